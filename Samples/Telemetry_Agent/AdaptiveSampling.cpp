@@ -0,0 +1,189 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  AdaptiveSampling.cpp
+ * @brief Per adapter sampling interval driven by signal variance.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#include "AdaptiveSampling.h"
+
+ctl_result_t AdaptiveSamplingInit(AdaptiveSamplingController *pController, uint32_t MinIntervalMs, uint32_t MaxIntervalMs, double TargetError)
+{
+    if (nullptr == pController)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((0 == MinIntervalMs) || (MinIntervalMs > MaxIntervalMs) || !(TargetError > 0.0))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    pController->minIntervalMs = MinIntervalMs;
+    pController->maxIntervalMs = MaxIntervalMs;
+    pController->targetError   = TargetError;
+    memset(pController->signals, 0, sizeof(pController->signals));
+    memset(pController->lastSampleNs, 0, sizeof(pController->lastSampleNs));
+    memset(pController->working, 0, sizeof(pController->working));
+    for (uint32_t i = 0; i < AGENT_MAX_ADAPTERS; i++)
+    {
+        pController->intervalMs[i]           = MinIntervalMs;
+        pController->meanPeriodSec[i]        = 0.0;
+        pController->working[i].adapterIndex = i;
+        pController->working[i].intervalMs   = MinIntervalMs;
+    }
+
+    std::lock_guard<std::mutex> Guard(pController->statsLock);
+    memcpy(pController->stats, pController->working, sizeof(pController->stats));
+    return CTL_RESULT_SUCCESS;
+}
+
+/***************************************************************
+ * @brief Current value of a signal, false if the pass lacks it
+ ***************************************************************/
+static bool SignalValue(const PublishedSnapshot *pSample, AdaptiveSignal Signal, double *pValue)
+{
+    const DerivedMetrics *pDerived = &pSample->derived;
+    switch (Signal)
+    {
+        case ADAPTIVE_SIGNAL_POWER:
+            if ((CTL_RESULT_SUCCESS != pSample->snapshot.telemetryResult) || (0 == (pSample->snapshot.telemetryValidMask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_GPU_POWER_PERCENT))))
+            {
+                return false;
+            }
+            *pValue = pSample->snapshot.telemetryValues[TELEMETRY_ITEM_GPU_POWER_PERCENT];
+            return true;
+        case ADAPTIVE_SIGNAL_GLOBAL_ACTIVITY:
+            *pValue = pDerived->globalUtilizationPct;
+            return 0 != (pDerived->validMask & DERIVED_VALID_GLOBAL_UTILIZATION);
+        case ADAPTIVE_SIGNAL_RENDER_ACTIVITY:
+            *pValue = pDerived->renderUtilizationPct;
+            return 0 != (pDerived->validMask & DERIVED_VALID_RENDER_UTILIZATION);
+        case ADAPTIVE_SIGNAL_MEDIA_ACTIVITY:
+            *pValue = pDerived->mediaUtilizationPct;
+            return 0 != (pDerived->validMask & DERIVED_VALID_MEDIA_UTILIZATION);
+        default:
+            return false;
+    }
+}
+
+uint32_t AdaptiveSamplingUpdate(AdaptiveSamplingController *pController, const PublishedSnapshot *pSample)
+{
+    uint32_t Index = pSample->snapshot.adapterIndex;
+    if (Index >= AGENT_MAX_ADAPTERS)
+    {
+        return pController->minIntervalMs;
+    }
+
+    uint64_t NowNs   = pSample->snapshot.hostTimestampNs;
+    uint64_t LastNs  = pController->lastSampleNs[Index];
+    double PeriodSec = ((0 != LastNs) && (NowNs > LastNs)) ? (NowNs - LastNs) / 1e9 : 0.0;
+
+    pController->lastSampleNs[Index] = NowNs;
+
+    // Largest step variance over the signals present in this pass
+    double MaxVariance      = 0.0;
+    AdaptiveSignal Dominant = ADAPTIVE_SIGNAL_POWER;
+    for (uint32_t s = 0; s < ADAPTIVE_SIGNAL_COUNT; s++)
+    {
+        AdaptiveSignalState *pSignal = &pController->signals[Index][s];
+        double Value;
+        if (!SignalValue(pSample, static_cast<AdaptiveSignal>(s), &Value))
+        {
+            pSignal->haveLast = false;
+            continue;
+        }
+
+        if (pSignal->haveLast && (PeriodSec > 0.0))
+        {
+            double Step = Value - pSignal->lastValue;
+            pSignal->variancePerSec += ADAPTIVE_SAMPLING_SMOOTHING * (Step * Step / PeriodSec - pSignal->variancePerSec);
+        }
+        pSignal->haveLast  = true;
+        pSignal->lastValue = Value;
+
+        if (pSignal->variancePerSec > MaxVariance)
+        {
+            MaxVariance = pSignal->variancePerSec;
+            Dominant    = static_cast<AdaptiveSignal>(s);
+        }
+    }
+
+    // Interval meeting the target error, approached at a bounded pace
+    double Current = pController->intervalMs[Index];
+    double Target  = (MaxVariance > 0.0) ? 4000.0 * pController->targetError * pController->targetError / MaxVariance : pController->maxIntervalMs;
+    double Next    = std::max(Current / ADAPTIVE_SAMPLING_MAX_SPEEDUP, std::min(Current * ADAPTIVE_SAMPLING_MAX_BACKOFF, Target));
+    Next           = std::max(static_cast<double>(pController->minIntervalMs), std::min(static_cast<double>(pController->maxIntervalMs), Next));
+
+    pController->intervalMs[Index] = Next;
+    if (PeriodSec > 0.0)
+    {
+        double &MeanPeriod = pController->meanPeriodSec[Index];
+        MeanPeriod         = (0.0 == MeanPeriod) ? PeriodSec : MeanPeriod + ADAPTIVE_SAMPLING_SMOOTHING * (PeriodSec - MeanPeriod);
+    }
+
+    AdaptiveSamplingStats *pStats = &pController->working[Index];
+    pStats->intervalMs            = static_cast<uint32_t>(Next + 0.5);
+    pStats->effectiveRateHz       = (pController->meanPeriodSec[Index] > 0.0) ? 1.0 / pController->meanPeriodSec[Index] : 0.0;
+    pStats->estimatedErrorPct     = sqrt(MaxVariance * Next / 1000.0) / 2.0;
+    pStats->dominant              = Dominant;
+    pStats->samples++;
+    if (Next < Current)
+    {
+        pStats->speedups++;
+    }
+    else if (Next > Current)
+    {
+        pStats->backoffs++;
+    }
+
+    {
+        std::lock_guard<std::mutex> Guard(pController->statsLock);
+        pController->stats[Index] = *pStats;
+    }
+    return pStats->intervalMs;
+}
+
+ctl_result_t AdaptiveSamplingRead(AdaptiveSamplingController *pController, uint32_t AdapterIndex, AdaptiveSamplingStats *pStats)
+{
+    if ((nullptr == pController) || (nullptr == pStats))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (AdapterIndex >= AGENT_MAX_ADAPTERS)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pController->statsLock);
+    *pStats = pController->stats[AdapterIndex];
+    return CTL_RESULT_SUCCESS;
+}
+
+const char *AdaptiveSignalLabel(AdaptiveSignal Signal)
+{
+    switch (Signal)
+    {
+        case ADAPTIVE_SIGNAL_POWER:
+            return "power";
+        case ADAPTIVE_SIGNAL_GLOBAL_ACTIVITY:
+            return "global_activity";
+        case ADAPTIVE_SIGNAL_RENDER_ACTIVITY:
+            return "render_activity";
+        case ADAPTIVE_SIGNAL_MEDIA_ACTIVITY:
+            return "media_activity";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,110 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  AdaptiveSampling.h
+ * @brief Per adapter sampling interval driven by signal variance.
+ *
+ * Each pass feeds gpuPowerPercent and the global, render and media
+ * activity of an adapter into the controller. Treating each signal as a
+ * random walk between samples, it keeps an exponentially weighted estimate
+ * of the variance per second of its steps, D. Linear interpolation over an
+ * interval T then has an RMS error of sqrt(D * T) / 2 at the midpoint, so
+ * the interval that meets a target error E is 4 * E^2 / D.
+ *
+ * The next interval moves toward that value, at most
+ * ADAPTIVE_SAMPLING_MAX_SPEEDUP times shorter or ADAPTIVE_SAMPLING_MAX_BACKOFF
+ * times longer per pass, and stays within the configured bounds. Bursts
+ * therefore raise the rate within a pass or two and idle adapters back off
+ * gradually.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <mutex>
+
+#include "TelemetrySampler.h"
+
+#define ADAPTIVE_SAMPLING_DEFAULT_MIN_MS 20
+#define ADAPTIVE_SAMPLING_DEFAULT_MAX_MS 1000
+#define ADAPTIVE_SAMPLING_DEFAULT_TARGET_ERROR 1.0 ///< Percentage points
+#define ADAPTIVE_SAMPLING_SMOOTHING 0.25           ///< Weight of the newest step in the variance estimate
+#define ADAPTIVE_SAMPLING_MAX_SPEEDUP 4.0
+#define ADAPTIVE_SAMPLING_MAX_BACKOFF 1.25
+
+enum AdaptiveSignal
+{
+    ADAPTIVE_SIGNAL_POWER = 0, ///< gpuPowerPercent
+    ADAPTIVE_SIGNAL_GLOBAL_ACTIVITY,
+    ADAPTIVE_SIGNAL_RENDER_ACTIVITY,
+    ADAPTIVE_SIGNAL_MEDIA_ACTIVITY,
+    ADAPTIVE_SIGNAL_COUNT
+};
+
+struct AdaptiveSignalState
+{
+    bool haveLast;
+    double lastValue;
+    double variancePerSec; ///< D, squared percentage points per second
+};
+
+/***************************************************************
+ * @brief Sampling state of one adapter
+ ***************************************************************/
+struct AdaptiveSamplingStats
+{
+    uint32_t adapterIndex;
+    uint32_t intervalMs;      ///< Interval chosen for the next pass
+    double effectiveRateHz;   ///< Smoothed rate of the passes actually made
+    double estimatedErrorPct; ///< RMS interpolation error at the chosen interval, worst signal
+    AdaptiveSignal dominant;  ///< Signal that set the interval
+    uint64_t samples;
+    uint64_t speedups; ///< Passes that shortened the interval
+    uint64_t backoffs; ///< Passes that lengthened it
+};
+
+struct AdaptiveSamplingController
+{
+    uint32_t minIntervalMs;
+    uint32_t maxIntervalMs;
+    double targetError;
+
+    // Sampler private
+    AdaptiveSignalState signals[AGENT_MAX_ADAPTERS][ADAPTIVE_SIGNAL_COUNT];
+    double intervalMs[AGENT_MAX_ADAPTERS];
+    double meanPeriodSec[AGENT_MAX_ADAPTERS];
+    uint64_t lastSampleNs[AGENT_MAX_ADAPTERS];
+    AdaptiveSamplingStats working[AGENT_MAX_ADAPTERS];
+
+    std::mutex statsLock;
+    AdaptiveSamplingStats stats[AGENT_MAX_ADAPTERS];
+};
+
+/***************************************************************
+ * @brief Sets the bounds and the target error in percentage points
+ *
+ * Every adapter starts at MinIntervalMs and backs off from there.
+ ***************************************************************/
+ctl_result_t AdaptiveSamplingInit(AdaptiveSamplingController *pController, uint32_t MinIntervalMs, uint32_t MaxIntervalMs, double TargetError);
+
+/***************************************************************
+ * @brief Feeds one published pass, returns the interval to the next
+ *
+ * Called by the telemetry cache on its sampler thread.
+ ***************************************************************/
+uint32_t AdaptiveSamplingUpdate(AdaptiveSamplingController *pController, const PublishedSnapshot *pSample);
+
+ctl_result_t AdaptiveSamplingRead(AdaptiveSamplingController *pController, uint32_t AdapterIndex, AdaptiveSamplingStats *pStats);
+
+/***************************************************************
+ * @brief Lower case signal name used in labels
+ ***************************************************************/
+const char *AdaptiveSignalLabel(AdaptiveSignal Signal);
@@ -0,0 +1,449 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  AlertEngine.cpp
+ * @brief Threshold, hysteresis and rate of change alerts over telemetry.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "AlertEngine.h"
+
+#define ALERT_END_OF_CHAIN ALERT_MAX_INSTANCES
+#define ALERT_DERIVED_COUNT 8
+
+static_assert(TELEMETRY_ITEM_COUNT <= ALERT_SLOT_TEMPERATURE, "telemetry items overlap the temperature slots");
+static_assert(ALERT_SLOT_TEMPERATURE + AGENT_MAX_TEMP_SENSORS <= ALERT_SLOT_FAN, "temperature sensors overlap the fan slots");
+static_assert(ALERT_SLOT_FAN + AGENT_MAX_FANS <= ALERT_SLOT_DERIVED, "fans overlap the derived slots");
+static_assert(ALERT_SLOT_DERIVED + ALERT_DERIVED_COUNT <= ALERT_SLOT_COUNT, "derived metrics exceed the slot mask");
+static_assert(ALERT_MAX_INSTANCES < 0xFFFF, "instance links are 16 bits wide");
+static_assert(0 == (ALERT_QUEUE_CAPACITY & (ALERT_QUEUE_CAPACITY - 1)), "queue capacity must be a power of two");
+
+static inline uint32_t LowestSetBit(uint64_t Mask)
+{
+#if defined(_MSC_VER)
+    unsigned long Index;
+    _BitScanForward64(&Index, Mask);
+    return static_cast<uint32_t>(Index);
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(Mask));
+#endif
+}
+
+static void AlertListener(const AdapterSnapshot *pPrevious, const PublishedSnapshot *pCurrent, void *pContext)
+{
+    (void)pPrevious;
+    AlertEngineEvaluate(static_cast<AlertEngine *>(pContext), pCurrent);
+}
+
+ctl_result_t AlertEngineInit(AlertEngine *pEngine, TelemetryCache *pCache, AlertCallback pfnCallback, void *pContext)
+{
+    if ((nullptr == pEngine) || (nullptr == pCache))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pEngine->pCache        = pCache;
+    pEngine->pfnCallback   = pfnCallback;
+    pEngine->pContext      = pContext;
+    pEngine->ruleCount     = 0;
+    pEngine->instanceCount = 0;
+    for (uint32_t i = 0; i < AGENT_MAX_ADAPTERS; i++)
+    {
+        pEngine->adapters[i].slotMask = 0;
+        for (uint32_t s = 0; s < ALERT_SLOT_COUNT; s++)
+        {
+            pEngine->adapters[i].head[s] = ALERT_END_OF_CHAIN;
+        }
+    }
+    pEngine->queue.head.store(0, std::memory_order_relaxed);
+    pEngine->queue.tail.store(0, std::memory_order_relaxed);
+    pEngine->queue.dropped.store(0, std::memory_order_relaxed);
+
+    return TelemetryCacheAddListener(pCache, AlertListener, pEngine);
+}
+
+/***************************************************************
+ * @brief Slot of a metric, ALERT_SLOT_COUNT if it does not exist
+ ***************************************************************/
+static uint32_t MetricSlot(const AlertMetric *pMetric)
+{
+    switch (pMetric->source)
+    {
+        case ALERT_SOURCE_TELEMETRY:
+            return (pMetric->index < TELEMETRY_ITEM_COUNT) ? ALERT_SLOT_TELEMETRY + pMetric->index : ALERT_SLOT_COUNT;
+        case ALERT_SOURCE_TEMPERATURE:
+            return (pMetric->index < AGENT_MAX_TEMP_SENSORS) ? ALERT_SLOT_TEMPERATURE + pMetric->index : ALERT_SLOT_COUNT;
+        case ALERT_SOURCE_FAN:
+            return (pMetric->index < AGENT_MAX_FANS) ? ALERT_SLOT_FAN + pMetric->index : ALERT_SLOT_COUNT;
+        case ALERT_SOURCE_DERIVED:
+            return (pMetric->index < ALERT_DERIVED_COUNT) ? ALERT_SLOT_DERIVED + pMetric->index : ALERT_SLOT_COUNT;
+        default:
+            return ALERT_SLOT_COUNT;
+    }
+}
+
+/***************************************************************
+ * @brief Whether the adapter has the component behind a metric
+ ***************************************************************/
+static bool MetricPresent(const AdapterTopology *pTopology, const AlertMetric *pMetric)
+{
+    switch (pMetric->source)
+    {
+        case ALERT_SOURCE_TEMPERATURE:
+            return pMetric->index < pTopology->tempSensorCount;
+        case ALERT_SOURCE_FAN:
+            return pMetric->index < pTopology->fanCount;
+        default:
+            return true;
+    }
+}
+
+ctl_result_t AlertEngineAddRule(AlertEngine *pEngine, const AlertRule *pRule, uint32_t *pRuleId)
+{
+    if ((nullptr == pEngine) || (nullptr == pRule))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    uint32_t Slot = MetricSlot(&pRule->metric);
+    if (ALERT_SLOT_COUNT == Slot)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    bool RaisesAbove = (ALERT_CONDITION_ABOVE == pRule->condition) || (ALERT_CONDITION_RATE_ABOVE == pRule->condition);
+    if (RaisesAbove ? (pRule->clearThreshold > pRule->threshold) : (pRule->clearThreshold < pRule->threshold))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+    if (pEngine->ruleCount >= ALERT_MAX_RULES)
+    {
+        return CTL_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    const TelemetryCache *pCache = pEngine->pCache;
+    uint32_t Needed              = 0;
+    for (uint32_t i = 0; i < pCache->adapterCount; i++)
+    {
+        if (AgentAdapterMaskTest(&pRule->adapters, i) && MetricPresent(&pCache->topology[i], &pRule->metric))
+        {
+            Needed++;
+        }
+    }
+    if (pEngine->instanceCount + Needed > ALERT_MAX_INSTANCES)
+    {
+        return CTL_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    uint32_t RuleId        = pEngine->ruleCount++;
+    pEngine->rules[RuleId] = *pRule;
+
+    pEngine->rules[RuleId].name[ALERT_RULE_NAME_LEN - 1] = '\0';
+
+    for (uint32_t i = 0; i < pCache->adapterCount; i++)
+    {
+        if (!AgentAdapterMaskTest(&pRule->adapters, i) || !MetricPresent(&pCache->topology[i], &pRule->metric))
+        {
+            continue;
+        }
+
+        uint16_t Id              = static_cast<uint16_t>(pEngine->instanceCount++);
+        AlertInstance *pInstance = &pEngine->instances[Id];
+        memset(pInstance, 0, sizeof(*pInstance));
+        pInstance->ruleId = static_cast<uint16_t>(RuleId);
+        pInstance->next   = pEngine->adapters[i].head[Slot];
+
+        pEngine->adapters[i].head[Slot] = Id;
+        pEngine->adapters[i].slotMask |= 1ull << Slot;
+    }
+
+    if (nullptr != pRuleId)
+    {
+        *pRuleId = RuleId;
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+static ctl_result_t AddDefaultRule(AlertEngine *pEngine, const char *pName, AlertSource Source, uint32_t Index, AlertCondition Condition, double Threshold, double ClearThreshold,
+                                   uint32_t MinDurationMs, uint32_t Severity)
+{
+    AlertRule Rule;
+    snprintf(Rule.name, sizeof(Rule.name), "%s", pName);
+    AgentAdapterMaskSetAll(&Rule.adapters);
+    Rule.metric         = { Source, Index };
+    Rule.condition      = Condition;
+    Rule.threshold      = Threshold;
+    Rule.clearThreshold = ClearThreshold;
+    Rule.minDurationMs  = MinDurationMs;
+    Rule.severity       = Severity;
+    return AlertEngineAddRule(pEngine, &Rule, nullptr);
+}
+
+ctl_result_t AlertEngineAddDefaultRules(AlertEngine *pEngine)
+{
+    ctl_result_t Result = CTL_RESULT_SUCCESS;
+    char Name[ALERT_RULE_NAME_LEN];
+
+    // Sensor temperatures, with a few degrees of hysteresis
+    for (uint32_t s = 0; (CTL_RESULT_SUCCESS == Result) && (s < AGENT_MAX_TEMP_SENSORS); s++)
+    {
+        snprintf(Name, sizeof(Name), "temperature%u_high", s);
+        Result = AddDefaultRule(pEngine, Name, ALERT_SOURCE_TEMPERATURE, s, ALERT_CONDITION_ABOVE, 95.0, 90.0, 2000, ALERT_SEVERITY_WARNING);
+    }
+    if (CTL_RESULT_SUCCESS == Result)
+    {
+        Result = AddDefaultRule(pEngine, "gpu_temperature_rise", ALERT_SOURCE_TELEMETRY, TELEMETRY_ITEM_GPU_TEMPERATURE, ALERT_CONDITION_RATE_ABOVE, 5.0, 1.0, 1000, ALERT_SEVERITY_WARNING);
+    }
+    if (CTL_RESULT_SUCCESS == Result)
+    {
+        Result = AddDefaultRule(pEngine, "vram_temperature_high", ALERT_SOURCE_TELEMETRY, TELEMETRY_ITEM_VRAM_TEMPERATURE, ALERT_CONDITION_ABOVE, 95.0, 90.0, 2000, ALERT_SEVERITY_WARNING);
+    }
+
+    // Percentages of the firmware limits, 100 means the limit is reached
+    if (CTL_RESULT_SUCCESS == Result)
+    {
+        Result = AddDefaultRule(pEngine, "gpu_temperature_limit", ALERT_SOURCE_TELEMETRY, TELEMETRY_ITEM_GPU_TEMPERATURE_PERCENT, ALERT_CONDITION_ABOVE, 98.0, 92.0, 1000,
+                                ALERT_SEVERITY_CRITICAL);
+    }
+    if (CTL_RESULT_SUCCESS == Result)
+    {
+        Result = AddDefaultRule(pEngine, "gpu_power_limit", ALERT_SOURCE_TELEMETRY, TELEMETRY_ITEM_GPU_POWER_PERCENT, ALERT_CONDITION_ABOVE, 98.0, 90.0, 5000, ALERT_SEVERITY_WARNING);
+    }
+
+    // Fans may stop at idle, so alert on a collapse of the speed rather than on a low speed.
+    // The hold outlasts a step of the fan controller, which may lower a table at once
+    for (uint32_t f = 0; (CTL_RESULT_SUCCESS == Result) && (f < AGENT_MAX_FANS); f++)
+    {
+        snprintf(Name, sizeof(Name), "fan%u_speed_drop", f);
+        Result = AddDefaultRule(pEngine, Name, ALERT_SOURCE_FAN, f, ALERT_CONDITION_RATE_BELOW, -1500.0, -100.0, 2000, ALERT_SEVERITY_WARNING);
+    }
+
+    // Every PSU input is a 12 V rail, the ATX tolerance is 5 %
+    for (uint32_t p = 0; (CTL_RESULT_SUCCESS == Result) && (p < CTL_PSU_COUNT); p++)
+    {
+        snprintf(Name, sizeof(Name), "psu%u_voltage_low", p);
+        Result = AddDefaultRule(pEngine, Name, ALERT_SOURCE_TELEMETRY, TELEMETRY_ITEM_PSU_VOLTAGE_0 + p, ALERT_CONDITION_BELOW, 11.4, 11.6, 500, ALERT_SEVERITY_CRITICAL);
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            snprintf(Name, sizeof(Name), "psu%u_voltage_high", p);
+            Result = AddDefaultRule(pEngine, Name, ALERT_SOURCE_TELEMETRY, TELEMETRY_ITEM_PSU_VOLTAGE_0 + p, ALERT_CONDITION_ABOVE, 12.6, 12.4, 500, ALERT_SEVERITY_CRITICAL);
+        }
+    }
+
+    return Result;
+}
+
+/***************************************************************
+ * @brief Slots present in a pass, one bit per metric
+ ***************************************************************/
+static uint64_t ValidSlots(const PublishedSnapshot *pSample)
+{
+    const AdapterSnapshot *pSnapshot = &pSample->snapshot;
+    uint64_t Mask                    = 0;
+    if (CTL_RESULT_SUCCESS == pSnapshot->telemetryResult)
+    {
+        Mask |= pSnapshot->telemetryValidMask << ALERT_SLOT_TELEMETRY;
+    }
+    Mask |= static_cast<uint64_t>(pSnapshot->tempValidMask & ((1u << AGENT_MAX_TEMP_SENSORS) - 1)) << ALERT_SLOT_TEMPERATURE;
+    Mask |= static_cast<uint64_t>(pSnapshot->fanValidMask & ((1u << AGENT_MAX_FANS) - 1)) << ALERT_SLOT_FAN;
+    Mask |= static_cast<uint64_t>(pSample->derived.validMask & ((1u << ALERT_DERIVED_COUNT) - 1)) << ALERT_SLOT_DERIVED;
+    return Mask;
+}
+
+static double SlotValue(const PublishedSnapshot *pSample, uint32_t Slot)
+{
+    if (Slot < ALERT_SLOT_TEMPERATURE)
+    {
+        return pSample->snapshot.telemetryValues[Slot - ALERT_SLOT_TELEMETRY];
+    }
+    if (Slot < ALERT_SLOT_FAN)
+    {
+        return pSample->snapshot.temperature[Slot - ALERT_SLOT_TEMPERATURE];
+    }
+    if (Slot < ALERT_SLOT_DERIVED)
+    {
+        return static_cast<double>(pSample->snapshot.fanSpeedRpm[Slot - ALERT_SLOT_FAN]);
+    }
+
+    const DerivedMetrics *pDerived = &pSample->derived;
+    const double Values[]          = { pDerived->gpuPowerW,           pDerived->vramPowerW,          pDerived->cardPowerW,          pDerived->globalUtilizationPct,
+                                       pDerived->renderUtilizationPct, pDerived->mediaUtilizationPct, pDerived->vramReadBytesPerSec, pDerived->vramWriteBytesPerSec };
+    static_assert(sizeof(Values) / sizeof(Values[0]) == ALERT_DERIVED_COUNT, "one value per DERIVED_VALID_* flag");
+    return Values[Slot - ALERT_SLOT_DERIVED];
+}
+
+static void QueuePush(AlertQueue *pQueue, const AlertEvent *pEvent)
+{
+    uint64_t Head = pQueue->head.load(std::memory_order_relaxed);
+    uint64_t Tail = pQueue->tail.load(std::memory_order_acquire);
+    if (Head - Tail >= ALERT_QUEUE_CAPACITY)
+    {
+        pQueue->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    pQueue->events[Head & (ALERT_QUEUE_CAPACITY - 1)] = *pEvent;
+    pQueue->head.store(Head + 1, std::memory_order_release);
+}
+
+static void Emit(AlertEngine *pEngine, const AlertInstance *pInstance, uint32_t AdapterIndex, AlertEventType Type, double Value, uint64_t NowNs)
+{
+    const AlertRule *pRule = &pEngine->rules[pInstance->ruleId];
+
+    AlertEvent Event;
+    Event.ruleId          = pInstance->ruleId;
+    Event.adapterIndex    = AdapterIndex;
+    Event.type            = Type;
+    Event.severity        = pRule->severity;
+    Event.value           = Value;
+    Event.threshold       = (ALERT_EVENT_RAISED == Type) ? pRule->threshold : pRule->clearThreshold;
+    Event.hostTimestampNs = NowNs;
+    Event.activeNs        = (ALERT_EVENT_CLEARED == Type) ? NowNs - pInstance->raisedNs : 0;
+
+    if (nullptr != pEngine->pfnCallback)
+    {
+        pEngine->pfnCallback(&Event, pEngine->pContext);
+    }
+    QueuePush(&pEngine->queue, &Event);
+}
+
+/***************************************************************
+ * @brief Advances one instance by one observation of its metric
+ ***************************************************************/
+static void EvaluateInstance(AlertEngine *pEngine, AlertInstance *pInstance, uint32_t AdapterIndex, double Value, uint64_t NowNs)
+{
+    const AlertRule *pRule = &pEngine->rules[pInstance->ruleId];
+    double Observed        = Value;
+
+    if ((ALERT_CONDITION_RATE_ABOVE == pRule->condition) || (ALERT_CONDITION_RATE_BELOW == pRule->condition))
+    {
+        bool HaveRate = pInstance->haveLast && (NowNs > pInstance->lastNs);
+        if (HaveRate)
+        {
+            Observed = (Value - pInstance->lastValue) / ((NowNs - pInstance->lastNs) / 1e9);
+        }
+        pInstance->haveLast  = true;
+        pInstance->lastValue = Value;
+        pInstance->lastNs    = NowNs;
+        if (!HaveRate)
+        {
+            return;
+        }
+    }
+
+    bool Above   = (ALERT_CONDITION_ABOVE == pRule->condition) || (ALERT_CONDITION_RATE_ABOVE == pRule->condition);
+    bool Trigger = Above ? (Observed > pRule->threshold) : (Observed < pRule->threshold);
+    bool Clear   = Above ? (Observed < pRule->clearThreshold) : (Observed > pRule->clearThreshold);
+
+    if (pInstance->active)
+    {
+        if (Clear)
+        {
+            Emit(pEngine, pInstance, AdapterIndex, ALERT_EVENT_CLEARED, Observed, NowNs);
+            pInstance->active = false;
+        }
+        return;
+    }
+
+    if (!Trigger)
+    {
+        pInstance->pending = false;
+        return;
+    }
+    if (!pInstance->pending)
+    {
+        pInstance->pending        = true;
+        pInstance->pendingSinceNs = NowNs;
+    }
+    if (NowNs - pInstance->pendingSinceNs >= pRule->minDurationMs * 1000000ull)
+    {
+        pInstance->pending  = false;
+        pInstance->active   = true;
+        pInstance->raisedNs = NowNs;
+        Emit(pEngine, pInstance, AdapterIndex, ALERT_EVENT_RAISED, Observed, NowNs);
+    }
+}
+
+void AlertEngineEvaluate(AlertEngine *pEngine, const PublishedSnapshot *pSample)
+{
+    uint32_t AdapterIndex = pSample->snapshot.adapterIndex;
+    if ((AdapterIndex >= AGENT_MAX_ADAPTERS) || (0 == pSample->snapshot.sequence))
+    {
+        return;
+    }
+
+    AlertAdapterIndex *pIndex = &pEngine->adapters[AdapterIndex];
+    uint64_t NowNs            = pSample->snapshot.hostTimestampNs;
+
+    // Only slots that have rules and were read in this pass are visited
+    uint64_t Touched = pIndex->slotMask & ValidSlots(pSample);
+    while (0 != Touched)
+    {
+        uint32_t Slot = LowestSetBit(Touched);
+        Touched &= Touched - 1;
+
+        double Value = SlotValue(pSample, Slot);
+        for (uint16_t Id = pIndex->head[Slot]; ALERT_END_OF_CHAIN != Id; Id = pEngine->instances[Id].next)
+        {
+            EvaluateInstance(pEngine, &pEngine->instances[Id], AdapterIndex, Value, NowNs);
+        }
+    }
+}
+
+uint32_t AlertEnginePoll(AlertEngine *pEngine, AlertEvent *pEvents, uint32_t MaxEvents)
+{
+    if ((nullptr == pEngine) || (nullptr == pEvents))
+    {
+        return 0;
+    }
+
+    AlertQueue *pQueue = &pEngine->queue;
+    uint64_t Tail      = pQueue->tail.load(std::memory_order_relaxed);
+    uint64_t Head      = pQueue->head.load(std::memory_order_acquire);
+    uint32_t Count     = (Head - Tail < MaxEvents) ? static_cast<uint32_t>(Head - Tail) : MaxEvents;
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        pEvents[i] = pQueue->events[(Tail + i) & (ALERT_QUEUE_CAPACITY - 1)];
+    }
+    pQueue->tail.store(Tail + Count, std::memory_order_release);
+    return Count;
+}
+
+void AlertMetricName(const AlertMetric *pMetric, char *pBuffer, size_t BufferSize)
+{
+    static const char *DerivedNames[] = { "gpu_power_w", "vram_power_w", "card_power_w", "global_utilization", "render_utilization", "media_utilization", "vram_read_bps", "vram_write_bps" };
+
+    uint32_t Index = pMetric->index;
+    switch (pMetric->source)
+    {
+        case ALERT_SOURCE_TELEMETRY:
+            TelemetryItemLabel(Index, pBuffer, BufferSize);
+            break;
+        case ALERT_SOURCE_TEMPERATURE:
+            snprintf(pBuffer, BufferSize, "temperature%u", Index);
+            break;
+        case ALERT_SOURCE_FAN:
+            snprintf(pBuffer, BufferSize, "fan%u_rpm", Index);
+            break;
+        case ALERT_SOURCE_DERIVED:
+            snprintf(pBuffer, BufferSize, "%s", (Index < ALERT_DERIVED_COUNT) ? DerivedNames[Index] : "unknown");
+            break;
+        default:
+            snprintf(pBuffer, BufferSize, "unknown");
+            break;
+    }
+}
@@ -0,0 +1,189 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  AlertEngine.h
+ * @brief Threshold, hysteresis and rate of change alerts over telemetry.
+ *
+ * Rules name a metric of the published snapshot, e.g. a temperature sensor,
+ * a fan, gpuPowerPercent or a PSU voltage, and a condition on it. Each rule
+ * is instantiated once per adapter it applies to and chained on the metric
+ * it watches. Every metric of an adapter maps to one bit of a 64 bit mask,
+ * so evaluating a pass only walks the rules whose metric was present in it.
+ *
+ * A rule raises after its condition has held for minDurationMs and clears
+ * once the value crosses back over clearThreshold, so a reading that
+ * hovers around the threshold does not flap. Rate rules apply the same
+ * logic to the change per second between two passes.
+ *
+ * Raised and cleared events go to an optional callback on the sampler
+ * thread and to a lock free single consumer queue.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+#include "TelemetryCache.h"
+
+#define ALERT_MAX_RULES 64
+#define ALERT_MAX_INSTANCES (AGENT_MAX_ADAPTERS * ALERT_MAX_RULES) ///< Every rule on every adapter
+#define ALERT_QUEUE_CAPACITY 1024 ///< Power of two
+#define ALERT_RULE_NAME_LEN 32
+#define ALERT_INVALID_RULE 0xFFFFFFFFu
+#define ALERT_SEVERITY_WARNING 1
+#define ALERT_SEVERITY_CRITICAL 2
+
+/***************************************************************
+ * @brief Metric bits of one adapter, see AlertMetric
+ ***************************************************************/
+#define ALERT_SLOT_TELEMETRY 0
+#define ALERT_SLOT_TEMPERATURE 40
+#define ALERT_SLOT_FAN 48
+#define ALERT_SLOT_DERIVED 56
+#define ALERT_SLOT_COUNT 64
+
+enum AlertSource
+{
+    ALERT_SOURCE_TELEMETRY = 0, ///< index is a TelemetryItemId
+    ALERT_SOURCE_TEMPERATURE,   ///< index is a temperature sensor of the topology
+    ALERT_SOURCE_FAN,           ///< index is a fan of the topology, RPM
+    ALERT_SOURCE_DERIVED        ///< index is the bit of a DERIVED_VALID_* flag
+};
+
+struct AlertMetric
+{
+    AlertSource source;
+    uint32_t index;
+};
+
+enum AlertCondition
+{
+    ALERT_CONDITION_ABOVE = 0,  ///< value > threshold, clears below clearThreshold
+    ALERT_CONDITION_BELOW,      ///< value < threshold, clears above clearThreshold
+    ALERT_CONDITION_RATE_ABOVE, ///< Change per second > threshold
+    ALERT_CONDITION_RATE_BELOW  ///< Change per second < threshold
+};
+
+struct AlertRule
+{
+    char name[ALERT_RULE_NAME_LEN];
+    AgentAdapterMask adapters; ///< AgentAdapterMaskSetAll for every adapter
+    AlertMetric metric;
+    AlertCondition condition;
+    double threshold;
+    double clearThreshold; ///< Equal to threshold for no hysteresis
+    uint32_t minDurationMs;
+    uint32_t severity; ///< ALERT_SEVERITY_*, passed through to events
+};
+
+enum AlertEventType
+{
+    ALERT_EVENT_RAISED = 0,
+    ALERT_EVENT_CLEARED
+};
+
+struct AlertEvent
+{
+    uint32_t ruleId;
+    uint32_t adapterIndex;
+    AlertEventType type;
+    uint32_t severity;
+    double value; ///< Value or rate that triggered the event
+    double threshold;
+    uint64_t hostTimestampNs;
+    uint64_t activeNs; ///< For ALERT_EVENT_CLEARED, time since raised
+};
+
+typedef void (*AlertCallback)(const AlertEvent *pEvent, void *pContext);
+
+/***************************************************************
+ * @brief Bounded single producer, single consumer event ring
+ ***************************************************************/
+struct AlertQueue
+{
+    alignas(64) std::atomic<uint64_t> head; ///< Next slot written by the sampler
+    alignas(64) std::atomic<uint64_t> tail; ///< Next slot read by the consumer
+    alignas(64) std::atomic<uint64_t> dropped;
+    AlertEvent events[ALERT_QUEUE_CAPACITY];
+};
+
+/***************************************************************
+ * @brief One rule applied to one adapter
+ ***************************************************************/
+struct AlertInstance
+{
+    uint16_t ruleId;
+    uint16_t next; ///< Next instance on the same metric, ALERT_MAX_INSTANCES ends the chain
+    bool active;
+    bool pending;
+    bool haveLast;
+    uint64_t pendingSinceNs;
+    uint64_t raisedNs;
+    uint64_t lastNs;
+    double lastValue;
+};
+
+struct AlertAdapterIndex
+{
+    uint64_t slotMask; ///< Slots with at least one instance
+    uint16_t head[ALERT_SLOT_COUNT];
+};
+
+struct AlertEngine
+{
+    const TelemetryCache *pCache;
+    AlertCallback pfnCallback;
+    void *pContext;
+
+    uint32_t ruleCount;
+    AlertRule rules[ALERT_MAX_RULES];
+    uint32_t instanceCount;
+    AlertInstance instances[ALERT_MAX_INSTANCES];
+    AlertAdapterIndex adapters[AGENT_MAX_ADAPTERS];
+    AlertQueue queue;
+};
+
+/***************************************************************
+ * @brief Registers the engine as a listener of the cache
+ *
+ * pfnCallback may be nullptr, events are then only queued. Call before
+ * TelemetryCacheStart.
+ ***************************************************************/
+ctl_result_t AlertEngineInit(AlertEngine *pEngine, TelemetryCache *pCache, AlertCallback pfnCallback, void *pContext);
+
+/***************************************************************
+ * @brief Adds a rule, must be called before TelemetryCacheStart
+ *
+ * Returns CTL_RESULT_ERROR_INVALID_ARGUMENT for a metric that does not
+ * exist or a clear threshold on the wrong side of the threshold.
+ ***************************************************************/
+ctl_result_t AlertEngineAddRule(AlertEngine *pEngine, const AlertRule *pRule, uint32_t *pRuleId);
+
+/***************************************************************
+ * @brief Adds temperature, power, fan and PSU rules with stock limits
+ ***************************************************************/
+ctl_result_t AlertEngineAddDefaultRules(AlertEngine *pEngine);
+
+/***************************************************************
+ * @brief Evaluates the rules touched by one pass, called by the listener
+ ***************************************************************/
+void AlertEngineEvaluate(AlertEngine *pEngine, const PublishedSnapshot *pSample);
+
+/***************************************************************
+ * @brief Pops up to MaxEvents queued events, single consumer only
+ ***************************************************************/
+uint32_t AlertEnginePoll(AlertEngine *pEngine, AlertEvent *pEvents, uint32_t MaxEvents);
+
+/***************************************************************
+ * @brief Writes a readable metric name such as "fan1_rpm"
+ ***************************************************************/
+void AlertMetricName(const AlertMetric *pMetric, char *pBuffer, size_t BufferSize);
@@ -0,0 +1,355 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  AnomalyDetector.cpp
+ * @brief Streaming anomaly detection over the cached telemetry.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "AnomalyDetector.h"
+#include "TimeSeriesStore.h"
+
+#define ANOMALY_SEASON_MEMORY 3.0 ///< Seasons a bin mostly remembers
+
+#define ANOMALY_BIT(Kind) (1u << (Kind))
+
+void AnomalyDefaultConfig(AnomalyConfig *pConfig)
+{
+    pConfig->shortTauSec      = 10.0;
+    pConfig->longTauSec       = 3600.0;
+    pConfig->spikeZ           = 5.0;
+    pConfig->driftZ           = 3.0;
+    pConfig->driftHoldSec     = 30.0;
+    pConfig->warmupSec        = 60.0;
+    pConfig->seasonPeriodSec  = 86400.0;
+    pConfig->seasonZ          = 4.0;
+    pConfig->seasonMinSamples = 100;
+}
+
+static void AnomalyListener(const AdapterSnapshot *pPrevious, const PublishedSnapshot *pCurrent, void *pContext)
+{
+    (void)pPrevious;
+    AnomalyDetectorEvaluate(static_cast<AnomalyDetector *>(pContext), pCurrent);
+}
+
+ctl_result_t AnomalyDetectorInit(AnomalyDetector *pDetector, const AnomalyConfig *pConfig, TelemetryCache *pCache, AnomalyCallback pfnCallback, void *pContext)
+{
+    if (nullptr == pDetector)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    if (nullptr != pConfig)
+    {
+        if (!(pConfig->shortTauSec > 0.0) || !(pConfig->longTauSec > pConfig->shortTauSec) || !(pConfig->seasonPeriodSec > 0.0))
+        {
+            return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+        pDetector->config = *pConfig;
+    }
+    else
+    {
+        AnomalyDefaultConfig(&pDetector->config);
+    }
+
+    // Offset of the wall clock, so seasons line up with the time of day
+    int64_t WallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    pDetector->pfnCallback  = pfnCallback;
+    pDetector->pContext     = pContext;
+    pDetector->wallOffsetNs = WallNs - static_cast<int64_t>(AgentHostTimeNs());
+    memset(pDetector->streams, 0, sizeof(pDetector->streams));
+    memset(pDetector->raised, 0, sizeof(pDetector->raised));
+
+    return (nullptr != pCache) ? TelemetryCacheAddListener(pCache, AnomalyListener, pDetector) : CTL_RESULT_SUCCESS;
+}
+
+/***************************************************************
+ * @brief Value of a stream in a pass and the smallest sigma it is tested with
+ ***************************************************************/
+static bool StreamValue(const PublishedSnapshot *pSample, uint32_t Stream, double *pValue, double *pSigmaFloor)
+{
+    const AdapterSnapshot *pSnapshot = &pSample->snapshot;
+    const DerivedMetrics *pDerived   = &pSample->derived;
+    bool Telemetry                   = (CTL_RESULT_SUCCESS == pSnapshot->telemetryResult);
+
+    if (Stream >= ANOMALY_STREAM_FAN_0)
+    {
+        uint32_t Fan = Stream - ANOMALY_STREAM_FAN_0;
+        *pValue      = pSnapshot->fanSpeedRpm[Fan];
+        *pSigmaFloor = ANOMALY_SIGMA_FLOOR_RPM;
+        return 0 != (pSnapshot->fanValidMask & CTL_BIT(Fan));
+    }
+    if (Stream >= ANOMALY_STREAM_SENSOR_0)
+    {
+        uint32_t Sensor = Stream - ANOMALY_STREAM_SENSOR_0;
+        *pValue         = pSnapshot->temperature[Sensor];
+        *pSigmaFloor    = ANOMALY_SIGMA_FLOOR_CELSIUS;
+        return 0 != (pSnapshot->tempValidMask & CTL_BIT(Sensor));
+    }
+
+    switch (Stream)
+    {
+        case ANOMALY_STREAM_GPU_POWER:
+            *pValue      = pDerived->gpuPowerW;
+            *pSigmaFloor = ANOMALY_SIGMA_FLOOR_WATTS;
+            return 0 != (pDerived->validMask & DERIVED_VALID_GPU_POWER);
+        case ANOMALY_STREAM_CARD_POWER:
+            *pValue      = pDerived->cardPowerW;
+            *pSigmaFloor = ANOMALY_SIGMA_FLOOR_WATTS;
+            return 0 != (pDerived->validMask & DERIVED_VALID_CARD_POWER);
+        case ANOMALY_STREAM_GPU_FREQUENCY:
+            *pValue      = pSnapshot->telemetryValues[TELEMETRY_ITEM_GPU_FREQUENCY];
+            *pSigmaFloor = ANOMALY_SIGMA_FLOOR_MHZ;
+            return Telemetry && (0 != (pSnapshot->telemetryValidMask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_GPU_FREQUENCY)));
+        case ANOMALY_STREAM_GPU_TEMPERATURE:
+            *pValue      = pSnapshot->telemetryValues[TELEMETRY_ITEM_GPU_TEMPERATURE];
+            *pSigmaFloor = ANOMALY_SIGMA_FLOOR_CELSIUS;
+            return Telemetry && (0 != (pSnapshot->telemetryValidMask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_GPU_TEMPERATURE)));
+        case ANOMALY_STREAM_VRAM_TEMPERATURE:
+            *pValue      = pSnapshot->telemetryValues[TELEMETRY_ITEM_VRAM_TEMPERATURE];
+            *pSigmaFloor = ANOMALY_SIGMA_FLOOR_CELSIUS;
+            return Telemetry && (0 != (pSnapshot->telemetryValidMask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_VRAM_TEMPERATURE)));
+        case ANOMALY_STREAM_VRAM_READ:
+            *pValue      = pDerived->vramReadBytesPerSec;
+            *pSigmaFloor = ANOMALY_SIGMA_FLOOR_BYTES_PER_SEC;
+            return 0 != (pDerived->validMask & DERIVED_VALID_VRAM_READ);
+        case ANOMALY_STREAM_VRAM_WRITE:
+            *pValue      = pDerived->vramWriteBytesPerSec;
+            *pSigmaFloor = ANOMALY_SIGMA_FLOOR_BYTES_PER_SEC;
+            return 0 != (pDerived->validMask & DERIVED_VALID_VRAM_WRITE);
+        default:
+            return false;
+    }
+}
+
+/***************************************************************
+ * @brief Exponentially weighted mean and variance update
+ *
+ * Weight is raised to at least MinWeight, which makes the estimate a plain
+ * running mean until enough history exists for the time constant.
+ * pVariance may be nullptr to track the mean only.
+ ***************************************************************/
+static void EwmaUpdate(double *pMean, double *pVariance, double Value, double Weight, double MinWeight)
+{
+    double Rate  = (Weight > MinWeight) ? Weight : MinWeight;
+    double Delta = Value - *pMean;
+    *pMean       = *pMean + Rate * Delta;
+    if (nullptr != pVariance)
+    {
+        *pVariance = (1.0 - Rate) * (*pVariance + Rate * Delta * Delta);
+    }
+}
+
+static void Emit(AnomalyDetector *pDetector, AnomalyStreamState *pState, uint32_t AdapterIndex, uint32_t Stream, AnomalyKind Kind, bool Raised, double Value, double Expected, double Score,
+                 uint64_t NowNs)
+{
+    if (Raised)
+    {
+        pState->active |= ANOMALY_BIT(Kind);
+        pDetector->raised[Kind]++;
+    }
+    else
+    {
+        pState->active &= ~ANOMALY_BIT(Kind);
+    }
+
+    if (nullptr != pDetector->pfnCallback)
+    {
+        AnomalyEvent Event = { AdapterIndex, static_cast<AnomalyStream>(Stream), Kind, Raised, Value, Expected, Score, NowNs };
+        pDetector->pfnCallback(&Event, pDetector->pContext);
+    }
+}
+
+/***************************************************************
+ * @brief Raises above Threshold and clears below half of it
+ ***************************************************************/
+static void TestScore(AnomalyDetector *pDetector, AnomalyStreamState *pState, uint32_t AdapterIndex, uint32_t Stream, AnomalyKind Kind, double Value, double Expected, double Score,
+                      double Threshold, uint64_t NowNs)
+{
+    bool Active = (0 != (pState->active & ANOMALY_BIT(Kind)));
+    if (!Active && (fabs(Score) > Threshold))
+    {
+        Emit(pDetector, pState, AdapterIndex, Stream, Kind, true, Value, Expected, Score, NowNs);
+    }
+    else if (Active && (fabs(Score) < Threshold / 2.0))
+    {
+        Emit(pDetector, pState, AdapterIndex, Stream, Kind, false, Value, Expected, Score, NowNs);
+    }
+}
+
+static void UpdateSeason(AnomalyDetector *pDetector, AnomalyStreamState *pState, uint32_t AdapterIndex, uint32_t Stream, double Value, double SigmaFloor, double IntervalSec, uint64_t NowNs)
+{
+    const AnomalyConfig *pConfig = &pDetector->config;
+    double WallSec               = (static_cast<int64_t>(NowNs) + pDetector->wallOffsetNs) / 1e9;
+    double Phase                 = fmod(WallSec, pConfig->seasonPeriodSec);
+    uint64_t Season              = static_cast<uint64_t>(WallSec / pConfig->seasonPeriodSec);
+    uint32_t Bin                 = static_cast<uint32_t>(Phase / pConfig->seasonPeriodSec * ANOMALY_SEASON_BINS) % ANOMALY_SEASON_BINS;
+    AnomalySeasonBin *pBin       = &pState->bins[Bin];
+
+    // Compare with earlier seasons before this one contributes
+    bool HaveEarlier = (pBin->seasons > 1) || ((1 == pBin->seasons) && (pBin->lastSeason != Season));
+    if (HaveEarlier && (pBin->samples >= pConfig->seasonMinSamples))
+    {
+        double Sigma = sqrt(pBin->variance);
+        Sigma        = (Sigma > SigmaFloor) ? Sigma : SigmaFloor;
+        TestScore(pDetector, pState, AdapterIndex, Stream, ANOMALY_KIND_SEASONAL, Value, pBin->mean, (Value - pBin->mean) / Sigma, pConfig->seasonZ, NowNs);
+    }
+
+    // Values of an active anomaly would pull the baseline toward themselves
+    if (0 != (pState->active & ANOMALY_BIT(ANOMALY_KIND_SEASONAL)))
+    {
+        return;
+    }
+    if ((0 == pBin->seasons) || (pBin->lastSeason != Season))
+    {
+        pBin->seasons++;
+        pBin->lastSeason = Season;
+    }
+    pBin->samples++;
+
+    double BinSec = pConfig->seasonPeriodSec / ANOMALY_SEASON_BINS;
+    EwmaUpdate(&pBin->mean, &pBin->variance, Value, TimeSeriesEwmaWeight(IntervalSec, BinSec * ANOMALY_SEASON_MEMORY), 1.0 / pBin->samples);
+}
+
+static void UpdateStream(AnomalyDetector *pDetector, uint32_t AdapterIndex, uint32_t Stream, double Value, double SigmaFloor, uint64_t NowNs)
+{
+    const AnomalyConfig *pConfig = &pDetector->config;
+    AnomalyStreamState *pState   = &pDetector->streams[AdapterIndex][Stream];
+
+    if (0 == pState->firstNs)
+    {
+        pState->firstNs   = NowNs;
+        pState->lastNs    = NowNs;
+        pState->shortMean = Value;
+        pState->longMean  = Value;
+        UpdateSeason(pDetector, pState, AdapterIndex, Stream, Value, SigmaFloor, 0.0, NowNs);
+        return;
+    }
+    if (NowNs <= pState->lastNs)
+    {
+        return;
+    }
+
+    double IntervalSec = (NowNs - pState->lastNs) / 1e9;
+    double ElapsedSec  = (NowNs - pState->firstNs) / 1e9;
+    bool Armed         = (ElapsedSec >= pConfig->warmupSec);
+    pState->lastNs     = NowNs;
+
+    // Spike, tested against the baseline before this sample
+    double ShortSigma = sqrt(pState->shortVariance);
+    ShortSigma        = (ShortSigma > SigmaFloor) ? ShortSigma : SigmaFloor;
+    if (Armed)
+    {
+        TestScore(pDetector, pState, AdapterIndex, Stream, ANOMALY_KIND_SPIKE, Value, pState->shortMean, (Value - pState->shortMean) / ShortSigma, pConfig->spikeZ, NowNs);
+    }
+
+    double MinWeight = IntervalSec / ElapsedSec;
+    EwmaUpdate(&pState->shortMean, &pState->shortVariance, Value, TimeSeriesEwmaWeight(IntervalSec, pConfig->shortTauSec), MinWeight);
+    EwmaUpdate(&pState->longMean, nullptr, Value, TimeSeriesEwmaWeight(IntervalSec, pConfig->longTauSec), MinWeight);
+
+    // Drift of the short baseline away from the long one, in units of the
+    // short term noise since the long variance also contains the drift
+    ShortSigma   = sqrt(pState->shortVariance);
+    ShortSigma   = (ShortSigma > SigmaFloor) ? ShortSigma : SigmaFloor;
+    double Drift = (pState->shortMean - pState->longMean) / ShortSigma;
+    if (Armed)
+    {
+        AnomalyKind Kind = (Drift > 0.0) ? ANOMALY_KIND_DRIFT_UP : ANOMALY_KIND_DRIFT_DOWN;
+        uint32_t Drifts  = ANOMALY_BIT(ANOMALY_KIND_DRIFT_UP) | ANOMALY_BIT(ANOMALY_KIND_DRIFT_DOWN);
+        if (fabs(Drift) > pConfig->driftZ)
+        {
+            pState->driftSinceNs = (0 != pState->driftSinceNs) ? pState->driftSinceNs : NowNs;
+            if ((0 == (pState->active & Drifts)) && ((NowNs - pState->driftSinceNs) / 1e9 >= pConfig->driftHoldSec))
+            {
+                Emit(pDetector, pState, AdapterIndex, Stream, Kind, true, pState->shortMean, pState->longMean, Drift, NowNs);
+            }
+        }
+        else if (fabs(Drift) < pConfig->driftZ / 2.0)
+        {
+            pState->driftSinceNs = 0;
+            for (uint32_t k = ANOMALY_KIND_DRIFT_UP; k <= ANOMALY_KIND_DRIFT_DOWN; k++)
+            {
+                if (0 != (pState->active & ANOMALY_BIT(k)))
+                {
+                    Emit(pDetector, pState, AdapterIndex, Stream, static_cast<AnomalyKind>(k), false, pState->shortMean, pState->longMean, Drift, NowNs);
+                }
+            }
+        }
+    }
+
+    UpdateSeason(pDetector, pState, AdapterIndex, Stream, Value, SigmaFloor, IntervalSec, NowNs);
+}
+
+void AnomalyDetectorEvaluate(AnomalyDetector *pDetector, const PublishedSnapshot *pSample)
+{
+    uint32_t AdapterIndex = pSample->snapshot.adapterIndex;
+    if ((AdapterIndex >= AGENT_MAX_ADAPTERS) || (0 == pSample->snapshot.sequence))
+    {
+        return;
+    }
+
+    uint64_t NowNs = pSample->snapshot.hostTimestampNs;
+    for (uint32_t s = 0; s < ANOMALY_STREAM_COUNT; s++)
+    {
+        double Value;
+        double SigmaFloor;
+        if (StreamValue(pSample, s, &Value, &SigmaFloor))
+        {
+            UpdateStream(pDetector, AdapterIndex, s, Value, SigmaFloor, NowNs);
+        }
+    }
+}
+
+const char *AnomalyStreamLabel(AnomalyStream Stream, char *pBuffer, size_t BufferSize)
+{
+    static const char *Names[] = { "gpu_power", "card_power", "gpu_frequency", "gpu_temperature", "vram_temperature", "vram_read", "vram_write" };
+    static_assert(sizeof(Names) / sizeof(Names[0]) == ANOMALY_STREAM_SENSOR_0, "one name per fixed stream");
+
+    if (Stream >= ANOMALY_STREAM_COUNT)
+    {
+        snprintf(pBuffer, BufferSize, "unknown");
+    }
+    else if (Stream >= ANOMALY_STREAM_FAN_0)
+    {
+        snprintf(pBuffer, BufferSize, "fan%u_rpm", Stream - ANOMALY_STREAM_FAN_0);
+    }
+    else if (Stream >= ANOMALY_STREAM_SENSOR_0)
+    {
+        snprintf(pBuffer, BufferSize, "temperature%u", Stream - ANOMALY_STREAM_SENSOR_0);
+    }
+    else
+    {
+        snprintf(pBuffer, BufferSize, "%s", Names[Stream]);
+    }
+    return pBuffer;
+}
+
+const char *AnomalyKindLabel(AnomalyKind Kind)
+{
+    switch (Kind)
+    {
+        case ANOMALY_KIND_SPIKE:
+            return "spike";
+        case ANOMALY_KIND_DRIFT_UP:
+            return "drift_up";
+        case ANOMALY_KIND_DRIFT_DOWN:
+            return "drift_down";
+        case ANOMALY_KIND_SEASONAL:
+            return "seasonal";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,151 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  AnomalyDetector.h
+ * @brief Streaming anomaly detection over the cached telemetry.
+ *
+ * Every pass of an adapter updates a fixed set of streams: GPU and card
+ * power, GPU clock, GPU and VRAM temperature, VRAM read and write
+ * throughput, each temperature sensor and each fan. Each stream runs three
+ * detectors in constant memory:
+ *
+ * - Spike: z-score of the sample against an exponentially weighted mean and
+ *   variance with a short time constant.
+ * - Drift: the short mean against a second one with a long time constant,
+ *   in units of the short standard deviation, held for a while. It catches
+ *   a fan slowly losing speed or a VRAM temperature creeping up long before
+ *   a hard limit is hit, while the short baseline has already followed.
+ * - Seasonal: z-score against the mean and variance of the same time of day
+ *   (or of any configured period) in earlier periods, in
+ *   ANOMALY_SEASON_BINS bins.
+ *
+ * All weights are derived from the time between samples, so results do not
+ * depend on the sampling period.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "TelemetryCache.h"
+
+#define ANOMALY_SEASON_BINS 24
+#define ANOMALY_SIGMA_FLOOR_WATTS 1.0
+#define ANOMALY_SIGMA_FLOOR_MHZ 10.0
+#define ANOMALY_SIGMA_FLOOR_CELSIUS 0.5
+#define ANOMALY_SIGMA_FLOOR_BYTES_PER_SEC 5e7
+#define ANOMALY_SIGMA_FLOOR_RPM 25.0
+
+enum AnomalyStream
+{
+    ANOMALY_STREAM_GPU_POWER = 0,
+    ANOMALY_STREAM_CARD_POWER,
+    ANOMALY_STREAM_GPU_FREQUENCY,
+    ANOMALY_STREAM_GPU_TEMPERATURE,
+    ANOMALY_STREAM_VRAM_TEMPERATURE,
+    ANOMALY_STREAM_VRAM_READ,
+    ANOMALY_STREAM_VRAM_WRITE,
+    ANOMALY_STREAM_SENSOR_0,
+    ANOMALY_STREAM_FAN_0 = ANOMALY_STREAM_SENSOR_0 + AGENT_MAX_TEMP_SENSORS,
+    ANOMALY_STREAM_COUNT = ANOMALY_STREAM_FAN_0 + AGENT_MAX_FANS
+};
+
+enum AnomalyKind
+{
+    ANOMALY_KIND_SPIKE = 0,
+    ANOMALY_KIND_DRIFT_UP,
+    ANOMALY_KIND_DRIFT_DOWN,
+    ANOMALY_KIND_SEASONAL,
+    ANOMALY_KIND_COUNT
+};
+
+struct AnomalyConfig
+{
+    double shortTauSec;     ///< Time constant of the spike baseline
+    double longTauSec;      ///< Time constant of the drift baseline
+    double spikeZ;          ///< |z| that raises a spike, cleared below half of it
+    double driftZ;          ///< Short mean minus long mean, in short standard deviations
+    double driftHoldSec;    ///< How long the drift must persist
+    double warmupSec;       ///< Spike and drift are armed after this much history
+    double seasonPeriodSec; ///< Length of one season, e.g. a day
+    double seasonZ;         ///< |z| against the seasonal bin
+    uint32_t seasonMinSamples;
+};
+
+struct AnomalyEvent
+{
+    uint32_t adapterIndex;
+    AnomalyStream stream;
+    AnomalyKind kind;
+    bool raised; ///< false when the stream returned to normal
+    double value;
+    double expected; ///< Baseline the value was compared with
+    double score;    ///< z-score, or drift in short standard deviations
+    uint64_t hostTimestampNs;
+};
+
+typedef void (*AnomalyCallback)(const AnomalyEvent *pEvent, void *pContext);
+
+struct AnomalySeasonBin
+{
+    double mean;
+    double variance;
+    uint32_t samples;
+    uint32_t seasons; ///< Distinct seasons that contributed
+    uint64_t lastSeason;
+};
+
+/***************************************************************
+ * @brief Detector state of one stream, a fixed size
+ ***************************************************************/
+struct AnomalyStreamState
+{
+    uint64_t firstNs; ///< 0 until the first sample
+    uint64_t lastNs;
+    double shortMean;
+    double shortVariance;
+    double longMean;
+    uint64_t driftSinceNs; ///< Start of the current drift excursion, 0 if none
+    uint32_t active;       ///< Bit per AnomalyKind
+    AnomalySeasonBin bins[ANOMALY_SEASON_BINS];
+};
+
+struct AnomalyDetector
+{
+    AnomalyConfig config;
+    AnomalyCallback pfnCallback;
+    void *pContext;
+    int64_t wallOffsetNs; ///< Wall clock minus host clock, places samples within a season
+
+    AnomalyStreamState streams[AGENT_MAX_ADAPTERS][ANOMALY_STREAM_COUNT];
+    uint64_t raised[ANOMALY_KIND_COUNT]; ///< Sampler private counts of raised events
+};
+
+/***************************************************************
+ * @brief Fills the default configuration
+ ***************************************************************/
+void AnomalyDefaultConfig(AnomalyConfig *pConfig);
+
+/***************************************************************
+ * @brief Prepares the detector and registers it as a cache listener
+ *
+ * pConfig may be nullptr for the defaults. pCache may be nullptr to feed
+ * passes through AnomalyDetectorEvaluate directly.
+ ***************************************************************/
+ctl_result_t AnomalyDetectorInit(AnomalyDetector *pDetector, const AnomalyConfig *pConfig, TelemetryCache *pCache, AnomalyCallback pfnCallback, void *pContext);
+
+/***************************************************************
+ * @brief Updates every stream present in one pass of an adapter
+ ***************************************************************/
+void AnomalyDetectorEvaluate(AnomalyDetector *pDetector, const PublishedSnapshot *pSample);
+
+const char *AnomalyStreamLabel(AnomalyStream Stream, char *pBuffer, size_t BufferSize);
+const char *AnomalyKindLabel(AnomalyKind Kind);
@@ -0,0 +1,159 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  Bench_AnomalyDetection.cpp
+ * @brief Feeds 8 simulated adapters at 100 Hz through the anomaly detector
+ *        and reports the cost per pass and the share of one core it takes.
+ *        Adapter 0 has a fan slowly losing speed and a VRAM temperature
+ *        creeping up; the time to detect both and the events raised on the
+ *        healthy adapters are reported too.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <random>
+
+#include "AnomalyDetector.h"
+
+#define BENCH_ADAPTER_COUNT 8
+#define BENCH_RATE_HZ 100
+#define BENCH_SIMULATED_SEC 1800
+#define BENCH_FAN_DECLINE_RPM_PER_MIN 10.0
+#define BENCH_VRAM_CREEP_CELSIUS_PER_MIN 0.2
+
+struct BenchContext
+{
+    double fanDetectedSec;
+    double vramDetectedSec;
+    uint64_t healthyEvents;
+    uint64_t startNs;
+};
+
+static void OnAnomaly(const AnomalyEvent *pEvent, void *pContext)
+{
+    BenchContext *pBench = static_cast<BenchContext *>(pContext);
+    if (!pEvent->raised)
+    {
+        return;
+    }
+
+    double AtSec = (pEvent->hostTimestampNs - pBench->startNs) / 1e9;
+    if (0 != pEvent->adapterIndex)
+    {
+        pBench->healthyEvents++;
+    }
+    else if ((ANOMALY_STREAM_FAN_0 == pEvent->stream) && (ANOMALY_KIND_DRIFT_DOWN == pEvent->kind) && (pBench->fanDetectedSec < 0.0))
+    {
+        pBench->fanDetectedSec = AtSec;
+    }
+    else if ((ANOMALY_STREAM_VRAM_TEMPERATURE == pEvent->stream) && (ANOMALY_KIND_DRIFT_UP == pEvent->kind) && (pBench->vramDetectedSec < 0.0))
+    {
+        pBench->vramDetectedSec = AtSec;
+    }
+}
+
+/***************************************************************
+ * @brief One pass of a simulated adapter under a 20 s periodic load
+ ***************************************************************/
+static void SimulatePass(PublishedSnapshot *pSample, uint32_t AdapterIndex, uint64_t NowNs, double Sec, std::mt19937 *pRandom)
+{
+    std::normal_distribution<double> Noise(0.0, 1.0);
+    double Load = 0.55 + 0.35 * sin(2.0 * 3.14159265358979 * Sec / 20.0 + AdapterIndex);
+
+    AdapterSnapshot *pSnapshot = &pSample->snapshot;
+    DerivedMetrics *pDerived   = &pSample->derived;
+    pSnapshot->sequence++;
+    pSnapshot->hostTimestampNs    = NowNs;
+    pSnapshot->adapterIndex       = AdapterIndex;
+    pSnapshot->telemetryResult    = CTL_RESULT_SUCCESS;
+    pSnapshot->telemetryValidMask = TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_GPU_FREQUENCY) | TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_GPU_TEMPERATURE) | TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_VRAM_TEMPERATURE);
+    pSnapshot->tempValidMask      = 0x7;
+    pSnapshot->fanValidMask       = 0x3;
+
+    double *pValues                          = pSnapshot->telemetryValues;
+    pValues[TELEMETRY_ITEM_GPU_FREQUENCY]    = 600.0 + 1800.0 * Load + 5.0 * Noise(*pRandom);
+    pValues[TELEMETRY_ITEM_GPU_TEMPERATURE]  = 40.0 + 40.0 * Load + 0.3 * Noise(*pRandom);
+    pValues[TELEMETRY_ITEM_VRAM_TEMPERATURE] = 60.0 + 0.3 * Noise(*pRandom);
+    for (uint32_t s = 0; s < 3; s++)
+    {
+        pSnapshot->temperature[s] = 40.0 + 40.0 * Load + 0.3 * Noise(*pRandom);
+    }
+    for (uint32_t f = 0; f < 2; f++)
+    {
+        pSnapshot->fanSpeedRpm[f] = static_cast<int32_t>(1500.0 + 20.0 * Noise(*pRandom));
+    }
+
+    pDerived->validMask            = DERIVED_VALID_GPU_POWER | DERIVED_VALID_CARD_POWER | DERIVED_VALID_VRAM_READ | DERIVED_VALID_VRAM_WRITE;
+    pDerived->gpuPowerW            = 30.0 + 150.0 * Load + 2.0 * Noise(*pRandom);
+    pDerived->cardPowerW           = pDerived->gpuPowerW + 25.0 + 1.0 * Noise(*pRandom);
+    pDerived->vramReadBytesPerSec  = 3e11 * Load * (1.0 + 0.02 * Noise(*pRandom));
+    pDerived->vramWriteBytesPerSec = 1.5e11 * Load * (1.0 + 0.02 * Noise(*pRandom));
+
+    // Slowly failing fan and creeping VRAM temperature on adapter 0
+    if (0 == AdapterIndex)
+    {
+        pSnapshot->fanSpeedRpm[0] -= static_cast<int32_t>(BENCH_FAN_DECLINE_RPM_PER_MIN * Sec / 60.0);
+        pValues[TELEMETRY_ITEM_VRAM_TEMPERATURE] += BENCH_VRAM_CREEP_CELSIUS_PER_MIN * Sec / 60.0;
+    }
+}
+
+int main()
+{
+    AnomalyDetector *pDetector  = new AnomalyDetector();
+    PublishedSnapshot *pSamples = new PublishedSnapshot[BENCH_ADAPTER_COUNT]();
+    BenchContext Bench          = { -1.0, -1.0, 0, 1000000000ull };
+    std::mt19937 Random(1234);
+
+    ctl_result_t Result = AnomalyDetectorInit(pDetector, nullptr, nullptr, OnAnomaly, &Bench);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        printf("[ERROR] AnomalyDetectorInit returned failure code: 0x%X\n", Result);
+        delete[] pSamples;
+        delete pDetector;
+        return 1;
+    }
+
+    const uint64_t Passes   = static_cast<uint64_t>(BENCH_SIMULATED_SEC) * BENCH_RATE_HZ;
+    const uint64_t PeriodNs = 1000000000ull / BENCH_RATE_HZ;
+    uint64_t BusyNs         = 0;
+    for (uint64_t p = 0; p < Passes; p++)
+    {
+        uint64_t NowNs = Bench.startNs + p * PeriodNs;
+        for (uint32_t a = 0; a < BENCH_ADAPTER_COUNT; a++)
+        {
+            SimulatePass(&pSamples[a], a, NowNs, p / static_cast<double>(BENCH_RATE_HZ), &Random);
+        }
+
+        uint64_t StartNs = AgentHostTimeNs();
+        for (uint32_t a = 0; a < BENCH_ADAPTER_COUNT; a++)
+        {
+            AnomalyDetectorEvaluate(pDetector, &pSamples[a]);
+        }
+        BusyNs += AgentHostTimeNs() - StartNs;
+    }
+
+    double PassNs    = static_cast<double>(BusyNs) / (Passes * BENCH_ADAPTER_COUNT);
+    double CoreShare = PassNs * BENCH_ADAPTER_COUNT * BENCH_RATE_HZ / 1e9;
+    printf("Adapters          : %u at %u Hz for %u simulated s\n", BENCH_ADAPTER_COUNT, BENCH_RATE_HZ, BENCH_SIMULATED_SEC);
+    printf("Streams           : %u per adapter, %llu bytes each\n", ANOMALY_STREAM_COUNT, static_cast<unsigned long long>(sizeof(AnomalyStreamState)));
+    printf("Evaluate          : %.0f ns per adapter pass\n", PassNs);
+    printf("Core share        : %.3f %%\n", 100.0 * CoreShare);
+    printf("Fan decline       : %.1f rpm/min, detected after %.0f s\n", BENCH_FAN_DECLINE_RPM_PER_MIN, Bench.fanDetectedSec);
+    printf("VRAM creep        : %.1f C/min, detected after %.0f s\n", BENCH_VRAM_CREEP_CELSIUS_PER_MIN, Bench.vramDetectedSec);
+    printf("Healthy events    : %llu\n", static_cast<unsigned long long>(Bench.healthyEvents));
+
+    delete[] pSamples;
+    delete pDetector;
+
+    bool Detected = (Bench.fanDetectedSec >= 0.0) && (Bench.vramDetectedSec >= 0.0);
+    return (Detected && (CoreShare < 1.0)) ? 0 : 1;
+}
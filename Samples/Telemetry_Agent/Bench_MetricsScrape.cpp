@@ -0,0 +1,136 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  Bench_MetricsScrape.cpp
+ * @brief Measures the /metrics render path over a primed cache of 8 adapters
+ *        and counts heap allocations made while scraping.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <vector>
+
+#include "igcl_api.h"
+#include "TelemetryCache.h"
+#include "MetricsExporter.h"
+
+#define BENCH_ADAPTER_COUNT 8
+#define BENCH_WARMUP_SCRAPES 16
+#define BENCH_SCRAPES 20000
+
+static std::atomic<uint64_t> AllocationCount(0);
+
+void *operator new(size_t Size)
+{
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    void *p = malloc((0 != Size) ? Size : 1);
+    if (nullptr == p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+int main()
+{
+#if !defined(_WIN32)
+    setenv("IGCL_STUB_ADAPTER_COUNT", "8", 0);
+#endif
+
+    ctl_init_args_t CtlInitArgs = {};
+    ctl_api_handle_t hAPIHandle = nullptr;
+    CtlInitArgs.AppVersion      = CTL_MAKE_VERSION(CTL_IMPL_MAJOR_VERSION, CTL_IMPL_MINOR_VERSION);
+    CtlInitArgs.flags           = CTL_INIT_FLAG_USE_LEVEL_ZERO;
+    CtlInitArgs.Size            = sizeof(CtlInitArgs);
+
+    ctl_result_t Result = ctlInit(&CtlInitArgs, &hAPIHandle);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        printf("[ERROR] ctlInit returned failure code: 0x%X\n", Result);
+        return 1;
+    }
+
+    uint32_t AdapterCount = 0;
+    ctlEnumerateDevices(hAPIHandle, &AdapterCount, nullptr);
+    std::vector<ctl_device_adapter_handle_t> Devices(AdapterCount);
+    ctlEnumerateDevices(hAPIHandle, &AdapterCount, Devices.data());
+
+    // Fewer real adapters than the benchmark needs: repeat them so every slot is populated
+    std::vector<ctl_device_adapter_handle_t> BenchDevices;
+    for (uint32_t i = 0; (0 != AdapterCount) && (i < BENCH_ADAPTER_COUNT); i++)
+    {
+        BenchDevices.push_back(Devices[i % AdapterCount]);
+    }
+
+    TelemetryCache *pCache     = new TelemetryCache();
+    MetricsExporter *pExporter = new MetricsExporter();
+    std::vector<uint64_t> Durations(BENCH_SCRAPES);
+
+    Result = TelemetryCacheInit(pCache, BenchDevices.data(), static_cast<uint32_t>(BenchDevices.size()), 0);
+    if (CTL_RESULT_SUCCESS == Result)
+    {
+        Result = MetricsExporterInit(pExporter, pCache, nullptr, 0);
+    }
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        printf("[ERROR] Setup returned failure code: 0x%X\n", Result);
+        delete pExporter;
+        delete pCache;
+        ctlClose(hAPIHandle);
+        return 1;
+    }
+
+    // Two passes so counter based metrics have a previous sample
+    TelemetryCacheSampleOnce(pCache);
+    TelemetryCacheSampleOnce(pCache);
+
+    for (uint32_t i = 0; i < BENCH_WARMUP_SCRAPES; i++)
+    {
+        MetricsExporterRender(pExporter);
+    }
+
+    uint64_t AllocationsBefore = AllocationCount.load();
+    for (uint32_t i = 0; i < BENCH_SCRAPES; i++)
+    {
+        uint64_t StartNs = AgentHostTimeNs();
+        MetricsExporterRender(pExporter);
+        Durations[i] = AgentHostTimeNs() - StartNs;
+    }
+    uint64_t Allocations = AllocationCount.load() - AllocationsBefore;
+
+    std::sort(Durations.begin(), Durations.end());
+    printf("Adapters          : %u\n", pCache->adapterCount);
+    printf("Body size         : %llu bytes\n", static_cast<unsigned long long>(pExporter->bodyLength));
+    printf("Scrapes           : %u\n", BENCH_SCRAPES);
+    printf("Render p50        : %.1f us\n", Durations[BENCH_SCRAPES / 2] / 1e3);
+    printf("Render p99        : %.1f us\n", Durations[BENCH_SCRAPES * 99 / 100] / 1e3);
+    printf("Render max        : %.1f us\n", Durations[BENCH_SCRAPES - 1] / 1e3);
+    printf("Heap allocations  : %llu\n", static_cast<unsigned long long>(Allocations));
+
+    delete pExporter;
+    delete pCache;
+    ctlClose(hAPIHandle);
+
+    return (0 == Allocations) ? 0 : 1;
+}
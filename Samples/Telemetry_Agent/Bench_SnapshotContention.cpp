@@ -0,0 +1,230 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  Bench_SnapshotContention.cpp
+ * @brief One writer publishing a snapshot at 1 kHz against many readers
+ *        copying it in a tight loop, seqlock or mutex baseline.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "SnapshotSeqlock.h"
+#include "TelemetryCache.h"
+
+#define BENCH_DEFAULT_READERS 32
+#define BENCH_DEFAULT_SECONDS 3
+#define BENCH_WRITE_PERIOD_US 1000
+#define BENCH_LATENCY_STRIDE 64
+#define BENCH_LATENCY_SAMPLES (1 << 16)
+
+/***************************************************************
+ * @brief Shared state, mutex fields are only used by the baseline
+ ***************************************************************/
+struct BenchState
+{
+    SnapshotSlot slot;
+    alignas(64) std::mutex lock;
+    PublishedSnapshot locked;
+    alignas(64) std::atomic<bool> stopRequested;
+    bool useMutex;
+};
+
+struct alignas(64) ReaderStats
+{
+    uint64_t reads;
+    uint64_t retries;
+    uint64_t torn;
+    uint32_t latencyCount;
+    std::vector<uint32_t> latencyNs;
+};
+
+/***************************************************************
+ * @brief Stamps the first, a middle and the last word of the payload
+ ***************************************************************/
+static void StampSnapshot(PublishedSnapshot *pSnapshot, uint64_t Value)
+{
+    pSnapshot->snapshot.sequence                                        = Value;
+    pSnapshot->snapshot.hostTimestampNs                                 = Value;
+    pSnapshot->snapshot.memState[AGENT_MAX_MEM_MODULES - 1].size        = Value;
+    pSnapshot->derived.engineUtilizationPct[AGENT_MAX_ENGINE_GROUPS - 1] = static_cast<double>(Value);
+}
+
+static bool SnapshotConsistent(const PublishedSnapshot *pSnapshot)
+{
+    uint64_t Value = pSnapshot->snapshot.sequence;
+    return (Value == pSnapshot->snapshot.hostTimestampNs) && (Value == pSnapshot->snapshot.memState[AGENT_MAX_MEM_MODULES - 1].size) &&
+           (static_cast<double>(Value) == pSnapshot->derived.engineUtilizationPct[AGENT_MAX_ENGINE_GROUPS - 1]);
+}
+
+static void ReaderThread(BenchState *pState, ReaderStats *pStats)
+{
+    PublishedSnapshot Copy;
+    while (!pState->stopRequested.load(std::memory_order_relaxed))
+    {
+        bool Timed       = (0 == (pStats->reads % BENCH_LATENCY_STRIDE)) && (pStats->latencyCount < BENCH_LATENCY_SAMPLES);
+        uint64_t StartNs = Timed ? AgentHostTimeNs() : 0;
+
+        if (pState->useMutex)
+        {
+            std::lock_guard<std::mutex> Guard(pState->lock);
+            Copy = pState->locked;
+        }
+        else
+        {
+            pStats->retries += SeqlockRead(&pState->slot.sequence, pState->slot.words, &Copy, sizeof(PublishedSnapshot), nullptr);
+        }
+
+        if (Timed)
+        {
+            pStats->latencyNs[pStats->latencyCount++] = static_cast<uint32_t>(AgentHostTimeNs() - StartNs);
+        }
+        if (!SnapshotConsistent(&Copy))
+        {
+            pStats->torn++;
+        }
+        pStats->reads++;
+    }
+}
+
+static void Usage()
+{
+    printf("Usage: Bench_SnapshotContention [-r readers] [-d seconds] [-m]\n");
+    printf("  -m  use a mutex protected copy instead of the seqlock\n");
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t ReaderCount = BENCH_DEFAULT_READERS;
+    uint32_t Seconds     = BENCH_DEFAULT_SECONDS;
+    BenchState *pState   = new BenchState();
+    pState->useMutex     = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "-r")) && (i + 1 < argc))
+        {
+            ReaderCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if ((0 == strcmp(argv[i], "-d")) && (i + 1 < argc))
+        {
+            Seconds = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if (0 == strcmp(argv[i], "-m"))
+        {
+            pState->useMutex = true;
+        }
+        else
+        {
+            Usage();
+            delete pState;
+            return 1;
+        }
+    }
+
+    PublishedSnapshot *pPayload = new PublishedSnapshot();
+    StampSnapshot(pPayload, 0);
+    pState->locked = *pPayload;
+    pState->slot.sequence.store(0);
+    SeqlockWrite(&pState->slot.sequence, pState->slot.words, pPayload, sizeof(PublishedSnapshot));
+    pState->stopRequested.store(false);
+
+    std::vector<ReaderStats> Stats(ReaderCount);
+    std::vector<std::thread> Readers;
+    for (uint32_t r = 0; r < ReaderCount; r++)
+    {
+        Stats[r] = {};
+        Stats[r].latencyNs.resize(BENCH_LATENCY_SAMPLES);
+        Readers.emplace_back(ReaderThread, pState, &Stats[r]);
+    }
+
+    // Writer runs on the main thread at a fixed 1 kHz schedule
+    uint32_t WriteCount = Seconds * (1000000 / BENCH_WRITE_PERIOD_US);
+    std::vector<uint64_t> PublishNs(WriteCount);
+    std::vector<uint64_t> JitterNs(WriteCount);
+    auto NextTick = std::chrono::steady_clock::now();
+    for (uint32_t w = 0; w < WriteCount; w++)
+    {
+        NextTick += std::chrono::microseconds(BENCH_WRITE_PERIOD_US);
+        std::this_thread::sleep_until(NextTick);
+        auto Woke   = std::chrono::steady_clock::now();
+        JitterNs[w] = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Woke - NextTick).count());
+
+        StampSnapshot(pPayload, w + 1);
+        uint64_t StartNs = AgentHostTimeNs();
+        if (pState->useMutex)
+        {
+            std::lock_guard<std::mutex> Guard(pState->lock);
+            pState->locked = *pPayload;
+        }
+        else
+        {
+            SeqlockWrite(&pState->slot.sequence, pState->slot.words, pPayload, sizeof(PublishedSnapshot));
+        }
+        PublishNs[w] = AgentHostTimeNs() - StartNs;
+    }
+
+    pState->stopRequested.store(true);
+    for (auto &Reader : Readers)
+    {
+        Reader.join();
+    }
+
+    uint64_t Reads   = 0;
+    uint64_t Retries = 0;
+    uint64_t Torn    = 0;
+    std::vector<uint32_t> Latencies;
+    for (auto &Reader : Stats)
+    {
+        Reads += Reader.reads;
+        Retries += Reader.retries;
+        Torn += Reader.torn;
+        Latencies.insert(Latencies.end(), Reader.latencyNs.begin(), Reader.latencyNs.begin() + Reader.latencyCount);
+    }
+
+    std::sort(Latencies.begin(), Latencies.end());
+    std::sort(PublishNs.begin(), PublishNs.end());
+    std::sort(JitterNs.begin(), JitterNs.end());
+    size_t LatencyCount = Latencies.size();
+
+    printf("Mode              : %s\n", pState->useMutex ? "mutex" : "seqlock");
+    printf("Payload           : %zu bytes\n", sizeof(PublishedSnapshot));
+    printf("Readers           : %u\n", ReaderCount);
+    printf("Publishes         : %u at %u Hz\n", WriteCount, 1000000 / BENCH_WRITE_PERIOD_US);
+    printf("Reads             : %.2f M/s\n", Reads / (Seconds * 1e6));
+    printf("Read retries      : %llu\n", static_cast<unsigned long long>(Retries));
+    if (0 != LatencyCount)
+    {
+        printf("Read p50          : %.1f us\n", Latencies[LatencyCount / 2] / 1e3);
+        printf("Read p99          : %.1f us\n", Latencies[LatencyCount * 99 / 100] / 1e3);
+        printf("Read p99.9        : %.1f us\n", Latencies[LatencyCount * 999 / 1000] / 1e3);
+        printf("Read max          : %.1f us\n", Latencies[LatencyCount - 1] / 1e3);
+    }
+    if (0 != WriteCount)
+    {
+        printf("Publish p50       : %.1f us\n", PublishNs[WriteCount / 2] / 1e3);
+        printf("Publish p99       : %.1f us\n", PublishNs[WriteCount * 99 / 100] / 1e3);
+        printf("Publish max       : %.1f us\n", PublishNs[WriteCount - 1] / 1e3);
+        printf("Wakeup jitter p99 : %.1f us\n", JitterNs[WriteCount * 99 / 100] / 1e3);
+    }
+    printf("Torn reads        : %llu\n", static_cast<unsigned long long>(Torn));
+
+    delete pPayload;
+    delete pState;
+
+    return (0 == Torn) ? 0 : 1;
+}
@@ -0,0 +1,586 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  Bench_TelemetryApi.cpp
+ * @brief Cost of every telemetry entry point the sample pass calls, on one
+ *        thread, from several threads on one adapter and from one thread
+ *        per adapter, with results saved as JSON and compared against a
+ *        saved baseline.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "igcl_api.h"
+#include "TelemetrySampler.h"
+
+#define BENCH_DEFAULT_ITERATIONS 2000
+#define BENCH_DEFAULT_MAX_THREADS 8
+#define BENCH_DEFAULT_TOLERANCE_PCT 25.0
+#define BENCH_DEFAULT_BUDGET_PCT 1.0 ///< Share of one core the sampler may spend in driver calls
+#define BENCH_WARMUP_CALLS 50
+#define BENCH_CLOCK_SAMPLES 10001
+
+enum BenchEntry
+{
+    BENCH_ENTRY_POWER_TELEMETRY = 0,
+    BENCH_ENTRY_ENGINE_ACTIVITY,
+    BENCH_ENTRY_FREQUENCY_STATE,
+    BENCH_ENTRY_TEMPERATURE_STATE,
+    BENCH_ENTRY_FAN_STATE,
+    BENCH_ENTRY_MEMORY_STATE,
+    BENCH_ENTRY_MEMORY_BANDWIDTH,
+    BENCH_ENTRY_PCI_STATE,
+    BENCH_ENTRY_ENERGY_COUNTER,
+    BENCH_ENTRY_COUNT
+};
+
+enum BenchMode
+{
+    BENCH_MODE_SINGLE = 0, ///< One thread, first adapter
+    BENCH_MODE_THREADS,    ///< Several threads, first adapter
+    BENCH_MODE_ADAPTERS,   ///< One thread per adapter
+    BENCH_MODE_COUNT
+};
+
+static const char *const BenchEntryNames[BENCH_ENTRY_COUNT] = { "ctlPowerTelemetryGet",   "ctlEngineGetActivity",  "ctlFrequencyGetState",
+                                                                "ctlTemperatureGetState", "ctlFanGetState",        "ctlMemoryGetState",
+                                                                "ctlMemoryGetBandwidth",  "ctlPciGetState",        "ctlPowerGetEnergyCounter" };
+static const char *const BenchModeNames[BENCH_MODE_COUNT]   = { "single", "threads", "adapters" };
+
+struct BenchResult
+{
+    BenchEntry entry;
+    BenchMode mode;
+    uint32_t threads;
+    uint64_t calls;
+    uint64_t failures;
+    double p50Ns;
+    double p99Ns;
+    double maxNs;
+    double callsPerSec; ///< All threads together
+};
+
+struct alignas(64) BenchWorker
+{
+    const AdapterTopology *pTopology;
+    BenchEntry entry;
+    uint32_t iterations;
+    uint64_t failures;
+    uint64_t startNs;
+    uint64_t endNs;
+    std::vector<uint32_t> latencyNs;
+};
+
+/***************************************************************
+ * @brief Handles of an entry point one sample pass calls it with
+ ***************************************************************/
+static uint32_t BenchHandleCount(const AdapterTopology *pTopology, BenchEntry Entry)
+{
+    switch (Entry)
+    {
+        case BENCH_ENTRY_ENGINE_ACTIVITY:
+            return pTopology->engineGroupCount;
+        case BENCH_ENTRY_FREQUENCY_STATE:
+            return pTopology->freqDomainCount;
+        case BENCH_ENTRY_TEMPERATURE_STATE:
+            return pTopology->tempSensorCount;
+        case BENCH_ENTRY_FAN_STATE:
+            return pTopology->fanCount;
+        case BENCH_ENTRY_MEMORY_STATE:
+        case BENCH_ENTRY_MEMORY_BANDWIDTH:
+            return pTopology->memModuleCount;
+        case BENCH_ENTRY_ENERGY_COUNTER:
+            return pTopology->powerDomainCount;
+        default:
+            return 1;
+    }
+}
+
+static ctl_result_t BenchCall(const AdapterTopology *pTopology, BenchEntry Entry, uint32_t Handle)
+{
+    switch (Entry)
+    {
+        case BENCH_ENTRY_POWER_TELEMETRY:
+        {
+            ctl_power_telemetry_t Telemetry = {};
+            Telemetry.Size                  = sizeof(ctl_power_telemetry_t);
+            Telemetry.Version               = 1;
+            return ctlPowerTelemetryGet(pTopology->hDevice, &Telemetry);
+        }
+        case BENCH_ENTRY_ENGINE_ACTIVITY:
+        {
+            ctl_engine_stats_t Stats = {};
+            Stats.Size               = sizeof(ctl_engine_stats_t);
+            return ctlEngineGetActivity(pTopology->hEngine[Handle], &Stats);
+        }
+        case BENCH_ENTRY_FREQUENCY_STATE:
+        {
+            ctl_freq_state_t State = {};
+            State.Size             = sizeof(ctl_freq_state_t);
+            return ctlFrequencyGetState(pTopology->hFreq[Handle], &State);
+        }
+        case BENCH_ENTRY_TEMPERATURE_STATE:
+        {
+            double Temperature = 0.0;
+            return ctlTemperatureGetState(pTopology->hTemp[Handle], &Temperature);
+        }
+        case BENCH_ENTRY_FAN_STATE:
+        {
+            int32_t Speed = 0;
+            return ctlFanGetState(pTopology->hFan[Handle], CTL_FAN_SPEED_UNITS_RPM, &Speed);
+        }
+        case BENCH_ENTRY_MEMORY_STATE:
+        {
+            ctl_mem_state_t State = {};
+            State.Size            = sizeof(ctl_mem_state_t);
+            return ctlMemoryGetState(pTopology->hMemory[Handle], &State);
+        }
+        case BENCH_ENTRY_MEMORY_BANDWIDTH:
+        {
+            ctl_mem_bandwidth_t Bandwidth = {};
+            Bandwidth.Size                = sizeof(ctl_mem_bandwidth_t);
+            Bandwidth.Version             = 1;
+            return ctlMemoryGetBandwidth(pTopology->hMemory[Handle], &Bandwidth);
+        }
+        case BENCH_ENTRY_PCI_STATE:
+        {
+            ctl_pci_state_t State = {};
+            State.Size            = sizeof(ctl_pci_state_t);
+            State.speed.Size      = sizeof(ctl_pci_speed_t);
+            return ctlPciGetState(pTopology->hDevice, &State);
+        }
+        case BENCH_ENTRY_ENERGY_COUNTER:
+        {
+            ctl_power_energy_counter_t Energy = {};
+            Energy.Size                       = sizeof(ctl_power_energy_counter_t);
+            return ctlPowerGetEnergyCounter(pTopology->hPower[Handle], &Energy);
+        }
+        default:
+            return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+}
+
+/***************************************************************
+ * @brief Times each call, cycling through the handles of the entry
+ ***************************************************************/
+static void BenchWorkerRun(BenchWorker *pWorker, std::atomic<uint32_t> *pReady, const std::atomic<bool> *pGo)
+{
+    uint32_t HandleCount = BenchHandleCount(pWorker->pTopology, pWorker->entry);
+    for (uint32_t i = 0; i < BENCH_WARMUP_CALLS; i++)
+    {
+        BenchCall(pWorker->pTopology, pWorker->entry, i % HandleCount);
+    }
+
+    pReady->fetch_add(1);
+    while (!pGo->load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+
+    pWorker->startNs = AgentHostTimeNs();
+    uint64_t LastNs  = pWorker->startNs;
+    for (uint32_t i = 0; i < pWorker->iterations; i++)
+    {
+        if (CTL_RESULT_SUCCESS != BenchCall(pWorker->pTopology, pWorker->entry, i % HandleCount))
+        {
+            pWorker->failures++;
+        }
+        uint64_t NowNs        = AgentHostTimeNs();
+        pWorker->latencyNs[i] = static_cast<uint32_t>(std::min<uint64_t>(NowNs - LastNs, UINT32_MAX));
+        LastNs                = NowNs;
+    }
+    pWorker->endNs = LastNs;
+}
+
+/***************************************************************
+ * @brief Runs one worker per topology entry and merges their latencies
+ ***************************************************************/
+static void BenchRun(const std::vector<const AdapterTopology *> &Targets, BenchEntry Entry, BenchMode Mode, uint32_t Iterations, BenchResult *pResult)
+{
+    std::vector<BenchWorker> Workers(Targets.size());
+    std::atomic<uint32_t> Ready(0);
+    std::atomic<bool> Go(false);
+    for (size_t w = 0; w < Workers.size(); w++)
+    {
+        Workers[w].pTopology  = Targets[w];
+        Workers[w].entry      = Entry;
+        Workers[w].iterations = Iterations;
+        Workers[w].failures   = 0;
+        Workers[w].latencyNs.resize(Iterations);
+    }
+
+    if (1 == Workers.size())
+    {
+        Go.store(true);
+        BenchWorkerRun(&Workers[0], &Ready, &Go);
+    }
+    else
+    {
+        std::vector<std::thread> Threads;
+        for (auto &Worker : Workers)
+        {
+            Threads.emplace_back(BenchWorkerRun, &Worker, &Ready, &Go);
+        }
+        while (Ready.load() < Workers.size())
+        {
+            std::this_thread::yield();
+        }
+        Go.store(true, std::memory_order_release);
+        for (auto &Thread : Threads)
+        {
+            Thread.join();
+        }
+    }
+
+    std::vector<uint32_t> Latencies;
+    uint64_t FirstNs = UINT64_MAX;
+    uint64_t LastNs  = 0;
+    pResult->entry    = Entry;
+    pResult->mode     = Mode;
+    pResult->threads  = static_cast<uint32_t>(Workers.size());
+    pResult->calls    = 0;
+    pResult->failures = 0;
+    for (auto &Worker : Workers)
+    {
+        Latencies.insert(Latencies.end(), Worker.latencyNs.begin(), Worker.latencyNs.end());
+        FirstNs = std::min(FirstNs, Worker.startNs);
+        LastNs  = std::max(LastNs, Worker.endNs);
+        pResult->calls += Worker.iterations;
+        pResult->failures += Worker.failures;
+    }
+
+    std::sort(Latencies.begin(), Latencies.end());
+    size_t Count         = Latencies.size();
+    pResult->p50Ns       = (0 != Count) ? Latencies[Count / 2] : 0.0;
+    pResult->p99Ns       = (0 != Count) ? Latencies[Count * 99 / 100] : 0.0;
+    pResult->maxNs       = (0 != Count) ? Latencies[Count - 1] : 0.0;
+    pResult->callsPerSec = (LastNs > FirstNs) ? pResult->calls * 1e9 / (LastNs - FirstNs) : 0.0;
+}
+
+/***************************************************************
+ * @brief Median cost of one host clock read, included in every latency
+ ***************************************************************/
+static double BenchClockOverheadNs()
+{
+    std::vector<uint32_t> Deltas(BENCH_CLOCK_SAMPLES);
+    uint64_t LastNs = AgentHostTimeNs();
+    for (auto &Delta : Deltas)
+    {
+        uint64_t NowNs = AgentHostTimeNs();
+        Delta          = static_cast<uint32_t>(NowNs - LastNs);
+        LastNs         = NowNs;
+    }
+    std::sort(Deltas.begin(), Deltas.end());
+    return Deltas[Deltas.size() / 2];
+}
+
+static void BenchWriteJson(FILE *pFile, const char *pDevice, uint32_t AdapterCount, uint32_t Iterations, double ClockNs, double PassNs, const std::vector<BenchResult> &Results)
+{
+    fprintf(pFile, "{\n");
+    fprintf(pFile, "  \"benchmark\": \"telemetry_api\",\n");
+    fprintf(pFile, "  \"device\": \"%s\",\n", pDevice);
+    fprintf(pFile, "  \"adapters\": %u,\n", AdapterCount);
+    fprintf(pFile, "  \"iterations\": %u,\n", Iterations);
+    fprintf(pFile, "  \"clock_overhead_ns\": %.1f,\n", ClockNs);
+    fprintf(pFile, "  \"sample_pass_ns\": %.1f,\n", PassNs);
+    fprintf(pFile, "  \"results\": [\n");
+    for (size_t r = 0; r < Results.size(); r++)
+    {
+        const BenchResult &Result = Results[r];
+        fprintf(pFile,
+                "    { \"entry\": \"%s\", \"mode\": \"%s\", \"threads\": %u, \"calls\": %llu, \"failures\": %llu, \"p50_ns\": %.1f, \"p99_ns\": %.1f, \"max_ns\": %.1f, "
+                "\"calls_per_sec\": %.1f }%s\n",
+                BenchEntryNames[Result.entry], BenchModeNames[Result.mode], Result.threads, static_cast<unsigned long long>(Result.calls), static_cast<unsigned long long>(Result.failures),
+                Result.p50Ns, Result.p99Ns, Result.maxNs, Result.callsPerSec, (r + 1 < Results.size()) ? "," : "");
+    }
+    fprintf(pFile, "  ]\n");
+    fprintf(pFile, "}\n");
+}
+
+/***************************************************************
+ * @brief Finds a number field of one result in a file written by -o
+ *
+ * Each result is written on a single line starting with its entry and
+ * mode, which is all this needs to know about the format.
+ ***************************************************************/
+static bool BenchBaselineValue(const std::string &Baseline, const BenchResult *pResult, const char *pField, double *pValue)
+{
+    char Key[128];
+    snprintf(Key, sizeof(Key), "\"entry\": \"%s\", \"mode\": \"%s\"", BenchEntryNames[pResult->entry], BenchModeNames[pResult->mode]);
+    size_t Line = Baseline.find(Key);
+    if (std::string::npos == Line)
+    {
+        return false;
+    }
+    size_t LineEnd = Baseline.find('\n', Line);
+    snprintf(Key, sizeof(Key), "\"%s\": ", pField);
+    size_t Field = Baseline.find(Key, Line);
+    if ((std::string::npos == Field) || (Field > LineEnd))
+    {
+        return false;
+    }
+    *pValue = strtod(Baseline.c_str() + Field + strlen(Key), nullptr);
+    return true;
+}
+
+/***************************************************************
+ * @brief Prints every result slower than the baseline beyond the tolerance
+ *
+ * Writes to pReport. Returns the number of regressions.
+ ***************************************************************/
+static uint32_t BenchCompare(FILE *pReport, const std::string &Baseline, const std::vector<BenchResult> &Results, double TolerancePct)
+{
+    double Limit         = 1.0 + TolerancePct / 100.0;
+    uint32_t Compared    = 0;
+    uint32_t Regressions = 0;
+    for (const auto &Result : Results)
+    {
+        double BaseP50  = 0.0;
+        double BaseRate = 0.0;
+        if (!BenchBaselineValue(Baseline, &Result, "p50_ns", &BaseP50) || !BenchBaselineValue(Baseline, &Result, "calls_per_sec", &BaseRate))
+        {
+            continue;
+        }
+        Compared++;
+
+        bool SlowerCall = (BaseP50 > 0.0) && (Result.p50Ns > BaseP50 * Limit);
+        bool LowerRate  = (BaseRate > 0.0) && (Result.callsPerSec * Limit < BaseRate);
+        if (SlowerCall || LowerRate)
+        {
+            fprintf(pReport, "[REGRESSION] %-24s %-8s p50 %.0f ns (baseline %.0f), %.0f calls/s (baseline %.0f)\n", BenchEntryNames[Result.entry], BenchModeNames[Result.mode],
+                    Result.p50Ns, BaseP50, Result.callsPerSec, BaseRate);
+            Regressions++;
+        }
+    }
+    fprintf(pReport, "Baseline          : %u results compared, %u regressions beyond %.0f %%\n", Compared, Regressions, TolerancePct);
+    return Regressions;
+}
+
+static bool BenchReadFile(const char *pPath, std::string *pText)
+{
+    FILE *pFile = fopen(pPath, "rb");
+    if (nullptr == pFile)
+    {
+        return false;
+    }
+    char Buffer[4096];
+    size_t Read = 0;
+    while (0 != (Read = fread(Buffer, 1, sizeof(Buffer), pFile)))
+    {
+        pText->append(Buffer, Read);
+    }
+    fclose(pFile);
+    return true;
+}
+
+static void Usage()
+{
+    printf("Usage: Bench_TelemetryApi [-n iterations] [-t threads] [-o results.json] [-b baseline.json] [-r tolerance_pct] [-p budget_pct]\n");
+    printf("  -o  write the results as JSON, - for stdout with the table and summary on stderr\n");
+    printf("  -b  compare with results written earlier by -o, exit with 2 on a regression\n");
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t Iterations   = BENCH_DEFAULT_ITERATIONS;
+    uint32_t ThreadCount  = std::max(2u, std::min<uint32_t>(std::thread::hardware_concurrency(), BENCH_DEFAULT_MAX_THREADS));
+    double TolerancePct   = BENCH_DEFAULT_TOLERANCE_PCT;
+    double BudgetPct      = BENCH_DEFAULT_BUDGET_PCT;
+    const char *pOutput   = nullptr;
+    const char *pBaseline = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "-n")) && (i + 1 < argc))
+        {
+            Iterations = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if ((0 == strcmp(argv[i], "-t")) && (i + 1 < argc))
+        {
+            ThreadCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if ((0 == strcmp(argv[i], "-o")) && (i + 1 < argc))
+        {
+            pOutput = argv[++i];
+        }
+        else if ((0 == strcmp(argv[i], "-b")) && (i + 1 < argc))
+        {
+            pBaseline = argv[++i];
+        }
+        else if ((0 == strcmp(argv[i], "-r")) && (i + 1 < argc))
+        {
+            TolerancePct = strtod(argv[++i], nullptr);
+        }
+        else if ((0 == strcmp(argv[i], "-p")) && (i + 1 < argc))
+        {
+            BudgetPct = strtod(argv[++i], nullptr);
+        }
+        else
+        {
+            Usage();
+            return 1;
+        }
+    }
+    if ((0 == Iterations) || (0 == ThreadCount))
+    {
+        Usage();
+        return 1;
+    }
+
+    // The table and summary make way for the JSON when it goes to stdout
+    FILE *pReport = ((nullptr != pOutput) && (0 == strcmp(pOutput, "-"))) ? stderr : stdout;
+
+    std::string Baseline;
+    if ((nullptr != pBaseline) && !BenchReadFile(pBaseline, &Baseline))
+    {
+        fprintf(pReport, "[ERROR] Cannot read baseline %s\n", pBaseline);
+        return 1;
+    }
+
+    ctl_init_args_t CtlInitArgs = {};
+    ctl_api_handle_t hAPIHandle = nullptr;
+    CtlInitArgs.AppVersion      = CTL_MAKE_VERSION(CTL_IMPL_MAJOR_VERSION, CTL_IMPL_MINOR_VERSION);
+    CtlInitArgs.flags           = CTL_INIT_FLAG_USE_LEVEL_ZERO;
+    CtlInitArgs.Size            = sizeof(CtlInitArgs);
+
+    ctl_result_t Result = ctlInit(&CtlInitArgs, &hAPIHandle);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        fprintf(pReport, "[ERROR] ctlInit returned failure code: 0x%X\n", Result);
+        return 1;
+    }
+
+    uint32_t AdapterCount = 0;
+    Result                = ctlEnumerateDevices(hAPIHandle, &AdapterCount, nullptr);
+    std::vector<ctl_device_adapter_handle_t> hAdapters(std::min<uint32_t>(AdapterCount, AGENT_MAX_ADAPTERS));
+    AdapterCount = static_cast<uint32_t>(hAdapters.size());
+    if ((CTL_RESULT_SUCCESS == Result) && (0 != AdapterCount))
+    {
+        Result = ctlEnumerateDevices(hAPIHandle, &AdapterCount, hAdapters.data());
+    }
+    if ((CTL_RESULT_SUCCESS != Result) || (0 == AdapterCount))
+    {
+        fprintf(pReport, "[ERROR] No adapters, ctlEnumerateDevices returned 0x%X\n", Result);
+        ctlClose(hAPIHandle);
+        return 1;
+    }
+
+    std::vector<AdapterTopology> Topologies(AdapterCount);
+    for (uint32_t a = 0; a < AdapterCount; a++)
+    {
+        EnumerateAdapterTopology(hAdapters[a], a, &Topologies[a]);
+    }
+
+    double ClockNs = BenchClockOverheadNs();
+    std::vector<BenchResult> Results;
+    double SingleP50Ns[BENCH_ENTRY_COUNT] = {};
+
+    fprintf(pReport, "%-26s %-9s %7s %10s %10s %10s %12s %8s\n", "Entry point", "Mode", "Threads", "p50 ns", "p99 ns", "max ns", "calls/s", "failed");
+    for (uint32_t e = 0; e < BENCH_ENTRY_COUNT; e++)
+    {
+        BenchEntry Entry = static_cast<BenchEntry>(e);
+        if (0 == BenchHandleCount(&Topologies[0], Entry))
+        {
+            fprintf(pReport, "%-26s not exposed by the first adapter\n", BenchEntryNames[Entry]);
+            continue;
+        }
+
+        for (uint32_t m = 0; m < BENCH_MODE_COUNT; m++)
+        {
+            BenchMode Mode = static_cast<BenchMode>(m);
+            std::vector<const AdapterTopology *> Targets;
+            if (BENCH_MODE_SINGLE == Mode)
+            {
+                Targets.push_back(&Topologies[0]);
+            }
+            else if (BENCH_MODE_THREADS == Mode)
+            {
+                Targets.assign(ThreadCount, &Topologies[0]);
+            }
+            else
+            {
+                for (const auto &Topology : Topologies)
+                {
+                    if (0 != BenchHandleCount(&Topology, Entry))
+                    {
+                        Targets.push_back(&Topology);
+                    }
+                }
+                if (Targets.size() < 2)
+                {
+                    continue;
+                }
+            }
+
+            BenchResult Run;
+            BenchRun(Targets, Entry, Mode, Iterations, &Run);
+            Results.push_back(Run);
+            if (BENCH_MODE_SINGLE == Mode)
+            {
+                SingleP50Ns[e] = Run.p50Ns;
+            }
+            fprintf(pReport, "%-26s %-9s %7u %10.0f %10.0f %10.0f %12.0f %8llu\n", BenchEntryNames[Entry], BenchModeNames[Mode], Run.threads, Run.p50Ns, Run.p99Ns, Run.maxNs,
+                    Run.callsPerSec, static_cast<unsigned long long>(Run.failures));
+        }
+    }
+
+    // Cost of one sample pass over every adapter at the single thread medians
+    double PassNs = 0.0;
+    for (const auto &Topology : Topologies)
+    {
+        for (uint32_t e = 0; e < BENCH_ENTRY_COUNT; e++)
+        {
+            PassNs += SingleP50Ns[e] * BenchHandleCount(&Topology, static_cast<BenchEntry>(e));
+        }
+    }
+
+    fprintf(pReport, "\n");
+    fprintf(pReport, "Adapters          : %u (%s)\n", AdapterCount, Topologies[0].name);
+    fprintf(pReport, "Iterations        : %u per thread\n", Iterations);
+    fprintf(pReport, "Clock read        : %.0f ns, included in every latency\n", ClockNs);
+    fprintf(pReport, "Sample pass       : %.1f us over all adapters\n", PassNs / 1e3);
+    if (PassNs > 0.0)
+    {
+        fprintf(pReport, "Polling budget    : %.1f Hz within %.1f %% of one core\n", BudgetPct / 100.0 * 1e9 / PassNs, BudgetPct);
+    }
+
+    if (nullptr != pOutput)
+    {
+        FILE *pFile = (0 == strcmp(pOutput, "-")) ? stdout : fopen(pOutput, "w");
+        if (nullptr == pFile)
+        {
+            fprintf(pReport, "[ERROR] Cannot write %s\n", pOutput);
+            ctlClose(hAPIHandle);
+            return 1;
+        }
+        BenchWriteJson(pFile, Topologies[0].name, AdapterCount, Iterations, ClockNs, PassNs, Results);
+        if (stdout != pFile)
+        {
+            fclose(pFile);
+        }
+    }
+
+    uint32_t Regressions = 0;
+    if (nullptr != pBaseline)
+    {
+        Regressions = BenchCompare(pReport, Baseline, Results, TolerancePct);
+    }
+
+    ctlClose(hAPIHandle);
+    return (0 == Regressions) ? 0 : 2;
+}
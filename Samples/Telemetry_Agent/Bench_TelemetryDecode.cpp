@@ -0,0 +1,197 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  Bench_TelemetryDecode.cpp
+ * @brief Compares the per item decode of the telemetry sample, which checks
+ *        bSupported and builds unit and data type strings for every item,
+ *        with the precompiled decode plan.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <map>
+#include <new>
+#include <string>
+
+#include "igcl_api.h"
+#include "TelemetryDecodePlan.h"
+#include "TelemetrySampler.h"
+
+#define BENCH_ITERATIONS 200000
+
+static std::atomic<uint64_t> AllocationCount(0);
+
+void *operator new(size_t Size)
+{
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    void *p = malloc((0 != Size) ? Size : 1);
+    if (nullptr == p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+// Same lookups as the Telemetry_Samples application
+static std::string DecodeCtlDataType(ctl_data_type_t Type)
+{
+    static const std::map<ctl_data_type_t, std::string> dataTypeStringMap = { { CTL_DATA_TYPE_INT8, "INT8" },     { CTL_DATA_TYPE_UINT8, "UINT8" },   { CTL_DATA_TYPE_INT16, "INT16" },
+                                                                              { CTL_DATA_TYPE_UINT16, "UINT16" }, { CTL_DATA_TYPE_INT32, "INT32" },   { CTL_DATA_TYPE_UINT32, "UINT32" },
+                                                                              { CTL_DATA_TYPE_INT64, "INT64" },   { CTL_DATA_TYPE_UINT64, "UINT64" }, { CTL_DATA_TYPE_FLOAT, "FLOAT" },
+                                                                              { CTL_DATA_TYPE_DOUBLE, "DOUBLE" } };
+
+    auto it = dataTypeStringMap.find(Type);
+    if (it != dataTypeStringMap.end())
+    {
+        return it->second;
+    }
+    return "Unknown datatype";
+}
+
+static std::string DecodeCtlUnits(ctl_units_t Units)
+{
+    static const std::map<ctl_units_t, std::string> unitsStringMap = { { CTL_UNITS_FREQUENCY_MHZ, "Frequency in MHz" },
+                                                                       { CTL_UNITS_VOLTAGE_VOLTS, "Voltage in Volts" },
+                                                                       { CTL_UNITS_POWER_WATTS, "Power in Watts" },
+                                                                       { CTL_UNITS_TEMPERATURE_CELSIUS, "Temperature in Celsius" },
+                                                                       { CTL_UNITS_ENERGY_JOULES, "Energy in Joules" },
+                                                                       { CTL_UNITS_TIME_SECONDS, "Time in Seconds" },
+                                                                       { CTL_UNITS_MEMORY_BYTES, "Memory in Bytes" },
+                                                                       { CTL_UNITS_ANGULAR_SPEED_RPM, "Angular Speed in RPM" },
+                                                                       { CTL_UNITS_POWER_MILLIWATTS, "Power in Milli Watts" },
+                                                                       { CTL_UNITS_PERCENT, "Units in Percentage" },
+                                                                       { CTL_UNITS_VOLTAGE_MILLIVOLTS, "Voltage in MilliVolts" },
+                                                                       { CTL_UNITS_BANDWIDTH_MBPS, "Bandwidth in MegaBytes Per Second" } };
+
+    auto it = unitsStringMap.find(Units);
+    if (it != unitsStringMap.end())
+    {
+        return it->second;
+    }
+    return "Unknown unit";
+}
+
+/***************************************************************
+ * @brief Per item path: bSupported check and string decode on every item
+ ***************************************************************/
+static uint64_t DecodeReference(const ctl_power_telemetry_t *pTelemetry, double *pValues, size_t *pTextBytes)
+{
+    const char *pBase = reinterpret_cast<const char *>(pTelemetry);
+    uint64_t Mask     = 0;
+    for (uint32_t Id = 0; Id < TELEMETRY_ITEM_COUNT; Id++)
+    {
+        const ctl_oc_telemetry_item_t *pItem = reinterpret_cast<const ctl_oc_telemetry_item_t *>(pBase + TelemetryItemOffset(Id));
+        if (pItem->bSupported)
+        {
+            std::string Units = DecodeCtlUnits(pItem->units);
+            std::string Type  = DecodeCtlDataType(pItem->type);
+            *pTextBytes += Units.size() + Type.size();
+
+            double Scale = ((CTL_UNITS_POWER_MILLIWATTS == pItem->units) || (CTL_UNITS_VOLTAGE_MILLIVOLTS == pItem->units)) ? 1e-3 : 1.0;
+            pValues[Id]  = TelemetryItemToDouble(*pItem) * Scale;
+            Mask |= TELEMETRY_ITEM_BIT(Id);
+        }
+    }
+    return Mask;
+}
+
+int main()
+{
+    ctl_init_args_t CtlInitArgs = {};
+    ctl_api_handle_t hAPIHandle = nullptr;
+    CtlInitArgs.AppVersion      = CTL_MAKE_VERSION(CTL_IMPL_MAJOR_VERSION, CTL_IMPL_MINOR_VERSION);
+    CtlInitArgs.flags           = CTL_INIT_FLAG_USE_LEVEL_ZERO;
+    CtlInitArgs.Size            = sizeof(CtlInitArgs);
+
+    ctl_result_t Result = ctlInit(&CtlInitArgs, &hAPIHandle);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        printf("[ERROR] ctlInit returned failure code: 0x%X\n", Result);
+        return 1;
+    }
+
+    uint32_t AdapterCount                = 1;
+    ctl_device_adapter_handle_t hAdapter = nullptr;
+    Result                               = ctlEnumerateDevices(hAPIHandle, &AdapterCount, &hAdapter);
+
+    ctl_power_telemetry_t Telemetry = {};
+    Telemetry.Size                  = sizeof(ctl_power_telemetry_t);
+    Telemetry.Version               = 1;
+    if (CTL_RESULT_SUCCESS == Result)
+    {
+        Result = ctlPowerTelemetryGet(hAdapter, &Telemetry);
+    }
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        printf("[ERROR] Telemetry sample returned failure code: 0x%X\n", Result);
+        ctlClose(hAPIHandle);
+        return 1;
+    }
+
+    TelemetryDecodePlan Plan;
+    TelemetryDecodePlanBuild(&Telemetry, &Plan);
+
+    double ReferenceValues[TELEMETRY_ITEM_COUNT] = {};
+    double PlanValues[TELEMETRY_ITEM_COUNT]      = {};
+    size_t TextBytes                             = 0;
+    uint64_t ReferenceMask                       = 0;
+    uint64_t PlanMask                            = 0;
+
+    uint64_t AllocationsBefore = AllocationCount.load();
+    uint64_t StartNs           = AgentHostTimeNs();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        ReferenceMask = DecodeReference(&Telemetry, ReferenceValues, &TextBytes);
+    }
+    uint64_t ReferenceNs          = AgentHostTimeNs() - StartNs;
+    uint64_t ReferenceAllocations = AllocationCount.load() - AllocationsBefore;
+
+    AllocationsBefore = AllocationCount.load();
+    StartNs           = AgentHostTimeNs();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        PlanMask = TelemetryDecodePlanExtract(&Plan, &Telemetry, PlanValues);
+    }
+    uint64_t PlanNs          = AgentHostTimeNs() - StartNs;
+    uint64_t PlanAllocations = AllocationCount.load() - AllocationsBefore;
+
+    uint32_t Mismatches = (ReferenceMask != PlanMask) ? 1 : 0;
+    for (uint32_t Id = 0; Id < TELEMETRY_ITEM_COUNT; Id++)
+    {
+        if ((0 != (PlanMask & TELEMETRY_ITEM_BIT(Id))) && (ReferenceValues[Id] != PlanValues[Id]))
+        {
+            Mismatches++;
+        }
+    }
+
+    printf("Items in struct   : %u\n", static_cast<uint32_t>(TELEMETRY_ITEM_COUNT));
+    printf("Supported items   : %u\n", Plan.entryCount);
+    printf("Iterations        : %u\n", BENCH_ITERATIONS);
+    printf("Per item decode   : %.1f ns/sample, %.2f allocations/sample\n", static_cast<double>(ReferenceNs) / BENCH_ITERATIONS, static_cast<double>(ReferenceAllocations) / BENCH_ITERATIONS);
+    printf("Decode plan       : %.1f ns/sample, %.2f allocations/sample\n", static_cast<double>(PlanNs) / BENCH_ITERATIONS, static_cast<double>(PlanAllocations) / BENCH_ITERATIONS);
+    printf("Speedup           : %.1fx\n", (0 != PlanNs) ? static_cast<double>(ReferenceNs) / PlanNs : 0.0);
+    printf("Value mismatches  : %u\n", Mismatches);
+    printf("(%zu bytes of unit text built)\n", TextBytes);
+
+    ctlClose(hAPIHandle);
+    return ((0 == Mismatches) && (0 == PlanAllocations)) ? 0 : 1;
+}
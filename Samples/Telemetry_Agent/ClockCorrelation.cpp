@@ -0,0 +1,273 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  ClockCorrelation.cpp
+ * @brief Maps driver timestamps of every clock domain onto the host clock.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "ClockCorrelation.h"
+#include "TimeSeriesStore.h"
+
+#define CLOCK_CORRELATION_BRACKET_SMOOTHING 0.05 ///< Weight of the newest bracket in the mean width
+
+/***************************************************************
+ * @brief Feeds the lowest valid handle of every domain in a pass
+ *
+ * Handles of the same type are not promised a common base either, so one
+ * handle per domain keeps a single fit consistent.
+ ***************************************************************/
+static void ClockListener(const AdapterSnapshot *pPrevious, const PublishedSnapshot *pCurrent, void *pContext)
+{
+    (void)pPrevious;
+    ClockCorrelator *pCorrelator     = static_cast<ClockCorrelator *>(pContext);
+    const AdapterSnapshot *pSnapshot = &pCurrent->snapshot;
+    uint32_t Adapter                 = pSnapshot->adapterIndex;
+
+    if ((CTL_RESULT_SUCCESS == pSnapshot->telemetryResult) && (0 != (pSnapshot->telemetryValidMask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_TIMESTAMP))))
+    {
+        ClockCorrelatorObserve(pCorrelator, Adapter, CLOCK_DOMAIN_POWER_TELEMETRY, pSnapshot->telemetryValues[TELEMETRY_ITEM_TIMESTAMP], &pSnapshot->telemetryBracket);
+    }
+
+    for (uint32_t i = 0; i < AGENT_MAX_FREQ_DOMAINS; i++)
+    {
+        if (0 != (pSnapshot->throttleValidMask & CTL_BIT(i)))
+        {
+            ClockCorrelatorObserve(pCorrelator, Adapter, CLOCK_DOMAIN_THROTTLE, pSnapshot->throttleTime[i].timestamp / 1e6, &pSnapshot->throttleBracket[i]);
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; i < AGENT_MAX_ENGINE_GROUPS; i++)
+    {
+        if (0 != (pSnapshot->engineValidMask & CTL_BIT(i)))
+        {
+            ClockCorrelatorObserve(pCorrelator, Adapter, CLOCK_DOMAIN_ENGINE, pSnapshot->engineStats[i].timestamp / 1e6, &pSnapshot->engineBracket[i]);
+            break;
+        }
+    }
+}
+
+ctl_result_t ClockCorrelatorInit(ClockCorrelator *pCorrelator, double WindowSec, TelemetryCache *pCache)
+{
+    if (nullptr == pCorrelator)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (!(WindowSec > 0.0))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    {
+        std::lock_guard<std::mutex> Guard(pCorrelator->lock);
+        pCorrelator->windowSec = WindowSec;
+        memset(pCorrelator->fits, 0, sizeof(pCorrelator->fits));
+    }
+
+    return (nullptr != pCache) ? TelemetryCacheAddListener(pCache, ClockListener, pCorrelator) : CTL_RESULT_SUCCESS;
+}
+
+/***************************************************************
+ * @brief Slope of the fit in host ns per device second
+ ***************************************************************/
+static double FitSlope(const ClockFitState *pFit)
+{
+    return (pFit->comomentXX > 0.0) ? pFit->comomentXY / pFit->comomentXX : 1e9;
+}
+
+/***************************************************************
+ * @brief Host ns since the reference at X device seconds since it
+ ***************************************************************/
+static double FitPredict(const ClockFitState *pFit, double X)
+{
+    return pFit->meanY + FitSlope(pFit) * (X - pFit->meanX);
+}
+
+/***************************************************************
+ * @brief Bound of a timestamp mapped at X device seconds since the reference
+ ***************************************************************/
+static double FitErrorBound(const ClockFitState *pFit, double X)
+{
+    double Leverage = (pFit->comomentXX > 0.0) ? (X - pFit->meanX) * (X - pFit->meanX) / pFit->comomentXX : 0.0;
+    double Variance = pFit->residualVariance * (1.0 + 1.0 / pFit->weight + Leverage);
+    return CLOCK_CORRELATION_BOUND_SIGMAS * sqrt(Variance) + pFit->meanHalfWidthNs;
+}
+
+/***************************************************************
+ * @brief Drops the fit, keeps the counters
+ ***************************************************************/
+static void FitRestart(ClockFitState *pFit)
+{
+    uint64_t Rejected = pFit->rejected;
+    uint64_t Resets   = pFit->resets;
+    memset(pFit, 0, sizeof(ClockFitState));
+    pFit->rejected = Rejected;
+    pFit->resets   = Resets + 1;
+}
+
+ctl_result_t ClockCorrelatorObserve(ClockCorrelator *pCorrelator, uint32_t AdapterIndex, ClockDomain Domain, double DeviceSec, const HostBracket *pBracket)
+{
+    if ((nullptr == pCorrelator) || (nullptr == pBracket))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((AdapterIndex >= AGENT_MAX_ADAPTERS) || (Domain >= CLOCK_DOMAIN_COUNT) || (pBracket->endNs < pBracket->startNs))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    double HalfWidthNs = (pBracket->endNs - pBracket->startNs) / 2.0;
+    uint64_t MidNs     = pBracket->startNs + (pBracket->endNs - pBracket->startNs) / 2;
+
+    std::lock_guard<std::mutex> Guard(pCorrelator->lock);
+    ClockFitState *pFit = &pCorrelator->fits[AdapterIndex][Domain];
+
+    // A wide bracket says little about either clock, so it can neither feed nor restart the fit
+    if (0 != pFit->observations)
+    {
+        bool Wide = (pFit->observations >= CLOCK_CORRELATION_MIN_OBSERVATIONS) && (HalfWidthNs > CLOCK_CORRELATION_REJECT_FACTOR * pFit->meanHalfWidthNs);
+        pFit->meanHalfWidthNs += CLOCK_CORRELATION_BRACKET_SMOOTHING * (HalfWidthNs - pFit->meanHalfWidthNs);
+        if (Wide)
+        {
+            pFit->rejected++;
+            return CTL_RESULT_SUCCESS;
+        }
+    }
+
+    // A device clock that went backwards or jumped away from the fit has a new base
+    double Residual = 0.0;
+    if (0 != pFit->observations)
+    {
+        Residual       = static_cast<double>(static_cast<int64_t>(MidNs - pFit->referenceHostNs)) - FitPredict(pFit, DeviceSec - pFit->referenceDeviceSec);
+        bool Backwards = (DeviceSec < pFit->lastDeviceSec);
+        bool Jumped    = (pFit->observations >= CLOCK_CORRELATION_MIN_OBSERVATIONS) && (fabs(Residual) > CLOCK_CORRELATION_RESET_NS);
+        if (Backwards || Jumped)
+        {
+            FitRestart(pFit);
+        }
+    }
+
+    if (0 == pFit->observations)
+    {
+        pFit->referenceHostNs    = MidNs;
+        pFit->referenceDeviceSec = DeviceSec;
+        pFit->meanHalfWidthNs    = HalfWidthNs;
+    }
+
+    // Exponentially weighted means and co-moments, updated in place
+    double Decay = (0 != pFit->observations) ? 1.0 - TimeSeriesEwmaWeight((MidNs - pFit->lastHostNs) / 1e9, pCorrelator->windowSec) : 0.0;
+    double X     = DeviceSec - pFit->referenceDeviceSec;
+    double Y     = static_cast<double>(static_cast<int64_t>(MidNs - pFit->referenceHostNs));
+    pFit->weight = Decay * pFit->weight + 1.0;
+
+    double DeltaX = X - pFit->meanX;
+    double DeltaY = Y - pFit->meanY;
+    pFit->meanX += DeltaX / pFit->weight;
+    pFit->meanY += DeltaY / pFit->weight;
+    pFit->comomentXX = Decay * pFit->comomentXX + DeltaX * (X - pFit->meanX);
+    pFit->comomentXY = Decay * pFit->comomentXY + DeltaX * (Y - pFit->meanY);
+
+    // Residuals against the fit before this observation, once it has a slope
+    if (pFit->observations >= CLOCK_CORRELATION_MIN_OBSERVATIONS)
+    {
+        double Gain = (CLOCK_CORRELATION_MIN_OBSERVATIONS == pFit->observations) ? 1.0 : 1.0 / pFit->weight;
+        pFit->residualVariance += Gain * (Residual * Residual - pFit->residualVariance);
+    }
+
+    pFit->lastDeviceSec = DeviceSec;
+    pFit->lastHostNs    = MidNs;
+    pFit->observations++;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t ClockCorrelatorToHost(ClockCorrelator *pCorrelator, uint32_t AdapterIndex, ClockDomain Domain, double DeviceSec, uint64_t *pHostNs, double *pErrorBoundNs)
+{
+    if ((nullptr == pCorrelator) || (nullptr == pHostNs))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((AdapterIndex >= AGENT_MAX_ADAPTERS) || (Domain >= CLOCK_DOMAIN_COUNT))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pCorrelator->lock);
+    const ClockFitState *pFit = &pCorrelator->fits[AdapterIndex][Domain];
+    if (pFit->observations < CLOCK_CORRELATION_MIN_OBSERVATIONS)
+    {
+        return CTL_RESULT_ERROR_NOT_AVAILABLE;
+    }
+
+    double X      = DeviceSec - pFit->referenceDeviceSec;
+    double HostNs = static_cast<double>(pFit->referenceHostNs) + FitPredict(pFit, X);
+    *pHostNs      = (HostNs > 0.0) ? static_cast<uint64_t>(HostNs + 0.5) : 0;
+    if (nullptr != pErrorBoundNs)
+    {
+        *pErrorBoundNs = FitErrorBound(pFit, X);
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t ClockCorrelatorRead(ClockCorrelator *pCorrelator, uint32_t AdapterIndex, ClockDomain Domain, ClockDomainStats *pStats)
+{
+    if ((nullptr == pCorrelator) || (nullptr == pStats))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((AdapterIndex >= AGENT_MAX_ADAPTERS) || (Domain >= CLOCK_DOMAIN_COUNT))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pCorrelator->lock);
+    const ClockFitState *pFit = &pCorrelator->fits[AdapterIndex][Domain];
+    double X                  = pFit->lastDeviceSec - pFit->referenceDeviceSec;
+
+    memset(pStats, 0, sizeof(ClockDomainStats));
+    pStats->adapterIndex = AdapterIndex;
+    pStats->domain       = Domain;
+    pStats->valid        = (pFit->observations >= CLOCK_CORRELATION_MIN_OBSERVATIONS);
+    pStats->observations = pFit->observations;
+    pStats->rejected     = pFit->rejected;
+    pStats->resets       = pFit->resets;
+    pStats->lastHostNs   = pFit->lastHostNs;
+    pStats->bracketNs    = 2.0 * pFit->meanHalfWidthNs;
+    if (pStats->valid)
+    {
+        pStats->offsetSec     = (pFit->referenceHostNs + FitPredict(pFit, X)) / 1e9 - pFit->lastDeviceSec;
+        pStats->driftPpm      = (FitSlope(pFit) / 1e9 - 1.0) * 1e6;
+        pStats->residualRmsNs = sqrt(pFit->residualVariance);
+        pStats->errorBoundNs  = FitErrorBound(pFit, X);
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+const char *ClockDomainLabel(ClockDomain Domain)
+{
+    switch (Domain)
+    {
+        case CLOCK_DOMAIN_POWER_TELEMETRY:
+            return "power_telemetry";
+        case CLOCK_DOMAIN_THROTTLE:
+            return "throttle";
+        case CLOCK_DOMAIN_ENGINE:
+            return "engine";
+        case CLOCK_DOMAIN_MEM_BANDWIDTH:
+            return "mem_bandwidth";
+        case CLOCK_DOMAIN_VBLANK:
+            return "vblank";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,136 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  ClockCorrelation.h
+ * @brief Maps driver timestamps of every clock domain onto the host clock.
+ *
+ * The timestamps of ctl_power_telemetry_t, ctl_freq_throttle_time_t,
+ * ctl_engine_stats_t, ctl_mem_bandwidth_t and ctl_vblank_ts_args_t are not
+ * guaranteed to share a base with each other or with the host. Every driver
+ * call that returns one is bracketed by two host steady clock reads; the
+ * device timestamp is paired with the midpoint of the bracket.
+ *
+ * Per adapter and domain, an exponentially weighted least squares fit of host
+ * time against device time gives the offset and the drift of the device
+ * clock. Observations with an unusually wide bracket, e.g. when the sampler
+ * was preempted inside the call, are left out of the fit. A device timestamp
+ * going backwards or landing far from the fit restarts it.
+ *
+ * The error bound of a mapped timestamp is three standard deviations of a
+ * single observation around the fit at that point, which covers timestamp
+ * resolution and jitter, plus the mean half width of the brackets, since
+ * the driver may stamp anywhere within the call.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <mutex>
+
+#include "TelemetryCache.h"
+
+#define CLOCK_CORRELATION_DEFAULT_WINDOW_SEC 300.0 ///< Time constant of the fit
+#define CLOCK_CORRELATION_MIN_OBSERVATIONS 8
+#define CLOCK_CORRELATION_REJECT_FACTOR 4.0 ///< Brackets wider than this times the mean are not fitted
+#define CLOCK_CORRELATION_RESET_NS 1e8      ///< Residual that restarts the fit
+#define CLOCK_CORRELATION_BOUND_SIGMAS 3.0
+
+enum ClockDomain
+{
+    CLOCK_DOMAIN_POWER_TELEMETRY = 0, ///< ctl_power_telemetry_t timeStamp
+    CLOCK_DOMAIN_THROTTLE,            ///< ctl_freq_throttle_time_t timestamp
+    CLOCK_DOMAIN_ENGINE,              ///< ctl_engine_stats_t timestamp
+    CLOCK_DOMAIN_MEM_BANDWIDTH,       ///< ctl_mem_bandwidth_t timestamp
+    CLOCK_DOMAIN_VBLANK,              ///< ctl_vblank_ts_args_t VblankTS
+    CLOCK_DOMAIN_COUNT
+};
+
+/***************************************************************
+ * @brief Running fit of one clock domain, host ns against device s
+ *
+ * Both axes are kept relative to the first observation so the sums stay
+ * small enough for doubles.
+ ***************************************************************/
+struct ClockFitState
+{
+    uint64_t observations;
+    uint64_t rejected;
+    uint64_t resets;
+    uint64_t referenceHostNs;
+    double referenceDeviceSec;
+    double lastDeviceSec;
+    uint64_t lastHostNs;
+    double weight; ///< Sum of the decayed weights
+    double meanX;  ///< Device seconds since the reference
+    double meanY;  ///< Host ns since the reference
+    double comomentXX;
+    double comomentXY;
+    double residualVariance; ///< Of each observation against the fit before it, ns^2
+    double meanHalfWidthNs;
+};
+
+/***************************************************************
+ * @brief Correlation of one clock domain with the host clock
+ ***************************************************************/
+struct ClockDomainStats
+{
+    uint32_t adapterIndex;
+    ClockDomain domain;
+    bool valid;            ///< Enough observations for a fit
+    double offsetSec;      ///< Host minus device time at the latest observation
+    double driftPpm;       ///< Device clock rate error, positive when it runs slow
+    double residualRmsNs;  ///< Spread of the observations around the fit
+    double bracketNs;      ///< Mean width of the brackets
+    double errorBoundNs;   ///< Bound of a timestamp mapped at the latest observation
+    uint64_t observations; ///< Fitted since the last restart
+    uint64_t rejected;
+    uint64_t resets;
+    uint64_t lastHostNs;
+};
+
+struct ClockCorrelator
+{
+    double windowSec;
+
+    std::mutex lock; ///< Observations come from the cache and the bandwidth sampler threads
+    ClockFitState fits[AGENT_MAX_ADAPTERS][CLOCK_DOMAIN_COUNT];
+};
+
+/***************************************************************
+ * @brief Prepares the correlator and registers it as a cache listener
+ *
+ * pCache may be nullptr to feed observations only through
+ * ClockCorrelatorObserve or MemoryBandwidthAttachClockCorrelator.
+ ***************************************************************/
+ctl_result_t ClockCorrelatorInit(ClockCorrelator *pCorrelator, double WindowSec, TelemetryCache *pCache);
+
+/***************************************************************
+ * @brief Adds one device timestamp taken inside the given bracket
+ *
+ * DeviceSec is the driver timestamp converted to seconds, e.g. the
+ * microsecond counters divided by 1e6.
+ ***************************************************************/
+ctl_result_t ClockCorrelatorObserve(ClockCorrelator *pCorrelator, uint32_t AdapterIndex, ClockDomain Domain, double DeviceSec, const HostBracket *pBracket);
+
+/***************************************************************
+ * @brief Maps a device timestamp onto the host steady clock
+ *
+ * Returns CTL_RESULT_ERROR_NOT_AVAILABLE until the domain has
+ * CLOCK_CORRELATION_MIN_OBSERVATIONS. pErrorBoundNs may be nullptr.
+ ***************************************************************/
+ctl_result_t ClockCorrelatorToHost(ClockCorrelator *pCorrelator, uint32_t AdapterIndex, ClockDomain Domain, double DeviceSec, uint64_t *pHostNs, double *pErrorBoundNs);
+
+ctl_result_t ClockCorrelatorRead(ClockCorrelator *pCorrelator, uint32_t AdapterIndex, ClockDomain Domain, ClockDomainStats *pStats);
+
+/***************************************************************
+ * @brief Lower case domain name used in labels
+ ***************************************************************/
+const char *ClockDomainLabel(ClockDomain Domain);
@@ -0,0 +1,319 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  EccMonitor.cpp
+ * @brief Current and pending ECC state of every adapter, and bulk changes.
+ *
+ */
+
+#include <string.h>
+
+#include "EccMonitor.h"
+
+ctl_result_t EccMonitorInit(EccMonitor *pMonitor, const AdapterTopology *pTopologies, uint32_t AdapterCount, uint32_t PeriodMs)
+{
+    if ((nullptr == pMonitor) || (nullptr == pTopologies))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pMonitor->adapterCount = (AdapterCount < AGENT_MAX_ADAPTERS) ? AdapterCount : AGENT_MAX_ADAPTERS;
+    pMonitor->periodMs     = (0 != PeriodMs) ? PeriodMs : ECC_MONITOR_DEFAULT_PERIOD_MS;
+    pMonitor->stopRequested.store(false);
+    memset(pMonitor->working, 0, sizeof(pMonitor->working));
+    memset(pMonitor->rebootPendingSinceNs, 0, sizeof(pMonitor->rebootPendingSinceNs));
+
+    uint32_t Supported = 0;
+    for (uint32_t i = 0; i < pMonitor->adapterCount; i++)
+    {
+        EccAdapterStats *pStats = &pMonitor->working[i];
+        pMonitor->hDevices[i]   = pTopologies[i].hDevice;
+        pStats->adapterIndex    = pTopologies[i].adapterIndex;
+        pStats->requested       = CTL_ECC_STATE_MAX;
+
+        ctl_ecc_properties_t Properties = {};
+        Properties.Size                 = sizeof(ctl_ecc_properties_t);
+        Properties.Version              = 0;
+        pStats->lastResult              = ctlEccGetProperties(pTopologies[i].hDevice, &Properties);
+        if (CTL_RESULT_SUCCESS == pStats->lastResult)
+        {
+            pStats->supported  = Properties.isSupported;
+            pStats->canControl = Properties.isSupported && Properties.canControl;
+        }
+        Supported += pStats->supported ? 1 : 0;
+    }
+
+    std::lock_guard<std::mutex> Guard(pMonitor->statsLock);
+    memcpy(pMonitor->stats, pMonitor->working, sizeof(pMonitor->stats));
+    for (uint32_t i = 0; i < AGENT_MAX_ADAPTERS; i++)
+    {
+        pMonitor->requested[i] = CTL_ECC_STATE_MAX;
+    }
+
+    return (0 != Supported) ? CTL_RESULT_SUCCESS : CTL_RESULT_ERROR_NOT_AVAILABLE;
+}
+
+static ctl_result_t EccReadState(ctl_device_adapter_handle_t hDevice, ctl_ecc_state_desc_t *pState)
+{
+    *pState         = {};
+    pState->Size    = sizeof(ctl_ecc_state_desc_t);
+    pState->Version = 0;
+    return ctlEccGetState(hDevice, pState);
+}
+
+void EccMonitorSampleOnce(EccMonitor *pMonitor)
+{
+    for (uint32_t i = 0; i < pMonitor->adapterCount; i++)
+    {
+        EccAdapterStats *pStats = &pMonitor->working[i];
+        if (!pStats->supported)
+        {
+            continue;
+        }
+
+        ctl_ecc_state_desc_t State;
+        pStats->lastResult = EccReadState(pMonitor->hDevices[i], &State);
+        uint64_t NowNs     = AgentHostTimeNs();
+        if (CTL_RESULT_SUCCESS != pStats->lastResult)
+        {
+            pStats->failures++;
+            continue;
+        }
+
+        pStats->pendingChanges += (pStats->valid && (State.pendingEccState != pStats->pending)) ? 1 : 0;
+        pStats->valid         = true;
+        pStats->current       = State.currentEccState;
+        pStats->pending       = State.pendingEccState;
+        pStats->rebootPending = (State.currentEccState != State.pendingEccState);
+        pStats->samples++;
+
+        if (!pStats->rebootPending)
+        {
+            pMonitor->rebootPendingSinceNs[i] = 0;
+        }
+        else if (0 == pMonitor->rebootPendingSinceNs[i])
+        {
+            pMonitor->rebootPendingSinceNs[i] = NowNs;
+        }
+        pStats->rebootPendingSec = pStats->rebootPending ? (NowNs - pMonitor->rebootPendingSinceNs[i]) / 1e9 : 0.0;
+    }
+
+    std::lock_guard<std::mutex> Guard(pMonitor->statsLock);
+    for (uint32_t i = 0; i < pMonitor->adapterCount; i++)
+    {
+        EccAdapterStats *pStats = &pMonitor->working[i];
+        pStats->requested       = pMonitor->requested[i];
+        pStats->requestMismatch = pStats->valid && (CTL_ECC_STATE_ECC_ENABLED_STATE <= pStats->requested) && (CTL_ECC_STATE_ECC_DISABLED_STATE >= pStats->requested) &&
+                                  (pStats->pending != pStats->requested);
+    }
+    memcpy(pMonitor->stats, pMonitor->working, pMonitor->adapterCount * sizeof(EccAdapterStats));
+}
+
+static void EccMonitorThread(EccMonitor *pMonitor)
+{
+    auto NextTick = std::chrono::steady_clock::now();
+    while (!pMonitor->stopRequested.load(std::memory_order_relaxed))
+    {
+        EccMonitorSampleOnce(pMonitor);
+
+        NextTick += std::chrono::milliseconds(pMonitor->periodMs);
+        auto Now = std::chrono::steady_clock::now();
+        if (NextTick < Now)
+        {
+            NextTick = Now;
+        }
+        std::this_thread::sleep_until(NextTick);
+    }
+}
+
+ctl_result_t EccMonitorStart(EccMonitor *pMonitor)
+{
+    if (nullptr == pMonitor)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (pMonitor->sampler.joinable())
+    {
+        return CTL_RESULT_ERROR_ALREADY_INITIALIZED;
+    }
+
+    pMonitor->stopRequested.store(false);
+    pMonitor->sampler = std::thread(EccMonitorThread, pMonitor);
+    return CTL_RESULT_SUCCESS;
+}
+
+void EccMonitorStop(EccMonitor *pMonitor)
+{
+    if ((nullptr == pMonitor) || !pMonitor->sampler.joinable())
+    {
+        return;
+    }
+
+    pMonitor->stopRequested.store(true);
+    pMonitor->sampler.join();
+}
+
+ctl_result_t EccMonitorRead(EccMonitor *pMonitor, uint32_t AdapterIndex, EccAdapterStats *pStats)
+{
+    if ((nullptr == pMonitor) || (nullptr == pStats))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (AdapterIndex >= pMonitor->adapterCount)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pMonitor->statsLock);
+    *pStats = pMonitor->stats[AdapterIndex];
+    return CTL_RESULT_SUCCESS;
+}
+
+/***************************************************************
+ * @brief Writes State to one adapter unless it is already there
+ ***************************************************************/
+static void EccApplyOne(ctl_device_adapter_handle_t hDevice, ctl_ecc_state_t State, EccApplyResult *pResult)
+{
+    uint64_t StartNs = AgentHostTimeNs();
+
+    ctl_ecc_state_desc_t Desc;
+    if ((CTL_ECC_STATE_ECC_DEFAULT_STATE != State) && (CTL_RESULT_SUCCESS == EccReadState(hDevice, &Desc)) && (State == Desc.currentEccState) && (State == Desc.pendingEccState))
+    {
+        pResult->outcome = ECC_APPLY_ALREADY;
+    }
+    else
+    {
+        Desc                 = {};
+        Desc.Size            = sizeof(ctl_ecc_state_desc_t);
+        Desc.Version         = 0;
+        Desc.currentEccState = State;
+        pResult->setResult   = ctlEccSetState(hDevice, &Desc);
+    }
+    pResult->setSec = (AgentHostTimeNs() - StartNs) / 1e9;
+}
+
+ctl_result_t EccMonitorApply(EccMonitor *pMonitor, ctl_ecc_state_t State, EccApplyReport *pReport)
+{
+    if ((nullptr == pMonitor) || (nullptr == pReport))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((State < CTL_ECC_STATE_ECC_DEFAULT_STATE) || (State >= CTL_ECC_STATE_MAX))
+    {
+        return CTL_RESULT_ERROR_INVALID_ENUMERATION;
+    }
+
+    memset(pReport, 0, sizeof(EccApplyReport));
+    pReport->requested    = State;
+    pReport->adapterCount = pMonitor->adapterCount;
+    uint64_t StartNs      = AgentHostTimeNs();
+
+    // Support was read by EccMonitorInit and is never written by the sampler
+    std::thread Workers[AGENT_MAX_ADAPTERS];
+    for (uint32_t i = 0; i < pMonitor->adapterCount; i++)
+    {
+        EccApplyResult *pResult = &pReport->results[i];
+        pResult->adapterIndex   = pMonitor->working[i].adapterIndex;
+        pResult->outcome        = ECC_APPLY_SKIPPED;
+        pResult->setResult      = CTL_RESULT_SUCCESS;
+        pResult->verifyResult   = CTL_RESULT_SUCCESS;
+        pResult->current        = CTL_ECC_STATE_MAX;
+        pResult->pending        = CTL_ECC_STATE_MAX;
+        if (pMonitor->working[i].canControl)
+        {
+            pResult->outcome = ECC_APPLY_FAILED;
+            Workers[i]       = std::thread(EccApplyOne, pMonitor->hDevices[i], State, pResult);
+        }
+    }
+    for (uint32_t i = 0; i < pMonitor->adapterCount; i++)
+    {
+        if (Workers[i].joinable())
+        {
+            Workers[i].join();
+        }
+    }
+
+    // One verification pass once every write has returned
+    for (uint32_t i = 0; i < pMonitor->adapterCount; i++)
+    {
+        EccApplyResult *pResult = &pReport->results[i];
+        if ((ECC_APPLY_FAILED != pResult->outcome) || (CTL_RESULT_SUCCESS != pResult->setResult))
+        {
+            pReport->outcomeCount[pResult->outcome]++;
+            continue;
+        }
+
+        ctl_ecc_state_desc_t Desc;
+        pResult->verifyResult = EccReadState(pMonitor->hDevices[i], &Desc);
+        if (CTL_RESULT_SUCCESS == pResult->verifyResult)
+        {
+            // The factory default is not known up front, any state it leaves is accepted
+            ctl_ecc_state_t Expected = (CTL_ECC_STATE_ECC_DEFAULT_STATE == State) ? Desc.pendingEccState : State;
+            pResult->current         = Desc.currentEccState;
+            pResult->pending         = Desc.pendingEccState;
+            if (Expected == Desc.currentEccState)
+            {
+                pResult->outcome = (Expected == Desc.pendingEccState) ? ECC_APPLY_ACTIVE : ECC_APPLY_NOT_TAKEN;
+            }
+            else
+            {
+                pResult->outcome = (Expected == Desc.pendingEccState) ? ECC_APPLY_PENDING_REBOOT : ECC_APPLY_NOT_TAKEN;
+            }
+        }
+        pReport->outcomeCount[pResult->outcome]++;
+    }
+    pReport->elapsedSec = (AgentHostTimeNs() - StartNs) / 1e9;
+
+    std::lock_guard<std::mutex> Guard(pMonitor->statsLock);
+    for (uint32_t i = 0; i < pMonitor->adapterCount; i++)
+    {
+        if (ECC_APPLY_SKIPPED != pReport->results[i].outcome)
+        {
+            pMonitor->requested[i] = State;
+        }
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+const char *EccStateLabel(ctl_ecc_state_t State)
+{
+    switch (State)
+    {
+        case CTL_ECC_STATE_ECC_DEFAULT_STATE:
+            return "default";
+        case CTL_ECC_STATE_ECC_ENABLED_STATE:
+            return "enabled";
+        case CTL_ECC_STATE_ECC_DISABLED_STATE:
+            return "disabled";
+        default:
+            return "unknown";
+    }
+}
+
+const char *EccApplyOutcomeLabel(EccApplyOutcome Outcome)
+{
+    switch (Outcome)
+    {
+        case ECC_APPLY_SKIPPED:
+            return "skipped";
+        case ECC_APPLY_ALREADY:
+            return "already";
+        case ECC_APPLY_ACTIVE:
+            return "active";
+        case ECC_APPLY_PENDING_REBOOT:
+            return "pending_reboot";
+        case ECC_APPLY_NOT_TAKEN:
+            return "not_taken";
+        case ECC_APPLY_FAILED:
+            return "failed";
+        default:
+            return "unknown";
+    }
+}
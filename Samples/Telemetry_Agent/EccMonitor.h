@@ -0,0 +1,131 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  EccMonitor.h
+ * @brief Current and pending ECC state of every adapter, and bulk changes.
+ *
+ * ctlEccSetState only records a pending state; the current state follows
+ * at the next reboot. Every tick reads ctlEccGetState for each adapter that
+ * supports ECC and flags the ones whose pending state differs from the
+ * current one, along with how long that has been so, and the ones whose
+ * pending state is not what EccMonitorApply last asked for.
+ *
+ * EccMonitorApply sets one state on every controllable adapter at once,
+ * one thread per adapter, since each call can take as long as a firmware
+ * write. Adapters already in the requested state are left alone. After all
+ * of them have returned, a single verification pass reads the state back
+ * and classifies each adapter.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "TelemetryCache.h"
+
+#define ECC_MONITOR_DEFAULT_PERIOD_MS 5000
+
+enum EccApplyOutcome
+{
+    ECC_APPLY_SKIPPED = 0,    ///< ECC unsupported or not controllable
+    ECC_APPLY_ALREADY,        ///< Current and pending already the requested state, nothing written
+    ECC_APPLY_ACTIVE,         ///< Current state is the requested one
+    ECC_APPLY_PENDING_REBOOT, ///< Pending state is the requested one, a reboot applies it
+    ECC_APPLY_NOT_TAKEN,      ///< The write succeeded but the pending state is something else
+    ECC_APPLY_FAILED,         ///< The write or the verification failed
+    ECC_APPLY_OUTCOME_COUNT
+};
+
+struct EccAdapterStats
+{
+    uint32_t adapterIndex;
+    bool supported;
+    bool canControl;
+    bool valid; ///< At least one ctlEccGetState succeeded
+    ctl_ecc_state_t current;
+    ctl_ecc_state_t pending;
+    bool rebootPending;        ///< Pending differs from current
+    double rebootPendingSec;   ///< How long it has, by this monitor's clock
+    ctl_ecc_state_t requested; ///< Last state applied by EccMonitorApply, CTL_ECC_STATE_MAX if none
+    bool requestMismatch;      ///< Pending is not the requested state, CTL_ECC_STATE_ECC_DEFAULT_STATE never mismatches
+    uint64_t samples;
+    uint64_t failures;
+    uint64_t pendingChanges; ///< Pending state changes seen between ticks
+    ctl_result_t lastResult;
+};
+
+struct EccApplyResult
+{
+    uint32_t adapterIndex;
+    EccApplyOutcome outcome;
+    ctl_result_t setResult; ///< CTL_RESULT_SUCCESS when nothing was written
+    ctl_result_t verifyResult;
+    ctl_ecc_state_t current; ///< As read by the verification pass
+    ctl_ecc_state_t pending;
+    double setSec; ///< Time of the read and write on the adapter's thread
+};
+
+struct EccApplyReport
+{
+    ctl_ecc_state_t requested;
+    uint32_t adapterCount;
+    double elapsedSec; ///< Writes and verification together
+    uint32_t outcomeCount[ECC_APPLY_OUTCOME_COUNT];
+    EccApplyResult results[AGENT_MAX_ADAPTERS];
+};
+
+struct EccMonitor
+{
+    uint32_t adapterCount;
+    uint32_t periodMs;
+    ctl_device_adapter_handle_t hDevices[AGENT_MAX_ADAPTERS];
+
+    // Sampler private
+    EccAdapterStats working[AGENT_MAX_ADAPTERS];
+    uint64_t rebootPendingSinceNs[AGENT_MAX_ADAPTERS];
+
+    std::mutex statsLock;
+    EccAdapterStats stats[AGENT_MAX_ADAPTERS];
+    ctl_ecc_state_t requested[AGENT_MAX_ADAPTERS]; ///< Written by EccMonitorApply
+
+    std::atomic<bool> stopRequested;
+    std::thread sampler;
+};
+
+/***************************************************************
+ * @brief Reads the ECC properties of every adapter
+ *
+ * Returns CTL_RESULT_ERROR_NOT_AVAILABLE when no adapter supports ECC.
+ ***************************************************************/
+ctl_result_t EccMonitorInit(EccMonitor *pMonitor, const AdapterTopology *pTopologies, uint32_t AdapterCount, uint32_t PeriodMs);
+
+void EccMonitorSampleOnce(EccMonitor *pMonitor);
+ctl_result_t EccMonitorStart(EccMonitor *pMonitor);
+void EccMonitorStop(EccMonitor *pMonitor);
+
+ctl_result_t EccMonitorRead(EccMonitor *pMonitor, uint32_t AdapterIndex, EccAdapterStats *pStats);
+
+/***************************************************************
+ * @brief Sets State on every controllable adapter in parallel and verifies it
+ *
+ * Blocks until every adapter has been written and read back once. The
+ * monitor does not need to be running; when it is, its next tick picks up
+ * the new pending states.
+ ***************************************************************/
+ctl_result_t EccMonitorApply(EccMonitor *pMonitor, ctl_ecc_state_t State, EccApplyReport *pReport);
+
+/***************************************************************
+ * @brief Lower case names used in labels
+ ***************************************************************/
+const char *EccStateLabel(ctl_ecc_state_t State);
+const char *EccApplyOutcomeLabel(EccApplyOutcome Outcome);
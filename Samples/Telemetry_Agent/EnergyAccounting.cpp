@@ -0,0 +1,381 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  EnergyAccounting.cpp
+ * @brief Energy of named measurement windows, e.g. per job or benchmark run.
+ *
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "EnergyAccounting.h"
+
+#define ENERGY_DOMAIN_WRAP_J 4294.967296 ///< 2^32 microjoules, for domain counters that still fit 32 bits
+
+/***************************************************************
+ * @brief Integrates one counter reading, true if it closed an interval
+ ***************************************************************/
+static bool EnergyIntegrate(EnergyCounterState *pState, EnergyTotals *pTotals, double CounterJ, double Sec, double WrapJ)
+{
+    if (!pState->haveLast || (Sec < pState->lastSec))
+    {
+        // First reading, or the timestamp was reset and the interval is unknown
+        pTotals->resets += pState->haveLast ? 1 : 0;
+        pState->haveLast = true;
+        pState->lastJ    = CounterJ;
+        pState->lastSec  = Sec;
+        pState->wrapJ    = WrapJ;
+        return false;
+    }
+
+    double IntervalSec = Sec - pState->lastSec;
+    if (IntervalSec <= 0.0)
+    {
+        return false;
+    }
+
+    // The range is that of the previous reading, the one the counter wrapped from
+    double DeltaJ   = CounterJ - pState->lastJ;
+    double LimitJ   = ENERGY_MAX_PLAUSIBLE_WATTS * IntervalSec;
+    double RangeJ   = pState->wrapJ;
+    pState->lastJ   = CounterJ;
+    pState->lastSec = Sec;
+    pState->wrapJ   = WrapJ;
+    if ((DeltaJ < 0.0) && (RangeJ > 0.0) && (DeltaJ + RangeJ <= LimitJ))
+    {
+        DeltaJ += RangeJ;
+        pTotals->wraps++;
+    }
+    else if ((DeltaJ < 0.0) || (DeltaJ > LimitJ))
+    {
+        DeltaJ = pState->powerW * IntervalSec;
+        pTotals->estimatedJ += DeltaJ;
+        pTotals->resets++;
+    }
+
+    pState->powerW = DeltaJ / IntervalSec;
+    pTotals->joules += DeltaJ;
+    return true;
+}
+
+static void EnergyListener(const AdapterSnapshot *pPrevious, const PublishedSnapshot *pCurrent, void *pContext)
+{
+    (void)pPrevious;
+    EnergyAccountant *pAccountant    = static_cast<EnergyAccountant *>(pContext);
+    const AdapterSnapshot *pSnapshot = &pCurrent->snapshot;
+    uint32_t Adapter                 = pSnapshot->adapterIndex;
+    if (Adapter >= AGENT_MAX_ADAPTERS)
+    {
+        return;
+    }
+
+    struct
+    {
+        uint32_t itemId;
+        EnergySource source;
+    } Items[] = {
+        { TELEMETRY_ITEM_GPU_ENERGY, ENERGY_SOURCE_GPU },
+        { TELEMETRY_ITEM_VRAM_ENERGY, ENERGY_SOURCE_VRAM },
+        { TELEMETRY_ITEM_CARD_ENERGY, ENERGY_SOURCE_CARD },
+    };
+
+    const TelemetryDecodePlan *pPlan = &pAccountant->pCache->decodePlan[Adapter];
+    const uint64_t Mask              = (CTL_RESULT_SUCCESS == pSnapshot->telemetryResult) ? pSnapshot->telemetryValidMask : 0;
+    double HostSec                   = pSnapshot->hostTimestampNs / 1e9;
+    double TelemetrySec              = (0 != (Mask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_TIMESTAMP))) ? pSnapshot->telemetryValues[TELEMETRY_ITEM_TIMESTAMP] : HostSec;
+    uint32_t UpdatedMask             = 0;
+
+    std::lock_guard<std::mutex> Guard(pAccountant->lock);
+    EnergyCounterState *pCounters = pAccountant->counters[Adapter];
+    EnergyTotals *pTotals         = pAccountant->totals[Adapter];
+    for (auto &Item : Items)
+    {
+        if (0 != (Mask & TELEMETRY_ITEM_BIT(Item.itemId)))
+        {
+            double WrapJ = TelemetryDecodePlanRange(pPlan, Item.itemId);
+            UpdatedMask |= EnergyIntegrate(&pCounters[Item.source], &pTotals[Item.source], pSnapshot->telemetryValues[Item.itemId], TelemetrySec, WrapJ) ? CTL_BIT(Item.source) : 0;
+            pAccountant->sourceValidMask[Adapter] |= CTL_BIT(Item.source);
+        }
+    }
+
+    for (uint32_t d = 0; d < AGENT_MAX_POWER_DOMAINS; d++)
+    {
+        if (0 != (pSnapshot->energyValidMask & CTL_BIT(d)))
+        {
+            const ctl_power_energy_counter_t &Counter = pSnapshot->energyCounter[d];
+            uint32_t Source                           = ENERGY_SOURCE_DOMAIN_0 + d;
+            double Sec                                = (0 != Counter.timestamp) ? Counter.timestamp / 1e6 : HostSec;
+            double WrapJ                              = (Counter.energy <= 0xFFFFFFFFull) ? ENERGY_DOMAIN_WRAP_J : 0.0;
+            UpdatedMask |= EnergyIntegrate(&pCounters[Source], &pTotals[Source], Counter.energy / 1e6, Sec, WrapJ) ? CTL_BIT(Source) : 0;
+            pAccountant->sourceValidMask[Adapter] |= CTL_BIT(Source);
+        }
+    }
+
+    // Passes without any counter do not move the ends of a window
+    bool AnyCounter = (0 != (Mask & (TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_GPU_ENERGY) | TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_VRAM_ENERGY) | TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_CARD_ENERGY)))) ||
+                      (0 != pSnapshot->energyValidMask);
+    if (!AnyCounter)
+    {
+        return;
+    }
+    pAccountant->lastSampleNs[Adapter] = pSnapshot->hostTimestampNs;
+
+    // Windows only track their peak, the energy comes from the totals
+    for (uint32_t w = 0, Seen = 0; (w < ENERGY_MAX_WINDOWS) && (Seen < pAccountant->openWindows); w++)
+    {
+        EnergyWindow *pWindow = &pAccountant->windows[w];
+        if (!pWindow->open)
+        {
+            continue;
+        }
+        Seen++;
+        if (!AgentAdapterMaskTest(&pWindow->adapters, Adapter))
+        {
+            continue;
+        }
+
+        // Opened before the first pass of the adapter, which only set the baseline
+        if (0 == pWindow->startSampleNs[Adapter])
+        {
+            pWindow->startSampleNs[Adapter] = pSnapshot->hostTimestampNs;
+        }
+        for (uint32_t s = 0; s < ENERGY_SOURCE_COUNT; s++)
+        {
+            double PowerW = pCounters[s].powerW;
+            if ((0 != (UpdatedMask & CTL_BIT(s))) && (PowerW > pWindow->peakW[Adapter][s]))
+            {
+                pWindow->peakW[Adapter][s] = PowerW;
+            }
+        }
+    }
+}
+
+ctl_result_t EnergyAccountantInit(EnergyAccountant *pAccountant, TelemetryCache *pCache)
+{
+    if ((nullptr == pAccountant) || (nullptr == pCache))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pAccountant->pCache = pCache;
+    {
+        std::lock_guard<std::mutex> Guard(pAccountant->lock);
+        memset(pAccountant->counters, 0, sizeof(pAccountant->counters));
+        memset(pAccountant->sourceValidMask, 0, sizeof(pAccountant->sourceValidMask));
+        memset(pAccountant->lastSampleNs, 0, sizeof(pAccountant->lastSampleNs));
+        memset(pAccountant->totals, 0, sizeof(pAccountant->totals));
+        memset(pAccountant->windows, 0, sizeof(pAccountant->windows));
+        pAccountant->openWindows = 0;
+    }
+
+    return TelemetryCacheAddListener(pCache, EnergyListener, pAccountant);
+}
+
+ctl_result_t EnergyWindowBegin(EnergyAccountant *pAccountant, const char *pName, const AgentAdapterMask *pAdapters, uint32_t *pWindowId)
+{
+    if ((nullptr == pAccountant) || (nullptr == pAdapters) || (nullptr == pWindowId))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    *pWindowId = ENERGY_INVALID_WINDOW;
+    std::lock_guard<std::mutex> Guard(pAccountant->lock);
+    for (uint32_t w = 0; w < ENERGY_MAX_WINDOWS; w++)
+    {
+        EnergyWindow *pWindow = &pAccountant->windows[w];
+        if (pWindow->open)
+        {
+            continue;
+        }
+
+        pWindow->open        = true;
+        pWindow->adapters    = *pAdapters;
+        pWindow->startNs     = AgentHostTimeNs();
+        snprintf(pWindow->name, sizeof(pWindow->name), "%s", (nullptr != pName) ? pName : "");
+        memcpy(pWindow->startSampleNs, pAccountant->lastSampleNs, sizeof(pWindow->startSampleNs));
+        memcpy(pWindow->start, pAccountant->totals, sizeof(pWindow->start));
+        memset(pWindow->peakW, 0, sizeof(pWindow->peakW));
+        pAccountant->openWindows++;
+        *pWindowId = w;
+        return CTL_RESULT_SUCCESS;
+    }
+    return CTL_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+}
+
+/***************************************************************
+ * @brief Differences between the totals now and when the window opened,
+ *        caller holds the lock
+ ***************************************************************/
+static void EnergyWindowReport(const EnergyAccountant *pAccountant, const EnergyWindow *pWindow, double WorkUnits, EnergyReport *pReport)
+{
+    memset(pReport, 0, sizeof(EnergyReport));
+    memcpy(pReport->name, pWindow->name, sizeof(pReport->name));
+    pReport->startNs   = pWindow->startNs;
+    pReport->endNs     = AgentHostTimeNs();
+    pReport->workUnits = WorkUnits;
+
+    for (uint32_t a = 0; a < pAccountant->pCache->adapterCount; a++)
+    {
+        if (!AgentAdapterMaskTest(&pWindow->adapters, a))
+        {
+            continue;
+        }
+
+        EnergyAdapterReport *pAdapter = &pReport->adapters[pReport->adapterCount++];
+        pAdapter->adapterIndex        = a;
+        pAdapter->sourceValidMask     = pAccountant->sourceValidMask[a];
+        pAdapter->elapsedSec          = (pAccountant->lastSampleNs[a] > pWindow->startSampleNs[a]) ? (pAccountant->lastSampleNs[a] - pWindow->startSampleNs[a]) / 1e9 : 0.0;
+        for (uint32_t s = 0; s < ENERGY_SOURCE_COUNT; s++)
+        {
+            const EnergyTotals &Now    = pAccountant->totals[a][s];
+            const EnergyTotals &Start  = pWindow->start[a][s];
+            EnergySourceReport *pEntry = &pAdapter->sources[s];
+            pEntry->joules             = Now.joules - Start.joules;
+            pEntry->estimatedJ         = Now.estimatedJ - Start.estimatedJ;
+            pEntry->wraps              = Now.wraps - Start.wraps;
+            pEntry->resets             = Now.resets - Start.resets;
+            pEntry->peakW              = pWindow->peakW[a][s];
+            pEntry->averageW           = (pAdapter->elapsedSec > 0.0) ? pEntry->joules / pAdapter->elapsedSec : 0.0;
+            pEntry->joulesPerUnit      = (WorkUnits > 0.0) ? pEntry->joules / WorkUnits : 0.0;
+        }
+    }
+}
+
+ctl_result_t EnergyWindowRead(EnergyAccountant *pAccountant, uint32_t WindowId, double WorkUnits, EnergyReport *pReport)
+{
+    if ((nullptr == pAccountant) || (nullptr == pReport))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(pAccountant->lock);
+    if ((WindowId >= ENERGY_MAX_WINDOWS) || !pAccountant->windows[WindowId].open)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    EnergyWindowReport(pAccountant, &pAccountant->windows[WindowId], WorkUnits, pReport);
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t EnergyWindowEnd(EnergyAccountant *pAccountant, uint32_t WindowId, double WorkUnits, EnergyReport *pReport)
+{
+    if ((nullptr == pAccountant) || (nullptr == pReport))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(pAccountant->lock);
+    if ((WindowId >= ENERGY_MAX_WINDOWS) || !pAccountant->windows[WindowId].open)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    EnergyWindow *pWindow = &pAccountant->windows[WindowId];
+    EnergyWindowReport(pAccountant, pWindow, WorkUnits, pReport);
+    pWindow->open = false;
+    pAccountant->openWindows--;
+    return CTL_RESULT_SUCCESS;
+}
+
+const char *EnergySourceLabel(EnergySource Source, char *pBuffer, size_t BufferSize)
+{
+    switch (Source)
+    {
+        case ENERGY_SOURCE_GPU:
+            snprintf(pBuffer, BufferSize, "gpu");
+            break;
+        case ENERGY_SOURCE_VRAM:
+            snprintf(pBuffer, BufferSize, "vram");
+            break;
+        case ENERGY_SOURCE_CARD:
+            snprintf(pBuffer, BufferSize, "card");
+            break;
+        default:
+            snprintf(pBuffer, BufferSize, "domain_%u", static_cast<uint32_t>(Source - ENERGY_SOURCE_DOMAIN_0));
+            break;
+    }
+    return pBuffer;
+}
+
+/***************************************************************
+ * @brief snprintf at *pLength, truncating at the end of the buffer
+ ***************************************************************/
+static void FormatAppend(char *pBuffer, size_t BufferSize, size_t *pLength, const char *pFormat, ...)
+{
+    if (*pLength + 1 >= BufferSize)
+    {
+        return;
+    }
+
+    va_list Args;
+    va_start(Args, pFormat);
+    int Written = vsnprintf(pBuffer + *pLength, BufferSize - *pLength, pFormat, Args);
+    va_end(Args);
+
+    if (Written > 0)
+    {
+        *pLength += static_cast<size_t>(Written);
+        *pLength = (*pLength < BufferSize) ? *pLength : BufferSize - 1;
+    }
+}
+
+size_t EnergyAdapterReportFormat(const EnergyReport *pReport, uint32_t Index, char *pBuffer, size_t BufferSize)
+{
+    if ((nullptr == pReport) || (nullptr == pBuffer) || (0 == BufferSize) || (Index >= pReport->adapterCount))
+    {
+        return 0;
+    }
+
+    const EnergyAdapterReport *pAdapter = &pReport->adapters[Index];
+    size_t Length                       = 0;
+    pBuffer[0]                          = '\0';
+    FormatAppend(pBuffer, BufferSize, &Length, "Window %s, adapter %u: %.1f s", pReport->name, pAdapter->adapterIndex, pAdapter->elapsedSec);
+    for (uint32_t s = 0; s < ENERGY_SOURCE_COUNT; s++)
+    {
+        if (0 == (pAdapter->sourceValidMask & CTL_BIT(s)))
+        {
+            continue;
+        }
+
+        const EnergySourceReport *pEntry = &pAdapter->sources[s];
+        char Label[16];
+        EnergySourceLabel(static_cast<EnergySource>(s), Label, sizeof(Label));
+        FormatAppend(pBuffer, BufferSize, &Length, "; %s %.1f J, %.1f W average, %.1f W peak", Label, pEntry->joules, pEntry->averageW, pEntry->peakW);
+        if (pReport->workUnits > 0.0)
+        {
+            FormatAppend(pBuffer, BufferSize, &Length, ", %.3f J per unit", pEntry->joulesPerUnit);
+        }
+        if ((0 != pEntry->wraps) || (0 != pEntry->resets))
+        {
+            FormatAppend(pBuffer, BufferSize, &Length, " (%u wraps, %u resets, %.1f J estimated)", pEntry->wraps, pEntry->resets, pEntry->estimatedJ);
+        }
+    }
+    FormatAppend(pBuffer, BufferSize, &Length, "\n");
+    return Length;
+}
+
+size_t EnergyReportFormat(const EnergyReport *pReport, char *pBuffer, size_t BufferSize)
+{
+    if ((nullptr == pReport) || (nullptr == pBuffer) || (0 == BufferSize))
+    {
+        return 0;
+    }
+
+    size_t Length = 0;
+    pBuffer[0]    = '\0';
+    for (uint32_t i = 0; i < pReport->adapterCount; i++)
+    {
+        Length += EnergyAdapterReportFormat(pReport, i, pBuffer + Length, BufferSize - Length);
+    }
+    return Length;
+}
@@ -0,0 +1,177 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  EnergyAccounting.h
+ * @brief Energy of named measurement windows, e.g. per job or benchmark run.
+ *
+ * Every pass of the telemetry cache integrates gpuEnergyCounter,
+ * vramEnergyCounter and totalCardEnergyCounter of ctlPowerTelemetryGet and
+ * the ctlPowerGetEnergyCounter of each power domain into running totals per
+ * adapter. Missed or failed passes need no special care, the next good
+ * counter covers the gap. A counter that goes backwards is taken as a wrap
+ * when its data type has a known width and the wrapped delta is plausible;
+ * otherwise it was reset, and the energy of that interval is estimated from
+ * the last known power and reported separately.
+ *
+ * A window records the running totals when it is opened and reports the
+ * difference when it is closed, so its energy costs nothing per pass; only
+ * its peak power is updated, in constant time. Windows are independent and
+ * may overlap or nest. Both ends fall on the pass before the call, so a
+ * window is accurate to one sampling period at either end.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+
+#include "TelemetryCache.h"
+
+#define ENERGY_MAX_WINDOWS 32
+#define ENERGY_INVALID_WINDOW 0xFFFFFFFFu
+#define ENERGY_WINDOW_NAME_LEN 32
+#define ENERGY_REPORT_LINE_LEN 2048       ///< Longest line of EnergyAdapterReportFormat
+#define ENERGY_MAX_PLAUSIBLE_WATTS 2000.0 ///< Faster counter growth is treated as a reset
+
+enum EnergySource
+{
+    ENERGY_SOURCE_GPU = 0, ///< gpuEnergyCounter
+    ENERGY_SOURCE_VRAM,    ///< vramEnergyCounter
+    ENERGY_SOURCE_CARD,    ///< totalCardEnergyCounter
+    ENERGY_SOURCE_DOMAIN_0,
+    ENERGY_SOURCE_COUNT = ENERGY_SOURCE_DOMAIN_0 + AGENT_MAX_POWER_DOMAINS
+};
+
+/***************************************************************
+ * @brief Running integration of one counter, sampler private
+ ***************************************************************/
+struct EnergyCounterState
+{
+    bool haveLast;
+    double lastJ;
+    double lastSec; ///< Counter timestamp, host time if it has none
+    double wrapJ;   ///< Counter range in joules, 0 if unknown
+    double powerW;  ///< Over the last interval
+};
+
+/***************************************************************
+ * @brief Running totals of one counter, read by the windows
+ ***************************************************************/
+struct EnergyTotals
+{
+    double joules;
+    double estimatedJ; ///< Part of joules estimated across counter resets
+    uint32_t wraps;
+    uint32_t resets;
+};
+
+struct EnergySourceReport
+{
+    double joules;
+    double averageW;
+    double peakW;         ///< Highest single interval
+    double estimatedJ;    ///< Included in joules
+    double joulesPerUnit; ///< 0 when no work was reported
+    uint32_t wraps;
+    uint32_t resets;
+};
+
+struct EnergyAdapterReport
+{
+    uint32_t adapterIndex;
+    uint32_t sourceValidMask; ///< CTL_BIT(EnergySource) of the counters the adapter reports
+    double elapsedSec;        ///< Between the passes the window starts and ends on
+    EnergySourceReport sources[ENERGY_SOURCE_COUNT];
+};
+
+struct EnergyReport
+{
+    char name[ENERGY_WINDOW_NAME_LEN];
+    uint64_t startNs;
+    uint64_t endNs;
+    double workUnits; ///< Supplied by the caller when closing
+    uint32_t adapterCount;
+    EnergyAdapterReport adapters[AGENT_MAX_ADAPTERS];
+};
+
+struct EnergyWindow
+{
+    bool open;
+    char name[ENERGY_WINDOW_NAME_LEN];
+    AgentAdapterMask adapters; ///< The adapters the job runs on
+    uint64_t startNs;
+    uint64_t startSampleNs[AGENT_MAX_ADAPTERS];
+    EnergyTotals start[AGENT_MAX_ADAPTERS][ENERGY_SOURCE_COUNT];
+    double peakW[AGENT_MAX_ADAPTERS][ENERGY_SOURCE_COUNT];
+};
+
+struct EnergyAccountant
+{
+    const TelemetryCache *pCache;
+
+    EnergyCounterState counters[AGENT_MAX_ADAPTERS][ENERGY_SOURCE_COUNT]; ///< Sampler private
+
+    std::mutex lock; ///< Guards everything below
+    uint32_t sourceValidMask[AGENT_MAX_ADAPTERS];
+    uint64_t lastSampleNs[AGENT_MAX_ADAPTERS];
+    EnergyTotals totals[AGENT_MAX_ADAPTERS][ENERGY_SOURCE_COUNT];
+    uint32_t openWindows;
+    EnergyWindow windows[ENERGY_MAX_WINDOWS];
+};
+
+/***************************************************************
+ * @brief Registers the accountant as a listener of the cache
+ *
+ * Call before TelemetryCacheStart.
+ ***************************************************************/
+ctl_result_t EnergyAccountantInit(EnergyAccountant *pAccountant, TelemetryCache *pCache);
+
+/***************************************************************
+ * @brief Opens a named window over the adapters in pAdapters
+ *
+ * pName may be nullptr and is truncated to ENERGY_WINDOW_NAME_LEN - 1.
+ ***************************************************************/
+ctl_result_t EnergyWindowBegin(EnergyAccountant *pAccountant, const char *pName, const AgentAdapterMask *pAdapters, uint32_t *pWindowId);
+
+/***************************************************************
+ * @brief Reports an open window without closing it
+ *
+ * WorkUnits is the work done so far, e.g. frames or requests, 0 if none.
+ ***************************************************************/
+ctl_result_t EnergyWindowRead(EnergyAccountant *pAccountant, uint32_t WindowId, double WorkUnits, EnergyReport *pReport);
+
+/***************************************************************
+ * @brief Closes a window and reports it
+ ***************************************************************/
+ctl_result_t EnergyWindowEnd(EnergyAccountant *pAccountant, uint32_t WindowId, double WorkUnits, EnergyReport *pReport);
+
+/***************************************************************
+ * @brief Lower case counter name used in labels
+ ***************************************************************/
+const char *EnergySourceLabel(EnergySource Source, char *pBuffer, size_t BufferSize);
+
+/***************************************************************
+ * @brief Formats the line of pReport->adapters[Index], newline included
+ *
+ * ENERGY_REPORT_LINE_LEN always holds the line. Returns the number of
+ * characters written, excluding the terminator.
+ ***************************************************************/
+size_t EnergyAdapterReportFormat(const EnergyReport *pReport, uint32_t Index, char *pBuffer, size_t BufferSize);
+
+/***************************************************************
+ * @brief Formats a report as one text line per adapter and counter
+ *
+ * Truncates at the end of the buffer; size it at adapterCount times
+ * ENERGY_REPORT_LINE_LEN, or format each adapter on its own. Returns the
+ * number of characters written, excluding the terminator.
+ ***************************************************************/
+size_t EnergyReportFormat(const EnergyReport *pReport, char *pBuffer, size_t BufferSize);
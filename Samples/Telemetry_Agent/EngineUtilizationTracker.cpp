@@ -0,0 +1,248 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  EngineUtilizationTracker.cpp
+ * @brief Per engine group utilization with moving averages.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "EngineUtilizationTracker.h"
+
+ctl_result_t EngineTrackerInit(EngineUtilizationTracker *pTracker, const AdapterTopology *pTopologies, uint32_t AdapterCount, uint32_t PeriodMs, TimeSeriesStore *pStore)
+{
+    if ((nullptr == pTracker) || (nullptr == pTopologies))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pTracker->engineCount = 0;
+    pTracker->periodMs    = (0 != PeriodMs) ? PeriodMs : ENGINE_TRACKER_DEFAULT_PERIOD_MS;
+    pTracker->pStore      = pStore;
+    pTracker->passes      = 0;
+    pTracker->lastBatchNs = 0;
+    pTracker->stopRequested.store(false);
+    memset(pTracker->havePrevious, 0, sizeof(pTracker->havePrevious));
+    memset(pTracker->working, 0, sizeof(pTracker->working));
+
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const AdapterTopology *pTopology = &pTopologies[i];
+        for (uint32_t e = 0; (e < pTopology->engineGroupCount) && (pTracker->engineCount < ENGINE_TRACKER_MAX_ENGINES); e++)
+        {
+            TrackedEngine *pEngine = &pTracker->engines[pTracker->engineCount];
+            pEngine->adapterIndex  = pTopology->adapterIndex;
+            pEngine->groupIndex    = e;
+            pEngine->type          = pTopology->engineGroupType[e];
+            pEngine->hEngine       = pTopology->hEngine[e];
+            pEngine->seriesId      = TIME_SERIES_INVALID_ID;
+
+            if (nullptr != pStore)
+            {
+                char Labels[TIME_SERIES_LABELS_LEN];
+                snprintf(Labels, sizeof(Labels), "adapter=\"%u\",group=\"%s\",index=\"%u\"", pEngine->adapterIndex, EngineGroupLabel(pEngine->type), e);
+                pEngine->seriesId = TimeSeriesStoreRegister(pStore, ENGINE_TRACKER_SERIES_NAME, Labels);
+            }
+
+            EngineUtilization *pWorking = &pTracker->working[pTracker->engineCount];
+            pWorking->adapterIndex      = pEngine->adapterIndex;
+            pWorking->groupIndex        = e;
+            pWorking->type              = pEngine->type;
+            pTracker->engineCount++;
+        }
+    }
+
+    std::lock_guard<std::mutex> Guard(pTracker->statsLock);
+    memcpy(pTracker->stats, pTracker->working, sizeof(pTracker->stats));
+
+    return (0 != pTracker->engineCount) ? CTL_RESULT_SUCCESS : CTL_RESULT_ERROR_NOT_AVAILABLE;
+}
+
+void EngineTrackerSampleOnce(EngineUtilizationTracker *pTracker)
+{
+    uint32_t Count = pTracker->engineCount;
+
+    // Driver calls only, back to back, so all engines see the same window
+    uint64_t BatchStartNs = AgentHostTimeNs();
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        pTracker->batch[i]       = {};
+        pTracker->batch[i].Size  = sizeof(ctl_engine_stats_t);
+        pTracker->batchResult[i] = ctlEngineGetActivity(pTracker->engines[i].hEngine, &pTracker->batch[i]);
+    }
+    uint64_t BatchEndNs   = AgentHostTimeNs();
+    pTracker->lastBatchNs = BatchEndNs - BatchStartNs;
+    pTracker->passes++;
+
+    uint32_t SeriesCount = 0;
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        if (CTL_RESULT_SUCCESS != pTracker->batchResult[i])
+        {
+            // Keep the last good counters, the next success spans the gap
+            continue;
+        }
+
+        ctl_engine_stats_t Before       = pTracker->previous[i];
+        const ctl_engine_stats_t &After = pTracker->batch[i];
+        bool HadPrevious                = pTracker->havePrevious[i];
+        pTracker->previous[i]           = After;
+        pTracker->havePrevious[i]       = true;
+
+        if (!HadPrevious || (After.timestamp <= Before.timestamp) || (After.activeTime < Before.activeTime))
+        {
+            continue;
+        }
+
+        double IntervalSec = static_cast<double>(After.timestamp - Before.timestamp) / 1e6;
+        double Percent     = 100.0 * static_cast<double>(After.activeTime - Before.activeTime) / static_cast<double>(After.timestamp - Before.timestamp);
+        Percent            = (Percent > 100.0) ? 100.0 : Percent;
+
+        EngineUtilization *pWorking = &pTracker->working[i];
+        if (0 == pWorking->intervals)
+        {
+            pWorking->shortAveragePct = Percent;
+            pWorking->longAveragePct  = Percent;
+        }
+        else
+        {
+            pWorking->shortAveragePct += TimeSeriesEwmaWeight(IntervalSec, ENGINE_TRACKER_SHORT_WINDOW_SEC) * (Percent - pWorking->shortAveragePct);
+            pWorking->longAveragePct += TimeSeriesEwmaWeight(IntervalSec, ENGINE_TRACKER_LONG_WINDOW_SEC) * (Percent - pWorking->longAveragePct);
+        }
+        pWorking->utilizationPct  = Percent;
+        pWorking->valid           = true;
+        pWorking->hostTimestampNs = BatchEndNs;
+        pWorking->intervals++;
+
+        if (TIME_SERIES_INVALID_ID != pTracker->engines[i].seriesId)
+        {
+            pTracker->seriesIds[SeriesCount]    = pTracker->engines[i].seriesId;
+            pTracker->seriesValues[SeriesCount] = Percent;
+            SeriesCount++;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> Guard(pTracker->statsLock);
+        memcpy(pTracker->stats, pTracker->working, Count * sizeof(EngineUtilization));
+    }
+
+    if ((nullptr != pTracker->pStore) && (0 != SeriesCount))
+    {
+        TimeSeriesStoreAppendBatch(pTracker->pStore, pTracker->seriesIds, pTracker->seriesValues, SeriesCount, BatchEndNs);
+    }
+}
+
+static void EngineTrackerThread(EngineUtilizationTracker *pTracker)
+{
+    auto NextTick = std::chrono::steady_clock::now();
+    while (!pTracker->stopRequested.load(std::memory_order_relaxed))
+    {
+        EngineTrackerSampleOnce(pTracker);
+
+        NextTick += std::chrono::milliseconds(pTracker->periodMs);
+        auto Now = std::chrono::steady_clock::now();
+        if (NextTick < Now)
+        {
+            NextTick = Now;
+        }
+        std::this_thread::sleep_until(NextTick);
+    }
+}
+
+ctl_result_t EngineTrackerStart(EngineUtilizationTracker *pTracker)
+{
+    if (nullptr == pTracker)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (pTracker->sampler.joinable())
+    {
+        return CTL_RESULT_ERROR_ALREADY_INITIALIZED;
+    }
+
+    // First batch only establishes the counter baseline
+    EngineTrackerSampleOnce(pTracker);
+
+    pTracker->stopRequested.store(false);
+    pTracker->sampler = std::thread(EngineTrackerThread, pTracker);
+    return CTL_RESULT_SUCCESS;
+}
+
+void EngineTrackerStop(EngineUtilizationTracker *pTracker)
+{
+    if ((nullptr == pTracker) || !pTracker->sampler.joinable())
+    {
+        return;
+    }
+
+    pTracker->stopRequested.store(true);
+    pTracker->sampler.join();
+}
+
+uint32_t EngineTrackerRead(EngineUtilizationTracker *pTracker, EngineUtilization *pEntries, uint32_t MaxEntries)
+{
+    if ((nullptr == pTracker) || (nullptr == pEntries))
+    {
+        return 0;
+    }
+
+    uint32_t Count = (pTracker->engineCount < MaxEntries) ? pTracker->engineCount : MaxEntries;
+    std::lock_guard<std::mutex> Guard(pTracker->statsLock);
+    memcpy(pEntries, pTracker->stats, Count * sizeof(EngineUtilization));
+    return Count;
+}
+
+ctl_result_t EngineTrackerFindIdlest(EngineUtilizationTracker *pTracker, ctl_engine_group_t Type, uint32_t *pAdapterIndex, double *pAveragePct)
+{
+    if ((nullptr == pTracker) || (nullptr == pAdapterIndex))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    double Sum[AGENT_MAX_ADAPTERS]     = {};
+    uint32_t Count[AGENT_MAX_ADAPTERS] = {};
+    {
+        std::lock_guard<std::mutex> Guard(pTracker->statsLock);
+        for (uint32_t i = 0; i < pTracker->engineCount; i++)
+        {
+            const EngineUtilization *pStats = &pTracker->stats[i];
+            if (pStats->valid && (Type == pStats->type) && (pStats->adapterIndex < AGENT_MAX_ADAPTERS))
+            {
+                Sum[pStats->adapterIndex] += pStats->shortAveragePct;
+                Count[pStats->adapterIndex]++;
+            }
+        }
+    }
+
+    bool Found  = false;
+    double Best = 0.0;
+    for (uint32_t a = 0; a < AGENT_MAX_ADAPTERS; a++)
+    {
+        if ((0 != Count[a]) && (!Found || (Sum[a] / Count[a] < Best)))
+        {
+            Found          = true;
+            Best           = Sum[a] / Count[a];
+            *pAdapterIndex = a;
+        }
+    }
+
+    if (!Found)
+    {
+        return CTL_RESULT_ERROR_NOT_AVAILABLE;
+    }
+    if (nullptr != pAveragePct)
+    {
+        *pAveragePct = Best;
+    }
+    return CTL_RESULT_SUCCESS;
+}
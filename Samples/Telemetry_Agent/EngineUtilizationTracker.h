@@ -0,0 +1,121 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  EngineUtilizationTracker.h
+ * @brief Per engine group utilization with moving averages.
+ *
+ * The tracker keeps the engine handles of every adapter and, once per tick,
+ * reads the activity counters of all of them back to back into a batch
+ * before doing any arithmetic, so the counters of different engines are
+ * taken as close together as possible. Utilization is the activeTime delta
+ * over the timestamp delta reported by the driver for each engine.
+ *
+ * Every engine gets an exponentially weighted short and long average and a
+ * time series in a TimeSeriesStore. The averages are what a job scheduler
+ * should look at: the instantaneous value of a media engine swings between
+ * 0 and 100 % with every frame.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "TelemetrySampler.h"
+#include "TimeSeriesStore.h"
+
+#define ENGINE_TRACKER_MAX_ENGINES (AGENT_MAX_ADAPTERS * AGENT_MAX_ENGINE_GROUPS)
+#define ENGINE_TRACKER_DEFAULT_PERIOD_MS 50
+#define ENGINE_TRACKER_SHORT_WINDOW_SEC 1.0
+#define ENGINE_TRACKER_LONG_WINDOW_SEC 10.0
+#define ENGINE_TRACKER_SERIES_NAME "engine_utilization_percent"
+
+/***************************************************************
+ * @brief Utilization of one engine group, as published to consumers
+ ***************************************************************/
+struct EngineUtilization
+{
+    uint32_t adapterIndex;
+    uint32_t groupIndex; ///< Index into AdapterTopology::hEngine
+    ctl_engine_group_t type;
+    bool valid;               ///< At least one interval has been measured
+    double utilizationPct;    ///< Last interval
+    double shortAveragePct;   ///< ENGINE_TRACKER_SHORT_WINDOW_SEC time constant
+    double longAveragePct;    ///< ENGINE_TRACKER_LONG_WINDOW_SEC time constant
+    uint64_t intervals;       ///< Intervals folded into the averages
+    uint64_t hostTimestampNs; ///< Host time of the batch that produced the values
+};
+
+struct TrackedEngine
+{
+    uint32_t adapterIndex;
+    uint32_t groupIndex;
+    ctl_engine_group_t type;
+    ctl_engine_handle_t hEngine;
+    uint32_t seriesId;
+};
+
+struct EngineUtilizationTracker
+{
+    uint32_t engineCount;
+    uint32_t periodMs;
+    TrackedEngine engines[ENGINE_TRACKER_MAX_ENGINES];
+    TimeSeriesStore *pStore; ///< Optional, receives one point per engine per tick
+
+    // Sampler private
+    ctl_engine_stats_t batch[ENGINE_TRACKER_MAX_ENGINES];
+    ctl_result_t batchResult[ENGINE_TRACKER_MAX_ENGINES];
+    ctl_engine_stats_t previous[ENGINE_TRACKER_MAX_ENGINES];
+    bool havePrevious[ENGINE_TRACKER_MAX_ENGINES];
+    EngineUtilization working[ENGINE_TRACKER_MAX_ENGINES];
+    double seriesValues[ENGINE_TRACKER_MAX_ENGINES];
+    uint32_t seriesIds[ENGINE_TRACKER_MAX_ENGINES];
+    uint64_t passes;
+    uint64_t lastBatchNs; ///< Time spent in the driver calls of the last tick
+
+    std::mutex statsLock; ///< Held only to copy working into stats and out again
+    EngineUtilization stats[ENGINE_TRACKER_MAX_ENGINES];
+
+    std::atomic<bool> stopRequested;
+    std::thread sampler;
+};
+
+/***************************************************************
+ * @brief Collects the engine handles of the given adapters
+ *
+ * pStore may be nullptr. Otherwise one series per engine is registered with
+ * adapter, group and index labels.
+ ***************************************************************/
+ctl_result_t EngineTrackerInit(EngineUtilizationTracker *pTracker, const AdapterTopology *pTopologies, uint32_t AdapterCount, uint32_t PeriodMs, TimeSeriesStore *pStore);
+
+/***************************************************************
+ * @brief One batched read of every engine followed by the update
+ ***************************************************************/
+void EngineTrackerSampleOnce(EngineUtilizationTracker *pTracker);
+ctl_result_t EngineTrackerStart(EngineUtilizationTracker *pTracker);
+void EngineTrackerStop(EngineUtilizationTracker *pTracker);
+
+/***************************************************************
+ * @brief Copies the state of every tracked engine
+ *
+ * Returns the number of entries written, at most MaxEntries.
+ ***************************************************************/
+uint32_t EngineTrackerRead(EngineUtilizationTracker *pTracker, EngineUtilization *pEntries, uint32_t MaxEntries);
+
+/***************************************************************
+ * @brief Picks the adapter whose engines of a type are the least busy
+ *
+ * Adapters are ranked by the mean short average of their engines of Type.
+ * Adapters without a measured engine of that type are skipped. Returns
+ * CTL_RESULT_ERROR_NOT_AVAILABLE if no adapter qualifies.
+ ***************************************************************/
+ctl_result_t EngineTrackerFindIdlest(EngineUtilizationTracker *pTracker, ctl_engine_group_t Type, uint32_t *pAdapterIndex, double *pAveragePct);
@@ -0,0 +1,473 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  FanControl.cpp
+ * @brief Closed loop fan control through temperature to speed tables.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#include "FanControl.h"
+#include "TimeSeriesStore.h"
+
+void FanControlDefaultConfig(FanControlConfig *pConfig)
+{
+    pConfig->gpuTargetC       = 70.0;
+    pConfig->vramTargetC      = 85.0;
+    pConfig->criticalC        = 95.0;
+    pConfig->minPct           = 30.0;
+    pConfig->acousticMaxPct   = 100.0;
+    pConfig->maxSlewPctPerSec = 10.0;
+    pConfig->minChangePct     = 5.0;
+    pConfig->kp               = 4.0;
+    pConfig->ki               = 0.3;
+    pConfig->kd               = 4.0;
+}
+
+static void FanControlListener(const AdapterSnapshot *pPrevious, const PublishedSnapshot *pCurrent, void *pContext)
+{
+    (void)pPrevious;
+    FanControllerUpdate(static_cast<FanController *>(pContext), pCurrent);
+}
+
+/***************************************************************
+ * @brief Whether a fan takes a table in units the loop can express
+ ***************************************************************/
+static bool FanControllable(ctl_fan_handle_t hFan, FanControlLoop *pLoop, uint32_t Fan)
+{
+    ctl_fan_properties_t Properties = {};
+    Properties.Size                 = sizeof(ctl_fan_properties_t);
+    if ((CTL_RESULT_SUCCESS != ctlFanGetProperties(hFan, &Properties)) || !Properties.canControl || (0 == (Properties.supportedModes & CTL_BIT(CTL_FAN_SPEED_MODE_TABLE))) ||
+        (Properties.maxPoints < 2))
+    {
+        return false;
+    }
+
+    pLoop->maxRpm[Fan] = Properties.maxRPM;
+    if (0 != (Properties.supportedUnits & CTL_BIT(CTL_FAN_SPEED_UNITS_PERCENT)))
+    {
+        pLoop->units[Fan] = CTL_FAN_SPEED_UNITS_PERCENT;
+    }
+    else if ((0 != (Properties.supportedUnits & CTL_BIT(CTL_FAN_SPEED_UNITS_RPM))) && (Properties.maxRPM > 0))
+    {
+        pLoop->units[Fan] = CTL_FAN_SPEED_UNITS_RPM;
+    }
+    else
+    {
+        return false;
+    }
+
+    pLoop->tablePoints = std::min(pLoop->tablePoints, static_cast<uint32_t>(Properties.maxPoints));
+    return true;
+}
+
+ctl_result_t FanControllerInit(FanController *pController, const FanControlConfig *pConfig, TelemetryCache *pCache)
+{
+    if ((nullptr == pController) || (nullptr == pCache))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    if (nullptr != pConfig)
+    {
+        pController->config = *pConfig;
+    }
+    else
+    {
+        FanControlDefaultConfig(&pController->config);
+    }
+
+    const FanControlConfig *pCfg = &pController->config;
+    if ((pCfg->criticalC < FAN_CONTROL_TABLE_MIN_C + 2 * FAN_CONTROL_MAX_TABLE_POINTS) || (pCfg->gpuTargetC >= pCfg->criticalC) || (pCfg->minPct < 0.0) ||
+        (pCfg->minPct > pCfg->acousticMaxPct) || (pCfg->acousticMaxPct > 100.0) || !(pCfg->maxSlewPctPerSec > 0.0))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    pController->pCache = pCache;
+    memset(pController->loops, 0, sizeof(pController->loops));
+    memset(pController->working, 0, sizeof(pController->working));
+    for (uint32_t a = 0; a < AGENT_MAX_ADAPTERS; a++)
+    {
+        FanControlLoop *pLoop   = &pController->loops[a];
+        FanControlStats *pStats = &pController->working[a];
+        pLoop->tablePoints      = FAN_CONTROL_MAX_TABLE_POINTS;
+        pStats->adapterIndex    = a;
+        pStats->lastResult      = CTL_RESULT_SUCCESS;
+        if (a >= pCache->adapterCount)
+        {
+            continue;
+        }
+
+        const AdapterTopology *pTopology = &pCache->topology[a];
+        for (uint32_t f = 0; f < pTopology->fanCount; f++)
+        {
+            if (FanControllable(pTopology->hFan[f], pLoop, f))
+            {
+                pLoop->fanMask |= CTL_BIT(f);
+                pStats->fanCount++;
+            }
+        }
+        pStats->state = (0 != pLoop->fanMask) ? FAN_CONTROL_STATE_DEFAULT : FAN_CONTROL_STATE_UNSUPPORTED;
+    }
+
+    {
+        std::lock_guard<std::mutex> Guard(pController->statsLock);
+        memcpy(pController->stats, pController->working, sizeof(pController->stats));
+    }
+    return TelemetryCacheAddListener(pCache, FanControlListener, pController);
+}
+
+/***************************************************************
+ * @brief Hottest GPU and VRAM readings of a pass, false without a GPU one
+ ***************************************************************/
+static bool FanControlTemperatures(const AdapterTopology *pTopology, const AdapterSnapshot *pSnapshot, double *pGpuC, double *pVramC)
+{
+    const uint64_t Mask = (CTL_RESULT_SUCCESS == pSnapshot->telemetryResult) ? pSnapshot->telemetryValidMask : 0;
+    bool HaveGpu        = (0 != (Mask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_GPU_TEMPERATURE)));
+    *pGpuC              = HaveGpu ? pSnapshot->telemetryValues[TELEMETRY_ITEM_GPU_TEMPERATURE] : 0.0;
+    *pVramC             = (0 != (Mask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_VRAM_TEMPERATURE))) ? pSnapshot->telemetryValues[TELEMETRY_ITEM_VRAM_TEMPERATURE] : 0.0;
+
+    for (uint32_t i = 0; i < pTopology->tempSensorCount; i++)
+    {
+        if (0 == (pSnapshot->tempValidMask & CTL_BIT(i)))
+        {
+            continue;
+        }
+        double Value = pSnapshot->temperature[i];
+        switch (pTopology->tempSensorType[i])
+        {
+            case CTL_TEMP_SENSORS_GLOBAL:
+            case CTL_TEMP_SENSORS_GPU:
+                *pGpuC  = HaveGpu ? std::max(*pGpuC, Value) : Value;
+                HaveGpu = true;
+                break;
+            case CTL_TEMP_SENSORS_MEMORY:
+                *pVramC = std::max(*pVramC, Value);
+                break;
+            default:
+                break;
+        }
+    }
+    return HaveGpu;
+}
+
+/***************************************************************
+ * @brief Speed the fans run at before the loop takes over, in percent
+ *
+ * The fastest controlled fan of the sample, asked in percent when its
+ * maximum speed is unknown. Falls back to minPct without any reading.
+ ***************************************************************/
+static double FanControlCurrentPct(const FanControlConfig *pConfig, const AdapterTopology *pTopology, const FanControlLoop *pLoop, const AdapterSnapshot *pSnapshot)
+{
+    bool HaveSpeed = false;
+    double Pct     = 0.0;
+    for (uint32_t f = 0; f < pTopology->fanCount; f++)
+    {
+        if (0 == (pLoop->fanMask & CTL_BIT(f)))
+        {
+            continue;
+        }
+
+        int32_t Speed = 0;
+        if ((0 != (pSnapshot->fanValidMask & CTL_BIT(f))) && (pLoop->maxRpm[f] > 0))
+        {
+            Pct       = std::max(Pct, 100.0 * pSnapshot->fanSpeedRpm[f] / pLoop->maxRpm[f]);
+            HaveSpeed = true;
+        }
+        else if ((CTL_RESULT_SUCCESS == ctlFanGetState(pTopology->hFan[f], CTL_FAN_SPEED_UNITS_PERCENT, &Speed)) && (Speed >= 0))
+        {
+            Pct       = std::max(Pct, static_cast<double>(Speed));
+            HaveSpeed = true;
+        }
+    }
+    return HaveSpeed ? std::min(std::max(Pct, pConfig->minPct), 100.0) : pConfig->minPct;
+}
+
+/***************************************************************
+ * @brief Points of the table anchored at the command, in percent
+ *
+ * Rises linearly from minPct at the first point to the command at the
+ * current temperature, then toward full speed at criticalC, capped at
+ * the acoustic limit except for the last point.
+ ***************************************************************/
+static void FanControlBuildTable(const FanControlConfig *pConfig, uint32_t Points, double GpuC, double CommandPct, uint32_t *pTableC, int32_t *pTablePct)
+{
+    double SpanC = pConfig->criticalC - FAN_CONTROL_TABLE_MIN_C;
+    for (uint32_t i = 0; i < Points; i++)
+    {
+        double PointC = FAN_CONTROL_TABLE_MIN_C + SpanC * i / (Points - 1);
+        double Pct    = 100.0;
+        if (i + 1 < Points)
+        {
+            if (PointC <= GpuC)
+            {
+                Pct = pConfig->minPct + (CommandPct - pConfig->minPct) * (PointC - FAN_CONTROL_TABLE_MIN_C) / std::max(GpuC - FAN_CONTROL_TABLE_MIN_C, 1.0);
+            }
+            else
+            {
+                Pct = std::min(CommandPct + (100.0 - CommandPct) * (PointC - GpuC) / (pConfig->criticalC - GpuC), pConfig->acousticMaxPct);
+            }
+        }
+        pTableC[i]   = static_cast<uint32_t>(lround(PointC));
+        pTablePct[i] = static_cast<int32_t>(lround(std::min(std::max(Pct, pConfig->minPct), 100.0)));
+    }
+}
+
+/***************************************************************
+ * @brief Writes the table to every controlled fan, stops at the first failure
+ ***************************************************************/
+static ctl_result_t FanControlWrite(const AdapterTopology *pTopology, const FanControlLoop *pLoop, const uint32_t *pTableC, const int32_t *pTablePct)
+{
+    for (uint32_t f = 0; f < pTopology->fanCount; f++)
+    {
+        if (0 == (pLoop->fanMask & CTL_BIT(f)))
+        {
+            continue;
+        }
+
+        ctl_fan_speed_table_t Table = {};
+        Table.Size                  = sizeof(ctl_fan_speed_table_t);
+        Table.numPoints             = static_cast<int32_t>(pLoop->tablePoints);
+        for (uint32_t i = 0; i < pLoop->tablePoints; i++)
+        {
+            ctl_fan_temp_speed_t *pPoint = &Table.table[i];
+            pPoint->Size                 = sizeof(ctl_fan_temp_speed_t);
+            pPoint->temperature          = pTableC[i];
+            pPoint->speed.Size           = sizeof(ctl_fan_speed_t);
+            pPoint->speed.units          = pLoop->units[f];
+            pPoint->speed.speed          = (CTL_FAN_SPEED_UNITS_PERCENT == pLoop->units[f]) ? pTablePct[i] : pTablePct[i] * pLoop->maxRpm[f] / 100;
+        }
+
+        ctl_result_t Result = ctlFanSetSpeedTableMode(pTopology->hFan[f], &Table);
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            return Result;
+        }
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+static void FanControlRestoreDefault(const AdapterTopology *pTopology, const FanControlLoop *pLoop)
+{
+    for (uint32_t f = 0; f < pTopology->fanCount; f++)
+    {
+        if (0 != (pLoop->fanMask & CTL_BIT(f)))
+        {
+            ctlFanSetDefaultMode(pTopology->hFan[f]);
+        }
+    }
+}
+
+void FanControllerUpdate(FanController *pController, const PublishedSnapshot *pSample)
+{
+    const AdapterSnapshot *pSnapshot = &pSample->snapshot;
+    uint32_t Adapter                 = pSnapshot->adapterIndex;
+    if ((nullptr == pController) || (Adapter >= pController->pCache->adapterCount))
+    {
+        return;
+    }
+
+    const FanControlConfig *pConfig  = &pController->config;
+    const AdapterTopology *pTopology = &pController->pCache->topology[Adapter];
+    FanControlLoop *pLoop            = &pController->loops[Adapter];
+    FanControlStats *pStats          = &pController->working[Adapter];
+    if (FAN_CONTROL_STATE_UNSUPPORTED == pStats->state)
+    {
+        return;
+    }
+
+    uint64_t NowNs = pSnapshot->hostTimestampNs;
+    double GpuC    = 0.0;
+    double VramC   = 0.0;
+    if (!FanControlTemperatures(pTopology, pSnapshot, &GpuC, &VramC))
+    {
+        // Without an input the tables would go stale, the default curve is safer
+        if ((++pLoop->stalePasses >= FAN_CONTROL_STALE_PASSES) && (FAN_CONTROL_STATE_ACTIVE == pStats->state))
+        {
+            FanControlRestoreDefault(pTopology, pLoop);
+            pStats->state = FAN_CONTROL_STATE_DEFAULT;
+            pStats->fallbacks++;
+            pLoop->lastNs = 0;
+        }
+    }
+    else
+    {
+        pLoop->stalePasses = 0;
+        double IntervalSec = (0 != pLoop->lastNs) ? (NowNs - pLoop->lastNs) / 1e9 : 0.0;
+        if (0 == pLoop->lastNs)
+        {
+            // Taking over from the default curve, slew from where it left the fans
+            pLoop->commandPct = FanControlCurrentPct(pConfig, pTopology, pLoop, pSnapshot);
+        }
+        double ErrorC      = GpuC - pConfig->gpuTargetC;
+        if (VramC > 0.0)
+        {
+            ErrorC = std::max(ErrorC, VramC - pConfig->vramTargetC);
+        }
+
+        // Derivative on the measurement, so target changes do not kick the output
+        if (IntervalSec > 0.0)
+        {
+            double SlopeCPerSec = (GpuC - pLoop->lastGpuC) / IntervalSec;
+            pLoop->slopeCPerSec += (SlopeCPerSec - pLoop->slopeCPerSec) * TimeSeriesEwmaWeight(IntervalSec, FAN_CONTROL_DERIVATIVE_TAU_SEC);
+        }
+        else
+        {
+            pLoop->slopeCPerSec = 0.0;
+            pLoop->integralPct  = 0.0;
+        }
+
+        // Integrate only while the output can still act on the error
+        double CeilingPct = (GpuC >= pConfig->criticalC) ? 100.0 : pConfig->acousticMaxPct;
+        double OutputPct  = pConfig->minPct + pConfig->kp * ErrorC + pLoop->integralPct + pConfig->kd * pLoop->slopeCPerSec;
+        bool Saturated    = ((OutputPct >= CeilingPct) && (ErrorC > 0.0)) || ((OutputPct <= pConfig->minPct) && (ErrorC < 0.0));
+        if (!Saturated)
+        {
+            pLoop->integralPct += pConfig->ki * ErrorC * IntervalSec;
+            OutputPct += pConfig->ki * ErrorC * IntervalSec;
+        }
+        OutputPct = std::min(std::max(OutputPct, pConfig->minPct), CeilingPct);
+
+        // The acoustic slew limit holds below the critical temperature only,
+        // the first pass after a takeover moves by one period's worth
+        if (GpuC < pConfig->criticalC)
+        {
+            double SlewSec = (IntervalSec > 0.0) ? IntervalSec : pController->pCache->periodMs / 1e3;
+            double StepPct = pConfig->maxSlewPctPerSec * SlewSec;
+            OutputPct      = std::min(std::max(OutputPct, pLoop->commandPct - StepPct), pLoop->commandPct + StepPct);
+        }
+        pLoop->commandPct = OutputPct;
+        pLoop->lastGpuC   = GpuC;
+        pLoop->lastNs     = NowNs;
+
+        pStats->gpuC       = GpuC;
+        pStats->vramC      = VramC;
+        pStats->errorC     = ErrorC;
+        pStats->commandPct = OutputPct;
+
+        uint32_t TableC[FAN_CONTROL_MAX_TABLE_POINTS];
+        int32_t TablePct[FAN_CONTROL_MAX_TABLE_POINTS];
+        FanControlBuildTable(pConfig, pLoop->tablePoints, GpuC, OutputPct, TableC, TablePct);
+
+        int32_t MaxRisePct = 0;
+        int32_t MaxFallPct = 0;
+        for (uint32_t i = 0; i < pLoop->tablePoints; i++)
+        {
+            MaxRisePct = std::max(MaxRisePct, TablePct[i] - pLoop->writtenPct[i]);
+            MaxFallPct = std::max(MaxFallPct, pLoop->writtenPct[i] - TablePct[i]);
+        }
+
+        bool Due = false;
+        if (FAN_CONTROL_STATE_FALLBACK == pStats->state)
+        {
+            Due = (NowNs >= pLoop->retryNs);
+        }
+        else if (FAN_CONTROL_STATE_DEFAULT == pStats->state)
+        {
+            Due = true;
+        }
+        else
+        {
+            Due = (MaxRisePct >= pConfig->minChangePct) ||
+                  ((MaxFallPct >= pConfig->minChangePct) && (NowNs - pLoop->lastWriteNs >= static_cast<uint64_t>(FAN_CONTROL_MIN_WRITE_SEC * 1e9)));
+        }
+
+        if (!Due)
+        {
+            pStats->suppressed++;
+        }
+        else
+        {
+            pStats->lastResult = FanControlWrite(pTopology, pLoop, TableC, TablePct);
+            if (CTL_RESULT_SUCCESS == pStats->lastResult)
+            {
+                memcpy(pLoop->writtenPct, TablePct, sizeof(pLoop->writtenPct));
+                memcpy(pStats->tableC, TableC, sizeof(pStats->tableC));
+                memcpy(pStats->tablePct, TablePct, sizeof(pStats->tablePct));
+                pStats->tablePoints = pLoop->tablePoints;
+                pStats->state       = FAN_CONTROL_STATE_ACTIVE;
+                pLoop->lastWriteNs  = NowNs;
+                pStats->writes++;
+            }
+            else
+            {
+                // Fans may be left on a mix of tables, hand all of them back
+                FanControlRestoreDefault(pTopology, pLoop);
+                pStats->state       = FAN_CONTROL_STATE_FALLBACK;
+                pStats->tablePoints = 0;
+                pLoop->retryNs      = NowNs + static_cast<uint64_t>(FAN_CONTROL_RETRY_SEC * 1e9);
+                pStats->failures++;
+                pStats->fallbacks++;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> Guard(pController->statsLock);
+    pController->stats[Adapter] = *pStats;
+}
+
+ctl_result_t FanControllerRead(FanController *pController, uint32_t AdapterIndex, FanControlStats *pStats)
+{
+    if ((nullptr == pController) || (nullptr == pStats))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (AdapterIndex >= AGENT_MAX_ADAPTERS)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pController->statsLock);
+    *pStats = pController->stats[AdapterIndex];
+    return CTL_RESULT_SUCCESS;
+}
+
+void FanControllerRelease(FanController *pController)
+{
+    if (nullptr == pController)
+    {
+        return;
+    }
+
+    for (uint32_t a = 0; a < pController->pCache->adapterCount; a++)
+    {
+        FanControlStats *pStats = &pController->working[a];
+        if (FAN_CONTROL_STATE_ACTIVE == pStats->state)
+        {
+            FanControlRestoreDefault(&pController->pCache->topology[a], &pController->loops[a]);
+            pStats->state       = FAN_CONTROL_STATE_DEFAULT;
+            pStats->tablePoints = 0;
+        }
+    }
+
+    std::lock_guard<std::mutex> Guard(pController->statsLock);
+    memcpy(pController->stats, pController->working, sizeof(pController->stats));
+}
+
+const char *FanControlStateLabel(FanControlState State)
+{
+    switch (State)
+    {
+        case FAN_CONTROL_STATE_UNSUPPORTED:
+            return "unsupported";
+        case FAN_CONTROL_STATE_DEFAULT:
+            return "default";
+        case FAN_CONTROL_STATE_ACTIVE:
+            return "active";
+        case FAN_CONTROL_STATE_FALLBACK:
+            return "fallback";
+        default:
+            return "unknown";
+    }
+}
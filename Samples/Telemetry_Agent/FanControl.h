@@ -0,0 +1,161 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  FanControl.h
+ * @brief Closed loop fan control through temperature to speed tables.
+ *
+ * A PI loop with a filtered derivative on the GPU temperature runs on every
+ * pass of an adapter. Its error is the worse of the GPU and VRAM margins to
+ * their targets, so whichever runs hotter sets the command. All fans of an
+ * adapter share the loop.
+ *
+ * The command is not written as a fixed speed. It becomes the anchor of a
+ * table on the GPU temperature axis: from the minimum speed at the first
+ * point up to the command at the current temperature, then on toward full
+ * speed at the critical temperature. The firmware keeps following the
+ * table between passes, so a temperature rise is answered at once, and the
+ * loop only has to move the anchor.
+ *
+ * Below the critical temperature speeds are capped at the acoustic limit
+ * and the command slews at a bounded rate, on taking over from the speed
+ * the default curve left the fans at. A table is written with
+ * ctlFanSetSpeedTableMode only when a point moves by at least minChangePct;
+ * lowering waits FAN_CONTROL_MIN_WRITE_SEC after the previous write,
+ * raising never waits. A failed write hands every fan of the adapter back
+ * to ctlFanSetDefaultMode for FAN_CONTROL_RETRY_SEC, as does losing the
+ * temperature for FAN_CONTROL_STALE_PASSES passes.
+ *
+ * Writes are made by the listener, so only the sampler thread calls into
+ * the driver.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <mutex>
+
+#include "TelemetryCache.h"
+
+#define FAN_CONTROL_MAX_TABLE_POINTS 8
+#define FAN_CONTROL_TABLE_MIN_C 30 ///< Temperature of the first table point
+#define FAN_CONTROL_MIN_WRITE_SEC 5.0
+#define FAN_CONTROL_RETRY_SEC 60.0
+#define FAN_CONTROL_STALE_PASSES 5
+#define FAN_CONTROL_DERIVATIVE_TAU_SEC 5.0
+
+enum FanControlState
+{
+    FAN_CONTROL_STATE_UNSUPPORTED = 0, ///< No fan takes a speed table
+    FAN_CONTROL_STATE_DEFAULT,         ///< Default curve, before the first write or without a temperature
+    FAN_CONTROL_STATE_ACTIVE,          ///< Following the tables of the loop
+    FAN_CONTROL_STATE_FALLBACK,        ///< Default curve after a failed write, until the retry
+    FAN_CONTROL_STATE_COUNT
+};
+
+struct FanControlConfig
+{
+    double gpuTargetC;       ///< Held by the loop, below where the GPU throttles
+    double vramTargetC;      ///< Held by the loop when VRAM runs closer to its target
+    double criticalC;        ///< Last table point, at full speed past the acoustic limit
+    double minPct;           ///< Floor of every table point
+    double acousticMaxPct;   ///< Ceiling below the critical temperature
+    double maxSlewPctPerSec; ///< How fast the command may rise or fall below it
+    double minChangePct;     ///< Smaller moves of every point are not written
+    double kp;               ///< Percent per C of error
+    double ki;               ///< Percent per C second of error
+    double kd;               ///< Percent per C/s of GPU temperature slope
+};
+
+/***************************************************************
+ * @brief Loop state of one adapter, sampler private
+ ***************************************************************/
+struct FanControlLoop
+{
+    uint32_t fanMask; ///< CTL_BIT of the fans under control
+    ctl_fan_speed_units_t units[AGENT_MAX_FANS];
+    int32_t maxRpm[AGENT_MAX_FANS];
+    uint32_t tablePoints;
+    uint64_t lastNs;
+    double lastGpuC;
+    double slopeCPerSec;
+    double integralPct;
+    double commandPct;
+    uint32_t stalePasses;
+    uint64_t lastWriteNs;
+    uint64_t retryNs;
+    int32_t writtenPct[FAN_CONTROL_MAX_TABLE_POINTS];
+};
+
+struct FanControlStats
+{
+    uint32_t adapterIndex;
+    FanControlState state;
+    uint32_t fanCount; ///< Under control
+    double gpuC;
+    double vramC;      ///< 0 when not reported
+    double errorC;     ///< Worst margin to a target, positive when too hot
+    double commandPct; ///< Speed the loop asks for at the current temperature
+    uint32_t tablePoints;
+    uint32_t tableC[FAN_CONTROL_MAX_TABLE_POINTS];
+    int32_t tablePct[FAN_CONTROL_MAX_TABLE_POINTS]; ///< Last table written
+    uint64_t writes;
+    uint64_t suppressed; ///< Passes whose table was too close to the written one
+    uint64_t failures;
+    uint64_t fallbacks; ///< Hand backs to the default curve, failures or lost temperature
+    ctl_result_t lastResult;
+};
+
+struct FanController
+{
+    FanControlConfig config;
+    const TelemetryCache *pCache;
+
+    FanControlLoop loops[AGENT_MAX_ADAPTERS];    ///< Sampler private
+    FanControlStats working[AGENT_MAX_ADAPTERS]; ///< Sampler private
+
+    std::mutex statsLock;
+    FanControlStats stats[AGENT_MAX_ADAPTERS];
+};
+
+/***************************************************************
+ * @brief Fills the default configuration, tuned for throughput
+ *
+ * Targets sit well below the throttle points and the acoustic limit is
+ * full speed; lower acousticMaxPct where noise matters.
+ ***************************************************************/
+void FanControlDefaultConfig(FanControlConfig *pConfig);
+
+/***************************************************************
+ * @brief Finds the fans that take speed tables and registers the listener
+ *
+ * Fans stay on their default curve until the first pass. pConfig may be
+ * nullptr for the defaults. Call before TelemetryCacheStart.
+ ***************************************************************/
+ctl_result_t FanControllerInit(FanController *pController, const FanControlConfig *pConfig, TelemetryCache *pCache);
+
+/***************************************************************
+ * @brief Runs the loop of one adapter over one pass
+ ***************************************************************/
+void FanControllerUpdate(FanController *pController, const PublishedSnapshot *pSample);
+
+ctl_result_t FanControllerRead(FanController *pController, uint32_t AdapterIndex, FanControlStats *pStats);
+
+/***************************************************************
+ * @brief Returns every controlled fan to its default curve
+ *
+ * Call after TelemetryCacheStop.
+ ***************************************************************/
+void FanControllerRelease(FanController *pController);
+
+/***************************************************************
+ * @brief Lower case state name used in labels
+ ***************************************************************/
+const char *FanControlStateLabel(FanControlState State);
@@ -0,0 +1,428 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  FrequencyGovernor.cpp
+ * @brief Frequency ranges that follow the phase of the running workload.
+ *
+ */
+
+#include <string.h>
+#include <algorithm>
+
+#include "FrequencyGovernor.h"
+#include "TimeSeriesStore.h"
+
+void FreqGovernorDefaultConfig(FreqGovernorConfig *pConfig)
+{
+    pConfig->idleActivityPct = 10.0;
+    pConfig->memoryBoundPct  = 60.0;
+    pConfig->narrowDwellSec  = 3.0;
+    pConfig->widenDwellSec   = 0.2;
+
+    pConfig->gpuCapPct[FREQ_PHASE_UNKNOWN]    = 100.0;
+    pConfig->gpuCapPct[FREQ_PHASE_COMPUTE]    = 100.0;
+    pConfig->gpuCapPct[FREQ_PHASE_MEMORY]     = 60.0;
+    pConfig->gpuCapPct[FREQ_PHASE_IDLE]       = 30.0;
+    pConfig->memoryCapPct[FREQ_PHASE_UNKNOWN] = 100.0;
+    pConfig->memoryCapPct[FREQ_PHASE_COMPUTE] = 100.0;
+    pConfig->memoryCapPct[FREQ_PHASE_MEMORY]  = 100.0;
+    pConfig->memoryCapPct[FREQ_PHASE_IDLE]    = 50.0;
+}
+
+static void FreqGovernorListener(const AdapterSnapshot *pPrevious, const PublishedSnapshot *pCurrent, void *pContext)
+{
+    (void)pPrevious;
+    FreqGovernorUpdate(static_cast<FrequencyGovernor *>(pContext), pCurrent);
+}
+
+/***************************************************************
+ * @brief Caches a domain, false if its range cannot be set
+ ***************************************************************/
+static bool FreqGovernorCacheDomain(ctl_freq_handle_t hFrequency, FreqGovernorDomain *pDomain)
+{
+    ctl_freq_properties_t Properties = {};
+    Properties.Size                  = sizeof(ctl_freq_properties_t);
+    if ((CTL_RESULT_SUCCESS != ctlFrequencyGetProperties(hFrequency, &Properties)) || !Properties.canControl || !(Properties.max > Properties.min))
+    {
+        return false;
+    }
+
+    pDomain->original      = {};
+    pDomain->original.Size = sizeof(ctl_freq_range_t);
+    if (CTL_RESULT_SUCCESS != ctlFrequencyGetRange(hFrequency, &pDomain->original))
+    {
+        return false;
+    }
+
+    pDomain->hFrequency     = hFrequency;
+    pDomain->type           = Properties.type;
+    pDomain->hardwareMinMhz = Properties.min;
+    pDomain->hardwareMaxMhz = Properties.max;
+    pDomain->writtenMaxMhz  = 0.0;
+
+    // Without steps caps are written as computed
+    uint32_t Count = FREQ_GOVERNOR_MAX_CLOCKS;
+    if (CTL_RESULT_SUCCESS != ctlFrequencyGetAvailableClocks(hFrequency, &Count, pDomain->clocksMhz))
+    {
+        Count = 0;
+    }
+    pDomain->clockCount = std::min<uint32_t>(Count, FREQ_GOVERNOR_MAX_CLOCKS);
+    std::sort(pDomain->clocksMhz, pDomain->clocksMhz + pDomain->clockCount);
+    return true;
+}
+
+ctl_result_t FreqGovernorInit(FrequencyGovernor *pGovernor, const FreqGovernorConfig *pConfig, TelemetryCache *pCache)
+{
+    if ((nullptr == pGovernor) || (nullptr == pCache))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    if (nullptr != pConfig)
+    {
+        pGovernor->config = *pConfig;
+    }
+    else
+    {
+        FreqGovernorDefaultConfig(&pGovernor->config);
+    }
+
+    const FreqGovernorConfig *pCfg = &pGovernor->config;
+    if ((pCfg->idleActivityPct < 0.0) || (pCfg->memoryBoundPct <= 0.0) || (pCfg->narrowDwellSec < 0.0) || (pCfg->widenDwellSec < 0.0))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+    for (uint32_t p = 0; p < FREQ_PHASE_COUNT; p++)
+    {
+        if ((pCfg->gpuCapPct[p] < 0.0) || (pCfg->gpuCapPct[p] > 100.0) || (pCfg->memoryCapPct[p] < 0.0) || (pCfg->memoryCapPct[p] > 100.0))
+        {
+            return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    pGovernor->pCache = pCache;
+    memset(pGovernor->loops, 0, sizeof(pGovernor->loops));
+    memset(pGovernor->working, 0, sizeof(pGovernor->working));
+    for (uint32_t a = 0; a < AGENT_MAX_ADAPTERS; a++)
+    {
+        FreqGovernorLoop *pLoop   = &pGovernor->loops[a];
+        FreqGovernorStats *pStats = &pGovernor->working[a];
+        pStats->adapterIndex      = a;
+        pStats->lastResult        = CTL_RESULT_SUCCESS;
+        if (a >= pCache->adapterCount)
+        {
+            continue;
+        }
+
+        const AdapterTopology *pTopology = &pCache->topology[a];
+        for (uint32_t d = 0; d < pTopology->freqDomainCount; d++)
+        {
+            if (FreqGovernorCacheDomain(pTopology->hFreq[d], &pLoop->domains[pLoop->domainCount]))
+            {
+                pLoop->domainCount++;
+            }
+        }
+        for (uint32_t m = 0; m < pTopology->memModuleCount; m++)
+        {
+            ctl_mem_bandwidth_t Bandwidth = {};
+            Bandwidth.Size                = sizeof(ctl_mem_bandwidth_t);
+            Bandwidth.Version             = 1;
+            if (CTL_RESULT_SUCCESS == ctlMemoryGetBandwidth(pTopology->hMemory[m], &Bandwidth))
+            {
+                pLoop->maxBandwidthBps += static_cast<double>(Bandwidth.maxBandwidth);
+            }
+        }
+        pStats->domainCount = pLoop->domainCount;
+        pStats->state       = (0 != pLoop->domainCount) ? FREQ_GOVERNOR_STATE_ACTIVE : FREQ_GOVERNOR_STATE_UNSUPPORTED;
+    }
+
+    {
+        std::lock_guard<std::mutex> Guard(pGovernor->statsLock);
+        memcpy(pGovernor->stats, pGovernor->working, sizeof(pGovernor->stats));
+    }
+    return TelemetryCacheAddListener(pCache, FreqGovernorListener, pGovernor);
+}
+
+/***************************************************************
+ * @brief Busiest render and compute group of a pass, false if none was measured
+ ***************************************************************/
+static bool FreqGovernorActivity(const AdapterTopology *pTopology, const DerivedMetrics *pDerived, double *pActivityPct)
+{
+    bool Found = false;
+    for (uint32_t i = 0; i < pTopology->engineGroupCount; i++)
+    {
+        if ((0 != (pDerived->engineValidMask & CTL_BIT(i))) && (CTL_ENGINE_GROUP_RENDER == pTopology->engineGroupType[i]))
+        {
+            *pActivityPct = Found ? std::max(*pActivityPct, pDerived->engineUtilizationPct[i]) : pDerived->engineUtilizationPct[i];
+            Found         = true;
+        }
+    }
+    if (!Found && (0 != (pDerived->validMask & DERIVED_VALID_RENDER_UTILIZATION)))
+    {
+        *pActivityPct = pDerived->renderUtilizationPct;
+        Found         = true;
+    }
+    if (!Found && (0 != (pDerived->validMask & DERIVED_VALID_GLOBAL_UTILIZATION)))
+    {
+        *pActivityPct = pDerived->globalUtilizationPct;
+        Found         = true;
+    }
+    return Found;
+}
+
+/***************************************************************
+ * @brief Top of the start range, negative values mean no limit
+ ***************************************************************/
+static double FreqGovernorTopMhz(const FreqGovernorDomain *pDomain)
+{
+    return (pDomain->original.max > 0.0) ? std::min(pDomain->original.max, pDomain->hardwareMaxMhz) : pDomain->hardwareMaxMhz;
+}
+
+/***************************************************************
+ * @brief Top of the range of a domain in a phase, on a clock step
+ ***************************************************************/
+static double FreqGovernorCapMhz(const FreqGovernorConfig *pConfig, const FreqGovernorDomain *pDomain, FreqPhase Phase)
+{
+    double CapPct = (CTL_FREQ_DOMAIN_GPU == pDomain->type) ? pConfig->gpuCapPct[Phase] : pConfig->memoryCapPct[Phase];
+    double TopMhz = FreqGovernorTopMhz(pDomain);
+    double BotMhz = (pDomain->original.min > 0.0) ? pDomain->original.min : pDomain->hardwareMinMhz;
+    double CapMhz = std::min(pDomain->hardwareMinMhz + CapPct / 100.0 * (pDomain->hardwareMaxMhz - pDomain->hardwareMinMhz), TopMhz);
+
+    // Highest step under the cap, or the lowest step at or above the bottom
+    if (0 != pDomain->clockCount)
+    {
+        const double *pEnd  = pDomain->clocksMhz + pDomain->clockCount;
+        const double *pStep = std::upper_bound(pDomain->clocksMhz, pEnd, CapMhz);
+        CapMhz              = (pStep != pDomain->clocksMhz) ? *(pStep - 1) : pDomain->clocksMhz[0];
+        if (CapMhz < BotMhz)
+        {
+            pStep  = std::lower_bound(pDomain->clocksMhz, pEnd, BotMhz);
+            CapMhz = (pStep != pEnd) ? *pStep : TopMhz;
+        }
+    }
+    return std::max(CapMhz, BotMhz);
+}
+
+/***************************************************************
+ * @brief Hands every domain of an adapter back its start range
+ ***************************************************************/
+static void FreqGovernorRestore(FreqGovernorLoop *pLoop, FreqGovernorStats *pStats)
+{
+    for (uint32_t d = 0; d < pLoop->domainCount; d++)
+    {
+        FreqGovernorDomain *pDomain = &pLoop->domains[d];
+        if (0.0 != pDomain->writtenMaxMhz)
+        {
+            ctlFrequencySetRange(pDomain->hFrequency, &pDomain->original);
+            pDomain->writtenMaxMhz = 0.0;
+        }
+        pStats->maxMhz[d] = 0.0;
+    }
+}
+
+/***************************************************************
+ * @brief Writes the caps of a phase, restoring all domains on failure
+ ***************************************************************/
+static ctl_result_t FreqGovernorApply(const FreqGovernorConfig *pConfig, FreqGovernorLoop *pLoop, FreqGovernorStats *pStats, FreqPhase Phase)
+{
+    for (uint32_t d = 0; d < pLoop->domainCount; d++)
+    {
+        FreqGovernorDomain *pDomain = &pLoop->domains[d];
+        double CapMhz               = FreqGovernorCapMhz(pConfig, pDomain, Phase);
+        double InForceMhz           = (0.0 != pDomain->writtenMaxMhz) ? pDomain->writtenMaxMhz : FreqGovernorTopMhz(pDomain);
+        if (CapMhz == InForceMhz)
+        {
+            continue;
+        }
+
+        ctl_freq_range_t Range = pDomain->original;
+        Range.max              = CapMhz;
+        ctl_result_t Result    = ctlFrequencySetRange(pDomain->hFrequency, &Range);
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            // Domains may be left on a mix of phases, hand all of them back
+            pDomain->writtenMaxMhz = CapMhz;
+            FreqGovernorRestore(pLoop, pStats);
+            return Result;
+        }
+        pDomain->writtenMaxMhz = CapMhz;
+        pStats->maxMhz[d]      = CapMhz;
+        pStats->writes++;
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+void FreqGovernorUpdate(FrequencyGovernor *pGovernor, const PublishedSnapshot *pSample)
+{
+    const uint32_t Adapter = pSample->snapshot.adapterIndex;
+    if (Adapter >= pGovernor->pCache->adapterCount)
+    {
+        return;
+    }
+
+    const FreqGovernorConfig *pConfig = &pGovernor->config;
+    const DerivedMetrics *pDerived    = &pSample->derived;
+    FreqGovernorLoop *pLoop           = &pGovernor->loops[Adapter];
+    FreqGovernorStats *pStats         = &pGovernor->working[Adapter];
+    const uint64_t NowNs              = pSample->snapshot.hostTimestampNs;
+    if (FREQ_GOVERNOR_STATE_UNSUPPORTED == pStats->state)
+    {
+        return;
+    }
+
+    double ActivityPct = 0.0;
+    if (!FreqGovernorActivity(&pGovernor->pCache->topology[Adapter], pDerived, &ActivityPct))
+    {
+        return;
+    }
+    double MemoryPct = 0.0;
+    if ((pLoop->maxBandwidthBps > 0.0) && (0 != (pDerived->validMask & DERIVED_VALID_VRAM_READ)) && (0 != (pDerived->validMask & DERIVED_VALID_VRAM_WRITE)))
+    {
+        MemoryPct = 100.0 * (pDerived->vramReadBytesPerSec + pDerived->vramWriteBytesPerSec) / pLoop->maxBandwidthBps;
+    }
+
+    double Dt     = ((0 != pLoop->lastNs) && (NowNs > pLoop->lastNs)) ? (NowNs - pLoop->lastNs) / 1e9 : 0.0;
+    pLoop->lastNs = NowNs;
+    if (!pLoop->smoothed)
+    {
+        pStats->activityPct = ActivityPct;
+        pStats->memoryPct   = MemoryPct;
+        pLoop->smoothed     = true;
+    }
+    else
+    {
+        double Weight = TimeSeriesEwmaWeight(Dt, FREQ_GOVERNOR_SMOOTHING_TAU_SEC);
+        pStats->activityPct += Weight * (ActivityPct - pStats->activityPct);
+        pStats->memoryPct += Weight * (MemoryPct - pStats->memoryPct);
+    }
+
+    pStats->phaseSec[pStats->phase] += Dt;
+    if (0 != (pDerived->validMask & DERIVED_VALID_GPU_POWER))
+    {
+        pStats->phaseEnergyJ[pStats->phase] += pDerived->gpuPowerW * Dt;
+    }
+
+    FreqPhase Phase = FREQ_PHASE_COMPUTE;
+    if (pStats->activityPct < pConfig->idleActivityPct)
+    {
+        Phase = FREQ_PHASE_IDLE;
+    }
+    else if (pStats->memoryPct >= pConfig->memoryBoundPct)
+    {
+        Phase = FREQ_PHASE_MEMORY;
+    }
+
+    bool Due = false;
+    if (Phase != pLoop->pending)
+    {
+        pLoop->pending        = Phase;
+        pLoop->pendingSinceNs = NowNs;
+    }
+    if ((Phase != pStats->phase) && (FREQ_GOVERNOR_STATE_ACTIVE == pStats->state))
+    {
+        bool Widens  = (pConfig->gpuCapPct[Phase] >= pConfig->gpuCapPct[pStats->phase]) && (pConfig->memoryCapPct[Phase] >= pConfig->memoryCapPct[pStats->phase]);
+        double Dwell = Widens ? pConfig->widenDwellSec : pConfig->narrowDwellSec;
+        Due          = (NowNs - pLoop->pendingSinceNs >= static_cast<uint64_t>(Dwell * 1e9));
+    }
+    else if ((FREQ_GOVERNOR_STATE_FALLBACK == pStats->state) && (NowNs >= pLoop->retryNs))
+    {
+        Due = true;
+    }
+
+    if (Due)
+    {
+        pStats->lastResult = FreqGovernorApply(pConfig, pLoop, pStats, Phase);
+        if (CTL_RESULT_SUCCESS == pStats->lastResult)
+        {
+            pStats->transitions += (Phase != pStats->phase) ? 1 : 0;
+            pStats->phase = Phase;
+            pStats->state = FREQ_GOVERNOR_STATE_ACTIVE;
+        }
+        else
+        {
+            pStats->phase  = FREQ_PHASE_UNKNOWN;
+            pStats->state  = FREQ_GOVERNOR_STATE_FALLBACK;
+            pLoop->retryNs = NowNs + static_cast<uint64_t>(FREQ_GOVERNOR_RETRY_SEC * 1e9);
+            pStats->failures++;
+        }
+    }
+
+    std::lock_guard<std::mutex> Guard(pGovernor->statsLock);
+    pGovernor->stats[Adapter] = *pStats;
+}
+
+ctl_result_t FreqGovernorRead(FrequencyGovernor *pGovernor, uint32_t AdapterIndex, FreqGovernorStats *pStats)
+{
+    if ((nullptr == pGovernor) || (nullptr == pStats))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (AdapterIndex >= AGENT_MAX_ADAPTERS)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pGovernor->statsLock);
+    *pStats = pGovernor->stats[AdapterIndex];
+    return CTL_RESULT_SUCCESS;
+}
+
+void FreqGovernorRelease(FrequencyGovernor *pGovernor)
+{
+    if (nullptr == pGovernor)
+    {
+        return;
+    }
+
+    for (uint32_t a = 0; a < pGovernor->pCache->adapterCount; a++)
+    {
+        FreqGovernorStats *pStats = &pGovernor->working[a];
+        if (FREQ_GOVERNOR_STATE_UNSUPPORTED != pStats->state)
+        {
+            FreqGovernorRestore(&pGovernor->loops[a], pStats);
+            pStats->phase = FREQ_PHASE_UNKNOWN;
+        }
+    }
+
+    std::lock_guard<std::mutex> Guard(pGovernor->statsLock);
+    memcpy(pGovernor->stats, pGovernor->working, sizeof(pGovernor->stats));
+}
+
+const char *FreqPhaseLabel(FreqPhase Phase)
+{
+    switch (Phase)
+    {
+        case FREQ_PHASE_UNKNOWN:
+            return "unknown";
+        case FREQ_PHASE_COMPUTE:
+            return "compute";
+        case FREQ_PHASE_MEMORY:
+            return "memory";
+        case FREQ_PHASE_IDLE:
+            return "idle";
+        default:
+            return "unknown";
+    }
+}
+
+const char *FreqGovernorStateLabel(FreqGovernorState State)
+{
+    switch (State)
+    {
+        case FREQ_GOVERNOR_STATE_UNSUPPORTED:
+            return "unsupported";
+        case FREQ_GOVERNOR_STATE_ACTIVE:
+            return "active";
+        case FREQ_GOVERNOR_STATE_FALLBACK:
+            return "fallback";
+        default:
+            return "unknown";
+    }
+}
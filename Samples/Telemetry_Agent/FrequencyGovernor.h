@@ -0,0 +1,167 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  FrequencyGovernor.h
+ * @brief Frequency ranges that follow the phase of the running workload.
+ *
+ * Every pass of an adapter is classified as idle, memory bound or compute
+ * from the busiest render and compute engine group and the share of the
+ * VRAM bandwidth in use, both smoothed over FREQ_GOVERNOR_SMOOTHING_TAU_SEC.
+ * Each phase caps the top of the range of every controllable frequency
+ * domain at a percentage of its hardware span. A memory bound kernel waits
+ * on VRAM whatever the GPU clock, so a lower cap saves energy per job there
+ * while compute keeps the whole range.
+ *
+ * A phase that lowers the cap must last narrowDwellSec before it is
+ * applied; one that raises it waits only widenDwellSec, so compute is
+ * never held back for long. Caps snap down to a clock step of
+ * ctlFrequencyGetAvailableClocks and never exceed the range in force at
+ * start, whose bottom is kept. Hardware limits, start ranges and clock
+ * steps are read once by FreqGovernorInit.
+ *
+ * A failed ctlFrequencySetRange restores the start ranges of the adapter
+ * until FREQ_GOVERNOR_RETRY_SEC has passed. Writes are made by the
+ * listener, so only the sampler thread calls into the driver.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <mutex>
+
+#include "TelemetryCache.h"
+
+#define FREQ_GOVERNOR_MAX_CLOCKS 128
+#define FREQ_GOVERNOR_SMOOTHING_TAU_SEC 2.0
+#define FREQ_GOVERNOR_RETRY_SEC 60.0
+
+enum FreqPhase
+{
+    FREQ_PHASE_UNKNOWN = 0, ///< Before the first classification, start ranges
+    FREQ_PHASE_COMPUTE,
+    FREQ_PHASE_MEMORY,
+    FREQ_PHASE_IDLE,
+    FREQ_PHASE_COUNT
+};
+
+enum FreqGovernorState
+{
+    FREQ_GOVERNOR_STATE_UNSUPPORTED = 0, ///< No controllable frequency domain
+    FREQ_GOVERNOR_STATE_ACTIVE,          ///< Following the phase
+    FREQ_GOVERNOR_STATE_FALLBACK,        ///< Start ranges after a failed write, until the retry
+    FREQ_GOVERNOR_STATE_COUNT
+};
+
+struct FreqGovernorConfig
+{
+    double idleActivityPct; ///< Busiest engine group below this is idle
+    double memoryBoundPct;  ///< VRAM bandwidth share from which a busy adapter is memory bound
+    double narrowDwellSec;  ///< How long a phase with a lower cap must last
+    double widenDwellSec;   ///< How long a phase with a higher cap must last
+
+    double gpuCapPct[FREQ_PHASE_COUNT];    ///< Top of the GPU range, percent of the span above the hardware minimum
+    double memoryCapPct[FREQ_PHASE_COUNT]; ///< Likewise for memory domains
+};
+
+/***************************************************************
+ * @brief Cached limits of one frequency domain, sampler private
+ ***************************************************************/
+struct FreqGovernorDomain
+{
+    ctl_freq_handle_t hFrequency;
+    ctl_freq_domain_t type;
+    double hardwareMinMhz;
+    double hardwareMaxMhz;
+    ctl_freq_range_t original; ///< Range in force at start
+    uint32_t clockCount;       ///< 0 when the steps are not reported
+    double clocksMhz[FREQ_GOVERNOR_MAX_CLOCKS];
+    double writtenMaxMhz; ///< 0 while the original range is in force
+};
+
+/***************************************************************
+ * @brief Phase detection state of one adapter, sampler private
+ ***************************************************************/
+struct FreqGovernorLoop
+{
+    uint32_t domainCount; ///< Controllable domains
+    FreqGovernorDomain domains[AGENT_MAX_FREQ_DOMAINS];
+    double maxBandwidthBps; ///< Sum over memory modules, 0 if unknown
+    uint64_t lastNs;
+    bool smoothed;
+    FreqPhase pending;
+    uint64_t pendingSinceNs;
+    uint64_t retryNs;
+};
+
+struct FreqGovernorStats
+{
+    uint32_t adapterIndex;
+    FreqGovernorState state;
+    FreqPhase phase; ///< Whose caps are in force
+    uint32_t domainCount;
+    double activityPct; ///< Smoothed busiest render and compute group
+    double memoryPct;   ///< Smoothed VRAM bandwidth share
+
+    double maxMhz[AGENT_MAX_FREQ_DOMAINS]; ///< Top of the range written, 0 for the original range
+    double phaseSec[FREQ_PHASE_COUNT];
+    double phaseEnergyJ[FREQ_PHASE_COUNT]; ///< GPU energy spent in each phase
+    uint64_t transitions;
+    uint64_t writes;
+    uint64_t failures;
+    ctl_result_t lastResult;
+};
+
+struct FrequencyGovernor
+{
+    FreqGovernorConfig config;
+    const TelemetryCache *pCache;
+
+    FreqGovernorLoop loops[AGENT_MAX_ADAPTERS];    ///< Sampler private
+    FreqGovernorStats working[AGENT_MAX_ADAPTERS]; ///< Sampler private
+
+    std::mutex statsLock;
+    FreqGovernorStats stats[AGENT_MAX_ADAPTERS];
+};
+
+/***************************************************************
+ * @brief Fills the default configuration
+ *
+ * Memory bound phases cap the GPU at 60 % of its span and idle at 30 %;
+ * memory domains are only capped while idle.
+ ***************************************************************/
+void FreqGovernorDefaultConfig(FreqGovernorConfig *pConfig);
+
+/***************************************************************
+ * @brief Caches the domain limits and clock steps and registers the listener
+ *
+ * pConfig may be nullptr for the defaults. Call before TelemetryCacheStart.
+ ***************************************************************/
+ctl_result_t FreqGovernorInit(FrequencyGovernor *pGovernor, const FreqGovernorConfig *pConfig, TelemetryCache *pCache);
+
+/***************************************************************
+ * @brief Classifies one pass of an adapter and applies its phase
+ ***************************************************************/
+void FreqGovernorUpdate(FrequencyGovernor *pGovernor, const PublishedSnapshot *pSample);
+
+ctl_result_t FreqGovernorRead(FrequencyGovernor *pGovernor, uint32_t AdapterIndex, FreqGovernorStats *pStats);
+
+/***************************************************************
+ * @brief Restores the start range of every domain written to
+ *
+ * Call after TelemetryCacheStop.
+ ***************************************************************/
+void FreqGovernorRelease(FrequencyGovernor *pGovernor);
+
+/***************************************************************
+ * @brief Lower case names used in labels
+ ***************************************************************/
+const char *FreqPhaseLabel(FreqPhase Phase);
+const char *FreqGovernorStateLabel(FreqGovernorState State);
@@ -0,0 +1,337 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  MemoryBandwidthMonitor.cpp
+ * @brief Continuous VRAM bandwidth from the memory module counters.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ClockCorrelation.h"
+#include "MemoryBandwidthMonitor.h"
+
+ctl_result_t MemoryBandwidthInit(MemoryBandwidthMonitor *pMonitor, const AdapterTopology *pTopologies, uint32_t AdapterCount, uint32_t PeriodMs, const TelemetryCache *pCache,
+                                 TimeSeriesStore *pStore)
+{
+    if ((nullptr == pMonitor) || (nullptr == pTopologies))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pMonitor->moduleCount  = 0;
+    pMonitor->adapterCount = (AdapterCount < AGENT_MAX_ADAPTERS) ? AdapterCount : AGENT_MAX_ADAPTERS;
+    pMonitor->periodMs     = (0 != PeriodMs) ? PeriodMs : MEM_BW_DEFAULT_PERIOD_MS;
+    pMonitor->pCache       = pCache;
+    pMonitor->pStore       = pStore;
+    pMonitor->pClocks      = nullptr;
+    pMonitor->passes       = 0;
+    pMonitor->stopRequested.store(false);
+    memset(pMonitor->havePrevious, 0, sizeof(pMonitor->havePrevious));
+    memset(pMonitor->working, 0, sizeof(pMonitor->working));
+    memset(pMonitor->workingCheck, 0, sizeof(pMonitor->workingCheck));
+
+    for (uint32_t i = 0; i < pMonitor->adapterCount; i++)
+    {
+        const AdapterTopology *pTopology       = &pTopologies[i];
+        pMonitor->workingCheck[i].adapterIndex = pTopology->adapterIndex;
+        for (uint32_t m = 0; (m < pTopology->memModuleCount) && (pMonitor->moduleCount < MEM_BW_MAX_MODULES); m++)
+        {
+            TrackedMemoryModule *pModule = &pMonitor->modules[pMonitor->moduleCount];
+            pModule->adapterIndex        = pTopology->adapterIndex;
+            pModule->moduleIndex         = m;
+            pModule->hMemory             = pTopology->hMemory[m];
+            pModule->readSeriesId        = TIME_SERIES_INVALID_ID;
+            pModule->writeSeriesId       = TIME_SERIES_INVALID_ID;
+            pModule->utilizationSeriesId = TIME_SERIES_INVALID_ID;
+
+            if (nullptr != pStore)
+            {
+                char Labels[TIME_SERIES_LABELS_LEN];
+                snprintf(Labels, sizeof(Labels), "adapter=\"%u\",module=\"%u\"", pModule->adapterIndex, m);
+                pModule->readSeriesId        = TimeSeriesStoreRegister(pStore, "vram_read_bytes_per_second", Labels);
+                pModule->writeSeriesId       = TimeSeriesStoreRegister(pStore, "vram_write_bytes_per_second", Labels);
+                pModule->utilizationSeriesId = TimeSeriesStoreRegister(pStore, "vram_bandwidth_utilization_percent", Labels);
+            }
+
+            pMonitor->working[pMonitor->moduleCount].adapterIndex = pModule->adapterIndex;
+            pMonitor->working[pMonitor->moduleCount].moduleIndex  = m;
+            pMonitor->moduleCount++;
+        }
+    }
+
+    std::lock_guard<std::mutex> Guard(pMonitor->statsLock);
+    memcpy(pMonitor->stats, pMonitor->working, sizeof(pMonitor->stats));
+    memcpy(pMonitor->crossCheck, pMonitor->workingCheck, sizeof(pMonitor->crossCheck));
+
+    return (0 != pMonitor->moduleCount) ? CTL_RESULT_SUCCESS : CTL_RESULT_ERROR_NOT_AVAILABLE;
+}
+
+static void AppendSeries(MemoryBandwidthMonitor *pMonitor, uint32_t *pCount, uint32_t SeriesId, double Value)
+{
+    if (TIME_SERIES_INVALID_ID != SeriesId)
+    {
+        pMonitor->seriesIds[*pCount]    = SeriesId;
+        pMonitor->seriesValues[*pCount] = Value;
+        (*pCount)++;
+    }
+}
+
+static double RelativeDifference(double Measured, double Reference)
+{
+    double Larger = (Measured > Reference) ? Measured : Reference;
+    if (Larger < MEM_BW_CROSSCHECK_MIN_BPS)
+    {
+        return 0.0;
+    }
+    return fabs(Measured - Reference) / Larger;
+}
+
+/***************************************************************
+ * @brief Compares the module totals of every adapter with its telemetry
+ ***************************************************************/
+static void MemoryBandwidthCrossCheckPass(MemoryBandwidthMonitor *pMonitor)
+{
+    for (uint32_t a = 0; a < pMonitor->adapterCount; a++)
+    {
+        MemoryBandwidthCrossCheck *pCheck = &pMonitor->workingCheck[a];
+        double IntervalSec                = pMonitor->adapterIntervalSec[a];
+        if ((IntervalSec <= 0.0) || (CTL_RESULT_SUCCESS != TelemetryCacheRead(pMonitor->pCache, a, &pMonitor->telemetry)))
+        {
+            continue;
+        }
+
+        const AdapterSnapshot *pSnapshot = &pMonitor->telemetry.snapshot;
+        const uint64_t Needed            = TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_VRAM_READ_BANDWIDTH) | TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_VRAM_WRITE_BANDWIDTH);
+        if ((0 == pSnapshot->sequence) || (Needed != (pSnapshot->telemetryValidMask & Needed)))
+        {
+            continue;
+        }
+
+        // Telemetry reports megabytes per second
+        double TelemetryRead  = pSnapshot->telemetryValues[TELEMETRY_ITEM_VRAM_READ_BANDWIDTH] * 1e6;
+        double TelemetryWrite = pSnapshot->telemetryValues[TELEMETRY_ITEM_VRAM_WRITE_BANDWIDTH] * 1e6;
+        if (!pCheck->valid)
+        {
+            pCheck->valid                     = true;
+            pCheck->moduleReadBytesPerSec     = pMonitor->adapterReadBytesPerSec[a];
+            pCheck->moduleWriteBytesPerSec    = pMonitor->adapterWriteBytesPerSec[a];
+            pCheck->telemetryReadBytesPerSec  = TelemetryRead;
+            pCheck->telemetryWriteBytesPerSec = TelemetryWrite;
+        }
+        else
+        {
+            double Weight = TimeSeriesEwmaWeight(IntervalSec, MEM_BW_SHORT_WINDOW_SEC);
+            pCheck->moduleReadBytesPerSec += Weight * (pMonitor->adapterReadBytesPerSec[a] - pCheck->moduleReadBytesPerSec);
+            pCheck->moduleWriteBytesPerSec += Weight * (pMonitor->adapterWriteBytesPerSec[a] - pCheck->moduleWriteBytesPerSec);
+            pCheck->telemetryReadBytesPerSec += Weight * (TelemetryRead - pCheck->telemetryReadBytesPerSec);
+            pCheck->telemetryWriteBytesPerSec += Weight * (TelemetryWrite - pCheck->telemetryWriteBytesPerSec);
+        }
+
+        double ReadDeviation  = RelativeDifference(pCheck->moduleReadBytesPerSec, pCheck->telemetryReadBytesPerSec);
+        double WriteDeviation = RelativeDifference(pCheck->moduleWriteBytesPerSec, pCheck->telemetryWriteBytesPerSec);
+        pCheck->deviation     = (ReadDeviation > WriteDeviation) ? ReadDeviation : WriteDeviation;
+        pCheck->maxDeviation  = (pCheck->deviation > pCheck->maxDeviation) ? pCheck->deviation : pCheck->maxDeviation;
+        pCheck->comparisons++;
+        pCheck->disagreements += (pCheck->deviation > MEM_BW_CROSSCHECK_TOLERANCE) ? 1 : 0;
+    }
+}
+
+void MemoryBandwidthAttachClockCorrelator(MemoryBandwidthMonitor *pMonitor, ClockCorrelator *pCorrelator)
+{
+    if (nullptr != pMonitor)
+    {
+        pMonitor->pClocks = pCorrelator;
+    }
+}
+
+void MemoryBandwidthSampleOnce(MemoryBandwidthMonitor *pMonitor)
+{
+    uint32_t Count = pMonitor->moduleCount;
+
+    // Driver calls only, back to back, plus the host clock reads around each one when correlating
+    bool Bracketed = (nullptr != pMonitor->pClocks);
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        pMonitor->batch[i]                = {};
+        pMonitor->batch[i].Size           = sizeof(ctl_mem_bandwidth_t);
+        pMonitor->batch[i].Version        = 1;
+        pMonitor->batchBracket[i].startNs = Bracketed ? AgentHostTimeNs() : 0;
+        pMonitor->batchResult[i]          = ctlMemoryGetBandwidth(pMonitor->modules[i].hMemory, &pMonitor->batch[i]);
+        pMonitor->batchBracket[i].endNs   = Bracketed ? AgentHostTimeNs() : 0;
+    }
+    uint64_t BatchEndNs = AgentHostTimeNs();
+    pMonitor->passes++;
+
+    // One module per adapter, modules are not promised a common base
+    AgentAdapterMask Correlated;
+    AgentAdapterMaskClear(&Correlated);
+    for (uint32_t i = 0; Bracketed && (i < Count); i++)
+    {
+        uint32_t Adapter = pMonitor->modules[i].adapterIndex;
+        if ((CTL_RESULT_SUCCESS == pMonitor->batchResult[i]) && (Adapter < AGENT_MAX_ADAPTERS) && !AgentAdapterMaskTest(&Correlated, Adapter))
+        {
+            ClockCorrelatorObserve(pMonitor->pClocks, Adapter, CLOCK_DOMAIN_MEM_BANDWIDTH, pMonitor->batch[i].timestamp / 1e6, &pMonitor->batchBracket[i]);
+            AgentAdapterMaskSet(&Correlated, Adapter);
+        }
+    }
+
+    memset(pMonitor->adapterIntervalSec, 0, sizeof(pMonitor->adapterIntervalSec));
+    memset(pMonitor->adapterReadBytesPerSec, 0, sizeof(pMonitor->adapterReadBytesPerSec));
+    memset(pMonitor->adapterWriteBytesPerSec, 0, sizeof(pMonitor->adapterWriteBytesPerSec));
+
+    uint32_t SeriesCount = 0;
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        if (CTL_RESULT_SUCCESS != pMonitor->batchResult[i])
+        {
+            continue;
+        }
+
+        ctl_mem_bandwidth_t Before       = pMonitor->previous[i];
+        const ctl_mem_bandwidth_t &After = pMonitor->batch[i];
+        bool HadPrevious                 = pMonitor->havePrevious[i];
+        pMonitor->previous[i]            = After;
+        pMonitor->havePrevious[i]        = true;
+
+        if (!HadPrevious || (After.timestamp <= Before.timestamp) || (After.readCounter < Before.readCounter) || (After.writeCounter < Before.writeCounter))
+        {
+            continue;
+        }
+
+        double IntervalSec       = static_cast<double>(After.timestamp - Before.timestamp) / 1e6;
+        MemoryBandwidth *pStats  = &pMonitor->working[i];
+        pStats->maxBandwidth     = After.maxBandwidth;
+        pStats->readBytesPerSec  = static_cast<double>(After.readCounter - Before.readCounter) / IntervalSec;
+        pStats->writeBytesPerSec = static_cast<double>(After.writeCounter - Before.writeCounter) / IntervalSec;
+        pStats->utilizationPct   = (0 != After.maxBandwidth) ? 100.0 * (pStats->readBytesPerSec + pStats->writeBytesPerSec) / static_cast<double>(After.maxBandwidth) : 0.0;
+
+        if (0 == pStats->intervals)
+        {
+            pStats->shortAveragePct = pStats->utilizationPct;
+            pStats->longAveragePct  = pStats->utilizationPct;
+        }
+        else
+        {
+            pStats->shortAveragePct += TimeSeriesEwmaWeight(IntervalSec, MEM_BW_SHORT_WINDOW_SEC) * (pStats->utilizationPct - pStats->shortAveragePct);
+            pStats->longAveragePct += TimeSeriesEwmaWeight(IntervalSec, MEM_BW_LONG_WINDOW_SEC) * (pStats->utilizationPct - pStats->longAveragePct);
+        }
+        pStats->peakPct          = (pStats->utilizationPct > pStats->peakPct) ? pStats->utilizationPct : pStats->peakPct;
+        pStats->sustainedPeakPct = (pStats->longAveragePct > pStats->sustainedPeakPct) ? pStats->longAveragePct : pStats->sustainedPeakPct;
+        pStats->valid            = true;
+        pStats->hostTimestampNs  = BatchEndNs;
+        pStats->intervals++;
+
+        uint32_t Adapter = pMonitor->modules[i].adapterIndex;
+        if (Adapter < AGENT_MAX_ADAPTERS)
+        {
+            pMonitor->adapterIntervalSec[Adapter] = IntervalSec;
+            pMonitor->adapterReadBytesPerSec[Adapter] += pStats->readBytesPerSec;
+            pMonitor->adapterWriteBytesPerSec[Adapter] += pStats->writeBytesPerSec;
+        }
+
+        AppendSeries(pMonitor, &SeriesCount, pMonitor->modules[i].readSeriesId, pStats->readBytesPerSec);
+        AppendSeries(pMonitor, &SeriesCount, pMonitor->modules[i].writeSeriesId, pStats->writeBytesPerSec);
+        AppendSeries(pMonitor, &SeriesCount, pMonitor->modules[i].utilizationSeriesId, pStats->utilizationPct);
+    }
+
+    if (nullptr != pMonitor->pCache)
+    {
+        MemoryBandwidthCrossCheckPass(pMonitor);
+    }
+
+    {
+        std::lock_guard<std::mutex> Guard(pMonitor->statsLock);
+        memcpy(pMonitor->stats, pMonitor->working, Count * sizeof(MemoryBandwidth));
+        memcpy(pMonitor->crossCheck, pMonitor->workingCheck, pMonitor->adapterCount * sizeof(MemoryBandwidthCrossCheck));
+    }
+
+    if ((nullptr != pMonitor->pStore) && (0 != SeriesCount))
+    {
+        TimeSeriesStoreAppendBatch(pMonitor->pStore, pMonitor->seriesIds, pMonitor->seriesValues, SeriesCount, BatchEndNs);
+    }
+}
+
+static void MemoryBandwidthThread(MemoryBandwidthMonitor *pMonitor)
+{
+    auto NextTick = std::chrono::steady_clock::now();
+    while (!pMonitor->stopRequested.load(std::memory_order_relaxed))
+    {
+        MemoryBandwidthSampleOnce(pMonitor);
+
+        NextTick += std::chrono::milliseconds(pMonitor->periodMs);
+        auto Now = std::chrono::steady_clock::now();
+        if (NextTick < Now)
+        {
+            NextTick = Now;
+        }
+        std::this_thread::sleep_until(NextTick);
+    }
+}
+
+ctl_result_t MemoryBandwidthStart(MemoryBandwidthMonitor *pMonitor)
+{
+    if (nullptr == pMonitor)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (pMonitor->sampler.joinable())
+    {
+        return CTL_RESULT_ERROR_ALREADY_INITIALIZED;
+    }
+
+    // First batch only establishes the counter baseline
+    MemoryBandwidthSampleOnce(pMonitor);
+
+    pMonitor->stopRequested.store(false);
+    pMonitor->sampler = std::thread(MemoryBandwidthThread, pMonitor);
+    return CTL_RESULT_SUCCESS;
+}
+
+void MemoryBandwidthStop(MemoryBandwidthMonitor *pMonitor)
+{
+    if ((nullptr == pMonitor) || !pMonitor->sampler.joinable())
+    {
+        return;
+    }
+
+    pMonitor->stopRequested.store(true);
+    pMonitor->sampler.join();
+}
+
+uint32_t MemoryBandwidthRead(MemoryBandwidthMonitor *pMonitor, MemoryBandwidth *pEntries, uint32_t MaxEntries)
+{
+    if ((nullptr == pMonitor) || (nullptr == pEntries))
+    {
+        return 0;
+    }
+
+    uint32_t Count = (pMonitor->moduleCount < MaxEntries) ? pMonitor->moduleCount : MaxEntries;
+    std::lock_guard<std::mutex> Guard(pMonitor->statsLock);
+    memcpy(pEntries, pMonitor->stats, Count * sizeof(MemoryBandwidth));
+    return Count;
+}
+
+ctl_result_t MemoryBandwidthReadCrossCheck(MemoryBandwidthMonitor *pMonitor, uint32_t AdapterIndex, MemoryBandwidthCrossCheck *pCheck)
+{
+    if ((nullptr == pMonitor) || (nullptr == pCheck))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (AdapterIndex >= pMonitor->adapterCount)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pMonitor->statsLock);
+    *pCheck = pMonitor->crossCheck[AdapterIndex];
+    return CTL_RESULT_SUCCESS;
+}
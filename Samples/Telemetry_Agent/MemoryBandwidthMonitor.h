@@ -0,0 +1,151 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  MemoryBandwidthMonitor.h
+ * @brief Continuous VRAM bandwidth from the memory module counters.
+ *
+ * Every tick reads ctlMemoryGetBandwidth for all memory modules back to back
+ * and turns the readCounter/writeCounter deltas into bytes per second and a
+ * share of maxBandwidth. Each module keeps a short and a long exponentially
+ * weighted utilization, the peak of a single interval and the peak of the
+ * long average, which is the sustained utilization a job actually held.
+ *
+ * When a telemetry cache is given, the module totals of an adapter are also
+ * compared with the vramReadBandwidth/vramWriteBandwidth items of its
+ * latest ctlPowerTelemetryGet sample. Both sides are smoothed with the short
+ * time constant first, since the two are not read at the same instant.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "TelemetryCache.h"
+#include "TimeSeriesStore.h"
+
+#define MEM_BW_MAX_MODULES (AGENT_MAX_ADAPTERS * AGENT_MAX_MEM_MODULES)
+#define MEM_BW_DEFAULT_PERIOD_MS 100
+#define MEM_BW_SHORT_WINDOW_SEC 1.0
+#define MEM_BW_LONG_WINDOW_SEC 10.0
+#define MEM_BW_CROSSCHECK_TOLERANCE 0.25 ///< Relative difference counted as a disagreement
+#define MEM_BW_CROSSCHECK_MIN_BPS 1e6    ///< Below this both sources are treated as idle
+
+struct ClockCorrelator;
+
+/***************************************************************
+ * @brief Bandwidth of one memory module
+ ***************************************************************/
+struct MemoryBandwidth
+{
+    uint32_t adapterIndex;
+    uint32_t moduleIndex;
+    bool valid; ///< At least one interval has been measured
+    uint64_t maxBandwidth;
+    double readBytesPerSec;  ///< Last interval
+    double writeBytesPerSec; ///< Last interval
+    double utilizationPct;   ///< (read + write) / maxBandwidth over the last interval
+    double shortAveragePct;  ///< MEM_BW_SHORT_WINDOW_SEC time constant
+    double longAveragePct;   ///< MEM_BW_LONG_WINDOW_SEC time constant
+    double peakPct;          ///< Highest single interval
+    double sustainedPeakPct; ///< Highest long average
+    uint64_t intervals;
+    uint64_t hostTimestampNs;
+};
+
+/***************************************************************
+ * @brief Module counters against the power telemetry of one adapter
+ ***************************************************************/
+struct MemoryBandwidthCrossCheck
+{
+    uint32_t adapterIndex;
+    bool valid;
+    double moduleReadBytesPerSec; ///< Short averages of both sources
+    double moduleWriteBytesPerSec;
+    double telemetryReadBytesPerSec;
+    double telemetryWriteBytesPerSec;
+    double deviation;    ///< Larger relative difference of read and write, latest comparison
+    double maxDeviation; ///< Since start
+    uint64_t comparisons;
+    uint64_t disagreements; ///< Comparisons with deviation above MEM_BW_CROSSCHECK_TOLERANCE
+};
+
+struct TrackedMemoryModule
+{
+    uint32_t adapterIndex;
+    uint32_t moduleIndex;
+    ctl_mem_handle_t hMemory;
+    uint32_t readSeriesId;
+    uint32_t writeSeriesId;
+    uint32_t utilizationSeriesId;
+};
+
+struct MemoryBandwidthMonitor
+{
+    uint32_t moduleCount;
+    uint32_t adapterCount;
+    uint32_t periodMs;
+    TrackedMemoryModule modules[MEM_BW_MAX_MODULES];
+    const TelemetryCache *pCache; ///< Optional, source of the cross-check
+    TimeSeriesStore *pStore;      ///< Optional
+    ClockCorrelator *pClocks;     ///< Optional, fed the bandwidth timestamps
+
+    // Sampler private
+    ctl_mem_bandwidth_t batch[MEM_BW_MAX_MODULES];
+    ctl_result_t batchResult[MEM_BW_MAX_MODULES];
+    HostBracket batchBracket[MEM_BW_MAX_MODULES];
+    ctl_mem_bandwidth_t previous[MEM_BW_MAX_MODULES];
+    bool havePrevious[MEM_BW_MAX_MODULES];
+    MemoryBandwidth working[MEM_BW_MAX_MODULES];
+    MemoryBandwidthCrossCheck workingCheck[AGENT_MAX_ADAPTERS];
+    double adapterIntervalSec[AGENT_MAX_ADAPTERS];
+    double adapterReadBytesPerSec[AGENT_MAX_ADAPTERS];
+    double adapterWriteBytesPerSec[AGENT_MAX_ADAPTERS];
+    uint32_t seriesIds[3 * MEM_BW_MAX_MODULES];
+    double seriesValues[3 * MEM_BW_MAX_MODULES];
+    PublishedSnapshot telemetry;
+    uint64_t passes;
+
+    std::mutex statsLock;
+    MemoryBandwidth stats[MEM_BW_MAX_MODULES];
+    MemoryBandwidthCrossCheck crossCheck[AGENT_MAX_ADAPTERS];
+
+    std::atomic<bool> stopRequested;
+    std::thread sampler;
+};
+
+/***************************************************************
+ * @brief Collects the memory module handles of the given adapters
+ *
+ * pCache and pStore may be nullptr. With a store, read, write and
+ * utilization series are registered for every module.
+ ***************************************************************/
+ctl_result_t MemoryBandwidthInit(MemoryBandwidthMonitor *pMonitor, const AdapterTopology *pTopologies, uint32_t AdapterCount, uint32_t PeriodMs, const TelemetryCache *pCache,
+                                 TimeSeriesStore *pStore);
+
+/***************************************************************
+ * @brief Brackets every bandwidth call and feeds it to a clock correlator
+ *
+ * Must be called before MemoryBandwidthStart. nullptr detaches it.
+ ***************************************************************/
+void MemoryBandwidthAttachClockCorrelator(MemoryBandwidthMonitor *pMonitor, ClockCorrelator *pCorrelator);
+
+void MemoryBandwidthSampleOnce(MemoryBandwidthMonitor *pMonitor);
+ctl_result_t MemoryBandwidthStart(MemoryBandwidthMonitor *pMonitor);
+void MemoryBandwidthStop(MemoryBandwidthMonitor *pMonitor);
+
+/***************************************************************
+ * @brief Copies the state of every module, returns the entries written
+ ***************************************************************/
+uint32_t MemoryBandwidthRead(MemoryBandwidthMonitor *pMonitor, MemoryBandwidth *pEntries, uint32_t MaxEntries);
+
+ctl_result_t MemoryBandwidthReadCrossCheck(MemoryBandwidthMonitor *pMonitor, uint32_t AdapterIndex, MemoryBandwidthCrossCheck *pCheck);
@@ -0,0 +1,1473 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  MetricsExporter.cpp
+ * @brief OpenMetrics/Prometheus text exporter over the telemetry cache.
+ *
+ */
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <charconv>
+
+#include "MetricsExporter.h"
+
+#if defined(_WIN32)
+#define EXPORTER_INVALID_SOCKET INVALID_SOCKET
+#define ExporterCloseSocket closesocket
+#else
+#define EXPORTER_INVALID_SOCKET (-1)
+#define ExporterCloseSocket close
+#endif
+
+#define EXPORTER_POLL_INTERVAL_MS 200
+#define EXPORTER_RECV_TIMEOUT_MS 1000
+
+/***************************************************************
+ * @brief Bounded append-only writer over the exporter body buffer
+ *
+ * Sample lines are assembled from small primitives instead of printf so a
+ * scrape formats numbers with std::to_chars and never parses a format string.
+ ***************************************************************/
+struct MetricsWriter
+{
+    char *pBuffer;
+    size_t capacity;
+    size_t length;
+    bool overflow;
+};
+
+static void WriterRaw(MetricsWriter *pWriter, const char *pData, size_t Length)
+{
+    if (pWriter->overflow || (Length > pWriter->capacity - pWriter->length))
+    {
+        pWriter->overflow = true;
+        return;
+    }
+    memcpy(pWriter->pBuffer + pWriter->length, pData, Length);
+    pWriter->length += Length;
+}
+
+static void WriterString(MetricsWriter *pWriter, const char *pString)
+{
+    WriterRaw(pWriter, pString, strlen(pString));
+}
+
+static void WriterUInt(MetricsWriter *pWriter, uint64_t Value)
+{
+    char Digits[24];
+    std::to_chars_result Converted = std::to_chars(Digits, Digits + sizeof(Digits), Value);
+    WriterRaw(pWriter, Digits, static_cast<size_t>(Converted.ptr - Digits));
+}
+
+static void WriterInt(MetricsWriter *pWriter, int64_t Value)
+{
+    char Digits[24];
+    std::to_chars_result Converted = std::to_chars(Digits, Digits + sizeof(Digits), Value);
+    WriterRaw(pWriter, Digits, static_cast<size_t>(Converted.ptr - Digits));
+}
+
+static void WriterDouble(MetricsWriter *pWriter, double Value)
+{
+    // to_chars spells these nan and inf, the exposition format does not accept them
+    if (isnan(Value))
+    {
+        WriterRaw(pWriter, "NaN", 3);
+        return;
+    }
+    if (isinf(Value))
+    {
+        WriterRaw(pWriter, (Value > 0.0) ? "+Inf" : "-Inf", 4);
+        return;
+    }
+
+    char Digits[32];
+    std::to_chars_result Converted = std::to_chars(Digits, Digits + sizeof(Digits), Value);
+    WriterRaw(pWriter, Digits, static_cast<size_t>(Converted.ptr - Digits));
+}
+
+static void WriterFamily(MetricsWriter *pWriter, const char *pName, const char *pType, const char *pHelp)
+{
+    WriterRaw(pWriter, "# TYPE ", 7);
+    WriterString(pWriter, pName);
+    WriterRaw(pWriter, " ", 1);
+    WriterString(pWriter, pType);
+    WriterRaw(pWriter, "\n# HELP ", 8);
+    WriterString(pWriter, pName);
+    WriterRaw(pWriter, " ", 1);
+    WriterString(pWriter, pHelp);
+    WriterRaw(pWriter, "\n", 1);
+}
+
+/***************************************************************
+ * @brief Writes a label value escaped per the exposition format
+ ***************************************************************/
+static void WriterLabelValue(MetricsWriter *pWriter, const char *pValue)
+{
+    for (const char *p = pValue; ('\0' != *p) && !pWriter->overflow; p++)
+    {
+        if (('\\' == *p) || ('"' == *p))
+        {
+            char Escaped[2] = { '\\', *p };
+            WriterRaw(pWriter, Escaped, 2);
+        }
+        else if ('\n' == *p)
+        {
+            WriterRaw(pWriter, "\\n", 2);
+        }
+        else
+        {
+            WriterRaw(pWriter, p, 1);
+        }
+    }
+}
+
+/***************************************************************
+ * @brief Starts a sample line: name[suffix]{adapter="N"
+ ***************************************************************/
+static void WriterSampleBegin(MetricsWriter *pWriter, const char *pName, const char *pSuffix, uint32_t Adapter)
+{
+    WriterString(pWriter, pName);
+    WriterString(pWriter, pSuffix);
+    WriterRaw(pWriter, "{adapter=\"", 10);
+    WriterUInt(pWriter, Adapter);
+    WriterRaw(pWriter, "\"", 1);
+}
+
+static void WriterLabel(MetricsWriter *pWriter, const char *pKey, const char *pValue)
+{
+    WriterRaw(pWriter, ",", 1);
+    WriterString(pWriter, pKey);
+    WriterRaw(pWriter, "=\"", 2);
+    WriterString(pWriter, pValue);
+    WriterRaw(pWriter, "\"", 1);
+}
+
+static void WriterLabelUInt(MetricsWriter *pWriter, const char *pKey, uint64_t Value)
+{
+    WriterRaw(pWriter, ",", 1);
+    WriterString(pWriter, pKey);
+    WriterRaw(pWriter, "=\"", 2);
+    WriterUInt(pWriter, Value);
+    WriterRaw(pWriter, "\"", 1);
+}
+
+static void WriterSampleEnd(MetricsWriter *pWriter, double Value)
+{
+    WriterRaw(pWriter, "} ", 2);
+    WriterDouble(pWriter, Value);
+    WriterRaw(pWriter, "\n", 1);
+}
+
+static void WriterSampleEndUInt(MetricsWriter *pWriter, uint64_t Value)
+{
+    WriterRaw(pWriter, "} ", 2);
+    WriterUInt(pWriter, Value);
+    WriterRaw(pWriter, "\n", 1);
+}
+
+static void WriterSampleEndInt(MetricsWriter *pWriter, int64_t Value)
+{
+    WriterRaw(pWriter, "} ", 2);
+    WriterInt(pWriter, Value);
+    WriterRaw(pWriter, "\n", 1);
+}
+
+/***************************************************************
+ * @brief Telemetry items exported directly, one row per sample line.
+ *
+ * Consecutive rows sharing a family name are rendered under a single
+ * TYPE/HELP header. Counter sample lines get the _total suffix.
+ ***************************************************************/
+struct TelemetryFamilyRow
+{
+    const char *pName;
+    const char *pType;
+    const char *pHelp;
+    const char *pLabelKey; ///< Extra label or nullptr
+    const char *pLabelValue;
+    uint32_t itemId; ///< TelemetryItemId of the decoded value
+};
+
+static const TelemetryFamilyRow TelemetryFamilies[] = {
+    { "igcl_gpu_energy_joules", "counter", "Energy consumed by the GPU chip.", nullptr, nullptr, TELEMETRY_ITEM_GPU_ENERGY },
+    { "igcl_vram_energy_joules", "counter", "Energy consumed by the local memory modules.", nullptr, nullptr, TELEMETRY_ITEM_VRAM_ENERGY },
+    { "igcl_card_energy_joules", "counter", "Energy consumed by the whole card.", nullptr, nullptr, TELEMETRY_ITEM_CARD_ENERGY },
+    { "igcl_gpu_voltage_volts", "gauge", "Voltage feeding the GPU chip.", nullptr, nullptr, TELEMETRY_ITEM_GPU_VOLTAGE },
+    { "igcl_gpu_frequency_mhz", "gauge", "Current GPU chip frequency.", nullptr, nullptr, TELEMETRY_ITEM_GPU_FREQUENCY },
+    { "igcl_gpu_effective_frequency_mhz", "gauge", "Effective GPU frequency.", nullptr, nullptr, TELEMETRY_ITEM_GPU_EFFECTIVE_FREQUENCY },
+    { "igcl_gpu_temperature_celsius", "gauge", "Hottest GPU chip sensor.", nullptr, nullptr, TELEMETRY_ITEM_GPU_TEMPERATURE },
+    { "igcl_gpu_active_seconds", "counter", "Time the engines of a class were busy.", "engine", "all", TELEMETRY_ITEM_GLOBAL_ACTIVITY },
+    { "igcl_gpu_active_seconds", "counter", "", "engine", "render_compute", TELEMETRY_ITEM_RENDER_ACTIVITY },
+    { "igcl_gpu_active_seconds", "counter", "", "engine", "media", TELEMETRY_ITEM_MEDIA_ACTIVITY },
+    { "igcl_gpu_power_percent", "gauge", "GPU power as a percent of the default maximum.", nullptr, nullptr, TELEMETRY_ITEM_GPU_POWER_PERCENT },
+    { "igcl_gpu_temperature_percent", "gauge", "GPU temperature as a percent of the thermal margin.", nullptr, nullptr, TELEMETRY_ITEM_GPU_TEMPERATURE_PERCENT },
+    { "igcl_gpu_overvoltage_percent", "gauge", "Fraction of the maximum over-voltage increment applied.", nullptr, nullptr, TELEMETRY_ITEM_GPU_OVERVOLTAGE_PERCENT },
+    { "igcl_vram_voltage_volts", "gauge", "Voltage feeding the memory modules.", nullptr, nullptr, TELEMETRY_ITEM_VRAM_VOLTAGE },
+    { "igcl_vram_frequency_mhz", "gauge", "Raw memory clock frequency.", nullptr, nullptr, TELEMETRY_ITEM_VRAM_FREQUENCY },
+    { "igcl_vram_effective_frequency", "gauge", "Effective memory data rate.", nullptr, nullptr, TELEMETRY_ITEM_VRAM_EFFECTIVE_FREQUENCY },
+    { "igcl_vram_temperature_celsius", "gauge", "Hottest memory module sensor.", nullptr, nullptr, TELEMETRY_ITEM_VRAM_TEMPERATURE },
+    { "igcl_vram_traffic_bytes", "counter", "Memory traffic.", "direction", "read", TELEMETRY_ITEM_VRAM_READ_COUNTER },
+    { "igcl_vram_traffic_bytes", "counter", "", "direction", "write", TELEMETRY_ITEM_VRAM_WRITE_COUNTER },
+    { "igcl_vram_bandwidth_mbps", "gauge", "Memory bandwidth in megabytes per second.", "direction", "read", TELEMETRY_ITEM_VRAM_READ_BANDWIDTH },
+    { "igcl_vram_bandwidth_mbps", "gauge", "", "direction", "write", TELEMETRY_ITEM_VRAM_WRITE_BANDWIDTH },
+    { "igcl_vr_temperature_celsius", "gauge", "Voltage regulator temperature.", "rail", "gpu", TELEMETRY_ITEM_GPU_VR_TEMPERATURE },
+    { "igcl_vr_temperature_celsius", "gauge", "", "rail", "vram", TELEMETRY_ITEM_VRAM_VR_TEMPERATURE },
+    { "igcl_vr_temperature_celsius", "gauge", "", "rail", "sa", TELEMETRY_ITEM_SA_VR_TEMPERATURE },
+};
+
+#define TELEMETRY_FAMILY_COUNT (sizeof(TelemetryFamilies) / sizeof(TelemetryFamilies[0]))
+
+static const char *FreqDomainLabel(ctl_freq_domain_t Domain)
+{
+    switch (Domain)
+    {
+        case CTL_FREQ_DOMAIN_GPU:
+            return "gpu";
+        case CTL_FREQ_DOMAIN_MEMORY:
+            return "memory";
+        case CTL_FREQ_DOMAIN_MEDIA:
+            return "media";
+        default:
+            return "unknown";
+    }
+}
+
+static const char *TempSensorLabel(ctl_temp_sensors_t Sensor)
+{
+    switch (Sensor)
+    {
+        case CTL_TEMP_SENSORS_GLOBAL:
+            return "global";
+        case CTL_TEMP_SENSORS_GPU:
+            return "gpu";
+        case CTL_TEMP_SENSORS_MEMORY:
+            return "memory";
+        case CTL_TEMP_SENSORS_GLOBAL_MIN:
+            return "global_min";
+        case CTL_TEMP_SENSORS_GPU_MIN:
+            return "gpu_min";
+        case CTL_TEMP_SENSORS_MEMORY_MIN:
+            return "memory_min";
+        default:
+            return "unknown";
+    }
+}
+
+static bool TelemetryValid(const AdapterSnapshot *pSnapshot)
+{
+    return (0 != pSnapshot->sequence) && (CTL_RESULT_SUCCESS == pSnapshot->telemetryResult);
+}
+
+static void RenderTelemetryItems(MetricsWriter *pWriter, const MetricsExporter *pExporter, uint32_t AdapterCount)
+{
+    const char *pPreviousName = nullptr;
+    for (size_t Row = 0; Row < TELEMETRY_FAMILY_COUNT; Row++)
+    {
+        const TelemetryFamilyRow *pRow = &TelemetryFamilies[Row];
+        const char *pSuffix            = ('c' == pRow->pType[0]) ? "_total" : "";
+
+        if ((nullptr == pPreviousName) || (0 != strcmp(pPreviousName, pRow->pName)))
+        {
+            WriterFamily(pWriter, pRow->pName, pRow->pType, pRow->pHelp);
+            pPreviousName = pRow->pName;
+        }
+
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            const AdapterSnapshot *pSnapshot = &pExporter->snapshots[i].snapshot;
+            if (!TelemetryValid(pSnapshot))
+            {
+                continue;
+            }
+
+            if (0 == (pSnapshot->telemetryValidMask & TELEMETRY_ITEM_BIT(pRow->itemId)))
+            {
+                continue;
+            }
+
+            WriterSampleBegin(pWriter, pRow->pName, pSuffix, i);
+            if (nullptr != pRow->pLabelKey)
+            {
+                WriterLabel(pWriter, pRow->pLabelKey, pRow->pLabelValue);
+            }
+            WriterSampleEnd(pWriter, pSnapshot->telemetryValues[pRow->itemId]);
+        }
+    }
+
+    static const char *LimitReasons[] = { "power", "temperature", "current", "voltage", "utilization" };
+    WriterFamily(pWriter, "igcl_gpu_limited", "gauge", "1 when the GPU frequency is limited for the given reason.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const AdapterSnapshot *pSnapshot = &pExporter->snapshots[i].snapshot;
+        if (!TelemetryValid(pSnapshot))
+        {
+            continue;
+        }
+
+        const bool Limited[] = { pSnapshot->telemetry.gpuPowerLimited, pSnapshot->telemetry.gpuTemperatureLimited, pSnapshot->telemetry.gpuCurrentLimited, pSnapshot->telemetry.gpuVoltageLimited,
+                                 pSnapshot->telemetry.gpuUtilizationLimited };
+        for (uint32_t Reason = 0; Reason < 5; Reason++)
+        {
+            WriterSampleBegin(pWriter, "igcl_gpu_limited", "", i);
+            WriterLabel(pWriter, "reason", LimitReasons[Reason]);
+            WriterSampleEndUInt(pWriter, Limited[Reason] ? 1 : 0);
+        }
+    }
+}
+
+static void RenderComponents(MetricsWriter *pWriter, const MetricsExporter *pExporter, uint32_t AdapterCount)
+{
+    const TelemetryCache *pCache = pExporter->pCache;
+
+    WriterFamily(pWriter, "igcl_frequency_mhz", "gauge", "Frequency domain state.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const AdapterSnapshot *pSnapshot = &pExporter->snapshots[i].snapshot;
+        for (uint32_t d = 0; d < pCache->topology[i].freqDomainCount; d++)
+        {
+            if (0 == (pSnapshot->freqValidMask & CTL_BIT(d)))
+            {
+                continue;
+            }
+
+            const char *pDomain   = FreqDomainLabel(pCache->topology[i].freqDomainType[d]);
+            const char *Kinds[]   = { "actual", "request", "tdp", "efficient" };
+            const double Values[] = { pSnapshot->freqState[d].actual, pSnapshot->freqState[d].request, pSnapshot->freqState[d].tdp, pSnapshot->freqState[d].efficient };
+            for (uint32_t k = 0; k < 4; k++)
+            {
+                WriterSampleBegin(pWriter, "igcl_frequency_mhz", "", i);
+                WriterLabel(pWriter, "domain", pDomain);
+                WriterLabel(pWriter, "kind", Kinds[k]);
+                WriterSampleEnd(pWriter, Values[k]);
+            }
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_frequency_throttle_reasons", "gauge", "Bitmask of ctl_freq_throttle_reason_flag_t.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const AdapterSnapshot *pSnapshot = &pExporter->snapshots[i].snapshot;
+        for (uint32_t d = 0; d < pCache->topology[i].freqDomainCount; d++)
+        {
+            if (0 != (pSnapshot->freqValidMask & CTL_BIT(d)))
+            {
+                WriterSampleBegin(pWriter, "igcl_frequency_throttle_reasons", "", i);
+                WriterLabel(pWriter, "domain", FreqDomainLabel(pCache->topology[i].freqDomainType[d]));
+                WriterSampleEndUInt(pWriter, pSnapshot->freqState[d].throttleReasons);
+            }
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_frequency_throttle_seconds", "counter", "Time the frequency domain was limited by the hardware.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const AdapterSnapshot *pSnapshot = &pExporter->snapshots[i].snapshot;
+        for (uint32_t d = 0; d < pCache->topology[i].freqDomainCount; d++)
+        {
+            if (0 != (pSnapshot->throttleValidMask & CTL_BIT(d)))
+            {
+                WriterSampleBegin(pWriter, "igcl_frequency_throttle_seconds", "_total", i);
+                WriterLabel(pWriter, "domain", FreqDomainLabel(pCache->topology[i].freqDomainType[d]));
+                WriterSampleEnd(pWriter, pSnapshot->throttleTime[d].throttleTime / 1e6);
+            }
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_temperature_celsius", "gauge", "Temperature sensor reading.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const AdapterSnapshot *pSnapshot = &pExporter->snapshots[i].snapshot;
+        for (uint32_t s = 0; s < pCache->topology[i].tempSensorCount; s++)
+        {
+            if (0 != (pSnapshot->tempValidMask & CTL_BIT(s)))
+            {
+                WriterSampleBegin(pWriter, "igcl_temperature_celsius", "", i);
+                WriterLabel(pWriter, "sensor", TempSensorLabel(pCache->topology[i].tempSensorType[s]));
+                WriterSampleEnd(pWriter, pSnapshot->temperature[s]);
+            }
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_fan_speed_rpm", "gauge", "Fan speed.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const AdapterSnapshot *pSnapshot = &pExporter->snapshots[i].snapshot;
+        for (uint32_t f = 0; f < pCache->topology[i].fanCount; f++)
+        {
+            if (0 != (pSnapshot->fanValidMask & CTL_BIT(f)))
+            {
+                WriterSampleBegin(pWriter, "igcl_fan_speed_rpm", "", i);
+                WriterLabelUInt(pWriter, "fan", f);
+                WriterSampleEndInt(pWriter, pSnapshot->fanSpeedRpm[f]);
+            }
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_power_limit_watts", "gauge", "Configured power limits per power domain.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const AdapterSnapshot *pSnapshot = &pExporter->snapshots[i].snapshot;
+        for (uint32_t p = 0; p < pCache->topology[i].powerDomainCount; p++)
+        {
+            if (0 == (pSnapshot->powerLimitsValidMask & CTL_BIT(p)))
+            {
+                continue;
+            }
+
+            const ctl_power_limits_t *pLimits = &pSnapshot->powerLimits[p];
+            const char *Limits[]              = { "sustained", "burst", "peak_ac", "peak_dc" };
+            const bool Enabled[]              = { pLimits->sustainedPowerLimit.enabled, pLimits->burstPowerLimit.enabled, true, true };
+            const int32_t PowerMw[]           = { pLimits->sustainedPowerLimit.power, pLimits->burstPowerLimit.power, pLimits->peakPowerLimits.powerAC, pLimits->peakPowerLimits.powerDC };
+            for (uint32_t l = 0; l < 4; l++)
+            {
+                if (Enabled[l])
+                {
+                    WriterSampleBegin(pWriter, "igcl_power_limit_watts", "", i);
+                    WriterLabelUInt(pWriter, "domain", p);
+                    WriterLabel(pWriter, "limit", Limits[l]);
+                    WriterSampleEnd(pWriter, PowerMw[l] / 1000.0);
+                }
+            }
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_engine_active_seconds", "counter", "Time the engine group was busy.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const AdapterSnapshot *pSnapshot = &pExporter->snapshots[i].snapshot;
+        for (uint32_t e = 0; e < pCache->topology[i].engineGroupCount; e++)
+        {
+            if (0 != (pSnapshot->engineValidMask & CTL_BIT(e)))
+            {
+                WriterSampleBegin(pWriter, "igcl_engine_active_seconds", "_total", i);
+                WriterLabel(pWriter, "group", EngineGroupLabel(pCache->topology[i].engineGroupType[e]));
+                WriterLabelUInt(pWriter, "index", e);
+                WriterSampleEnd(pWriter, pSnapshot->engineStats[e].activeTime / 1e6);
+            }
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_engine_timestamp_seconds", "gauge", "Device timestamp matching igcl_engine_active_seconds.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const AdapterSnapshot *pSnapshot = &pExporter->snapshots[i].snapshot;
+        for (uint32_t e = 0; e < pCache->topology[i].engineGroupCount; e++)
+        {
+            if (0 != (pSnapshot->engineValidMask & CTL_BIT(e)))
+            {
+                WriterSampleBegin(pWriter, "igcl_engine_timestamp_seconds", "", i);
+                WriterLabel(pWriter, "group", EngineGroupLabel(pCache->topology[i].engineGroupType[e]));
+                WriterLabelUInt(pWriter, "index", e);
+                WriterSampleEnd(pWriter, pSnapshot->engineStats[e].timestamp / 1e6);
+            }
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_memory_bytes", "gauge", "Memory module state.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const AdapterSnapshot *pSnapshot = &pExporter->snapshots[i].snapshot;
+        for (uint32_t m = 0; m < pCache->topology[i].memModuleCount; m++)
+        {
+            if (0 != (pSnapshot->memValidMask & CTL_BIT(m)))
+            {
+                WriterSampleBegin(pWriter, "igcl_memory_bytes", "", i);
+                WriterLabelUInt(pWriter, "module", m);
+                WriterLabel(pWriter, "kind", "free");
+                WriterSampleEndUInt(pWriter, pSnapshot->memState[m].free);
+
+                WriterSampleBegin(pWriter, "igcl_memory_bytes", "", i);
+                WriterLabelUInt(pWriter, "module", m);
+                WriterLabel(pWriter, "kind", "size");
+                WriterSampleEndUInt(pWriter, pSnapshot->memState[m].size);
+            }
+        }
+    }
+}
+
+static void RenderDerived(MetricsWriter *pWriter, const MetricsExporter *pExporter, uint32_t AdapterCount)
+{
+    const TelemetryCache *pCache = pExporter->pCache;
+
+    static const char *PowerRails[] = { "gpu", "vram", "card" };
+    WriterFamily(pWriter, "igcl_power_watts", "gauge", "Average power over the last sample interval.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const DerivedMetrics *pDerived = &pExporter->snapshots[i].derived;
+        const uint32_t Flags[]         = { DERIVED_VALID_GPU_POWER, DERIVED_VALID_VRAM_POWER, DERIVED_VALID_CARD_POWER };
+        const double Watts[]           = { pDerived->gpuPowerW, pDerived->vramPowerW, pDerived->cardPowerW };
+        for (uint32_t r = 0; r < 3; r++)
+        {
+            if (0 != (pDerived->validMask & Flags[r]))
+            {
+                WriterSampleBegin(pWriter, "igcl_power_watts", "", i);
+                WriterLabel(pWriter, "rail", PowerRails[r]);
+                WriterSampleEnd(pWriter, Watts[r]);
+            }
+        }
+    }
+
+    static const char *ActivityKinds[] = { "global", "render_compute", "media" };
+    WriterFamily(pWriter, "igcl_utilization_percent", "gauge", "Average activity over the last sample interval.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const DerivedMetrics *pDerived = &pExporter->snapshots[i].derived;
+        const uint32_t Flags[]         = { DERIVED_VALID_GLOBAL_UTILIZATION, DERIVED_VALID_RENDER_UTILIZATION, DERIVED_VALID_MEDIA_UTILIZATION };
+        const double Percent[]         = { pDerived->globalUtilizationPct, pDerived->renderUtilizationPct, pDerived->mediaUtilizationPct };
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            if (0 != (pDerived->validMask & Flags[k]))
+            {
+                WriterSampleBegin(pWriter, "igcl_utilization_percent", "", i);
+                WriterLabel(pWriter, "kind", ActivityKinds[k]);
+                WriterSampleEnd(pWriter, Percent[k]);
+            }
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_engine_utilization_percent", "gauge", "Engine group activity over the last sample interval.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const DerivedMetrics *pDerived = &pExporter->snapshots[i].derived;
+        for (uint32_t e = 0; e < pCache->topology[i].engineGroupCount; e++)
+        {
+            if (0 != (pDerived->engineValidMask & CTL_BIT(e)))
+            {
+                WriterSampleBegin(pWriter, "igcl_engine_utilization_percent", "", i);
+                WriterLabel(pWriter, "group", EngineGroupLabel(pCache->topology[i].engineGroupType[e]));
+                WriterLabelUInt(pWriter, "index", e);
+                WriterSampleEnd(pWriter, pDerived->engineUtilizationPct[e]);
+            }
+        }
+    }
+
+    if (nullptr != pExporter->pEngineTracker)
+    {
+        static const char *Windows[] = { "1s", "10s" };
+        WriterFamily(pWriter, "igcl_engine_utilization_average_percent", "gauge", "Exponentially weighted engine group activity.");
+        for (uint32_t w = 0; w < 2; w++)
+        {
+            for (uint32_t n = 0; n < pExporter->engineCount; n++)
+            {
+                const EngineUtilization *pEngine = &pExporter->engines[n];
+                if (pEngine->valid && (pEngine->adapterIndex < AdapterCount))
+                {
+                    WriterSampleBegin(pWriter, "igcl_engine_utilization_average_percent", "", pEngine->adapterIndex);
+                    WriterLabel(pWriter, "group", EngineGroupLabel(pEngine->type));
+                    WriterLabelUInt(pWriter, "index", pEngine->groupIndex);
+                    WriterLabel(pWriter, "window", Windows[w]);
+                    WriterSampleEnd(pWriter, (0 == w) ? pEngine->shortAveragePct : pEngine->longAveragePct);
+                }
+            }
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_vram_throughput_bytes_per_second", "gauge", "VRAM traffic over the last sample interval.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const DerivedMetrics *pDerived = &pExporter->snapshots[i].derived;
+        if (0 != (pDerived->validMask & DERIVED_VALID_VRAM_READ))
+        {
+            WriterSampleBegin(pWriter, "igcl_vram_throughput_bytes_per_second", "", i);
+            WriterLabel(pWriter, "direction", "read");
+            WriterSampleEnd(pWriter, pDerived->vramReadBytesPerSec);
+        }
+        if (0 != (pDerived->validMask & DERIVED_VALID_VRAM_WRITE))
+        {
+            WriterSampleBegin(pWriter, "igcl_vram_throughput_bytes_per_second", "", i);
+            WriterLabel(pWriter, "direction", "write");
+            WriterSampleEnd(pWriter, pDerived->vramWriteBytesPerSec);
+        }
+    }
+
+    if (nullptr != pExporter->pMemoryMonitor)
+    {
+        WriterFamily(pWriter, "igcl_vram_module_throughput_bytes_per_second", "gauge", "Memory module traffic from its bandwidth counters.");
+        for (uint32_t n = 0; n < pExporter->memoryModuleCount; n++)
+        {
+            const MemoryBandwidth *pModule = &pExporter->memoryModules[n];
+            if (pModule->valid && (pModule->adapterIndex < AdapterCount))
+            {
+                const char *Directions[] = { "read", "write" };
+                const double Values[]    = { pModule->readBytesPerSec, pModule->writeBytesPerSec };
+                for (uint32_t d = 0; d < 2; d++)
+                {
+                    WriterSampleBegin(pWriter, "igcl_vram_module_throughput_bytes_per_second", "", pModule->adapterIndex);
+                    WriterLabelUInt(pWriter, "module", pModule->moduleIndex);
+                    WriterLabel(pWriter, "direction", Directions[d]);
+                    WriterSampleEnd(pWriter, Values[d]);
+                }
+            }
+        }
+
+        WriterFamily(pWriter, "igcl_vram_bandwidth_utilization_percent", "gauge", "Memory module traffic as a share of its maximum bandwidth.");
+        for (uint32_t n = 0; n < pExporter->memoryModuleCount; n++)
+        {
+            const MemoryBandwidth *pModule = &pExporter->memoryModules[n];
+            if (pModule->valid && (pModule->adapterIndex < AdapterCount))
+            {
+                const char *Kinds[]   = { "interval", "average_1s", "average_10s", "peak", "sustained_peak" };
+                const double Values[] = { pModule->utilizationPct, pModule->shortAveragePct, pModule->longAveragePct, pModule->peakPct, pModule->sustainedPeakPct };
+                for (uint32_t k = 0; k < 5; k++)
+                {
+                    WriterSampleBegin(pWriter, "igcl_vram_bandwidth_utilization_percent", "", pModule->adapterIndex);
+                    WriterLabelUInt(pWriter, "module", pModule->moduleIndex);
+                    WriterLabel(pWriter, "kind", Kinds[k]);
+                    WriterSampleEnd(pWriter, Values[k]);
+                }
+            }
+        }
+
+        WriterFamily(pWriter, "igcl_vram_bandwidth_crosscheck_deviation", "gauge", "Relative difference between module counters and power telemetry bandwidth.");
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            if (pExporter->memoryChecks[i].valid)
+            {
+                WriterSampleBegin(pWriter, "igcl_vram_bandwidth_crosscheck_deviation", "", i);
+                WriterSampleEnd(pWriter, pExporter->memoryChecks[i].deviation);
+            }
+        }
+
+        WriterFamily(pWriter, "igcl_vram_bandwidth_crosscheck_disagreements", "counter", "Comparisons where the two bandwidth sources differed by more than the tolerance.");
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            if (pExporter->memoryChecks[i].valid)
+            {
+                WriterSampleBegin(pWriter, "igcl_vram_bandwidth_crosscheck_disagreements", "_total", i);
+                WriterSampleEndUInt(pWriter, pExporter->memoryChecks[i].disagreements);
+            }
+        }
+    }
+}
+
+static void RenderPcieLinks(MetricsWriter *pWriter, const MetricsExporter *pExporter, uint32_t AdapterCount)
+{
+    const char *Names[] = { "igcl_pcie_link_generation", "igcl_pcie_link_width_lanes", "igcl_pcie_link_bandwidth_bytes_per_second" };
+    const char *Helps[] = { "PCIe link generation, current and the highest the link supports.", "PCIe link width, current and the widest the link supports.",
+                            "PCIe link bandwidth summed over all lanes, current and at the maximum speed." };
+    const char *Kinds[] = { "current", "max" };
+    for (uint32_t f = 0; f < 3; f++)
+    {
+        WriterFamily(pWriter, Names[f], "gauge", Helps[f]);
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            const PcieLinkStats *pLink      = &pExporter->pcieLinks[i];
+            const ctl_pci_speed_t *Speeds[] = { pLink->valid ? &pLink->speed : nullptr, &pLink->maxSpeed };
+            for (uint32_t k = 0; k < 2; k++)
+            {
+                // Unknown fields are reported as -1
+                int64_t Value = (nullptr == Speeds[k]) ? -1 : (0 == f) ? Speeds[k]->gen : (1 == f) ? Speeds[k]->width : Speeds[k]->maxBandwidth;
+                if (Value > 0)
+                {
+                    WriterSampleBegin(pWriter, Names[f], "", i);
+                    WriterLabel(pWriter, "kind", Kinds[k]);
+                    WriterSampleEndUInt(pWriter, static_cast<uint64_t>(Value));
+                }
+            }
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_pcie_link_degraded", "gauge", "1 while the link runs below its maximum generation or width.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        if (pExporter->pcieLinks[i].valid)
+        {
+            WriterSampleBegin(pWriter, "igcl_pcie_link_degraded", "", i);
+            WriterSampleEndUInt(pWriter, pExporter->pcieLinks[i].degraded ? 1 : 0);
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_pcie_link_downgrades", "counter", "Link changes to a lower generation or fewer lanes, by adapter activity at the change.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const PcieLinkStats *pLink = &pExporter->pcieLinks[i];
+        WriterSampleBegin(pWriter, "igcl_pcie_link_downgrades", "_total", i);
+        WriterLabel(pWriter, "activity", "busy");
+        WriterSampleEndUInt(pWriter, pLink->busyDowngrades);
+        WriterSampleBegin(pWriter, "igcl_pcie_link_downgrades", "_total", i);
+        WriterLabel(pWriter, "activity", "idle");
+        WriterSampleEndUInt(pWriter, pLink->downgrades - pLink->busyDowngrades);
+    }
+
+    WriterFamily(pWriter, "igcl_pcie_link_state_seconds", "counter", "Time spent at each link generation and width, by adapter activity.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const PcieLinkStats *pLink = &pExporter->pcieLinks[i];
+        for (uint32_t b = 0; b < 2; b++)
+        {
+            for (uint32_t g = 0; g < PCIE_LINK_MAX_GEN; g++)
+            {
+                for (uint32_t w = 0; w < PCIE_LINK_WIDTH_BUCKETS; w++)
+                {
+                    if (pLink->stateSec[b][g][w] > 0.0)
+                    {
+                        WriterSampleBegin(pWriter, "igcl_pcie_link_state_seconds", "_total", i);
+                        WriterLabelUInt(pWriter, "gen", g + 1);
+                        WriterLabelUInt(pWriter, "width", PcieLinkBucketWidth(w));
+                        WriterLabel(pWriter, "activity", (0 != b) ? "busy" : "idle");
+                        WriterSampleEnd(pWriter, pLink->stateSec[b][g][w]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void RenderEcc(MetricsWriter *pWriter, const MetricsExporter *pExporter, uint32_t AdapterCount)
+{
+    WriterFamily(pWriter, "igcl_ecc_enabled", "gauge", "1 when ECC is enabled, in force now and pending the next reboot.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const EccAdapterStats *pEcc = &pExporter->ecc[i];
+        if (pEcc->valid)
+        {
+            WriterSampleBegin(pWriter, "igcl_ecc_enabled", "", i);
+            WriterLabel(pWriter, "kind", "current");
+            WriterSampleEndUInt(pWriter, (CTL_ECC_STATE_ECC_ENABLED_STATE == pEcc->current) ? 1 : 0);
+            WriterSampleBegin(pWriter, "igcl_ecc_enabled", "", i);
+            WriterLabel(pWriter, "kind", "pending");
+            WriterSampleEndUInt(pWriter, (CTL_ECC_STATE_ECC_ENABLED_STATE == pEcc->pending) ? 1 : 0);
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_ecc_reboot_pending_seconds", "gauge", "How long the pending ECC state has differed from the current one, absent when they match.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        if (pExporter->ecc[i].valid && pExporter->ecc[i].rebootPending)
+        {
+            WriterSampleBegin(pWriter, "igcl_ecc_reboot_pending_seconds", "", i);
+            WriterSampleEnd(pWriter, pExporter->ecc[i].rebootPendingSec);
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_ecc_request_mismatch", "gauge", "1 when the pending ECC state is not the one last applied by the agent.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        if (pExporter->ecc[i].valid && (CTL_ECC_STATE_MAX != pExporter->ecc[i].requested))
+        {
+            WriterSampleBegin(pWriter, "igcl_ecc_request_mismatch", "", i);
+            WriterSampleEndUInt(pWriter, pExporter->ecc[i].requestMismatch ? 1 : 0);
+        }
+    }
+}
+
+static const double QuantilePercentiles[METRICS_EXPORTER_QUANTILE_COUNT] = { 50.0, 95.0, 99.0 };
+static const char *QuantileLabels[METRICS_EXPORTER_QUANTILE_COUNT]       = { "0.5", "0.95", "0.99" };
+
+static void RenderQuantiles(MetricsWriter *pWriter, const MetricsExporter *pExporter, uint32_t AdapterCount)
+{
+    static const char *Windows[] = { "run", "current" };
+    const TelemetryCache *pCache = pExporter->pCache;
+    WriterFamily(pWriter, "igcl_telemetry_quantile", "gauge", "Time weighted percentiles of a metric over the whole run and the current window.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        for (uint32_t w = 0; w < 2; w++)
+        {
+            for (uint32_t m = 0; m < TELEMETRY_HISTOGRAM_METRIC_COUNT; m++)
+            {
+                uint32_t Engine = m - TELEMETRY_HISTOGRAM_ENGINE_0;
+                if ((0 == pExporter->quantileTotals[i][w][m]) || ((m >= TELEMETRY_HISTOGRAM_ENGINE_0) && (Engine >= pCache->topology[i].engineGroupCount)))
+                {
+                    continue;
+                }
+                for (uint32_t q = 0; q < METRICS_EXPORTER_QUANTILE_COUNT; q++)
+                {
+                    WriterSampleBegin(pWriter, "igcl_telemetry_quantile", "", i);
+                    WriterLabel(pWriter, "metric", TelemetryHistogramMetricLabel(static_cast<TelemetryHistogramMetric>(m)));
+                    if (m >= TELEMETRY_HISTOGRAM_ENGINE_0)
+                    {
+                        WriterLabel(pWriter, "group", EngineGroupLabel(pCache->topology[i].engineGroupType[Engine]));
+                        WriterLabelUInt(pWriter, "index", Engine);
+                    }
+                    WriterLabel(pWriter, "window", Windows[w]);
+                    WriterLabel(pWriter, "quantile", QuantileLabels[q]);
+                    WriterSampleEnd(pWriter, pExporter->quantiles[i][w][m][q]);
+                }
+            }
+        }
+    }
+}
+
+static void RenderCollector(MetricsWriter *pWriter, const MetricsExporter *pExporter, uint32_t AdapterCount)
+{
+    const ParallelCollectorStats *pStats = &pExporter->collector;
+    WriterFamily(pWriter, "igcl_collector_pass_seconds", "gauge", "Duration of the latest pass of each adapter's worker.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        WriterSampleBegin(pWriter, "igcl_collector_pass_seconds", "", i);
+        WriterSampleEnd(pWriter, pStats->workers[i].lastPassSec);
+    }
+
+    WriterFamily(pWriter, "igcl_collector_missed_ticks", "counter", "Ticks a worker skipped because its previous pass overran.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        WriterSampleBegin(pWriter, "igcl_collector_missed_ticks", "_total", i);
+        WriterSampleEndUInt(pWriter, pStats->workers[i].missedTicks);
+    }
+
+    if (pStats->tickBarrier)
+    {
+        WriterFamily(pWriter, "igcl_collector_barrier_wait_seconds", "counter", "Time a worker waited at the tick barrier for the others.");
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            WriterSampleBegin(pWriter, "igcl_collector_barrier_wait_seconds", "_total", i);
+            WriterSampleEnd(pWriter, pStats->workers[i].barrierWaitSec);
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_collector_ticks", "counter", "Ticks sampled by every worker, and ticks some worker skipped.");
+    WriterString(pWriter, "igcl_collector_ticks_total{kind=\"complete\"} ");
+    WriterUInt(pWriter, pStats->ticks);
+    WriterString(pWriter, "\nigcl_collector_ticks_total{kind=\"partial\"} ");
+    WriterUInt(pWriter, pStats->partialTicks);
+    WriterRaw(pWriter, "\n", 1);
+
+    WriterFamily(pWriter, "igcl_collector_tick_skew_seconds", "gauge", "Spread of the sample times of the adapters within a tick, over the run.");
+    for (uint32_t q = 0; (0 != pStats->skewUs.totalCount) && (q < METRICS_EXPORTER_QUANTILE_COUNT); q++)
+    {
+        WriterString(pWriter, "igcl_collector_tick_skew_seconds{quantile=\"");
+        WriterString(pWriter, QuantileLabels[q]);
+        WriterString(pWriter, "\"} ");
+        WriterDouble(pWriter, QuantileHistogramPercentile(&pStats->skewUs, QuantilePercentiles[q]) / 1e6);
+        WriterRaw(pWriter, "\n", 1);
+    }
+    WriterString(pWriter, "igcl_collector_tick_skew_seconds{quantile=\"1\"} ");
+    WriterDouble(pWriter, pStats->maxSkewSec);
+    WriterRaw(pWriter, "\n", 1);
+}
+
+static void RenderPowerRails(MetricsWriter *pWriter, const MetricsExporter *pExporter, uint32_t AdapterCount)
+{
+    struct
+    {
+        const char *name;
+        const char *type;
+        const char *help;
+        const char *suffix;
+        double PowerRail::*pValue;
+        double PowerRail::*pRequired; ///< Left out while this field is 0, e.g. without a voltage
+    } Families[] = {
+        { "igcl_psu_rail_power_watts", "gauge", "Power drawn through each PSU input over the latest interval.", "", &PowerRail::powerW, nullptr },
+        { "igcl_psu_rail_voltage_volts", "gauge", "Voltage at each PSU input.", "", &PowerRail::voltageV, &PowerRail::voltageV },
+        { "igcl_psu_rail_current_amperes", "gauge", "Current through each PSU input.", "", &PowerRail::currentA, &PowerRail::voltageV },
+        { "igcl_psu_rail_load_percent", "gauge", "Power of each PSU input against the rating of its connector.", "", &PowerRail::loadPct, &PowerRail::ratedW },
+        { "igcl_psu_rail_energy_joules", "counter", "Energy drawn through each PSU input since it was discovered.", "_total", &PowerRail::energyJ, nullptr },
+    };
+    for (auto &Family : Families)
+    {
+        WriterFamily(pWriter, Family.name, Family.type, Family.help);
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            const PowerRailStats *pStats = &pExporter->rails[i];
+            for (uint32_t r = 0; r < CTL_PSU_COUNT; r++)
+            {
+                const PowerRail *pRail = &pStats->rails[r];
+                if ((0 == (pStats->railMask & CTL_BIT(r))) || ((nullptr != Family.pRequired) && (pRail->*Family.pRequired <= 0.0)))
+                {
+                    continue;
+                }
+                WriterSampleBegin(pWriter, Family.name, Family.suffix, i);
+                WriterLabelUInt(pWriter, "rail", r);
+                WriterLabel(pWriter, "type", PowerRailTypeLabel(pRail->type));
+                WriterSampleEnd(pWriter, pRail->*Family.pValue);
+            }
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_psu_input_power_watts", "gauge", "Sum of the power of all PSU inputs.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        if (0 != pExporter->rails[i].railPowerMask)
+        {
+            WriterSampleBegin(pWriter, "igcl_psu_input_power_watts", "", i);
+            WriterSampleEnd(pWriter, pExporter->rails[i].inputPowerW);
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_psu_card_power_mismatch_watts", "gauge", "PSU input power minus the power of totalCardEnergyCounter, latest interval and smoothed.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const PowerRailStats *pStats = &pExporter->rails[i];
+        if (0 != pStats->intervals)
+        {
+            WriterSampleBegin(pWriter, "igcl_psu_card_power_mismatch_watts", "", i);
+            WriterLabel(pWriter, "kind", "last");
+            WriterSampleEnd(pWriter, pStats->mismatchW);
+            WriterSampleBegin(pWriter, "igcl_psu_card_power_mismatch_watts", "", i);
+            WriterLabel(pWriter, "kind", "average");
+            WriterSampleEnd(pWriter, pStats->averageMismatchW);
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_psu_card_power_mismatch_percent", "gauge", "Latest mismatch relative to the card power.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        if (0 != pExporter->rails[i].intervals)
+        {
+            WriterSampleBegin(pWriter, "igcl_psu_card_power_mismatch_percent", "", i);
+            WriterSampleEnd(pWriter, pExporter->rails[i].mismatchPct);
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_psu_reconciled_intervals", "counter", "Intervals compared against the card power, by whether the mismatch was within the tolerance.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const PowerRailStats *pStats = &pExporter->rails[i];
+        if (0 != pStats->railMask)
+        {
+            WriterSampleBegin(pWriter, "igcl_psu_reconciled_intervals", "_total", i);
+            WriterLabel(pWriter, "result", "within");
+            WriterSampleEndUInt(pWriter, pStats->intervals - pStats->mismatches);
+            WriterSampleBegin(pWriter, "igcl_psu_reconciled_intervals", "_total", i);
+            WriterLabel(pWriter, "result", "beyond");
+            WriterSampleEndUInt(pWriter, pStats->mismatches);
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_telemetry_fan_speed_rpm", "gauge", "Fan speed reported by ctlPowerTelemetryGet.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        for (uint32_t f = 0; f < CTL_FAN_COUNT; f++)
+        {
+            if (0 != (pExporter->rails[i].fanMask & CTL_BIT(f)))
+            {
+                WriterSampleBegin(pWriter, "igcl_telemetry_fan_speed_rpm", "", i);
+                WriterLabelUInt(pWriter, "fan", f);
+                WriterSampleEndInt(pWriter, static_cast<int64_t>(pExporter->rails[i].fanSpeedRpm[f]));
+            }
+        }
+    }
+}
+
+static void RenderSnapshotDelta(MetricsWriter *pWriter, const MetricsExporter *pExporter, uint32_t AdapterCount)
+{
+    WriterFamily(pWriter, "igcl_snapshot_delta_passes", "counter", "Passes compared by the snapshot delta encoder.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        WriterSampleBegin(pWriter, "igcl_snapshot_delta_passes", "_total", i);
+        WriterSampleEndUInt(pWriter, pExporter->delta[i].passes);
+    }
+
+    WriterFamily(pWriter, "igcl_snapshot_delta_frames", "counter", "Frames emitted to the sinks, by type.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const SnapshotDeltaStats *pStats = &pExporter->delta[i];
+        WriterSampleBegin(pWriter, "igcl_snapshot_delta_frames", "_total", i);
+        WriterLabel(pWriter, "type", "delta");
+        WriterSampleEndUInt(pWriter, pStats->frames - pStats->keyframes);
+        WriterSampleBegin(pWriter, "igcl_snapshot_delta_frames", "_total", i);
+        WriterLabel(pWriter, "type", "key");
+        WriterSampleEndUInt(pWriter, pStats->keyframes);
+    }
+
+    WriterFamily(pWriter, "igcl_snapshot_delta_fields", "counter", "Valid fields sampled, and of those sent downstream.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const SnapshotDeltaStats *pStats = &pExporter->delta[i];
+        WriterSampleBegin(pWriter, "igcl_snapshot_delta_fields", "_total", i);
+        WriterLabel(pWriter, "kind", "sampled");
+        WriterSampleEndUInt(pWriter, pStats->fieldsSampled);
+        WriterSampleBegin(pWriter, "igcl_snapshot_delta_fields", "_total", i);
+        WriterLabel(pWriter, "kind", "sent");
+        WriterSampleEndUInt(pWriter, pStats->fieldsSent);
+    }
+
+    WriterFamily(pWriter, "igcl_snapshot_delta_wire_bytes", "counter", "Wire bytes emitted, and had every pass been sent in full.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const SnapshotDeltaStats *pStats = &pExporter->delta[i];
+        WriterSampleBegin(pWriter, "igcl_snapshot_delta_wire_bytes", "_total", i);
+        WriterLabel(pWriter, "kind", "sent");
+        WriterSampleEndUInt(pWriter, pStats->wireBytes);
+        WriterSampleBegin(pWriter, "igcl_snapshot_delta_wire_bytes", "_total", i);
+        WriterLabel(pWriter, "kind", "full");
+        WriterSampleEndUInt(pWriter, pStats->fullWireBytes);
+    }
+}
+
+static void RenderAll(MetricsWriter *pWriter, MetricsExporter *pExporter, uint32_t AdapterCount, uint64_t NowNs)
+{
+    const TelemetryCache *pCache = pExporter->pCache;
+
+    WriterFamily(pWriter, "igcl_adapter", "info", "Adapter identity.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const AdapterTopology *pTopology = &pCache->topology[i];
+        char DeviceId[8];
+        char Bdf[16];
+        snprintf(DeviceId, sizeof(DeviceId), "0x%04X", pTopology->pciDeviceId & 0xFFFF);
+        snprintf(Bdf, sizeof(Bdf), "%02x:%02x.%x", pTopology->bdf.bus, pTopology->bdf.device, pTopology->bdf.function);
+
+        WriterSampleBegin(pWriter, "igcl_adapter", "_info", i);
+        WriterRaw(pWriter, ",name=\"", 7);
+        WriterLabelValue(pWriter, pTopology->name);
+        WriterRaw(pWriter, "\"", 1);
+        WriterLabel(pWriter, "device_id", DeviceId);
+        WriterLabel(pWriter, "bdf", Bdf);
+        WriterSampleEndUInt(pWriter, 1);
+    }
+
+    WriterFamily(pWriter, "igcl_sample_age_seconds", "gauge", "Age of the cached snapshot at scrape time.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        const AdapterSnapshot *pSnapshot = &pExporter->snapshots[i].snapshot;
+        if (0 != pSnapshot->sequence)
+        {
+            WriterSampleBegin(pWriter, "igcl_sample_age_seconds", "", i);
+            WriterSampleEnd(pWriter, (NowNs > pSnapshot->hostTimestampNs) ? (NowNs - pSnapshot->hostTimestampNs) / 1e9 : 0.0);
+        }
+    }
+
+    WriterFamily(pWriter, "igcl_samples", "counter", "Sample passes completed by the telemetry cache.");
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        WriterSampleBegin(pWriter, "igcl_samples", "_total", i);
+        WriterSampleEndUInt(pWriter, pExporter->snapshots[i].snapshot.sequence);
+    }
+
+    if (nullptr != pCache->pRateController)
+    {
+        WriterFamily(pWriter, "igcl_sampling_interval_seconds", "gauge", "Interval chosen by the adaptive rate controller for the next pass.");
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            WriterSampleBegin(pWriter, "igcl_sampling_interval_seconds", "", i);
+            WriterSampleEnd(pWriter, pExporter->sampling[i].intervalMs / 1e3);
+        }
+
+        WriterFamily(pWriter, "igcl_sampling_rate_hertz", "gauge", "Smoothed rate of the sample passes actually made.");
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            WriterSampleBegin(pWriter, "igcl_sampling_rate_hertz", "", i);
+            WriterSampleEnd(pWriter, pExporter->sampling[i].effectiveRateHz);
+        }
+
+        WriterFamily(pWriter, "igcl_sampling_estimated_error_percent", "gauge", "Estimated RMS interpolation error of power and activity at the chosen interval.");
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            WriterSampleBegin(pWriter, "igcl_sampling_estimated_error_percent", "", i);
+            WriterSampleEnd(pWriter, pExporter->sampling[i].estimatedErrorPct);
+        }
+    }
+
+    RenderTelemetryItems(pWriter, pExporter, AdapterCount);
+    RenderComponents(pWriter, pExporter, AdapterCount);
+    RenderDerived(pWriter, pExporter, AdapterCount);
+    if (nullptr != pExporter->pPcieMonitor)
+    {
+        RenderPcieLinks(pWriter, pExporter, AdapterCount);
+    }
+    if (nullptr != pExporter->pEccMonitor)
+    {
+        RenderEcc(pWriter, pExporter, AdapterCount);
+    }
+    if (nullptr != pExporter->pHistograms)
+    {
+        RenderQuantiles(pWriter, pExporter, AdapterCount);
+    }
+    if (nullptr != pExporter->pCollector)
+    {
+        RenderCollector(pWriter, pExporter, AdapterCount);
+    }
+    if (nullptr != pExporter->pRails)
+    {
+        RenderPowerRails(pWriter, pExporter, AdapterCount);
+    }
+    if (nullptr != pExporter->pDelta)
+    {
+        RenderSnapshotDelta(pWriter, pExporter, AdapterCount);
+    }
+
+    WriterFamily(pWriter, "igcl_exporter_scrapes", "counter", "Scrapes served by this exporter.");
+    WriterString(pWriter, "igcl_exporter_scrapes_total ");
+    WriterUInt(pWriter, pExporter->scrapeCount);
+    WriterRaw(pWriter, "\n", 1);
+    WriterFamily(pWriter, "igcl_exporter_render_seconds", "gauge", "Render time of the previous scrape.");
+    WriterString(pWriter, "igcl_exporter_render_seconds ");
+    WriterDouble(pWriter, pExporter->lastRenderNs / 1e9);
+    WriterString(pWriter, "\n# EOF\n");
+}
+
+ctl_result_t MetricsExporterInit(MetricsExporter *pExporter, TelemetryCache *pCache, const char *pBindAddress, uint16_t Port)
+{
+    if ((nullptr == pExporter) || (nullptr == pCache))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pExporter->pCache = pCache;
+    snprintf(pExporter->bindAddress, sizeof(pExporter->bindAddress), "%s", (nullptr != pBindAddress) ? pBindAddress : METRICS_EXPORTER_DEFAULT_ADDRESS);
+    pExporter->port         = (0 != Port) ? Port : METRICS_EXPORTER_DEFAULT_PORT;
+    pExporter->bodyLength   = 0;
+    pExporter->scrapeCount  = 0;
+    pExporter->lastRenderNs = 0;
+    pExporter->listenSocket = EXPORTER_INVALID_SOCKET;
+    pExporter->stopRequested.store(false);
+    memset(pExporter->snapshots, 0, sizeof(pExporter->snapshots));
+    pExporter->pEngineTracker    = nullptr;
+    pExporter->engineCount       = 0;
+    pExporter->pMemoryMonitor    = nullptr;
+    pExporter->memoryModuleCount = 0;
+    pExporter->pPcieMonitor      = nullptr;
+    pExporter->pEccMonitor       = nullptr;
+    pExporter->pHistograms       = nullptr;
+    pExporter->pCollector        = nullptr;
+    pExporter->pRails            = nullptr;
+    pExporter->pDelta            = nullptr;
+
+    try
+    {
+        pExporter->body.resize(METRICS_EXPORTER_INITIAL_BUFFER);
+    }
+    catch (std::bad_alloc &)
+    {
+        return CTL_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+void MetricsExporterAttachEngineTracker(MetricsExporter *pExporter, EngineUtilizationTracker *pTracker)
+{
+    if (nullptr != pExporter)
+    {
+        pExporter->pEngineTracker = pTracker;
+        pExporter->engineCount    = 0;
+    }
+}
+
+void MetricsExporterAttachMemoryMonitor(MetricsExporter *pExporter, MemoryBandwidthMonitor *pMonitor)
+{
+    if (nullptr != pExporter)
+    {
+        pExporter->pMemoryMonitor    = pMonitor;
+        pExporter->memoryModuleCount = 0;
+    }
+}
+
+void MetricsExporterAttachPcieMonitor(MetricsExporter *pExporter, PcieLinkMonitor *pMonitor)
+{
+    if (nullptr != pExporter)
+    {
+        pExporter->pPcieMonitor = pMonitor;
+    }
+}
+
+void MetricsExporterAttachEccMonitor(MetricsExporter *pExporter, EccMonitor *pMonitor)
+{
+    if (nullptr != pExporter)
+    {
+        pExporter->pEccMonitor = pMonitor;
+    }
+}
+
+void MetricsExporterAttachHistograms(MetricsExporter *pExporter, TelemetryHistograms *pHistograms)
+{
+    if (nullptr != pExporter)
+    {
+        pExporter->pHistograms = pHistograms;
+    }
+}
+
+void MetricsExporterAttachCollector(MetricsExporter *pExporter, ParallelCollector *pCollector)
+{
+    if (nullptr != pExporter)
+    {
+        pExporter->pCollector = pCollector;
+    }
+}
+
+void MetricsExporterAttachPowerRails(MetricsExporter *pExporter, PowerRailDecoder *pRails)
+{
+    if (nullptr != pExporter)
+    {
+        pExporter->pRails = pRails;
+    }
+}
+
+void MetricsExporterAttachSnapshotDelta(MetricsExporter *pExporter, SnapshotDeltaEncoder *pDelta)
+{
+    if (nullptr != pExporter)
+    {
+        pExporter->pDelta = pDelta;
+    }
+}
+
+ctl_result_t MetricsExporterRender(MetricsExporter *pExporter)
+{
+    if (nullptr == pExporter)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    uint64_t StartNs      = AgentHostTimeNs();
+    uint32_t AdapterCount = pExporter->pCache->adapterCount;
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        TelemetryCacheRead(pExporter->pCache, i, &pExporter->snapshots[i]);
+    }
+    // After the reads, so no snapshot is stamped later than the scrape
+    uint64_t ReadNs = AgentHostTimeNs();
+    if (nullptr != pExporter->pEngineTracker)
+    {
+        pExporter->engineCount = EngineTrackerRead(pExporter->pEngineTracker, pExporter->engines, ENGINE_TRACKER_MAX_ENGINES);
+    }
+    if (nullptr != pExporter->pMemoryMonitor)
+    {
+        pExporter->memoryModuleCount = MemoryBandwidthRead(pExporter->pMemoryMonitor, pExporter->memoryModules, MEM_BW_MAX_MODULES);
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            MemoryBandwidthReadCrossCheck(pExporter->pMemoryMonitor, i, &pExporter->memoryChecks[i]);
+        }
+    }
+    if (nullptr != pExporter->pPcieMonitor)
+    {
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            PcieLinkRead(pExporter->pPcieMonitor, i, &pExporter->pcieLinks[i]);
+        }
+    }
+    if (nullptr != pExporter->pEccMonitor)
+    {
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            EccMonitorRead(pExporter->pEccMonitor, i, &pExporter->ecc[i]);
+        }
+    }
+    if (nullptr != pExporter->pHistograms)
+    {
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            for (uint32_t w = 0; w < 2; w++)
+            {
+                for (uint32_t m = 0; m < TELEMETRY_HISTOGRAM_METRIC_COUNT; m++)
+                {
+                    TelemetryHistogramsPercentiles(pExporter->pHistograms, i, 1 == w, static_cast<TelemetryHistogramMetric>(m), QuantilePercentiles, METRICS_EXPORTER_QUANTILE_COUNT,
+                                                   pExporter->quantiles[i][w][m], &pExporter->quantileTotals[i][w][m]);
+                }
+            }
+        }
+    }
+    if (nullptr != pExporter->pCollector)
+    {
+        ParallelCollectorRead(pExporter->pCollector, &pExporter->collector);
+    }
+    if (nullptr != pExporter->pRails)
+    {
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            PowerRailDecoderRead(pExporter->pRails, i, &pExporter->rails[i]);
+        }
+    }
+    if (nullptr != pExporter->pDelta)
+    {
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            SnapshotDeltaRead(pExporter->pDelta, i, &pExporter->delta[i]);
+        }
+    }
+    if (nullptr != pExporter->pCache->pRateController)
+    {
+        for (uint32_t i = 0; i < AdapterCount; i++)
+        {
+            AdaptiveSamplingRead(pExporter->pCache->pRateController, i, &pExporter->sampling[i]);
+        }
+    }
+
+    pExporter->scrapeCount++;
+    for (;;)
+    {
+        MetricsWriter Writer = { pExporter->body.data(), pExporter->body.size(), 0, false };
+        RenderAll(&Writer, pExporter, AdapterCount, ReadNs);
+        if (!Writer.overflow)
+        {
+            pExporter->bodyLength = Writer.length;
+            break;
+        }
+
+        // Grow once and keep the larger buffer for all following scrapes
+        try
+        {
+            pExporter->body.resize(pExporter->body.size() * 2);
+        }
+        catch (std::bad_alloc &)
+        {
+            pExporter->bodyLength = 0;
+            return CTL_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+        }
+    }
+
+    pExporter->lastRenderNs = AgentHostTimeNs() - StartNs;
+    return CTL_RESULT_SUCCESS;
+}
+
+static bool ExporterSendAll(exporter_socket_t Socket, const char *pData, size_t Length)
+{
+    while (Length > 0)
+    {
+        int Sent = send(Socket, pData, static_cast<int>(Length), 0);
+        if (Sent <= 0)
+        {
+            return false;
+        }
+        pData += Sent;
+        Length -= static_cast<size_t>(Sent);
+    }
+    return true;
+}
+
+static void ExporterServeClient(MetricsExporter *pExporter, exporter_socket_t Client)
+{
+#if defined(_WIN32)
+    DWORD Timeout = EXPORTER_RECV_TIMEOUT_MS;
+#else
+    struct timeval Timeout = { EXPORTER_RECV_TIMEOUT_MS / 1000, (EXPORTER_RECV_TIMEOUT_MS % 1000) * 1000 };
+#endif
+    setsockopt(Client, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>(&Timeout), sizeof(Timeout));
+
+    // Only the request line matters, read until the end of the headers or the buffer is full
+    size_t Received = 0;
+    while (Received < METRICS_EXPORTER_REQUEST_SIZE - 1)
+    {
+        int Count = recv(Client, pExporter->request + Received, static_cast<int>(METRICS_EXPORTER_REQUEST_SIZE - 1 - Received), 0);
+        if (Count <= 0)
+        {
+            break;
+        }
+        Received += static_cast<size_t>(Count);
+        pExporter->request[Received] = '\0';
+        if (nullptr != strstr(pExporter->request, "\r\n\r\n"))
+        {
+            break;
+        }
+    }
+    pExporter->request[Received] = '\0';
+
+    char Header[256];
+    bool IsMetrics = (0 == strncmp(pExporter->request, "GET /metrics ", 13)) || (0 == strncmp(pExporter->request, "GET /metrics?", 13));
+    if (IsMetrics && (CTL_RESULT_SUCCESS == MetricsExporterRender(pExporter)))
+    {
+        int HeaderLength = snprintf(Header, sizeof(Header),
+                                    "HTTP/1.1 200 OK\r\nContent-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\nContent-Length: %llu\r\nConnection: close\r\n\r\n",
+                                    static_cast<unsigned long long>(pExporter->bodyLength));
+        if (ExporterSendAll(Client, Header, static_cast<size_t>(HeaderLength)))
+        {
+            ExporterSendAll(Client, pExporter->body.data(), pExporter->bodyLength);
+        }
+    }
+    else
+    {
+        static const char NotFound[] = "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\nContent-Length: 10\r\nConnection: close\r\n\r\nNot Found\n";
+        ExporterSendAll(Client, NotFound, sizeof(NotFound) - 1);
+    }
+}
+
+static void ExporterThread(MetricsExporter *pExporter)
+{
+    while (!pExporter->stopRequested.load(std::memory_order_relaxed))
+    {
+        // Poll with a timeout so a stop request is noticed without closing the socket under accept()
+        fd_set ReadSet;
+        FD_ZERO(&ReadSet);
+        FD_SET(pExporter->listenSocket, &ReadSet);
+        struct timeval PollTimeout = { 0, EXPORTER_POLL_INTERVAL_MS * 1000 };
+
+        int Ready = select(static_cast<int>(pExporter->listenSocket + 1), &ReadSet, nullptr, nullptr, &PollTimeout);
+        if (Ready <= 0)
+        {
+            continue;
+        }
+
+        exporter_socket_t Client = accept(pExporter->listenSocket, nullptr, nullptr);
+        if (EXPORTER_INVALID_SOCKET == Client)
+        {
+            continue;
+        }
+
+        ExporterServeClient(pExporter, Client);
+        ExporterCloseSocket(Client);
+    }
+}
+
+ctl_result_t MetricsExporterStart(MetricsExporter *pExporter)
+{
+    if (nullptr == pExporter)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (pExporter->server.joinable())
+    {
+        return CTL_RESULT_ERROR_ALREADY_INITIALIZED;
+    }
+
+#if defined(_WIN32)
+    WSADATA WsaData;
+    if (0 != WSAStartup(MAKEWORD(2, 2), &WsaData))
+    {
+        return CTL_RESULT_ERROR_NOT_INITIALIZED;
+    }
+#endif
+
+    struct sockaddr_in Address = {};
+    Address.sin_family         = AF_INET;
+    Address.sin_port           = htons(pExporter->port);
+    if (1 != inet_pton(AF_INET, pExporter->bindAddress, &Address.sin_addr))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    pExporter->listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (EXPORTER_INVALID_SOCKET == pExporter->listenSocket)
+    {
+        return CTL_RESULT_ERROR_UNKNOWN;
+    }
+
+    int Reuse = 1;
+    setsockopt(pExporter->listenSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&Reuse), sizeof(Reuse));
+
+    if ((0 != bind(pExporter->listenSocket, reinterpret_cast<struct sockaddr *>(&Address), sizeof(Address))) || (0 != listen(pExporter->listenSocket, 16)))
+    {
+        ExporterCloseSocket(pExporter->listenSocket);
+        pExporter->listenSocket = EXPORTER_INVALID_SOCKET;
+        return CTL_RESULT_ERROR_UNKNOWN;
+    }
+
+    pExporter->stopRequested.store(false);
+    pExporter->server = std::thread(ExporterThread, pExporter);
+    return CTL_RESULT_SUCCESS;
+}
+
+void MetricsExporterStop(MetricsExporter *pExporter)
+{
+    if ((nullptr == pExporter) || !pExporter->server.joinable())
+    {
+        return;
+    }
+
+    pExporter->stopRequested.store(true);
+    pExporter->server.join();
+    ExporterCloseSocket(pExporter->listenSocket);
+    pExporter->listenSocket = EXPORTER_INVALID_SOCKET;
+
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+}
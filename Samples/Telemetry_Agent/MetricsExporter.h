@@ -0,0 +1,155 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  MetricsExporter.h
+ * @brief OpenMetrics/Prometheus text exporter over the telemetry cache.
+ *
+ * A scrape copies the cached snapshots and renders them into a buffer owned
+ * by the exporter. No driver call is issued and, once the buffer has reached
+ * its working size, no heap allocation happens on the scrape path.
+ *
+ */
+
+#pragma once
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#endif
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "TelemetryCache.h"
+#include "EngineUtilizationTracker.h"
+#include "MemoryBandwidthMonitor.h"
+#include "PcieLinkMonitor.h"
+#include "EccMonitor.h"
+#include "TelemetryHistograms.h"
+#include "ParallelCollector.h"
+#include "PowerRails.h"
+#include "SnapshotDelta.h"
+
+#if defined(_WIN32)
+typedef SOCKET exporter_socket_t;
+#else
+typedef int exporter_socket_t;
+#endif
+
+#define METRICS_EXPORTER_DEFAULT_PORT 9410
+#define METRICS_EXPORTER_DEFAULT_ADDRESS "127.0.0.1"
+#define METRICS_EXPORTER_INITIAL_BUFFER (64 * 1024)
+#define METRICS_EXPORTER_REQUEST_SIZE 4096
+#define METRICS_EXPORTER_QUANTILE_COUNT 3
+
+struct MetricsExporter
+{
+    TelemetryCache *pCache;
+    char bindAddress[64];
+    uint16_t port;
+
+    std::vector<char> body; ///< Rendered exposition, grows only when a render overflows it
+    size_t bodyLength;
+    char request[METRICS_EXPORTER_REQUEST_SIZE];
+    PublishedSnapshot snapshots[AGENT_MAX_ADAPTERS];
+    EngineUtilizationTracker *pEngineTracker; ///< Optional source of engine moving averages
+    uint32_t engineCount;
+    EngineUtilization engines[ENGINE_TRACKER_MAX_ENGINES];
+    MemoryBandwidthMonitor *pMemoryMonitor; ///< Optional source of per module VRAM bandwidth
+    uint32_t memoryModuleCount;
+    MemoryBandwidth memoryModules[MEM_BW_MAX_MODULES];
+    MemoryBandwidthCrossCheck memoryChecks[AGENT_MAX_ADAPTERS];
+    PcieLinkMonitor *pPcieMonitor; ///< Optional source of the PCIe link state
+    PcieLinkStats pcieLinks[AGENT_MAX_ADAPTERS];
+    EccMonitor *pEccMonitor; ///< Optional source of the ECC state
+    EccAdapterStats ecc[AGENT_MAX_ADAPTERS];
+    TelemetryHistograms *pHistograms; ///< Optional source of percentiles, [0] is the run and [1] the current window
+    double quantiles[AGENT_MAX_ADAPTERS][2][TELEMETRY_HISTOGRAM_METRIC_COUNT][METRICS_EXPORTER_QUANTILE_COUNT];
+    uint64_t quantileTotals[AGENT_MAX_ADAPTERS][2][TELEMETRY_HISTOGRAM_METRIC_COUNT];
+    ParallelCollector *pCollector; ///< Optional source of per worker timing and tick skew
+    ParallelCollectorStats collector;
+    PowerRailDecoder *pRails; ///< Optional source of the PSU rail breakdown
+    PowerRailStats rails[AGENT_MAX_ADAPTERS];
+    SnapshotDeltaEncoder *pDelta; ///< Optional source of the change only emission counts
+    SnapshotDeltaStats delta[AGENT_MAX_ADAPTERS];
+    AdaptiveSamplingStats sampling[AGENT_MAX_ADAPTERS]; ///< Read when the cache has a rate controller
+
+    uint64_t scrapeCount;
+    uint64_t lastRenderNs;
+
+    exporter_socket_t listenSocket;
+    std::atomic<bool> stopRequested;
+    std::thread server;
+};
+
+ctl_result_t MetricsExporterInit(MetricsExporter *pExporter, TelemetryCache *pCache, const char *pBindAddress, uint16_t Port);
+
+/***************************************************************
+ * @brief Renders the latest cached snapshots into pExporter->body
+ ***************************************************************/
+ctl_result_t MetricsExporterRender(MetricsExporter *pExporter);
+
+/***************************************************************
+ * @brief Adds the moving averages of a running tracker to every scrape
+ *
+ * Must be called before MetricsExporterStart. nullptr detaches it.
+ ***************************************************************/
+void MetricsExporterAttachEngineTracker(MetricsExporter *pExporter, EngineUtilizationTracker *pTracker);
+
+/***************************************************************
+ * @brief Adds the per module bandwidth of a running monitor to every scrape
+ *
+ * Must be called before MetricsExporterStart. nullptr detaches it.
+ ***************************************************************/
+void MetricsExporterAttachMemoryMonitor(MetricsExporter *pExporter, MemoryBandwidthMonitor *pMonitor);
+
+/***************************************************************
+ * @brief Adds the link state and its histogram from a running monitor to every scrape
+ *
+ * Must be called before MetricsExporterStart. nullptr detaches it.
+ ***************************************************************/
+void MetricsExporterAttachPcieMonitor(MetricsExporter *pExporter, PcieLinkMonitor *pMonitor);
+
+/***************************************************************
+ * @brief Adds the current and pending ECC state of a running monitor to every scrape
+ *
+ * Must be called before MetricsExporterStart. nullptr detaches it.
+ ***************************************************************/
+void MetricsExporterAttachEccMonitor(MetricsExporter *pExporter, EccMonitor *pMonitor);
+
+/***************************************************************
+ * @brief Adds the run and window percentiles of every metric to every scrape
+ *
+ * Must be called before MetricsExporterStart. nullptr detaches it.
+ ***************************************************************/
+void MetricsExporterAttachHistograms(MetricsExporter *pExporter, TelemetryHistograms *pHistograms);
+
+/***************************************************************
+ * @brief Adds the pass times and tick skew of a parallel collector to every scrape
+ *
+ * Must be called before MetricsExporterStart. nullptr detaches it.
+ ***************************************************************/
+void MetricsExporterAttachCollector(MetricsExporter *pExporter, ParallelCollector *pCollector);
+
+/***************************************************************
+ * @brief Adds the power of each PSU rail and its reconciliation to every scrape
+ *
+ * Must be called before MetricsExporterStart. nullptr detaches it.
+ ***************************************************************/
+void MetricsExporterAttachPowerRails(MetricsExporter *pExporter, PowerRailDecoder *pRails);
+
+/***************************************************************
+ * @brief Adds the fields and bytes of a snapshot delta encoder to every scrape
+ *
+ * Must be called before MetricsExporterStart. nullptr detaches it.
+ ***************************************************************/
+void MetricsExporterAttachSnapshotDelta(MetricsExporter *pExporter, SnapshotDeltaEncoder *pDelta);
+
+ctl_result_t MetricsExporterStart(MetricsExporter *pExporter);
+void MetricsExporterStop(MetricsExporter *pExporter);
@@ -0,0 +1,687 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  OverclockSearch.cpp
+ * @brief Undervolt and overclock search of one adapter through the V2 API.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "OverclockSearch.h"
+
+#define OVERCLOCK_SEARCH_JOURNAL_LINE 256
+#define OVERCLOCK_SEARCH_EPSILON 1e-6
+
+/***************************************************************
+ * @brief Energy and busy cycles polled while the workload runs
+ ***************************************************************/
+struct OverclockMeter
+{
+    ctl_device_adapter_handle_t hDevice;
+    std::atomic<bool> stopRequested;
+    bool lost; ///< A read returned CTL_RESULT_ERROR_DEVICE_LOST
+    double energyJ;
+    double busyMcycles;
+};
+
+static double *OverclockSettingValue(OverclockSetting *pSetting, OverclockSearchKnob Knob)
+{
+    return (OVERCLOCK_SEARCH_KNOB_OFFSET == Knob) ? &pSetting->offsetMhz : ((OVERCLOCK_SEARCH_KNOB_POWER_LIMIT == Knob) ? &pSetting->powerLimitW : &pSetting->temperatureLimitC);
+}
+
+static bool OverclockSearchKnobParse(const char *pLabel, OverclockSearchKnob *pKnob)
+{
+    for (uint32_t i = 0; i <= OVERCLOCK_SEARCH_KNOB_COUNT; i++)
+    {
+        if (0 == strcmp(pLabel, OverclockSearchKnobLabel(static_cast<OverclockSearchKnob>(i))))
+        {
+            *pKnob = static_cast<OverclockSearchKnob>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool OverclockTrialOutcomeParse(const char *pLabel, OverclockTrialOutcome *pOutcome)
+{
+    for (uint32_t i = 0; i < OVERCLOCK_TRIAL_COUNT; i++)
+    {
+        if (0 == strcmp(pLabel, OverclockTrialOutcomeLabel(static_cast<OverclockTrialOutcome>(i))))
+        {
+            *pOutcome = static_cast<OverclockTrialOutcome>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void OverclockMeterRun(OverclockMeter *pMeter)
+{
+    double LastEnergyJ   = -1.0;
+    double LastActiveSec = -1.0;
+    while (true)
+    {
+        // The last read follows the end of the workload, so the whole run is counted
+        bool Stopping                   = pMeter->stopRequested.load();
+        ctl_power_telemetry_t Telemetry = {};
+        Telemetry.Size                  = sizeof(ctl_power_telemetry_t);
+        Telemetry.Version               = 1;
+        ctl_result_t Result             = ctlPowerTelemetryGet(pMeter->hDevice, &Telemetry);
+        if (CTL_RESULT_ERROR_DEVICE_LOST == Result)
+        {
+            pMeter->lost = true;
+            return;
+        }
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            // Counters that went backwards wrapped, the interval is left out
+            if (Telemetry.gpuEnergyCounter.bSupported)
+            {
+                double EnergyJ = Telemetry.gpuEnergyCounter.value.datadouble;
+                pMeter->energyJ += ((LastEnergyJ >= 0.0) && (EnergyJ >= LastEnergyJ)) ? EnergyJ - LastEnergyJ : 0.0;
+                LastEnergyJ = EnergyJ;
+            }
+            if (Telemetry.globalActivityCounter.bSupported && Telemetry.gpuCurrentClockFrequency.bSupported)
+            {
+                double ActiveSec = Telemetry.globalActivityCounter.value.datadouble;
+                pMeter->busyMcycles += ((LastActiveSec >= 0.0) && (ActiveSec >= LastActiveSec)) ? (ActiveSec - LastActiveSec) * Telemetry.gpuCurrentClockFrequency.value.datadouble : 0.0;
+                LastActiveSec = ActiveSec;
+            }
+        }
+        if (Stopping)
+        {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(OVERCLOCK_SEARCH_POLL_MS));
+    }
+}
+
+/***************************************************************
+ * @brief Runs the workload once under the meter
+ *
+ * pTrial, which may be nullptr for a settling run, receives the length,
+ * work and energy of the run.
+ ***************************************************************/
+static ctl_result_t OverclockSearchRun(OverclockSearch *pSearch, double DurationSec, bool *pStable, OverclockTrial *pTrial)
+{
+    OverclockMeter Meter;
+    Meter.hDevice     = pSearch->hDevice;
+    Meter.lost        = false;
+    Meter.energyJ     = 0.0;
+    Meter.busyMcycles = 0.0;
+    Meter.stopRequested.store(false);
+    std::thread Poller(OverclockMeterRun, &Meter);
+
+    OverclockWorkloadResult Work = { false, 0.0 };
+    auto Start                   = std::chrono::steady_clock::now();
+    ctl_result_t Result          = pSearch->pfnWorkload(DurationSec, &Work, pSearch->pWorkloadContext);
+    double Seconds               = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    Meter.stopRequested.store(true);
+    Poller.join();
+
+    if (CTL_RESULT_ERROR_DEVICE_LOST == Result)
+    {
+        Work.stable = false;
+        Result      = CTL_RESULT_SUCCESS;
+    }
+    *pStable = Work.stable && !Meter.lost;
+    if (nullptr != pTrial)
+    {
+        pTrial->seconds = Seconds;
+        pTrial->appWork = (Work.work > 0.0);
+        pTrial->work    = pTrial->appWork ? Work.work : Meter.busyMcycles;
+        pTrial->energyJ = Meter.energyJ;
+    }
+    return Result;
+}
+
+static void OverclockTrialScore(OverclockTrial *pTrial)
+{
+    pTrial->throughput   = (pTrial->seconds > 0.0) ? pTrial->work / pTrial->seconds : 0.0;
+    pTrial->workPerJoule = (pTrial->energyJ > 0.0) ? pTrial->work / pTrial->energyJ : 0.0;
+}
+
+/***************************************************************
+ * @brief Writes what differs from the applied setting
+ *
+ * The offset curve is written read, modify, write against the live curve,
+ * so only points that move are sent.
+ ***************************************************************/
+static ctl_result_t OverclockSearchApply(OverclockSearch *pSearch, const OverclockSetting *pSetting)
+{
+    const OverclockSearchConfig *pConfig = &pSearch->config;
+    ctl_result_t Result                  = CTL_RESULT_SUCCESS;
+    if (pConfig->knobs[OVERCLOCK_SEARCH_KNOB_OFFSET])
+    {
+        VfCurve Target = pSearch->stockCurve;
+        double TopMhz  = pSearch->stockCurve.points[pSearch->stockCurve.pointCount - 1].Frequency;
+        for (uint32_t i = 0; i < Target.pointCount; i++)
+        {
+            double Mhz                 = Target.points[i].Frequency + pSetting->offsetMhz;
+            Mhz                        = (OVERCLOCK_SEARCH_MODE_UNDERVOLT == pConfig->mode) ? std::min(Mhz, TopMhz) : Mhz;
+            Target.points[i].Frequency = static_cast<uint32_t>(Mhz);
+        }
+
+        VfCurve Live;
+        VfCurveDiff Diff;
+        Result = VfCurveEnforce(&Target, &pSearch->vfLimits, nullptr);
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            Result = VfCurveRead(pSearch->hDevice, CTL_VF_CURVE_TYPE_LIVE, CTL_VF_CURVE_DETAILS_ELABORATE, &Live);
+        }
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            Result = VfCurveDiffCompute(&Live, &Target, &pSearch->vfLimits, &Diff);
+        }
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            Result = VfCurveApply(pSearch->hDevice, &Live, &Diff, &pSearch->vfLimits, &Live);
+        }
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            return Result;
+        }
+        pSearch->applied.offsetMhz = pSetting->offsetMhz;
+    }
+
+    if (pConfig->knobs[OVERCLOCK_SEARCH_KNOB_POWER_LIMIT] && (pSetting->powerLimitW != pSearch->applied.powerLimitW))
+    {
+        Result = ctlOverclockPowerLimitSetV2(pSearch->hDevice, pSetting->powerLimitW * pSearch->powerScale);
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            return Result;
+        }
+        pSearch->applied.powerLimitW = pSetting->powerLimitW;
+    }
+    if (pConfig->knobs[OVERCLOCK_SEARCH_KNOB_TEMPERATURE_LIMIT] && (pSetting->temperatureLimitC != pSearch->applied.temperatureLimitC))
+    {
+        Result = ctlOverclockTemperatureLimitSetV2(pSearch->hDevice, pSetting->temperatureLimitC);
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            return Result;
+        }
+        pSearch->applied.temperatureLimitC = pSetting->temperatureLimitC;
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+/***************************************************************
+ * @brief Resets the adapter and applies the checkpoint again
+ ***************************************************************/
+static ctl_result_t OverclockSearchRollback(OverclockSearch *pSearch)
+{
+    pSearch->stats.rollbacks++;
+    ctl_result_t Result = ctlOverclockResetToDefault(pSearch->hDevice);
+    pSearch->applied    = pSearch->stats.stock;
+    if ((CTL_RESULT_SUCCESS == Result) && pSearch->config.knobs[OVERCLOCK_SEARCH_KNOB_OFFSET])
+    {
+        Result = ctlOverclockWaiverSet(pSearch->hDevice);
+    }
+    if (CTL_RESULT_SUCCESS == Result)
+    {
+        Result = OverclockSearchApply(pSearch, &pSearch->stats.best);
+    }
+    return Result;
+}
+
+static void OverclockSearchJournalTrial(OverclockSearch *pSearch, const OverclockTrial *pTrial)
+{
+    if (nullptr == pSearch->pJournal)
+    {
+        return;
+    }
+    fprintf(pSearch->pJournal, "trial %u %s %.3f %.3f %.3f\n", pTrial->index, OverclockSearchKnobLabel(pTrial->knob), pTrial->setting.offsetMhz, pTrial->setting.powerLimitW,
+            pTrial->setting.temperatureLimitC);
+    fflush(pSearch->pJournal);
+}
+
+static void OverclockSearchJournalResult(OverclockSearch *pSearch, const OverclockTrial *pTrial)
+{
+    if (nullptr == pSearch->pJournal)
+    {
+        return;
+    }
+    fprintf(pSearch->pJournal, "result %u %s %.6f %.6f %.6f %s\n", pTrial->index, OverclockTrialOutcomeLabel(pTrial->outcome), pTrial->seconds, pTrial->work, pTrial->energyJ,
+            pTrial->appWork ? "app" : "busy");
+    fflush(pSearch->pJournal);
+}
+
+/***************************************************************
+ * @brief Narrows the bounds of the knob of a finished trial
+ *
+ * The checkpoint follows from the bounds: the offset at its low end, the
+ * limits at their high end.
+ ***************************************************************/
+static void OverclockSearchFold(OverclockSearch *pSearch, const OverclockTrial *pTrial)
+{
+    OverclockSearchStats *pStats = &pSearch->stats;
+    bool Passed                  = (OVERCLOCK_TRIAL_PASSED == pTrial->outcome);
+    pStats->unstableCount += (OVERCLOCK_TRIAL_UNSTABLE == pTrial->outcome) ? 1 : 0;
+    if (OVERCLOCK_SEARCH_KNOB_COUNT == pTrial->knob)
+    {
+        pSearch->baselineMeasured   = true;
+        pSearch->baselineFailed     = !Passed;
+        pStats->stockThroughput     = pTrial->throughput;
+        pStats->stockWorkPerJoule   = pTrial->workPerJoule;
+        pStats->referenceThroughput = pTrial->throughput;
+        pStats->bestThroughput      = pTrial->throughput;
+        pStats->bestWorkPerJoule    = pTrial->workPerJoule;
+        return;
+    }
+
+    OverclockSetting Setting = pTrial->setting;
+    double Value             = *OverclockSettingValue(&Setting, pTrial->knob);
+    bool RaisesLow           = (OVERCLOCK_SEARCH_KNOB_OFFSET == pTrial->knob) ? Passed : !Passed;
+    if (RaisesLow)
+    {
+        pStats->low[pTrial->knob] = std::max(pStats->low[pTrial->knob], Value);
+    }
+    else
+    {
+        pStats->high[pTrial->knob] = std::min(pStats->high[pTrial->knob], Value);
+    }
+    if (Passed)
+    {
+        pStats->referenceThroughput = (OVERCLOCK_SEARCH_KNOB_OFFSET == pTrial->knob) ? pTrial->throughput : pStats->referenceThroughput;
+        pStats->bestThroughput      = pTrial->throughput;
+        pStats->bestWorkPerJoule    = pTrial->workPerJoule;
+    }
+
+    pStats->best.offsetMhz         = pStats->low[OVERCLOCK_SEARCH_KNOB_OFFSET];
+    pStats->best.powerLimitW       = pStats->high[OVERCLOCK_SEARCH_KNOB_POWER_LIMIT];
+    pStats->best.temperatureLimitC = pStats->high[OVERCLOCK_SEARCH_KNOB_TEMPERATURE_LIMIT];
+}
+
+/***************************************************************
+ * @brief Knob and setting of the next trial, false once converged
+ *
+ * The midpoint is rounded down to a whole number of steps above the low
+ * bound and a knob is done once no step fits between its bounds.
+ ***************************************************************/
+static bool OverclockSearchNext(const OverclockSearch *pSearch, OverclockSearchKnob *pKnob, OverclockSetting *pSetting)
+{
+    const OverclockSearchStats *pStats = &pSearch->stats;
+    if (!pSearch->baselineMeasured)
+    {
+        *pKnob    = OVERCLOCK_SEARCH_KNOB_COUNT;
+        *pSetting = pStats->stock;
+        return true;
+    }
+    if (pSearch->baselineFailed || (pStats->trialCount >= OVERCLOCK_SEARCH_MAX_TRIALS))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < OVERCLOCK_SEARCH_KNOB_COUNT; i++)
+    {
+        double Low   = pStats->low[i];
+        double High  = pStats->high[i];
+        double Step  = pSearch->step[i];
+        double Value = Low + Step * std::max(1.0, floor((High - Low) / (2.0 * Step) + OVERCLOCK_SEARCH_EPSILON));
+        if (!pSearch->config.knobs[i] || (Value >= High - OVERCLOCK_SEARCH_EPSILON))
+        {
+            continue;
+        }
+        *pKnob                                   = static_cast<OverclockSearchKnob>(i);
+        *pSetting                                = pStats->best;
+        *OverclockSettingValue(pSetting, *pKnob) = Value;
+        return true;
+    }
+    return false;
+}
+
+/***************************************************************
+ * @brief Replays an existing journal into the stats
+ *
+ * A trial without a result counts as unstable, except that of the stock
+ * setting which is measured again.
+ ***************************************************************/
+static void OverclockSearchReplay(OverclockSearch *pSearch, FILE *pFile)
+{
+    OverclockSearchStats *pStats = &pSearch->stats;
+    char Line[OVERCLOCK_SEARCH_JOURNAL_LINE];
+    while ((nullptr != fgets(Line, sizeof(Line), pFile)) && (pStats->trialCount < OVERCLOCK_SEARCH_MAX_TRIALS))
+    {
+        OverclockTrial Trial = {};
+        char Label[32]       = {};
+        char Source[32]      = {};
+        uint32_t Index       = 0;
+        if (5 == sscanf(Line, "trial %u %31s %lf %lf %lf", &Index, Label, &Trial.setting.offsetMhz, &Trial.setting.powerLimitW, &Trial.setting.temperatureLimitC))
+        {
+            if (OverclockSearchKnobParse(Label, &Trial.knob))
+            {
+                Trial.index                          = pStats->trialCount;
+                Trial.outcome                        = OVERCLOCK_TRIAL_PENDING;
+                Trial.resumed                        = true;
+                pStats->trials[pStats->trialCount++] = Trial;
+            }
+        }
+        else if ((6 == sscanf(Line, "result %u %31s %lf %lf %lf %31s", &Index, Label, &Trial.seconds, &Trial.work, &Trial.energyJ, Source)) && (0 != pStats->trialCount))
+        {
+            // A result belongs to the trial written just before it
+            OverclockTrial *pTrial = &pStats->trials[pStats->trialCount - 1];
+            if ((OVERCLOCK_TRIAL_PENDING == pTrial->outcome) && OverclockTrialOutcomeParse(Label, &pTrial->outcome))
+            {
+                pTrial->seconds = Trial.seconds;
+                pTrial->work    = Trial.work;
+                pTrial->energyJ = Trial.energyJ;
+                pTrial->appWork = (0 == strcmp(Source, "app"));
+                OverclockTrialScore(pTrial);
+            }
+        }
+    }
+
+    // Trials are renumbered in the order they were run
+    uint32_t Kept = 0;
+    for (uint32_t i = 0; i < pStats->trialCount; i++)
+    {
+        OverclockTrial Trial = pStats->trials[i];
+        if ((OVERCLOCK_SEARCH_KNOB_COUNT == Trial.knob) && (OVERCLOCK_TRIAL_PENDING == Trial.outcome))
+        {
+            continue;
+        }
+        Trial.outcome          = (OVERCLOCK_TRIAL_PENDING == Trial.outcome) ? OVERCLOCK_TRIAL_UNSTABLE : Trial.outcome;
+        Trial.index            = Kept;
+        pStats->trials[Kept++] = Trial;
+        OverclockSearchFold(pSearch, &Trial);
+    }
+    pStats->trialCount   = Kept;
+    pStats->resumedCount = Kept;
+}
+
+void OverclockSearchDefaultConfig(OverclockSearchConfig *pConfig)
+{
+    if (nullptr == pConfig)
+    {
+        return;
+    }
+    pConfig->mode                 = OVERCLOCK_SEARCH_MODE_UNDERVOLT;
+    pConfig->trialSec             = 10.0;
+    pConfig->settleSec            = 2.0;
+    pConfig->maxOffsetMhz         = 300.0;
+    pConfig->offsetStepMhz        = 15.0;
+    pConfig->powerStepW           = 2.0;
+    pConfig->temperatureStepC     = 1.0;
+    pConfig->maxThroughputLossPct = 3.0;
+    pConfig->pJournalPath         = nullptr;
+    for (uint32_t i = 0; i < OVERCLOCK_SEARCH_KNOB_COUNT; i++)
+    {
+        pConfig->knobs[i] = true;
+    }
+}
+
+ctl_result_t OverclockSearchInit(OverclockSearch *pSearch, ctl_device_adapter_handle_t hDevice, const OverclockSearchConfig *pConfig, OverclockWorkload pfnWorkload,
+                                 void *pWorkloadContext)
+{
+    if ((nullptr == pSearch) || (nullptr == pfnWorkload))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (nullptr == hDevice)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+
+    OverclockSearchConfig Config = {};
+    OverclockSearchDefaultConfig(&Config);
+    Config = (nullptr != pConfig) ? *pConfig : Config;
+    if ((Config.mode >= OVERCLOCK_SEARCH_MODE_COUNT) || !(Config.trialSec > 0.0) || (Config.settleSec < 0.0) || !(Config.maxOffsetMhz >= 0.0) || !(Config.offsetStepMhz > 0.0) ||
+        !(Config.powerStepW > 0.0) || !(Config.temperatureStepC > 0.0) || !(Config.maxThroughputLossPct >= 0.0) || !(Config.maxThroughputLossPct < 100.0))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    memset(&pSearch->stats, 0, sizeof(pSearch->stats));
+    pSearch->config           = Config;
+    pSearch->hDevice          = hDevice;
+    pSearch->pfnWorkload      = pfnWorkload;
+    pSearch->pWorkloadContext = pWorkloadContext;
+    pSearch->baselineMeasured = false;
+    pSearch->baselineFailed   = false;
+    pSearch->pJournal         = nullptr;
+
+    ctl_oc_properties_t Properties = {};
+    Properties.Size                = sizeof(ctl_oc_properties_t);
+    Properties.Version             = 1;
+    ctl_result_t Result            = ctlOverclockGetProperties(hDevice, &Properties);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        return Result;
+    }
+    if (!Properties.bSupported || (Config.knobs[OVERCLOCK_SEARCH_KNOB_POWER_LIMIT] && !Properties.powerLimit.bSupported) ||
+        (Config.knobs[OVERCLOCK_SEARCH_KNOB_TEMPERATURE_LIMIT] && !Properties.temperatureLimit.bSupported))
+    {
+        return CTL_RESULT_ERROR_UNSUPPORTED_FEATURE;
+    }
+    if (Config.knobs[OVERCLOCK_SEARCH_KNOB_OFFSET])
+    {
+        Result = VfCurveLimitsFromProperties(&Properties, &pSearch->vfLimits);
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            return Result;
+        }
+    }
+
+    // Everything is searched from the defaults
+    Result = ctlOverclockResetToDefault(hDevice);
+    if ((CTL_RESULT_SUCCESS == Result) && Config.knobs[OVERCLOCK_SEARCH_KNOB_OFFSET])
+    {
+        Result = ctlOverclockWaiverSet(hDevice);
+    }
+    if ((CTL_RESULT_SUCCESS == Result) && Config.knobs[OVERCLOCK_SEARCH_KNOB_OFFSET])
+    {
+        Result = VfCurveRead(hDevice, CTL_VF_CURVE_TYPE_STOCK, CTL_VF_CURVE_DETAILS_ELABORATE, &pSearch->stockCurve);
+    }
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        return Result;
+    }
+
+    // Power limits may be reported in milliwatts, the search works in watts
+    OverclockSetting *pStock  = &pSearch->stats.stock;
+    pSearch->powerScale       = (CTL_UNITS_POWER_MILLIWATTS == Properties.powerLimit.units) ? 1000.0 : 1.0;
+    pStock->offsetMhz         = 0.0;
+    pStock->powerLimitW       = 0.0;
+    pStock->temperatureLimitC = 0.0;
+    if (Properties.powerLimit.bSupported && (CTL_RESULT_SUCCESS == ctlOverclockPowerLimitGetV2(hDevice, &pStock->powerLimitW)))
+    {
+        pStock->powerLimitW /= pSearch->powerScale;
+    }
+    if (Properties.temperatureLimit.bSupported)
+    {
+        ctlOverclockTemperatureLimitGetV2(hDevice, &pStock->temperatureLimitC);
+    }
+
+    // The offset passes at 0 and the limits at their stock values; a knob
+    // left out of the search is pinned there. A disabled power limit is
+    // searched down from the highest one.
+    double *pLow        = pSearch->stats.low;
+    double *pHigh       = pSearch->stats.high;
+    double FrequencyMhz = std::max(1.0, pSearch->vfLimits.frequencyStepMhz);
+    double TopMhz       = Config.knobs[OVERCLOCK_SEARCH_KNOB_OFFSET] ? pSearch->stockCurve.points[pSearch->stockCurve.pointCount - 1].Frequency : 0.0;
+    double MaxOffsetMhz = (OVERCLOCK_SEARCH_MODE_OVERCLOCK == Config.mode) ? std::min(Config.maxOffsetMhz, pSearch->vfLimits.frequencyMaxMhz - TopMhz) : Config.maxOffsetMhz;
+    double MaxPowerW    = (0.0 != pStock->powerLimitW) ? pStock->powerLimitW : Properties.powerLimit.max / pSearch->powerScale;
+
+    pSearch->step[OVERCLOCK_SEARCH_KNOB_OFFSET]            = FrequencyMhz * ceil(Config.offsetStepMhz / FrequencyMhz - OVERCLOCK_SEARCH_EPSILON);
+    pSearch->step[OVERCLOCK_SEARCH_KNOB_POWER_LIMIT]       = std::max(Config.powerStepW, Properties.powerLimit.step / pSearch->powerScale);
+    pSearch->step[OVERCLOCK_SEARCH_KNOB_TEMPERATURE_LIMIT] = std::max(Config.temperatureStepC, Properties.temperatureLimit.step);
+    pLow[OVERCLOCK_SEARCH_KNOB_OFFSET]                     = 0.0;
+    pHigh[OVERCLOCK_SEARCH_KNOB_OFFSET]                    = Config.knobs[OVERCLOCK_SEARCH_KNOB_OFFSET] ? std::max(0.0, MaxOffsetMhz) : 0.0;
+    pLow[OVERCLOCK_SEARCH_KNOB_POWER_LIMIT]                = Config.knobs[OVERCLOCK_SEARCH_KNOB_POWER_LIMIT] ? Properties.powerLimit.min / pSearch->powerScale : pStock->powerLimitW;
+    pHigh[OVERCLOCK_SEARCH_KNOB_POWER_LIMIT]               = Config.knobs[OVERCLOCK_SEARCH_KNOB_POWER_LIMIT] ? MaxPowerW : pStock->powerLimitW;
+    pLow[OVERCLOCK_SEARCH_KNOB_TEMPERATURE_LIMIT]          = Config.knobs[OVERCLOCK_SEARCH_KNOB_TEMPERATURE_LIMIT] ? Properties.temperatureLimit.min : pStock->temperatureLimitC;
+    pHigh[OVERCLOCK_SEARCH_KNOB_TEMPERATURE_LIMIT]         = pStock->temperatureLimitC;
+    pSearch->stats.best                                    = *pStock;
+    pSearch->stats.best.powerLimitW                        = pHigh[OVERCLOCK_SEARCH_KNOB_POWER_LIMIT];
+    pSearch->applied                                       = *pStock;
+
+    if (nullptr == Config.pJournalPath)
+    {
+        return CTL_RESULT_SUCCESS;
+    }
+    FILE *pFile = fopen(Config.pJournalPath, "r");
+    if (nullptr != pFile)
+    {
+        OverclockSearchReplay(pSearch, pFile);
+        fclose(pFile);
+    }
+    pSearch->pJournal = fopen(Config.pJournalPath, "a");
+    if (nullptr == pSearch->pJournal)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+    if (nullptr == pFile)
+    {
+        fprintf(pSearch->pJournal, "# overclock search, %s mode\n", OverclockSearchModeLabel(Config.mode));
+        fflush(pSearch->pJournal);
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+bool OverclockSearchDone(const OverclockSearch *pSearch)
+{
+    OverclockSearchKnob Knob;
+    OverclockSetting Setting;
+    return (nullptr == pSearch) || !OverclockSearchNext(pSearch, &Knob, &Setting);
+}
+
+ctl_result_t OverclockSearchStep(OverclockSearch *pSearch, OverclockTrial *pTrial)
+{
+    if ((nullptr == pSearch) || (nullptr == pTrial))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    OverclockSearchStats *pStats = &pSearch->stats;
+    OverclockTrial Trial         = {};
+    if (!OverclockSearchNext(pSearch, &Trial.knob, &Trial.setting))
+    {
+        return CTL_RESULT_ERROR_NOT_AVAILABLE;
+    }
+    Trial.index                          = pStats->trialCount;
+    Trial.outcome                        = OVERCLOCK_TRIAL_PENDING;
+    pStats->trials[pStats->trialCount++] = Trial;
+    OverclockSearchJournalTrial(pSearch, &Trial);
+
+    // A setting the device is lost over is as unstable as one it hangs on under load
+    bool Stable         = true;
+    ctl_result_t Result = OverclockSearchApply(pSearch, &Trial.setting);
+    if ((CTL_RESULT_SUCCESS == Result) && (pSearch->config.settleSec > 0.0))
+    {
+        Result = OverclockSearchRun(pSearch, pSearch->config.settleSec, &Stable, nullptr);
+    }
+    if ((CTL_RESULT_SUCCESS == Result) && Stable)
+    {
+        Result = OverclockSearchRun(pSearch, pSearch->config.trialSec, &Stable, &Trial);
+    }
+    if (CTL_RESULT_ERROR_DEVICE_LOST == Result)
+    {
+        Stable = false;
+        Result = CTL_RESULT_SUCCESS;
+    }
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        OverclockSearchApply(pSearch, &pStats->best);
+        return Result;
+    }
+
+    OverclockTrialScore(&Trial);
+    bool Limit    = (OVERCLOCK_SEARCH_KNOB_POWER_LIMIT == Trial.knob) || (OVERCLOCK_SEARCH_KNOB_TEMPERATURE_LIMIT == Trial.knob);
+    bool Slow     = Limit && (Trial.throughput < (1.0 - pSearch->config.maxThroughputLossPct / 100.0) * pStats->referenceThroughput);
+    Trial.outcome = !Stable ? OVERCLOCK_TRIAL_UNSTABLE : (Slow ? OVERCLOCK_TRIAL_SLOW : OVERCLOCK_TRIAL_PASSED);
+    OverclockSearchJournalResult(pSearch, &Trial);
+    pStats->trials[Trial.index] = Trial;
+    OverclockSearchFold(pSearch, &Trial);
+    *pTrial = Trial;
+
+    if (OVERCLOCK_TRIAL_UNSTABLE == Trial.outcome)
+    {
+        return OverclockSearchRollback(pSearch);
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t OverclockSearchFinish(OverclockSearch *pSearch, bool KeepBest)
+{
+    if (nullptr == pSearch)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    ctl_result_t Result = CTL_RESULT_SUCCESS;
+    if (KeepBest && pSearch->baselineMeasured && !pSearch->baselineFailed)
+    {
+        Result = OverclockSearchApply(pSearch, &pSearch->stats.best);
+    }
+    else
+    {
+        Result           = ctlOverclockResetToDefault(pSearch->hDevice);
+        pSearch->applied = pSearch->stats.stock;
+    }
+    if (nullptr != pSearch->pJournal)
+    {
+        fclose(pSearch->pJournal);
+        pSearch->pJournal = nullptr;
+    }
+    return Result;
+}
+
+const char *OverclockSearchKnobLabel(OverclockSearchKnob Knob)
+{
+    switch (Knob)
+    {
+        case OVERCLOCK_SEARCH_KNOB_OFFSET:
+            return "offset";
+        case OVERCLOCK_SEARCH_KNOB_POWER_LIMIT:
+            return "power";
+        case OVERCLOCK_SEARCH_KNOB_TEMPERATURE_LIMIT:
+            return "temperature";
+        case OVERCLOCK_SEARCH_KNOB_COUNT:
+            return "stock";
+        default:
+            return "unknown";
+    }
+}
+
+const char *OverclockSearchModeLabel(OverclockSearchMode Mode)
+{
+    switch (Mode)
+    {
+        case OVERCLOCK_SEARCH_MODE_UNDERVOLT:
+            return "undervolt";
+        case OVERCLOCK_SEARCH_MODE_OVERCLOCK:
+            return "overclock";
+        default:
+            return "unknown";
+    }
+}
+
+const char *OverclockTrialOutcomeLabel(OverclockTrialOutcome Outcome)
+{
+    switch (Outcome)
+    {
+        case OVERCLOCK_TRIAL_PENDING:
+            return "pending";
+        case OVERCLOCK_TRIAL_PASSED:
+            return "passed";
+        case OVERCLOCK_TRIAL_SLOW:
+            return "slow";
+        case OVERCLOCK_TRIAL_UNSTABLE:
+            return "unstable";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,210 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  OverclockSearch.h
+ * @brief Undervolt and overclock search of one adapter through the V2 API.
+ *
+ * Three knobs are searched one after the other, each by bisection between
+ * a value known to pass and one known or assumed to fail:
+ *
+ *   - the VF offset, added to every point of the stock curve. In undervolt
+ *     mode points are capped at the top frequency of the stock curve, so
+ *     the GPU reaches the same clock at a lower voltage; in overclock mode
+ *     the whole curve moves up. The highest offset that runs stable wins.
+ *   - the sustained power limit and
+ *   - the temperature limit, where the lowest value wins that keeps the
+ *     throughput within maxThroughputLossPct of the best offset, trading a
+ *     little speed for work per joule.
+ *
+ * A trial applies a setting, runs the caller's workload for settleSec and
+ * then for trialSec, and scores the measured run. Throughput is the work
+ * the workload reports per second or, when it reports none, busy GPU
+ * cycles per second; work per joule takes the GPU energy. Both are polled
+ * from ctlPowerTelemetryGet while the workload runs. A trial is unstable
+ * when the workload says so or the device is lost; the adapter is then
+ * reset with ctlOverclockResetToDefault and the last setting that passed,
+ * the checkpoint, is applied again.
+ *
+ * With a journal every trial is appended and flushed before its setting is
+ * written, and its result once measured. A search started on an existing
+ * journal replays it and goes on where it stopped; a trial without a
+ * result is taken as unstable, since the usual reason a run ends inside a
+ * trial is that the setting took the machine down. A journal belongs to
+ * one adapter and configuration.
+ *
+ * The search starts from the defaults and writes only what changes
+ * between trials. OverclockSearchFinish leaves the best setting applied
+ * or resets the adapter.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "igcl_api.h"
+#include "VfCurve.h"
+
+#define OVERCLOCK_SEARCH_MAX_TRIALS 64
+#define OVERCLOCK_SEARCH_POLL_MS 20 ///< Telemetry period while the workload runs
+
+enum OverclockSearchKnob
+{
+    OVERCLOCK_SEARCH_KNOB_OFFSET = 0,        ///< MHz added to the stock curve
+    OVERCLOCK_SEARCH_KNOB_POWER_LIMIT,       ///< Sustained power limit in watts
+    OVERCLOCK_SEARCH_KNOB_TEMPERATURE_LIMIT, ///< In degrees Celsius
+    OVERCLOCK_SEARCH_KNOB_COUNT              ///< Also marks the trial of the stock setting
+};
+
+enum OverclockSearchMode
+{
+    OVERCLOCK_SEARCH_MODE_UNDERVOLT = 0, ///< Same top clock at a lower voltage
+    OVERCLOCK_SEARCH_MODE_OVERCLOCK,     ///< Higher clock at the same voltage
+    OVERCLOCK_SEARCH_MODE_COUNT
+};
+
+enum OverclockTrialOutcome
+{
+    OVERCLOCK_TRIAL_PENDING = 0, ///< Journaled without a result
+    OVERCLOCK_TRIAL_PASSED,
+    OVERCLOCK_TRIAL_SLOW, ///< Stable but lost more throughput than allowed
+    OVERCLOCK_TRIAL_UNSTABLE,
+    OVERCLOCK_TRIAL_COUNT
+};
+
+struct OverclockSearchConfig
+{
+    OverclockSearchMode mode;
+    bool knobs[OVERCLOCK_SEARCH_KNOB_COUNT]; ///< Searched, in the order of the enum
+    double trialSec;                         ///< Measured run of the workload
+    double settleSec;                        ///< Unmeasured run after each change, 0 for none
+    double maxOffsetMhz;                     ///< Upper end of the offset search
+    double offsetStepMhz;                    ///< Resolution of the offset search, rounded up to a frequency step of the curve
+    double powerStepW;
+    double temperatureStepC;
+    double maxThroughputLossPct; ///< Lower limits may give up against the best offset
+    const char *pJournalPath;    ///< nullptr for none
+};
+
+struct OverclockSetting
+{
+    double offsetMhz;
+    double powerLimitW; ///< 0 while the limit is disabled
+    double temperatureLimitC;
+};
+
+struct OverclockWorkloadResult
+{
+    bool stable; ///< Ran to the end with correct results
+    double work; ///< Frames or iterations for example, 0 to be scored by busy GPU cycles
+};
+
+/***************************************************************
+ * @brief Runs the workload for about DurationSec
+ *
+ * Returns CTL_RESULT_ERROR_DEVICE_LOST for a lost device, which counts as
+ * unstable; any other failure stops the search.
+ ***************************************************************/
+typedef ctl_result_t (*OverclockWorkload)(double DurationSec, OverclockWorkloadResult *pResult, void *pContext);
+
+struct OverclockTrial
+{
+    uint32_t index;
+    OverclockSearchKnob knob; ///< OVERCLOCK_SEARCH_KNOB_COUNT for the stock setting
+    OverclockSetting setting;
+    OverclockTrialOutcome outcome;
+    double seconds; ///< Of the measured run
+    double work;    ///< Reported by the workload or busy Mcycles
+    double energyJ;
+    double throughput; ///< Work per second
+    double workPerJoule;
+    bool appWork; ///< Work was reported by the workload rather than counted in busy cycles
+    bool resumed; ///< Replayed from the journal
+};
+
+struct OverclockSearchStats
+{
+    OverclockSetting stock;
+    OverclockSetting best;                   ///< The checkpoint, last setting that passed
+    double low[OVERCLOCK_SEARCH_KNOB_COUNT]; ///< Bisection bounds; the offset passes at low, the limits at high
+    double high[OVERCLOCK_SEARCH_KNOB_COUNT];
+    double stockThroughput;
+    double stockWorkPerJoule;
+    double referenceThroughput; ///< At the best offset, the throughput loss of the limits is taken against it
+    double bestThroughput;
+    double bestWorkPerJoule;
+    uint32_t trialCount;
+    uint32_t resumedCount;
+    uint32_t unstableCount;
+    uint32_t rollbacks;
+    OverclockTrial trials[OVERCLOCK_SEARCH_MAX_TRIALS];
+};
+
+struct OverclockSearch
+{
+    OverclockSearchConfig config;
+    ctl_device_adapter_handle_t hDevice;
+    OverclockWorkload pfnWorkload;
+    void *pWorkloadContext;
+    double step[OVERCLOCK_SEARCH_KNOB_COUNT];
+    double powerScale; ///< Units of the power limit per watt
+    VfCurveLimits vfLimits;
+    VfCurve stockCurve; ///< Elaborate, the offset is applied to it
+    OverclockSetting applied;
+    bool baselineMeasured;
+    bool baselineFailed; ///< The stock setting is not stable, nothing to search from
+    FILE *pJournal;
+    OverclockSearchStats stats;
+};
+
+/***************************************************************
+ * @brief Fills the default configuration
+ *
+ * Undervolts by up to 300 MHz in steps of 15 MHz, then lowers the power
+ * limit in steps of 2 W and the temperature limit in steps of 1 C for at
+ * most 3 % of the throughput. Trials run 10 s after 2 s of settling.
+ ***************************************************************/
+void OverclockSearchDefaultConfig(OverclockSearchConfig *pConfig);
+
+/***************************************************************
+ * @brief Resets the adapter to its defaults and reads the stock setting
+ *
+ * Sets the overclock waiver, which writing a VF curve needs. pConfig may
+ * be nullptr for the defaults. Replays and reopens the journal.
+ ***************************************************************/
+ctl_result_t OverclockSearchInit(OverclockSearch *pSearch, ctl_device_adapter_handle_t hDevice, const OverclockSearchConfig *pConfig, OverclockWorkload pfnWorkload,
+                                 void *pWorkloadContext);
+
+/***************************************************************
+ * @brief True once every knob has converged or the stock setting failed
+ ***************************************************************/
+bool OverclockSearchDone(const OverclockSearch *pSearch);
+
+/***************************************************************
+ * @brief Runs the next trial, the stock setting first
+ *
+ * pTrial receives the trial, which is also kept in the stats. A failure
+ * of the workload or the driver returns its result after restoring the
+ * checkpoint; the trial stays pending in the journal.
+ ***************************************************************/
+ctl_result_t OverclockSearchStep(OverclockSearch *pSearch, OverclockTrial *pTrial);
+
+/***************************************************************
+ * @brief Applies the best setting, or resets the adapter, and closes the journal
+ ***************************************************************/
+ctl_result_t OverclockSearchFinish(OverclockSearch *pSearch, bool KeepBest);
+
+/***************************************************************
+ * @brief Lower case names used in the journal and reports
+ ***************************************************************/
+const char *OverclockSearchKnobLabel(OverclockSearchKnob Knob);
+const char *OverclockSearchModeLabel(OverclockSearchMode Mode);
+const char *OverclockTrialOutcomeLabel(OverclockTrialOutcome Outcome);
@@ -0,0 +1,261 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  OverclockSearch_App.cpp
+ * @brief Searches the VF offset, power limit and temperature limit of one
+ *        adapter against a workload and keeps the best setting. The
+ *        workload is a command run once per trial, or without one the load
+ *        already running on the GPU. Each trial is journaled with -j, so a
+ *        search the machine crashed out of resumes where it stopped.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "igcl_api.h"
+#include "OverclockSearch.h"
+
+#if defined(_WIN32)
+#define SearchOpenPipe _popen
+#define SearchClosePipe _pclose
+#else
+#define SearchOpenPipe popen
+#define SearchClosePipe pclose
+#endif
+
+#define SEARCH_COMMAND_LINE 1024
+
+/***************************************************************
+ * @brief Waits while the load already on the GPU runs
+ *
+ * Throughput is then counted in busy cycles and stability is whether the
+ * device stays up.
+ ***************************************************************/
+static ctl_result_t SearchRunningWorkload(double DurationSec, OverclockWorkloadResult *pResult, void *pContext)
+{
+    (void)pContext;
+    std::this_thread::sleep_for(std::chrono::duration<double>(DurationSec));
+    pResult->stable = true;
+    pResult->work   = 0.0;
+    return CTL_RESULT_SUCCESS;
+}
+
+/***************************************************************
+ * @brief Runs the command with the duration in seconds appended
+ *
+ * Exit status 0 is stable, and the last line of output that starts with a
+ * number is the work done.
+ ***************************************************************/
+static ctl_result_t SearchCommandWorkload(double DurationSec, OverclockWorkloadResult *pResult, void *pContext)
+{
+    char Line[SEARCH_COMMAND_LINE];
+    snprintf(Line, sizeof(Line), "%s %.3f", static_cast<const char *>(pContext), DurationSec);
+    FILE *pPipe = SearchOpenPipe(Line, "r");
+    if (nullptr == pPipe)
+    {
+        return CTL_RESULT_ERROR_UNKNOWN;
+    }
+
+    double Work = 0.0;
+    while (nullptr != fgets(Line, sizeof(Line), pPipe))
+    {
+        double Value = 0.0;
+        Work         = (1 == sscanf(Line, "%lf", &Value)) ? Value : Work;
+    }
+    pResult->stable = (0 == SearchClosePipe(pPipe));
+    pResult->work   = Work;
+    return CTL_RESULT_SUCCESS;
+}
+
+static void SearchPrintTrial(const OverclockTrial *pTrial)
+{
+    printf("  %2u %-11s %+5.0f MHz %6.1f W %4.0f C  %-8s", pTrial->index, OverclockSearchKnobLabel(pTrial->knob), pTrial->setting.offsetMhz, pTrial->setting.powerLimitW,
+           pTrial->setting.temperatureLimitC, OverclockTrialOutcomeLabel(pTrial->outcome));
+    if (OVERCLOCK_TRIAL_UNSTABLE != pTrial->outcome)
+    {
+        printf(" %10.1f %s/s %8.3f %s/J", pTrial->throughput, pTrial->appWork ? "work" : "Mcycles", pTrial->workPerJoule, pTrial->appWork ? "work" : "Mcycles");
+    }
+    printf("%s\n", pTrial->resumed ? "  (journal)" : "");
+}
+
+static void Usage()
+{
+    printf("Usage: Overclock_Search [-a adapter] [-m undervolt|overclock] [-k offset,power,temperature] [-t trial_sec] [-s settle_sec] [-o max_offset_mhz] [-l max_loss_pct]\n");
+    printf("                        [-j journal] [-c command] [-r]\n");
+    printf("  -a  adapter index, 0 by default\n");
+    printf("  -m  undervolt keeps the top clock at a lower voltage, overclock raises it; undervolt by default\n");
+    printf("  -k  knobs searched, in this order, all by default\n");
+    printf("  -t  measured run of each trial, 10 s by default\n");
+    printf("  -s  unmeasured run after each change, 2 s by default\n");
+    printf("  -o  highest VF offset tried, 300 MHz by default\n");
+    printf("  -l  throughput the power and temperature limits may give up, 3 %% by default\n");
+    printf("  -j  journal appended to after every step and resumed from\n");
+    printf("  -c  workload command, run with the trial length in seconds appended; exit status 0 is\n");
+    printf("      stable and the last line of output starting with a number its work. Without it\n");
+    printf("      the load already on the GPU is measured in busy cycles\n");
+    printf("  -r  reset the adapter at the end instead of keeping the best setting\n");
+}
+
+int main(int argc, char *argv[])
+{
+    OverclockSearchConfig Config = {};
+    OverclockSearchDefaultConfig(&Config);
+    uint32_t AdapterIndex = 0;
+    const char *pCommand  = nullptr;
+    bool KeepBest         = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "-a")) && (i + 1 < argc))
+        {
+            AdapterIndex = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if ((0 == strcmp(argv[i], "-m")) && (i + 1 < argc))
+        {
+            i++;
+            Config.mode = (0 == strcmp(argv[i], "overclock")) ? OVERCLOCK_SEARCH_MODE_OVERCLOCK : OVERCLOCK_SEARCH_MODE_UNDERVOLT;
+            if ((0 != strcmp(argv[i], "overclock")) && (0 != strcmp(argv[i], "undervolt")))
+            {
+                Usage();
+                return 1;
+            }
+        }
+        else if ((0 == strcmp(argv[i], "-k")) && (i + 1 < argc))
+        {
+            i++;
+            for (uint32_t Knob = 0; Knob < OVERCLOCK_SEARCH_KNOB_COUNT; Knob++)
+            {
+                Config.knobs[Knob] = (nullptr != strstr(argv[i], OverclockSearchKnobLabel(static_cast<OverclockSearchKnob>(Knob))));
+            }
+        }
+        else if ((0 == strcmp(argv[i], "-t")) && (i + 1 < argc))
+        {
+            Config.trialSec = strtod(argv[++i], nullptr);
+        }
+        else if ((0 == strcmp(argv[i], "-s")) && (i + 1 < argc))
+        {
+            Config.settleSec = strtod(argv[++i], nullptr);
+        }
+        else if ((0 == strcmp(argv[i], "-o")) && (i + 1 < argc))
+        {
+            Config.maxOffsetMhz = strtod(argv[++i], nullptr);
+        }
+        else if ((0 == strcmp(argv[i], "-l")) && (i + 1 < argc))
+        {
+            Config.maxThroughputLossPct = strtod(argv[++i], nullptr);
+        }
+        else if ((0 == strcmp(argv[i], "-j")) && (i + 1 < argc))
+        {
+            Config.pJournalPath = argv[++i];
+        }
+        else if ((0 == strcmp(argv[i], "-c")) && (i + 1 < argc))
+        {
+            pCommand = argv[++i];
+        }
+        else if (0 == strcmp(argv[i], "-r"))
+        {
+            KeepBest = false;
+        }
+        else
+        {
+            Usage();
+            return 1;
+        }
+    }
+
+    ctl_init_args_t CtlInitArgs = {};
+    ctl_api_handle_t hAPIHandle = nullptr;
+    CtlInitArgs.AppVersion      = CTL_MAKE_VERSION(CTL_IMPL_MAJOR_VERSION, CTL_IMPL_MINOR_VERSION);
+    CtlInitArgs.flags           = CTL_INIT_FLAG_USE_LEVEL_ZERO;
+    CtlInitArgs.Size            = sizeof(CtlInitArgs);
+
+    ctl_result_t Result = ctlInit(&CtlInitArgs, &hAPIHandle);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        printf("[ERROR] ctlInit returned failure code: 0x%X\n", Result);
+        return 1;
+    }
+
+    uint32_t AdapterCount = 0;
+    Result                = ctlEnumerateDevices(hAPIHandle, &AdapterCount, nullptr);
+    std::vector<ctl_device_adapter_handle_t> hAdapters(AdapterCount);
+    if ((CTL_RESULT_SUCCESS == Result) && (0 != AdapterCount))
+    {
+        Result = ctlEnumerateDevices(hAPIHandle, &AdapterCount, hAdapters.data());
+    }
+    if ((CTL_RESULT_SUCCESS != Result) || (AdapterIndex >= AdapterCount))
+    {
+        printf("[ERROR] No adapter %u, result 0x%X with %u adapters\n", AdapterIndex, Result, AdapterCount);
+        ctlClose(hAPIHandle);
+        return 1;
+    }
+
+    OverclockSearch *pSearch      = new OverclockSearch();
+    OverclockWorkload pfnWorkload = (nullptr != pCommand) ? SearchCommandWorkload : SearchRunningWorkload;
+    Result                        = OverclockSearchInit(pSearch, hAdapters[AdapterIndex], &Config, pfnWorkload, const_cast<char *>(pCommand));
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        printf("[ERROR] OverclockSearchInit returned failure code: 0x%X\n", Result);
+        delete pSearch;
+        ctlClose(hAPIHandle);
+        return 1;
+    }
+
+    const OverclockSearchStats *pStats = &pSearch->stats;
+    printf("Searching adapter %u, %s mode, trials of %.1f s after %.1f s of settling\n", AdapterIndex, OverclockSearchModeLabel(pSearch->config.mode), pSearch->config.trialSec,
+           pSearch->config.settleSec);
+    for (uint32_t i = 0; i < pStats->trialCount; i++)
+    {
+        SearchPrintTrial(&pStats->trials[i]);
+    }
+
+    while ((CTL_RESULT_SUCCESS == Result) && !OverclockSearchDone(pSearch))
+    {
+        OverclockTrial Trial = {};
+        Result               = OverclockSearchStep(pSearch, &Trial);
+        if (OVERCLOCK_TRIAL_PENDING != Trial.outcome)
+        {
+            SearchPrintTrial(&Trial);
+        }
+    }
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        printf("[ERROR] OverclockSearchStep returned failure code: 0x%X\n", Result);
+    }
+
+    const OverclockSetting *pStock = &pStats->stock;
+    const OverclockSetting *pBest  = &pStats->best;
+    bool Keep                      = KeepBest && (CTL_RESULT_SUCCESS == Result) && !pSearch->baselineFailed;
+    ctl_result_t FinishResult      = OverclockSearchFinish(pSearch, Keep);
+    if (pSearch->baselineFailed)
+    {
+        printf("[ERROR] The workload is not stable at the stock setting\n");
+    }
+    else if (pSearch->baselineMeasured)
+    {
+        printf("Stock  %+5.0f MHz %6.1f W %4.0f C  %10.1f /s %8.3f /J\n", pStock->offsetMhz, pStock->powerLimitW, pStock->temperatureLimitC, pStats->stockThroughput,
+               pStats->stockWorkPerJoule);
+        printf("Best   %+5.0f MHz %6.1f W %4.0f C  %10.1f /s %8.3f /J, throughput %+.1f %%, work per joule %+.1f %%\n", pBest->offsetMhz, pBest->powerLimitW, pBest->temperatureLimitC,
+               pStats->bestThroughput, pStats->bestWorkPerJoule, 100.0 * (pStats->bestThroughput / pStats->stockThroughput - 1.0),
+               100.0 * (pStats->bestWorkPerJoule / pStats->stockWorkPerJoule - 1.0));
+    }
+    printf("%u trials, %u from the journal, %u unstable, %u rollbacks; %s\n", pStats->trialCount, pStats->resumedCount, pStats->unstableCount, pStats->rollbacks,
+           (CTL_RESULT_SUCCESS != FinishResult) ? "restoring the adapter failed" : (Keep ? "best setting applied" : "adapter reset"));
+
+    bool Failed = (CTL_RESULT_SUCCESS != Result) || (CTL_RESULT_SUCCESS != FinishResult) || pSearch->baselineFailed;
+    delete pSearch;
+    ctlClose(hAPIHandle);
+    return Failed ? 1 : 0;
+}
@@ -0,0 +1,262 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  ParallelCollector.cpp
+ * @brief Samples every adapter of a TelemetryCache on its own thread.
+ *
+ */
+
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "ParallelCollector.h"
+
+static ctl_result_t ParallelPinCurrentThread(int32_t Cpu)
+{
+#if defined(_WIN32)
+    if ((Cpu < 0) || (Cpu >= 64))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+    return (0 != SetThreadAffinityMask(GetCurrentThread(), 1ull << Cpu)) ? CTL_RESULT_SUCCESS : CTL_RESULT_ERROR_OS_CALL;
+#elif defined(__linux__)
+    if ((Cpu < 0) || (Cpu >= CPU_SETSIZE))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+    cpu_set_t Set;
+    CPU_ZERO(&Set);
+    CPU_SET(Cpu, &Set);
+    return (0 == pthread_setaffinity_np(pthread_self(), sizeof(Set), &Set)) ? CTL_RESULT_SUCCESS : CTL_RESULT_ERROR_OS_CALL;
+#else
+    (void)Cpu;
+    return CTL_RESULT_ERROR_UNSUPPORTED_FEATURE;
+#endif
+}
+
+static void ParallelSleepUntilNs(uint64_t WakeupNs)
+{
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(WakeupNs))));
+}
+
+/***************************************************************
+ * @brief Waits for every worker, false once the collector is stopping
+ *
+ * *pTick becomes the latest tick any worker arrived with, so a worker
+ * that overran takes the others along to the tick it skipped to.
+ ***************************************************************/
+static bool ParallelBarrierWait(ParallelCollector *pCollector, uint64_t *pTick)
+{
+    std::unique_lock<std::mutex> Lock(pCollector->barrierLock);
+    if (pCollector->barrierStopped)
+    {
+        return false;
+    }
+
+    uint64_t Generation     = pCollector->barrierGeneration;
+    pCollector->barrierTick = (*pTick > pCollector->barrierTick) ? *pTick : pCollector->barrierTick;
+    if (++pCollector->barrierArrived == pCollector->workerCount)
+    {
+        pCollector->barrierGoTick  = pCollector->barrierTick;
+        pCollector->barrierTick    = 0;
+        pCollector->barrierArrived = 0;
+        pCollector->barrierGeneration++;
+        pCollector->barrierWake.notify_all();
+    }
+    else
+    {
+        pCollector->barrierWake.wait(Lock, [&] { return (Generation != pCollector->barrierGeneration) || pCollector->barrierStopped; });
+        if (Generation == pCollector->barrierGeneration)
+        {
+            return false;
+        }
+    }
+
+    // No later generation can complete before every worker, this one included, arrives again
+    *pTick = pCollector->barrierGoTick;
+    return true;
+}
+
+static void ParallelRecordPass(ParallelCollector *pCollector, uint32_t Adapter, uint64_t Tick, uint64_t SampleNs, double PassSec, double WaitSec, uint64_t Missed)
+{
+    std::lock_guard<std::mutex> Guard(pCollector->statsLock);
+    ParallelWorkerStats *pWorker = &pCollector->stats.workers[Adapter];
+    pWorker->passes++;
+    pWorker->missedTicks += Missed;
+    pWorker->lastPassSec = PassSec;
+    pWorker->maxPassSec  = (PassSec > pWorker->maxPassSec) ? PassSec : pWorker->maxPassSec;
+    pWorker->barrierWaitSec += WaitSec;
+
+    ParallelTickSlot *pSlot = &pCollector->tickSlots[Tick % PARALLEL_COLLECTOR_TICK_SLOTS];
+    if ((0 == pSlot->count) || (pSlot->tick != Tick))
+    {
+        // A tick still gathering in this slot was skipped by some worker
+        pCollector->stats.partialTicks += (0 != pSlot->count) ? 1 : 0;
+        pSlot->tick  = Tick;
+        pSlot->count = 0;
+        pSlot->minNs = SampleNs;
+        pSlot->maxNs = SampleNs;
+    }
+    pSlot->count++;
+    pSlot->minNs = (SampleNs < pSlot->minNs) ? SampleNs : pSlot->minNs;
+    pSlot->maxNs = (SampleNs > pSlot->maxNs) ? SampleNs : pSlot->maxNs;
+    if (pSlot->count < pCollector->workerCount)
+    {
+        return;
+    }
+
+    double SkewSec                = (pSlot->maxNs - pSlot->minNs) / 1e9;
+    pCollector->stats.lastSkewSec = SkewSec;
+    pCollector->stats.maxSkewSec  = (SkewSec > pCollector->stats.maxSkewSec) ? SkewSec : pCollector->stats.maxSkewSec;
+    pSlot->count                  = 0;
+    pCollector->stats.ticks++;
+    QuantileHistogramRecord(&pCollector->stats.skewUs, SkewSec * 1e6, 1);
+}
+
+static void ParallelWorkerThread(ParallelWorker *pWorker)
+{
+    ParallelCollector *pCollector = pWorker->pCollector;
+    TelemetryCache *pCache        = pWorker->pCache;
+    uint32_t Adapter              = pWorker->adapterIndex;
+    int32_t Cpu                   = pCollector->config.cpu[Adapter];
+    ctl_result_t PinResult        = (PARALLEL_COLLECTOR_UNPINNED != Cpu) ? ParallelPinCurrentThread(Cpu) : CTL_RESULT_SUCCESS;
+    {
+        std::lock_guard<std::mutex> Guard(pCollector->statsLock);
+        pCollector->stats.workers[Adapter].pinResult = PinResult;
+    }
+
+    // Tick 0 is the pass TelemetryCacheStart primed the cache with
+    uint64_t PeriodNs = pCache->periodMs * 1000000ull;
+    uint64_t Tick     = 1;
+    while (!pCache->stopRequested.load(std::memory_order_relaxed))
+    {
+        ParallelSleepUntilNs(pCollector->epochNs + Tick * PeriodNs);
+        double WaitSec = 0.0;
+        if (pCollector->config.tickBarrier)
+        {
+            uint64_t ArriveNs = AgentHostTimeNs();
+            if (!ParallelBarrierWait(pCollector, &Tick))
+            {
+                break;
+            }
+            WaitSec = (AgentHostTimeNs() - ArriveNs) / 1e9;
+        }
+
+        uint64_t StartNs = AgentHostTimeNs();
+        TelemetryCacheSampleAdapter(pCache, Adapter, &pWorker->scratch);
+        uint64_t EndNs = AgentHostTimeNs();
+
+        // Next tick of the grid after this pass, skipping the ones it overran
+        uint64_t NextTick = (EndNs - pCollector->epochNs) / PeriodNs + 1;
+        NextTick          = (NextTick > Tick) ? NextTick : Tick + 1;
+        ParallelRecordPass(pCollector, Adapter, Tick, pWorker->scratch.snapshot.hostTimestampNs, (EndNs - StartNs) / 1e9, WaitSec, NextTick - Tick - 1);
+        Tick = NextTick;
+    }
+}
+
+void ParallelCollectorDefaultConfig(ParallelCollectorConfig *pConfig)
+{
+    pConfig->tickBarrier = false;
+    for (uint32_t i = 0; i < AGENT_MAX_ADAPTERS; i++)
+    {
+        pConfig->cpu[i] = PARALLEL_COLLECTOR_UNPINNED;
+    }
+}
+
+ctl_result_t ParallelCollectorInit(ParallelCollector *pCollector, const ParallelCollectorConfig *pConfig)
+{
+    if (nullptr == pCollector)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    if (nullptr != pConfig)
+    {
+        pCollector->config = *pConfig;
+    }
+    else
+    {
+        ParallelCollectorDefaultConfig(&pCollector->config);
+    }
+    pCollector->workerCount = 0;
+    pCollector->epochNs     = 0;
+
+    std::lock_guard<std::mutex> Guard(pCollector->statsLock);
+    memset(pCollector->tickSlots, 0, sizeof(pCollector->tickSlots));
+    pCollector->stats.workerCount  = 0;
+    pCollector->stats.tickBarrier  = pCollector->config.tickBarrier;
+    pCollector->stats.ticks        = 0;
+    pCollector->stats.partialTicks = 0;
+    pCollector->stats.lastSkewSec  = 0.0;
+    pCollector->stats.maxSkewSec   = 0.0;
+    QuantileHistogramInit(&pCollector->stats.skewUs, 1.0);
+    for (uint32_t i = 0; i < AGENT_MAX_ADAPTERS; i++)
+    {
+        ParallelWorkerStats *pWorker = &pCollector->stats.workers[i];
+        memset(pWorker, 0, sizeof(ParallelWorkerStats));
+        pWorker->adapterIndex = i;
+        pWorker->cpu          = pCollector->config.cpu[i];
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+void ParallelCollectorRun(ParallelCollector *pCollector, TelemetryCache *pCache)
+{
+    pCollector->workerCount = pCache->adapterCount;
+    pCollector->epochNs     = AgentHostTimeNs();
+    {
+        std::lock_guard<std::mutex> Guard(pCollector->barrierLock);
+        pCollector->barrierArrived    = 0;
+        pCollector->barrierGeneration = 0;
+        pCollector->barrierTick       = 0;
+        pCollector->barrierGoTick     = 0;
+        pCollector->barrierStopped    = false;
+    }
+    {
+        std::lock_guard<std::mutex> Guard(pCollector->statsLock);
+        pCollector->stats.workerCount = pCollector->workerCount;
+    }
+
+    for (uint32_t i = 0; i < pCollector->workerCount; i++)
+    {
+        ParallelWorker *pWorker = &pCollector->workers[i];
+        pWorker->pCollector     = pCollector;
+        pWorker->pCache         = pCache;
+        pWorker->adapterIndex   = i;
+        pWorker->thread         = std::thread(ParallelWorkerThread, pWorker);
+    }
+
+    while (!pCache->stopRequested.load(std::memory_order_relaxed))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(pCache->periodMs));
+    }
+
+    {
+        std::lock_guard<std::mutex> Guard(pCollector->barrierLock);
+        pCollector->barrierStopped = true;
+    }
+    pCollector->barrierWake.notify_all();
+    for (uint32_t i = 0; i < pCollector->workerCount; i++)
+    {
+        pCollector->workers[i].thread.join();
+    }
+}
+
+void ParallelCollectorRead(ParallelCollector *pCollector, ParallelCollectorStats *pStats)
+{
+    std::lock_guard<std::mutex> Guard(pCollector->statsLock);
+    memcpy(pStats, &pCollector->stats, sizeof(ParallelCollectorStats));
+}
@@ -0,0 +1,131 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  ParallelCollector.h
+ * @brief Samples every adapter of a TelemetryCache on its own thread.
+ *
+ * The cache's sampler walks the adapters one after the other, so each
+ * period must fit the driver calls of all of them and the last adapter is
+ * always read a whole walk after the first. Attached to the cache with
+ * TelemetryCacheAttachCollector, the collector runs one worker per adapter
+ * instead, optionally pinned to a core, each sampling into its own buffer
+ * on a tick grid shared by all workers. A worker that overruns skips to the
+ * next tick of the grid rather than drifting off it.
+ *
+ * With tickBarrier set the workers also wait for each other before every
+ * tick, so a slow adapter holds the others back instead of letting their
+ * samples spread over several ticks.
+ *
+ * For every tick that all workers sampled, the spread of their sample
+ * times is recorded as the tick's skew. Listeners still run one at a time,
+ * under the cache's listener lock.
+ *
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "QuantileHistogram.h"
+#include "TelemetryCache.h"
+
+#define PARALLEL_COLLECTOR_UNPINNED -1
+#define PARALLEL_COLLECTOR_TICK_SLOTS 16 ///< Ticks whose skew can be gathered at once
+
+struct ParallelCollectorConfig
+{
+    bool tickBarrier;                ///< Start every tick together, once the slowest worker finished the last one
+    int32_t cpu[AGENT_MAX_ADAPTERS]; ///< Core of each adapter's worker, PARALLEL_COLLECTOR_UNPINNED to leave it to the scheduler
+};
+
+struct ParallelWorkerStats
+{
+    uint32_t adapterIndex;
+    int32_t cpu;            ///< Core the worker is pinned to, PARALLEL_COLLECTOR_UNPINNED if none
+    ctl_result_t pinResult; ///< Of pinning it, CTL_RESULT_SUCCESS when unpinned
+    uint64_t passes;
+    uint64_t missedTicks; ///< Ticks skipped because a pass overran
+    double lastPassSec;
+    double maxPassSec;
+    double barrierWaitSec; ///< Total time spent waiting for the other workers
+};
+
+struct ParallelCollectorStats
+{
+    uint32_t workerCount;
+    bool tickBarrier;
+    uint64_t ticks;        ///< Ticks every worker sampled
+    uint64_t partialTicks; ///< Ticks at least one worker skipped, left out of the skew
+    double lastSkewSec;    ///< Spread of the sample times of the last complete tick
+    double maxSkewSec;
+    QuantileHistogram skewUs; ///< Skew of every complete tick, in microseconds
+    ParallelWorkerStats workers[AGENT_MAX_ADAPTERS];
+};
+
+struct ParallelTickSlot
+{
+    uint64_t tick;
+    uint32_t count; ///< Workers that sampled it so far
+    uint64_t minNs;
+    uint64_t maxNs;
+};
+
+/***************************************************************
+ * @brief One adapter's thread and sample buffer, kept apart from the others
+ ***************************************************************/
+struct alignas(64) ParallelWorker
+{
+    ParallelCollector *pCollector;
+    TelemetryCache *pCache;
+    uint32_t adapterIndex;
+    PublishedSnapshot scratch;
+    std::thread thread;
+};
+
+struct ParallelCollector
+{
+    ParallelCollectorConfig config;
+    uint32_t workerCount;
+    uint64_t epochNs; ///< Host time of tick 0
+    ParallelWorker workers[AGENT_MAX_ADAPTERS];
+
+    std::mutex barrierLock;
+    std::condition_variable barrierWake;
+    uint32_t barrierArrived;
+    uint64_t barrierGeneration;
+    uint64_t barrierTick;   ///< Latest tick any worker arrived with in this generation
+    uint64_t barrierGoTick; ///< Tick the last generation released its workers into
+    bool barrierStopped;    ///< Set on stop so no worker waits for one that has exited
+
+    std::mutex statsLock;
+    ParallelTickSlot tickSlots[PARALLEL_COLLECTOR_TICK_SLOTS];
+    ParallelCollectorStats stats;
+};
+
+/***************************************************************
+ * @brief No barrier and no worker pinned
+ ***************************************************************/
+void ParallelCollectorDefaultConfig(ParallelCollectorConfig *pConfig);
+
+/***************************************************************
+ * @brief Resets the statistics, pConfig may be nullptr for the defaults
+ ***************************************************************/
+ctl_result_t ParallelCollectorInit(ParallelCollector *pCollector, const ParallelCollectorConfig *pConfig);
+
+/***************************************************************
+ * @brief Runs one worker per adapter until pCache is stopped
+ *
+ * Called by the cache's sampler thread when the collector is attached.
+ ***************************************************************/
+void ParallelCollectorRun(ParallelCollector *pCollector, TelemetryCache *pCache);
+
+void ParallelCollectorRead(ParallelCollector *pCollector, ParallelCollectorStats *pStats);
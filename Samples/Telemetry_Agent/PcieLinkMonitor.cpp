@@ -0,0 +1,312 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  PcieLinkMonitor.cpp
+ * @brief PCIe link generation and width over time, against adapter activity.
+ *
+ */
+
+#include <string.h>
+
+#include "PcieLinkMonitor.h"
+
+ctl_result_t PcieLinkInit(PcieLinkMonitor *pMonitor, const AdapterTopology *pTopologies, uint32_t AdapterCount, uint32_t PeriodMs, PcieLinkPolicy Policy,
+                          const TelemetryCache *pCache)
+{
+    if ((nullptr == pMonitor) || (nullptr == pTopologies))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((Policy < PCIE_LINK_OBSERVE) || (Policy >= PCIE_LINK_POLICY_COUNT))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    pMonitor->adapterCount = (AdapterCount < AGENT_MAX_ADAPTERS) ? AdapterCount : AGENT_MAX_ADAPTERS;
+    pMonitor->periodMs     = (0 != PeriodMs) ? PeriodMs : PCIE_LINK_DEFAULT_PERIOD_MS;
+    pMonitor->policy       = Policy;
+    pMonitor->pCache       = pCache;
+    pMonitor->stopRequested.store(false);
+    memset(pMonitor->tracks, 0, sizeof(pMonitor->tracks));
+    memset(pMonitor->working, 0, sizeof(pMonitor->working));
+
+    uint32_t Supported = 0;
+    for (uint32_t i = 0; i < pMonitor->adapterCount; i++)
+    {
+        PcieLinkStats *pStats       = &pMonitor->working[i];
+        pMonitor->tracks[i].hDevice = pTopologies[i].hDevice;
+        pStats->adapterIndex        = pTopologies[i].adapterIndex;
+        pStats->maxSpeed.gen        = -1;
+        pStats->maxSpeed.width      = -1;
+        pStats->activityPct         = -1.0;
+
+        ctl_pci_properties_t Properties = {};
+        Properties.Size                 = sizeof(ctl_pci_properties_t);
+        Properties.Version              = 0;
+        pStats->lastResult              = ctlPciGetProperties(pTopologies[i].hDevice, &Properties);
+        if (CTL_RESULT_SUCCESS == pStats->lastResult)
+        {
+            pStats->maxSpeed = Properties.maxSpeed;
+            Supported++;
+        }
+    }
+
+    std::lock_guard<std::mutex> Guard(pMonitor->statsLock);
+    memcpy(pMonitor->stats, pMonitor->working, sizeof(pMonitor->stats));
+
+    return (0 != Supported) ? CTL_RESULT_SUCCESS : CTL_RESULT_ERROR_NOT_AVAILABLE;
+}
+
+/***************************************************************
+ * @brief Histogram bucket of a lane count, PCIE_LINK_WIDTH_BUCKETS if none
+ ***************************************************************/
+static uint32_t PcieLinkWidthBucket(int32_t Width)
+{
+    for (uint32_t b = 0; b < PCIE_LINK_WIDTH_BUCKETS; b++)
+    {
+        if (Width == static_cast<int32_t>(PcieLinkBucketWidth(b)))
+        {
+            return b;
+        }
+    }
+    return PCIE_LINK_WIDTH_BUCKETS;
+}
+
+/***************************************************************
+ * @brief Whether a link runs below the maximum reported for it
+ *
+ * Fields that either side leaves unknown are not compared.
+ ***************************************************************/
+static bool PcieLinkBelow(const ctl_pci_speed_t &Speed, const ctl_pci_speed_t &Reference)
+{
+    bool SlowerGen  = (Speed.gen > 0) && (Reference.gen > 0) && (Speed.gen < Reference.gen);
+    bool FewerLanes = (Speed.width > 0) && (Reference.width > 0) && (Speed.width < Reference.width);
+    return SlowerGen || FewerLanes;
+}
+
+static double PcieLinkActivity(PcieLinkMonitor *pMonitor, uint32_t AdapterIndex)
+{
+    if ((nullptr == pMonitor->pCache) || (CTL_RESULT_SUCCESS != TelemetryCacheRead(pMonitor->pCache, AdapterIndex, &pMonitor->telemetry)))
+    {
+        return -1.0;
+    }
+
+    const DerivedMetrics *pDerived = &pMonitor->telemetry.derived;
+    return (0 != (pDerived->validMask & DERIVED_VALID_GLOBAL_UTILIZATION)) ? pDerived->globalUtilizationPct : -1.0;
+}
+
+static void PcieLinkRecordEvent(PcieLinkStats *pStats, const PcieLinkEvent &Event)
+{
+    if (PCIE_LINK_MAX_EVENTS == pStats->eventCount)
+    {
+        memmove(&pStats->events[0], &pStats->events[1], (PCIE_LINK_MAX_EVENTS - 1) * sizeof(PcieLinkEvent));
+        pStats->eventCount--;
+    }
+    pStats->events[pStats->eventCount++] = Event;
+}
+
+/***************************************************************
+ * @brief Writes the link speed setting once, if the policy asks for it
+ ***************************************************************/
+static void PcieLinkApplyPolicy(PcieLinkMonitor *pMonitor, uint32_t AdapterIndex, bool Busy)
+{
+    PcieLinkStats *pStats = &pMonitor->working[AdapterIndex];
+    if (pStats->policyApplied || !Busy)
+    {
+        return;
+    }
+
+    bool Allow;
+    if ((PCIE_LINK_ALLOW_ON_DOWNGRADE == pMonitor->policy) && (pStats->speed.gen > 0) && (pStats->maxSpeed.gen > 0) && (pStats->speed.gen < pStats->maxSpeed.gen))
+    {
+        Allow = true;
+    }
+    else if ((PCIE_LINK_BLOCK_ON_FLAPPING == pMonitor->policy) && pStats->flapping)
+    {
+        Allow = false;
+    }
+    else
+    {
+        return;
+    }
+
+    pStats->policyApplied = true;
+    pStats->policyAllowed = Allow;
+    pStats->policyResult  = ctlAllowPCIeLinkSpeedUpdate(pMonitor->tracks[AdapterIndex].hDevice, Allow);
+}
+
+void PcieLinkSampleOnce(PcieLinkMonitor *pMonitor)
+{
+    for (uint32_t i = 0; i < pMonitor->adapterCount; i++)
+    {
+        PcieLinkTrack *pTrack = &pMonitor->tracks[i];
+        PcieLinkStats *pStats = &pMonitor->working[i];
+
+        ctl_pci_state_t State = {};
+        State.Size            = sizeof(ctl_pci_state_t);
+        State.Version         = 0;
+        pStats->lastResult    = ctlPciGetState(pTrack->hDevice, &State);
+        uint64_t NowNs        = AgentHostTimeNs();
+        if (CTL_RESULT_SUCCESS != pStats->lastResult)
+        {
+            pStats->failures++;
+            continue;
+        }
+
+        double ActivityPct = PcieLinkActivity(pMonitor, i);
+        bool Busy          = (ActivityPct >= PCIE_LINK_BUSY_PCT);
+
+        // The interval since the previous tick belongs to the state seen then
+        if (pTrack->havePrevious)
+        {
+            double IntervalSec = (NowNs - pTrack->previousNs) / 1e9;
+            uint32_t Bucket    = PcieLinkWidthBucket(pTrack->previous.width);
+            int32_t Gen        = pTrack->previous.gen;
+            if ((Gen >= 1) && (Gen <= PCIE_LINK_MAX_GEN) && (Bucket < PCIE_LINK_WIDTH_BUCKETS))
+            {
+                pStats->stateSec[pTrack->previousBusy ? 1 : 0][Gen - 1][Bucket] += IntervalSec;
+            }
+            else
+            {
+                pStats->unknownSec += IntervalSec;
+            }
+            if (PcieLinkBelow(pTrack->previous, pStats->maxSpeed))
+            {
+                pStats->degradedSec += IntervalSec;
+                pStats->degradedBusySec += pTrack->previousBusy ? IntervalSec : 0.0;
+            }
+
+            if ((State.speed.gen != pTrack->previous.gen) || (State.speed.width != pTrack->previous.width))
+            {
+                PcieLinkEvent Event   = {};
+                Event.hostTimestampNs = NowNs;
+                Event.fromGen         = pTrack->previous.gen;
+                Event.fromWidth       = pTrack->previous.width;
+                Event.toGen           = State.speed.gen;
+                Event.toWidth         = State.speed.width;
+                Event.downgrade       = PcieLinkBelow(State.speed, pTrack->previous);
+                Event.activityPct     = ActivityPct;
+                PcieLinkRecordEvent(pStats, Event);
+
+                pStats->changes++;
+                pStats->downgrades += Event.downgrade ? 1 : 0;
+                if (Event.downgrade && Busy)
+                {
+                    pStats->busyDowngrades++;
+                    pTrack->busyDowngradeNs[pTrack->busyDowngradeNext] = NowNs;
+                    pTrack->busyDowngradeNext                          = (pTrack->busyDowngradeNext + 1) % PCIE_LINK_FLAP_LIMIT;
+                }
+            }
+        }
+
+        // The next slot of the ring holds the oldest of the latest PCIE_LINK_FLAP_LIMIT busy downgrades
+        uint64_t OldestNs = pTrack->busyDowngradeNs[pTrack->busyDowngradeNext];
+        pStats->flapping  = (0 != OldestNs) && ((NowNs - OldestNs) / 1e9 <= PCIE_LINK_FLAP_WINDOW_SEC);
+
+        pStats->valid       = true;
+        pStats->speed       = State.speed;
+        pStats->activityPct = ActivityPct;
+        pStats->degraded    = PcieLinkBelow(State.speed, pStats->maxSpeed);
+        pStats->samples++;
+
+        pTrack->havePrevious = true;
+        pTrack->previous     = State.speed;
+        pTrack->previousBusy = Busy;
+        pTrack->previousNs   = NowNs;
+
+        if (PCIE_LINK_OBSERVE != pMonitor->policy)
+        {
+            PcieLinkApplyPolicy(pMonitor, i, Busy);
+        }
+    }
+
+    std::lock_guard<std::mutex> Guard(pMonitor->statsLock);
+    memcpy(pMonitor->stats, pMonitor->working, pMonitor->adapterCount * sizeof(PcieLinkStats));
+}
+
+static void PcieLinkThread(PcieLinkMonitor *pMonitor)
+{
+    auto NextTick = std::chrono::steady_clock::now();
+    while (!pMonitor->stopRequested.load(std::memory_order_relaxed))
+    {
+        PcieLinkSampleOnce(pMonitor);
+
+        NextTick += std::chrono::milliseconds(pMonitor->periodMs);
+        auto Now = std::chrono::steady_clock::now();
+        if (NextTick < Now)
+        {
+            NextTick = Now;
+        }
+        std::this_thread::sleep_until(NextTick);
+    }
+}
+
+ctl_result_t PcieLinkStart(PcieLinkMonitor *pMonitor)
+{
+    if (nullptr == pMonitor)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (pMonitor->sampler.joinable())
+    {
+        return CTL_RESULT_ERROR_ALREADY_INITIALIZED;
+    }
+
+    pMonitor->stopRequested.store(false);
+    pMonitor->sampler = std::thread(PcieLinkThread, pMonitor);
+    return CTL_RESULT_SUCCESS;
+}
+
+void PcieLinkStop(PcieLinkMonitor *pMonitor)
+{
+    if ((nullptr == pMonitor) || !pMonitor->sampler.joinable())
+    {
+        return;
+    }
+
+    pMonitor->stopRequested.store(true);
+    pMonitor->sampler.join();
+}
+
+ctl_result_t PcieLinkRead(PcieLinkMonitor *pMonitor, uint32_t AdapterIndex, PcieLinkStats *pStats)
+{
+    if ((nullptr == pMonitor) || (nullptr == pStats))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (AdapterIndex >= pMonitor->adapterCount)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pMonitor->statsLock);
+    *pStats = pMonitor->stats[AdapterIndex];
+    return CTL_RESULT_SUCCESS;
+}
+
+uint32_t PcieLinkBucketWidth(uint32_t Bucket)
+{
+    return (Bucket < PCIE_LINK_WIDTH_BUCKETS) ? (1u << Bucket) : 0;
+}
+
+const char *PcieLinkPolicyLabel(PcieLinkPolicy Policy)
+{
+    switch (Policy)
+    {
+        case PCIE_LINK_OBSERVE:
+            return "observe";
+        case PCIE_LINK_ALLOW_ON_DOWNGRADE:
+            return "allow_on_downgrade";
+        case PCIE_LINK_BLOCK_ON_FLAPPING:
+            return "block_on_flapping";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,154 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  PcieLinkMonitor.h
+ * @brief PCIe link generation and width over time, against adapter activity.
+ *
+ * Every tick reads ctlPciGetState for each adapter and compares the trained
+ * link with the previous tick and with the maxSpeed of ctlPciGetProperties,
+ * read once by PcieLinkInit. Each change is kept as an event stamped with the
+ * host clock and the global utilization of the latest cached sample, and the
+ * time between ticks is added to a histogram of generation, width and
+ * whether the adapter was busy.
+ *
+ * A link that drops while the adapter is idle is usually power management
+ * and costs nothing. One that drops while busy, or that stays below its
+ * maximum under load, throttles every transfer, which is what busyDowngrades
+ * and degradedBusySec count.
+ *
+ * ctlAllowPCIeLinkSpeedUpdate changes a persistent firmware setting that
+ * only takes effect when the link trains again, so a policy writes it at
+ * most once per adapter and run.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "TelemetryCache.h"
+
+#define PCIE_LINK_DEFAULT_PERIOD_MS 1000
+#define PCIE_LINK_MAX_GEN 6
+#define PCIE_LINK_WIDTH_BUCKETS 6 ///< x1, x2, x4, x8, x16 and x32
+#define PCIE_LINK_MAX_EVENTS 32
+#define PCIE_LINK_BUSY_PCT 30.0         ///< Global utilization from which the adapter counts as busy
+#define PCIE_LINK_FLAP_WINDOW_SEC 600.0 ///< Window of PCIE_LINK_BLOCK_ON_FLAPPING
+#define PCIE_LINK_FLAP_LIMIT 3          ///< Busy downgrades within the window that make a link flapping
+
+enum PcieLinkPolicy
+{
+    PCIE_LINK_OBSERVE = 0,        ///< Never writes
+    PCIE_LINK_ALLOW_ON_DOWNGRADE, ///< Allows the faster speeds once a busy link runs below its maximum generation
+    PCIE_LINK_BLOCK_ON_FLAPPING,  ///< Blocks the faster speeds once a busy link keeps dropping out of them
+    PCIE_LINK_POLICY_COUNT
+};
+
+/***************************************************************
+ * @brief One change of the trained link
+ ***************************************************************/
+struct PcieLinkEvent
+{
+    uint64_t hostTimestampNs;
+    int32_t fromGen;
+    int32_t fromWidth;
+    int32_t toGen;
+    int32_t toWidth;
+    bool downgrade;     ///< Lower generation or fewer lanes
+    double activityPct; ///< Global utilization at the change, negative if unknown
+};
+
+struct PcieLinkStats
+{
+    uint32_t adapterIndex;
+    bool valid; ///< At least one ctlPciGetState succeeded
+    ctl_pci_speed_t maxSpeed;
+    ctl_pci_speed_t speed;
+    double activityPct; ///< Negative if unknown
+    bool degraded;      ///< Below the maximum generation or width
+    bool flapping;      ///< PCIE_LINK_FLAP_LIMIT busy downgrades within PCIE_LINK_FLAP_WINDOW_SEC
+
+    double stateSec[2][PCIE_LINK_MAX_GEN][PCIE_LINK_WIDTH_BUCKETS]; ///< Indexed by busy, generation - 1 and width bucket
+    double unknownSec;                                              ///< Time at a generation or width outside the histogram
+    double degradedSec;
+    double degradedBusySec;
+
+    uint64_t samples;
+    uint64_t failures;
+    uint64_t changes;
+    uint64_t downgrades;
+    uint64_t busyDowngrades;
+    uint32_t eventCount;
+    PcieLinkEvent events[PCIE_LINK_MAX_EVENTS]; ///< Latest changes, oldest first
+
+    bool policyApplied;
+    bool policyAllowed; ///< Value written
+    ctl_result_t policyResult;
+    ctl_result_t lastResult;
+};
+
+/***************************************************************
+ * @brief Previous tick of one adapter, sampler private
+ ***************************************************************/
+struct PcieLinkTrack
+{
+    ctl_device_adapter_handle_t hDevice;
+    bool havePrevious;
+    ctl_pci_speed_t previous;
+    bool previousBusy;
+    uint64_t previousNs;
+    uint64_t busyDowngradeNs[PCIE_LINK_FLAP_LIMIT]; ///< Ring of the latest busy downgrades
+    uint32_t busyDowngradeNext;
+};
+
+struct PcieLinkMonitor
+{
+    uint32_t adapterCount;
+    uint32_t periodMs;
+    PcieLinkPolicy policy;
+    const TelemetryCache *pCache; ///< Optional, source of the activity
+
+    // Sampler private
+    PcieLinkTrack tracks[AGENT_MAX_ADAPTERS];
+    PcieLinkStats working[AGENT_MAX_ADAPTERS];
+    PublishedSnapshot telemetry;
+
+    std::mutex statsLock;
+    PcieLinkStats stats[AGENT_MAX_ADAPTERS];
+
+    std::atomic<bool> stopRequested;
+    std::thread sampler;
+};
+
+/***************************************************************
+ * @brief Reads the maximum speed of every adapter
+ *
+ * pCache may be nullptr, every tick then counts as idle.
+ ***************************************************************/
+ctl_result_t PcieLinkInit(PcieLinkMonitor *pMonitor, const AdapterTopology *pTopologies, uint32_t AdapterCount, uint32_t PeriodMs, PcieLinkPolicy Policy,
+                          const TelemetryCache *pCache);
+
+void PcieLinkSampleOnce(PcieLinkMonitor *pMonitor);
+ctl_result_t PcieLinkStart(PcieLinkMonitor *pMonitor);
+void PcieLinkStop(PcieLinkMonitor *pMonitor);
+
+ctl_result_t PcieLinkRead(PcieLinkMonitor *pMonitor, uint32_t AdapterIndex, PcieLinkStats *pStats);
+
+/***************************************************************
+ * @brief Lane count of a histogram bucket
+ ***************************************************************/
+uint32_t PcieLinkBucketWidth(uint32_t Bucket);
+
+/***************************************************************
+ * @brief Lower case names used in labels
+ ***************************************************************/
+const char *PcieLinkPolicyLabel(PcieLinkPolicy Policy);
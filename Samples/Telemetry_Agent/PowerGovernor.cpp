@@ -0,0 +1,489 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  PowerGovernor.cpp
+ * @brief Sustained power limit search for the most work per joule.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#include "PowerGovernor.h"
+
+void PowerGovernorDefaultConfig(PowerGovernorConfig *pConfig)
+{
+    pConfig->slotSec              = 5.0;
+    pConfig->settleSec            = 1.0;
+    pConfig->stepPct              = 10.0;
+    pConfig->minStepPct           = 2.0;
+    pConfig->floorPct             = 50.0;
+    pConfig->maxThroughputLossPct = 10.0;
+    pConfig->minGainPct           = 1.0;
+    pConfig->holdSec              = 60.0;
+}
+
+static void PowerGovernorListener(const AdapterSnapshot *pPrevious, const PublishedSnapshot *pCurrent, void *pContext)
+{
+    (void)pPrevious;
+    PowerGovernorUpdate(static_cast<PowerGovernor *>(pContext), pCurrent);
+}
+
+/***************************************************************
+ * @brief Live writer, the sustained limit of the first power domain
+ ***************************************************************/
+static ctl_result_t PowerGovernorDriverWriter(uint32_t AdapterIndex, const ctl_power_limits_t *pLimits, void *pContext)
+{
+    const TelemetryCache *pCache = static_cast<const TelemetryCache *>(pContext);
+    return ctlPowerSetLimits(pCache->topology[AdapterIndex].hPower[0], pLimits);
+}
+
+static ctl_result_t PowerGovernorSetup(PowerGovernor *pGovernor, const PowerGovernorConfig *pConfig)
+{
+    if (nullptr != pConfig)
+    {
+        pGovernor->config = *pConfig;
+    }
+    else
+    {
+        PowerGovernorDefaultConfig(&pGovernor->config);
+    }
+
+    const PowerGovernorConfig *pCfg = &pGovernor->config;
+    if (!(pCfg->slotSec > 0.0) || (pCfg->settleSec < 0.0) || (pCfg->settleSec >= pCfg->slotSec) || !(pCfg->minStepPct > 0.0) || (pCfg->stepPct < pCfg->minStepPct) ||
+        (pCfg->floorPct <= 0.0) || (pCfg->floorPct > 100.0) || (pCfg->maxThroughputLossPct < 0.0) || (pCfg->maxThroughputLossPct >= 100.0) || (pCfg->holdSec < 0.0))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    memset(pGovernor->loops, 0, sizeof(pGovernor->loops));
+    memset(pGovernor->working, 0, sizeof(pGovernor->working));
+    memset(pGovernor->progress, 0, sizeof(pGovernor->progress));
+    memset(pGovernor->progressSeen, 0, sizeof(pGovernor->progressSeen));
+    for (uint32_t a = 0; a < AGENT_MAX_ADAPTERS; a++)
+    {
+        pGovernor->working[a].adapterIndex = a;
+        pGovernor->working[a].lastResult   = CTL_RESULT_SUCCESS;
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+/***************************************************************
+ * @brief Derives the guard rails of an adapter, false if it cannot be governed
+ ***************************************************************/
+static bool PowerGovernorAttach(const PowerGovernorConfig *pConfig, const ctl_power_properties_t *pProperties, const ctl_power_limits_t *pLimits, PowerGovernorLoop *pLoop,
+                                PowerGovernorStats *pStats)
+{
+    const int32_t OriginalMw = pLimits->sustainedPowerLimit.power;
+    if (!pProperties->canControl || !pLimits->sustainedPowerLimit.enabled || (OriginalMw <= 0))
+    {
+        return false;
+    }
+
+    // Unknown bounds are reported as 0 or -1
+    pLoop->original  = *pLimits;
+    pLoop->defaultMw = (pProperties->defaultLimit > 0) ? pProperties->defaultLimit : OriginalMw;
+    pLoop->lowMw     = static_cast<int32_t>(pLoop->defaultMw * pConfig->floorPct / 100.0);
+    pLoop->highMw    = OriginalMw;
+    if (pProperties->minLimit > 0)
+    {
+        pLoop->lowMw = std::max(pLoop->lowMw, pProperties->minLimit);
+    }
+    if (pProperties->maxLimit > 0)
+    {
+        pLoop->highMw = std::min(pLoop->highMw, pProperties->maxLimit);
+    }
+    if (pLoop->lowMw >= pLoop->highMw)
+    {
+        return false;
+    }
+
+    pLoop->limitMw   = std::min(OriginalMw, pLoop->highMw);
+    pLoop->appliedMw = OriginalMw;
+    pLoop->direction = -1;
+    pLoop->stepPct   = pConfig->stepPct;
+
+    pStats->state           = POWER_GOVERNOR_STATE_SEARCHING;
+    pStats->originalMw      = OriginalMw;
+    pStats->lowMw           = pLoop->lowMw;
+    pStats->highMw          = pLoop->highMw;
+    pStats->limitMw         = pLoop->limitMw;
+    pStats->appliedMw       = OriginalMw;
+    pStats->stepPct         = pLoop->stepPct;
+    pStats->throughputRatio = 1.0;
+    pStats->efficiencyRatio = 1.0;
+    return true;
+}
+
+ctl_result_t PowerGovernorInit(PowerGovernor *pGovernor, const PowerGovernorConfig *pConfig, TelemetryCache *pCache)
+{
+    if ((nullptr == pGovernor) || (nullptr == pCache))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    ctl_result_t Result = PowerGovernorSetup(pGovernor, pConfig);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        return Result;
+    }
+
+    pGovernor->pCache         = pCache;
+    pGovernor->adapterCount   = pCache->adapterCount;
+    pGovernor->pfnWriter      = PowerGovernorDriverWriter;
+    pGovernor->pWriterContext = pCache;
+    for (uint32_t a = 0; a < pCache->adapterCount; a++)
+    {
+        const AdapterTopology *pTopology = &pCache->topology[a];
+        PowerGovernorStats *pStats       = &pGovernor->working[a];
+        if (0 == pTopology->powerDomainCount)
+        {
+            continue;
+        }
+
+        ctl_power_properties_t Properties = {};
+        ctl_power_limits_t Limits         = {};
+        Properties.Size                   = sizeof(ctl_power_properties_t);
+        Limits.Size                       = sizeof(ctl_power_limits_t);
+        pStats->lastResult                = ctlPowerGetProperties(pTopology->hPower[0], &Properties);
+        if (CTL_RESULT_SUCCESS == pStats->lastResult)
+        {
+            pStats->lastResult = ctlPowerGetLimits(pTopology->hPower[0], &Limits);
+        }
+        if (CTL_RESULT_SUCCESS == pStats->lastResult)
+        {
+            PowerGovernorAttach(&pGovernor->config, &Properties, &Limits, &pGovernor->loops[a], pStats);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> Guard(pGovernor->statsLock);
+        memcpy(pGovernor->stats, pGovernor->working, sizeof(pGovernor->stats));
+    }
+    return TelemetryCacheAddListener(pCache, PowerGovernorListener, pGovernor);
+}
+
+ctl_result_t PowerGovernorInitReplay(PowerGovernor *pGovernor, const PowerGovernorConfig *pConfig, uint32_t AdapterCount, const ctl_power_properties_t *pProperties,
+                                     const ctl_power_limits_t *pLimits, PowerLimitWriter pfnWriter, void *pWriterContext)
+{
+    if ((nullptr == pGovernor) || (nullptr == pProperties) || (nullptr == pLimits) || (nullptr == pfnWriter))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (AdapterCount > AGENT_MAX_ADAPTERS)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    ctl_result_t Result = PowerGovernorSetup(pGovernor, pConfig);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        return Result;
+    }
+
+    pGovernor->pCache         = nullptr;
+    pGovernor->adapterCount   = AdapterCount;
+    pGovernor->pfnWriter      = pfnWriter;
+    pGovernor->pWriterContext = pWriterContext;
+    for (uint32_t a = 0; a < AdapterCount; a++)
+    {
+        PowerGovernorAttach(&pGovernor->config, &pProperties[a], &pLimits[a], &pGovernor->loops[a], &pGovernor->working[a]);
+    }
+
+    std::lock_guard<std::mutex> Guard(pGovernor->statsLock);
+    memcpy(pGovernor->stats, pGovernor->working, sizeof(pGovernor->stats));
+    return CTL_RESULT_SUCCESS;
+}
+
+/***************************************************************
+ * @brief Writes a sustained limit, burst scaled alike, peak untouched
+ ***************************************************************/
+static ctl_result_t PowerGovernorWrite(PowerGovernor *pGovernor, uint32_t Adapter, int32_t SustainedMw)
+{
+    const PowerGovernorLoop *pLoop   = &pGovernor->loops[Adapter];
+    ctl_power_limits_t Limits        = pLoop->original;
+    Limits.sustainedPowerLimit.power = SustainedMw;
+    if (Limits.burstPowerLimit.enabled)
+    {
+        double Scaled                = static_cast<double>(pLoop->original.burstPowerLimit.power) * SustainedMw / pLoop->original.sustainedPowerLimit.power;
+        Limits.burstPowerLimit.power = std::max(SustainedMw, static_cast<int32_t>(Scaled));
+    }
+    return pGovernor->pfnWriter(Adapter, &Limits, pGovernor->pWriterContext);
+}
+
+/***************************************************************
+ * @brief Moves to the next candidate, false once the step is spent
+ ***************************************************************/
+static bool PowerGovernorNextCandidate(const PowerGovernorConfig *pConfig, PowerGovernorLoop *pLoop)
+{
+    while (pLoop->stepPct >= pConfig->minStepPct)
+    {
+        int32_t StepMw    = static_cast<int32_t>(lround(pLoop->stepPct / 100.0 * pLoop->defaultMw));
+        int32_t Candidate = std::min(std::max(pLoop->limitMw + pLoop->direction * StepMw, pLoop->lowMw), pLoop->highMw);
+        if (Candidate != pLoop->limitMw)
+        {
+            pLoop->candidateMw = Candidate;
+            return true;
+        }
+        pLoop->direction = -pLoop->direction;
+        pLoop->stepPct *= 0.5;
+    }
+    return false;
+}
+
+static void PowerGovernorResetProbe(PowerGovernorLoop *pLoop, uint64_t NowNs)
+{
+    pLoop->slot        = 0;
+    pLoop->slotStartNs = NowNs;
+    memset(pLoop->sideSec, 0, sizeof(pLoop->sideSec));
+    memset(pLoop->sideEnergyJ, 0, sizeof(pLoop->sideEnergyJ));
+    memset(pLoop->sideWork, 0, sizeof(pLoop->sideWork));
+}
+
+/***************************************************************
+ * @brief Settles a finished probe and picks what comes next
+ ***************************************************************/
+static void PowerGovernorEvaluate(const PowerGovernorConfig *pConfig, PowerGovernorLoop *pLoop, PowerGovernorStats *pStats, uint64_t NowNs)
+{
+    // A probe without measurements on both sides is run again
+    for (uint32_t Side = 0; Side < 2; Side++)
+    {
+        if (!(pLoop->sideSec[Side] > 0.0) || !(pLoop->sideEnergyJ[Side] > 0.0) || !(pLoop->sideWork[Side] > 0.0))
+        {
+            return;
+        }
+    }
+
+    double ThroughputA  = pLoop->sideWork[0] / pLoop->sideSec[0];
+    double ThroughputB  = pLoop->sideWork[1] / pLoop->sideSec[1];
+    double EfficiencyA  = pLoop->sideWork[0] / pLoop->sideEnergyJ[0];
+    double EfficiencyB  = pLoop->sideWork[1] / pLoop->sideEnergyJ[1];
+    double RatioT       = ThroughputB / ThroughputA;
+    double RatioE       = EfficiencyB / EfficiencyA;
+    pStats->lastGainPct = 100.0 * (RatioE - 1.0);
+    pStats->probes++;
+
+    bool Accept = (RatioE >= 1.0 + pConfig->minGainPct / 100.0) && (pStats->throughputRatio * RatioT >= 1.0 - pConfig->maxThroughputLossPct / 100.0);
+    if (Accept)
+    {
+        pLoop->limitMw = pLoop->candidateMw;
+        pStats->throughputRatio *= RatioT;
+        pStats->efficiencyRatio *= RatioE;
+        pStats->accepted++;
+    }
+    else
+    {
+        pLoop->direction = -pLoop->direction;
+        pLoop->stepPct *= 0.5;
+    }
+
+    if (!PowerGovernorNextCandidate(pConfig, pLoop))
+    {
+        pStats->state      = POWER_GOVERNOR_STATE_HOLDING;
+        pLoop->holdUntilNs = NowNs + static_cast<uint64_t>(pConfig->holdSec * 1e9);
+        pStats->searches++;
+    }
+}
+
+void PowerGovernorUpdate(PowerGovernor *pGovernor, const PublishedSnapshot *pSample)
+{
+    const uint32_t Adapter = pSample->snapshot.adapterIndex;
+    if (Adapter >= pGovernor->adapterCount)
+    {
+        return;
+    }
+
+    const PowerGovernorConfig *pConfig = &pGovernor->config;
+    PowerGovernorLoop *pLoop           = &pGovernor->loops[Adapter];
+    PowerGovernorStats *pStats         = &pGovernor->working[Adapter];
+    const uint64_t NowNs               = pSample->snapshot.hostTimestampNs;
+
+    double Progress   = 0.0;
+    bool ProgressSeen = false;
+    {
+        std::lock_guard<std::mutex> Guard(pGovernor->progressLock);
+        Progress                     = pGovernor->progress[Adapter];
+        ProgressSeen                 = pGovernor->progressSeen[Adapter];
+        pGovernor->progress[Adapter] = 0.0;
+    }
+
+    if ((POWER_GOVERNOR_STATE_SEARCHING != pStats->state) && (POWER_GOVERNOR_STATE_HOLDING != pStats->state))
+    {
+        return;
+    }
+
+    if (0 == pLoop->lastNs)
+    {
+        pLoop->lastNs = NowNs;
+        PowerGovernorResetProbe(pLoop, NowNs);
+        PowerGovernorNextCandidate(pConfig, pLoop);
+    }
+    double Dt     = (NowNs > pLoop->lastNs) ? (NowNs - pLoop->lastNs) / 1e9 : 0.0;
+    pLoop->lastNs = NowNs;
+
+    // Busy cycles and application units do not compare, start over on the switch
+    if (ProgressSeen && !pStats->appProgress)
+    {
+        pStats->appProgress = true;
+        PowerGovernorResetProbe(pLoop, NowNs);
+    }
+
+    if (POWER_GOVERNOR_STATE_HOLDING == pStats->state)
+    {
+        if (NowNs < pLoop->holdUntilNs)
+        {
+            return;
+        }
+        pLoop->stepPct = pConfig->stepPct;
+        PowerGovernorResetProbe(pLoop, NowNs);
+        pStats->state = PowerGovernorNextCandidate(pConfig, pLoop) ? POWER_GOVERNOR_STATE_SEARCHING : POWER_GOVERNOR_STATE_HOLDING;
+        if (POWER_GOVERNOR_STATE_HOLDING == pStats->state)
+        {
+            pLoop->holdUntilNs = NowNs + static_cast<uint64_t>(pConfig->holdSec * 1e9);
+        }
+    }
+    else if ((NowNs - pLoop->slotStartNs >= static_cast<uint64_t>(pConfig->settleSec * 1e9)) && (Dt > 0.0))
+    {
+        const DerivedMetrics *pDerived = &pSample->derived;
+        const uint64_t Mask            = (CTL_RESULT_SUCCESS == pSample->snapshot.telemetryResult) ? pSample->snapshot.telemetryValidMask : 0;
+        double Work                    = Progress;
+        bool HaveWork                  = pStats->appProgress;
+        if (!HaveWork && (0 != (pDerived->validMask & DERIVED_VALID_GLOBAL_UTILIZATION)))
+        {
+            TelemetryItemId Clock = (0 != (Mask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_GPU_EFFECTIVE_FREQUENCY))) ? TELEMETRY_ITEM_GPU_EFFECTIVE_FREQUENCY : TELEMETRY_ITEM_GPU_FREQUENCY;
+            HaveWork              = (0 != (Mask & TELEMETRY_ITEM_BIT(Clock)));
+            Work                  = HaveWork ? pDerived->globalUtilizationPct / 100.0 * pSample->snapshot.telemetryValues[Clock] * Dt : 0.0;
+        }
+
+        if (HaveWork && (0 != (pDerived->validMask & DERIVED_VALID_GPU_POWER)))
+        {
+            const uint32_t Side = ((1 == pLoop->slot) || (2 == pLoop->slot)) ? 1 : 0;
+            pLoop->sideSec[Side] += Dt;
+            pLoop->sideEnergyJ[Side] += pDerived->gpuPowerW * Dt;
+            pLoop->sideWork[Side] += Work;
+        }
+    }
+
+    if ((POWER_GOVERNOR_STATE_SEARCHING == pStats->state) && (NowNs - pLoop->slotStartNs >= static_cast<uint64_t>(pConfig->slotSec * 1e9)))
+    {
+        pLoop->slot++;
+        pLoop->slotStartNs = NowNs;
+        if (POWER_GOVERNOR_PROBE_SLOTS == pLoop->slot)
+        {
+            PowerGovernorEvaluate(pConfig, pLoop, pStats, NowNs);
+            PowerGovernorResetProbe(pLoop, NowNs);
+        }
+    }
+
+    int32_t WantMw = pLoop->limitMw;
+    if ((POWER_GOVERNOR_STATE_SEARCHING == pStats->state) && ((1 == pLoop->slot) || (2 == pLoop->slot)))
+    {
+        WantMw = pLoop->candidateMw;
+    }
+    if (WantMw != pLoop->appliedMw)
+    {
+        pStats->lastResult = PowerGovernorWrite(pGovernor, Adapter, WantMw);
+        if (CTL_RESULT_SUCCESS == pStats->lastResult)
+        {
+            pLoop->appliedMw = WantMw;
+            pStats->writes++;
+        }
+        else
+        {
+            // The limit in force is unknown, go back to the one found at start
+            pGovernor->pfnWriter(Adapter, &pLoop->original, pGovernor->pWriterContext);
+            pLoop->appliedMw = pLoop->original.sustainedPowerLimit.power;
+            pStats->state    = POWER_GOVERNOR_STATE_ROLLED_BACK;
+            pStats->failures++;
+        }
+    }
+
+    pStats->limitMw     = pLoop->limitMw;
+    pStats->candidateMw = pLoop->candidateMw;
+    pStats->appliedMw   = pLoop->appliedMw;
+    pStats->stepPct     = pLoop->stepPct;
+
+    std::lock_guard<std::mutex> Guard(pGovernor->statsLock);
+    pGovernor->stats[Adapter] = *pStats;
+}
+
+ctl_result_t PowerGovernorAddProgress(PowerGovernor *pGovernor, uint32_t AdapterIndex, double Units)
+{
+    if (nullptr == pGovernor)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((AdapterIndex >= AGENT_MAX_ADAPTERS) || (Units < 0.0))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pGovernor->progressLock);
+    pGovernor->progress[AdapterIndex] += Units;
+    pGovernor->progressSeen[AdapterIndex] = true;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t PowerGovernorRead(PowerGovernor *pGovernor, uint32_t AdapterIndex, PowerGovernorStats *pStats)
+{
+    if ((nullptr == pGovernor) || (nullptr == pStats))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (AdapterIndex >= AGENT_MAX_ADAPTERS)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pGovernor->statsLock);
+    *pStats = pGovernor->stats[AdapterIndex];
+    return CTL_RESULT_SUCCESS;
+}
+
+void PowerGovernorRelease(PowerGovernor *pGovernor)
+{
+    if (nullptr == pGovernor)
+    {
+        return;
+    }
+
+    for (uint32_t a = 0; a < pGovernor->adapterCount; a++)
+    {
+        PowerGovernorLoop *pLoop   = &pGovernor->loops[a];
+        PowerGovernorStats *pStats = &pGovernor->working[a];
+        if ((POWER_GOVERNOR_STATE_UNSUPPORTED != pStats->state) && (pLoop->appliedMw != pLoop->original.sustainedPowerLimit.power))
+        {
+            pStats->lastResult = pGovernor->pfnWriter(a, &pLoop->original, pGovernor->pWriterContext);
+            pLoop->appliedMw   = pLoop->original.sustainedPowerLimit.power;
+            pStats->appliedMw  = pLoop->appliedMw;
+        }
+    }
+
+    std::lock_guard<std::mutex> Guard(pGovernor->statsLock);
+    memcpy(pGovernor->stats, pGovernor->working, sizeof(pGovernor->stats));
+}
+
+const char *PowerGovernorStateLabel(PowerGovernorState State)
+{
+    switch (State)
+    {
+        case POWER_GOVERNOR_STATE_UNSUPPORTED:
+            return "unsupported";
+        case POWER_GOVERNOR_STATE_SEARCHING:
+            return "searching";
+        case POWER_GOVERNOR_STATE_HOLDING:
+            return "holding";
+        case POWER_GOVERNOR_STATE_ROLLED_BACK:
+            return "rolled back";
+        default:
+            return "unknown";
+    }
+}
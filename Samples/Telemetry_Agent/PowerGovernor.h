@@ -0,0 +1,194 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  PowerGovernor.h
+ * @brief Sustained power limit search for the most work per joule.
+ *
+ * Each adapter runs a step search on its sustained limit. A probe compares
+ * the incumbent limit A with a candidate B over four slots in the order
+ * A B B A, so a workload that drifts linearly weighs on both sides alike.
+ * The first settleSec of every slot are left out while the firmware
+ * follows the new limit. Work per joule and work per second are taken from
+ * the passes of each side.
+ *
+ * The candidate is accepted when its work per joule is at least minGainPct
+ * better and the throughput, chained over every accepted step, stays within
+ * maxThroughputLossPct of the original limit. Otherwise the search turns
+ * around with half the step. Once the step falls below minStepPct the
+ * limit is held for holdSec and the search starts over, so a new workload
+ * gets a new answer.
+ *
+ * Work is what the application reports through PowerGovernorAddProgress,
+ * frames or batches for example. Until it reports anything the governor
+ * counts busy clock cycles, global activity times the effective clock.
+ *
+ * Limits stay within the range of ctlPowerGetProperties, at or above
+ * floorPct of the default limit and never above the original sustained
+ * limit. The burst limit moves in proportion, the peak limits are left
+ * alone. Writes only happen at slot boundaries. A failed write restores
+ * the original limits and stops the adapter.
+ *
+ * The limits are written through a PowerLimitWriter. The live writer calls
+ * ctlPowerSetLimits from the listener, so only the sampler thread calls
+ * into the driver; PowerGovernorInitReplay takes a writer of its own to
+ * tune the governor against recorded telemetry.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <mutex>
+
+#include "TelemetryCache.h"
+
+#define POWER_GOVERNOR_PROBE_SLOTS 4 ///< A B B A
+
+enum PowerGovernorState
+{
+    POWER_GOVERNOR_STATE_UNSUPPORTED = 0, ///< No controllable sustained limit
+    POWER_GOVERNOR_STATE_SEARCHING,       ///< Probing candidates
+    POWER_GOVERNOR_STATE_HOLDING,         ///< Converged, holding the limit until the next search
+    POWER_GOVERNOR_STATE_ROLLED_BACK,     ///< Original limits restored after a failed write
+    POWER_GOVERNOR_STATE_COUNT
+};
+
+struct PowerGovernorConfig
+{
+    double slotSec;              ///< Length of one probe slot
+    double settleSec;            ///< Left out at the start of every slot
+    double stepPct;              ///< First step, percent of the default limit
+    double minStepPct;           ///< Smaller steps end the search
+    double floorPct;             ///< Lowest limit, percent of the default limit
+    double maxThroughputLossPct; ///< Against the original limit, chained over accepted steps
+    double minGainPct;           ///< Work per joule a candidate must win by
+    double holdSec;              ///< Between the end of a search and the next one
+};
+
+/***************************************************************
+ * @brief Writes the limits of one adapter
+ *
+ * Returns the result of the driver, anything but success rolls back.
+ ***************************************************************/
+typedef ctl_result_t (*PowerLimitWriter)(uint32_t AdapterIndex, const ctl_power_limits_t *pLimits, void *pContext);
+
+/***************************************************************
+ * @brief Search state of one adapter, sampler private
+ ***************************************************************/
+struct PowerGovernorLoop
+{
+    ctl_power_limits_t original;
+    int32_t defaultMw;
+    int32_t lowMw; ///< Guard rails of the search
+    int32_t highMw;
+    int32_t limitMw; ///< Incumbent
+    int32_t candidateMw;
+    int32_t appliedMw; ///< Sustained limit last written
+    int32_t direction; ///< -1 while lowering, 1 while raising
+    double stepPct;
+    uint32_t slot;
+    uint64_t slotStartNs;
+    uint64_t lastNs;
+    uint64_t holdUntilNs;
+    double sideSec[2]; ///< Measured time of A and B in the current probe
+    double sideEnergyJ[2];
+    double sideWork[2];
+};
+
+struct PowerGovernorStats
+{
+    uint32_t adapterIndex;
+    PowerGovernorState state;
+    int32_t originalMw;
+    int32_t lowMw;
+    int32_t highMw;
+    int32_t limitMw;     ///< Incumbent of the search
+    int32_t candidateMw; ///< Of the running probe
+    int32_t appliedMw;
+    double stepPct;
+    double throughputRatio; ///< Against the original limit, chained over accepted steps
+    double efficiencyRatio; ///< Work per joule against the original limit, chained likewise
+    double lastGainPct;     ///< Work per joule of the last candidate over its incumbent
+    bool appProgress;       ///< Work counted from PowerGovernorAddProgress
+    uint64_t probes;
+    uint64_t accepted;
+    uint64_t searches; ///< Completed, each followed by a hold
+    uint64_t writes;
+    uint64_t failures;
+    ctl_result_t lastResult;
+};
+
+struct PowerGovernor
+{
+    PowerGovernorConfig config;
+    const TelemetryCache *pCache; ///< nullptr when replaying
+    uint32_t adapterCount;
+    PowerLimitWriter pfnWriter;
+    void *pWriterContext;
+
+    PowerGovernorLoop loops[AGENT_MAX_ADAPTERS];    ///< Sampler private
+    PowerGovernorStats working[AGENT_MAX_ADAPTERS]; ///< Sampler private
+
+    std::mutex progressLock;
+    double progress[AGENT_MAX_ADAPTERS]; ///< Reported since the last pass
+    bool progressSeen[AGENT_MAX_ADAPTERS];
+
+    std::mutex statsLock;
+    PowerGovernorStats stats[AGENT_MAX_ADAPTERS];
+};
+
+/***************************************************************
+ * @brief Fills the default configuration
+ *
+ * A probe takes 20 s; a search of a few probes settles within minutes and
+ * gives up at most 10 % of the throughput.
+ ***************************************************************/
+void PowerGovernorDefaultConfig(PowerGovernorConfig *pConfig);
+
+/***************************************************************
+ * @brief Reads the guard rails and original limits and registers the listener
+ *
+ * Writes the sustained limit of the first power domain of each adapter.
+ * pConfig may be nullptr for the defaults. Call before TelemetryCacheStart.
+ ***************************************************************/
+ctl_result_t PowerGovernorInit(PowerGovernor *pGovernor, const PowerGovernorConfig *pConfig, TelemetryCache *pCache);
+
+/***************************************************************
+ * @brief Sets the governor up for snapshots fed by the caller
+ *
+ * pProperties and pLimits hold AdapterCount entries, the guard rails and
+ * the limits in force at the start. pfnWriter receives every write.
+ ***************************************************************/
+ctl_result_t PowerGovernorInitReplay(PowerGovernor *pGovernor, const PowerGovernorConfig *pConfig, uint32_t AdapterCount, const ctl_power_properties_t *pProperties,
+                                     const ctl_power_limits_t *pLimits, PowerLimitWriter pfnWriter, void *pWriterContext);
+
+/***************************************************************
+ * @brief Advances the search of one adapter over one pass
+ ***************************************************************/
+void PowerGovernorUpdate(PowerGovernor *pGovernor, const PublishedSnapshot *pSample);
+
+/***************************************************************
+ * @brief Reports application work done on an adapter, from any thread
+ ***************************************************************/
+ctl_result_t PowerGovernorAddProgress(PowerGovernor *pGovernor, uint32_t AdapterIndex, double Units);
+
+ctl_result_t PowerGovernorRead(PowerGovernor *pGovernor, uint32_t AdapterIndex, PowerGovernorStats *pStats);
+
+/***************************************************************
+ * @brief Restores the original limits of every adapter
+ *
+ * Call after TelemetryCacheStop.
+ ***************************************************************/
+void PowerGovernorRelease(PowerGovernor *pGovernor);
+
+/***************************************************************
+ * @brief Lower case state name used in labels
+ ***************************************************************/
+const char *PowerGovernorStateLabel(PowerGovernorState State);
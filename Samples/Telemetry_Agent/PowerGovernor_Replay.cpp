@@ -0,0 +1,368 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  PowerGovernor_Replay.cpp
+ * @brief Records power, activity and clock of an adapter to CSV, and tunes
+ *        the power governor offline by replaying such a recording, or a
+ *        built in trace of three phases, through a plant model of the
+ *        power limit. Clocks above the limit drop until the dynamic share
+ *        of the power, which grows with the clock to the power given by -a,
+ *        fits under it. The governed replay is reported against the same
+ *        trace at the original limit.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "igcl_api.h"
+#include "PowerGovernor.h"
+
+#define REPLAY_PERIOD_MS 100
+#define REPLAY_DEFAULT_LOOPS 3
+#define REPLAY_DEFAULT_EXPONENT 2.5
+#define REPLAY_DEFAULT_STATIC_W 30.0
+#define REPLAY_LIMIT_MW 190000 ///< Original sustained limit of the replay
+#define REPLAY_MIN_LIMIT_MW 60000
+#define REPLAY_MAX_LIMIT_MW 228000
+#define REPLAY_PHASE_SEC 120
+
+struct ReplayRow
+{
+    double timeSec;
+    double gpuPowerW; ///< At the original limit
+    double activityPct;
+    double clockMhz;
+};
+
+struct ReplayPlant
+{
+    double exponent;
+    double staticW;
+    int32_t limitMw;
+    uint64_t writes;
+};
+
+static ctl_result_t ReplayWriter(uint32_t AdapterIndex, const ctl_power_limits_t *pLimits, void *pContext)
+{
+    (void)AdapterIndex;
+    ReplayPlant *pPlant = static_cast<ReplayPlant *>(pContext);
+    pPlant->limitMw     = pLimits->sustainedPowerLimit.power;
+    pPlant->writes++;
+    return CTL_RESULT_SUCCESS;
+}
+
+/***************************************************************
+ * @brief Power and clock of a row under a limit
+ *
+ * A row recorded below the limit is unchanged; lowering the limit under it
+ * lowers the clock until the dynamic power fits.
+ ***************************************************************/
+static void ReplayApply(const ReplayPlant *pPlant, const ReplayRow *pRow, double *pPowerW, double *pClockMhz)
+{
+    double LimitW = pPlant->limitMw / 1000.0;
+    *pPowerW      = pRow->gpuPowerW;
+    *pClockMhz    = pRow->clockMhz;
+    if ((pRow->gpuPowerW > LimitW) && (pRow->gpuPowerW > pPlant->staticW))
+    {
+        double Scale = pow(fmax(LimitW - pPlant->staticW, 0.0) / (pRow->gpuPowerW - pPlant->staticW), 1.0 / pPlant->exponent);
+        *pPowerW     = LimitW;
+        *pClockMhz   = pRow->clockMhz * Scale;
+    }
+}
+
+/***************************************************************
+ * @brief Compute bound, mixed and light phases with a little noise
+ ***************************************************************/
+static void ReplaySynthesize(std::vector<ReplayRow> *pRows)
+{
+    const double PhasePowerW[]   = { 175.0, 125.0, 65.0 };
+    const double PhaseActivity[] = { 97.0, 75.0, 35.0 };
+    const double PhaseClockMhz[] = { 2350.0, 1950.0, 1300.0 };
+    const uint32_t RowsPerPhase  = REPLAY_PHASE_SEC * 1000 / REPLAY_PERIOD_MS;
+    std::mt19937 Generator(7);
+    std::normal_distribution<double> Noise(0.0, 1.0);
+
+    for (uint32_t Phase = 0; Phase < 3; Phase++)
+    {
+        for (uint32_t i = 0; i < RowsPerPhase; i++)
+        {
+            ReplayRow Row   = {};
+            Row.timeSec     = (Phase * RowsPerPhase + i) * REPLAY_PERIOD_MS / 1000.0;
+            Row.gpuPowerW   = PhasePowerW[Phase] + 3.0 * Noise(Generator);
+            Row.activityPct = fmin(PhaseActivity[Phase] + 2.0 * Noise(Generator), 100.0);
+            Row.clockMhz    = PhaseClockMhz[Phase] + 20.0 * Noise(Generator);
+            pRows->push_back(Row);
+        }
+    }
+}
+
+static bool ReplayLoad(const char *pPath, std::vector<ReplayRow> *pRows)
+{
+    FILE *pFile = fopen(pPath, "r");
+    if (nullptr == pFile)
+    {
+        return false;
+    }
+
+    char Line[256];
+    while (nullptr != fgets(Line, sizeof(Line), pFile))
+    {
+        ReplayRow Row = {};
+        if (4 == sscanf(Line, "%lf,%lf,%lf,%lf", &Row.timeSec, &Row.gpuPowerW, &Row.activityPct, &Row.clockMhz))
+        {
+            pRows->push_back(Row);
+        }
+    }
+    fclose(pFile);
+    return !pRows->empty();
+}
+
+/***************************************************************
+ * @brief Records adapter 0 through the telemetry cache
+ ***************************************************************/
+static int ReplayCapture(const char *pPath, double Seconds)
+{
+    ctl_init_args_t CtlInitArgs = {};
+    ctl_api_handle_t hAPIHandle = nullptr;
+    CtlInitArgs.AppVersion      = CTL_MAKE_VERSION(CTL_IMPL_MAJOR_VERSION, CTL_IMPL_MINOR_VERSION);
+    CtlInitArgs.flags           = CTL_INIT_FLAG_USE_LEVEL_ZERO;
+    CtlInitArgs.Size            = sizeof(CtlInitArgs);
+
+    ctl_result_t Result = ctlInit(&CtlInitArgs, &hAPIHandle);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        printf("[ERROR] ctlInit returned failure code: 0x%X\n", Result);
+        return 1;
+    }
+
+    uint32_t AdapterCount = 0;
+    Result                = ctlEnumerateDevices(hAPIHandle, &AdapterCount, nullptr);
+    std::vector<ctl_device_adapter_handle_t> hAdapters(std::min<uint32_t>(AdapterCount, AGENT_MAX_ADAPTERS));
+    AdapterCount = static_cast<uint32_t>(hAdapters.size());
+    if ((CTL_RESULT_SUCCESS == Result) && (0 != AdapterCount))
+    {
+        Result = ctlEnumerateDevices(hAPIHandle, &AdapterCount, hAdapters.data());
+    }
+
+    TelemetryCache *pCache = new TelemetryCache();
+    if ((CTL_RESULT_SUCCESS == Result) && (0 != AdapterCount))
+    {
+        Result = TelemetryCacheInit(pCache, hAdapters.data(), AdapterCount, REPLAY_PERIOD_MS);
+    }
+    FILE *pFile = nullptr;
+    if ((CTL_RESULT_SUCCESS == Result) && (0 != AdapterCount))
+    {
+        pFile = fopen(pPath, "w");
+    }
+    if ((nullptr == pFile) || (CTL_RESULT_SUCCESS != TelemetryCacheStart(pCache)))
+    {
+        printf("[ERROR] Cannot record to %s, result 0x%X with %u adapters\n", pPath, Result, AdapterCount);
+        if (nullptr != pFile)
+        {
+            fclose(pFile);
+        }
+        delete pCache;
+        ctlClose(hAPIHandle);
+        return 1;
+    }
+
+    fprintf(pFile, "time_sec,gpu_power_w,activity_pct,clock_mhz\n");
+    PublishedSnapshot *pSample = new PublishedSnapshot();
+    uint64_t LastSequence      = 0;
+    uint64_t StartNs           = 0;
+    uint32_t Rows              = 0;
+    auto Deadline              = std::chrono::steady_clock::now() + std::chrono::duration<double>(Seconds);
+    while (std::chrono::steady_clock::now() < Deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(REPLAY_PERIOD_MS / 4));
+        if ((CTL_RESULT_SUCCESS != TelemetryCacheRead(pCache, 0, pSample)) || (pSample->snapshot.sequence == LastSequence))
+        {
+            continue;
+        }
+        LastSequence = pSample->snapshot.sequence;
+
+        const DerivedMetrics *pDerived = &pSample->derived;
+        const uint64_t Mask            = pSample->snapshot.telemetryValidMask;
+        TelemetryItemId Clock          = (0 != (Mask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_GPU_EFFECTIVE_FREQUENCY))) ? TELEMETRY_ITEM_GPU_EFFECTIVE_FREQUENCY : TELEMETRY_ITEM_GPU_FREQUENCY;
+        if ((0 == (pDerived->validMask & DERIVED_VALID_GPU_POWER)) || (0 == (pDerived->validMask & DERIVED_VALID_GLOBAL_UTILIZATION)) || (0 == (Mask & TELEMETRY_ITEM_BIT(Clock))))
+        {
+            continue;
+        }
+        StartNs = (0 == StartNs) ? pSample->snapshot.hostTimestampNs : StartNs;
+        fprintf(pFile, "%.3f,%.2f,%.2f,%.1f\n", (pSample->snapshot.hostTimestampNs - StartNs) / 1e9, pDerived->gpuPowerW, pDerived->globalUtilizationPct,
+                pSample->snapshot.telemetryValues[Clock]);
+        Rows++;
+    }
+
+    TelemetryCacheStop(pCache);
+    fclose(pFile);
+    printf("Recorded %u rows of adapter 0 to %s\n", Rows, pPath);
+    delete pSample;
+    delete pCache;
+    ctlClose(hAPIHandle);
+    return (0 != Rows) ? 0 : 1;
+}
+
+static void Usage()
+{
+    printf("Usage: PowerGovernor_Replay [-c record.csv -t seconds] [-r record.csv] [-l loops] [-a exponent] [-s static_w]\n");
+    printf("  -c  record adapter 0 for the given seconds instead of replaying\n");
+    printf("  -r  replay a recording, the built in trace otherwise\n");
+    printf("  -l  times the trace is played, %u by default\n", REPLAY_DEFAULT_LOOPS);
+    printf("  -a  exponent of dynamic power over clock, %.1f by default\n", REPLAY_DEFAULT_EXPONENT);
+    printf("  -s  power that does not scale with the clock, %.0f W by default\n", REPLAY_DEFAULT_STATIC_W);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *pCapture = nullptr;
+    const char *pReplay  = nullptr;
+    double CaptureSec    = 60.0;
+    uint32_t Loops       = REPLAY_DEFAULT_LOOPS;
+    ReplayPlant Plant    = { REPLAY_DEFAULT_EXPONENT, REPLAY_DEFAULT_STATIC_W, REPLAY_LIMIT_MW, 0 };
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "-c")) && (i + 1 < argc))
+        {
+            pCapture = argv[++i];
+        }
+        else if ((0 == strcmp(argv[i], "-t")) && (i + 1 < argc))
+        {
+            CaptureSec = strtod(argv[++i], nullptr);
+        }
+        else if ((0 == strcmp(argv[i], "-r")) && (i + 1 < argc))
+        {
+            pReplay = argv[++i];
+        }
+        else if ((0 == strcmp(argv[i], "-l")) && (i + 1 < argc))
+        {
+            Loops = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if ((0 == strcmp(argv[i], "-a")) && (i + 1 < argc))
+        {
+            Plant.exponent = strtod(argv[++i], nullptr);
+        }
+        else if ((0 == strcmp(argv[i], "-s")) && (i + 1 < argc))
+        {
+            Plant.staticW = strtod(argv[++i], nullptr);
+        }
+        else
+        {
+            Usage();
+            return 1;
+        }
+    }
+    if ((0 == Loops) || !(Plant.exponent > 0.0) || (Plant.staticW < 0.0) || !(CaptureSec > 0.0))
+    {
+        Usage();
+        return 1;
+    }
+
+    if (nullptr != pCapture)
+    {
+        return ReplayCapture(pCapture, CaptureSec);
+    }
+
+    std::vector<ReplayRow> Rows;
+    if (nullptr != pReplay)
+    {
+        if (!ReplayLoad(pReplay, &Rows))
+        {
+            printf("[ERROR] No rows in %s\n", pReplay);
+            return 1;
+        }
+    }
+    else
+    {
+        ReplaySynthesize(&Rows);
+    }
+
+    ctl_power_properties_t Properties  = {};
+    ctl_power_limits_t Limits          = {};
+    Properties.canControl              = true;
+    Properties.defaultLimit            = REPLAY_LIMIT_MW;
+    Properties.minLimit                = REPLAY_MIN_LIMIT_MW;
+    Properties.maxLimit                = REPLAY_MAX_LIMIT_MW;
+    Limits.sustainedPowerLimit.enabled = true;
+    Limits.sustainedPowerLimit.power   = REPLAY_LIMIT_MW;
+    Limits.burstPowerLimit.enabled     = true;
+    Limits.burstPowerLimit.power       = REPLAY_MAX_LIMIT_MW;
+
+    PowerGovernor *pGovernor = new PowerGovernor();
+    ctl_result_t Result      = PowerGovernorInitReplay(pGovernor, nullptr, 1, &Properties, &Limits, ReplayWriter, &Plant);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        printf("[ERROR] PowerGovernorInitReplay returned failure code: 0x%X\n", Result);
+        delete pGovernor;
+        return 1;
+    }
+
+    // Rows are played back to back, each loop continuing the clock of the last
+    const double TraceSec      = Rows.back().timeSec - Rows.front().timeSec + REPLAY_PERIOD_MS / 1000.0;
+    PublishedSnapshot *pSample = new PublishedSnapshot();
+    double GovernedWork        = 0.0;
+    double GovernedEnergyJ     = 0.0;
+    double BaselineWork        = 0.0;
+    double BaselineEnergyJ     = 0.0;
+    double LastSec             = -1.0;
+    for (uint32_t Loop = 0; Loop < Loops; Loop++)
+    {
+        for (const ReplayRow &Row : Rows)
+        {
+            double NowSec = Loop * TraceSec + (Row.timeSec - Rows.front().timeSec);
+            double Dt     = (LastSec < 0.0) ? REPLAY_PERIOD_MS / 1000.0 : NowSec - LastSec;
+            LastSec       = NowSec;
+
+            double PowerW   = 0.0;
+            double ClockMhz = 0.0;
+            ReplayApply(&Plant, &Row, &PowerW, &ClockMhz);
+            GovernedWork += Row.activityPct / 100.0 * ClockMhz * Dt;
+            GovernedEnergyJ += PowerW * Dt;
+            BaselineWork += Row.activityPct / 100.0 * Row.clockMhz * Dt;
+            BaselineEnergyJ += Row.gpuPowerW * Dt;
+
+            memset(pSample, 0, sizeof(PublishedSnapshot));
+            pSample->snapshot.sequence                                                = 1;
+            pSample->snapshot.hostTimestampNs                                         = static_cast<uint64_t>((NowSec + 1.0) * 1e9);
+            pSample->snapshot.telemetryResult                                         = CTL_RESULT_SUCCESS;
+            pSample->snapshot.telemetryValidMask                                      = TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_GPU_EFFECTIVE_FREQUENCY);
+            pSample->snapshot.telemetryValues[TELEMETRY_ITEM_GPU_EFFECTIVE_FREQUENCY] = ClockMhz;
+            pSample->derived.intervalSec                                              = Dt;
+            pSample->derived.gpuPowerW                                                = PowerW;
+            pSample->derived.globalUtilizationPct                                     = Row.activityPct;
+            pSample->derived.validMask                                                = DERIVED_VALID_GPU_POWER | DERIVED_VALID_GLOBAL_UTILIZATION;
+            PowerGovernorUpdate(pGovernor, pSample);
+        }
+    }
+
+    PowerGovernorStats Stats = {};
+    PowerGovernorRead(pGovernor, 0, &Stats);
+    double ThroughputPct = 100.0 * GovernedWork / BaselineWork;
+    double SavingPct     = 100.0 * (1.0 - (GovernedEnergyJ / GovernedWork) / (BaselineEnergyJ / BaselineWork));
+    printf("Replayed %zu rows %u times, %.0f s, exponent %.1f, static %.0f W\n", Rows.size(), Loops, Loops * TraceSec, Plant.exponent, Plant.staticW);
+    printf("  state %s, limit %.1f W of %.1f W, range %.1f..%.1f W\n", PowerGovernorStateLabel(Stats.state), Stats.limitMw / 1000.0, Stats.originalMw / 1000.0,
+           Stats.lowMw / 1000.0, Stats.highMw / 1000.0);
+    printf("  probes %llu, accepted %llu, searches %llu, writes %llu\n", static_cast<unsigned long long>(Stats.probes), static_cast<unsigned long long>(Stats.accepted),
+           static_cast<unsigned long long>(Stats.searches), static_cast<unsigned long long>(Plant.writes));
+    printf("  throughput %.1f %% of the original limit, energy per unit of work %.1f %% lower\n", ThroughputPct, SavingPct);
+    printf("  average power %.1f W governed, %.1f W at the original limit\n", GovernedEnergyJ / (Loops * TraceSec), BaselineEnergyJ / (Loops * TraceSec));
+
+    delete pSample;
+    delete pGovernor;
+    return 0;
+}
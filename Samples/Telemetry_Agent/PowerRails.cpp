@@ -0,0 +1,284 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  PowerRails.cpp
+ * @brief Input power of every PSU rail, the fans and the voltage regulators.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "EnergyAccounting.h"
+#include "PowerRails.h"
+
+static const uint32_t PowerRailRegulatorItems[POWER_RAIL_VR_COUNT] = { TELEMETRY_ITEM_GPU_VR_TEMPERATURE, TELEMETRY_ITEM_VRAM_VR_TEMPERATURE, TELEMETRY_ITEM_SA_VR_TEMPERATURE };
+
+static double PowerRailRatedW(ctl_psu_type_t Type)
+{
+    switch (Type)
+    {
+        case CTL_PSU_TYPE_PSU_PCIE:
+            return POWER_RAIL_PCIE_SLOT_RATED_W;
+        case CTL_PSU_TYPE_PSU_6PIN:
+            return POWER_RAIL_6PIN_RATED_W;
+        case CTL_PSU_TYPE_PSU_8PIN:
+            return POWER_RAIL_8PIN_RATED_W;
+        default:
+            return 0.0;
+    }
+}
+
+static void PowerRailListener(const AdapterSnapshot *pPrevious, const PublishedSnapshot *pCurrent, void *pContext)
+{
+    PowerRailDecoderUpdate(static_cast<PowerRailDecoder *>(pContext), pPrevious, pCurrent);
+}
+
+ctl_result_t PowerRailDecoderInit(PowerRailDecoder *pDecoder, TelemetryCache *pCache, double TolerancePct, TimeSeriesStore *pStore)
+{
+    if ((nullptr == pDecoder) || (nullptr == pCache))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (TolerancePct < 0.0)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    pDecoder->pCache       = pCache;
+    pDecoder->tolerancePct = (0.0 != TolerancePct) ? TolerancePct : POWER_RAIL_DEFAULT_TOLERANCE_PCT;
+    pDecoder->pStore       = pStore;
+    for (uint32_t a = 0; a < AGENT_MAX_ADAPTERS; a++)
+    {
+        for (uint32_t r = 0; r < CTL_PSU_COUNT; r++)
+        {
+            pDecoder->railSeriesIds[a][r][0] = TIME_SERIES_INVALID_ID;
+            pDecoder->railSeriesIds[a][r][1] = TIME_SERIES_INVALID_ID;
+        }
+        pDecoder->inputSeriesIds[a][0] = TIME_SERIES_INVALID_ID;
+        pDecoder->inputSeriesIds[a][1] = TIME_SERIES_INVALID_ID;
+    }
+    {
+        std::lock_guard<std::mutex> Guard(pDecoder->lock);
+        memset(pDecoder->stats, 0, sizeof(pDecoder->stats));
+        for (uint32_t a = 0; a < AGENT_MAX_ADAPTERS; a++)
+        {
+            pDecoder->stats[a].adapterIndex = a;
+        }
+    }
+
+    return TelemetryCacheAddListener(pCache, PowerRailListener, pDecoder);
+}
+
+/***************************************************************
+ * @brief Registers the series of rails and adapters seen for the first time
+ ***************************************************************/
+static void PowerRailRegisterSeries(PowerRailDecoder *pDecoder, uint32_t Adapter, uint32_t NewRailMask, const ctl_psu_info_t *pPsu)
+{
+    char Labels[TIME_SERIES_LABELS_LEN];
+    if (TIME_SERIES_INVALID_ID == pDecoder->inputSeriesIds[Adapter][0])
+    {
+        snprintf(Labels, sizeof(Labels), "adapter=\"%u\"", Adapter);
+        pDecoder->inputSeriesIds[Adapter][0] = TimeSeriesStoreRegister(pDecoder->pStore, "psu_input_power_watts", Labels);
+        pDecoder->inputSeriesIds[Adapter][1] = TimeSeriesStoreRegister(pDecoder->pStore, "psu_card_power_mismatch_watts", Labels);
+    }
+    for (uint32_t r = 0; r < CTL_PSU_COUNT; r++)
+    {
+        if (0 != (NewRailMask & CTL_BIT(r)))
+        {
+            snprintf(Labels, sizeof(Labels), "adapter=\"%u\",rail=\"%u\",type=\"%s\"", Adapter, r, PowerRailTypeLabel(pPsu[r].psuType));
+            pDecoder->railSeriesIds[Adapter][r][0] = TimeSeriesStoreRegister(pDecoder->pStore, "psu_rail_power_watts", Labels);
+            pDecoder->railSeriesIds[Adapter][r][1] = TimeSeriesStoreRegister(pDecoder->pStore, "psu_rail_voltage_volts", Labels);
+        }
+    }
+}
+
+void PowerRailDecoderUpdate(PowerRailDecoder *pDecoder, const AdapterSnapshot *pPrevious, const PublishedSnapshot *pCurrent)
+{
+    const AdapterSnapshot *pSnapshot = &pCurrent->snapshot;
+    const DerivedMetrics *pDerived   = &pCurrent->derived;
+    uint32_t Adapter                 = pSnapshot->adapterIndex;
+    if ((Adapter >= AGENT_MAX_ADAPTERS) || (CTL_RESULT_SUCCESS != pSnapshot->telemetryResult))
+    {
+        return;
+    }
+
+    // A rail is populated when its entry is supported and it reports a reading
+    const ctl_psu_info_t *pPsu = pSnapshot->telemetry.psu;
+    const uint64_t Mask        = pSnapshot->telemetryValidMask;
+    const uint64_t BothMask    = (CTL_RESULT_SUCCESS == pPrevious->telemetryResult) ? (Mask & pPrevious->telemetryValidMask) : 0;
+    double IntervalSec         = pDerived->intervalSec;
+    uint32_t RailMask          = 0;
+    for (uint32_t r = 0; r < CTL_PSU_COUNT; r++)
+    {
+        uint64_t Items = TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_PSU_ENERGY_0 + r) | TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_PSU_VOLTAGE_0 + r);
+        RailMask |= (pPsu[r].bSupported && (0 != (Mask & Items))) ? CTL_BIT(r) : 0;
+    }
+
+    uint32_t SeriesIds[2 * CTL_PSU_COUNT + 2];
+    double SeriesValues[2 * CTL_PSU_COUNT + 2];
+    uint32_t SeriesCount = 0;
+    {
+        std::lock_guard<std::mutex> Guard(pDecoder->lock);
+        PowerRailStats *pStats = &pDecoder->stats[Adapter];
+        uint32_t NewRailMask   = RailMask & ~pStats->railMask;
+        if ((nullptr != pDecoder->pStore) && (0 != NewRailMask))
+        {
+            PowerRailRegisterSeries(pDecoder, Adapter, NewRailMask, pPsu);
+        }
+        pStats->railMask |= RailMask;
+        pStats->railPowerMask = 0;
+
+        // Energy is only counted by rails that report a counter at all
+        uint32_t MeteredMask = 0;
+        double InputW        = 0.0;
+        for (uint32_t r = 0; r < CTL_PSU_COUNT; r++)
+        {
+            if (0 == (RailMask & CTL_BIT(r)))
+            {
+                continue;
+            }
+
+            PowerRail *pRail     = &pStats->rails[r];
+            uint32_t EnergyItem  = TELEMETRY_ITEM_PSU_ENERGY_0 + r;
+            uint32_t VoltageItem = TELEMETRY_ITEM_PSU_VOLTAGE_0 + r;
+            pRail->type          = pPsu[r].psuType;
+            pRail->ratedW        = PowerRailRatedW(pPsu[r].psuType);
+            pRail->voltageV      = (0 != (Mask & TELEMETRY_ITEM_BIT(VoltageItem))) ? pSnapshot->telemetryValues[VoltageItem] : 0.0;
+            MeteredMask |= (0 != (Mask & TELEMETRY_ITEM_BIT(EnergyItem))) ? CTL_BIT(r) : 0;
+            if ((0 == (BothMask & TELEMETRY_ITEM_BIT(EnergyItem))) || (IntervalSec <= 0.0))
+            {
+                continue;
+            }
+
+            double DeltaJ = pSnapshot->telemetryValues[EnergyItem] - pPrevious->telemetryValues[EnergyItem];
+            double RangeJ = TelemetryDecodePlanRange(&pDecoder->pCache->decodePlan[Adapter], EnergyItem);
+            double LimitJ = ENERGY_MAX_PLAUSIBLE_WATTS * IntervalSec;
+            if ((DeltaJ < 0.0) && (RangeJ > 0.0) && (DeltaJ + RangeJ <= LimitJ))
+            {
+                DeltaJ += RangeJ;
+                pRail->counterWraps++;
+            }
+            else if ((DeltaJ < 0.0) || (DeltaJ > LimitJ))
+            {
+                pRail->counterResets++;
+                continue;
+            }
+            pRail->powerW   = DeltaJ / IntervalSec;
+            pRail->currentA = (pRail->voltageV > 0.0) ? pRail->powerW / pRail->voltageV : 0.0;
+            pRail->loadPct  = (pRail->ratedW > 0.0) ? 100.0 * pRail->powerW / pRail->ratedW : 0.0;
+            pRail->peakW    = (pRail->powerW > pRail->peakW) ? pRail->powerW : pRail->peakW;
+            pRail->energyJ += DeltaJ;
+            pStats->railPowerMask |= CTL_BIT(r);
+            InputW += pRail->powerW;
+
+            SeriesIds[SeriesCount]      = pDecoder->railSeriesIds[Adapter][r][0];
+            SeriesValues[SeriesCount++] = pRail->powerW;
+            if (pRail->voltageV > 0.0)
+            {
+                SeriesIds[SeriesCount]      = pDecoder->railSeriesIds[Adapter][r][1];
+                SeriesValues[SeriesCount++] = pRail->voltageV;
+            }
+        }
+
+        pStats->fanMask = 0;
+        for (uint32_t f = 0; f < CTL_FAN_COUNT; f++)
+        {
+            if (0 != (Mask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_FAN_SPEED_0 + f)))
+            {
+                pStats->fanSpeedRpm[f] = pSnapshot->telemetryValues[TELEMETRY_ITEM_FAN_SPEED_0 + f];
+                pStats->fanMask |= CTL_BIT(f);
+            }
+        }
+
+        pStats->regulatorMask = 0;
+        for (uint32_t v = 0; v < POWER_RAIL_VR_COUNT; v++)
+        {
+            if (0 != (Mask & TELEMETRY_ITEM_BIT(PowerRailRegulatorItems[v])))
+            {
+                pStats->regulatorC[v] = pSnapshot->telemetryValues[PowerRailRegulatorItems[v]];
+                pStats->regulatorMask |= CTL_BIT(v);
+            }
+        }
+
+        // Both sides must cover the same interval, a rail left out would read as a mismatch
+        pStats->reconciled = (0 != MeteredMask) && (MeteredMask == pStats->railPowerMask) && (0 != (pDerived->validMask & DERIVED_VALID_CARD_POWER));
+        if (0 != pStats->railPowerMask)
+        {
+            pStats->inputPowerW         = InputW;
+            SeriesIds[SeriesCount]      = pDecoder->inputSeriesIds[Adapter][0];
+            SeriesValues[SeriesCount++] = InputW;
+        }
+        if (pStats->reconciled)
+        {
+            pStats->cardPowerW  = pDerived->cardPowerW;
+            pStats->mismatchW   = InputW - pDerived->cardPowerW;
+            pStats->mismatchPct = (pDerived->cardPowerW >= POWER_RAIL_MIN_CARD_W) ? 100.0 * pStats->mismatchW / pDerived->cardPowerW : 0.0;
+            pStats->averageMismatchW += ((0 == pStats->intervals) ? 1.0 : TimeSeriesEwmaWeight(IntervalSec, POWER_RAIL_MISMATCH_TAU_SEC)) * (pStats->mismatchW - pStats->averageMismatchW);
+            pStats->intervals++;
+            pStats->mismatches += (fabs(pStats->mismatchPct) > pDecoder->tolerancePct) ? 1 : 0;
+
+            SeriesIds[SeriesCount]      = pDecoder->inputSeriesIds[Adapter][1];
+            SeriesValues[SeriesCount++] = pStats->mismatchW;
+        }
+    }
+
+    if ((nullptr != pDecoder->pStore) && (0 != SeriesCount))
+    {
+        TimeSeriesStoreAppendBatch(pDecoder->pStore, SeriesIds, SeriesValues, SeriesCount, pSnapshot->hostTimestampNs);
+    }
+}
+
+ctl_result_t PowerRailDecoderRead(PowerRailDecoder *pDecoder, uint32_t AdapterIndex, PowerRailStats *pStats)
+{
+    if ((nullptr == pDecoder) || (nullptr == pStats))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (AdapterIndex >= AGENT_MAX_ADAPTERS)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pDecoder->lock);
+    *pStats = pDecoder->stats[AdapterIndex];
+    return CTL_RESULT_SUCCESS;
+}
+
+const char *PowerRailTypeLabel(ctl_psu_type_t Type)
+{
+    switch (Type)
+    {
+        case CTL_PSU_TYPE_PSU_PCIE:
+            return "pcie_slot";
+        case CTL_PSU_TYPE_PSU_6PIN:
+            return "6pin";
+        case CTL_PSU_TYPE_PSU_8PIN:
+            return "8pin";
+        default:
+            return "unknown";
+    }
+}
+
+const char *PowerRailRegulatorLabel(PowerRailRegulator Regulator)
+{
+    switch (Regulator)
+    {
+        case POWER_RAIL_VR_GPU:
+            return "gpu";
+        case POWER_RAIL_VR_VRAM:
+            return "vram";
+        case POWER_RAIL_VR_SA:
+            return "sa";
+        default:
+            return "unknown";
+    }
+}
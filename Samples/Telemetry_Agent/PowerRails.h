@@ -0,0 +1,125 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  PowerRails.h
+ * @brief Input power of every PSU rail, the fans and the voltage regulators.
+ *
+ * ctlPowerTelemetryGet reports an energy counter and a voltage for each of
+ * up to CTL_PSU_COUNT power inputs, e.g. the PCIe slot and the 6 or 8 pin
+ * connectors, a speed for each of up to CTL_FAN_COUNT fans and the
+ * temperature of the GPU, VRAM and system agent regulators. Which entries a
+ * board populates differs by model, so a listener on the telemetry cache
+ * discovers them from the first passes that report them.
+ *
+ * Each pass turns the counters of the populated rails into watts over the
+ * interval of the derived metrics, and their sum into the input power of the
+ * card. The same interval gives cardPowerW from totalCardEnergyCounter, so
+ * the two are compared sample for sample: a rail that is not measured or a
+ * counter that drifts shows up as a mismatch that persists. A rail counter
+ * that drops by its decoded range wrapped and is counted through, as the
+ * card energy is by EnergyAccountant; an interval where it drops any other
+ * way, or grows faster than ENERGY_MAX_PLAUSIBLE_WATTS, is a reset and is
+ * left out.
+ *
+ * The load of a rail is also given against the rating of its connector,
+ * which is what a rack level power cap has to respect per cable.
+ *
+ */
+
+#pragma once
+
+#include <mutex>
+
+#include "TelemetryCache.h"
+#include "TimeSeriesStore.h"
+
+#define POWER_RAIL_DEFAULT_TOLERANCE_PCT 5.0
+#define POWER_RAIL_MIN_CARD_W 5.0         ///< Below this card power the relative mismatch is not judged
+#define POWER_RAIL_MISMATCH_TAU_SEC 30.0  ///< Time constant of the average mismatch
+#define POWER_RAIL_PCIE_SLOT_RATED_W 75.0 ///< PCIe CEM ratings of each input
+#define POWER_RAIL_6PIN_RATED_W 75.0
+#define POWER_RAIL_8PIN_RATED_W 150.0
+
+enum PowerRailRegulator
+{
+    POWER_RAIL_VR_GPU = 0,
+    POWER_RAIL_VR_VRAM,
+    POWER_RAIL_VR_SA,
+    POWER_RAIL_VR_COUNT
+};
+
+struct PowerRail
+{
+    ctl_psu_type_t type;
+    double ratedW;   ///< Rating of the connector type, 0 if unknown
+    double voltageV; ///< Latest reading, 0 if the rail reports no voltage
+    double powerW;   ///< Over the latest interval
+    double currentA; ///< powerW at voltageV, 0 without a voltage
+    double loadPct;  ///< powerW of ratedW, 0 without a rating
+    double peakW;
+    double energyJ; ///< Integrated since the rail was discovered
+    uint32_t counterWraps;
+    uint32_t counterResets;
+};
+
+struct PowerRailStats
+{
+    uint32_t adapterIndex;
+    uint32_t railMask;      ///< CTL_BIT(i) of the populated psu[i]
+    uint32_t railPowerMask; ///< CTL_BIT(i) of the rails whose powerW is current
+    uint32_t fanMask;       ///< CTL_BIT(i) of the fanSpeed[i] reported
+    uint32_t regulatorMask; ///< CTL_BIT(PowerRailRegulator) of the temperatures reported
+    PowerRail rails[CTL_PSU_COUNT];
+    double fanSpeedRpm[CTL_FAN_COUNT];
+    double regulatorC[POWER_RAIL_VR_COUNT];
+
+    bool reconciled;         ///< Every rail and the card counter covered the latest interval
+    double inputPowerW;      ///< Sum of the rails
+    double cardPowerW;       ///< From totalCardEnergyCounter
+    double mismatchW;        ///< inputPowerW minus cardPowerW
+    double mismatchPct;      ///< Of cardPowerW, 0 below POWER_RAIL_MIN_CARD_W
+    double averageMismatchW; ///< Over POWER_RAIL_MISMATCH_TAU_SEC
+    uint64_t intervals;      ///< Reconciled so far
+    uint64_t mismatches;     ///< Of those, beyond the tolerance
+};
+
+struct PowerRailDecoder
+{
+    const TelemetryCache *pCache;
+    double tolerancePct;
+    TimeSeriesStore *pStore;                                      ///< Optional, receives each rail and the input power
+    uint32_t railSeriesIds[AGENT_MAX_ADAPTERS][CTL_PSU_COUNT][2]; ///< Power and voltage, sampler private
+    uint32_t inputSeriesIds[AGENT_MAX_ADAPTERS][2];               ///< Input power and mismatch, sampler private
+
+    std::mutex lock;
+    PowerRailStats stats[AGENT_MAX_ADAPTERS];
+};
+
+/***************************************************************
+ * @brief Clears every adapter and registers the listener
+ *
+ * TolerancePct is the mismatch counted in mismatches, 0 for the default.
+ * pStore may be nullptr. Call before TelemetryCacheStart.
+ ***************************************************************/
+ctl_result_t PowerRailDecoderInit(PowerRailDecoder *pDecoder, TelemetryCache *pCache, double TolerancePct, TimeSeriesStore *pStore);
+
+/***************************************************************
+ * @brief Decodes one pass of an adapter
+ ***************************************************************/
+void PowerRailDecoderUpdate(PowerRailDecoder *pDecoder, const AdapterSnapshot *pPrevious, const PublishedSnapshot *pCurrent);
+
+ctl_result_t PowerRailDecoderRead(PowerRailDecoder *pDecoder, uint32_t AdapterIndex, PowerRailStats *pStats);
+
+/***************************************************************
+ * @brief Lower case connector names used in labels
+ ***************************************************************/
+const char *PowerRailTypeLabel(ctl_psu_type_t Type);
+
+const char *PowerRailRegulatorLabel(PowerRailRegulator Regulator);
@@ -0,0 +1,190 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  QuantileHistogram.cpp
+ * @brief Fixed size log-linear histogram for streaming percentiles.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "QuantileHistogram.h"
+
+#define QUANTILE_HISTOGRAM_HALF (QUANTILE_HISTOGRAM_SUB_BUCKETS / 2)
+
+/***************************************************************
+ * @brief Index of the highest set bit, Value must not be 0
+ ***************************************************************/
+static inline uint32_t QuantileHistogramMsb(uint64_t Value)
+{
+#if defined(_MSC_VER)
+    unsigned long Index;
+    _BitScanReverse64(&Index, Value);
+    return static_cast<uint32_t>(Index);
+#else
+    return 63u - static_cast<uint32_t>(__builtin_clzll(Value));
+#endif
+}
+
+static inline uint32_t QuantileHistogramIndex(uint64_t Units)
+{
+    if (Units < QUANTILE_HISTOGRAM_SUB_BUCKETS)
+    {
+        return static_cast<uint32_t>(Units);
+    }
+
+    // Bucket b holds [HALF << b, SUB_BUCKETS << b) in steps of 1 << b
+    uint32_t Bucket = QuantileHistogramMsb(Units) - (QUANTILE_HISTOGRAM_SUB_BUCKET_BITS - 1);
+    uint32_t Sub    = static_cast<uint32_t>(Units >> Bucket);
+    return (Bucket + 1) * QUANTILE_HISTOGRAM_HALF + (Sub - QUANTILE_HISTOGRAM_HALF);
+}
+
+/***************************************************************
+ * @brief Lowest unit and width in units of a bucket
+ ***************************************************************/
+static inline void QuantileHistogramBucketRange(uint32_t Index, uint64_t *pLow, uint64_t *pWidth)
+{
+    if (Index < QUANTILE_HISTOGRAM_SUB_BUCKETS)
+    {
+        *pLow   = Index;
+        *pWidth = 1;
+        return;
+    }
+
+    uint32_t Bucket = Index / QUANTILE_HISTOGRAM_HALF - 1;
+    uint64_t Sub    = Index % QUANTILE_HISTOGRAM_HALF + QUANTILE_HISTOGRAM_HALF;
+    *pLow           = Sub << Bucket;
+    *pWidth         = 1ull << Bucket;
+}
+
+ctl_result_t QuantileHistogramInit(QuantileHistogram *pHistogram, double Resolution)
+{
+    if (nullptr == pHistogram)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (!(Resolution > 0.0))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    pHistogram->resolution = Resolution;
+    QuantileHistogramReset(pHistogram);
+    return CTL_RESULT_SUCCESS;
+}
+
+void QuantileHistogramReset(QuantileHistogram *pHistogram)
+{
+    pHistogram->totalCount = 0;
+    pHistogram->clamped    = 0;
+    pHistogram->min        = 0.0;
+    pHistogram->max        = 0.0;
+    pHistogram->sum        = 0.0;
+    memset(pHistogram->counts, 0, sizeof(pHistogram->counts));
+}
+
+void QuantileHistogramRecord(QuantileHistogram *pHistogram, double Value, uint64_t Count)
+{
+    if ((0 == Count) || isnan(Value))
+    {
+        return;
+    }
+
+    double Units = Value / pHistogram->resolution + 0.5;
+    uint64_t Index;
+    if (Units < 1.0)
+    {
+        Index = 0;
+    }
+    else if (Units >= static_cast<double>(QUANTILE_HISTOGRAM_MAX_UNITS))
+    {
+        Index = QUANTILE_HISTOGRAM_BUCKETS - 1;
+        pHistogram->clamped += Count;
+    }
+    else
+    {
+        Index = QuantileHistogramIndex(static_cast<uint64_t>(Units));
+    }
+    pHistogram->counts[Index] += Count;
+
+    pHistogram->min = ((0 == pHistogram->totalCount) || (Value < pHistogram->min)) ? Value : pHistogram->min;
+    pHistogram->max = ((0 == pHistogram->totalCount) || (Value > pHistogram->max)) ? Value : pHistogram->max;
+    pHistogram->sum += Value * static_cast<double>(Count);
+    pHistogram->totalCount += Count;
+}
+
+ctl_result_t QuantileHistogramMerge(QuantileHistogram *pDestination, const QuantileHistogram *pSource)
+{
+    if ((nullptr == pDestination) || (nullptr == pSource))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (pDestination->resolution != pSource->resolution)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+    if (0 == pSource->totalCount)
+    {
+        return CTL_RESULT_SUCCESS;
+    }
+
+    for (uint32_t i = 0; i < QUANTILE_HISTOGRAM_BUCKETS; i++)
+    {
+        pDestination->counts[i] += pSource->counts[i];
+    }
+    pDestination->min = ((0 == pDestination->totalCount) || (pSource->min < pDestination->min)) ? pSource->min : pDestination->min;
+    pDestination->max = ((0 == pDestination->totalCount) || (pSource->max > pDestination->max)) ? pSource->max : pDestination->max;
+    pDestination->sum += pSource->sum;
+    pDestination->clamped += pSource->clamped;
+    pDestination->totalCount += pSource->totalCount;
+    return CTL_RESULT_SUCCESS;
+}
+
+double QuantileHistogramPercentile(const QuantileHistogram *pHistogram, double Percentile)
+{
+    if ((nullptr == pHistogram) || (0 == pHistogram->totalCount))
+    {
+        return 0.0;
+    }
+
+    double Clamped = (Percentile < 0.0) ? 0.0 : ((Percentile > 100.0) ? 100.0 : Percentile);
+    uint64_t Rank  = static_cast<uint64_t>(ceil(Clamped / 100.0 * static_cast<double>(pHistogram->totalCount)));
+    Rank           = (0 == Rank) ? 1 : Rank;
+
+    uint64_t Seen = 0;
+    for (uint32_t i = 0; i < QUANTILE_HISTOGRAM_BUCKETS; i++)
+    {
+        Seen += pHistogram->counts[i];
+        if (Seen >= Rank)
+        {
+            uint64_t Low;
+            uint64_t Width;
+            QuantileHistogramBucketRange(i, &Low, &Width);
+
+            // Unit u holds [u - 0.5, u + 0.5) since values are rounded
+            double Value = (static_cast<double>(Low) + 0.5 * static_cast<double>(Width) - 0.5) * pHistogram->resolution;
+            return (Value < pHistogram->min) ? pHistogram->min : ((Value > pHistogram->max) ? pHistogram->max : Value);
+        }
+    }
+    return pHistogram->max;
+}
+
+double QuantileHistogramMean(const QuantileHistogram *pHistogram)
+{
+    if ((nullptr == pHistogram) || (0 == pHistogram->totalCount))
+    {
+        return 0.0;
+    }
+    return pHistogram->sum / static_cast<double>(pHistogram->totalCount);
+}
@@ -0,0 +1,82 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  QuantileHistogram.h
+ * @brief Fixed size log-linear histogram for streaming percentiles.
+ *
+ * Values are counted in units of a resolution chosen per metric, e.g. 0.1 W,
+ * and bucketed the way HdrHistogram does: the first
+ * QUANTILE_HISTOGRAM_SUB_BUCKETS units are exact, and each further power of
+ * two is split into QUANTILE_HISTOGRAM_SUB_BUCKETS / 2 equal buckets. A
+ * bucket is thus never wider than 1/32 of its value, and a percentile read
+ * from its midpoint is off by under 1.6 %.
+ *
+ * Recording is a bit scan and an add, with no allocation. Two histograms of
+ * the same resolution merge by adding their buckets, so per adapter, per
+ * window or per job histograms combine without the raw samples. Values at
+ * or above QUANTILE_HISTOGRAM_MAX_UNITS land in the last bucket and are
+ * counted in clamped; negative values count as 0.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "igcl_api.h"
+
+#define QUANTILE_HISTOGRAM_SUB_BUCKET_BITS 6
+#define QUANTILE_HISTOGRAM_SUB_BUCKETS (1u << QUANTILE_HISTOGRAM_SUB_BUCKET_BITS)
+#define QUANTILE_HISTOGRAM_MAX_BITS 24 ///< Largest value counted exactly is 2^24 units
+#define QUANTILE_HISTOGRAM_MAX_UNITS (1ull << QUANTILE_HISTOGRAM_MAX_BITS)
+#define QUANTILE_HISTOGRAM_BUCKETS ((QUANTILE_HISTOGRAM_MAX_BITS - QUANTILE_HISTOGRAM_SUB_BUCKET_BITS + 2) * (QUANTILE_HISTOGRAM_SUB_BUCKETS / 2))
+
+struct QuantileHistogram
+{
+    double resolution; ///< Value of one unit
+    uint64_t totalCount;
+    uint64_t clamped; ///< Counts recorded at or above QUANTILE_HISTOGRAM_MAX_UNITS
+    double min;
+    double max;
+    double sum; ///< Of value times count
+    uint64_t counts[QUANTILE_HISTOGRAM_BUCKETS];
+};
+
+/***************************************************************
+ * @brief Empties the histogram and sets its resolution
+ ***************************************************************/
+ctl_result_t QuantileHistogramInit(QuantileHistogram *pHistogram, double Resolution);
+
+/***************************************************************
+ * @brief Empties the histogram, keeping its resolution
+ ***************************************************************/
+void QuantileHistogramReset(QuantileHistogram *pHistogram);
+
+/***************************************************************
+ * @brief Counts Value Count times, e.g. once per millisecond it held
+ ***************************************************************/
+void QuantileHistogramRecord(QuantileHistogram *pHistogram, double Value, uint64_t Count);
+
+/***************************************************************
+ * @brief Adds the buckets of pSource to pDestination
+ *
+ * Returns CTL_RESULT_ERROR_INVALID_ARGUMENT if the resolutions differ.
+ ***************************************************************/
+ctl_result_t QuantileHistogramMerge(QuantileHistogram *pDestination, const QuantileHistogram *pSource);
+
+/***************************************************************
+ * @brief Value below which Percentile percent of the counts fall
+ *
+ * Midpoint of the bucket holding that rank, kept within min and max.
+ * Returns 0 for an empty histogram.
+ ***************************************************************/
+double QuantileHistogramPercentile(const QuantileHistogram *pHistogram, double Percentile);
+
+double QuantileHistogramMean(const QuantileHistogram *pHistogram);
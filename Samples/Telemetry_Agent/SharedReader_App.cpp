@@ -0,0 +1,109 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  SharedReader_App.cpp
+ * @brief Example consumer of the shared memory telemetry segment. It does
+ *        not initialize or link the control library.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+#include "SharedTelemetry.h"
+
+static void PrintUsage()
+{
+    printf("Usage: Telemetry_SharedReader [-n name] [-c count] [-i interval_ms]\n");
+    printf("    -n  Segment name, default %s\n", SHARED_TELEMETRY_DEFAULT_NAME);
+    printf("    -c  Number of reports, default 10\n");
+    printf("    -i  Interval between reports in milliseconds, default 1000\n");
+}
+
+/***************************************************************
+ * @brief Main Function
+ ***************************************************************/
+int main(int argc, char *argv[])
+{
+    const char *pName   = SHARED_TELEMETRY_DEFAULT_NAME;
+    uint32_t Count      = 10;
+    uint32_t IntervalMs = 1000;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((i + 1 < argc) && (0 == strcmp(argv[i], "-n")))
+        {
+            pName = argv[++i];
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-c")))
+        {
+            Count = static_cast<uint32_t>(atoi(argv[++i]));
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-i")))
+        {
+            IntervalMs = static_cast<uint32_t>(atoi(argv[++i]));
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    SharedTelemetryReader Reader;
+    ctl_result_t Result = SharedTelemetryReaderOpen(&Reader, pName);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        printf("[ERROR] SharedTelemetryReaderOpen returned failure code: 0x%X\n", Result);
+        return 1;
+    }
+
+    const SharedTelemetryHeader *pHeader = &Reader.pLayout->header;
+    printf("[INFO] Segment %s: %u adapters, publisher pid %u, period %u ms\n", pName, Reader.adapterCount, pHeader->publisherPid, pHeader->periodMs);
+
+    PublishedSnapshot Snapshot;
+    for (uint32_t n = 0; (n < Count) && SharedTelemetryReaderPublisherActive(&Reader); n++)
+    {
+        uint64_t NowNs = AgentHostTimeNs();
+        for (uint32_t i = 0; i < Reader.adapterCount; i++)
+        {
+            SharedTelemetryReaderRead(&Reader, i, &Snapshot);
+
+            const DerivedMetrics *pDerived = &Snapshot.derived;
+            printf("Adapter %u %-24s seq %-8llu age %6.1f ms", i, pHeader->topology[i].name, static_cast<unsigned long long>(Snapshot.snapshot.sequence),
+                   ((0 != Snapshot.snapshot.sequence) && (NowNs > Snapshot.snapshot.hostTimestampNs)) ? (NowNs - Snapshot.snapshot.hostTimestampNs) / 1e6 : 0.0);
+            if (0 != (pDerived->validMask & DERIVED_VALID_CARD_POWER))
+            {
+                printf("  card %7.2f W", pDerived->cardPowerW);
+            }
+            if (0 != (pDerived->validMask & DERIVED_VALID_GLOBAL_UTILIZATION))
+            {
+                printf("  busy %5.1f %%", pDerived->globalUtilizationPct);
+            }
+            if (0 != (Snapshot.snapshot.telemetryValidMask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_GPU_TEMPERATURE)))
+            {
+                printf("  gpu %5.1f C", Snapshot.snapshot.telemetryValues[TELEMETRY_ITEM_GPU_TEMPERATURE]);
+            }
+            printf("\n");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(IntervalMs));
+    }
+
+    if (!SharedTelemetryReaderPublisherActive(&Reader))
+    {
+        printf("[INFO] Publisher stopped\n");
+    }
+
+    SharedTelemetryReaderClose(&Reader);
+    return 0;
+}
@@ -0,0 +1,273 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  SharedTelemetry.cpp
+ * @brief Shared memory mapping and the reader side of the publication.
+ *
+ * Only this file and SnapshotSeqlock.h are needed by reader processes, they
+ * do not link the control library.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "SharedTelemetry.h"
+
+static bool SharedMemoryName(const char *pName, SharedMemoryRegion *pRegion)
+{
+    if ((nullptr == pName) || (0 == pName[0]) || (strlen(pName) > SHARED_TELEMETRY_MAX_NAME))
+    {
+        return false;
+    }
+
+#if defined(_WIN32)
+    snprintf(pRegion->name, sizeof(pRegion->name), "Local\\%s", pName);
+#else
+    snprintf(pRegion->name, sizeof(pRegion->name), "/%s", pName);
+#endif
+    return true;
+}
+
+ctl_result_t SharedMemoryCreate(const char *pName, size_t Size, SharedMemoryRegion *pRegion)
+{
+    if (nullptr == pRegion)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    memset(pRegion, 0, sizeof(SharedMemoryRegion));
+    if (!SharedMemoryName(pName, pRegion))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+#if defined(_WIN32)
+    HANDLE hMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(Size), pRegion->name);
+    if (nullptr == hMapping)
+    {
+        return CTL_RESULT_ERROR_OS_CALL;
+    }
+    if (ERROR_ALREADY_EXISTS == GetLastError())
+    {
+        // Another process still holds the mapping open
+        CloseHandle(hMapping);
+        return CTL_RESULT_ERROR_ALREADY_INITIALIZED;
+    }
+
+    void *pView = MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, Size);
+    if (nullptr == pView)
+    {
+        CloseHandle(hMapping);
+        return CTL_RESULT_ERROR_OS_CALL;
+    }
+    pRegion->hMapping = hMapping;
+#else
+    // A crashed publisher leaves the name behind, the caller decides whether it is stale
+    int Fd = shm_open(pRegion->name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (Fd < 0)
+    {
+        return (EEXIST == errno) ? CTL_RESULT_ERROR_ALREADY_INITIALIZED : CTL_RESULT_ERROR_OS_CALL;
+    }
+    if (0 != ftruncate(Fd, static_cast<off_t>(Size)))
+    {
+        close(Fd);
+        shm_unlink(pRegion->name);
+        return CTL_RESULT_ERROR_OS_CALL;
+    }
+
+    void *pView = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+    close(Fd);
+    if (MAP_FAILED == pView)
+    {
+        shm_unlink(pRegion->name);
+        return CTL_RESULT_ERROR_OS_CALL;
+    }
+#endif
+
+    pRegion->pView = pView;
+    pRegion->size  = Size;
+    pRegion->owner = true;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t SharedMemoryOpenReadOnly(const char *pName, SharedMemoryRegion *pRegion)
+{
+    if (nullptr == pRegion)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    memset(pRegion, 0, sizeof(SharedMemoryRegion));
+    if (!SharedMemoryName(pName, pRegion))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+#if defined(_WIN32)
+    HANDLE hMapping = OpenFileMappingA(FILE_MAP_READ, FALSE, pRegion->name);
+    if (nullptr == hMapping)
+    {
+        return CTL_RESULT_ERROR_NOT_AVAILABLE;
+    }
+
+    void *pView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION Info;
+    if ((nullptr == pView) || (0 == VirtualQuery(pView, &Info, sizeof(Info))))
+    {
+        if (nullptr != pView)
+        {
+            UnmapViewOfFile(pView);
+        }
+        CloseHandle(hMapping);
+        return CTL_RESULT_ERROR_OS_CALL;
+    }
+    pRegion->hMapping = hMapping;
+    pRegion->size     = Info.RegionSize;
+#else
+    int Fd = shm_open(pRegion->name, O_RDONLY, 0);
+    if (Fd < 0)
+    {
+        return (ENOENT == errno) ? CTL_RESULT_ERROR_NOT_AVAILABLE : CTL_RESULT_ERROR_OS_CALL;
+    }
+
+    struct stat Stat;
+    if ((0 != fstat(Fd, &Stat)) || (0 == Stat.st_size))
+    {
+        close(Fd);
+        return CTL_RESULT_ERROR_NOT_INITIALIZED;
+    }
+
+    void *pView = mmap(nullptr, static_cast<size_t>(Stat.st_size), PROT_READ, MAP_SHARED, Fd, 0);
+    close(Fd);
+    if (MAP_FAILED == pView)
+    {
+        return CTL_RESULT_ERROR_OS_CALL;
+    }
+    pRegion->size = static_cast<size_t>(Stat.st_size);
+#endif
+
+    pRegion->pView = pView;
+    pRegion->owner = false;
+    return CTL_RESULT_SUCCESS;
+}
+
+void SharedMemoryClose(SharedMemoryRegion *pRegion)
+{
+    if ((nullptr == pRegion) || (nullptr == pRegion->pView))
+    {
+        return;
+    }
+
+#if defined(_WIN32)
+    UnmapViewOfFile(pRegion->pView);
+    CloseHandle(static_cast<HANDLE>(pRegion->hMapping));
+#else
+    munmap(pRegion->pView, pRegion->size);
+    if (pRegion->owner)
+    {
+        shm_unlink(pRegion->name);
+    }
+#endif
+
+    pRegion->pView    = nullptr;
+    pRegion->hMapping = nullptr;
+    pRegion->size     = 0;
+}
+
+ctl_result_t SharedTelemetryReaderOpen(SharedTelemetryReader *pReader, const char *pName)
+{
+    if (nullptr == pReader)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pReader->pLayout      = nullptr;
+    pReader->adapterCount = 0;
+
+    ctl_result_t Result = SharedMemoryOpenReadOnly((nullptr != pName) ? pName : SHARED_TELEMETRY_DEFAULT_NAME, &pReader->region);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        return Result;
+    }
+
+    const SharedTelemetryLayout *pLayout = static_cast<const SharedTelemetryLayout *>(pReader->region.pView);
+    const SharedTelemetryHeader *pHeader = &pLayout->header;
+    if (pReader->region.size < sizeof(SharedTelemetryHeader))
+    {
+        Result = CTL_RESULT_ERROR_NOT_INITIALIZED;
+    }
+    else if (SHARED_TELEMETRY_MAGIC != pHeader->magic.load(std::memory_order_acquire))
+    {
+        Result = CTL_RESULT_ERROR_NOT_INITIALIZED;
+    }
+    else if ((SHARED_TELEMETRY_LAYOUT_VERSION != pHeader->layoutVersion) || (sizeof(SharedTelemetryHeader) != pHeader->headerSize) || (sizeof(SnapshotSlot) != pHeader->slotSize) ||
+             (sizeof(PublishedSnapshot) != pHeader->payloadSize) || (pReader->region.size < sizeof(SharedTelemetryLayout)) || (pHeader->adapterCount > AGENT_MAX_ADAPTERS))
+    {
+        Result = CTL_RESULT_ERROR_UNSUPPORTED_VERSION;
+    }
+
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        SharedMemoryClose(&pReader->region);
+        return Result;
+    }
+
+    pReader->pLayout      = pLayout;
+    pReader->adapterCount = pHeader->adapterCount;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t SharedTelemetryReaderRead(const SharedTelemetryReader *pReader, uint32_t AdapterIndex, PublishedSnapshot *pSnapshot, uint32_t *pRetries)
+{
+    if ((nullptr == pReader) || (nullptr == pReader->pLayout) || (nullptr == pSnapshot))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (AdapterIndex >= pReader->adapterCount)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    const SnapshotSlot *pSlot = &pReader->pLayout->slots[AdapterIndex];
+    uint32_t Retries          = SeqlockRead(&pSlot->sequence, pSlot->words, pSnapshot, sizeof(PublishedSnapshot), nullptr);
+    if (nullptr != pRetries)
+    {
+        *pRetries = Retries;
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+bool SharedTelemetryReaderPublisherActive(const SharedTelemetryReader *pReader)
+{
+    return (nullptr != pReader) && (nullptr != pReader->pLayout) && (SHARED_TELEMETRY_STATE_ACTIVE == pReader->pLayout->header.state.load(std::memory_order_acquire));
+}
+
+void SharedTelemetryReaderClose(SharedTelemetryReader *pReader)
+{
+    if (nullptr == pReader)
+    {
+        return;
+    }
+
+    SharedMemoryClose(&pReader->region);
+    pReader->pLayout      = nullptr;
+    pReader->adapterCount = 0;
+}
@@ -0,0 +1,133 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  SharedTelemetry.h
+ * @brief Node wide telemetry publication over named shared memory.
+ *
+ * One publisher process samples the driver and its TelemetryCache writes
+ * every adapter slot directly into the segment. Reader processes map the
+ * segment read only once; after that a read is a seqlock copy out of the
+ * mapping and issues no system call and no driver call.
+ *
+ * The segment starts with a header describing the layout. Readers refuse
+ * segments whose magic, layout version or sizes differ from their own build.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#include "SnapshotSeqlock.h"
+#include "TelemetrySampler.h"
+#include "TelemetryCache.h"
+
+#define SHARED_TELEMETRY_MAGIC 0x4C434749u ///< "IGCL"
+#define SHARED_TELEMETRY_LAYOUT_VERSION 6
+#define SHARED_TELEMETRY_DEFAULT_NAME "igcl_telemetry"
+#define SHARED_TELEMETRY_MAX_NAME 64
+#define SHARED_TELEMETRY_RECLAIM_GRACE_SEC 10 ///< Age at which a segment without a complete header or pid is taken as abandoned
+
+#define SHARED_TELEMETRY_STATE_ACTIVE 1
+#define SHARED_TELEMETRY_STATE_STOPPED 2
+
+/***************************************************************
+ * @brief Segment header, written once by the publisher before magic
+ *
+ * Topology handles are cleared, they have no meaning in another process.
+ * The fields from magic to state keep their offsets in every layout
+ * version, so a publisher can tell who owns a segment of another build.
+ ***************************************************************/
+struct SharedTelemetryHeader
+{
+    std::atomic<uint32_t> magic; ///< Stored last with release, 0 while the header is being filled
+    uint32_t layoutVersion;
+    uint32_t headerSize;
+    uint32_t slotSize;
+    uint32_t payloadSize;
+    uint32_t adapterCount;
+    uint32_t periodMs;
+    uint32_t publisherPid;
+    std::atomic<uint32_t> state;
+    uint64_t createdNs; ///< Publisher steady clock, same clock as hostTimestampNs
+    AdapterTopology topology[AGENT_MAX_ADAPTERS];
+};
+
+struct SharedTelemetryLayout
+{
+    alignas(64) SharedTelemetryHeader header;
+    SnapshotSlot slots[AGENT_MAX_ADAPTERS];
+};
+
+/***************************************************************
+ * @brief Platform mapping of a named segment
+ ***************************************************************/
+struct SharedMemoryRegion
+{
+    void *pView;
+    size_t size;
+    void *hMapping; ///< Windows mapping handle, unused elsewhere
+    bool owner;     ///< Created by this process, removed on close
+    char name[SHARED_TELEMETRY_MAX_NAME + 8];
+};
+
+ctl_result_t SharedMemoryCreate(const char *pName, size_t Size, SharedMemoryRegion *pRegion);
+ctl_result_t SharedMemoryOpenReadOnly(const char *pName, SharedMemoryRegion *pRegion);
+void SharedMemoryClose(SharedMemoryRegion *pRegion);
+
+struct SharedTelemetryReader
+{
+    SharedMemoryRegion region;
+    const SharedTelemetryLayout *pLayout;
+    uint32_t adapterCount;
+};
+
+/***************************************************************
+ * @brief Maps the segment and validates its layout
+ *
+ * Returns CTL_RESULT_ERROR_NOT_AVAILABLE if no publisher created it,
+ * CTL_RESULT_ERROR_NOT_INITIALIZED while the header is still being filled
+ * and CTL_RESULT_ERROR_UNSUPPORTED_VERSION on a layout mismatch.
+ ***************************************************************/
+ctl_result_t SharedTelemetryReaderOpen(SharedTelemetryReader *pReader, const char *pName);
+
+/***************************************************************
+ * @brief Copies the latest snapshot of an adapter without system calls
+ ***************************************************************/
+ctl_result_t SharedTelemetryReaderRead(const SharedTelemetryReader *pReader, uint32_t AdapterIndex, PublishedSnapshot *pSnapshot, uint32_t *pRetries = nullptr);
+
+/***************************************************************
+ * @brief False once the publisher has shut down cleanly
+ ***************************************************************/
+bool SharedTelemetryReaderPublisherActive(const SharedTelemetryReader *pReader);
+
+void SharedTelemetryReaderClose(SharedTelemetryReader *pReader);
+
+struct SharedTelemetryPublisher
+{
+    SharedMemoryRegion region;
+    SharedTelemetryLayout *pLayout;
+    TelemetryCache *pCache;
+};
+
+/***************************************************************
+ * @brief Creates the segment and attaches the cache slots to it
+ *
+ * Call before TelemetryCacheStart. Fails with
+ * CTL_RESULT_ERROR_ALREADY_INITIALIZED if a live publisher owns the name.
+ ***************************************************************/
+ctl_result_t SharedTelemetryPublisherCreate(SharedTelemetryPublisher *pPublisher, TelemetryCache *pCache, const char *pName);
+
+/***************************************************************
+ * @brief Marks the segment stopped and removes it. Call after TelemetryCacheStop.
+ ***************************************************************/
+void SharedTelemetryPublisherDestroy(SharedTelemetryPublisher *pPublisher);
@@ -0,0 +1,193 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  SharedTelemetryPublisher.cpp
+ * @brief Publisher side of the shared memory telemetry segment.
+ *
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "SharedTelemetry.h"
+
+static uint32_t CurrentProcessId()
+{
+#if defined(_WIN32)
+    return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+    return static_cast<uint32_t>(getpid());
+#endif
+}
+
+#if !defined(_WIN32)
+static bool ProcessGone(uint32_t Pid)
+{
+    return (0 != Pid) && (0 != kill(static_cast<pid_t>(Pid), 0)) && (ESRCH == errno);
+}
+
+/***************************************************************
+ * @brief True if a segment this build cannot attach to has no owner left
+ *
+ * The pid is written before the magic and sits at the same offset in every
+ * layout version, so a publisher that died filling the header, or one of
+ * another build, is found dead through it. A segment too short to hold a
+ * pid, or that never got one, is abandoned once it is older than
+ * SHARED_TELEMETRY_RECLAIM_GRACE_SEC; a live publisher fills the header
+ * right after creating it.
+ ***************************************************************/
+static bool SharedTelemetryUnreadableStale(const char *pName)
+{
+    char Name[SHARED_TELEMETRY_MAX_NAME + 8];
+    snprintf(Name, sizeof(Name), "/%s", pName);
+    int Fd = shm_open(Name, O_RDONLY, 0);
+    if (Fd < 0)
+    {
+        return false;
+    }
+
+    struct stat Stat;
+    uint32_t Pid  = 0;
+    bool HavePid  = false;
+    bool HaveStat = (0 == fstat(Fd, &Stat));
+    if (HaveStat && (static_cast<size_t>(Stat.st_size) >= offsetof(SharedTelemetryHeader, publisherPid) + sizeof(Pid)))
+    {
+        HavePid = (static_cast<ssize_t>(sizeof(Pid)) == pread(Fd, &Pid, sizeof(Pid), static_cast<off_t>(offsetof(SharedTelemetryHeader, publisherPid))));
+    }
+    close(Fd);
+
+    if (HavePid && (0 != Pid))
+    {
+        return ProcessGone(Pid);
+    }
+    return HaveStat && (difftime(time(nullptr), Stat.st_mtime) >= SHARED_TELEMETRY_RECLAIM_GRACE_SEC);
+}
+#endif
+
+/***************************************************************
+ * @brief True if an existing segment was left behind by a dead or stopped publisher
+ ***************************************************************/
+static bool SharedTelemetryStale(const char *pName)
+{
+#if defined(_WIN32)
+    // Windows removes the mapping with its last handle, an existing one is always live
+    (void)pName;
+    return false;
+#else
+    SharedTelemetryReader Reader;
+    ctl_result_t Result = SharedTelemetryReaderOpen(&Reader, pName);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        // Header never completed or another layout version
+        return ((CTL_RESULT_ERROR_NOT_INITIALIZED == Result) || (CTL_RESULT_ERROR_UNSUPPORTED_VERSION == Result)) && SharedTelemetryUnreadableStale(pName);
+    }
+
+    const SharedTelemetryHeader *pHeader = &Reader.pLayout->header;
+    bool Stopped                         = (SHARED_TELEMETRY_STATE_ACTIVE != pHeader->state.load(std::memory_order_acquire));
+    bool Orphaned                        = ProcessGone(pHeader->publisherPid);
+    SharedTelemetryReaderClose(&Reader);
+    return Stopped || Orphaned;
+#endif
+}
+
+ctl_result_t SharedTelemetryPublisherCreate(SharedTelemetryPublisher *pPublisher, TelemetryCache *pCache, const char *pName)
+{
+    if ((nullptr == pPublisher) || (nullptr == pCache))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pPublisher->pLayout = nullptr;
+    pPublisher->pCache  = pCache;
+    if (nullptr == pName)
+    {
+        pName = SHARED_TELEMETRY_DEFAULT_NAME;
+    }
+
+    ctl_result_t Result = SharedMemoryCreate(pName, sizeof(SharedTelemetryLayout), &pPublisher->region);
+    if ((CTL_RESULT_ERROR_ALREADY_INITIALIZED == Result) && SharedTelemetryStale(pName))
+    {
+#if !defined(_WIN32)
+        char Name[SHARED_TELEMETRY_MAX_NAME + 8];
+        snprintf(Name, sizeof(Name), "/%s", pName);
+        shm_unlink(Name);
+#endif
+        Result = SharedMemoryCreate(pName, sizeof(SharedTelemetryLayout), &pPublisher->region);
+    }
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        return Result;
+    }
+
+    // New mappings are zero filled, so magic reads 0 until the header is complete
+    SharedTelemetryLayout *pLayout = static_cast<SharedTelemetryLayout *>(pPublisher->region.pView);
+    SharedTelemetryHeader *pHeader = &pLayout->header;
+    pHeader->layoutVersion         = SHARED_TELEMETRY_LAYOUT_VERSION;
+    pHeader->headerSize            = sizeof(SharedTelemetryHeader);
+    pHeader->slotSize              = sizeof(SnapshotSlot);
+    pHeader->payloadSize           = sizeof(PublishedSnapshot);
+    pHeader->adapterCount          = pCache->adapterCount;
+    pHeader->periodMs              = pCache->periodMs;
+    pHeader->publisherPid          = CurrentProcessId();
+    pHeader->createdNs             = AgentHostTimeNs();
+    pHeader->state.store(SHARED_TELEMETRY_STATE_ACTIVE, std::memory_order_relaxed);
+
+    for (uint32_t i = 0; i < pCache->adapterCount; i++)
+    {
+        AdapterTopology *pTopology = &pHeader->topology[i];
+        *pTopology                 = pCache->topology[i];
+        pTopology->hDevice         = nullptr;
+        memset(pTopology->hFreq, 0, sizeof(pTopology->hFreq));
+        memset(pTopology->hTemp, 0, sizeof(pTopology->hTemp));
+        memset(pTopology->hFan, 0, sizeof(pTopology->hFan));
+        memset(pTopology->hPower, 0, sizeof(pTopology->hPower));
+        memset(pTopology->hEngine, 0, sizeof(pTopology->hEngine));
+        memset(pTopology->hMemory, 0, sizeof(pTopology->hMemory));
+    }
+
+    Result = TelemetryCacheAttachSlots(pCache, pLayout->slots);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        SharedMemoryClose(&pPublisher->region);
+        return Result;
+    }
+
+    pHeader->magic.store(SHARED_TELEMETRY_MAGIC, std::memory_order_release);
+    pPublisher->pLayout = pLayout;
+    return CTL_RESULT_SUCCESS;
+}
+
+void SharedTelemetryPublisherDestroy(SharedTelemetryPublisher *pPublisher)
+{
+    if ((nullptr == pPublisher) || (nullptr == pPublisher->pLayout))
+    {
+        return;
+    }
+
+    // Readers that still have the segment mapped keep the last snapshots and see the stop
+    pPublisher->pLayout->header.state.store(SHARED_TELEMETRY_STATE_STOPPED, std::memory_order_release);
+    TelemetryCacheAttachSlots(pPublisher->pCache, nullptr);
+
+    SharedMemoryClose(&pPublisher->region);
+    pPublisher->pLayout = nullptr;
+}
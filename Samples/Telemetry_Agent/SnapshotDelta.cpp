@@ -0,0 +1,639 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  SnapshotDelta.cpp
+ * @brief Change only emission of the power telemetry, frequency and temperature.
+ *
+ */
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+#include <math.h>
+#include <string.h>
+
+#include "SnapshotDelta.h"
+
+#if defined(_WIN32)
+#define SNAPSHOT_DELTA_INVALID_SOCKET INVALID_SOCKET
+#define SnapshotDeltaCloseSocket closesocket
+#else
+#define SNAPSHOT_DELTA_INVALID_SOCKET (-1)
+#define SnapshotDeltaCloseSocket close
+#endif
+
+#define SNAPSHOT_DELTA_MIB (1024.0 * 1024.0)
+
+SnapshotDeltaKind SnapshotDeltaFieldKind(SnapshotDeltaField Field)
+{
+    if ((SNAPSHOT_DELTA_FIELD_LIMIT_FLAGS == Field) || ((Field >= SNAPSHOT_DELTA_FIELD_FREQ_THROTTLE_0) && (Field < SNAPSHOT_DELTA_FIELD_TEMPERATURE_0)))
+    {
+        return SNAPSHOT_DELTA_KIND_EXACT;
+    }
+
+    // The telemetry items come first, so the field is also the item id
+    uint32_t ItemId = Field - SNAPSHOT_DELTA_FIELD_ITEM_0;
+    if ((ItemId >= TELEMETRY_ITEM_PSU_ENERGY_0) && (ItemId < TELEMETRY_ITEM_PSU_VOLTAGE_0))
+    {
+        return SNAPSHOT_DELTA_KIND_COUNTER;
+    }
+    switch (ItemId)
+    {
+        case TELEMETRY_ITEM_TIMESTAMP:
+        case TELEMETRY_ITEM_GPU_ENERGY:
+        case TELEMETRY_ITEM_GLOBAL_ACTIVITY:
+        case TELEMETRY_ITEM_RENDER_ACTIVITY:
+        case TELEMETRY_ITEM_MEDIA_ACTIVITY:
+        case TELEMETRY_ITEM_VRAM_ENERGY:
+        case TELEMETRY_ITEM_VRAM_READ_COUNTER:
+        case TELEMETRY_ITEM_VRAM_WRITE_COUNTER:
+        case TELEMETRY_ITEM_CARD_ENERGY:
+            return SNAPSHOT_DELTA_KIND_COUNTER;
+        default:
+            return SNAPSHOT_DELTA_KIND_LEVEL;
+    }
+}
+
+/***************************************************************
+ * @brief Deadband of a telemetry item, in its base unit
+ ***************************************************************/
+static double SnapshotDeltaItemDeadband(uint32_t ItemId)
+{
+    if ((ItemId >= TELEMETRY_ITEM_PSU_ENERGY_0) && (ItemId < TELEMETRY_ITEM_PSU_VOLTAGE_0))
+    {
+        return 1.0;
+    }
+    if ((ItemId >= TELEMETRY_ITEM_PSU_VOLTAGE_0) && (ItemId < TELEMETRY_ITEM_FAN_SPEED_0))
+    {
+        return 0.02;
+    }
+    if (ItemId >= TELEMETRY_ITEM_FAN_SPEED_0)
+    {
+        return 20.0;
+    }
+    switch (ItemId)
+    {
+        case TELEMETRY_ITEM_TIMESTAMP:
+            return 0.001;
+        case TELEMETRY_ITEM_GPU_ENERGY:
+        case TELEMETRY_ITEM_VRAM_ENERGY:
+        case TELEMETRY_ITEM_CARD_ENERGY:
+            return 1.0;
+        case TELEMETRY_ITEM_GPU_VOLTAGE:
+        case TELEMETRY_ITEM_VRAM_VOLTAGE:
+            return 0.005;
+        case TELEMETRY_ITEM_GLOBAL_ACTIVITY:
+        case TELEMETRY_ITEM_RENDER_ACTIVITY:
+        case TELEMETRY_ITEM_MEDIA_ACTIVITY:
+            return 0.005;
+        case TELEMETRY_ITEM_VRAM_READ_COUNTER:
+        case TELEMETRY_ITEM_VRAM_WRITE_COUNTER:
+            return 64.0 * SNAPSHOT_DELTA_MIB;
+        case TELEMETRY_ITEM_GPU_TEMPERATURE:
+        case TELEMETRY_ITEM_VRAM_TEMPERATURE:
+        case TELEMETRY_ITEM_GPU_VR_TEMPERATURE:
+        case TELEMETRY_ITEM_VRAM_VR_TEMPERATURE:
+        case TELEMETRY_ITEM_SA_VR_TEMPERATURE:
+            return 0.5;
+        case TELEMETRY_ITEM_GPU_OVERVOLTAGE_PERCENT:
+        case TELEMETRY_ITEM_GPU_POWER_PERCENT:
+        case TELEMETRY_ITEM_GPU_TEMPERATURE_PERCENT:
+            return 0.5;
+        case TELEMETRY_ITEM_VRAM_READ_BANDWIDTH:
+        case TELEMETRY_ITEM_VRAM_WRITE_BANDWIDTH:
+            return 100.0;
+        default:
+            // Frequencies, in megahertz
+            return 1.0;
+    }
+}
+
+void SnapshotDeltaDefaultConfig(SnapshotDeltaConfig *pConfig)
+{
+    pConfig->keyframeSec = SNAPSHOT_DELTA_DEFAULT_KEYFRAME_SEC;
+    for (uint32_t f = 0; f < SNAPSHOT_DELTA_FIELD_COUNT; f++)
+    {
+        if (f < TELEMETRY_ITEM_COUNT)
+        {
+            pConfig->deadband[f] = SnapshotDeltaItemDeadband(f);
+        }
+        else if (f < SNAPSHOT_DELTA_FIELD_TEMPERATURE_0)
+        {
+            // Clocks in megahertz, the flags are exact
+            pConfig->deadband[f] = 1.0;
+        }
+        else
+        {
+            pConfig->deadband[f] = 0.5;
+        }
+    }
+}
+
+void SnapshotDeltaFieldLabel(SnapshotDeltaField Field, char *pBuffer, size_t BufferSize)
+{
+    if (Field < SNAPSHOT_DELTA_FIELD_LIMIT_FLAGS)
+    {
+        TelemetryItemLabel(Field - SNAPSHOT_DELTA_FIELD_ITEM_0, pBuffer, BufferSize);
+    }
+    else if (Field == SNAPSHOT_DELTA_FIELD_LIMIT_FLAGS)
+    {
+        snprintf(pBuffer, BufferSize, "limit_flags");
+    }
+    else if (Field < SNAPSHOT_DELTA_FIELD_FREQ_REQUEST_0)
+    {
+        snprintf(pBuffer, BufferSize, "freq%u_actual", Field - SNAPSHOT_DELTA_FIELD_FREQ_ACTUAL_0);
+    }
+    else if (Field < SNAPSHOT_DELTA_FIELD_FREQ_THROTTLE_0)
+    {
+        snprintf(pBuffer, BufferSize, "freq%u_request", Field - SNAPSHOT_DELTA_FIELD_FREQ_REQUEST_0);
+    }
+    else if (Field < SNAPSHOT_DELTA_FIELD_TEMPERATURE_0)
+    {
+        snprintf(pBuffer, BufferSize, "freq%u_throttle_reasons", Field - SNAPSHOT_DELTA_FIELD_FREQ_THROTTLE_0);
+    }
+    else if (Field < SNAPSHOT_DELTA_FIELD_COUNT)
+    {
+        snprintf(pBuffer, BufferSize, "temperature%u", Field - SNAPSHOT_DELTA_FIELD_TEMPERATURE_0);
+    }
+    else
+    {
+        snprintf(pBuffer, BufferSize, "unknown");
+    }
+}
+
+static void SnapshotDeltaListener(const AdapterSnapshot *pPrevious, const PublishedSnapshot *pCurrent, void *pContext)
+{
+    (void)pPrevious;
+    SnapshotDeltaUpdate(static_cast<SnapshotDeltaEncoder *>(pContext), pCurrent);
+}
+
+ctl_result_t SnapshotDeltaInit(SnapshotDeltaEncoder *pEncoder, TelemetryCache *pCache, const SnapshotDeltaConfig *pConfig)
+{
+    if ((nullptr == pEncoder) || (nullptr == pCache))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (nullptr != pConfig)
+    {
+        if (pConfig->keyframeSec < 0.0)
+        {
+            return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+        for (uint32_t f = 0; f < SNAPSHOT_DELTA_FIELD_COUNT; f++)
+        {
+            if (!(pConfig->deadband[f] >= 0.0))
+            {
+                return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+            }
+        }
+        pEncoder->config = *pConfig;
+    }
+    else
+    {
+        SnapshotDeltaDefaultConfig(&pEncoder->config);
+    }
+
+    pEncoder->pCache    = pCache;
+    pEncoder->sinkCount = 0;
+    for (uint32_t a = 0; a < AGENT_MAX_ADAPTERS; a++)
+    {
+        SnapshotDeltaMirrorReset(&pEncoder->mirrors[a]);
+        pEncoder->lastKeyframeNs[a] = 0;
+    }
+    {
+        std::lock_guard<std::mutex> Guard(pEncoder->statsLock);
+        memset(pEncoder->stats, 0, sizeof(pEncoder->stats));
+        for (uint32_t a = 0; a < AGENT_MAX_ADAPTERS; a++)
+        {
+            pEncoder->stats[a].adapterIndex = a;
+        }
+    }
+
+    return TelemetryCacheAddListener(pCache, SnapshotDeltaListener, pEncoder);
+}
+
+ctl_result_t SnapshotDeltaAddSink(SnapshotDeltaEncoder *pEncoder, SnapshotDeltaSink pfnSink, void *pContext)
+{
+    if ((nullptr == pEncoder) || (nullptr == pfnSink))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (pEncoder->sinkCount >= SNAPSHOT_DELTA_MAX_SINKS)
+    {
+        return CTL_RESULT_ERROR_INVALID_SIZE;
+    }
+
+    pEncoder->pfnSinks[pEncoder->sinkCount]      = pfnSink;
+    pEncoder->pSinkContexts[pEncoder->sinkCount] = pContext;
+    pEncoder->sinkCount++;
+    return CTL_RESULT_SUCCESS;
+}
+
+void SnapshotDeltaMirrorReset(SnapshotDeltaMirror *pMirror)
+{
+    memset(pMirror, 0, sizeof(*pMirror));
+}
+
+void SnapshotDeltaMirrorApply(SnapshotDeltaMirror *pMirror, const SnapshotDeltaFrame *pFrame)
+{
+    // Fields no longer valid are forgotten, so they are sent again in full
+    pMirror->validMask &= pFrame->validMask;
+    pMirror->historyMask &= pFrame->validMask;
+
+    for (uint32_t i = 0; i < pFrame->count; i++)
+    {
+        const SnapshotDeltaEntry *pEntry = &pFrame->entries[i];
+        if (pEntry->field >= SNAPSHOT_DELTA_FIELD_COUNT)
+        {
+            continue;
+        }
+
+        SnapshotDeltaField Field = static_cast<SnapshotDeltaField>(pEntry->field);
+        uint64_t Bit             = SNAPSHOT_DELTA_FIELD_BIT(Field);
+
+        // A counter that went backwards was reset, the line before it is meaningless
+        bool Extend = (0 != (pMirror->validMask & Bit)) && (SNAPSHOT_DELTA_KIND_COUNTER == SnapshotDeltaFieldKind(Field)) && (pEntry->value >= pMirror->value[Field]) &&
+                      (pFrame->hostTimestampNs > pMirror->valueNs[Field]);
+        if (Extend)
+        {
+            pMirror->previous[Field]   = pMirror->value[Field];
+            pMirror->previousNs[Field] = pMirror->valueNs[Field];
+            pMirror->historyMask |= Bit;
+        }
+        else
+        {
+            pMirror->historyMask &= ~Bit;
+        }
+        pMirror->value[Field]   = pEntry->value;
+        pMirror->valueNs[Field] = pFrame->hostTimestampNs;
+        pMirror->validMask |= Bit;
+    }
+}
+
+double SnapshotDeltaMirrorValue(const SnapshotDeltaMirror *pMirror, SnapshotDeltaField Field, uint64_t AtNs)
+{
+    if ((Field >= SNAPSHOT_DELTA_FIELD_COUNT) || (0 == (pMirror->validMask & SNAPSHOT_DELTA_FIELD_BIT(Field))))
+    {
+        return 0.0;
+    }
+    if (0 == (pMirror->historyMask & SNAPSHOT_DELTA_FIELD_BIT(Field)))
+    {
+        return pMirror->value[Field];
+    }
+
+    double SpanNs  = static_cast<double>(pMirror->valueNs[Field] - pMirror->previousNs[Field]);
+    double SinceNs = static_cast<double>(AtNs) - static_cast<double>(pMirror->valueNs[Field]);
+    return pMirror->value[Field] + (pMirror->value[Field] - pMirror->previous[Field]) * SinceNs / SpanNs;
+}
+
+/***************************************************************
+ * @brief Flattens the fields of one pass, returning the valid mask
+ ***************************************************************/
+static uint64_t SnapshotDeltaSample(const AdapterSnapshot *pSnapshot, double *pValues)
+{
+    uint64_t ValidMask = 0;
+    if (CTL_RESULT_SUCCESS == pSnapshot->telemetryResult)
+    {
+        for (uint32_t i = 0; i < TELEMETRY_ITEM_COUNT; i++)
+        {
+            pValues[SNAPSHOT_DELTA_FIELD_ITEM_0 + i] = pSnapshot->telemetryValues[i];
+        }
+        ValidMask |= pSnapshot->telemetryValidMask << SNAPSHOT_DELTA_FIELD_ITEM_0;
+
+        const ctl_power_telemetry_t *pTelemetry = &pSnapshot->telemetry;
+        uint32_t Flags                          = 0;
+        Flags |= pTelemetry->gpuPowerLimited ? SNAPSHOT_DELTA_LIMIT_POWER : 0;
+        Flags |= pTelemetry->gpuTemperatureLimited ? SNAPSHOT_DELTA_LIMIT_TEMPERATURE : 0;
+        Flags |= pTelemetry->gpuCurrentLimited ? SNAPSHOT_DELTA_LIMIT_CURRENT : 0;
+        Flags |= pTelemetry->gpuVoltageLimited ? SNAPSHOT_DELTA_LIMIT_VOLTAGE : 0;
+        Flags |= pTelemetry->gpuUtilizationLimited ? SNAPSHOT_DELTA_LIMIT_UTILIZATION : 0;
+        pValues[SNAPSHOT_DELTA_FIELD_LIMIT_FLAGS] = static_cast<double>(Flags);
+        ValidMask |= SNAPSHOT_DELTA_FIELD_BIT(SNAPSHOT_DELTA_FIELD_LIMIT_FLAGS);
+    }
+
+    for (uint32_t d = 0; d < AGENT_MAX_FREQ_DOMAINS; d++)
+    {
+        if (0 == (pSnapshot->freqValidMask & CTL_BIT(d)))
+        {
+            continue;
+        }
+        pValues[SNAPSHOT_DELTA_FIELD_FREQ_ACTUAL_0 + d]   = pSnapshot->freqState[d].actual;
+        pValues[SNAPSHOT_DELTA_FIELD_FREQ_REQUEST_0 + d]  = pSnapshot->freqState[d].request;
+        pValues[SNAPSHOT_DELTA_FIELD_FREQ_THROTTLE_0 + d] = static_cast<double>(pSnapshot->freqState[d].throttleReasons);
+        ValidMask |= SNAPSHOT_DELTA_FIELD_BIT(SNAPSHOT_DELTA_FIELD_FREQ_ACTUAL_0 + d) | SNAPSHOT_DELTA_FIELD_BIT(SNAPSHOT_DELTA_FIELD_FREQ_REQUEST_0 + d) |
+                     SNAPSHOT_DELTA_FIELD_BIT(SNAPSHOT_DELTA_FIELD_FREQ_THROTTLE_0 + d);
+    }
+
+    for (uint32_t s = 0; s < AGENT_MAX_TEMP_SENSORS; s++)
+    {
+        if (0 != (pSnapshot->tempValidMask & CTL_BIT(s)))
+        {
+            pValues[SNAPSHOT_DELTA_FIELD_TEMPERATURE_0 + s] = pSnapshot->temperature[s];
+            ValidMask |= SNAPSHOT_DELTA_FIELD_BIT(SNAPSHOT_DELTA_FIELD_TEMPERATURE_0 + s);
+        }
+    }
+    return ValidMask;
+}
+
+/***************************************************************
+ * @brief Whether downstream must be told the value of a field
+ ***************************************************************/
+static bool SnapshotDeltaChanged(const SnapshotDeltaMirror *pMirror, SnapshotDeltaField Field, double Value, double Deadband, uint64_t AtNs)
+{
+    if (0 == (pMirror->validMask & SNAPSHOT_DELTA_FIELD_BIT(Field)))
+    {
+        return true;
+    }
+
+    switch (SnapshotDeltaFieldKind(Field))
+    {
+        case SNAPSHOT_DELTA_KIND_EXACT:
+            return Value != pMirror->value[Field];
+        case SNAPSHOT_DELTA_KIND_COUNTER:
+            return (Value < pMirror->value[Field]) || (fabs(Value - SnapshotDeltaMirrorValue(pMirror, Field, AtNs)) > Deadband);
+        default:
+            return fabs(Value - pMirror->value[Field]) > Deadband;
+    }
+}
+
+void SnapshotDeltaUpdate(SnapshotDeltaEncoder *pEncoder, const PublishedSnapshot *pCurrent)
+{
+    const AdapterSnapshot *pSnapshot = &pCurrent->snapshot;
+    uint32_t Adapter                 = pSnapshot->adapterIndex;
+    if (Adapter >= AGENT_MAX_ADAPTERS)
+    {
+        return;
+    }
+
+    double Values[SNAPSHOT_DELTA_FIELD_COUNT];
+    uint64_t ValidMask           = SnapshotDeltaSample(pSnapshot, Values);
+    uint64_t NowNs               = pSnapshot->hostTimestampNs;
+    SnapshotDeltaMirror *pMirror = &pEncoder->mirrors[Adapter];
+    uint64_t KeyframeNs          = static_cast<uint64_t>(pEncoder->config.keyframeSec * 1e9);
+    bool Keyframe                = (0 == pEncoder->lastKeyframeNs[Adapter]) || ((0 != KeyframeNs) && (NowNs - pEncoder->lastKeyframeNs[Adapter] >= KeyframeNs));
+
+    SnapshotDeltaFrame *pFrame = &pEncoder->frame;
+    pFrame->adapterIndex       = Adapter;
+    pFrame->keyframe           = Keyframe;
+    pFrame->sequence           = pSnapshot->sequence;
+    pFrame->hostTimestampNs    = NowNs;
+    pFrame->validMask          = ValidMask;
+    pFrame->count              = 0;
+    uint32_t Sampled           = 0;
+    for (uint32_t f = 0; f < SNAPSHOT_DELTA_FIELD_COUNT; f++)
+    {
+        if (0 == (ValidMask & SNAPSHOT_DELTA_FIELD_BIT(f)))
+        {
+            continue;
+        }
+        Sampled++;
+
+        SnapshotDeltaField Field = static_cast<SnapshotDeltaField>(f);
+        if (Keyframe || SnapshotDeltaChanged(pMirror, Field, Values[f], pEncoder->config.deadband[f], NowNs))
+        {
+            pFrame->entries[pFrame->count].field = static_cast<uint8_t>(f);
+            pFrame->entries[pFrame->count].value = Values[f];
+            pFrame->count++;
+        }
+    }
+
+    // A field that stopped being valid is news even when nothing else changed
+    bool Emit   = (0 != pFrame->count) || (ValidMask != pMirror->validMask);
+    size_t Size = 0;
+    if (Emit)
+    {
+        SnapshotDeltaMirrorApply(pMirror, pFrame);
+        if (Keyframe)
+        {
+            pEncoder->lastKeyframeNs[Adapter] = NowNs;
+        }
+        Size = SnapshotDeltaEncode(pFrame, pEncoder->wire, sizeof(pEncoder->wire));
+        for (uint32_t s = 0; s < pEncoder->sinkCount; s++)
+        {
+            pEncoder->pfnSinks[s](pFrame, pEncoder->wire, Size, pEncoder->pSinkContexts[s]);
+        }
+    }
+
+    std::lock_guard<std::mutex> Guard(pEncoder->statsLock);
+    SnapshotDeltaStats *pStats = &pEncoder->stats[Adapter];
+    pStats->passes++;
+    pStats->frames += Emit ? 1 : 0;
+    pStats->keyframes += (Emit && Keyframe) ? 1 : 0;
+    pStats->fieldsSampled += Sampled;
+    pStats->fieldsSent += pFrame->count;
+    pStats->wireBytes += Size;
+    pStats->fullWireBytes += SNAPSHOT_DELTA_WIRE_SIZE(Sampled);
+}
+
+ctl_result_t SnapshotDeltaRead(SnapshotDeltaEncoder *pEncoder, uint32_t AdapterIndex, SnapshotDeltaStats *pStats)
+{
+    if ((nullptr == pEncoder) || (nullptr == pStats))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (AdapterIndex >= AGENT_MAX_ADAPTERS)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pEncoder->statsLock);
+    *pStats = pEncoder->stats[AdapterIndex];
+    return CTL_RESULT_SUCCESS;
+}
+
+static void WirePut(uint8_t *pBuffer, uint64_t Value, uint32_t Bytes)
+{
+    for (uint32_t i = 0; i < Bytes; i++)
+    {
+        pBuffer[i] = static_cast<uint8_t>(Value >> (8 * i));
+    }
+}
+
+static uint64_t WireGet(const uint8_t *pBuffer, uint32_t Bytes)
+{
+    uint64_t Value = 0;
+    for (uint32_t i = 0; i < Bytes; i++)
+    {
+        Value |= static_cast<uint64_t>(pBuffer[i]) << (8 * i);
+    }
+    return Value;
+}
+
+size_t SnapshotDeltaEncode(const SnapshotDeltaFrame *pFrame, uint8_t *pBuffer, size_t BufferSize)
+{
+    size_t Size = SNAPSHOT_DELTA_WIRE_SIZE(pFrame->count);
+    if ((pFrame->count > SNAPSHOT_DELTA_FIELD_COUNT) || (BufferSize < Size))
+    {
+        return 0;
+    }
+
+    WirePut(pBuffer + 0, SNAPSHOT_DELTA_WIRE_MAGIC, 4);
+    WirePut(pBuffer + 4, SNAPSHOT_DELTA_WIRE_VERSION, 2);
+    WirePut(pBuffer + 6, pFrame->keyframe ? SNAPSHOT_DELTA_FLAG_KEYFRAME : 0, 2);
+    WirePut(pBuffer + 8, pFrame->adapterIndex, 4);
+    WirePut(pBuffer + 12, pFrame->count, 4);
+    WirePut(pBuffer + 16, pFrame->sequence, 8);
+    WirePut(pBuffer + 24, pFrame->hostTimestampNs, 8);
+    WirePut(pBuffer + 32, pFrame->validMask, 8);
+
+    uint8_t *pEntry = pBuffer + SNAPSHOT_DELTA_WIRE_HEADER_SIZE;
+    for (uint32_t i = 0; i < pFrame->count; i++)
+    {
+        uint64_t Bits;
+        memcpy(&Bits, &pFrame->entries[i].value, sizeof(Bits));
+        pEntry[0] = pFrame->entries[i].field;
+        WirePut(pEntry + 1, Bits, 8);
+        pEntry += SNAPSHOT_DELTA_WIRE_ENTRY_SIZE;
+    }
+    return Size;
+}
+
+ctl_result_t SnapshotDeltaDecode(const uint8_t *pBuffer, size_t Size, SnapshotDeltaFrame *pFrame)
+{
+    if ((nullptr == pBuffer) || (nullptr == pFrame))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((Size < SNAPSHOT_DELTA_WIRE_HEADER_SIZE) || (SNAPSHOT_DELTA_WIRE_MAGIC != WireGet(pBuffer, 4)))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+    if (SNAPSHOT_DELTA_WIRE_VERSION != WireGet(pBuffer + 4, 2))
+    {
+        return CTL_RESULT_ERROR_UNSUPPORTED_VERSION;
+    }
+
+    uint64_t Count = WireGet(pBuffer + 12, 4);
+    if ((Count > SNAPSHOT_DELTA_FIELD_COUNT) || (Size != SNAPSHOT_DELTA_WIRE_SIZE(Count)))
+    {
+        return CTL_RESULT_ERROR_INVALID_SIZE;
+    }
+
+    pFrame->keyframe        = 0 != (WireGet(pBuffer + 6, 2) & SNAPSHOT_DELTA_FLAG_KEYFRAME);
+    pFrame->adapterIndex    = static_cast<uint32_t>(WireGet(pBuffer + 8, 4));
+    pFrame->count           = static_cast<uint32_t>(Count);
+    pFrame->sequence        = WireGet(pBuffer + 16, 8);
+    pFrame->hostTimestampNs = WireGet(pBuffer + 24, 8);
+    pFrame->validMask       = WireGet(pBuffer + 32, 8);
+
+    const uint8_t *pEntry = pBuffer + SNAPSHOT_DELTA_WIRE_HEADER_SIZE;
+    for (uint32_t i = 0; i < pFrame->count; i++)
+    {
+        if (pEntry[0] >= SNAPSHOT_DELTA_FIELD_COUNT)
+        {
+            return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+        uint64_t Bits            = WireGet(pEntry + 1, 8);
+        pFrame->entries[i].field = pEntry[0];
+        memcpy(&pFrame->entries[i].value, &Bits, sizeof(Bits));
+        pEntry += SNAPSHOT_DELTA_WIRE_ENTRY_SIZE;
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+void SnapshotDeltaLogSink(const SnapshotDeltaFrame *pFrame, const uint8_t *pWire, size_t WireSize, void *pContext)
+{
+    (void)pWire;
+    (void)WireSize;
+    FILE *pFile = static_cast<FILE *>(pContext);
+
+    fprintf(pFile, "%.6f adapter=%u seq=%llu %s valid=0x%016llx", static_cast<double>(pFrame->hostTimestampNs) / 1e9, pFrame->adapterIndex,
+            static_cast<unsigned long long>(pFrame->sequence), pFrame->keyframe ? "key" : "delta", static_cast<unsigned long long>(pFrame->validMask));
+    for (uint32_t i = 0; i < pFrame->count; i++)
+    {
+        char Label[32];
+        SnapshotDeltaFieldLabel(static_cast<SnapshotDeltaField>(pFrame->entries[i].field), Label, sizeof(Label));
+        fprintf(pFile, " %s=%.9g", Label, pFrame->entries[i].value);
+    }
+    fputc('\n', pFile);
+}
+
+ctl_result_t SnapshotDeltaUdpSinkOpen(SnapshotDeltaUdpSink *pSink, const char *pAddress, uint16_t Port)
+{
+    if ((nullptr == pSink) || (nullptr == pAddress))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    pSink->socket     = SNAPSHOT_DELTA_INVALID_SOCKET;
+    pSink->datagrams  = 0;
+    pSink->sendErrors = 0;
+
+    struct sockaddr_in Address = {};
+    Address.sin_family         = AF_INET;
+    Address.sin_port           = htons(Port);
+    if (1 != inet_pton(AF_INET, pAddress, &Address.sin_addr))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+#if defined(_WIN32)
+    WSADATA WsaData;
+    if (0 != WSAStartup(MAKEWORD(2, 2), &WsaData))
+    {
+        return CTL_RESULT_ERROR_NOT_INITIALIZED;
+    }
+#endif
+
+    // Connected, so every frame is a plain send and ICMP errors surface there
+    pSink->socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (SNAPSHOT_DELTA_INVALID_SOCKET == pSink->socket)
+    {
+#if defined(_WIN32)
+        WSACleanup();
+#endif
+        return CTL_RESULT_ERROR_UNKNOWN;
+    }
+    if (0 != connect(pSink->socket, reinterpret_cast<struct sockaddr *>(&Address), sizeof(Address)))
+    {
+        SnapshotDeltaUdpSinkClose(pSink);
+        return CTL_RESULT_ERROR_UNKNOWN;
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+void SnapshotDeltaUdpSend(const SnapshotDeltaFrame *pFrame, const uint8_t *pWire, size_t WireSize, void *pContext)
+{
+    (void)pFrame;
+    SnapshotDeltaUdpSink *pSink = static_cast<SnapshotDeltaUdpSink *>(pContext);
+    if ((SNAPSHOT_DELTA_INVALID_SOCKET == pSink->socket) || (0 == WireSize))
+    {
+        return;
+    }
+
+    int Sent = send(pSink->socket, reinterpret_cast<const char *>(pWire), static_cast<int>(WireSize), 0);
+    if (Sent == static_cast<int>(WireSize))
+    {
+        pSink->datagrams++;
+    }
+    else
+    {
+        pSink->sendErrors++;
+    }
+}
+
+void SnapshotDeltaUdpSinkClose(SnapshotDeltaUdpSink *pSink)
+{
+    if ((nullptr == pSink) || (SNAPSHOT_DELTA_INVALID_SOCKET == pSink->socket))
+    {
+        return;
+    }
+
+    SnapshotDeltaCloseSocket(pSink->socket);
+    pSink->socket = SNAPSHOT_DELTA_INVALID_SOCKET;
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+}
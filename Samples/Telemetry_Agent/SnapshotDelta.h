@@ -0,0 +1,258 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  SnapshotDelta.h
+ * @brief Change only emission of the power telemetry, frequency and temperature.
+ *
+ * An idle adapter reports almost the same ctl_power_telemetry_t, frequency
+ * state and temperatures on every pass, yet shipping each pass in full costs
+ * the same bytes as a busy one. A listener on the telemetry cache flattens
+ * those into SNAPSHOT_DELTA_FIELD_COUNT fields and compares each pass with
+ * what downstream already holds, emitting a frame with the changed fields
+ * only.
+ *
+ * What downstream holds is kept in a SnapshotDeltaMirror that the encoder
+ * and every receiver update from the same frames, so both sides agree on
+ * the value of a field without a round trip:
+ *  - a level, e.g. a voltage or a clock, holds the value last sent and is
+ *    sent again once it moves by more than its deadband;
+ *  - a counter, e.g. an energy counter, is extrapolated along the line
+ *    through the last two values sent and is sent again once the reading is
+ *    off that line by more than its deadband, so a steady load costs
+ *    nothing however fast the counter runs;
+ *  - flags are sent on any change.
+ * A field that becomes valid is always sent, and every keyframeSec a
+ * keyframe carries every valid field so a receiver joining late, or one
+ * that lost a datagram, converges.
+ *
+ * Frames go to up to SNAPSHOT_DELTA_MAX_SINKS sinks, each given the frame
+ * and its little endian wire encoding. A text log and a UDP sink are
+ * provided. The latest state in full is already published by the shared
+ * memory publisher, so no shared memory sink is needed.
+ *
+ */
+
+#pragma once
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#endif
+#include <mutex>
+#include <stdio.h>
+
+#include "TelemetryCache.h"
+
+#define SNAPSHOT_DELTA_MAX_SINKS 4
+#define SNAPSHOT_DELTA_DEFAULT_KEYFRAME_SEC 10.0
+#define SNAPSHOT_DELTA_WIRE_MAGIC 0x44534749u ///< "IGSD"
+#define SNAPSHOT_DELTA_WIRE_VERSION 1
+#define SNAPSHOT_DELTA_WIRE_HEADER_SIZE 40
+#define SNAPSHOT_DELTA_WIRE_ENTRY_SIZE 9 ///< Field id and a double
+#define SNAPSHOT_DELTA_WIRE_SIZE(Count) (SNAPSHOT_DELTA_WIRE_HEADER_SIZE + (Count)*SNAPSHOT_DELTA_WIRE_ENTRY_SIZE)
+#define SNAPSHOT_DELTA_FLAG_KEYFRAME 0x1
+
+/***************************************************************
+ * @brief Identifies a field, also its bit in the valid masks
+ *
+ * The first TELEMETRY_ITEM_COUNT fields are the decoded telemetry items.
+ ***************************************************************/
+enum SnapshotDeltaField
+{
+    SNAPSHOT_DELTA_FIELD_ITEM_0          = 0,
+    SNAPSHOT_DELTA_FIELD_LIMIT_FLAGS     = SNAPSHOT_DELTA_FIELD_ITEM_0 + TELEMETRY_ITEM_COUNT, ///< SNAPSHOT_DELTA_LIMIT_ bits of the gpu*Limited flags
+    SNAPSHOT_DELTA_FIELD_FREQ_ACTUAL_0   = SNAPSHOT_DELTA_FIELD_LIMIT_FLAGS + 1,               ///< Megahertz, per frequency domain
+    SNAPSHOT_DELTA_FIELD_FREQ_REQUEST_0  = SNAPSHOT_DELTA_FIELD_FREQ_ACTUAL_0 + AGENT_MAX_FREQ_DOMAINS,
+    SNAPSHOT_DELTA_FIELD_FREQ_THROTTLE_0 = SNAPSHOT_DELTA_FIELD_FREQ_REQUEST_0 + AGENT_MAX_FREQ_DOMAINS,  ///< throttleReasons, per frequency domain
+    SNAPSHOT_DELTA_FIELD_TEMPERATURE_0   = SNAPSHOT_DELTA_FIELD_FREQ_THROTTLE_0 + AGENT_MAX_FREQ_DOMAINS, ///< Celsius, per temperature sensor
+    SNAPSHOT_DELTA_FIELD_COUNT           = SNAPSHOT_DELTA_FIELD_TEMPERATURE_0 + AGENT_MAX_TEMP_SENSORS
+};
+
+static_assert(SNAPSHOT_DELTA_FIELD_COUNT <= 64, "field masks are 64 bits wide");
+
+#define SNAPSHOT_DELTA_FIELD_BIT(Field) (1ull << (Field))
+
+#define SNAPSHOT_DELTA_LIMIT_POWER CTL_BIT(0)
+#define SNAPSHOT_DELTA_LIMIT_TEMPERATURE CTL_BIT(1)
+#define SNAPSHOT_DELTA_LIMIT_CURRENT CTL_BIT(2)
+#define SNAPSHOT_DELTA_LIMIT_VOLTAGE CTL_BIT(3)
+#define SNAPSHOT_DELTA_LIMIT_UTILIZATION CTL_BIT(4)
+
+enum SnapshotDeltaKind
+{
+    SNAPSHOT_DELTA_KIND_LEVEL = 0, ///< Sent when it moves by more than the deadband from the value last sent
+    SNAPSHOT_DELTA_KIND_COUNTER,   ///< Sent when it leaves the line through the last two values sent by more than the deadband
+    SNAPSHOT_DELTA_KIND_EXACT      ///< Sent on any change, the deadband is ignored
+};
+
+struct SnapshotDeltaConfig
+{
+    double keyframeSec;                          ///< 0 sends a keyframe only on the first pass
+    double deadband[SNAPSHOT_DELTA_FIELD_COUNT]; ///< In the unit of the field, 0 sends any change
+};
+
+struct SnapshotDeltaEntry
+{
+    uint8_t field; ///< SnapshotDeltaField
+    double value;
+};
+
+struct SnapshotDeltaFrame
+{
+    uint32_t adapterIndex;
+    bool keyframe;
+    uint64_t sequence;        ///< Of the pass, from AdapterSnapshot
+    uint64_t hostTimestampNs; ///< Of the pass, counters are extrapolated to it
+    uint64_t validMask;       ///< SNAPSHOT_DELTA_FIELD_BIT of every valid field
+    uint32_t count;
+    SnapshotDeltaEntry entries[SNAPSHOT_DELTA_FIELD_COUNT];
+};
+
+/***************************************************************
+ * @brief Values of one adapter as known downstream
+ ***************************************************************/
+struct SnapshotDeltaMirror
+{
+    uint64_t validMask;
+    uint64_t historyMask; ///< Counters with a previous value to extrapolate from
+    double value[SNAPSHOT_DELTA_FIELD_COUNT];
+    uint64_t valueNs[SNAPSHOT_DELTA_FIELD_COUNT];
+    double previous[SNAPSHOT_DELTA_FIELD_COUNT];
+    uint64_t previousNs[SNAPSHOT_DELTA_FIELD_COUNT];
+};
+
+/***************************************************************
+ * @brief Called from the sampler thread with every frame emitted
+ *
+ * pWire holds WireSize bytes of SnapshotDeltaEncode. Sinks run under the
+ * cache's listener lock and should not block.
+ ***************************************************************/
+typedef void (*SnapshotDeltaSink)(const SnapshotDeltaFrame *pFrame, const uint8_t *pWire, size_t WireSize, void *pContext);
+
+struct SnapshotDeltaStats
+{
+    uint32_t adapterIndex;
+    uint64_t passes;
+    uint64_t frames; ///< Emitted, keyframes included
+    uint64_t keyframes;
+    uint64_t fieldsSampled; ///< Valid fields over every pass
+    uint64_t fieldsSent;
+    uint64_t wireBytes;     ///< Of the frames emitted
+    uint64_t fullWireBytes; ///< Had every pass been a keyframe
+};
+
+struct SnapshotDeltaEncoder
+{
+    const TelemetryCache *pCache;
+    SnapshotDeltaConfig config;
+    uint32_t sinkCount;
+    SnapshotDeltaSink pfnSinks[SNAPSHOT_DELTA_MAX_SINKS];
+    void *pSinkContexts[SNAPSHOT_DELTA_MAX_SINKS];
+    SnapshotDeltaMirror mirrors[AGENT_MAX_ADAPTERS];                    ///< Sampler private
+    uint64_t lastKeyframeNs[AGENT_MAX_ADAPTERS];                        ///< Sampler private, 0 before the first
+    SnapshotDeltaFrame frame;                                           ///< Sampler private
+    uint8_t wire[SNAPSHOT_DELTA_WIRE_SIZE(SNAPSHOT_DELTA_FIELD_COUNT)]; ///< Sampler private
+
+    std::mutex statsLock;
+    SnapshotDeltaStats stats[AGENT_MAX_ADAPTERS];
+};
+
+#if defined(_WIN32)
+typedef SOCKET snapshot_delta_socket_t;
+#else
+typedef int snapshot_delta_socket_t;
+#endif
+
+/***************************************************************
+ * @brief Sends every frame as one datagram to a fixed receiver
+ ***************************************************************/
+struct SnapshotDeltaUdpSink
+{
+    snapshot_delta_socket_t socket;
+    uint64_t datagrams;
+    uint64_t sendErrors;
+};
+
+/***************************************************************
+ * @brief Default deadbands and keyframe interval
+ ***************************************************************/
+void SnapshotDeltaDefaultConfig(SnapshotDeltaConfig *pConfig);
+
+/***************************************************************
+ * @brief Clears every adapter and registers the listener
+ *
+ * pConfig may be nullptr for the defaults. Add the sinks and call before
+ * TelemetryCacheStart.
+ ***************************************************************/
+ctl_result_t SnapshotDeltaInit(SnapshotDeltaEncoder *pEncoder, TelemetryCache *pCache, const SnapshotDeltaConfig *pConfig);
+
+ctl_result_t SnapshotDeltaAddSink(SnapshotDeltaEncoder *pEncoder, SnapshotDeltaSink pfnSink, void *pContext);
+
+/***************************************************************
+ * @brief Compares one pass of an adapter and emits its frame, if any
+ ***************************************************************/
+void SnapshotDeltaUpdate(SnapshotDeltaEncoder *pEncoder, const PublishedSnapshot *pCurrent);
+
+ctl_result_t SnapshotDeltaRead(SnapshotDeltaEncoder *pEncoder, uint32_t AdapterIndex, SnapshotDeltaStats *pStats);
+
+SnapshotDeltaKind SnapshotDeltaFieldKind(SnapshotDeltaField Field);
+
+/***************************************************************
+ * @brief Lower case field name, e.g. gpu_energy or freq0_actual
+ ***************************************************************/
+void SnapshotDeltaFieldLabel(SnapshotDeltaField Field, char *pBuffer, size_t BufferSize);
+
+/***************************************************************
+ * @brief Empties a mirror, as before the first frame
+ ***************************************************************/
+void SnapshotDeltaMirrorReset(SnapshotDeltaMirror *pMirror);
+
+/***************************************************************
+ * @brief Brings a mirror up to date with a frame
+ *
+ * Frames must be applied in order. After a lost frame the mirror may drift
+ * until the next keyframe.
+ ***************************************************************/
+void SnapshotDeltaMirrorApply(SnapshotDeltaMirror *pMirror, const SnapshotDeltaFrame *pFrame);
+
+/***************************************************************
+ * @brief Value of a field at host time AtNs, 0 if it is not valid
+ *
+ * Counters are extrapolated, other fields return the value last sent.
+ ***************************************************************/
+double SnapshotDeltaMirrorValue(const SnapshotDeltaMirror *pMirror, SnapshotDeltaField Field, uint64_t AtNs);
+
+/***************************************************************
+ * @brief Writes a frame in the wire format, returning its size
+ *
+ * Returns 0 when BufferSize is too small.
+ ***************************************************************/
+size_t SnapshotDeltaEncode(const SnapshotDeltaFrame *pFrame, uint8_t *pBuffer, size_t BufferSize);
+
+/***************************************************************
+ * @brief Reads a frame written by SnapshotDeltaEncode
+ ***************************************************************/
+ctl_result_t SnapshotDeltaDecode(const uint8_t *pBuffer, size_t Size, SnapshotDeltaFrame *pFrame);
+
+/***************************************************************
+ * @brief Sink writing one text line per frame to the FILE in pContext
+ ***************************************************************/
+void SnapshotDeltaLogSink(const SnapshotDeltaFrame *pFrame, const uint8_t *pWire, size_t WireSize, void *pContext);
+
+/***************************************************************
+ * @brief Creates the socket of a UDP sink, Address is an IPv4 address
+ ***************************************************************/
+ctl_result_t SnapshotDeltaUdpSinkOpen(SnapshotDeltaUdpSink *pSink, const char *pAddress, uint16_t Port);
+
+/***************************************************************
+ * @brief Sink sending the wire encoding to the SnapshotDeltaUdpSink in pContext
+ ***************************************************************/
+void SnapshotDeltaUdpSend(const SnapshotDeltaFrame *pFrame, const uint8_t *pWire, size_t WireSize, void *pContext);
+
+void SnapshotDeltaUdpSinkClose(SnapshotDeltaUdpSink *pSink);
@@ -0,0 +1,108 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  SnapshotSeqlock.h
+ * @brief Single writer, many reader sequence lock over a word array.
+ *
+ * The writer makes the sequence odd, stores the payload and makes it even
+ * again. A reader copies the payload between two loads of the sequence and
+ * retries if they differ or are odd. Payload words are relaxed atomics so a
+ * torn read is detected and discarded rather than being a data race, and the
+ * same routines work on memory shared between processes.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+#define SEQLOCK_WORDS(Size) (((Size) + sizeof(uint64_t) - 1) / sizeof(uint64_t))
+#define SEQLOCK_SPINS_BEFORE_YIELD 64
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "seqlock words must be lock free");
+
+/***************************************************************
+ * @brief Publishes Size bytes. Only one writer may call this per sequence.
+ ***************************************************************/
+inline void SeqlockWrite(std::atomic<uint64_t> *pSequence, std::atomic<uint64_t> *pWords, const void *pData, size_t Size)
+{
+    uint64_t Sequence = pSequence->load(std::memory_order_relaxed);
+    pSequence->store(Sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const char *pSource = static_cast<const char *>(pData);
+    size_t WordCount    = SEQLOCK_WORDS(Size);
+    for (size_t i = 0; i < WordCount; i++)
+    {
+        uint64_t Word = 0;
+        size_t Offset = i * sizeof(uint64_t);
+        memcpy(&Word, pSource + Offset, ((Size - Offset) < sizeof(uint64_t)) ? (Size - Offset) : sizeof(uint64_t));
+        pWords[i].store(Word, std::memory_order_relaxed);
+    }
+
+    pSequence->store(Sequence + 2, std::memory_order_release);
+}
+
+/***************************************************************
+ * @brief Single read attempt, false if a publish overlapped the copy
+ ***************************************************************/
+inline bool SeqlockTryRead(const std::atomic<uint64_t> *pSequence, const std::atomic<uint64_t> *pWords, void *pData, size_t Size, uint64_t *pVersion)
+{
+    uint64_t Before = pSequence->load(std::memory_order_acquire);
+    if (0 != (Before & 1))
+    {
+        return false;
+    }
+
+    char *pDestination = static_cast<char *>(pData);
+    size_t WordCount   = SEQLOCK_WORDS(Size);
+    for (size_t i = 0; i < WordCount; i++)
+    {
+        uint64_t Word = pWords[i].load(std::memory_order_relaxed);
+        size_t Offset = i * sizeof(uint64_t);
+        memcpy(pDestination + Offset, &Word, ((Size - Offset) < sizeof(uint64_t)) ? (Size - Offset) : sizeof(uint64_t));
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t After = pSequence->load(std::memory_order_relaxed);
+    if (Before != After)
+    {
+        return false;
+    }
+
+    if (nullptr != pVersion)
+    {
+        *pVersion = Before >> 1;
+    }
+    return true;
+}
+
+/***************************************************************
+ * @brief Reads a consistent copy, never blocks the writer.
+ *
+ * Returns the number of attempts that were discarded. The version is the
+ * number of publishes completed when the copy was taken.
+ ***************************************************************/
+inline uint32_t SeqlockRead(const std::atomic<uint64_t> *pSequence, const std::atomic<uint64_t> *pWords, void *pData, size_t Size, uint64_t *pVersion)
+{
+    uint32_t Retries = 0;
+    while (!SeqlockTryRead(pSequence, pWords, pData, Size, pVersion))
+    {
+        // The writer holds the odd state only for the length of one copy
+        if (0 == (++Retries % SEQLOCK_SPINS_BEFORE_YIELD))
+        {
+            std::this_thread::yield();
+        }
+    }
+    return Retries;
+}
@@ -0,0 +1,1727 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  StubRuntime.cpp
+ * @brief Stand-in for the control library runtime used on hosts without it.
+ *
+ * Implements the telemetry subset of the API over a simple analytic load
+ * model so the agent can be built and exercised on Linux, along with the
+ * overclocking properties, the reads and writes of the VF curve and the
+ * power and temperature limits of the V2 overclocking API. The number of
+ * adapters is taken from IGCL_STUB_ADAPTER_COUNT (default 2).
+ *
+ * The GPU runs at the top of the live VF curve, and each adapter has a
+ * seeded margin below the stock curve it is stable at. Under load a curve
+ * past that margin hangs the GPU: telemetry then fails with
+ * CTL_RESULT_ERROR_DEVICE_LOST until ctlOverclockResetToDefault.
+ *
+ * The model advances in fixed ticks of STUB_TICK_SEC, so every value is a
+ * function of the time since ctlInit and the seed only, however often and
+ * in whatever order the API is called. Without a scenario each adapter's
+ * load follows a slow sine. IGCL_STUB_SCENARIO names a scenario file that
+ * drives the load through phases instead, with seeded noise, and sets the
+ * ambient temperature, the thermal time constants, the throttle point and
+ * the width at which the counters wrap; IGCL_STUB_SEED overrides its seed.
+ * See StubScenarioLoad for the format.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "igcl_api.h"
+
+#define STUB_MAX_ADAPTERS 128
+#define STUB_DEFAULT_ADAPTER_COUNT 2
+#define STUB_PI 3.14159265358979323846
+#define STUB_TICK_SEC 0.001 ///< Integration step of the load model
+
+#define STUB_MAX_PHASES 32
+#define STUB_SCENARIO_LINE 256
+#define STUB_DEFAULT_SEED 1
+#define STUB_NOISE_TICKS 50 ///< Ticks between independent noise values, interpolated in between
+
+#define STUB_FREQ_DOMAIN_COUNT 2
+#define STUB_TEMP_SENSOR_COUNT 3
+#define STUB_FAN_COUNT 2
+#define STUB_POWER_DOMAIN_COUNT 1
+#define STUB_ENGINE_GROUP_COUNT 3
+#define STUB_MEM_MODULE_COUNT 1
+
+#define STUB_GPU_MIN_MHZ 300.0
+#define STUB_GPU_MAX_MHZ 2400.0
+#define STUB_GPU_CLOCK_STEP_MHZ 50.0
+#define STUB_MEM_MIN_MHZ 1000.0
+#define STUB_MEM_MAX_MHZ 2000.0
+#define STUB_MEM_CLOCK_STEP_MHZ 500.0
+
+#define STUB_VRAM_SIZE_BYTES (16ull * 1024 * 1024 * 1024)
+#define STUB_VRAM_MAX_BANDWIDTH (512ull * 1000 * 1000 * 1000)
+
+#define STUB_AMBIENT_C 25.0
+#define STUB_THERMAL_TAU_SEC 8.0
+#define STUB_MEM_THERMAL_TAU_SEC 4.0
+#define STUB_THROTTLE_C 90.0              ///< GPU temperature above which the clock backs off
+#define STUB_THERMAL_BACKOFF_PER_SEC 0.5  ///< Clock scale lost per second above the throttle point
+#define STUB_THERMAL_RECOVER_PER_SEC 0.25 ///< And regained per second below it
+#define STUB_THERMAL_MIN_SCALE 0.5
+#define STUB_FAN_MAX_RPM 3000
+#define STUB_FAN_MAX_W 4.0 ///< Drawn from the PSU rails ahead of the card energy counter
+
+#define STUB_PSU_COUNT 3 ///< PCIe slot and two 8 pin inputs, odd adapters leave the second 8 pin unpopulated
+#define STUB_PSU_VOLTS 12.1
+#define STUB_PSU_OHMS 0.012 ///< Cable and connector resistance behind each rail's voltage drop
+
+#define STUB_POWER_DEFAULT_MW 190000
+#define STUB_POWER_MIN_MW 60000
+#define STUB_POWER_MAX_MW 228000
+#define STUB_GPU_STATIC_W 30.0
+#define STUB_DVFS_EXPONENT 2.5 ///< Dynamic power grows with clock to this power
+
+#define STUB_PCI_GEN 4
+#define STUB_PCI_WIDTH 16
+#define STUB_PCI_NARROW_WIDTH 8          ///< Odd adapters train at this width, as in a slot wired narrower than it looks
+#define STUB_PCI_BLOCKED_GEN 3           ///< Fastest generation while ctlAllowPCIeLinkSpeedUpdate blocks higher speeds
+#define STUB_PCI_IDLE_UTILIZATION 0.25   ///< Below this the link power management drops to gen 1
+#define STUB_PCI_RETRAIN_PERIOD_SEC 30.0 ///< At the fastest generation the link retrains at gen 3 once per period
+#define STUB_PCI_RETRAIN_SEC 3.0
+
+#define STUB_ECC_WRITE_MS 250 ///< ctlEccSetState takes this long, as a firmware write would
+
+#define STUB_VF_POINTS 32 ///< Of the elaborate curve, medium reads every second point and simplified every fourth
+#define STUB_VF_MIN_MV 650
+#define STUB_VF_STEP_MV 15
+#define STUB_VF_LIMIT_MIN_MV 600.0
+#define STUB_VF_LIMIT_MAX_MV 1150.0
+#define STUB_VF_LIMIT_MAX_MHZ 3000.0
+#define STUB_VF_FREQ_STEP_MHZ 15      ///< Applied frequencies are rounded down to this
+#define STUB_OC_MARGIN_MV 40.0        ///< Mean undervolt below the stock curve the silicon runs stable at
+#define STUB_OC_MARGIN_SPREAD_MV 15.0 ///< Seeded spread of that margin across adapters
+#define STUB_OC_HANG_UTILIZATION 0.3  ///< Above this load a curve past the margin hangs the GPU
+#define STUB_TEMP_LIMIT_MIN_C 60.0
+#define STUB_TEMP_LIMIT_MAX_C 100.0
+
+/***************************************************************
+ * @brief Load held or ramped linearly over durationSec
+ ***************************************************************/
+struct StubPhase
+{
+    double durationSec;
+    double utilizationStart;
+    double utilizationEnd;
+    double media; ///< Media engine utilization
+    double noise; ///< Amplitude of the seeded noise added to both
+};
+
+struct StubScenario
+{
+    uint64_t seed;
+    uint32_t adapterCount; ///< 0 leaves it to IGCL_STUB_ADAPTER_COUNT
+    uint32_t phaseCount;   ///< 0 keeps the sine load
+    StubPhase phases[STUB_MAX_PHASES];
+    double cycleSec;   ///< Sum of the phase durations
+    bool loop;         ///< Repeat the phases, otherwise hold the end of the last one
+    double staggerSec; ///< Adapter i runs i times this ahead in the phases
+    double ambientC;
+    double thermalTauSec;
+    double memoryTauSec;
+    double throttleC;
+    double energyWrapJ;     ///< Modulus of the energy counters, 0 never wraps
+    double activityWrapSec; ///< Modulus of the activity counters
+    double byteWrap;        ///< Modulus of the VRAM byte counters
+};
+
+struct _ctl_freq_handle_t
+{
+    struct _ctl_device_adapter_handle_t *pAdapter;
+    uint32_t index;
+    double rangeMin; ///< Set by ctlFrequencySetRange
+    double rangeMax;
+};
+
+struct _ctl_temp_handle_t
+{
+    struct _ctl_device_adapter_handle_t *pAdapter;
+    uint32_t index;
+};
+
+struct _ctl_fan_handle_t
+{
+    struct _ctl_device_adapter_handle_t *pAdapter;
+    uint32_t index;
+    double duty;    ///< 0 to 1
+    bool tableMode; ///< Follows table instead of the default curve
+    ctl_fan_speed_table_t table;
+};
+
+struct _ctl_pwr_handle_t
+{
+    struct _ctl_device_adapter_handle_t *pAdapter;
+    uint32_t index;
+};
+
+struct _ctl_engine_handle_t
+{
+    struct _ctl_device_adapter_handle_t *pAdapter;
+    uint32_t index;
+};
+
+struct _ctl_mem_handle_t
+{
+    struct _ctl_device_adapter_handle_t *pAdapter;
+    uint32_t index;
+};
+
+struct _ctl_device_adapter_handle_t
+{
+    uint32_t index;
+
+    std::mutex lock;
+    uint64_t tick;        ///< Ticks of the model advanced so far
+    double lastUpdateSec; ///< Steady clock time of the last tick
+    double utilization;
+    double mediaUtilization;
+    double gpuEnergyJ;
+    double vramEnergyJ;
+    double globalActiveSec;
+    double renderActiveSec;
+    double mediaActiveSec;
+    double vramReadBytes;
+    double vramWriteBytes;
+    double gpuThrottleSec;
+    double gpuTemperatureC;
+    double memoryTemperatureC;
+    double thermalScale; ///< Below 1 while the GPU backs off above the throttle point
+    double gpuPowerW;
+    double psuEnergyJ[STUB_PSU_COUNT];
+    double psuPowerW[STUB_PSU_COUNT];
+    double rangeScale; ///< Below 1 while the range of the GPU domain caps the clock
+    double clockScale; ///< Below 1 while the sustained limit caps the clock
+    ctl_power_limits_t limits;
+    uint32_t pciWidth;    ///< Trained link width
+    bool pciAllowFastGen; ///< Set by ctlAllowPCIeLinkSpeedUpdate
+    ctl_ecc_state_t eccCurrent;
+    ctl_ecc_state_t eccPending; ///< Set by ctlEccSetState, never becomes current since the stub is not rebooted
+    bool ocWaiver;              ///< Set by ctlOverclockWaiverSet
+    ctl_voltage_frequency_point_t vfLive[STUB_VF_POINTS];
+    double ocMarginMv;        ///< Undervolt below the stock curve this adapter runs stable at
+    double ocClockScale;      ///< Top frequency of the live curve over that of the stock curve
+    double ocVoltageScale;    ///< Voltage at which the live curve reaches its top over that of the stock curve
+    bool ocStable;            ///< Every point of the live curve is within the margin
+    bool hung;                ///< Loaded with an unstable curve, the device is lost until ctlOverclockResetToDefault
+    double temperatureLimitC; ///< Set by ctlOverclockTemperatureLimitSetV2
+
+    _ctl_freq_handle_t freq[STUB_FREQ_DOMAIN_COUNT];
+    _ctl_temp_handle_t temp[STUB_TEMP_SENSOR_COUNT];
+    _ctl_fan_handle_t fan[STUB_FAN_COUNT];
+    _ctl_pwr_handle_t power[STUB_POWER_DOMAIN_COUNT];
+    _ctl_engine_handle_t engine[STUB_ENGINE_GROUP_COUNT];
+    _ctl_mem_handle_t memory[STUB_MEM_MODULE_COUNT];
+};
+
+struct _ctl_api_handle_t
+{
+    uint32_t adapterCount;
+    uint32_t telemetryLatencyUs; ///< Added to every ctlPowerTelemetryGet, 0 unless IGCL_STUB_TELEMETRY_US is set
+    double startSec;             ///< Steady clock time of tick 0
+    double wallStartSec;         ///< Wall clock time of tick 0
+    StubScenario scenario;
+    _ctl_device_adapter_handle_t adapters[STUB_MAX_ADAPTERS];
+};
+
+static const ctl_freq_domain_t StubFreqDomains[STUB_FREQ_DOMAIN_COUNT]    = { CTL_FREQ_DOMAIN_GPU, CTL_FREQ_DOMAIN_MEMORY };
+static const ctl_temp_sensors_t StubTempSensors[STUB_TEMP_SENSOR_COUNT]   = { CTL_TEMP_SENSORS_GLOBAL, CTL_TEMP_SENSORS_GPU, CTL_TEMP_SENSORS_MEMORY };
+static const ctl_engine_group_t StubEngineGroups[STUB_ENGINE_GROUP_COUNT] = { CTL_ENGINE_GROUP_GT, CTL_ENGINE_GROUP_RENDER, CTL_ENGINE_GROUP_MEDIA };
+static const ctl_psu_type_t StubPsuTypes[STUB_PSU_COUNT]                  = { CTL_PSU_TYPE_PSU_PCIE, CTL_PSU_TYPE_PSU_8PIN, CTL_PSU_TYPE_PSU_8PIN };
+
+static std::chrono::steady_clock::time_point StubEpoch = std::chrono::steady_clock::now();
+
+static double StubNowSec()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - StubEpoch).count();
+}
+
+static double StubClamp(double Value, double Min, double Max)
+{
+    return (Value < Min) ? Min : ((Value > Max) ? Max : Value);
+}
+
+/***************************************************************
+ * @brief Reading of a counter that wraps at Modulus, 0 never wraps
+ ***************************************************************/
+static double StubWrap(double Value, double Modulus)
+{
+    return (Modulus > 0.0) ? fmod(Value, Modulus) : Value;
+}
+
+/***************************************************************
+ * @brief Uniform value in [-1, 1) from the seed and a position, splitmix64
+ ***************************************************************/
+static double StubNoiseAt(uint64_t Seed, uint32_t Adapter, uint32_t Channel, uint64_t Index)
+{
+    uint64_t Z = Seed + 0x9E3779B97F4A7C15ull * (Index + 1) + (static_cast<uint64_t>(Adapter) << 40) + (static_cast<uint64_t>(Channel) << 56);
+    Z          = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    Z          = (Z ^ (Z >> 27)) * 0x94D049BB133111EBull;
+    Z          = Z ^ (Z >> 31);
+    return static_cast<double>(Z >> 11) / static_cast<double>(1ull << 52) - 1.0;
+}
+
+/***************************************************************
+ * @brief Noise of a tick, interpolated between values STUB_NOISE_TICKS apart
+ ***************************************************************/
+static double StubNoise(uint64_t Seed, uint32_t Adapter, uint32_t Channel, uint64_t Tick)
+{
+    uint64_t Index  = Tick / STUB_NOISE_TICKS;
+    double Fraction = static_cast<double>(Tick % STUB_NOISE_TICKS) / STUB_NOISE_TICKS;
+    double Low      = StubNoiseAt(Seed, Adapter, Channel, Index);
+    return Low + (StubNoiseAt(Seed, Adapter, Channel, Index + 1) - Low) * Fraction;
+}
+
+static void StubScenarioDefaults(StubScenario *pScenario)
+{
+    memset(pScenario, 0, sizeof(*pScenario));
+    pScenario->seed          = STUB_DEFAULT_SEED;
+    pScenario->loop          = true;
+    pScenario->ambientC      = STUB_AMBIENT_C;
+    pScenario->thermalTauSec = STUB_THERMAL_TAU_SEC;
+    pScenario->memoryTauSec  = STUB_MEM_THERMAL_TAU_SEC;
+    pScenario->throttleC     = STUB_THROTTLE_C;
+}
+
+/***************************************************************
+ * @brief Reads a scenario file over the defaults
+ *
+ * One directive per line, # starts a comment:
+ *   seed <n>
+ *   adapters <n>
+ *   phase <seconds> <utilization> [<utilization at the end> [<media> [<noise>]]]
+ *   loop on|off
+ *   stagger <seconds>
+ *   ambient <celsius>
+ *   thermal_tau <seconds>
+ *   memory_tau <seconds>
+ *   throttle <celsius>
+ *   wrap energy|activity|bytes <modulus in joules, seconds or bytes>
+ * Utilizations are fractions of 0 to 1.
+ ***************************************************************/
+static ctl_result_t StubScenarioLoad(const char *pPath, StubScenario *pScenario)
+{
+    struct StubScenarioScalar
+    {
+        const char *pName;
+        double StubScenario::*pValue;
+        double min;
+    };
+    static const StubScenarioScalar Scalars[] = { { "stagger", &StubScenario::staggerSec, 0.0 },        { "ambient", &StubScenario::ambientC, -40.0 },
+                                                  { "thermal_tau", &StubScenario::thermalTauSec, 0.01 }, { "memory_tau", &StubScenario::memoryTauSec, 0.01 },
+                                                  { "throttle", &StubScenario::throttleC, 0.0 } };
+    static const StubScenarioScalar Wraps[]   = { { "energy", &StubScenario::energyWrapJ, 0.0 }, { "activity", &StubScenario::activityWrapSec, 0.0 }, { "bytes", &StubScenario::byteWrap, 0.0 } };
+
+    FILE *pFile = fopen(pPath, "r");
+    if (nullptr == pFile)
+    {
+        fprintf(stderr, "stub: cannot open scenario %s\n", pPath);
+        return CTL_RESULT_ERROR_NOT_AVAILABLE;
+    }
+
+    char Line[STUB_SCENARIO_LINE];
+    uint32_t LineNumber = 0;
+    bool Valid          = true;
+    while (Valid && (nullptr != fgets(Line, sizeof(Line), pFile)))
+    {
+        LineNumber++;
+        char *pComment = strchr(Line, '#');
+        if (nullptr != pComment)
+        {
+            *pComment = '\0';
+        }
+
+        char Directive[32];
+        char Word[32];
+        double Value;
+        unsigned long long Count;
+        if (1 != sscanf(Line, "%31s", Directive))
+        {
+            continue;
+        }
+
+        Valid = false;
+        if (0 == strcmp(Directive, "seed"))
+        {
+            Valid           = (1 == sscanf(Line, "%*s %llu", &Count));
+            pScenario->seed = Count;
+        }
+        else if (0 == strcmp(Directive, "adapters"))
+        {
+            Valid                   = (1 == sscanf(Line, "%*s %llu", &Count)) && (Count >= 1) && (Count <= STUB_MAX_ADAPTERS);
+            pScenario->adapterCount = static_cast<uint32_t>(Count);
+        }
+        else if (0 == strcmp(Directive, "loop"))
+        {
+            Valid           = (1 == sscanf(Line, "%*s %31s", Word)) && ((0 == strcmp(Word, "on")) || (0 == strcmp(Word, "off")));
+            pScenario->loop = (0 == strcmp(Word, "on"));
+        }
+        else if (0 == strcmp(Directive, "phase"))
+        {
+            StubPhase Phase;
+            int Fields           = sscanf(Line, "%*s %lf %lf %lf %lf %lf", &Phase.durationSec, &Phase.utilizationStart, &Phase.utilizationEnd, &Phase.media, &Phase.noise);
+            Phase.utilizationEnd = (Fields >= 3) ? Phase.utilizationEnd : Phase.utilizationStart;
+            Phase.media          = (Fields >= 4) ? Phase.media : 0.0;
+            Phase.noise          = (Fields >= 5) ? Phase.noise : 0.0;
+            Valid                = (Fields >= 2) && (pScenario->phaseCount < STUB_MAX_PHASES) && (Phase.durationSec > 0.0) && (Phase.utilizationStart >= 0.0) && (Phase.utilizationStart <= 1.0) &&
+                                   (Phase.utilizationEnd >= 0.0) && (Phase.utilizationEnd <= 1.0) && (Phase.media >= 0.0) && (Phase.media <= 1.0) && (Phase.noise >= 0.0);
+            if (Valid)
+            {
+                pScenario->phases[pScenario->phaseCount++] = Phase;
+                pScenario->cycleSec += Phase.durationSec;
+            }
+        }
+        else if (0 == strcmp(Directive, "wrap"))
+        {
+            for (const StubScenarioScalar &Wrap : Wraps)
+            {
+                if ((2 == sscanf(Line, "%*s %31s %lf", Word, &Value)) && (0 == strcmp(Word, Wrap.pName)) && (Value >= Wrap.min))
+                {
+                    pScenario->*Wrap.pValue = Value;
+                    Valid                   = true;
+                }
+            }
+        }
+        else
+        {
+            for (const StubScenarioScalar &Scalar : Scalars)
+            {
+                if ((0 == strcmp(Directive, Scalar.pName)) && (1 == sscanf(Line, "%*s %lf", &Value)) && (Value >= Scalar.min))
+                {
+                    pScenario->*Scalar.pValue = Value;
+                    Valid                     = true;
+                }
+            }
+        }
+    }
+    fclose(pFile);
+
+    if (!Valid)
+    {
+        fprintf(stderr, "stub: %s:%u: not a valid scenario directive\n", pPath, LineNumber);
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+/***************************************************************
+ * @brief Engine and media utilization of an adapter at a tick
+ ***************************************************************/
+static void StubScenarioLoadAt(const StubScenario *pScenario, uint32_t Adapter, uint64_t Tick, double *pUtilization, double *pMedia)
+{
+    double Sec   = Tick * STUB_TICK_SEC;
+    double Phase = 0.7 * Adapter;
+    if (0 == pScenario->phaseCount)
+    {
+        *pUtilization = StubClamp(0.55 + 0.35 * sin(2.0 * STUB_PI * Sec / 20.0 + Phase), 0.0, 1.0);
+        *pMedia       = StubClamp(0.30 + 0.25 * sin(2.0 * STUB_PI * Sec / 7.0 + Phase), 0.0, 1.0);
+        return;
+    }
+
+    double At = Sec + pScenario->staggerSec * Adapter;
+    At        = pScenario->loop ? fmod(At, pScenario->cycleSec) : At;
+
+    // Past the end of a scenario that does not loop, the last phase holds its end
+    uint32_t Index  = 0;
+    double Fraction = 1.0;
+    for (; Index < pScenario->phaseCount; Index++)
+    {
+        if (At < pScenario->phases[Index].durationSec)
+        {
+            Fraction = At / pScenario->phases[Index].durationSec;
+            break;
+        }
+        At -= pScenario->phases[Index].durationSec;
+    }
+    const StubPhase *pPhase = &pScenario->phases[(Index < pScenario->phaseCount) ? Index : pScenario->phaseCount - 1];
+
+    double Utilization = pPhase->utilizationStart + (pPhase->utilizationEnd - pPhase->utilizationStart) * Fraction;
+    *pUtilization      = StubClamp(Utilization + pPhase->noise * StubNoise(pScenario->seed, Adapter, 0, Tick), 0.0, 1.0);
+    *pMedia            = StubClamp(pPhase->media + pPhase->noise * StubNoise(pScenario->seed, Adapter, 1, Tick), 0.0, 1.0);
+}
+
+/***************************************************************
+ * @brief Duty a speed table asks for at a temperature, linear between points
+ ***************************************************************/
+static double StubTableDuty(const ctl_fan_speed_table_t *pTable, double TemperatureC)
+{
+    double Duty = 0.0;
+    for (int32_t i = 0; i < pTable->numPoints; i++)
+    {
+        const ctl_fan_temp_speed_t &Point = pTable->table[i];
+        double PointDuty                  = (CTL_FAN_SPEED_UNITS_PERCENT == Point.speed.units) ? Point.speed.speed / 100.0 : static_cast<double>(Point.speed.speed) / STUB_FAN_MAX_RPM;
+        if (TemperatureC <= Point.temperature)
+        {
+            if (0 == i)
+            {
+                return StubClamp(PointDuty, 0.0, 1.0);
+            }
+            const ctl_fan_temp_speed_t &Below = pTable->table[i - 1];
+            double Fraction                   = (TemperatureC - Below.temperature) / static_cast<double>(Point.temperature - Below.temperature);
+            return StubClamp(Duty + (PointDuty - Duty) * Fraction, 0.0, 1.0);
+        }
+        Duty = PointDuty;
+    }
+    return StubClamp(Duty, 0.0, 1.0);
+}
+
+/***************************************************************
+ * @brief Stock curve at the elaborate level of detail
+ ***************************************************************/
+static void StubVfStock(ctl_voltage_frequency_point_t *pPoints)
+{
+    for (uint32_t i = 0; i < STUB_VF_POINTS; i++)
+    {
+        double Mhz           = 600.0 + (STUB_GPU_MAX_MHZ - 600.0) * pow(i / (STUB_VF_POINTS - 1.0), 0.8);
+        pPoints[i].Voltage   = STUB_VF_MIN_MV + STUB_VF_STEP_MV * i;
+        pPoints[i].Frequency = static_cast<uint32_t>(Mhz) / STUB_VF_FREQ_STEP_MHZ * STUB_VF_FREQ_STEP_MHZ;
+    }
+}
+
+static uint32_t StubVfPointCount(ctl_vf_curve_details_t Details)
+{
+    return (CTL_VF_CURVE_DETAILS_SIMPLIFIED == Details) ? STUB_VF_POINTS / 4 : (CTL_VF_CURVE_DETAILS_MEDIUM == Details) ? STUB_VF_POINTS / 2 : STUB_VF_POINTS;
+}
+
+/***************************************************************
+ * @brief Voltage of the stock curve at a frequency, extrapolated past its top
+ ***************************************************************/
+static double StubVfStockVoltageAt(const ctl_voltage_frequency_point_t *pStock, double Mhz)
+{
+    uint32_t i = 1;
+    while ((i + 1 < STUB_VF_POINTS) && (pStock[i].Frequency < Mhz))
+    {
+        i++;
+    }
+    double Fraction = (Mhz - pStock[i - 1].Frequency) / (static_cast<double>(pStock[i].Frequency) - pStock[i - 1].Frequency);
+    return pStock[i - 1].Voltage + (static_cast<double>(pStock[i].Voltage) - pStock[i - 1].Voltage) * Fraction;
+}
+
+/***************************************************************
+ * @brief Derives the clock, voltage and stability of the live curve
+ *
+ * The GPU runs at the top of the live curve and at the lowest voltage that
+ * reaches it. A point more than the margin of the adapter below the stock
+ * curve makes the curve unstable.
+ ***************************************************************/
+static void StubVfOperatingPoint(_ctl_device_adapter_handle_t *pAdapter)
+{
+    ctl_voltage_frequency_point_t Stock[STUB_VF_POINTS];
+    StubVfStock(Stock);
+
+    const ctl_voltage_frequency_point_t *pLive = pAdapter->vfLive;
+    uint32_t Top                               = 0;
+    bool Stable                                = true;
+    for (uint32_t i = 0; i < STUB_VF_POINTS; i++)
+    {
+        Top = (pLive[i].Frequency > pLive[Top].Frequency) ? i : Top;
+        Stable &= (pLive[i].Voltage >= StubVfStockVoltageAt(Stock, pLive[i].Frequency) - pAdapter->ocMarginMv);
+    }
+    pAdapter->ocClockScale   = static_cast<double>(pLive[Top].Frequency) / Stock[STUB_VF_POINTS - 1].Frequency;
+    pAdapter->ocVoltageScale = static_cast<double>(pLive[Top].Voltage) / Stock[STUB_VF_POINTS - 1].Voltage;
+    pAdapter->ocStable       = Stable;
+}
+
+/***************************************************************
+ * @brief Populated PSU inputs of an adapter, the first is the PCIe slot
+ ***************************************************************/
+static uint32_t StubPsuCount(const _ctl_device_adapter_handle_t *pAdapter)
+{
+    return (0 == pAdapter->index % 2) ? STUB_PSU_COUNT : STUB_PSU_COUNT - 1;
+}
+
+static _ctl_api_handle_t *pStubApi = nullptr;
+
+/***************************************************************
+ * @brief Advances the load model of an adapter by one tick
+ ***************************************************************/
+static void StubStep(_ctl_device_adapter_handle_t *pAdapter, const StubScenario *pScenario)
+{
+    const double Dt = STUB_TICK_SEC;
+    pAdapter->tick++;
+    StubScenarioLoadAt(pScenario, pAdapter->index, pAdapter->tick, &pAdapter->utilization, &pAdapter->mediaUtilization);
+
+    // An unstable curve hangs the GPU as soon as it is loaded, and a hung GPU does no work
+    pAdapter->hung |= (!pAdapter->ocStable && (pAdapter->utilization > STUB_OC_HANG_UTILIZATION));
+    if (pAdapter->hung)
+    {
+        pAdapter->utilization      = 0.0;
+        pAdapter->mediaUtilization = 0.0;
+    }
+
+    // The frequency range bounds the requested clock, the live curve scales it
+    // and the dynamic power with its clock and voltage squared, the sustained
+    // limit then lowers it further until dynamic power fits under the limit,
+    // and above the throttle point the clock backs off until the GPU has
+    // cooled down
+    double RequestMhz = 600.0 + 1800.0 * pAdapter->utilization;
+    double RangeScale = StubClamp(RequestMhz, pAdapter->freq[0].rangeMin, pAdapter->freq[0].rangeMax) / RequestMhz;
+    double CurveScale = pAdapter->ocClockScale * pAdapter->ocVoltageScale * pAdapter->ocVoltageScale;
+    double DemandW    = STUB_GPU_STATIC_W + 150.0 * pAdapter->utilization * pow(RangeScale * pAdapter->thermalScale, STUB_DVFS_EXPONENT) * CurveScale;
+    double LimitW     = pAdapter->limits.sustainedPowerLimit.enabled ? pAdapter->limits.sustainedPowerLimit.power / 1000.0 : DemandW;
+    double GpuPowerW  = (DemandW > LimitW) ? LimitW : DemandW;
+    double VramPowerW = 10.0 + 15.0 * pAdapter->utilization;
+
+    pAdapter->rangeScale = RangeScale;
+    pAdapter->gpuPowerW  = GpuPowerW;
+    pAdapter->clockScale = (DemandW > LimitW) ? pow((LimitW - STUB_GPU_STATIC_W) / (DemandW - STUB_GPU_STATIC_W), 1.0 / STUB_DVFS_EXPONENT) : 1.0;
+
+    pAdapter->gpuEnergyJ += GpuPowerW * Dt;
+    pAdapter->vramEnergyJ += VramPowerW * Dt;
+    pAdapter->globalActiveSec += pAdapter->utilization * Dt;
+    pAdapter->renderActiveSec += 0.9 * pAdapter->utilization * Dt;
+    pAdapter->mediaActiveSec += pAdapter->mediaUtilization * Dt;
+    pAdapter->vramReadBytes += 0.6 * pAdapter->utilization * STUB_VRAM_MAX_BANDWIDTH * Dt;
+    pAdapter->vramWriteBytes += 0.3 * pAdapter->utilization * STUB_VRAM_MAX_BANDWIDTH * Dt;
+    pAdapter->gpuThrottleSec += ((pAdapter->utilization > 0.85) || (pAdapter->clockScale < 1.0) || (pAdapter->thermalScale < 1.0)) ? Dt : 0.0;
+
+    // Fans follow the default curve or their table; the GPU settles toward
+    // ambient plus power times a thermal resistance that falls with airflow,
+    // the memory lags its load with a time constant of its own
+    double MeanDuty = 0.0;
+    for (uint32_t i = 0; i < STUB_FAN_COUNT; i++)
+    {
+        _ctl_fan_handle_t *pFan = &pAdapter->fan[i];
+        pFan->duty              = pFan->tableMode ? StubTableDuty(&pFan->table, pAdapter->gpuTemperatureC) : (0.3 + 0.6 * pAdapter->utilization);
+        MeanDuty += pFan->duty / STUB_FAN_COUNT;
+    }
+    double SteadyC       = pScenario->ambientC + GpuPowerW * 0.32 / (0.35 + MeanDuty);
+    double MemorySteadyC = pScenario->ambientC + 20.0 + 30.0 * pAdapter->utilization;
+    pAdapter->gpuTemperatureC += (SteadyC - pAdapter->gpuTemperatureC) * (1.0 - exp(-Dt / pScenario->thermalTauSec));
+    pAdapter->memoryTemperatureC += (MemorySteadyC - pAdapter->memoryTemperatureC) * (1.0 - exp(-Dt / pScenario->memoryTauSec));
+
+    double ThermalStep     = (pAdapter->gpuTemperatureC > pAdapter->temperatureLimitC) ? -STUB_THERMAL_BACKOFF_PER_SEC * Dt : STUB_THERMAL_RECOVER_PER_SEC * Dt;
+    pAdapter->thermalScale = StubClamp(pAdapter->thermalScale + ThermalStep, STUB_THERMAL_MIN_SCALE, 1.0);
+
+    // The slot carries a fifth of the input up to 66 W, the 8 pin inputs share the rest
+    double FanPowerW  = STUB_FAN_MAX_W * STUB_FAN_COUNT * MeanDuty * MeanDuty * MeanDuty;
+    double InputW     = GpuPowerW + VramPowerW + FanPowerW;
+    double SlotW      = StubClamp(0.2 * InputW, 0.0, 66.0);
+    uint32_t PsuCount = StubPsuCount(pAdapter);
+    for (uint32_t i = 0; i < PsuCount; i++)
+    {
+        pAdapter->psuPowerW[i] = (0 == i) ? SlotW : (InputW - SlotW) / (PsuCount - 1);
+        pAdapter->psuEnergyJ[i] += pAdapter->psuPowerW[i] * Dt;
+    }
+}
+
+/***************************************************************
+ * @brief Advances the load model of an adapter to now, caller holds the lock
+ *
+ * Only whole ticks are taken, so the trace of an adapter is the same
+ * however often it is read.
+ ***************************************************************/
+static void StubAdvance(_ctl_device_adapter_handle_t *pAdapter)
+{
+    uint64_t Target = static_cast<uint64_t>((StubNowSec() - pStubApi->startSec) / STUB_TICK_SEC);
+    while (pAdapter->tick < Target)
+    {
+        StubStep(pAdapter, &pStubApi->scenario);
+    }
+    pAdapter->lastUpdateSec = pStubApi->startSec + pAdapter->tick * STUB_TICK_SEC;
+}
+
+static void StubSetItem(ctl_oc_telemetry_item_t *pItem, ctl_units_t Units, double Value)
+{
+    pItem->bSupported       = true;
+    pItem->units            = Units;
+    pItem->type             = CTL_DATA_TYPE_DOUBLE;
+    pItem->value.datadouble = Value;
+}
+
+static void StubSetItemU64(ctl_oc_telemetry_item_t *pItem, ctl_units_t Units, uint64_t Value)
+{
+    pItem->bSupported    = true;
+    pItem->units         = Units;
+    pItem->type          = CTL_DATA_TYPE_UINT64;
+    pItem->value.datau64 = Value;
+}
+
+template <typename HandleT> static ctl_result_t StubEnumerate(uint32_t *pCount, HandleT **phHandles, HandleT *pSource, uint32_t SourceCount)
+{
+    if (nullptr == pCount)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((nullptr == phHandles) || (0 == *pCount))
+    {
+        *pCount = SourceCount;
+        return CTL_RESULT_SUCCESS;
+    }
+
+    uint32_t Count = (*pCount < SourceCount) ? *pCount : SourceCount;
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        phHandles[i] = &pSource[i];
+    }
+    *pCount = Count;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlInit(ctl_init_args_t *pInitDesc, ctl_api_handle_t *phAPIHandle)
+{
+    if ((nullptr == pInitDesc) || (nullptr == phAPIHandle))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (nullptr != pStubApi)
+    {
+        *phAPIHandle = pStubApi;
+        return CTL_RESULT_SUCCESS;
+    }
+
+    pStubApi = new _ctl_api_handle_t;
+    if (nullptr == pStubApi)
+    {
+        return CTL_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    StubScenarioDefaults(&pStubApi->scenario);
+    const char *pEnv = getenv("IGCL_STUB_SCENARIO");
+    if (nullptr != pEnv)
+    {
+        ctl_result_t Result = StubScenarioLoad(pEnv, &pStubApi->scenario);
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            delete pStubApi;
+            pStubApi = nullptr;
+            return Result;
+        }
+    }
+    pEnv = getenv("IGCL_STUB_SEED");
+    if (nullptr != pEnv)
+    {
+        pStubApi->scenario.seed = strtoull(pEnv, nullptr, 0);
+    }
+
+    // The environment overrides the scenario, which overrides the default
+    uint32_t AdapterCount = (0 != pStubApi->scenario.adapterCount) ? pStubApi->scenario.adapterCount : STUB_DEFAULT_ADAPTER_COUNT;
+    pEnv                  = getenv("IGCL_STUB_ADAPTER_COUNT");
+    if (nullptr != pEnv)
+    {
+        AdapterCount = static_cast<uint32_t>(StubClamp(atoi(pEnv), 1, STUB_MAX_ADAPTERS));
+    }
+
+    pStubApi->adapterCount       = AdapterCount;
+    pStubApi->startSec           = StubNowSec();
+    pStubApi->wallStartSec       = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    pEnv                         = getenv("IGCL_STUB_TELEMETRY_US");
+    pStubApi->telemetryLatencyUs = (nullptr != pEnv) ? static_cast<uint32_t>(StubClamp(atoi(pEnv), 0, 1000000)) : 0;
+    for (uint32_t i = 0; i < AdapterCount; i++)
+    {
+        _ctl_device_adapter_handle_t *pAdapter = &pStubApi->adapters[i];
+        pAdapter->index                        = i;
+        pAdapter->tick                         = 0;
+        pAdapter->lastUpdateSec                = pStubApi->startSec;
+        pAdapter->utilization                  = 0.0;
+        pAdapter->mediaUtilization             = 0.0;
+        pAdapter->gpuEnergyJ                   = 1000.0 * (i + 1);
+        pAdapter->vramEnergyJ                  = 100.0 * (i + 1);
+        pAdapter->globalActiveSec              = 0.0;
+        pAdapter->renderActiveSec              = 0.0;
+        pAdapter->mediaActiveSec               = 0.0;
+        pAdapter->vramReadBytes                = 0.0;
+        pAdapter->vramWriteBytes               = 0.0;
+        pAdapter->gpuThrottleSec               = 0.0;
+        pAdapter->gpuTemperatureC              = 40.0;
+        pAdapter->memoryTemperatureC           = 45.0;
+        pAdapter->thermalScale                 = 1.0;
+        pAdapter->gpuPowerW                    = STUB_GPU_STATIC_W;
+        pAdapter->rangeScale                   = 1.0;
+        pAdapter->clockScale                   = 1.0;
+        pAdapter->pciWidth                     = (0 != (i & 1)) ? STUB_PCI_NARROW_WIDTH : STUB_PCI_WIDTH;
+        pAdapter->pciAllowFastGen              = true;
+        pAdapter->eccCurrent                   = CTL_ECC_STATE_ECC_ENABLED_STATE;
+        pAdapter->eccPending                   = CTL_ECC_STATE_ECC_ENABLED_STATE;
+        pAdapter->ocWaiver                     = false;
+        pAdapter->ocMarginMv                   = STUB_OC_MARGIN_MV + STUB_OC_MARGIN_SPREAD_MV * StubNoiseAt(pStubApi->scenario.seed, i, 2, 0);
+        pAdapter->hung                         = false;
+        pAdapter->temperatureLimitC            = pStubApi->scenario.throttleC;
+        StubVfStock(pAdapter->vfLive);
+        StubVfOperatingPoint(pAdapter);
+
+        for (uint32_t j = 0; j < STUB_PSU_COUNT; j++)
+        {
+            pAdapter->psuEnergyJ[j] = 0.0;
+            pAdapter->psuPowerW[j]  = 0.0;
+        }
+
+        pAdapter->limits                              = {};
+        pAdapter->limits.sustainedPowerLimit.enabled  = true;
+        pAdapter->limits.sustainedPowerLimit.power    = STUB_POWER_DEFAULT_MW;
+        pAdapter->limits.sustainedPowerLimit.interval = 28000;
+        pAdapter->limits.burstPowerLimit.enabled      = true;
+        pAdapter->limits.burstPowerLimit.power        = 228000;
+        pAdapter->limits.peakPowerLimits.powerAC      = 252000;
+        pAdapter->limits.peakPowerLimits.powerDC      = 252000;
+
+        for (uint32_t j = 0; j < STUB_FREQ_DOMAIN_COUNT; j++)
+        {
+            bool Gpu          = (CTL_FREQ_DOMAIN_GPU == StubFreqDomains[j]);
+            pAdapter->freq[j] = { pAdapter, j, Gpu ? STUB_GPU_MIN_MHZ : STUB_MEM_MIN_MHZ, Gpu ? STUB_GPU_MAX_MHZ : STUB_MEM_MAX_MHZ };
+        }
+        for (uint32_t j = 0; j < STUB_TEMP_SENSOR_COUNT; j++)
+        {
+            pAdapter->temp[j] = { pAdapter, j };
+        }
+        for (uint32_t j = 0; j < STUB_FAN_COUNT; j++)
+        {
+            pAdapter->fan[j] = { pAdapter, j, 0.3, false, {} };
+        }
+        for (uint32_t j = 0; j < STUB_POWER_DOMAIN_COUNT; j++)
+        {
+            pAdapter->power[j] = { pAdapter, j };
+        }
+        for (uint32_t j = 0; j < STUB_ENGINE_GROUP_COUNT; j++)
+        {
+            pAdapter->engine[j] = { pAdapter, j };
+        }
+        for (uint32_t j = 0; j < STUB_MEM_MODULE_COUNT; j++)
+        {
+            pAdapter->memory[j] = { pAdapter, j };
+        }
+    }
+
+    pInitDesc->SupportedVersion = CTL_IMPL_VERSION;
+    *phAPIHandle                = pStubApi;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlClose(ctl_api_handle_t hAPIHandle)
+{
+    if ((nullptr == hAPIHandle) || (hAPIHandle != pStubApi))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+
+    delete pStubApi;
+    pStubApi = nullptr;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlEnumerateDevices(ctl_api_handle_t hAPIHandle, uint32_t *pCount, ctl_device_adapter_handle_t *phDevices)
+{
+    if (nullptr == hAPIHandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    return StubEnumerate(pCount, phDevices, hAPIHandle->adapters, hAPIHandle->adapterCount);
+}
+
+ctl_result_t CTL_APICALL ctlGetDeviceProperties(ctl_device_adapter_handle_t hDAhandle, ctl_device_adapter_properties_t *pProperties)
+{
+    if (nullptr == hDAhandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    if (nullptr == pProperties)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pProperties->device_type          = CTL_DEVICE_TYPE_GRAPHICS;
+    pProperties->pci_vendor_id        = 0x8086;
+    pProperties->pci_device_id        = 0x56A0;
+    pProperties->rev_id               = 0x08;
+    pProperties->pci_subsys_id        = 0x1020;
+    pProperties->pci_subsys_vendor_id = 0x8086;
+    pProperties->adapter_bdf.bus      = static_cast<uint8_t>(3 + hDAhandle->index);
+    pProperties->adapter_bdf.device   = 0;
+    pProperties->adapter_bdf.function = 0;
+    snprintf(pProperties->name, CTL_MAX_DEVICE_NAME_LEN, "Intel(R) Arc(TM) Stub Graphics %u", hDAhandle->index);
+    return CTL_RESULT_SUCCESS;
+}
+
+/***************************************************************
+ * @brief Usable bandwidth of a link, 8b/10b up to gen 2 and 128b/130b after
+ ***************************************************************/
+static void StubSetPciSpeed(ctl_pci_speed_t *pSpeed, uint32_t Gen, uint32_t Width)
+{
+    static const int64_t LaneBytesPerSec[] = { 250000000ll, 500000000ll, 984600000ll, 1969000000ll, 3938000000ll };
+
+    pSpeed->gen          = static_cast<int32_t>(Gen);
+    pSpeed->width        = static_cast<int32_t>(Width);
+    pSpeed->maxBandwidth = LaneBytesPerSec[Gen - 1] * Width;
+}
+
+/***************************************************************
+ * @brief Generation the link runs at now, caller holds the lock
+ *
+ * The link drops to gen 1 while the adapter is nearly idle and, when
+ * allowed to train at the fastest generation, periodically falls back
+ * to gen 3 for a few seconds as a marginal link would.
+ ***************************************************************/
+static uint32_t StubPciGen(const _ctl_device_adapter_handle_t *pAdapter)
+{
+    if (pAdapter->utilization < STUB_PCI_IDLE_UTILIZATION)
+    {
+        return 1;
+    }
+    if (!pAdapter->pciAllowFastGen)
+    {
+        return STUB_PCI_BLOCKED_GEN;
+    }
+    return (fmod(pAdapter->lastUpdateSec + 7.0 * pAdapter->index, STUB_PCI_RETRAIN_PERIOD_SEC) < STUB_PCI_RETRAIN_SEC) ? STUB_PCI_BLOCKED_GEN : STUB_PCI_GEN;
+}
+
+ctl_result_t CTL_APICALL ctlPciGetProperties(ctl_device_adapter_handle_t hDAhandle, ctl_pci_properties_t *pProperties)
+{
+    if (nullptr == hDAhandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    if (nullptr == pProperties)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pProperties->address.domain   = 0;
+    pProperties->address.bus      = 3 + hDAhandle->index;
+    pProperties->address.device   = 0;
+    pProperties->address.function = 0;
+    StubSetPciSpeed(&pProperties->maxSpeed, STUB_PCI_GEN, STUB_PCI_WIDTH);
+    pProperties->resizable_bar_supported = true;
+    pProperties->resizable_bar_enabled   = true;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlPciGetState(ctl_device_adapter_handle_t hDAhandle, ctl_pci_state_t *pState)
+{
+    if (nullptr == hDAhandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    if (nullptr == pState)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hDAhandle->lock);
+    StubAdvance(hDAhandle);
+    StubSetPciSpeed(&pState->speed, StubPciGen(hDAhandle), hDAhandle->pciWidth);
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlAllowPCIeLinkSpeedUpdate(ctl_device_adapter_handle_t hDeviceAdapter, bool AllowPCIeLinkSpeedUpdate)
+{
+    if (nullptr == hDeviceAdapter)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+
+    std::lock_guard<std::mutex> Guard(hDeviceAdapter->lock);
+    StubAdvance(hDeviceAdapter);
+    hDeviceAdapter->pciAllowFastGen = AllowPCIeLinkSpeedUpdate;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlEccGetProperties(ctl_device_adapter_handle_t hDAhandle, ctl_ecc_properties_t *pProperties)
+{
+    if (nullptr == hDAhandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    if (nullptr == pProperties)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pProperties->isSupported = true;
+    pProperties->canControl  = true;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlEccGetState(ctl_device_adapter_handle_t hDAhandle, ctl_ecc_state_desc_t *pState)
+{
+    if (nullptr == hDAhandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    if (nullptr == pState)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hDAhandle->lock);
+    pState->currentEccState = hDAhandle->eccCurrent;
+    pState->pendingEccState = hDAhandle->eccPending;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlEccSetState(ctl_device_adapter_handle_t hDAhandle, ctl_ecc_state_desc_t *pState)
+{
+    if (nullptr == hDAhandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    if (nullptr == pState)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (pState->currentEccState > CTL_ECC_STATE_ECC_DISABLED_STATE)
+    {
+        return CTL_RESULT_ERROR_INVALID_ENUMERATION;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(STUB_ECC_WRITE_MS));
+
+    // Enabled is the factory setting
+    std::lock_guard<std::mutex> Guard(hDAhandle->lock);
+    hDAhandle->eccPending   = (CTL_ECC_STATE_ECC_DEFAULT_STATE == pState->currentEccState) ? CTL_ECC_STATE_ECC_ENABLED_STATE : pState->currentEccState;
+    pState->pendingEccState = hDAhandle->eccPending;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlEnumFrequencyDomains(ctl_device_adapter_handle_t hDAhandle, uint32_t *pCount, ctl_freq_handle_t *phFrequency)
+{
+    if (nullptr == hDAhandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    return StubEnumerate(pCount, phFrequency, hDAhandle->freq, STUB_FREQ_DOMAIN_COUNT);
+}
+
+ctl_result_t CTL_APICALL ctlFrequencyGetProperties(ctl_freq_handle_t hFrequency, ctl_freq_properties_t *pProperties)
+{
+    if ((nullptr == hFrequency) || (nullptr == pProperties))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pProperties->type       = StubFreqDomains[hFrequency->index];
+    pProperties->canControl = (CTL_FREQ_DOMAIN_GPU == pProperties->type);
+    pProperties->min        = (CTL_FREQ_DOMAIN_GPU == pProperties->type) ? STUB_GPU_MIN_MHZ : STUB_MEM_MIN_MHZ;
+    pProperties->max        = (CTL_FREQ_DOMAIN_GPU == pProperties->type) ? STUB_GPU_MAX_MHZ : STUB_MEM_MAX_MHZ;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlFrequencyGetAvailableClocks(ctl_freq_handle_t hFrequency, uint32_t *pCount, double *phFrequency)
+{
+    if ((nullptr == hFrequency) || (nullptr == pCount))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    bool Gpu        = (CTL_FREQ_DOMAIN_GPU == StubFreqDomains[hFrequency->index]);
+    double MinMhz   = Gpu ? STUB_GPU_MIN_MHZ : STUB_MEM_MIN_MHZ;
+    double StepMhz  = Gpu ? STUB_GPU_CLOCK_STEP_MHZ : STUB_MEM_CLOCK_STEP_MHZ;
+    uint32_t Clocks = static_cast<uint32_t>(((Gpu ? STUB_GPU_MAX_MHZ : STUB_MEM_MAX_MHZ) - MinMhz) / StepMhz) + 1;
+    if ((0 == *pCount) || (nullptr == phFrequency))
+    {
+        *pCount = Clocks;
+        return CTL_RESULT_SUCCESS;
+    }
+
+    *pCount = (*pCount < Clocks) ? *pCount : Clocks;
+    for (uint32_t i = 0; i < *pCount; i++)
+    {
+        phFrequency[i] = MinMhz + i * StepMhz;
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlFrequencyGetRange(ctl_freq_handle_t hFrequency, ctl_freq_range_t *pLimits)
+{
+    if ((nullptr == hFrequency) || (nullptr == pLimits))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hFrequency->pAdapter->lock);
+    pLimits->min = hFrequency->rangeMin;
+    pLimits->max = hFrequency->rangeMax;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlFrequencySetRange(ctl_freq_handle_t hFrequency, const ctl_freq_range_t *pLimits)
+{
+    if ((nullptr == hFrequency) || (nullptr == pLimits))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    bool Gpu = (CTL_FREQ_DOMAIN_GPU == StubFreqDomains[hFrequency->index]);
+    if (!Gpu)
+    {
+        return CTL_RESULT_ERROR_UNSUPPORTED_FEATURE;
+    }
+
+    // 0 and -1 return a bound to the hardware limit, which is also the factory value here
+    double MinMhz = (pLimits->min <= 0.0) ? STUB_GPU_MIN_MHZ : pLimits->min;
+    double MaxMhz = (pLimits->max <= 0.0) ? STUB_GPU_MAX_MHZ : pLimits->max;
+    if ((MinMhz < STUB_GPU_MIN_MHZ) || (MaxMhz > STUB_GPU_MAX_MHZ) || (MinMhz > MaxMhz))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(hFrequency->pAdapter->lock);
+    StubAdvance(hFrequency->pAdapter);
+    hFrequency->rangeMin = MinMhz;
+    hFrequency->rangeMax = MaxMhz;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlFrequencyGetState(ctl_freq_handle_t hFrequency, ctl_freq_state_t *pState)
+{
+    if ((nullptr == hFrequency) || (nullptr == pState))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hFrequency->pAdapter->lock);
+    StubAdvance(hFrequency->pAdapter);
+
+    double Utilization = hFrequency->pAdapter->utilization;
+    if (CTL_FREQ_DOMAIN_GPU == StubFreqDomains[hFrequency->index])
+    {
+        pState->currentVoltage  = (0.70 + 0.35 * Utilization) * hFrequency->pAdapter->ocVoltageScale;
+        pState->request         = (600.0 + 1800.0 * Utilization) * hFrequency->pAdapter->rangeScale * hFrequency->pAdapter->ocClockScale;
+        pState->tdp             = STUB_GPU_MAX_MHZ;
+        pState->efficient       = 600.0;
+        pState->actual          = pState->request * hFrequency->pAdapter->thermalScale * hFrequency->pAdapter->clockScale;
+        pState->throttleReasons = ((Utilization > 0.85) || (hFrequency->pAdapter->clockScale < 1.0)) ? static_cast<uint32_t>(CTL_FREQ_THROTTLE_REASON_FLAG_AVE_PWR_CAP) : 0u;
+        pState->throttleReasons |= ((Utilization > 0.88) || (hFrequency->pAdapter->thermalScale < 1.0)) ? static_cast<uint32_t>(CTL_FREQ_THROTTLE_REASON_FLAG_THERMAL_LIMIT) : 0u;
+    }
+    else
+    {
+        pState->currentVoltage  = 1.35;
+        pState->request         = 2000.0;
+        pState->tdp             = 2000.0;
+        pState->efficient       = 1000.0;
+        pState->actual          = 2000.0;
+        pState->throttleReasons = 0;
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlFrequencyGetThrottleTime(ctl_freq_handle_t hFrequency, ctl_freq_throttle_time_t *pThrottleTime)
+{
+    if ((nullptr == hFrequency) || (nullptr == pThrottleTime))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hFrequency->pAdapter->lock);
+    StubAdvance(hFrequency->pAdapter);
+
+    bool Gpu                    = (CTL_FREQ_DOMAIN_GPU == StubFreqDomains[hFrequency->index]);
+    pThrottleTime->throttleTime = Gpu ? static_cast<uint64_t>(hFrequency->pAdapter->gpuThrottleSec * 1e6) : 0;
+    pThrottleTime->timestamp    = static_cast<uint64_t>(hFrequency->pAdapter->lastUpdateSec * 1e6);
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlEnumTemperatureSensors(ctl_device_adapter_handle_t hDAhandle, uint32_t *pCount, ctl_temp_handle_t *phTemperature)
+{
+    if (nullptr == hDAhandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    return StubEnumerate(pCount, phTemperature, hDAhandle->temp, STUB_TEMP_SENSOR_COUNT);
+}
+
+ctl_result_t CTL_APICALL ctlTemperatureGetProperties(ctl_temp_handle_t hTemperature, ctl_temp_properties_t *pProperties)
+{
+    if ((nullptr == hTemperature) || (nullptr == pProperties))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pProperties->type           = StubTempSensors[hTemperature->index];
+    pProperties->maxTemperature = 105.0;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlTemperatureGetState(ctl_temp_handle_t hTemperature, double *pTemperature)
+{
+    if ((nullptr == hTemperature) || (nullptr == pTemperature))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hTemperature->pAdapter->lock);
+    StubAdvance(hTemperature->pAdapter);
+
+    bool Memory   = (CTL_TEMP_SENSORS_MEMORY == StubTempSensors[hTemperature->index]);
+    *pTemperature = Memory ? hTemperature->pAdapter->memoryTemperatureC : hTemperature->pAdapter->gpuTemperatureC;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlEnumFans(ctl_device_adapter_handle_t hDAhandle, uint32_t *pCount, ctl_fan_handle_t *phFan)
+{
+    if (nullptr == hDAhandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    return StubEnumerate(pCount, phFan, hDAhandle->fan, STUB_FAN_COUNT);
+}
+
+ctl_result_t CTL_APICALL ctlFanGetState(ctl_fan_handle_t hFan, ctl_fan_speed_units_t units, int32_t *pSpeed)
+{
+    if ((nullptr == hFan) || (nullptr == pSpeed))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hFan->pAdapter->lock);
+    StubAdvance(hFan->pAdapter);
+
+    *pSpeed = (CTL_FAN_SPEED_UNITS_PERCENT == units) ? static_cast<int32_t>(100.0 * hFan->duty) : static_cast<int32_t>(STUB_FAN_MAX_RPM * hFan->duty) + 10 * static_cast<int32_t>(hFan->index);
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlFanGetProperties(ctl_fan_handle_t hFan, ctl_fan_properties_t *pProperties)
+{
+    if ((nullptr == hFan) || (nullptr == pProperties))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pProperties->canControl     = true;
+    pProperties->supportedModes = CTL_BIT(CTL_FAN_SPEED_MODE_DEFAULT) | CTL_BIT(CTL_FAN_SPEED_MODE_TABLE);
+    pProperties->supportedUnits = CTL_BIT(CTL_FAN_SPEED_UNITS_RPM) | CTL_BIT(CTL_FAN_SPEED_UNITS_PERCENT);
+    pProperties->maxRPM         = STUB_FAN_MAX_RPM;
+    pProperties->maxPoints      = 10;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlFanGetConfig(ctl_fan_handle_t hFan, ctl_fan_config_t *pConfig)
+{
+    if ((nullptr == hFan) || (nullptr == pConfig))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hFan->pAdapter->lock);
+    pConfig->mode             = hFan->tableMode ? CTL_FAN_SPEED_MODE_TABLE : CTL_FAN_SPEED_MODE_DEFAULT;
+    pConfig->speedFixed.speed = -1;
+    pConfig->speedTable       = hFan->table;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlFanSetDefaultMode(ctl_fan_handle_t hFan)
+{
+    if (nullptr == hFan)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+
+    std::lock_guard<std::mutex> Guard(hFan->pAdapter->lock);
+    StubAdvance(hFan->pAdapter);
+    hFan->tableMode       = false;
+    hFan->table.numPoints = 0;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlFanSetSpeedTableMode(ctl_fan_handle_t hFan, const ctl_fan_speed_table_t *speedTable)
+{
+    if ((nullptr == hFan) || (nullptr == speedTable))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    // Same checks as firmware: a bounded, strictly rising table
+    if ((speedTable->numPoints < 1) || (speedTable->numPoints > 10))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+    for (int32_t i = 1; i < speedTable->numPoints; i++)
+    {
+        if (speedTable->table[i].temperature <= speedTable->table[i - 1].temperature)
+        {
+            return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    std::lock_guard<std::mutex> Guard(hFan->pAdapter->lock);
+    StubAdvance(hFan->pAdapter);
+    hFan->table     = *speedTable;
+    hFan->tableMode = true;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlEnumPowerDomains(ctl_device_adapter_handle_t hDAhandle, uint32_t *pCount, ctl_pwr_handle_t *phPower)
+{
+    if (nullptr == hDAhandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    return StubEnumerate(pCount, phPower, hDAhandle->power, STUB_POWER_DOMAIN_COUNT);
+}
+
+ctl_result_t CTL_APICALL ctlPowerGetLimits(ctl_pwr_handle_t hPower, ctl_power_limits_t *pPowerLimits)
+{
+    if ((nullptr == hPower) || (nullptr == pPowerLimits))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hPower->pAdapter->lock);
+    pPowerLimits->sustainedPowerLimit = hPower->pAdapter->limits.sustainedPowerLimit;
+    pPowerLimits->burstPowerLimit     = hPower->pAdapter->limits.burstPowerLimit;
+    pPowerLimits->peakPowerLimits     = hPower->pAdapter->limits.peakPowerLimits;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlPowerGetProperties(ctl_pwr_handle_t hPower, ctl_power_properties_t *pProperties)
+{
+    if ((nullptr == hPower) || (nullptr == pProperties))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pProperties->canControl   = true;
+    pProperties->defaultLimit = STUB_POWER_DEFAULT_MW;
+    pProperties->minLimit     = STUB_POWER_MIN_MW;
+    pProperties->maxLimit     = STUB_POWER_MAX_MW;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlPowerSetLimits(ctl_pwr_handle_t hPower, const ctl_power_limits_t *pPowerLimits)
+{
+    if ((nullptr == hPower) || (nullptr == pPowerLimits))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    const ctl_power_sustained_limit_t &Sustained = pPowerLimits->sustainedPowerLimit;
+    const ctl_power_burst_limit_t &Burst         = pPowerLimits->burstPowerLimit;
+    if ((Sustained.enabled && ((Sustained.power < STUB_POWER_MIN_MW) || (Sustained.power > STUB_POWER_MAX_MW))) ||
+        (Burst.enabled && ((Burst.power < STUB_POWER_MIN_MW) || (Burst.power > STUB_POWER_MAX_MW))))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(hPower->pAdapter->lock);
+    StubAdvance(hPower->pAdapter);
+    hPower->pAdapter->limits.sustainedPowerLimit = Sustained;
+    hPower->pAdapter->limits.burstPowerLimit     = Burst;
+    hPower->pAdapter->limits.peakPowerLimits     = pPowerLimits->peakPowerLimits;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlPowerGetEnergyCounter(ctl_pwr_handle_t hPower, ctl_power_energy_counter_t *pEnergy)
+{
+    if ((nullptr == hPower) || (nullptr == pEnergy))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hPower->pAdapter->lock);
+    StubAdvance(hPower->pAdapter);
+    if (hPower->pAdapter->hung)
+    {
+        return CTL_RESULT_ERROR_DEVICE_LOST;
+    }
+
+    // The single domain covers the whole card
+    double EnergyJ     = StubWrap(hPower->pAdapter->gpuEnergyJ + hPower->pAdapter->vramEnergyJ, pStubApi->scenario.energyWrapJ);
+    pEnergy->energy    = static_cast<uint64_t>(EnergyJ * 1e6);
+    pEnergy->timestamp = static_cast<uint64_t>(hPower->pAdapter->lastUpdateSec * 1e6);
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlEnumEngineGroups(ctl_device_adapter_handle_t hDAhandle, uint32_t *pCount, ctl_engine_handle_t *phEngine)
+{
+    if (nullptr == hDAhandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    return StubEnumerate(pCount, phEngine, hDAhandle->engine, STUB_ENGINE_GROUP_COUNT);
+}
+
+ctl_result_t CTL_APICALL ctlEngineGetProperties(ctl_engine_handle_t hEngine, ctl_engine_properties_t *pProperties)
+{
+    if ((nullptr == hEngine) || (nullptr == pProperties))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pProperties->type = StubEngineGroups[hEngine->index];
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlEngineGetActivity(ctl_engine_handle_t hEngine, ctl_engine_stats_t *pStats)
+{
+    if ((nullptr == hEngine) || (nullptr == pStats))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    _ctl_device_adapter_handle_t *pAdapter = hEngine->pAdapter;
+    std::lock_guard<std::mutex> Guard(pAdapter->lock);
+    StubAdvance(pAdapter);
+    if (pAdapter->hung)
+    {
+        return CTL_RESULT_ERROR_DEVICE_LOST;
+    }
+
+    double ActiveSec = pAdapter->globalActiveSec;
+    if (CTL_ENGINE_GROUP_RENDER == StubEngineGroups[hEngine->index])
+    {
+        ActiveSec = pAdapter->renderActiveSec;
+    }
+    else if (CTL_ENGINE_GROUP_MEDIA == StubEngineGroups[hEngine->index])
+    {
+        ActiveSec = pAdapter->mediaActiveSec;
+    }
+
+    pStats->activeTime = static_cast<uint64_t>(StubWrap(ActiveSec, pStubApi->scenario.activityWrapSec) * 1e6);
+    pStats->timestamp  = static_cast<uint64_t>(pAdapter->lastUpdateSec * 1e6);
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlEnumMemoryModules(ctl_device_adapter_handle_t hDAhandle, uint32_t *pCount, ctl_mem_handle_t *phMemory)
+{
+    if (nullptr == hDAhandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    return StubEnumerate(pCount, phMemory, hDAhandle->memory, STUB_MEM_MODULE_COUNT);
+}
+
+ctl_result_t CTL_APICALL ctlMemoryGetState(ctl_mem_handle_t hMemory, ctl_mem_state_t *pState)
+{
+    if ((nullptr == hMemory) || (nullptr == pState))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hMemory->pAdapter->lock);
+    StubAdvance(hMemory->pAdapter);
+
+    pState->size = STUB_VRAM_SIZE_BYTES;
+    pState->free = static_cast<uint64_t>(STUB_VRAM_SIZE_BYTES * (0.9 - 0.5 * hMemory->pAdapter->utilization));
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlMemoryGetBandwidth(ctl_mem_handle_t hMemory, ctl_mem_bandwidth_t *pBandwidth)
+{
+    if ((nullptr == hMemory) || (nullptr == pBandwidth))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hMemory->pAdapter->lock);
+    StubAdvance(hMemory->pAdapter);
+
+    pBandwidth->maxBandwidth = STUB_VRAM_MAX_BANDWIDTH;
+    pBandwidth->timestamp    = static_cast<uint64_t>(hMemory->pAdapter->lastUpdateSec * 1e6);
+    if (pBandwidth->Version > 0)
+    {
+        pBandwidth->readCounter  = static_cast<uint64_t>(StubWrap(hMemory->pAdapter->vramReadBytes, pStubApi->scenario.byteWrap));
+        pBandwidth->writeCounter = static_cast<uint64_t>(StubWrap(hMemory->pAdapter->vramWriteBytes, pStubApi->scenario.byteWrap));
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlPowerTelemetryGet(ctl_device_adapter_handle_t hDeviceHandle, ctl_power_telemetry_t *pTelemetryInfo)
+{
+    if (nullptr == hDeviceHandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    if (nullptr == pTelemetryInfo)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    // A real read is an escape into the driver, which waits on the device
+    if (0 != pStubApi->telemetryLatencyUs)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(pStubApi->telemetryLatencyUs));
+    }
+
+    std::lock_guard<std::mutex> Guard(hDeviceHandle->lock);
+    StubAdvance(hDeviceHandle);
+    if (hDeviceHandle->hung)
+    {
+        return CTL_RESULT_ERROR_DEVICE_LOST;
+    }
+
+    const StubScenario *pScenario = &pStubApi->scenario;
+    double Utilization            = hDeviceHandle->utilization;
+    double WallSec                = pStubApi->wallStartSec + (hDeviceHandle->lastUpdateSec - pStubApi->startSec);
+    double GpuPowerW              = hDeviceHandle->gpuPowerW;
+    double ClockMhz               = (600.0 + 1800.0 * Utilization) * hDeviceHandle->rangeScale * hDeviceHandle->thermalScale * hDeviceHandle->clockScale * hDeviceHandle->ocClockScale;
+
+    // Stamped at the last tick, as the device stamps the counters it latched
+    StubSetItem(&pTelemetryInfo->timeStamp, CTL_UNITS_TIME_SECONDS, WallSec);
+    StubSetItem(&pTelemetryInfo->gpuEnergyCounter, CTL_UNITS_ENERGY_JOULES, StubWrap(hDeviceHandle->gpuEnergyJ, pScenario->energyWrapJ));
+    StubSetItem(&pTelemetryInfo->gpuVoltage, CTL_UNITS_VOLTAGE_VOLTS, (0.70 + 0.35 * Utilization) * hDeviceHandle->ocVoltageScale);
+    StubSetItem(&pTelemetryInfo->gpuCurrentClockFrequency, CTL_UNITS_FREQUENCY_MHZ, ClockMhz);
+    StubSetItem(&pTelemetryInfo->gpuCurrentTemperature, CTL_UNITS_TEMPERATURE_CELSIUS, hDeviceHandle->gpuTemperatureC);
+    StubSetItem(&pTelemetryInfo->globalActivityCounter, CTL_UNITS_TIME_SECONDS, StubWrap(hDeviceHandle->globalActiveSec, pScenario->activityWrapSec));
+    StubSetItem(&pTelemetryInfo->renderComputeActivityCounter, CTL_UNITS_TIME_SECONDS, StubWrap(hDeviceHandle->renderActiveSec, pScenario->activityWrapSec));
+    StubSetItem(&pTelemetryInfo->mediaActivityCounter, CTL_UNITS_TIME_SECONDS, StubWrap(hDeviceHandle->mediaActiveSec, pScenario->activityWrapSec));
+
+    pTelemetryInfo->gpuPowerLimited       = (Utilization > 0.85) || (hDeviceHandle->clockScale < 1.0);
+    pTelemetryInfo->gpuTemperatureLimited = (hDeviceHandle->thermalScale < 1.0);
+    pTelemetryInfo->gpuCurrentLimited     = false;
+    pTelemetryInfo->gpuVoltageLimited     = false;
+    pTelemetryInfo->gpuUtilizationLimited = (Utilization < 0.25);
+
+    StubSetItem(&pTelemetryInfo->vramEnergyCounter, CTL_UNITS_ENERGY_JOULES, StubWrap(hDeviceHandle->vramEnergyJ, pScenario->energyWrapJ));
+    StubSetItem(&pTelemetryInfo->vramVoltage, CTL_UNITS_VOLTAGE_VOLTS, 1.35);
+    StubSetItem(&pTelemetryInfo->vramCurrentClockFrequency, CTL_UNITS_FREQUENCY_MHZ, 2000.0);
+    StubSetItem(&pTelemetryInfo->vramCurrentEffectiveFrequency, CTL_UNITS_OPERATIONS_MTS, 16000.0);
+    StubSetItemU64(&pTelemetryInfo->vramReadBandwidthCounter, CTL_UNITS_MEMORY_BYTES, static_cast<uint64_t>(StubWrap(hDeviceHandle->vramReadBytes, pScenario->byteWrap)));
+    StubSetItemU64(&pTelemetryInfo->vramWriteBandwidthCounter, CTL_UNITS_MEMORY_BYTES, static_cast<uint64_t>(StubWrap(hDeviceHandle->vramWriteBytes, pScenario->byteWrap)));
+    StubSetItem(&pTelemetryInfo->vramCurrentTemperature, CTL_UNITS_TEMPERATURE_CELSIUS, hDeviceHandle->memoryTemperatureC);
+    StubSetItem(&pTelemetryInfo->totalCardEnergyCounter, CTL_UNITS_ENERGY_JOULES, StubWrap(hDeviceHandle->gpuEnergyJ + hDeviceHandle->vramEnergyJ, pScenario->energyWrapJ));
+
+    for (uint32_t i = 0; i < STUB_FAN_COUNT; i++)
+    {
+        StubSetItem(&pTelemetryInfo->fanSpeed[i], CTL_UNITS_ANGULAR_SPEED_RPM, STUB_FAN_MAX_RPM * hDeviceHandle->fan[i].duty + 10.0 * i);
+    }
+
+    for (uint32_t i = 0; i < StubPsuCount(hDeviceHandle); i++)
+    {
+        double Volts                      = STUB_PSU_VOLTS - STUB_PSU_OHMS * hDeviceHandle->psuPowerW[i] / STUB_PSU_VOLTS;
+        pTelemetryInfo->psu[i].bSupported = true;
+        pTelemetryInfo->psu[i].psuType    = StubPsuTypes[i];
+        StubSetItem(&pTelemetryInfo->psu[i].energyCounter, CTL_UNITS_ENERGY_JOULES, StubWrap(hDeviceHandle->psuEnergyJ[i], pScenario->energyWrapJ));
+        StubSetItem(&pTelemetryInfo->psu[i].voltage, CTL_UNITS_VOLTAGE_VOLTS, Volts);
+    }
+
+    if (pTelemetryInfo->Version > 0)
+    {
+        StubSetItem(&pTelemetryInfo->gpuVrTemp, CTL_UNITS_TEMPERATURE_CELSIUS, 45.0 + 35.0 * Utilization);
+        StubSetItem(&pTelemetryInfo->vramVrTemp, CTL_UNITS_TEMPERATURE_CELSIUS, 42.0 + 25.0 * Utilization);
+        StubSetItem(&pTelemetryInfo->saVrTemp, CTL_UNITS_TEMPERATURE_CELSIUS, 40.0 + 15.0 * Utilization);
+        StubSetItem(&pTelemetryInfo->gpuEffectiveClock, CTL_UNITS_FREQUENCY_MHZ, ClockMhz * 0.97);
+        StubSetItem(&pTelemetryInfo->gpuOverVoltagePercent, CTL_UNITS_PERCENT, 0.0);
+        StubSetItem(&pTelemetryInfo->gpuPowerPercent, CTL_UNITS_PERCENT, 100.0 * GpuPowerW / (hDeviceHandle->limits.sustainedPowerLimit.power / 1000.0));
+        StubSetItem(&pTelemetryInfo->gpuTemperaturePercent, CTL_UNITS_PERCENT, hDeviceHandle->gpuTemperatureC / 1.05);
+        StubSetItem(&pTelemetryInfo->vramReadBandwidth, CTL_UNITS_BANDWIDTH_MBPS, 0.6 * Utilization * STUB_VRAM_MAX_BANDWIDTH / 1e6);
+        StubSetItem(&pTelemetryInfo->vramWriteBandwidth, CTL_UNITS_BANDWIDTH_MBPS, 0.3 * Utilization * STUB_VRAM_MAX_BANDWIDTH / 1e6);
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlOverclockGetProperties(ctl_device_adapter_handle_t hDeviceHandle, ctl_oc_properties_t *pOcProperties)
+{
+    if (nullptr == hDeviceHandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    if (nullptr == pOcProperties)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pOcProperties->bSupported       = true;
+    pOcProperties->powerLimit       = { true, false, false, CTL_UNITS_POWER_WATTS, STUB_POWER_MIN_MW / 1000.0, STUB_POWER_MAX_MW / 1000.0, 1.0, STUB_POWER_DEFAULT_MW / 1000.0, 0.0 };
+    pOcProperties->temperatureLimit = { true, false, false, CTL_UNITS_TEMPERATURE_CELSIUS, STUB_TEMP_LIMIT_MIN_C, STUB_TEMP_LIMIT_MAX_C, 1.0, pStubApi->scenario.throttleC, 0.0 };
+    if (pOcProperties->Version > 0)
+    {
+        pOcProperties->gpuVFCurveVoltageLimit   = { true, false, false, CTL_UNITS_VOLTAGE_MILLIVOLTS, STUB_VF_LIMIT_MIN_MV, STUB_VF_LIMIT_MAX_MV, 1.0, 0.0, 0.0 };
+        pOcProperties->gpuVFCurveFrequencyLimit = { true, false, false, CTL_UNITS_FREQUENCY_MHZ, STUB_GPU_MIN_MHZ, STUB_VF_LIMIT_MAX_MHZ, STUB_VF_FREQ_STEP_MHZ, 0.0, 0.0 };
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlOverclockWaiverSet(ctl_device_adapter_handle_t hDeviceHandle)
+{
+    if (nullptr == hDeviceHandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+
+    std::lock_guard<std::mutex> Guard(hDeviceHandle->lock);
+    hDeviceHandle->ocWaiver = true;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlOverclockResetToDefault(ctl_device_adapter_handle_t hDeviceHandle)
+{
+    if (nullptr == hDeviceHandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+
+    // Clears every overclock setting, and recovers a hung GPU as a driver reset would
+    std::lock_guard<std::mutex> Guard(hDeviceHandle->lock);
+    StubAdvance(hDeviceHandle);
+    StubVfStock(hDeviceHandle->vfLive);
+    StubVfOperatingPoint(hDeviceHandle);
+    hDeviceHandle->hung                               = false;
+    hDeviceHandle->temperatureLimitC                  = pStubApi->scenario.throttleC;
+    hDeviceHandle->limits.sustainedPowerLimit.enabled = true;
+    hDeviceHandle->limits.sustainedPowerLimit.power   = STUB_POWER_DEFAULT_MW;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlOverclockPowerLimitGetV2(ctl_device_adapter_handle_t hDeviceHandle, double *pSustainedPowerLimit)
+{
+    if (nullptr == hDeviceHandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    if (nullptr == pSustainedPowerLimit)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hDeviceHandle->lock);
+    *pSustainedPowerLimit = hDeviceHandle->limits.sustainedPowerLimit.enabled ? hDeviceHandle->limits.sustainedPowerLimit.power / 1000.0 : 0.0;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlOverclockPowerLimitSetV2(ctl_device_adapter_handle_t hDeviceHandle, double sustainedPowerLimit)
+{
+    if (nullptr == hDeviceHandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    if ((0.0 != sustainedPowerLimit) && ((sustainedPowerLimit < STUB_POWER_MIN_MW / 1000.0) || (sustainedPowerLimit > STUB_POWER_MAX_MW / 1000.0)))
+    {
+        return CTL_RESULT_ERROR_CORE_OVERCLOCK_POWER_OUTSIDE_RANGE;
+    }
+
+    // 0 disables the limit
+    std::lock_guard<std::mutex> Guard(hDeviceHandle->lock);
+    StubAdvance(hDeviceHandle);
+    hDeviceHandle->limits.sustainedPowerLimit.enabled = (0.0 != sustainedPowerLimit);
+    hDeviceHandle->limits.sustainedPowerLimit.power   = (0.0 != sustainedPowerLimit) ? static_cast<int32_t>(sustainedPowerLimit * 1000.0) : STUB_POWER_DEFAULT_MW;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlOverclockTemperatureLimitGetV2(ctl_device_adapter_handle_t hDeviceHandle, double *pTemperatureLimit)
+{
+    if (nullptr == hDeviceHandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    if (nullptr == pTemperatureLimit)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hDeviceHandle->lock);
+    *pTemperatureLimit = hDeviceHandle->temperatureLimitC;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlOverclockTemperatureLimitSetV2(ctl_device_adapter_handle_t hDeviceHandle, double temperatureLimit)
+{
+    if (nullptr == hDeviceHandle)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    if ((temperatureLimit < STUB_TEMP_LIMIT_MIN_C) || (temperatureLimit > STUB_TEMP_LIMIT_MAX_C))
+    {
+        return CTL_RESULT_ERROR_CORE_OVERCLOCK_TEMPERATURE_OUTSIDE_RANGE;
+    }
+
+    std::lock_guard<std::mutex> Guard(hDeviceHandle->lock);
+    StubAdvance(hDeviceHandle);
+    hDeviceHandle->temperatureLimitC = temperatureLimit;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlOverclockReadVFCurve(ctl_device_adapter_handle_t hDeviceAdapter, ctl_vf_curve_type_t VFCurveType, ctl_vf_curve_details_t VFCurveDetail, uint32_t *pNumPoints,
+                                                 ctl_voltage_frequency_point_t *pVFCurveTable)
+{
+    if (nullptr == hDeviceAdapter)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    if (nullptr == pNumPoints)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((VFCurveType > CTL_VF_CURVE_TYPE_LIVE) || (VFCurveDetail > CTL_VF_CURVE_DETAILS_ELABORATE))
+    {
+        return CTL_RESULT_ERROR_INVALID_ENUMERATION;
+    }
+
+    uint32_t Count = StubVfPointCount(VFCurveDetail);
+    if (0 == *pNumPoints)
+    {
+        *pNumPoints = Count;
+        return CTL_RESULT_SUCCESS;
+    }
+    if (Count != *pNumPoints)
+    {
+        return CTL_RESULT_ERROR_INVALID_SIZE;
+    }
+    if (nullptr == pVFCurveTable)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    ctl_voltage_frequency_point_t Stock[STUB_VF_POINTS];
+    StubVfStock(Stock);
+    std::lock_guard<std::mutex> Guard(hDeviceAdapter->lock);
+    const ctl_voltage_frequency_point_t *pSource = (CTL_VF_CURVE_TYPE_STOCK == VFCurveType) ? Stock : hDeviceAdapter->vfLive;
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        pVFCurveTable[i] = pSource[i * (STUB_VF_POINTS - 1) / (Count - 1)];
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t CTL_APICALL ctlOverclockWriteCustomVFCurve(ctl_device_adapter_handle_t hDeviceAdapter, uint32_t NumPoints, ctl_voltage_frequency_point_t *pCustomVFCurveTable)
+{
+    if (nullptr == hDeviceAdapter)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_HANDLE;
+    }
+    if (nullptr == pCustomVFCurveTable)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(hDeviceAdapter->lock);
+    StubAdvance(hDeviceAdapter);
+    if (!hDeviceAdapter->ocWaiver)
+    {
+        return CTL_RESULT_ERROR_CORE_OVERCLOCK_WAIVER_NOT_SET;
+    }
+
+    const ctl_voltage_frequency_point_t *pPoints = pCustomVFCurveTable;
+    bool Valid                                   = (NumPoints >= 2);
+    for (uint32_t i = 0; Valid && (i < NumPoints); i++)
+    {
+        Valid = (pPoints[i].Voltage >= STUB_VF_LIMIT_MIN_MV) && (pPoints[i].Voltage <= STUB_VF_LIMIT_MAX_MV) && (pPoints[i].Frequency >= STUB_GPU_MIN_MHZ) &&
+                (pPoints[i].Frequency <= STUB_VF_LIMIT_MAX_MHZ) && ((0 == i) || ((pPoints[i].Voltage > pPoints[i - 1].Voltage) && (pPoints[i].Frequency >= pPoints[i - 1].Frequency)));
+    }
+    if (!Valid)
+    {
+        return CTL_RESULT_ERROR_CORE_OVERCLOCK_INVALID_CUSTOM_VF_CURVE;
+    }
+
+    // The curve runs at the voltages of the elaborate curve, so the points
+    // written are interpolated there and rounded down to a frequency step
+    uint32_t j = 0;
+    for (uint32_t i = 0; i < STUB_VF_POINTS; i++)
+    {
+        ctl_voltage_frequency_point_t &Point = hDeviceAdapter->vfLive[i];
+        while ((j + 2 < NumPoints) && (pPoints[j + 1].Voltage < Point.Voltage))
+        {
+            j++;
+        }
+        double Fraction = StubClamp((static_cast<double>(Point.Voltage) - pPoints[j].Voltage) / (static_cast<double>(pPoints[j + 1].Voltage) - pPoints[j].Voltage), 0.0, 1.0);
+        double Mhz      = pPoints[j].Frequency + (static_cast<double>(pPoints[j + 1].Frequency) - pPoints[j].Frequency) * Fraction;
+        Point.Frequency = static_cast<uint32_t>(Mhz) / STUB_VF_FREQ_STEP_MHZ * STUB_VF_FREQ_STEP_MHZ;
+    }
+    StubVfOperatingPoint(hDeviceAdapter);
+    return CTL_RESULT_SUCCESS;
+}
@@ -0,0 +1,1048 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  TelemetryAgent_App.cpp
+ * @brief Node telemetry agent. Samples every adapter in the background and
+ *        serves the cached snapshots on /metrics.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "igcl_api.h"
+#include "TelemetryCache.h"
+#include "MetricsExporter.h"
+#include "SharedTelemetry.h"
+#include "EngineUtilizationTracker.h"
+#include "MemoryBandwidthMonitor.h"
+#include "PcieLinkMonitor.h"
+#include "EccMonitor.h"
+#include "TelemetryHistograms.h"
+#include "ParallelCollector.h"
+#include "PowerRails.h"
+#include "SnapshotDelta.h"
+#include "TimeSeriesStore.h"
+#include "ThrottleAttribution.h"
+#include "AlertEngine.h"
+#include "AnomalyDetector.h"
+#include "ClockCorrelation.h"
+#include "EnergyAccounting.h"
+#include "FanControl.h"
+#include "PowerGovernor.h"
+#include "FrequencyGovernor.h"
+
+#define AGENT_LOG_INFO(fmt, ...) printf("[INFO] " fmt "\n", ##__VA_ARGS__)
+#define AGENT_LOG_ERROR(fmt, ...) printf("[ERROR] " fmt "\n", ##__VA_ARGS__)
+
+struct AgentOptions
+{
+    const char *pBindAddress;
+    uint16_t port;
+    uint32_t periodMs;
+    uint32_t durationSec;    ///< 0 runs until Enter is pressed
+    const char *pSharedName; ///< Shared memory segment to publish to, nullptr to not publish
+    uint32_t enginePeriodMs; ///< Engine tracker period, 0 leaves the tracker off
+    uint32_t memoryPeriodMs; ///< Memory bandwidth monitor period, 0 leaves it off
+    uint32_t pciePeriodMs;   ///< PCIe link monitor period, 0 leaves it off
+    uint32_t eccPeriodMs;    ///< ECC monitor period, 0 leaves it off
+    bool throttleReport;     ///< Print the throttle breakdown of the run on exit
+    bool alerts;             ///< Log temperature, power, fan and PSU alerts
+    uint32_t maxPeriodMs;    ///< Longest adaptive period, 0 samples every adapter each periodMs
+    bool anomalies;          ///< Log spikes, drifts and seasonal deviations
+    bool clockReport;        ///< Print the offset and drift of every driver clock domain on exit
+    bool energyReport;       ///< Print the energy of the run on exit
+    double fanTargetC;       ///< GPU temperature held by the fan controller, 0 leaves the fans alone
+    bool powerGovernor;      ///< Search the sustained power limit for the most work per joule
+    bool freqGovernor;       ///< Narrow the frequency ranges in memory bound and idle phases
+    PcieLinkPolicy pciePolicy;
+    ctl_ecc_state_t eccApply; ///< Set on every adapter at start, CTL_ECC_STATE_MAX to leave ECC alone
+    uint32_t histogramSec;    ///< Percentile window length, 0 leaves the histograms off
+    bool parallel;            ///< Sample every adapter on its own thread
+    ParallelCollectorConfig collector;
+    double railTolerancePct; ///< Mismatch counted by the PSU rail breakdown, 0 leaves it off
+    uint32_t deltaSinkCount; ///< Change only emission is off without sinks
+    const char *pDeltaSinks[SNAPSHOT_DELTA_MAX_SINKS];
+};
+
+static void PrintUsage()
+{
+    printf("Usage: Telemetry_Agent [-a address] [-p port] [-i period_ms] [-t seconds] [-s name] [-e period_ms] [-m period_ms] [-l period_ms] [-k allow|block] [-x period_ms] [-y enable|disable|default] [-q window_sec] [-u] [-z core,...] [-b] [-r] [-w] [-v max_period_ms] [-n] [-c] [-j] [-f target_c] [-g] [-d] [-o tolerance_pct] [-D log:path|udp:address:port]\n");
+    printf("    -a  Listen address, default %s\n", METRICS_EXPORTER_DEFAULT_ADDRESS);
+    printf("    -p  Listen port, default %u\n", METRICS_EXPORTER_DEFAULT_PORT);
+    printf("    -i  Sampling period in milliseconds, default %u\n", TELEMETRY_CACHE_DEFAULT_PERIOD_MS);
+    printf("    -t  Run time in seconds, default runs until Enter is pressed\n");
+    printf("    -s  Also publish to the named shared memory segment, e.g. %s\n", SHARED_TELEMETRY_DEFAULT_NAME);
+    printf("    -e  Track engine group utilization every period_ms, e.g. %u\n", ENGINE_TRACKER_DEFAULT_PERIOD_MS);
+    printf("    -m  Monitor VRAM bandwidth every period_ms, e.g. %u\n", MEM_BW_DEFAULT_PERIOD_MS);
+    printf("    -l  Track the PCIe link generation and width every period_ms, e.g. %u\n", PCIE_LINK_DEFAULT_PERIOD_MS);
+    printf("    -k  Allow faster PCIe link speeds once a busy link runs slow, or block them once it keeps dropping; implies -l\n");
+    printf("    -x  Track the current and pending ECC state every period_ms, e.g. %u\n", ECC_MONITOR_DEFAULT_PERIOD_MS);
+    printf("    -y  Set ECC on every adapter at once at start and verify it; implies -x\n");
+    printf("    -q  Keep percentiles of power, clocks, temperatures and engine utilization over the run and windows of window_sec, e.g. %u\n",
+           static_cast<uint32_t>(TELEMETRY_HISTOGRAM_DEFAULT_WINDOW_SEC));
+    printf("    -u  Sample every adapter on its own thread on a common tick and report the skew between adapters\n");
+    printf("    -z  Pin the thread of adapter i to the i-th core of the list, e.g. 2,3,4,5; implies -u\n");
+    printf("    -b  Start every tick on all adapters together, after the slowest finished the last one; implies -u\n");
+    printf("    -r  Report how long each adapter was throttled and why on exit\n");
+    printf("    -w  Log temperature, power, fan and PSU alerts with the default rules\n");
+    printf("    -n  Log spikes, slow drifts and seasonal deviations of power, clocks, temperatures, fans and VRAM bandwidth\n");
+    printf("    -c  Report the offset, drift and error bound of every driver clock domain against the host clock on exit\n");
+    printf("    -j  Report the energy, average and peak power of every adapter over the run on exit\n");
+    printf("    -f  Drive the fan speed tables to hold the GPU at target_c, e.g. 70\n");
+    printf("    -g  Lower the sustained power limit while work per joule improves, giving up at most 10 %% of throughput\n");
+    printf("    -d  Narrow the frequency ranges while the workload is memory bound or idle\n");
+    printf("    -o  Break the input power down by PSU rail and compare it with the card energy counter, counting mismatches beyond tolerance_pct, e.g. %.0f\n",
+           POWER_RAIL_DEFAULT_TOLERANCE_PCT);
+    printf("    -D  Emit only the telemetry, frequency and temperature fields that moved beyond their deadband, as text lines to a file or - for stdout, or as datagrams; repeatable up to %u times\n",
+           SNAPSHOT_DELTA_MAX_SINKS);
+    printf("    -v  Vary each adapter's period between -i and max_period_ms with its power and activity, e.g. %u, not with -u/-z/-b\n", ADAPTIVE_SAMPLING_DEFAULT_MAX_MS);
+}
+
+/***************************************************************
+ * @brief Reads a comma separated list of cores, one per adapter in order
+ ***************************************************************/
+static bool ParseCoreList(const char *pList, ParallelCollectorConfig *pConfig)
+{
+    uint32_t Adapter = 0;
+    for (const char *p = pList; '\0' != *p; Adapter++)
+    {
+        char *pEnd;
+        long Cpu = strtol(p, &pEnd, 10);
+        if ((pEnd == p) || (Cpu < 0) || (Adapter >= AGENT_MAX_ADAPTERS) || ((',' != *pEnd) && ('\0' != *pEnd)))
+        {
+            return false;
+        }
+        pConfig->cpu[Adapter] = static_cast<int32_t>(Cpu);
+        p                     = (',' == *pEnd) ? pEnd + 1 : pEnd;
+    }
+    return 0 != Adapter;
+}
+
+/***************************************************************
+ * @brief Opens the sink of a -D option and adds it to the encoder
+ ***************************************************************/
+static ctl_result_t OpenDeltaSink(SnapshotDeltaEncoder *pDelta, const char *pSpec, FILE **ppLog, SnapshotDeltaUdpSink **ppUdp)
+{
+    if (0 == strncmp(pSpec, "log:", 4))
+    {
+        *ppLog = (0 == strcmp(pSpec + 4, "-")) ? stdout : fopen(pSpec + 4, "w");
+        if (nullptr == *ppLog)
+        {
+            AGENT_LOG_ERROR("Cannot open %s", pSpec + 4);
+            return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+        return SnapshotDeltaAddSink(pDelta, SnapshotDeltaLogSink, *ppLog);
+    }
+
+    // udp:address:port
+    char Address[64];
+    const char *pPort = strrchr(pSpec + 4, ':');
+    int Port          = (nullptr != pPort) ? atoi(pPort + 1) : 0;
+    if ((nullptr == pPort) || (Port <= 0) || (Port > 65535) || (static_cast<size_t>(pPort - pSpec - 4) >= sizeof(Address)))
+    {
+        AGENT_LOG_ERROR("Expected udp:address:port, got %s", pSpec);
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+    snprintf(Address, sizeof(Address), "%.*s", static_cast<int>(pPort - pSpec - 4), pSpec + 4);
+
+    *ppUdp              = new SnapshotDeltaUdpSink();
+    ctl_result_t Result = SnapshotDeltaUdpSinkOpen(*ppUdp, Address, static_cast<uint16_t>(Port));
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        AGENT_LOG_ERROR("Cannot send datagrams to %s:%d", Address, Port);
+        return Result;
+    }
+    return SnapshotDeltaAddSink(pDelta, SnapshotDeltaUdpSend, *ppUdp);
+}
+
+static bool ParseOptions(int argc, char *argv[], AgentOptions *pOptions)
+{
+    pOptions->pBindAddress   = METRICS_EXPORTER_DEFAULT_ADDRESS;
+    pOptions->port           = METRICS_EXPORTER_DEFAULT_PORT;
+    pOptions->periodMs       = TELEMETRY_CACHE_DEFAULT_PERIOD_MS;
+    pOptions->durationSec    = 0;
+    pOptions->pSharedName    = nullptr;
+    pOptions->enginePeriodMs = 0;
+    pOptions->memoryPeriodMs = 0;
+    pOptions->pciePeriodMs   = 0;
+    pOptions->eccPeriodMs    = 0;
+    pOptions->eccApply       = CTL_ECC_STATE_MAX;
+    pOptions->throttleReport = false;
+    pOptions->alerts         = false;
+    pOptions->maxPeriodMs    = 0;
+    pOptions->anomalies      = false;
+    pOptions->clockReport    = false;
+    pOptions->energyReport   = false;
+    pOptions->fanTargetC     = 0.0;
+    pOptions->powerGovernor  = false;
+    pOptions->freqGovernor   = false;
+    pOptions->pciePolicy     = PCIE_LINK_OBSERVE;
+    pOptions->histogramSec   = 0;
+    pOptions->parallel       = false;
+    ParallelCollectorDefaultConfig(&pOptions->collector);
+    pOptions->railTolerancePct = 0.0;
+    pOptions->deltaSinkCount   = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((i + 1 < argc) && (0 == strcmp(argv[i], "-a")))
+        {
+            pOptions->pBindAddress = argv[++i];
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-p")))
+        {
+            pOptions->port = static_cast<uint16_t>(atoi(argv[++i]));
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-i")))
+        {
+            pOptions->periodMs = static_cast<uint32_t>(atoi(argv[++i]));
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-t")))
+        {
+            pOptions->durationSec = static_cast<uint32_t>(atoi(argv[++i]));
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-s")))
+        {
+            pOptions->pSharedName = argv[++i];
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-e")))
+        {
+            pOptions->enginePeriodMs = static_cast<uint32_t>(atoi(argv[++i]));
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-m")))
+        {
+            pOptions->memoryPeriodMs = static_cast<uint32_t>(atoi(argv[++i]));
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-l")))
+        {
+            pOptions->pciePeriodMs = static_cast<uint32_t>(atoi(argv[++i]));
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-k")))
+        {
+            i++;
+            if (0 == strcmp(argv[i], "allow"))
+            {
+                pOptions->pciePolicy = PCIE_LINK_ALLOW_ON_DOWNGRADE;
+            }
+            else if (0 == strcmp(argv[i], "block"))
+            {
+                pOptions->pciePolicy = PCIE_LINK_BLOCK_ON_FLAPPING;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-x")))
+        {
+            pOptions->eccPeriodMs = static_cast<uint32_t>(atoi(argv[++i]));
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-y")))
+        {
+            i++;
+            if (0 == strcmp(argv[i], "enable"))
+            {
+                pOptions->eccApply = CTL_ECC_STATE_ECC_ENABLED_STATE;
+            }
+            else if (0 == strcmp(argv[i], "disable"))
+            {
+                pOptions->eccApply = CTL_ECC_STATE_ECC_DISABLED_STATE;
+            }
+            else if (0 == strcmp(argv[i], "default"))
+            {
+                pOptions->eccApply = CTL_ECC_STATE_ECC_DEFAULT_STATE;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-q")))
+        {
+            pOptions->histogramSec = static_cast<uint32_t>(atoi(argv[++i]));
+        }
+        else if (0 == strcmp(argv[i], "-u"))
+        {
+            pOptions->parallel = true;
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-z")))
+        {
+            pOptions->parallel = true;
+            if (!ParseCoreList(argv[++i], &pOptions->collector))
+            {
+                return false;
+            }
+        }
+        else if (0 == strcmp(argv[i], "-b"))
+        {
+            pOptions->parallel              = true;
+            pOptions->collector.tickBarrier = true;
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-v")))
+        {
+            pOptions->maxPeriodMs = static_cast<uint32_t>(atoi(argv[++i]));
+        }
+        else if (0 == strcmp(argv[i], "-r"))
+        {
+            pOptions->throttleReport = true;
+        }
+        else if (0 == strcmp(argv[i], "-w"))
+        {
+            pOptions->alerts = true;
+        }
+        else if (0 == strcmp(argv[i], "-n"))
+        {
+            pOptions->anomalies = true;
+        }
+        else if (0 == strcmp(argv[i], "-c"))
+        {
+            pOptions->clockReport = true;
+        }
+        else if (0 == strcmp(argv[i], "-j"))
+        {
+            pOptions->energyReport = true;
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-f")))
+        {
+            pOptions->fanTargetC = atof(argv[++i]);
+        }
+        else if (0 == strcmp(argv[i], "-g"))
+        {
+            pOptions->powerGovernor = true;
+        }
+        else if (0 == strcmp(argv[i], "-d"))
+        {
+            pOptions->freqGovernor = true;
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-o")))
+        {
+            pOptions->railTolerancePct = atof(argv[++i]);
+            if (!(pOptions->railTolerancePct > 0.0))
+            {
+                return false;
+            }
+        }
+        else if ((i + 1 < argc) && (0 == strcmp(argv[i], "-D")))
+        {
+            const char *pSpec = argv[++i];
+            if ((pOptions->deltaSinkCount >= SNAPSHOT_DELTA_MAX_SINKS) || ((0 != strncmp(pSpec, "log:", 4)) && (0 != strncmp(pSpec, "udp:", 4))))
+            {
+                return false;
+            }
+            pOptions->pDeltaSinks[pOptions->deltaSinkCount++] = pSpec;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if ((PCIE_LINK_OBSERVE != pOptions->pciePolicy) && (0 == pOptions->pciePeriodMs))
+    {
+        pOptions->pciePeriodMs = PCIE_LINK_DEFAULT_PERIOD_MS;
+    }
+    if ((CTL_ECC_STATE_MAX != pOptions->eccApply) && (0 == pOptions->eccPeriodMs))
+    {
+        pOptions->eccPeriodMs = ECC_MONITOR_DEFAULT_PERIOD_MS;
+    }
+
+    // Per adapter periods do not fit the common ticks of the parallel collector
+    if (pOptions->parallel && (0 != pOptions->maxPeriodMs))
+    {
+        AGENT_LOG_ERROR("-v cannot be combined with -u/-z/-b");
+        return false;
+    }
+    return true;
+}
+
+/***************************************************************
+ * @brief Logs alerts from the sampler thread
+ ***************************************************************/
+static void LogAlert(const AlertEvent *pEvent, void *pContext)
+{
+    const AlertRule *pRule = &static_cast<AlertEngine *>(pContext)->rules[pEvent->ruleId];
+    char Metric[64];
+    AlertMetricName(&pRule->metric, Metric, sizeof(Metric));
+    if (ALERT_EVENT_RAISED == pEvent->type)
+    {
+        AGENT_LOG_INFO("Adapter %u: alert %s raised, %s %.2f crossed %.2f", pEvent->adapterIndex, pRule->name, Metric, pEvent->value, pEvent->threshold);
+    }
+    else
+    {
+        AGENT_LOG_INFO("Adapter %u: alert %s cleared after %.1f s, %s %.2f", pEvent->adapterIndex, pRule->name, pEvent->activeNs / 1e9, Metric, pEvent->value);
+    }
+}
+
+/***************************************************************
+ * @brief Logs anomalies from the sampler thread
+ ***************************************************************/
+static void LogAnomaly(const AnomalyEvent *pEvent, void *pContext)
+{
+    (void)pContext;
+    char Stream[32];
+    AnomalyStreamLabel(pEvent->stream, Stream, sizeof(Stream));
+    AGENT_LOG_INFO("Adapter %u: %s %s %s, %.2f against %.2f (score %.1f)", pEvent->adapterIndex, Stream, AnomalyKindLabel(pEvent->kind), pEvent->raised ? "raised" : "cleared", pEvent->value,
+                   pEvent->expected, pEvent->score);
+}
+
+/***************************************************************
+ * @brief Logs the median, p95 and p99 of every metric recorded in a set
+ ***************************************************************/
+static void LogHistogramSet(const TelemetryHistogramSet *pSet, const char *pSpan)
+{
+    for (uint32_t m = 0; m < TELEMETRY_HISTOGRAM_METRIC_COUNT; m++)
+    {
+        const QuantileHistogram *pHistogram = &pSet->metrics[m];
+        if (0 == pHistogram->totalCount)
+        {
+            continue;
+        }
+        char Metric[48];
+        const char *pLabel = TelemetryHistogramMetricLabel(static_cast<TelemetryHistogramMetric>(m));
+        if (m >= TELEMETRY_HISTOGRAM_ENGINE_0)
+        {
+            snprintf(Metric, sizeof(Metric), "%s %u", pLabel, m - TELEMETRY_HISTOGRAM_ENGINE_0);
+        }
+        else
+        {
+            snprintf(Metric, sizeof(Metric), "%s", pLabel);
+        }
+        AGENT_LOG_INFO("Adapter %u: %s %s over %.1f s, p50 %.1f, p95 %.1f, p99 %.1f, max %.1f", pSet->adapterIndex, pSpan, Metric, pHistogram->totalCount / 1e3,
+                       QuantileHistogramPercentile(pHistogram, 50.0), QuantileHistogramPercentile(pHistogram, 95.0), QuantileHistogramPercentile(pHistogram, 99.0), pHistogram->max);
+    }
+}
+
+/***************************************************************
+ * @brief Logs every closed window from the sampler thread
+ ***************************************************************/
+static void LogHistogramWindow(const TelemetryHistogramSet *pWindow, void *pContext)
+{
+    (void)pContext;
+    LogHistogramSet(pWindow, "window");
+}
+
+/***************************************************************
+ * @brief Main Function
+ ***************************************************************/
+int main(int argc, char *argv[])
+{
+    AgentOptions Options;
+    if (!ParseOptions(argc, argv, &Options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    ctl_init_args_t CtlInitArgs = {};
+    ctl_api_handle_t hAPIHandle = nullptr;
+    CtlInitArgs.AppVersion      = CTL_MAKE_VERSION(CTL_IMPL_MAJOR_VERSION, CTL_IMPL_MINOR_VERSION);
+    CtlInitArgs.flags           = CTL_INIT_FLAG_USE_LEVEL_ZERO;
+    CtlInitArgs.Size            = sizeof(CtlInitArgs);
+    CtlInitArgs.Version         = 0;
+
+    ctl_result_t Result = ctlInit(&CtlInitArgs, &hAPIHandle);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        AGENT_LOG_ERROR("ctlInit returned failure code: 0x%X", Result);
+        return 1;
+    }
+
+    uint32_t AdapterCount = 0;
+    std::vector<ctl_device_adapter_handle_t> Devices;
+    TelemetryCache *pCache                   = new TelemetryCache();
+    MetricsExporter *pExporter               = new MetricsExporter();
+    SharedTelemetryPublisher Publisher       = {};
+    TimeSeriesStore *pSeriesStore            = nullptr;
+    EngineUtilizationTracker *pEngineTracker = nullptr;
+    MemoryBandwidthMonitor *pMemoryMonitor   = nullptr;
+    PcieLinkMonitor *pPcieMonitor            = nullptr;
+    EccMonitor *pEccMonitor                  = nullptr;
+    ThrottleAttributor *pThrottle            = nullptr;
+    AlertEngine *pAlerts                     = nullptr;
+    AdaptiveSamplingController *pRateControl = nullptr;
+    AnomalyDetector *pAnomalies              = nullptr;
+    ClockCorrelator *pClocks                 = nullptr;
+    EnergyAccountant *pEnergy                = nullptr;
+    FanController *pFans                     = nullptr;
+    PowerGovernor *pGovernor                 = nullptr;
+    FrequencyGovernor *pFreqGovernor         = nullptr;
+    TelemetryHistograms *pHistograms         = nullptr;
+    ParallelCollector *pCollector            = nullptr;
+    PowerRailDecoder *pRails                 = nullptr;
+    SnapshotDeltaEncoder *pDelta             = nullptr;
+    uint32_t ThrottleWindowId                = THROTTLE_INVALID_WINDOW;
+    uint32_t EnergyWindowId                  = ENERGY_INVALID_WINDOW;
+    AgentAdapterMask AllAdapters;
+    FILE *pDeltaLogs[SNAPSHOT_DELTA_MAX_SINKS]                = {};
+    SnapshotDeltaUdpSink *pDeltaUdp[SNAPSHOT_DELTA_MAX_SINKS] = {};
+
+    AgentAdapterMaskSetAll(&AllAdapters);
+    Result = ctlEnumerateDevices(hAPIHandle, &AdapterCount, nullptr);
+    if ((CTL_RESULT_SUCCESS != Result) || (0 == AdapterCount))
+    {
+        AGENT_LOG_ERROR("ctlEnumerateDevices returned failure code: 0x%X", Result);
+        goto Exit;
+    }
+
+    Devices.resize(AdapterCount);
+    Result = ctlEnumerateDevices(hAPIHandle, &AdapterCount, Devices.data());
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        AGENT_LOG_ERROR("ctlEnumerateDevices returned failure code: 0x%X", Result);
+        goto Exit;
+    }
+
+    Result = TelemetryCacheInit(pCache, Devices.data(), AdapterCount, Options.periodMs);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        AGENT_LOG_ERROR("TelemetryCacheInit returned failure code: 0x%X", Result);
+        goto Exit;
+    }
+
+    for (uint32_t i = 0; i < pCache->adapterCount; i++)
+    {
+        const AdapterTopology *pTopology = &pCache->topology[i];
+        AGENT_LOG_INFO("Adapter %u: %s, %u frequency domains, %u temperature sensors, %u fans, %u engine groups, %u memory modules", i, pTopology->name, pTopology->freqDomainCount,
+                       pTopology->tempSensorCount, pTopology->fanCount, pTopology->engineGroupCount, pTopology->memModuleCount);
+    }
+
+    if (nullptr != Options.pSharedName)
+    {
+        Result = SharedTelemetryPublisherCreate(&Publisher, pCache, Options.pSharedName);
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            AGENT_LOG_ERROR("SharedTelemetryPublisherCreate returned failure code: 0x%X", Result);
+            goto Exit;
+        }
+        AGENT_LOG_INFO("Publishing to shared memory segment %s", Options.pSharedName);
+    }
+
+    if (Options.throttleReport)
+    {
+        pThrottle = new ThrottleAttributor();
+        Result    = ThrottleAttributorInit(pThrottle, pCache, nullptr, nullptr);
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            Result = ThrottleWindowBegin(pThrottle, &AllAdapters, &ThrottleWindowId);
+        }
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            AGENT_LOG_ERROR("Throttle attribution returned failure code: 0x%X", Result);
+            goto Exit;
+        }
+    }
+
+    if (Options.energyReport)
+    {
+        pEnergy = new EnergyAccountant();
+        Result  = EnergyAccountantInit(pEnergy, pCache);
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            Result = EnergyWindowBegin(pEnergy, "run", &AllAdapters, &EnergyWindowId);
+        }
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            AGENT_LOG_ERROR("Energy accounting returned failure code: 0x%X", Result);
+            goto Exit;
+        }
+    }
+
+    if (Options.alerts)
+    {
+        pAlerts = new AlertEngine();
+        Result  = AlertEngineInit(pAlerts, pCache, LogAlert, pAlerts);
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            Result = AlertEngineAddDefaultRules(pAlerts);
+        }
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            AGENT_LOG_ERROR("Alert engine returned failure code: 0x%X", Result);
+            goto Exit;
+        }
+        AGENT_LOG_INFO("Evaluating %u alert rules over %u adapters", pAlerts->ruleCount, pCache->adapterCount);
+    }
+
+    if (Options.anomalies)
+    {
+        pAnomalies = new AnomalyDetector();
+        Result     = AnomalyDetectorInit(pAnomalies, nullptr, pCache, LogAnomaly, nullptr);
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            AGENT_LOG_ERROR("Anomaly detection returned failure code: 0x%X", Result);
+            goto Exit;
+        }
+    }
+
+    if (Options.clockReport)
+    {
+        pClocks = new ClockCorrelator();
+        Result  = ClockCorrelatorInit(pClocks, CLOCK_CORRELATION_DEFAULT_WINDOW_SEC, pCache);
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            AGENT_LOG_ERROR("Clock correlation returned failure code: 0x%X", Result);
+            goto Exit;
+        }
+    }
+
+    if (Options.fanTargetC > 0.0)
+    {
+        FanControlConfig FanConfig;
+        FanControlDefaultConfig(&FanConfig);
+        FanConfig.gpuTargetC = Options.fanTargetC;
+
+        pFans  = new FanController();
+        Result = FanControllerInit(pFans, &FanConfig, pCache);
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            AGENT_LOG_ERROR("Fan control returned failure code: 0x%X", Result);
+            goto Exit;
+        }
+    }
+
+    if (Options.powerGovernor)
+    {
+        pGovernor = new PowerGovernor();
+        Result    = PowerGovernorInit(pGovernor, nullptr, pCache);
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            AGENT_LOG_ERROR("Power governor returned failure code: 0x%X", Result);
+            goto Exit;
+        }
+    }
+
+    if (Options.freqGovernor)
+    {
+        pFreqGovernor = new FrequencyGovernor();
+        Result        = FreqGovernorInit(pFreqGovernor, nullptr, pCache);
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            AGENT_LOG_ERROR("Frequency governor returned failure code: 0x%X", Result);
+            goto Exit;
+        }
+    }
+
+    if (0 != Options.histogramSec)
+    {
+        pHistograms = new TelemetryHistograms();
+        Result      = TelemetryHistogramsInit(pHistograms, pCache, Options.histogramSec, LogHistogramWindow, nullptr);
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            AGENT_LOG_ERROR("Telemetry histograms returned failure code: 0x%X", Result);
+            goto Exit;
+        }
+        AGENT_LOG_INFO("Keeping percentiles over the run and every %u s", Options.histogramSec);
+    }
+
+    if (0 != Options.maxPeriodMs)
+    {
+        pRateControl = new AdaptiveSamplingController();
+        Result       = AdaptiveSamplingInit(pRateControl, pCache->periodMs, Options.maxPeriodMs, ADAPTIVE_SAMPLING_DEFAULT_TARGET_ERROR);
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            Result = TelemetryCacheAttachRateController(pCache, pRateControl);
+        }
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            AGENT_LOG_ERROR("Adaptive sampling returned failure code: 0x%X", Result);
+            goto Exit;
+        }
+        AGENT_LOG_INFO("Adapting the sampling period between %u and %u ms", pRateControl->minIntervalMs, pRateControl->maxIntervalMs);
+    }
+
+    if (Options.parallel)
+    {
+        pCollector = new ParallelCollector();
+        Result     = ParallelCollectorInit(pCollector, &Options.collector);
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            Result = TelemetryCacheAttachCollector(pCache, pCollector);
+        }
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            AGENT_LOG_ERROR("Parallel collection returned failure code: 0x%X", Result);
+            goto Exit;
+        }
+        AGENT_LOG_INFO("Sampling %u adapters on a thread each%s", pCache->adapterCount, Options.collector.tickBarrier ? ", starting every tick together" : "");
+    }
+
+    Result = MetricsExporterInit(pExporter, pCache, Options.pBindAddress, Options.port);
+    MetricsExporterAttachHistograms(pExporter, pHistograms);
+    MetricsExporterAttachCollector(pExporter, pCollector);
+    if ((0 != Options.enginePeriodMs) || (0 != Options.memoryPeriodMs) || (0.0 != Options.railTolerancePct))
+    {
+        pSeriesStore = new TimeSeriesStore();
+        TimeSeriesStoreInit(pSeriesStore, TIME_SERIES_DEFAULT_POINTS);
+    }
+    if ((CTL_RESULT_SUCCESS == Result) && (0 != Options.enginePeriodMs))
+    {
+        pEngineTracker = new EngineUtilizationTracker();
+        Result         = EngineTrackerInit(pEngineTracker, pCache->topology, pCache->adapterCount, Options.enginePeriodMs, pSeriesStore);
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            Result = EngineTrackerStart(pEngineTracker);
+        }
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            MetricsExporterAttachEngineTracker(pExporter, pEngineTracker);
+            AGENT_LOG_INFO("Tracking %u engine groups every %u ms", pEngineTracker->engineCount, pEngineTracker->periodMs);
+        }
+    }
+    if ((CTL_RESULT_SUCCESS == Result) && (0 != Options.memoryPeriodMs))
+    {
+        pMemoryMonitor = new MemoryBandwidthMonitor();
+        Result         = MemoryBandwidthInit(pMemoryMonitor, pCache->topology, pCache->adapterCount, Options.memoryPeriodMs, pCache, pSeriesStore);
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            MemoryBandwidthAttachClockCorrelator(pMemoryMonitor, pClocks);
+            Result = MemoryBandwidthStart(pMemoryMonitor);
+        }
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            MetricsExporterAttachMemoryMonitor(pExporter, pMemoryMonitor);
+            AGENT_LOG_INFO("Monitoring %u memory modules every %u ms", pMemoryMonitor->moduleCount, pMemoryMonitor->periodMs);
+        }
+    }
+    if ((CTL_RESULT_SUCCESS == Result) && (0 != Options.pciePeriodMs))
+    {
+        pPcieMonitor = new PcieLinkMonitor();
+        Result       = PcieLinkInit(pPcieMonitor, pCache->topology, pCache->adapterCount, Options.pciePeriodMs, Options.pciePolicy, pCache);
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            Result = PcieLinkStart(pPcieMonitor);
+        }
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            MetricsExporterAttachPcieMonitor(pExporter, pPcieMonitor);
+            AGENT_LOG_INFO("Tracking the PCIe links every %u ms, policy %s", pPcieMonitor->periodMs, PcieLinkPolicyLabel(pPcieMonitor->policy));
+        }
+    }
+    if ((CTL_RESULT_SUCCESS == Result) && (0 != Options.eccPeriodMs))
+    {
+        pEccMonitor = new EccMonitor();
+        Result      = EccMonitorInit(pEccMonitor, pCache->topology, pCache->adapterCount, Options.eccPeriodMs);
+        if ((CTL_RESULT_SUCCESS == Result) && (CTL_ECC_STATE_MAX != Options.eccApply))
+        {
+            EccApplyReport *pReport = new EccApplyReport();
+            Result                  = EccMonitorApply(pEccMonitor, Options.eccApply, pReport);
+            for (uint32_t i = 0; (CTL_RESULT_SUCCESS == Result) && (i < pReport->adapterCount); i++)
+            {
+                const EccApplyResult *pApplied = &pReport->results[i];
+                AGENT_LOG_INFO("Adapter %u: ECC %s, current %s, pending %s, write 0x%X in %.2f s, verify 0x%X", pApplied->adapterIndex, EccApplyOutcomeLabel(pApplied->outcome),
+                               EccStateLabel(pApplied->current), EccStateLabel(pApplied->pending), pApplied->setResult, pApplied->setSec, pApplied->verifyResult);
+            }
+            if (CTL_RESULT_SUCCESS == Result)
+            {
+                AGENT_LOG_INFO("Applied ECC %s to %u adapters in %.2f s: %u active, %u pending reboot, %u already set, %u not taken, %u failed, %u skipped", EccStateLabel(pReport->requested),
+                               pReport->adapterCount, pReport->elapsedSec, pReport->outcomeCount[ECC_APPLY_ACTIVE], pReport->outcomeCount[ECC_APPLY_PENDING_REBOOT],
+                               pReport->outcomeCount[ECC_APPLY_ALREADY], pReport->outcomeCount[ECC_APPLY_NOT_TAKEN], pReport->outcomeCount[ECC_APPLY_FAILED],
+                               pReport->outcomeCount[ECC_APPLY_SKIPPED]);
+            }
+            delete pReport;
+        }
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            Result = EccMonitorStart(pEccMonitor);
+        }
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            MetricsExporterAttachEccMonitor(pExporter, pEccMonitor);
+            AGENT_LOG_INFO("Tracking the ECC state every %u ms", pEccMonitor->periodMs);
+        }
+    }
+    if ((CTL_RESULT_SUCCESS == Result) && (0.0 != Options.railTolerancePct))
+    {
+        pRails = new PowerRailDecoder();
+        Result = PowerRailDecoderInit(pRails, pCache, Options.railTolerancePct, pSeriesStore);
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            MetricsExporterAttachPowerRails(pExporter, pRails);
+            AGENT_LOG_INFO("Breaking the input power down by PSU rail, mismatch tolerance %.1f %%", pRails->tolerancePct);
+        }
+    }
+    if ((CTL_RESULT_SUCCESS == Result) && (0 != Options.deltaSinkCount))
+    {
+        pDelta = new SnapshotDeltaEncoder();
+        Result = SnapshotDeltaInit(pDelta, pCache, nullptr);
+        for (uint32_t s = 0; (CTL_RESULT_SUCCESS == Result) && (s < Options.deltaSinkCount); s++)
+        {
+            Result = OpenDeltaSink(pDelta, Options.pDeltaSinks[s], &pDeltaLogs[s], &pDeltaUdp[s]);
+        }
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            MetricsExporterAttachSnapshotDelta(pExporter, pDelta);
+            AGENT_LOG_INFO("Emitting changed fields only to %u sinks, keyframe every %.0f s", pDelta->sinkCount, pDelta->config.keyframeSec);
+        }
+    }
+    if (CTL_RESULT_SUCCESS == Result)
+    {
+        Result = TelemetryCacheStart(pCache);
+    }
+    if (CTL_RESULT_SUCCESS == Result)
+    {
+        Result = MetricsExporterStart(pExporter);
+    }
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        AGENT_LOG_ERROR("Starting the agent returned failure code: 0x%X", Result);
+        goto Exit;
+    }
+
+    AGENT_LOG_INFO("Serving http://%s:%u/metrics, sampling every %u ms", pExporter->bindAddress, pExporter->port, pCache->periodMs);
+    if (0 != Options.durationSec)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(Options.durationSec));
+    }
+    else
+    {
+        AGENT_LOG_INFO("Press Enter to stop");
+        getchar();
+    }
+
+Exit:
+    MetricsExporterStop(pExporter);
+    TelemetryCacheStop(pCache);
+    EngineTrackerStop(pEngineTracker);
+    MemoryBandwidthStop(pMemoryMonitor);
+    PcieLinkStop(pPcieMonitor);
+    EccMonitorStop(pEccMonitor);
+    SharedTelemetryPublisherDestroy(&Publisher);
+    AGENT_LOG_INFO("Served %llu scrapes", static_cast<unsigned long long>(pExporter->scrapeCount));
+    for (uint32_t i = 0; (nullptr != pRateControl) && (i < pCache->adapterCount); i++)
+    {
+        AdaptiveSamplingStats Sampling;
+        AdaptiveSamplingRead(pRateControl, i, &Sampling);
+        AGENT_LOG_INFO("Adapter %u: %llu samples, %.1f Hz, next interval %u ms, estimated error %.2f %% (%s)", i, static_cast<unsigned long long>(Sampling.samples),
+                       Sampling.effectiveRateHz, Sampling.intervalMs, Sampling.estimatedErrorPct, AdaptiveSignalLabel(Sampling.dominant));
+    }
+    if (nullptr != pCollector)
+    {
+        ParallelCollectorStats *pStats = new ParallelCollectorStats();
+        ParallelCollectorRead(pCollector, pStats);
+        for (uint32_t i = 0; i < pStats->workerCount; i++)
+        {
+            const ParallelWorkerStats *pWorker = &pStats->workers[i];
+            char Pinning[48];
+            if (PARALLEL_COLLECTOR_UNPINNED == pWorker->cpu)
+            {
+                snprintf(Pinning, sizeof(Pinning), "unpinned");
+            }
+            else
+            {
+                snprintf(Pinning, sizeof(Pinning), "on core %d%s", pWorker->cpu, (CTL_RESULT_SUCCESS == pWorker->pinResult) ? "" : " (pinning failed)");
+            }
+            AGENT_LOG_INFO("Adapter %u: worker %s, %llu passes, last %.2f ms, max %.2f ms, %llu missed ticks, %.2f s at the barrier", i, Pinning,
+                           static_cast<unsigned long long>(pWorker->passes), 1e3 * pWorker->lastPassSec, 1e3 * pWorker->maxPassSec, static_cast<unsigned long long>(pWorker->missedTicks),
+                           pWorker->barrierWaitSec);
+        }
+        AGENT_LOG_INFO("%llu complete ticks, %llu partial, skew p50 %.0f us, p99 %.0f us, max %.0f us", static_cast<unsigned long long>(pStats->ticks),
+                       static_cast<unsigned long long>(pStats->partialTicks), QuantileHistogramPercentile(&pStats->skewUs, 50.0), QuantileHistogramPercentile(&pStats->skewUs, 99.0),
+                       1e6 * pStats->maxSkewSec);
+        delete pStats;
+    }
+    for (uint32_t i = 0; (nullptr != pFans) && (i < pCache->adapterCount); i++)
+    {
+        FanControlStats Fan;
+        FanControllerRead(pFans, i, &Fan);
+        AGENT_LOG_INFO("Adapter %u: %u fans %s, GPU %.1f C, command %.0f %%, %llu table writes, %llu suppressed, %llu failures, %llu fallbacks", i, Fan.fanCount,
+                       FanControlStateLabel(Fan.state), Fan.gpuC, Fan.commandPct, static_cast<unsigned long long>(Fan.writes), static_cast<unsigned long long>(Fan.suppressed),
+                       static_cast<unsigned long long>(Fan.failures), static_cast<unsigned long long>(Fan.fallbacks));
+    }
+    FanControllerRelease(pFans);
+    for (uint32_t i = 0; (nullptr != pGovernor) && (i < pCache->adapterCount); i++)
+    {
+        PowerGovernorStats Governor;
+        PowerGovernorRead(pGovernor, i, &Governor);
+        AGENT_LOG_INFO("Adapter %u: power governor %s, limit %.1f W of %.1f W, throughput %.1f %%, work per joule %+.1f %%, %llu probes, %llu accepted, %llu writes, %llu failures",
+                       i, PowerGovernorStateLabel(Governor.state), Governor.limitMw / 1000.0, Governor.originalMw / 1000.0, 100.0 * Governor.throughputRatio,
+                       100.0 * (Governor.efficiencyRatio - 1.0), static_cast<unsigned long long>(Governor.probes), static_cast<unsigned long long>(Governor.accepted),
+                       static_cast<unsigned long long>(Governor.writes), static_cast<unsigned long long>(Governor.failures));
+    }
+    PowerGovernorRelease(pGovernor);
+    for (uint32_t i = 0; (nullptr != pFreqGovernor) && (i < pCache->adapterCount); i++)
+    {
+        FreqGovernorStats Freq;
+        FreqGovernorRead(pFreqGovernor, i, &Freq);
+        AGENT_LOG_INFO("Adapter %u: frequency governor %s in %s phase, %u domains, %llu transitions, %llu writes, %llu failures", i, FreqGovernorStateLabel(Freq.state),
+                       FreqPhaseLabel(Freq.phase), Freq.domainCount, static_cast<unsigned long long>(Freq.transitions), static_cast<unsigned long long>(Freq.writes),
+                       static_cast<unsigned long long>(Freq.failures));
+        for (uint32_t p = FREQ_PHASE_COMPUTE; p < FREQ_PHASE_COUNT; p++)
+        {
+            if (Freq.phaseSec[p] > 0.0)
+            {
+                AGENT_LOG_INFO("Adapter %u:   %s %.1f s, %.1f W average", i, FreqPhaseLabel(static_cast<FreqPhase>(p)), Freq.phaseSec[p], Freq.phaseEnergyJ[p] / Freq.phaseSec[p]);
+            }
+        }
+    }
+    FreqGovernorRelease(pFreqGovernor);
+    for (uint32_t i = 0; (nullptr != pPcieMonitor) && (i < pCache->adapterCount); i++)
+    {
+        PcieLinkStats Link;
+        PcieLinkRead(pPcieMonitor, i, &Link);
+        AGENT_LOG_INFO("Adapter %u: PCIe gen %d x%d of gen %d x%d, %llu changes, %llu downgrades (%llu busy), degraded %.1f s (%.1f s busy)%s", i, Link.speed.gen, Link.speed.width,
+                       Link.maxSpeed.gen, Link.maxSpeed.width, static_cast<unsigned long long>(Link.changes), static_cast<unsigned long long>(Link.downgrades),
+                       static_cast<unsigned long long>(Link.busyDowngrades), Link.degradedSec, Link.degradedBusySec, Link.flapping ? ", flapping" : "");
+        for (uint32_t b = 0; b < 2; b++)
+        {
+            for (uint32_t g = 0; g < PCIE_LINK_MAX_GEN; g++)
+            {
+                for (uint32_t w = 0; w < PCIE_LINK_WIDTH_BUCKETS; w++)
+                {
+                    if (Link.stateSec[b][g][w] > 0.0)
+                    {
+                        AGENT_LOG_INFO("Adapter %u:   gen %u x%u %s %.1f s", i, g + 1, PcieLinkBucketWidth(w), (0 != b) ? "busy" : "idle", Link.stateSec[b][g][w]);
+                    }
+                }
+            }
+        }
+        if (Link.policyApplied)
+        {
+            AGENT_LOG_INFO("Adapter %u:   %s faster link speeds, result 0x%X", i, Link.policyAllowed ? "allowed" : "blocked", Link.policyResult);
+        }
+    }
+    for (uint32_t i = 0; (nullptr != pEccMonitor) && (i < pCache->adapterCount); i++)
+    {
+        EccAdapterStats Ecc;
+        EccMonitorRead(pEccMonitor, i, &Ecc);
+        if (Ecc.valid)
+        {
+            AGENT_LOG_INFO("Adapter %u: ECC %s, pending %s%s%s", i, EccStateLabel(Ecc.current), EccStateLabel(Ecc.pending), Ecc.rebootPending ? ", reboot required" : "",
+                           Ecc.requestMismatch ? ", not the state applied" : "");
+        }
+    }
+    for (uint32_t i = 0; (nullptr != pClocks) && (i < pCache->adapterCount); i++)
+    {
+        for (uint32_t d = 0; d < CLOCK_DOMAIN_COUNT; d++)
+        {
+            ClockDomainStats Clock;
+            ClockCorrelatorRead(pClocks, i, static_cast<ClockDomain>(d), &Clock);
+            if (Clock.valid)
+            {
+                AGENT_LOG_INFO("Adapter %u: %s clock offset %.6f s, drift %+.2f ppm, residual %.0f ns, bound %.0f ns, %llu observations, %llu rejected, %llu restarts", i,
+                               ClockDomainLabel(Clock.domain), Clock.offsetSec, Clock.driftPpm, Clock.residualRmsNs, Clock.errorBoundNs, static_cast<unsigned long long>(Clock.observations),
+                               static_cast<unsigned long long>(Clock.rejected), static_cast<unsigned long long>(Clock.resets));
+            }
+        }
+    }
+    for (uint32_t i = 0; (nullptr != pHistograms) && (i < pCache->adapterCount); i++)
+    {
+        TelemetryHistogramSet *pRun = new TelemetryHistogramSet();
+        TelemetryHistogramsRead(pHistograms, i, false, pRun);
+        LogHistogramSet(pRun, "run");
+        delete pRun;
+    }
+    for (uint32_t i = 0; (nullptr != pRails) && (i < pCache->adapterCount); i++)
+    {
+        PowerRailStats Rails;
+        char Breakdown[512];
+        size_t Length = 0;
+        PowerRailDecoderRead(pRails, i, &Rails);
+        Breakdown[0] = '\0';
+        for (uint32_t r = 0; (r < CTL_PSU_COUNT) && (Length < sizeof(Breakdown)); r++)
+        {
+            const PowerRail *pRail = &Rails.rails[r];
+            if (0 != (Rails.railMask & CTL_BIT(r)))
+            {
+                Length += snprintf(Breakdown + Length, sizeof(Breakdown) - Length, "%s%u %s %.2f V %.1f W peak %.1f W (%.0f %%)", (0 != Length) ? ", " : "", r,
+                                   PowerRailTypeLabel(pRail->type), pRail->voltageV, pRail->powerW, pRail->peakW, pRail->loadPct);
+            }
+        }
+        if (0 == Rails.railMask)
+        {
+            AGENT_LOG_INFO("Adapter %u: no PSU rails reported", i);
+            continue;
+        }
+        AGENT_LOG_INFO("Adapter %u: rails %s; input %.1f W, card %.1f W, mismatch %+.1f W (%+.1f %%), average %+.1f W, %llu of %llu intervals beyond %.1f %%", i, Breakdown,
+                       Rails.inputPowerW, Rails.cardPowerW, Rails.mismatchW, Rails.mismatchPct, Rails.averageMismatchW, static_cast<unsigned long long>(Rails.mismatches),
+                       static_cast<unsigned long long>(Rails.intervals), pRails->tolerancePct);
+    }
+    for (uint32_t i = 0; (nullptr != pDelta) && (i < pCache->adapterCount); i++)
+    {
+        SnapshotDeltaStats Delta;
+        SnapshotDeltaRead(pDelta, i, &Delta);
+        if (0 == Delta.passes)
+        {
+            continue;
+        }
+        AGENT_LOG_INFO("Adapter %u: %llu frames over %llu passes, %llu keyframes, %.1f of %.1f fields per pass, %llu of %llu bytes (%.1f %%)", i,
+                       static_cast<unsigned long long>(Delta.frames), static_cast<unsigned long long>(Delta.passes), static_cast<unsigned long long>(Delta.keyframes),
+                       static_cast<double>(Delta.fieldsSent) / Delta.passes, static_cast<double>(Delta.fieldsSampled) / Delta.passes,
+                       static_cast<unsigned long long>(Delta.wireBytes), static_cast<unsigned long long>(Delta.fullWireBytes),
+                       (0 != Delta.fullWireBytes) ? 100.0 * Delta.wireBytes / Delta.fullWireBytes : 0.0);
+    }
+    for (uint32_t s = 0; s < SNAPSHOT_DELTA_MAX_SINKS; s++)
+    {
+        if (nullptr != pDeltaUdp[s])
+        {
+            if (0 != pDeltaUdp[s]->sendErrors)
+            {
+                AGENT_LOG_INFO("Snapshot delta sink %u: %llu datagrams failed to send", s, static_cast<unsigned long long>(pDeltaUdp[s]->sendErrors));
+            }
+            SnapshotDeltaUdpSinkClose(pDeltaUdp[s]);
+            delete pDeltaUdp[s];
+        }
+        if ((nullptr != pDeltaLogs[s]) && (stdout != pDeltaLogs[s]))
+        {
+            fclose(pDeltaLogs[s]);
+        }
+    }
+    if ((nullptr != pThrottle) && (THROTTLE_INVALID_WINDOW != ThrottleWindowId))
+    {
+        ThrottleSummary Summary;
+        char Line[THROTTLE_REPORT_LINE_LEN];
+        ThrottleWindowEnd(pThrottle, ThrottleWindowId, &Summary);
+        for (uint32_t i = 0; i < Summary.adapterCount; i++)
+        {
+            ThrottleAdapterSummaryFormat(&Summary.adapters[i], Line, sizeof(Line));
+            printf("%s", Line);
+        }
+    }
+    if ((nullptr != pEnergy) && (ENERGY_INVALID_WINDOW != EnergyWindowId))
+    {
+        EnergyReport *pReport = new EnergyReport();
+        char Line[ENERGY_REPORT_LINE_LEN];
+        EnergyWindowEnd(pEnergy, EnergyWindowId, 0.0, pReport);
+        for (uint32_t i = 0; i < pReport->adapterCount; i++)
+        {
+            EnergyAdapterReportFormat(pReport, i, Line, sizeof(Line));
+            printf("%s", Line);
+        }
+        delete pReport;
+    }
+
+    delete pExporter;
+    delete pCache;
+    delete pEngineTracker;
+    delete pMemoryMonitor;
+    delete pPcieMonitor;
+    delete pEccMonitor;
+    delete pSeriesStore;
+    delete pThrottle;
+    delete pAlerts;
+    delete pRateControl;
+    delete pAnomalies;
+    delete pClocks;
+    delete pEnergy;
+    delete pFans;
+    delete pGovernor;
+    delete pFreqGovernor;
+    delete pHistograms;
+    delete pCollector;
+    delete pRails;
+    delete pDelta;
+    ctlClose(hAPIHandle);
+
+    return (CTL_RESULT_SUCCESS == Result) ? 0 : 1;
+}
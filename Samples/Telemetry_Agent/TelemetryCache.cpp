@@ -0,0 +1,288 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  TelemetryCache.cpp
+ * @brief Background sampler holding the latest snapshot of every adapter.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "TelemetryCache.h"
+#include "ParallelCollector.h"
+
+ctl_result_t TelemetryCacheInit(TelemetryCache *pCache, ctl_device_adapter_handle_t *phDevices, uint32_t DeviceCount, uint32_t PeriodMs)
+{
+    if ((nullptr == pCache) || (nullptr == phDevices))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pCache->adapterCount = 0;
+    pCache->periodMs     = (0 != PeriodMs) ? PeriodMs : TELEMETRY_CACHE_DEFAULT_PERIOD_MS;
+    pCache->stopRequested.store(false);
+    pCache->listenerCount   = 0;
+    pCache->pRateController = nullptr;
+    pCache->pCollector      = nullptr;
+    memset(pCache->nextDueNs, 0, sizeof(pCache->nextDueNs));
+    memset(pCache->previous, 0, sizeof(pCache->previous));
+    memset(pCache->decodePlan, 0, sizeof(pCache->decodePlan));
+    memset(&pCache->scratch, 0, sizeof(pCache->scratch));
+
+    for (uint32_t i = 0; (i < DeviceCount) && (pCache->adapterCount < AGENT_MAX_ADAPTERS); i++)
+    {
+        if (nullptr == phDevices[i])
+        {
+            continue;
+        }
+
+        uint32_t Index = pCache->adapterCount;
+        if (CTL_RESULT_SUCCESS == EnumerateAdapterTopology(phDevices[i], Index, &pCache->topology[Index]))
+        {
+            pCache->previous[Index].adapterIndex = Index;
+            pCache->adapterCount++;
+        }
+    }
+
+    // Publish empty snapshots so readers see sequence 0 until the first pass
+    pCache->pSlots = pCache->localSlots;
+    for (uint32_t i = 0; i < AGENT_MAX_ADAPTERS; i++)
+    {
+        pCache->pSlots[i].sequence.store(0, std::memory_order_relaxed);
+        pCache->scratch.snapshot.adapterIndex = i;
+        SeqlockWrite(&pCache->pSlots[i].sequence, pCache->pSlots[i].words, &pCache->scratch, sizeof(PublishedSnapshot));
+    }
+
+    return (0 != pCache->adapterCount) ? CTL_RESULT_SUCCESS : CTL_RESULT_ERROR_NOT_AVAILABLE;
+}
+
+void TelemetryCacheSampleAdapter(TelemetryCache *pCache, uint32_t AdapterIndex, PublishedSnapshot *pScratch)
+{
+    // Driver calls run on scratch, the slot is odd only for the final copy
+    pScratch->snapshot.sequence = pCache->previous[AdapterIndex].sequence;
+    SampleAdapter(&pCache->topology[AdapterIndex], &pCache->decodePlan[AdapterIndex], &pScratch->snapshot);
+    ComputeDerivedMetrics(&pCache->previous[AdapterIndex], &pScratch->snapshot, &pScratch->derived);
+    SeqlockWrite(&pCache->pSlots[AdapterIndex].sequence, pCache->pSlots[AdapterIndex].words, pScratch, sizeof(PublishedSnapshot));
+
+    uint32_t IntervalMs = pCache->periodMs;
+    {
+        std::lock_guard<std::mutex> Guard(pCache->listenerLock);
+        for (uint32_t l = 0; l < pCache->listenerCount; l++)
+        {
+            pCache->listeners[l].pfnListener(&pCache->previous[AdapterIndex], pScratch, pCache->listeners[l].pContext);
+        }
+        if (nullptr != pCache->pRateController)
+        {
+            IntervalMs = AdaptiveSamplingUpdate(pCache->pRateController, pScratch);
+        }
+    }
+    pCache->previous[AdapterIndex]  = pScratch->snapshot;
+    pCache->nextDueNs[AdapterIndex] = pScratch->snapshot.hostTimestampNs + IntervalMs * 1000000ull;
+}
+
+void TelemetryCacheSampleOnce(TelemetryCache *pCache)
+{
+    for (uint32_t i = 0; i < pCache->adapterCount; i++)
+    {
+        TelemetryCacheSampleAdapter(pCache, i, &pCache->scratch);
+    }
+}
+
+/***************************************************************
+ * @brief Sampler loop when every adapter has its own interval
+ *
+ * Each wakeup samples the adapters that are due. The next pass of an
+ * adapter is scheduled from the end of its last one, so an overrun delays
+ * it rather than causing a burst.
+ ***************************************************************/
+static void AdaptiveCacheThread(TelemetryCache *pCache)
+{
+    while (!pCache->stopRequested.load(std::memory_order_relaxed))
+    {
+        uint64_t NowNs      = AgentHostTimeNs();
+        uint64_t EarliestNs = UINT64_MAX;
+        for (uint32_t i = 0; i < pCache->adapterCount; i++)
+        {
+            if (pCache->nextDueNs[i] <= NowNs)
+            {
+                TelemetryCacheSampleAdapter(pCache, i, &pCache->scratch);
+            }
+            EarliestNs = (pCache->nextDueNs[i] < EarliestNs) ? pCache->nextDueNs[i] : EarliestNs;
+        }
+
+        auto Wakeup = std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(EarliestNs)));
+        std::this_thread::sleep_until(Wakeup);
+    }
+}
+
+static void TelemetryCacheThread(TelemetryCache *pCache)
+{
+    if (nullptr != pCache->pRateController)
+    {
+        AdaptiveCacheThread(pCache);
+        return;
+    }
+    if (nullptr != pCache->pCollector)
+    {
+        ParallelCollectorRun(pCache->pCollector, pCache);
+        return;
+    }
+
+    auto NextTick = std::chrono::steady_clock::now();
+    while (!pCache->stopRequested.load(std::memory_order_relaxed))
+    {
+        TelemetryCacheSampleOnce(pCache);
+
+        NextTick += std::chrono::milliseconds(pCache->periodMs);
+        auto Now = std::chrono::steady_clock::now();
+        if (NextTick < Now)
+        {
+            // Overran the period, resynchronize instead of bursting to catch up
+            NextTick = Now;
+        }
+        std::this_thread::sleep_until(NextTick);
+    }
+}
+
+ctl_result_t TelemetryCacheStart(TelemetryCache *pCache)
+{
+    if (nullptr == pCache)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (pCache->sampler.joinable())
+    {
+        return CTL_RESULT_ERROR_ALREADY_INITIALIZED;
+    }
+
+    // Prime the cache so the first consumer read returns real data
+    TelemetryCacheSampleOnce(pCache);
+
+    pCache->stopRequested.store(false);
+    pCache->sampler = std::thread(TelemetryCacheThread, pCache);
+    return CTL_RESULT_SUCCESS;
+}
+
+void TelemetryCacheStop(TelemetryCache *pCache)
+{
+    if ((nullptr == pCache) || !pCache->sampler.joinable())
+    {
+        return;
+    }
+
+    pCache->stopRequested.store(true);
+    pCache->sampler.join();
+}
+
+ctl_result_t TelemetryCacheAttachSlots(TelemetryCache *pCache, SnapshotSlot *pSlots)
+{
+    if (nullptr == pCache)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (pCache->sampler.joinable())
+    {
+        return CTL_RESULT_ERROR_ALREADY_INITIALIZED;
+    }
+
+    SnapshotSlot *pTarget = (nullptr != pSlots) ? pSlots : pCache->localSlots;
+    if (pTarget == pCache->pSlots)
+    {
+        return CTL_RESULT_SUCCESS;
+    }
+
+    for (uint32_t i = 0; i < AGENT_MAX_ADAPTERS; i++)
+    {
+        SeqlockRead(&pCache->pSlots[i].sequence, pCache->pSlots[i].words, &pCache->scratch, sizeof(PublishedSnapshot), nullptr);
+        pTarget[i].sequence.store(0, std::memory_order_relaxed);
+        SeqlockWrite(&pTarget[i].sequence, pTarget[i].words, &pCache->scratch, sizeof(PublishedSnapshot));
+    }
+
+    pCache->pSlots = pTarget;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t TelemetryCacheAttachRateController(TelemetryCache *pCache, AdaptiveSamplingController *pController)
+{
+    if (nullptr == pCache)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (pCache->sampler.joinable())
+    {
+        return CTL_RESULT_ERROR_ALREADY_INITIALIZED;
+    }
+    if ((nullptr != pController) && (nullptr != pCache->pCollector))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    pCache->pRateController = pController;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t TelemetryCacheAttachCollector(TelemetryCache *pCache, ParallelCollector *pCollector)
+{
+    if (nullptr == pCache)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (pCache->sampler.joinable())
+    {
+        return CTL_RESULT_ERROR_ALREADY_INITIALIZED;
+    }
+    if ((nullptr != pCollector) && (nullptr != pCache->pRateController))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    pCache->pCollector = pCollector;
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t TelemetryCacheAddListener(TelemetryCache *pCache, TelemetrySampleListener pfnListener, void *pContext)
+{
+    if ((nullptr == pCache) || (nullptr == pfnListener))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (pCache->sampler.joinable())
+    {
+        return CTL_RESULT_ERROR_ALREADY_INITIALIZED;
+    }
+    if (pCache->listenerCount >= TELEMETRY_CACHE_MAX_LISTENERS)
+    {
+        return CTL_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    pCache->listeners[pCache->listenerCount++] = { pfnListener, pContext };
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t TelemetryCacheRead(const TelemetryCache *pCache, uint32_t AdapterIndex, PublishedSnapshot *pSnapshot, uint32_t *pRetries)
+{
+    if ((nullptr == pCache) || (nullptr == pSnapshot))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (AdapterIndex >= pCache->adapterCount)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    const SnapshotSlot *pSlot = &pCache->pSlots[AdapterIndex];
+    uint32_t Retries          = SeqlockRead(&pSlot->sequence, pSlot->words, pSnapshot, sizeof(PublishedSnapshot), nullptr);
+    if (nullptr != pRetries)
+    {
+        *pRetries = Retries;
+    }
+    return CTL_RESULT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  TelemetryCache.h
+ * @brief Background sampler holding the latest snapshot of every adapter.
+ *
+ * Only the sampler thread calls into the driver. Consumers such as the
+ * metrics exporter copy the cached snapshots and never issue driver calls.
+ *
+ * Each adapter is published through its own seqlock slot, so any number of
+ * readers can copy snapshots without ever delaying the sampler, and readers
+ * of different adapters never share a cache line.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "AdaptiveSampling.h"
+#include "SnapshotSeqlock.h"
+#include "TelemetrySampler.h"
+
+#define TELEMETRY_CACHE_DEFAULT_PERIOD_MS 100
+#define TELEMETRY_CACHE_MAX_LISTENERS 16
+
+struct ParallelCollector;
+
+/***************************************************************
+ * @brief Seqlock protected copy of one PublishedSnapshot
+ ***************************************************************/
+struct alignas(64) SnapshotSlot
+{
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> words[SEQLOCK_WORDS(sizeof(PublishedSnapshot))];
+};
+
+/***************************************************************
+ * @brief Called on the sampler thread after an adapter was published
+ *
+ * pPrevious is the pass before pCurrent, its sequence is 0 if there was
+ * none. Listeners run inside the sample pass and must not block. With a
+ * ParallelCollector attached they are called from one thread per adapter,
+ * but never two at once.
+ ***************************************************************/
+typedef void (*TelemetrySampleListener)(const AdapterSnapshot *pPrevious, const PublishedSnapshot *pCurrent, void *pContext);
+
+struct TelemetryCacheListener
+{
+    TelemetrySampleListener pfnListener;
+    void *pContext;
+};
+
+struct TelemetryCache
+{
+    uint32_t adapterCount;
+    uint32_t periodMs; ///< Period of every adapter unless a rate controller is attached
+    AdapterTopology topology[AGENT_MAX_ADAPTERS];
+    AdaptiveSamplingController *pRateController; ///< Optional, chooses the period of each adapter
+    ParallelCollector *pCollector;               ///< Optional, samples each adapter on its own thread
+
+    SnapshotSlot localSlots[AGENT_MAX_ADAPTERS];
+    SnapshotSlot *pSlots; ///< localSlots unless attached to external memory
+
+    AdapterSnapshot previous[AGENT_MAX_ADAPTERS];       ///< Sampler private, last pass of each adapter
+    TelemetryDecodePlan decodePlan[AGENT_MAX_ADAPTERS]; ///< Sampler private
+    PublishedSnapshot scratch;                          ///< Sampler working copy
+    uint64_t nextDueNs[AGENT_MAX_ADAPTERS];             ///< Sampler private, host time of the next pass
+    uint32_t listenerCount;
+    TelemetryCacheListener listeners[TELEMETRY_CACHE_MAX_LISTENERS];
+    std::mutex listenerLock; ///< Held around the listeners and the rate controller of every pass
+    std::atomic<bool> stopRequested;
+    std::thread sampler;
+};
+
+ctl_result_t TelemetryCacheInit(TelemetryCache *pCache, ctl_device_adapter_handle_t *phDevices, uint32_t DeviceCount, uint32_t PeriodMs);
+void TelemetryCacheSampleOnce(TelemetryCache *pCache);
+ctl_result_t TelemetryCacheStart(TelemetryCache *pCache);
+void TelemetryCacheStop(TelemetryCache *pCache);
+
+/***************************************************************
+ * @brief Moves publication to AGENT_MAX_ADAPTERS caller owned slots
+ *
+ * The current contents are carried over. nullptr returns to the local
+ * slots. Must not be called while the sampler thread is running.
+ ***************************************************************/
+ctl_result_t TelemetryCacheAttachSlots(TelemetryCache *pCache, SnapshotSlot *pSlots);
+
+/***************************************************************
+ * @brief Samples each adapter at the interval chosen by pController
+ *
+ * nullptr returns to sampling every adapter each periodMs. Must not be
+ * called while the sampler thread is running. Stopping then waits for at
+ * most the longest interval of the controller.
+ ***************************************************************/
+ctl_result_t TelemetryCacheAttachRateController(TelemetryCache *pCache, AdaptiveSamplingController *pController);
+
+/***************************************************************
+ * @brief Samples every adapter on its own thread of pCollector
+ *
+ * nullptr returns to the single sampler thread. Must not be called while
+ * the sampler thread is running, nor together with a rate controller,
+ * whose per adapter periods do not fit the collector's common ticks.
+ ***************************************************************/
+ctl_result_t TelemetryCacheAttachCollector(TelemetryCache *pCache, ParallelCollector *pCollector);
+
+/***************************************************************
+ * @brief Samples and publishes one adapter into pScratch
+ *
+ * For the threads of a ParallelCollector: each adapter must be sampled
+ * by one thread at a time, with a buffer of its own.
+ ***************************************************************/
+void TelemetryCacheSampleAdapter(TelemetryCache *pCache, uint32_t AdapterIndex, PublishedSnapshot *pScratch);
+
+/***************************************************************
+ * @brief Registers a listener for every published pass
+ *
+ * Must not be called while the sampler thread is running.
+ ***************************************************************/
+ctl_result_t TelemetryCacheAddListener(TelemetryCache *pCache, TelemetrySampleListener pfnListener, void *pContext);
+
+/***************************************************************
+ * @brief Copies the latest snapshot of an adapter, never calls the driver
+ *
+ * Lock free and safe from any number of threads. pRetries, if not null,
+ * receives the number of copies discarded because a publish overlapped.
+ ***************************************************************/
+ctl_result_t TelemetryCacheRead(const TelemetryCache *pCache, uint32_t AdapterIndex, PublishedSnapshot *pSnapshot, uint32_t *pRetries = nullptr);
@@ -0,0 +1,246 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  TelemetryDecodePlan.cpp
+ * @brief Precompiled decode of ctl_power_telemetry_t items.
+ *
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "TelemetryDecodePlan.h"
+
+#define ITEM_OFFSET(Field) static_cast<uint16_t>(offsetof(ctl_power_telemetry_t, Field))
+
+static const uint16_t TelemetryItemOffsets[TELEMETRY_ITEM_COUNT] = {
+    ITEM_OFFSET(timeStamp),
+    ITEM_OFFSET(gpuEnergyCounter),
+    ITEM_OFFSET(gpuVoltage),
+    ITEM_OFFSET(gpuCurrentClockFrequency),
+    ITEM_OFFSET(gpuCurrentTemperature),
+    ITEM_OFFSET(globalActivityCounter),
+    ITEM_OFFSET(renderComputeActivityCounter),
+    ITEM_OFFSET(mediaActivityCounter),
+    ITEM_OFFSET(vramEnergyCounter),
+    ITEM_OFFSET(vramVoltage),
+    ITEM_OFFSET(vramCurrentClockFrequency),
+    ITEM_OFFSET(vramCurrentEffectiveFrequency),
+    ITEM_OFFSET(vramReadBandwidthCounter),
+    ITEM_OFFSET(vramWriteBandwidthCounter),
+    ITEM_OFFSET(vramCurrentTemperature),
+    ITEM_OFFSET(totalCardEnergyCounter),
+    ITEM_OFFSET(gpuVrTemp),
+    ITEM_OFFSET(vramVrTemp),
+    ITEM_OFFSET(saVrTemp),
+    ITEM_OFFSET(gpuEffectiveClock),
+    ITEM_OFFSET(gpuOverVoltagePercent),
+    ITEM_OFFSET(gpuPowerPercent),
+    ITEM_OFFSET(gpuTemperaturePercent),
+    ITEM_OFFSET(vramReadBandwidth),
+    ITEM_OFFSET(vramWriteBandwidth),
+    ITEM_OFFSET(psu[0].energyCounter),
+    ITEM_OFFSET(psu[1].energyCounter),
+    ITEM_OFFSET(psu[2].energyCounter),
+    ITEM_OFFSET(psu[3].energyCounter),
+    ITEM_OFFSET(psu[4].energyCounter),
+    ITEM_OFFSET(psu[0].voltage),
+    ITEM_OFFSET(psu[1].voltage),
+    ITEM_OFFSET(psu[2].voltage),
+    ITEM_OFFSET(psu[3].voltage),
+    ITEM_OFFSET(psu[4].voltage),
+    ITEM_OFFSET(fanSpeed[0]),
+    ITEM_OFFSET(fanSpeed[1]),
+    ITEM_OFFSET(fanSpeed[2]),
+    ITEM_OFFSET(fanSpeed[3]),
+    ITEM_OFFSET(fanSpeed[4]),
+};
+
+static_assert(CTL_PSU_COUNT == 5 && CTL_FAN_COUNT == 5, "offset table lists 5 PSU and 5 fan entries");
+
+static const char *TelemetryItemNames[] = { "timestamp",
+                                           "gpu_energy",
+                                           "gpu_voltage",
+                                           "gpu_frequency",
+                                           "gpu_temperature",
+                                           "global_activity",
+                                           "render_activity",
+                                           "media_activity",
+                                           "vram_energy",
+                                           "vram_voltage",
+                                           "vram_frequency",
+                                           "vram_effective_frequency",
+                                           "vram_read_counter",
+                                           "vram_write_counter",
+                                           "vram_temperature",
+                                           "card_energy",
+                                           "gpu_vr_temperature",
+                                           "vram_vr_temperature",
+                                           "sa_vr_temperature",
+                                           "gpu_effective_frequency",
+                                           "gpu_overvoltage_percent",
+                                           "gpu_power_percent",
+                                           "gpu_temperature_percent",
+                                           "vram_read_bandwidth",
+                                           "vram_write_bandwidth" };
+
+static_assert(sizeof(TelemetryItemNames) / sizeof(TelemetryItemNames[0]) == TELEMETRY_ITEM_PSU_ENERGY_0, "name table lists every item before the PSU entries");
+
+uint16_t TelemetryItemOffset(uint32_t ItemId)
+{
+    return (ItemId < TELEMETRY_ITEM_COUNT) ? TelemetryItemOffsets[ItemId] : 0;
+}
+
+void TelemetryItemLabel(uint32_t ItemId, char *pBuffer, size_t BufferSize)
+{
+    if (ItemId < TELEMETRY_ITEM_PSU_ENERGY_0)
+    {
+        snprintf(pBuffer, BufferSize, "%s", TelemetryItemNames[ItemId]);
+    }
+    else if (ItemId < TELEMETRY_ITEM_PSU_VOLTAGE_0)
+    {
+        snprintf(pBuffer, BufferSize, "psu%u_energy", ItemId - TELEMETRY_ITEM_PSU_ENERGY_0);
+    }
+    else if (ItemId < TELEMETRY_ITEM_FAN_SPEED_0)
+    {
+        snprintf(pBuffer, BufferSize, "psu%u_voltage", ItemId - TELEMETRY_ITEM_PSU_VOLTAGE_0);
+    }
+    else if (ItemId < TELEMETRY_ITEM_COUNT)
+    {
+        snprintf(pBuffer, BufferSize, "telemetry_fan%u_speed", ItemId - TELEMETRY_ITEM_FAN_SPEED_0);
+    }
+    else
+    {
+        snprintf(pBuffer, BufferSize, "unknown");
+    }
+}
+
+/***************************************************************
+ * @brief Factor converting a unit to its base unit
+ ***************************************************************/
+static double UnitScale(ctl_units_t Units)
+{
+    switch (Units)
+    {
+        case CTL_UNITS_POWER_MILLIWATTS:
+        case CTL_UNITS_VOLTAGE_MILLIVOLTS:
+            return 1e-3;
+        default:
+            return 1.0;
+    }
+}
+
+static bool NumericType(ctl_data_type_t Type)
+{
+    return (Type >= CTL_DATA_TYPE_INT8) && (Type <= CTL_DATA_TYPE_DOUBLE);
+}
+
+void TelemetryDecodePlanBuild(const ctl_power_telemetry_t *pTelemetry, TelemetryDecodePlan *pPlan)
+{
+    memset(pPlan, 0, sizeof(TelemetryDecodePlan));
+
+    const char *pBase = reinterpret_cast<const char *>(pTelemetry);
+    for (uint32_t Id = 0; Id < TELEMETRY_ITEM_COUNT; Id++)
+    {
+        const ctl_oc_telemetry_item_t *pItem = reinterpret_cast<const ctl_oc_telemetry_item_t *>(pBase + TelemetryItemOffsets[Id]);
+        if (!pItem->bSupported || !NumericType(pItem->type))
+        {
+            continue;
+        }
+
+        TelemetryDecodeEntry *pEntry = &pPlan->entries[pPlan->entryCount++];
+        pEntry->offset               = TelemetryItemOffsets[Id];
+        pEntry->itemId               = static_cast<uint8_t>(Id);
+        pEntry->type                 = static_cast<uint8_t>(pItem->type);
+        pEntry->scale                = UnitScale(pItem->units);
+        pPlan->supportedMask |= TELEMETRY_ITEM_BIT(Id);
+    }
+}
+
+uint64_t TelemetryDecodePlanExtract(const TelemetryDecodePlan *pPlan, const ctl_power_telemetry_t *pTelemetry, double *pValues)
+{
+    const char *pBase = reinterpret_cast<const char *>(pTelemetry);
+    uint64_t Mask     = 0;
+
+    for (uint32_t i = 0; i < pPlan->entryCount; i++)
+    {
+        const TelemetryDecodeEntry *pEntry   = &pPlan->entries[i];
+        const ctl_oc_telemetry_item_t *pItem = reinterpret_cast<const ctl_oc_telemetry_item_t *>(pBase + pEntry->offset);
+        const ctl_data_value_t &Value        = pItem->value;
+
+        double Decoded;
+        switch (pEntry->type)
+        {
+            case CTL_DATA_TYPE_INT8:
+                Decoded = Value.data8;
+                break;
+            case CTL_DATA_TYPE_UINT8:
+                Decoded = Value.datau8;
+                break;
+            case CTL_DATA_TYPE_INT16:
+                Decoded = Value.data16;
+                break;
+            case CTL_DATA_TYPE_UINT16:
+                Decoded = Value.datau16;
+                break;
+            case CTL_DATA_TYPE_INT32:
+                Decoded = Value.data32;
+                break;
+            case CTL_DATA_TYPE_UINT32:
+                Decoded = Value.datau32;
+                break;
+            case CTL_DATA_TYPE_INT64:
+                Decoded = static_cast<double>(Value.data64);
+                break;
+            case CTL_DATA_TYPE_UINT64:
+                Decoded = static_cast<double>(Value.datau64);
+                break;
+            case CTL_DATA_TYPE_FLOAT:
+                Decoded = Value.datafloat;
+                break;
+            default:
+                Decoded = Value.datadouble;
+                break;
+        }
+
+        pValues[pEntry->itemId] = Decoded * pEntry->scale;
+        Mask |= static_cast<uint64_t>(pItem->bSupported) << pEntry->itemId;
+    }
+
+    return Mask;
+}
+
+double TelemetryDecodePlanRange(const TelemetryDecodePlan *pPlan, uint32_t ItemId)
+{
+    for (uint32_t i = 0; i < pPlan->entryCount; i++)
+    {
+        const TelemetryDecodeEntry &Entry = pPlan->entries[i];
+        if (Entry.itemId != ItemId)
+        {
+            continue;
+        }
+        switch (Entry.type)
+        {
+            case CTL_DATA_TYPE_INT8:
+            case CTL_DATA_TYPE_UINT8:
+                return 256.0 * Entry.scale;
+            case CTL_DATA_TYPE_INT16:
+            case CTL_DATA_TYPE_UINT16:
+                return 65536.0 * Entry.scale;
+            case CTL_DATA_TYPE_INT32:
+            case CTL_DATA_TYPE_UINT32:
+                return 4294967296.0 * Entry.scale;
+            default:
+                return 0.0;
+        }
+    }
+    return 0.0;
+}
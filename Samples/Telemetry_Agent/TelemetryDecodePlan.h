@@ -0,0 +1,123 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  TelemetryDecodePlan.h
+ * @brief Precompiled decode of ctl_power_telemetry_t items.
+ *
+ * Which items an adapter supports, and their data type and units, do not
+ * change between samples. The plan records them once from the first good
+ * sample as a bitmap plus a compact (offset, type, scale) list, so each later
+ * sample is decoded by one tight loop over the supported items only, into
+ * caller owned storage, without strings or heap allocations.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "igcl_api.h"
+
+/***************************************************************
+ * @brief Identifies a telemetry item, also its bit in the masks
+ ***************************************************************/
+enum TelemetryItemId
+{
+    TELEMETRY_ITEM_TIMESTAMP = 0,
+    TELEMETRY_ITEM_GPU_ENERGY,
+    TELEMETRY_ITEM_GPU_VOLTAGE,
+    TELEMETRY_ITEM_GPU_FREQUENCY,
+    TELEMETRY_ITEM_GPU_TEMPERATURE,
+    TELEMETRY_ITEM_GLOBAL_ACTIVITY,
+    TELEMETRY_ITEM_RENDER_ACTIVITY,
+    TELEMETRY_ITEM_MEDIA_ACTIVITY,
+    TELEMETRY_ITEM_VRAM_ENERGY,
+    TELEMETRY_ITEM_VRAM_VOLTAGE,
+    TELEMETRY_ITEM_VRAM_FREQUENCY,
+    TELEMETRY_ITEM_VRAM_EFFECTIVE_FREQUENCY,
+    TELEMETRY_ITEM_VRAM_READ_COUNTER,
+    TELEMETRY_ITEM_VRAM_WRITE_COUNTER,
+    TELEMETRY_ITEM_VRAM_TEMPERATURE,
+    TELEMETRY_ITEM_CARD_ENERGY,
+    TELEMETRY_ITEM_GPU_VR_TEMPERATURE,
+    TELEMETRY_ITEM_VRAM_VR_TEMPERATURE,
+    TELEMETRY_ITEM_SA_VR_TEMPERATURE,
+    TELEMETRY_ITEM_GPU_EFFECTIVE_FREQUENCY,
+    TELEMETRY_ITEM_GPU_OVERVOLTAGE_PERCENT,
+    TELEMETRY_ITEM_GPU_POWER_PERCENT,
+    TELEMETRY_ITEM_GPU_TEMPERATURE_PERCENT,
+    TELEMETRY_ITEM_VRAM_READ_BANDWIDTH,
+    TELEMETRY_ITEM_VRAM_WRITE_BANDWIDTH,
+    TELEMETRY_ITEM_PSU_ENERGY_0,
+    TELEMETRY_ITEM_PSU_VOLTAGE_0 = TELEMETRY_ITEM_PSU_ENERGY_0 + CTL_PSU_COUNT,
+    TELEMETRY_ITEM_FAN_SPEED_0   = TELEMETRY_ITEM_PSU_VOLTAGE_0 + CTL_PSU_COUNT,
+    TELEMETRY_ITEM_COUNT         = TELEMETRY_ITEM_FAN_SPEED_0 + CTL_FAN_COUNT
+};
+
+static_assert(TELEMETRY_ITEM_COUNT <= 64, "item masks are 64 bits wide");
+
+#define TELEMETRY_ITEM_BIT(Id) (1ull << (Id))
+
+/***************************************************************
+ * @brief One supported item. Values are multiplied by scale, which only
+ *        turns milliwatts into watts and millivolts into volts; every
+ *        other unit stays as the driver reports it, such as joules,
+ *        seconds, bytes, MHz, degrees Celsius, RPM, percent, and megabytes
+ *        per second for the VRAM bandwidth items.
+ ***************************************************************/
+struct TelemetryDecodeEntry
+{
+    uint16_t offset; ///< Offset of the item in ctl_power_telemetry_t
+    uint8_t itemId;
+    uint8_t type; ///< ctl_data_type_t
+    double scale;
+};
+
+struct TelemetryDecodePlan
+{
+    uint64_t supportedMask; ///< 0 until built
+    uint32_t entryCount;
+    TelemetryDecodeEntry entries[TELEMETRY_ITEM_COUNT];
+};
+
+/***************************************************************
+ * @brief Offset of an item in ctl_power_telemetry_t
+ ***************************************************************/
+uint16_t TelemetryItemOffset(uint32_t ItemId);
+
+/***************************************************************
+ * @brief Lower case item name, e.g. gpu_energy or psu0_voltage
+ ***************************************************************/
+void TelemetryItemLabel(uint32_t ItemId, char *pBuffer, size_t BufferSize);
+
+/***************************************************************
+ * @brief Builds the plan from a successful sample
+ *
+ * Items with a data type that cannot be decoded to a number are left out.
+ ***************************************************************/
+void TelemetryDecodePlanBuild(const ctl_power_telemetry_t *pTelemetry, TelemetryDecodePlan *pPlan);
+
+/***************************************************************
+ * @brief Decodes the planned items of one sample
+ *
+ * pValues has TELEMETRY_ITEM_COUNT entries indexed by item id; only the
+ * planned ones are written. Returns the mask of items the sample reports as
+ * supported, a subset of the plan.
+ ***************************************************************/
+uint64_t TelemetryDecodePlanExtract(const TelemetryDecodePlan *pPlan, const ctl_power_telemetry_t *pTelemetry, double *pValues);
+
+/***************************************************************
+ * @brief Decoded range of a counter item, the step it drops by on a wrap
+ *
+ * 0 for items of 64 bits or floating point, whose wrap is not known, and
+ * for items not in the plan.
+ ***************************************************************/
+double TelemetryDecodePlanRange(const TelemetryDecodePlan *pPlan, uint32_t ItemId);
@@ -0,0 +1,263 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  TelemetryHistograms.cpp
+ * @brief Power, clock, temperature and engine distributions of every adapter.
+ *
+ */
+
+#include <string.h>
+
+#include "TelemetryHistograms.h"
+
+static const double TelemetryHistogramResolution[TELEMETRY_HISTOGRAM_ENGINE_0] = { 0.1, 0.1, 1.0, 0.1, 0.1 };
+
+static void TelemetryHistogramSetInit(TelemetryHistogramSet *pSet, uint32_t AdapterIndex)
+{
+    pSet->adapterIndex = AdapterIndex;
+    pSet->startNs      = 0;
+    pSet->endNs        = 0;
+    for (uint32_t m = 0; m < TELEMETRY_HISTOGRAM_METRIC_COUNT; m++)
+    {
+        QuantileHistogramInit(&pSet->metrics[m], (m < TELEMETRY_HISTOGRAM_ENGINE_0) ? TelemetryHistogramResolution[m] : 0.1);
+    }
+}
+
+static void TelemetryHistogramSetReset(TelemetryHistogramSet *pSet)
+{
+    pSet->startNs = 0;
+    pSet->endNs   = 0;
+    for (uint32_t m = 0; m < TELEMETRY_HISTOGRAM_METRIC_COUNT; m++)
+    {
+        QuantileHistogramReset(&pSet->metrics[m]);
+    }
+}
+
+static void TelemetryHistogramsListener(const AdapterSnapshot *pPrevious, const PublishedSnapshot *pCurrent, void *pContext)
+{
+    (void)pPrevious;
+    TelemetryHistogramsUpdate(static_cast<TelemetryHistograms *>(pContext), pCurrent);
+}
+
+ctl_result_t TelemetryHistogramsInit(TelemetryHistograms *pHistograms, TelemetryCache *pCache, double WindowSec, TelemetryHistogramWindowCallback pfnCallback, void *pContext)
+{
+    if ((nullptr == pHistograms) || (nullptr == pCache))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (WindowSec < 0.0)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    pHistograms->pCache      = pCache;
+    pHistograms->windowSec   = WindowSec;
+    pHistograms->pfnCallback = pfnCallback;
+    pHistograms->pContext    = pContext;
+    {
+        std::lock_guard<std::mutex> Guard(pHistograms->statsLock);
+        for (uint32_t a = 0; a < AGENT_MAX_ADAPTERS; a++)
+        {
+            TelemetryHistogramSetInit(&pHistograms->closed[a], a);
+            TelemetryHistogramSetInit(&pHistograms->run[a], a);
+            TelemetryHistogramSetInit(&pHistograms->window[a], a);
+        }
+    }
+
+    return TelemetryCacheAddListener(pCache, TelemetryHistogramsListener, pHistograms);
+}
+
+void TelemetryHistogramsUpdate(TelemetryHistograms *pHistograms, const PublishedSnapshot *pSample)
+{
+    const AdapterSnapshot *pSnapshot = &pSample->snapshot;
+    const DerivedMetrics *pDerived   = &pSample->derived;
+    uint32_t Adapter                 = pSnapshot->adapterIndex;
+    if (Adapter >= AGENT_MAX_ADAPTERS)
+    {
+        return;
+    }
+
+    const uint64_t Mask = (CTL_RESULT_SUCCESS == pSnapshot->telemetryResult) ? pSnapshot->telemetryValidMask : 0;
+    uint32_t ValidMask  = 0;
+    double Values[TELEMETRY_HISTOGRAM_METRIC_COUNT];
+    struct
+    {
+        TelemetryHistogramMetric metric;
+        bool valid;
+        double value;
+    } Sources[] = {
+        { TELEMETRY_HISTOGRAM_GPU_POWER, 0 != (pDerived->validMask & DERIVED_VALID_GPU_POWER), pDerived->gpuPowerW },
+        { TELEMETRY_HISTOGRAM_CARD_POWER, 0 != (pDerived->validMask & DERIVED_VALID_CARD_POWER), pDerived->cardPowerW },
+        { TELEMETRY_HISTOGRAM_GPU_CLOCK, 0 != (Mask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_GPU_FREQUENCY)), pSnapshot->telemetryValues[TELEMETRY_ITEM_GPU_FREQUENCY] },
+        { TELEMETRY_HISTOGRAM_GPU_TEMPERATURE, 0 != (Mask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_GPU_TEMPERATURE)), pSnapshot->telemetryValues[TELEMETRY_ITEM_GPU_TEMPERATURE] },
+        { TELEMETRY_HISTOGRAM_VRAM_TEMPERATURE, 0 != (Mask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_VRAM_TEMPERATURE)), pSnapshot->telemetryValues[TELEMETRY_ITEM_VRAM_TEMPERATURE] },
+    };
+    for (auto &Source : Sources)
+    {
+        Values[Source.metric] = Source.value;
+        ValidMask |= Source.valid ? CTL_BIT(Source.metric) : 0;
+    }
+    for (uint32_t e = 0; e < AGENT_MAX_ENGINE_GROUPS; e++)
+    {
+        Values[TELEMETRY_HISTOGRAM_ENGINE_0 + e] = pDerived->engineUtilizationPct[e];
+        ValidMask |= (0 != (pDerived->engineValidMask & CTL_BIT(e))) ? (1u << (TELEMETRY_HISTOGRAM_ENGINE_0 + e)) : 0;
+    }
+    if (0 == ValidMask)
+    {
+        return;
+    }
+
+    // Each value holds for the interval that produced it, counted in milliseconds
+    double IntervalMs = pDerived->intervalSec * 1000.0 + 0.5;
+    uint64_t Weight   = (IntervalMs >= 1.0) ? static_cast<uint64_t>(IntervalMs) : 1;
+    uint64_t NowNs    = pSnapshot->hostTimestampNs;
+    bool Closed       = false;
+    {
+        std::lock_guard<std::mutex> Guard(pHistograms->statsLock);
+        TelemetryHistogramSet *pRun    = &pHistograms->run[Adapter];
+        TelemetryHistogramSet *pWindow = &pHistograms->window[Adapter];
+        if ((pHistograms->windowSec > 0.0) && (0 != pWindow->startNs) && (NowNs - pWindow->startNs >= static_cast<uint64_t>(pHistograms->windowSec * 1e9)))
+        {
+            memcpy(&pHistograms->closed[Adapter], pWindow, sizeof(TelemetryHistogramSet));
+            TelemetryHistogramSetReset(pWindow);
+            Closed = true;
+        }
+
+        for (uint32_t m = 0; m < TELEMETRY_HISTOGRAM_METRIC_COUNT; m++)
+        {
+            if (0 != (ValidMask & CTL_BIT(m)))
+            {
+                QuantileHistogramRecord(&pRun->metrics[m], Values[m], Weight);
+                QuantileHistogramRecord(&pWindow->metrics[m], Values[m], Weight);
+            }
+        }
+        pRun->startNs    = (0 == pRun->startNs) ? NowNs : pRun->startNs;
+        pWindow->startNs = (0 == pWindow->startNs) ? NowNs : pWindow->startNs;
+        pRun->endNs      = NowNs;
+        pWindow->endNs   = NowNs;
+    }
+
+    if (Closed && (nullptr != pHistograms->pfnCallback))
+    {
+        pHistograms->pfnCallback(&pHistograms->closed[Adapter], pHistograms->pContext);
+    }
+}
+
+ctl_result_t TelemetryHistogramsRead(TelemetryHistograms *pHistograms, uint32_t AdapterIndex, bool Window, TelemetryHistogramSet *pSet)
+{
+    if ((nullptr == pHistograms) || (nullptr == pSet))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (AdapterIndex >= AGENT_MAX_ADAPTERS)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pHistograms->statsLock);
+    memcpy(pSet, Window ? &pHistograms->window[AdapterIndex] : &pHistograms->run[AdapterIndex], sizeof(TelemetryHistogramSet));
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t TelemetryHistogramsPercentiles(TelemetryHistograms *pHistograms, uint32_t AdapterIndex, bool Window, TelemetryHistogramMetric Metric, const double *pPercentiles,
+                                            uint32_t Count, double *pValues, uint64_t *pTotal)
+{
+    if ((nullptr == pHistograms) || (nullptr == pPercentiles) || (nullptr == pValues))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((AdapterIndex >= AGENT_MAX_ADAPTERS) || (Metric >= TELEMETRY_HISTOGRAM_METRIC_COUNT))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pHistograms->statsLock);
+    const TelemetryHistogramSet *pSet = Window ? &pHistograms->window[AdapterIndex] : &pHistograms->run[AdapterIndex];
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        pValues[i] = QuantileHistogramPercentile(&pSet->metrics[Metric], pPercentiles[i]);
+    }
+    if (nullptr != pTotal)
+    {
+        *pTotal = pSet->metrics[Metric].totalCount;
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t TelemetryHistogramsResetWindow(TelemetryHistograms *pHistograms, uint32_t AdapterIndex, TelemetryHistogramSet *pClosed)
+{
+    if (nullptr == pHistograms)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((AdapterIndex >= AGENT_MAX_ADAPTERS) && (TELEMETRY_HISTOGRAM_ALL_ADAPTERS != AdapterIndex))
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pHistograms->statsLock);
+    if (TELEMETRY_HISTOGRAM_ALL_ADAPTERS == AdapterIndex)
+    {
+        for (uint32_t a = 0; a < AGENT_MAX_ADAPTERS; a++)
+        {
+            TelemetryHistogramSetReset(&pHistograms->window[a]);
+        }
+        return CTL_RESULT_SUCCESS;
+    }
+
+    if (nullptr != pClosed)
+    {
+        memcpy(pClosed, &pHistograms->window[AdapterIndex], sizeof(TelemetryHistogramSet));
+    }
+    TelemetryHistogramSetReset(&pHistograms->window[AdapterIndex]);
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t TelemetryHistogramSetMerge(TelemetryHistogramSet *pDestination, const TelemetryHistogramSet *pSource)
+{
+    if ((nullptr == pDestination) || (nullptr == pSource))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    for (uint32_t m = 0; m < TELEMETRY_HISTOGRAM_METRIC_COUNT; m++)
+    {
+        ctl_result_t Result = QuantileHistogramMerge(&pDestination->metrics[m], &pSource->metrics[m]);
+        if (CTL_RESULT_SUCCESS != Result)
+        {
+            return Result;
+        }
+    }
+    if (0 != pSource->startNs)
+    {
+        pDestination->startNs = ((0 == pDestination->startNs) || (pSource->startNs < pDestination->startNs)) ? pSource->startNs : pDestination->startNs;
+        pDestination->endNs   = (pSource->endNs > pDestination->endNs) ? pSource->endNs : pDestination->endNs;
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+const char *TelemetryHistogramMetricLabel(TelemetryHistogramMetric Metric)
+{
+    switch (Metric)
+    {
+        case TELEMETRY_HISTOGRAM_GPU_POWER:
+            return "gpu_power_watts";
+        case TELEMETRY_HISTOGRAM_CARD_POWER:
+            return "card_power_watts";
+        case TELEMETRY_HISTOGRAM_GPU_CLOCK:
+            return "gpu_frequency_mhz";
+        case TELEMETRY_HISTOGRAM_GPU_TEMPERATURE:
+            return "gpu_temperature_celsius";
+        case TELEMETRY_HISTOGRAM_VRAM_TEMPERATURE:
+            return "vram_temperature_celsius";
+        default:
+            return (Metric < TELEMETRY_HISTOGRAM_METRIC_COUNT) ? "engine_utilization_percent" : "unknown";
+    }
+}
@@ -0,0 +1,118 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  TelemetryHistograms.h
+ * @brief Power, clock, temperature and engine distributions of every adapter.
+ *
+ * A listener on the telemetry cache records each pass of an adapter into a
+ * QuantileHistogram per metric, weighted by the milliseconds since the
+ * previous pass so that adaptive sampling does not skew the percentiles
+ * towards busy periods. Every adapter keeps one set over the whole run and
+ * one over the current window; the window is closed every windowSec, or
+ * by TelemetryHistogramsResetWindow at the boundaries of a job, and the
+ * closed set is handed to a callback.
+ *
+ * Memory is fixed at two sets of TELEMETRY_HISTOGRAM_METRIC_COUNT
+ * histograms per adapter, however long the run.
+ *
+ */
+
+#pragma once
+
+#include <mutex>
+
+#include "QuantileHistogram.h"
+#include "TelemetryCache.h"
+
+#define TELEMETRY_HISTOGRAM_DEFAULT_WINDOW_SEC 3600.0
+#define TELEMETRY_HISTOGRAM_ALL_ADAPTERS 0xFFFFFFFFu
+
+enum TelemetryHistogramMetric
+{
+    TELEMETRY_HISTOGRAM_GPU_POWER = 0,    ///< Watts, 0.1 W resolution
+    TELEMETRY_HISTOGRAM_CARD_POWER,       ///< Watts, 0.1 W resolution
+    TELEMETRY_HISTOGRAM_GPU_CLOCK,        ///< Megahertz, 1 MHz resolution
+    TELEMETRY_HISTOGRAM_GPU_TEMPERATURE,  ///< Celsius, 0.1 C resolution
+    TELEMETRY_HISTOGRAM_VRAM_TEMPERATURE, ///< Celsius, 0.1 C resolution
+    TELEMETRY_HISTOGRAM_ENGINE_0,         ///< Percent per engine group, 0.1 % resolution
+    TELEMETRY_HISTOGRAM_METRIC_COUNT = TELEMETRY_HISTOGRAM_ENGINE_0 + AGENT_MAX_ENGINE_GROUPS
+};
+
+/***************************************************************
+ * @brief Histograms of one adapter over one span of time
+ ***************************************************************/
+struct TelemetryHistogramSet
+{
+    uint32_t adapterIndex;
+    uint64_t startNs; ///< Host time of the first pass recorded, 0 if none
+    uint64_t endNs;   ///< Host time of the last pass recorded
+    QuantileHistogram metrics[TELEMETRY_HISTOGRAM_METRIC_COUNT];
+};
+
+/***************************************************************
+ * @brief Called from the sampler thread with every window closed by time
+ ***************************************************************/
+typedef void (*TelemetryHistogramWindowCallback)(const TelemetryHistogramSet *pWindow, void *pContext);
+
+struct TelemetryHistograms
+{
+    const TelemetryCache *pCache;
+    double windowSec; ///< 0 closes windows only on TelemetryHistogramsResetWindow
+    TelemetryHistogramWindowCallback pfnCallback;
+    void *pContext;
+    TelemetryHistogramSet closed[AGENT_MAX_ADAPTERS]; ///< Sampler private, passed to the callback
+
+    std::mutex statsLock;
+    TelemetryHistogramSet run[AGENT_MAX_ADAPTERS];
+    TelemetryHistogramSet window[AGENT_MAX_ADAPTERS];
+};
+
+/***************************************************************
+ * @brief Empties every set and registers the listener
+ *
+ * pfnCallback may be nullptr. Call before TelemetryCacheStart.
+ ***************************************************************/
+ctl_result_t TelemetryHistogramsInit(TelemetryHistograms *pHistograms, TelemetryCache *pCache, double WindowSec, TelemetryHistogramWindowCallback pfnCallback, void *pContext);
+
+/***************************************************************
+ * @brief Records one pass of an adapter
+ ***************************************************************/
+void TelemetryHistogramsUpdate(TelemetryHistograms *pHistograms, const PublishedSnapshot *pSample);
+
+/***************************************************************
+ * @brief Copies the run or current window set of an adapter
+ ***************************************************************/
+ctl_result_t TelemetryHistogramsRead(TelemetryHistograms *pHistograms, uint32_t AdapterIndex, bool Window, TelemetryHistogramSet *pSet);
+
+/***************************************************************
+ * @brief Percentiles of one metric without copying the set
+ *
+ * Returns the milliseconds recorded in *pTotal when pTotal is not nullptr.
+ ***************************************************************/
+ctl_result_t TelemetryHistogramsPercentiles(TelemetryHistograms *pHistograms, uint32_t AdapterIndex, bool Window, TelemetryHistogramMetric Metric, const double *pPercentiles,
+                                            uint32_t Count, double *pValues, uint64_t *pTotal);
+
+/***************************************************************
+ * @brief Closes the current window of an adapter, returning it in pClosed
+ *
+ * pClosed may be nullptr. TELEMETRY_HISTOGRAM_ALL_ADAPTERS resets every
+ * adapter, pClosed then receives none.
+ ***************************************************************/
+ctl_result_t TelemetryHistogramsResetWindow(TelemetryHistograms *pHistograms, uint32_t AdapterIndex, TelemetryHistogramSet *pClosed);
+
+/***************************************************************
+ * @brief Adds every histogram of pSource to pDestination, e.g. across adapters
+ ***************************************************************/
+ctl_result_t TelemetryHistogramSetMerge(TelemetryHistogramSet *pDestination, const TelemetryHistogramSet *pSource);
+
+/***************************************************************
+ * @brief Lower case names used in labels, with the unit
+ ***************************************************************/
+const char *TelemetryHistogramMetricLabel(TelemetryHistogramMetric Metric);
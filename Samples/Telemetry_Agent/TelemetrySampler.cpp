@@ -0,0 +1,309 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  TelemetrySampler.cpp
+ * @brief Adapter topology enumeration and sample pass.
+ *
+ */
+
+#include <string.h>
+
+#include "TelemetrySampler.h"
+
+/***************************************************************
+ * @brief Two-call enumeration helper clamped to the snapshot capacity
+ ***************************************************************/
+template <typename HandleT, typename EnumFnT> static uint32_t EnumerateHandles(ctl_device_adapter_handle_t hDevice, EnumFnT EnumFn, HandleT *pHandles, uint32_t MaxCount)
+{
+    uint32_t Count      = 0;
+    ctl_result_t Result = EnumFn(hDevice, &Count, nullptr);
+    if ((CTL_RESULT_SUCCESS != Result) || (0 == Count))
+    {
+        return 0;
+    }
+
+    // The enumeration call fills at most Count entries, so ask only for what fits
+    if (Count > MaxCount)
+    {
+        Count = MaxCount;
+    }
+
+    Result = EnumFn(hDevice, &Count, pHandles);
+    return (CTL_RESULT_SUCCESS == Result) ? Count : 0;
+}
+
+ctl_result_t EnumerateAdapterTopology(ctl_device_adapter_handle_t hDevice, uint32_t AdapterIndex, AdapterTopology *pTopology)
+{
+    if ((nullptr == hDevice) || (nullptr == pTopology))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    memset(pTopology, 0, sizeof(AdapterTopology));
+    pTopology->adapterIndex = AdapterIndex;
+    pTopology->hDevice      = hDevice;
+
+    ctl_device_adapter_properties_t DeviceProperties = { 0 };
+    DeviceProperties.Size                            = sizeof(ctl_device_adapter_properties_t);
+    DeviceProperties.Version                         = 2;
+
+    ctl_result_t Result = ctlGetDeviceProperties(hDevice, &DeviceProperties);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        return Result;
+    }
+
+    memcpy(pTopology->name, DeviceProperties.name, sizeof(pTopology->name));
+    pTopology->name[CTL_MAX_DEVICE_NAME_LEN - 1] = '\0';
+    pTopology->pciDeviceId                       = DeviceProperties.pci_device_id;
+    pTopology->bdf                               = DeviceProperties.adapter_bdf;
+
+    pTopology->freqDomainCount = EnumerateHandles(hDevice, ctlEnumFrequencyDomains, pTopology->hFreq, AGENT_MAX_FREQ_DOMAINS);
+    for (uint32_t i = 0; i < pTopology->freqDomainCount; i++)
+    {
+        ctl_freq_properties_t FreqProperties = { 0 };
+        FreqProperties.Size                  = sizeof(ctl_freq_properties_t);
+        pTopology->freqDomainType[i]         = (CTL_RESULT_SUCCESS == ctlFrequencyGetProperties(pTopology->hFreq[i], &FreqProperties)) ? FreqProperties.type : CTL_FREQ_DOMAIN_MAX;
+    }
+
+    pTopology->tempSensorCount = EnumerateHandles(hDevice, ctlEnumTemperatureSensors, pTopology->hTemp, AGENT_MAX_TEMP_SENSORS);
+    for (uint32_t i = 0; i < pTopology->tempSensorCount; i++)
+    {
+        ctl_temp_properties_t TempProperties = { 0 };
+        TempProperties.Size                  = sizeof(ctl_temp_properties_t);
+        pTopology->tempSensorType[i]         = (CTL_RESULT_SUCCESS == ctlTemperatureGetProperties(pTopology->hTemp[i], &TempProperties)) ? TempProperties.type : CTL_TEMP_SENSORS_MAX;
+    }
+
+    pTopology->fanCount         = EnumerateHandles(hDevice, ctlEnumFans, pTopology->hFan, AGENT_MAX_FANS);
+    pTopology->powerDomainCount = EnumerateHandles(hDevice, ctlEnumPowerDomains, pTopology->hPower, AGENT_MAX_POWER_DOMAINS);
+
+    pTopology->engineGroupCount = EnumerateHandles(hDevice, ctlEnumEngineGroups, pTopology->hEngine, AGENT_MAX_ENGINE_GROUPS);
+    for (uint32_t i = 0; i < pTopology->engineGroupCount; i++)
+    {
+        ctl_engine_properties_t EngineProperties = { 0 };
+        EngineProperties.Size                    = sizeof(ctl_engine_properties_t);
+        pTopology->engineGroupType[i]            = (CTL_RESULT_SUCCESS == ctlEngineGetProperties(pTopology->hEngine[i], &EngineProperties)) ? EngineProperties.type : CTL_ENGINE_GROUP_MAX;
+    }
+
+    pTopology->memModuleCount = EnumerateHandles(hDevice, ctlEnumMemoryModules, pTopology->hMemory, AGENT_MAX_MEM_MODULES);
+
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t SampleAdapter(const AdapterTopology *pTopology, TelemetryDecodePlan *pPlan, AdapterSnapshot *pSnapshot)
+{
+    if ((nullptr == pTopology) || (nullptr == pPlan) || (nullptr == pSnapshot))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pSnapshot->adapterIndex = pTopology->adapterIndex;
+
+    pSnapshot->telemetry                = {};
+    pSnapshot->telemetry.Size           = sizeof(ctl_power_telemetry_t);
+    pSnapshot->telemetry.Version        = 1;
+    pSnapshot->telemetryBracket.startNs = AgentHostTimeNs();
+    pSnapshot->telemetryResult          = ctlPowerTelemetryGet(pTopology->hDevice, &pSnapshot->telemetry);
+    pSnapshot->telemetryBracket.endNs   = AgentHostTimeNs();
+
+    pSnapshot->telemetryValidMask = 0;
+    if (CTL_RESULT_SUCCESS == pSnapshot->telemetryResult)
+    {
+        if (0 == pPlan->supportedMask)
+        {
+            TelemetryDecodePlanBuild(&pSnapshot->telemetry, pPlan);
+        }
+        pSnapshot->telemetryValidMask = TelemetryDecodePlanExtract(pPlan, &pSnapshot->telemetry, pSnapshot->telemetryValues);
+    }
+
+    pSnapshot->freqValidMask = 0;
+    for (uint32_t i = 0; i < pTopology->freqDomainCount; i++)
+    {
+        pSnapshot->freqState[i]      = {};
+        pSnapshot->freqState[i].Size = sizeof(ctl_freq_state_t);
+        if (CTL_RESULT_SUCCESS == ctlFrequencyGetState(pTopology->hFreq[i], &pSnapshot->freqState[i]))
+        {
+            pSnapshot->freqValidMask |= CTL_BIT(i);
+        }
+    }
+
+    pSnapshot->throttleValidMask = 0;
+    for (uint32_t i = 0; i < pTopology->freqDomainCount; i++)
+    {
+        pSnapshot->throttleTime[i]            = {};
+        pSnapshot->throttleTime[i].Size       = sizeof(ctl_freq_throttle_time_t);
+        pSnapshot->throttleBracket[i].startNs = AgentHostTimeNs();
+        ctl_result_t Result                   = ctlFrequencyGetThrottleTime(pTopology->hFreq[i], &pSnapshot->throttleTime[i]);
+        pSnapshot->throttleBracket[i].endNs   = AgentHostTimeNs();
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            pSnapshot->throttleValidMask |= CTL_BIT(i);
+        }
+    }
+
+    pSnapshot->tempValidMask = 0;
+    for (uint32_t i = 0; i < pTopology->tempSensorCount; i++)
+    {
+        if (CTL_RESULT_SUCCESS == ctlTemperatureGetState(pTopology->hTemp[i], &pSnapshot->temperature[i]))
+        {
+            pSnapshot->tempValidMask |= CTL_BIT(i);
+        }
+    }
+
+    pSnapshot->fanValidMask = 0;
+    for (uint32_t i = 0; i < pTopology->fanCount; i++)
+    {
+        if ((CTL_RESULT_SUCCESS == ctlFanGetState(pTopology->hFan[i], CTL_FAN_SPEED_UNITS_RPM, &pSnapshot->fanSpeedRpm[i])) && (pSnapshot->fanSpeedRpm[i] >= 0))
+        {
+            pSnapshot->fanValidMask |= CTL_BIT(i);
+        }
+    }
+
+    pSnapshot->powerLimitsValidMask = 0;
+    for (uint32_t i = 0; i < pTopology->powerDomainCount; i++)
+    {
+        pSnapshot->powerLimits[i]      = {};
+        pSnapshot->powerLimits[i].Size = sizeof(ctl_power_limits_t);
+        if (CTL_RESULT_SUCCESS == ctlPowerGetLimits(pTopology->hPower[i], &pSnapshot->powerLimits[i]))
+        {
+            pSnapshot->powerLimitsValidMask |= CTL_BIT(i);
+        }
+    }
+
+    pSnapshot->energyValidMask = 0;
+    for (uint32_t i = 0; i < pTopology->powerDomainCount; i++)
+    {
+        pSnapshot->energyCounter[i]      = {};
+        pSnapshot->energyCounter[i].Size = sizeof(ctl_power_energy_counter_t);
+        if (CTL_RESULT_SUCCESS == ctlPowerGetEnergyCounter(pTopology->hPower[i], &pSnapshot->energyCounter[i]))
+        {
+            pSnapshot->energyValidMask |= CTL_BIT(i);
+        }
+    }
+
+    pSnapshot->engineValidMask = 0;
+    for (uint32_t i = 0; i < pTopology->engineGroupCount; i++)
+    {
+        pSnapshot->engineStats[i]           = {};
+        pSnapshot->engineStats[i].Size      = sizeof(ctl_engine_stats_t);
+        pSnapshot->engineBracket[i].startNs = AgentHostTimeNs();
+        ctl_result_t Result                 = ctlEngineGetActivity(pTopology->hEngine[i], &pSnapshot->engineStats[i]);
+        pSnapshot->engineBracket[i].endNs   = AgentHostTimeNs();
+        if (CTL_RESULT_SUCCESS == Result)
+        {
+            pSnapshot->engineValidMask |= CTL_BIT(i);
+        }
+    }
+
+    pSnapshot->memValidMask = 0;
+    for (uint32_t i = 0; i < pTopology->memModuleCount; i++)
+    {
+        pSnapshot->memState[i]      = {};
+        pSnapshot->memState[i].Size = sizeof(ctl_mem_state_t);
+        if (CTL_RESULT_SUCCESS == ctlMemoryGetState(pTopology->hMemory[i], &pSnapshot->memState[i]))
+        {
+            pSnapshot->memValidMask |= CTL_BIT(i);
+        }
+    }
+
+    pSnapshot->hostTimestampNs = AgentHostTimeNs();
+    pSnapshot->sequence++;
+
+    return pSnapshot->telemetryResult;
+}
+
+void ComputeDerivedMetrics(const AdapterSnapshot *pPrevious, const AdapterSnapshot *pCurrent, DerivedMetrics *pDerived)
+{
+    memset(pDerived, 0, sizeof(DerivedMetrics));
+    if ((0 == pPrevious->sequence) || (CTL_RESULT_SUCCESS != pPrevious->telemetryResult) || (CTL_RESULT_SUCCESS != pCurrent->telemetryResult))
+    {
+        return;
+    }
+
+    const uint64_t Mask   = pPrevious->telemetryValidMask & pCurrent->telemetryValidMask;
+    const double *pBefore = pPrevious->telemetryValues;
+    const double *pAfter  = pCurrent->telemetryValues;
+
+    // Counters are stamped by the device, so prefer its timestamp over the host clock
+    double IntervalSec = 0.0;
+    if (0 != (Mask & TELEMETRY_ITEM_BIT(TELEMETRY_ITEM_TIMESTAMP)))
+    {
+        IntervalSec = pAfter[TELEMETRY_ITEM_TIMESTAMP] - pBefore[TELEMETRY_ITEM_TIMESTAMP];
+    }
+    if (IntervalSec <= 0.0)
+    {
+        IntervalSec = (pCurrent->hostTimestampNs - pPrevious->hostTimestampNs) / 1e9;
+    }
+    if (IntervalSec <= 0.0)
+    {
+        return;
+    }
+    pDerived->intervalSec = IntervalSec;
+
+    struct
+    {
+        uint32_t itemId;
+        double *pRate;
+        double scale;
+        uint32_t flag;
+    } Rates[] = {
+        { TELEMETRY_ITEM_GPU_ENERGY, &pDerived->gpuPowerW, 1.0, DERIVED_VALID_GPU_POWER },
+        { TELEMETRY_ITEM_VRAM_ENERGY, &pDerived->vramPowerW, 1.0, DERIVED_VALID_VRAM_POWER },
+        { TELEMETRY_ITEM_CARD_ENERGY, &pDerived->cardPowerW, 1.0, DERIVED_VALID_CARD_POWER },
+        { TELEMETRY_ITEM_GLOBAL_ACTIVITY, &pDerived->globalUtilizationPct, 100.0, DERIVED_VALID_GLOBAL_UTILIZATION },
+        { TELEMETRY_ITEM_RENDER_ACTIVITY, &pDerived->renderUtilizationPct, 100.0, DERIVED_VALID_RENDER_UTILIZATION },
+        { TELEMETRY_ITEM_MEDIA_ACTIVITY, &pDerived->mediaUtilizationPct, 100.0, DERIVED_VALID_MEDIA_UTILIZATION },
+        { TELEMETRY_ITEM_VRAM_READ_COUNTER, &pDerived->vramReadBytesPerSec, 1.0, DERIVED_VALID_VRAM_READ },
+        { TELEMETRY_ITEM_VRAM_WRITE_COUNTER, &pDerived->vramWriteBytesPerSec, 1.0, DERIVED_VALID_VRAM_WRITE },
+    };
+
+    for (auto &Rate : Rates)
+    {
+        double Delta = pAfter[Rate.itemId] - pBefore[Rate.itemId];
+        if ((0 != (Mask & TELEMETRY_ITEM_BIT(Rate.itemId))) && (Delta >= 0.0))
+        {
+            *Rate.pRate = Rate.scale * Delta / IntervalSec;
+            pDerived->validMask |= Rate.flag;
+        }
+    }
+
+    // Engine counters carry their own microsecond timestamps
+    uint32_t EngineMask = pPrevious->engineValidMask & pCurrent->engineValidMask;
+    for (uint32_t i = 0; i < AGENT_MAX_ENGINE_GROUPS; i++)
+    {
+        if (0 == (EngineMask & CTL_BIT(i)))
+        {
+            continue;
+        }
+
+        const ctl_engine_stats_t &EngineBefore = pPrevious->engineStats[i];
+        const ctl_engine_stats_t &EngineAfter  = pCurrent->engineStats[i];
+        if ((EngineAfter.timestamp > EngineBefore.timestamp) && (EngineAfter.activeTime >= EngineBefore.activeTime))
+        {
+            pDerived->engineUtilizationPct[i] = 100.0 * static_cast<double>(EngineAfter.activeTime - EngineBefore.activeTime) / static_cast<double>(EngineAfter.timestamp - EngineBefore.timestamp);
+            pDerived->engineValidMask |= CTL_BIT(i);
+        }
+    }
+}
+
+const char *EngineGroupLabel(ctl_engine_group_t Group)
+{
+    switch (Group)
+    {
+        case CTL_ENGINE_GROUP_GT:
+            return "gt";
+        case CTL_ENGINE_GROUP_RENDER:
+            return "render";
+        case CTL_ENGINE_GROUP_MEDIA:
+            return "media";
+        default:
+            return "unknown";
+    }
+}
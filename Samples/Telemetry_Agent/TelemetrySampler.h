@@ -0,0 +1,264 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  TelemetrySampler.h
+ * @brief Per adapter handle topology and fixed size telemetry snapshots.
+ *
+ * Component handles are enumerated once per adapter. A sample pass then only
+ * issues the Get calls for those handles and writes into a flat, trivially
+ * copyable snapshot that can be cached, copied or published without touching
+ * the heap.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+
+#include "igcl_api.h"
+#include "TelemetryDecodePlan.h"
+
+#define AGENT_MAX_ADAPTERS 128
+#define AGENT_MAX_FREQ_DOMAINS 4
+#define AGENT_MAX_TEMP_SENSORS 8
+#define AGENT_MAX_FANS 8
+#define AGENT_MAX_POWER_DOMAINS 4
+#define AGENT_MAX_ENGINE_GROUPS 8
+#define AGENT_MAX_MEM_MODULES 4
+#define AGENT_ADAPTER_MASK_WORDS ((AGENT_MAX_ADAPTERS + 63) / 64)
+
+/***************************************************************
+ * @brief Handles and static properties of one adapter, enumerated once.
+ ***************************************************************/
+struct AdapterTopology
+{
+    uint32_t adapterIndex;
+    ctl_device_adapter_handle_t hDevice;
+    char name[CTL_MAX_DEVICE_NAME_LEN];
+    uint32_t pciDeviceId;
+    ctl_adapter_bdf_t bdf;
+
+    uint32_t freqDomainCount;
+    ctl_freq_handle_t hFreq[AGENT_MAX_FREQ_DOMAINS];
+    ctl_freq_domain_t freqDomainType[AGENT_MAX_FREQ_DOMAINS];
+
+    uint32_t tempSensorCount;
+    ctl_temp_handle_t hTemp[AGENT_MAX_TEMP_SENSORS];
+    ctl_temp_sensors_t tempSensorType[AGENT_MAX_TEMP_SENSORS];
+
+    uint32_t fanCount;
+    ctl_fan_handle_t hFan[AGENT_MAX_FANS];
+
+    uint32_t powerDomainCount;
+    ctl_pwr_handle_t hPower[AGENT_MAX_POWER_DOMAINS];
+
+    uint32_t engineGroupCount;
+    ctl_engine_handle_t hEngine[AGENT_MAX_ENGINE_GROUPS];
+    ctl_engine_group_t engineGroupType[AGENT_MAX_ENGINE_GROUPS];
+
+    uint32_t memModuleCount;
+    ctl_mem_handle_t hMemory[AGENT_MAX_MEM_MODULES];
+};
+
+/***************************************************************
+ * @brief Host steady clock read just before and just after a driver call
+ ***************************************************************/
+struct HostBracket
+{
+    uint64_t startNs;
+    uint64_t endNs;
+};
+
+/***************************************************************
+ * @brief One sample pass over an adapter.
+ *
+ * Bit i of a valid mask is set when item i of that group was read
+ * successfully during this pass.
+ ***************************************************************/
+struct AdapterSnapshot
+{
+    uint64_t sequence;        ///< Number of sample passes, 0 if never sampled
+    uint64_t hostTimestampNs; ///< Host steady clock at the end of the pass
+    uint32_t adapterIndex;
+
+    ctl_result_t telemetryResult;
+    ctl_power_telemetry_t telemetry;
+    HostBracket telemetryBracket;
+    uint64_t telemetryValidMask;                  ///< TELEMETRY_ITEM_BIT of every decoded item
+    double telemetryValues[TELEMETRY_ITEM_COUNT]; ///< Decoded items in watts and volts or as reported, see TelemetryDecodeEntry
+
+    uint32_t freqValidMask;
+    ctl_freq_state_t freqState[AGENT_MAX_FREQ_DOMAINS];
+
+    uint32_t throttleValidMask;
+    ctl_freq_throttle_time_t throttleTime[AGENT_MAX_FREQ_DOMAINS];
+    HostBracket throttleBracket[AGENT_MAX_FREQ_DOMAINS];
+
+    uint32_t tempValidMask;
+    double temperature[AGENT_MAX_TEMP_SENSORS];
+
+    uint32_t fanValidMask;
+    int32_t fanSpeedRpm[AGENT_MAX_FANS];
+
+    uint32_t powerLimitsValidMask;
+    ctl_power_limits_t powerLimits[AGENT_MAX_POWER_DOMAINS];
+
+    uint32_t energyValidMask;
+    ctl_power_energy_counter_t energyCounter[AGENT_MAX_POWER_DOMAINS];
+
+    uint32_t engineValidMask;
+    ctl_engine_stats_t engineStats[AGENT_MAX_ENGINE_GROUPS];
+    HostBracket engineBracket[AGENT_MAX_ENGINE_GROUPS];
+
+    uint32_t memValidMask;
+    ctl_mem_state_t memState[AGENT_MAX_MEM_MODULES];
+};
+
+#define DERIVED_VALID_GPU_POWER CTL_BIT(0)
+#define DERIVED_VALID_VRAM_POWER CTL_BIT(1)
+#define DERIVED_VALID_CARD_POWER CTL_BIT(2)
+#define DERIVED_VALID_GLOBAL_UTILIZATION CTL_BIT(3)
+#define DERIVED_VALID_RENDER_UTILIZATION CTL_BIT(4)
+#define DERIVED_VALID_MEDIA_UTILIZATION CTL_BIT(5)
+#define DERIVED_VALID_VRAM_READ CTL_BIT(6)
+#define DERIVED_VALID_VRAM_WRITE CTL_BIT(7)
+
+/***************************************************************
+ * @brief Rates derived from the counters of two consecutive snapshots.
+ *
+ * A metric is left out of validMask when either sample lacks it or the
+ * counter went backwards (reset or wrap) during the interval.
+ ***************************************************************/
+struct DerivedMetrics
+{
+    double intervalSec; ///< Telemetry timestamp delta, host time if the timestamp is unsupported
+    double gpuPowerW;
+    double vramPowerW;
+    double cardPowerW;
+    double globalUtilizationPct;
+    double renderUtilizationPct;
+    double mediaUtilizationPct;
+    double vramReadBytesPerSec;
+    double vramWriteBytesPerSec;
+    double engineUtilizationPct[AGENT_MAX_ENGINE_GROUPS];
+    uint32_t validMask;
+    uint32_t engineValidMask;
+};
+
+/***************************************************************
+ * @brief Snapshot plus derived metrics, the unit published to readers
+ ***************************************************************/
+struct PublishedSnapshot
+{
+    AdapterSnapshot snapshot;
+    DerivedMetrics derived;
+};
+
+/***************************************************************
+ * @brief Host steady clock in nanoseconds
+ ***************************************************************/
+inline uint64_t AgentHostTimeNs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/***************************************************************
+ * @brief One bit per adapter index, for every index below AGENT_MAX_ADAPTERS
+ ***************************************************************/
+struct AgentAdapterMask
+{
+    uint64_t words[AGENT_ADAPTER_MASK_WORDS];
+};
+
+inline void AgentAdapterMaskClear(AgentAdapterMask *pMask)
+{
+    for (uint32_t w = 0; w < AGENT_ADAPTER_MASK_WORDS; w++)
+    {
+        pMask->words[w] = 0;
+    }
+}
+
+inline void AgentAdapterMaskSetAll(AgentAdapterMask *pMask)
+{
+    for (uint32_t w = 0; w < AGENT_ADAPTER_MASK_WORDS; w++)
+    {
+        pMask->words[w] = ~0ull;
+    }
+}
+
+/***************************************************************
+ * @brief Adds an adapter, false if the index is AGENT_MAX_ADAPTERS or above
+ ***************************************************************/
+inline bool AgentAdapterMaskSet(AgentAdapterMask *pMask, uint32_t AdapterIndex)
+{
+    if (AdapterIndex >= AGENT_MAX_ADAPTERS)
+    {
+        return false;
+    }
+    pMask->words[AdapterIndex / 64] |= 1ull << (AdapterIndex % 64);
+    return true;
+}
+
+/***************************************************************
+ * @brief True if the adapter is in the mask, false for any index out of range
+ ***************************************************************/
+inline bool AgentAdapterMaskTest(const AgentAdapterMask *pMask, uint32_t AdapterIndex)
+{
+    return (AdapterIndex < AGENT_MAX_ADAPTERS) && (0 != (pMask->words[AdapterIndex / 64] & (1ull << (AdapterIndex % 64))));
+}
+
+/***************************************************************
+ * @brief Converts a telemetry item to double according to its data type
+ ***************************************************************/
+inline double TelemetryItemToDouble(const ctl_oc_telemetry_item_t &Item)
+{
+    switch (Item.type)
+    {
+        case CTL_DATA_TYPE_INT8:
+            return static_cast<double>(Item.value.data8);
+        case CTL_DATA_TYPE_UINT8:
+            return static_cast<double>(Item.value.datau8);
+        case CTL_DATA_TYPE_INT16:
+            return static_cast<double>(Item.value.data16);
+        case CTL_DATA_TYPE_UINT16:
+            return static_cast<double>(Item.value.datau16);
+        case CTL_DATA_TYPE_INT32:
+            return static_cast<double>(Item.value.data32);
+        case CTL_DATA_TYPE_UINT32:
+            return static_cast<double>(Item.value.datau32);
+        case CTL_DATA_TYPE_INT64:
+            return static_cast<double>(Item.value.data64);
+        case CTL_DATA_TYPE_UINT64:
+            return static_cast<double>(Item.value.datau64);
+        case CTL_DATA_TYPE_FLOAT:
+            return static_cast<double>(Item.value.datafloat);
+        case CTL_DATA_TYPE_DOUBLE:
+            return Item.value.datadouble;
+        default:
+            return 0.0;
+    }
+}
+
+ctl_result_t EnumerateAdapterTopology(ctl_device_adapter_handle_t hDevice, uint32_t AdapterIndex, AdapterTopology *pTopology);
+
+/***************************************************************
+ * @brief Runs one sample pass over an adapter
+ *
+ * pPlan is built from the first successful telemetry sample and reused to
+ * decode every later one.
+ ***************************************************************/
+ctl_result_t SampleAdapter(const AdapterTopology *pTopology, TelemetryDecodePlan *pPlan, AdapterSnapshot *pSnapshot);
+void ComputeDerivedMetrics(const AdapterSnapshot *pPrevious, const AdapterSnapshot *pCurrent, DerivedMetrics *pDerived);
+
+/***************************************************************
+ * @brief Lower case engine group name used in labels
+ ***************************************************************/
+const char *EngineGroupLabel(ctl_engine_group_t Group);
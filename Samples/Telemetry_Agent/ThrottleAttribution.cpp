@@ -0,0 +1,422 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  ThrottleAttribution.cpp
+ * @brief Splits hardware throttle time into the reasons that caused it.
+ *
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ThrottleAttribution.h"
+
+#define THROTTLE_REASON_BIT(Reason) CTL_BIT(Reason)
+
+/***************************************************************
+ * @brief Reasons flagged by one pass for one frequency domain
+ *
+ * The telemetry limit flags describe the GPU clock, so they are only
+ * applied to the GPU domain.
+ ***************************************************************/
+static uint32_t ThrottleReasonsAt(const AdapterSnapshot *pSnapshot, uint32_t DomainIndex, ctl_freq_domain_t Domain)
+{
+    uint32_t Reasons = 0;
+    if (0 != (pSnapshot->freqValidMask & CTL_BIT(DomainIndex)))
+    {
+        ctl_freq_throttle_reason_flags_t Flags = pSnapshot->freqState[DomainIndex].throttleReasons;
+        if (0 != (Flags & (CTL_FREQ_THROTTLE_REASON_FLAG_AVE_PWR_CAP | CTL_FREQ_THROTTLE_REASON_FLAG_BURST_PWR_CAP)))
+        {
+            Reasons |= THROTTLE_REASON_BIT(THROTTLE_REASON_POWER);
+        }
+        if (0 != (Flags & CTL_FREQ_THROTTLE_REASON_FLAG_THERMAL_LIMIT))
+        {
+            Reasons |= THROTTLE_REASON_BIT(THROTTLE_REASON_THERMAL);
+        }
+        if (0 != (Flags & (CTL_FREQ_THROTTLE_REASON_FLAG_CURRENT_LIMIT | CTL_FREQ_THROTTLE_REASON_FLAG_PSU_ALERT)))
+        {
+            Reasons |= THROTTLE_REASON_BIT(THROTTLE_REASON_CURRENT);
+        }
+        if (0 != (Flags & (CTL_FREQ_THROTTLE_REASON_FLAG_SW_RANGE | CTL_FREQ_THROTTLE_REASON_FLAG_HW_RANGE)))
+        {
+            Reasons |= THROTTLE_REASON_BIT(THROTTLE_REASON_RANGE);
+        }
+    }
+
+    if ((CTL_FREQ_DOMAIN_GPU == Domain) && (CTL_RESULT_SUCCESS == pSnapshot->telemetryResult))
+    {
+        const ctl_power_telemetry_t &Telemetry = pSnapshot->telemetry;
+        Reasons |= Telemetry.gpuPowerLimited ? THROTTLE_REASON_BIT(THROTTLE_REASON_POWER) : 0;
+        Reasons |= Telemetry.gpuTemperatureLimited ? THROTTLE_REASON_BIT(THROTTLE_REASON_THERMAL) : 0;
+        Reasons |= Telemetry.gpuCurrentLimited ? THROTTLE_REASON_BIT(THROTTLE_REASON_CURRENT) : 0;
+        Reasons |= Telemetry.gpuVoltageLimited ? THROTTLE_REASON_BIT(THROTTLE_REASON_VOLTAGE) : 0;
+    }
+    return Reasons;
+}
+
+bool ThrottleComputeInterval(const AdapterTopology *pTopology, const AdapterSnapshot *pPrevious, const AdapterSnapshot *pCurrent, ThrottleInterval *pInterval)
+{
+    memset(pInterval, 0, sizeof(ThrottleInterval));
+    pInterval->adapterIndex = pCurrent->adapterIndex;
+    if (0 == pPrevious->sequence)
+    {
+        return false;
+    }
+
+    pInterval->startNs     = pPrevious->hostTimestampNs;
+    pInterval->endNs       = pCurrent->hostTimestampNs;
+    pInterval->domainCount = pTopology->freqDomainCount;
+
+    for (uint32_t d = 0; d < pTopology->freqDomainCount; d++)
+    {
+        ThrottleDomainInterval *pDomain = &pInterval->domains[d];
+        pDomain->domain                 = pTopology->freqDomainType[d];
+
+        const uint32_t Bit = CTL_BIT(d);
+        if (0 == (pPrevious->throttleValidMask & pCurrent->throttleValidMask & Bit))
+        {
+            continue;
+        }
+
+        const ctl_freq_throttle_time_t &Before = pPrevious->throttleTime[d];
+        const ctl_freq_throttle_time_t &After  = pCurrent->throttleTime[d];
+        if ((After.timestamp <= Before.timestamp) || (After.throttleTime < Before.throttleTime))
+        {
+            // Counter reset, nothing can be said about this interval
+            continue;
+        }
+
+        pDomain->valid        = true;
+        pDomain->intervalSec  = static_cast<double>(After.timestamp - Before.timestamp) / 1e6;
+        pDomain->throttledSec = static_cast<double>(After.throttleTime - Before.throttleTime) / 1e6;
+        if (pDomain->throttledSec > pDomain->intervalSec)
+        {
+            pDomain->throttledSec = pDomain->intervalSec;
+        }
+        if (0.0 == pDomain->throttledSec)
+        {
+            continue;
+        }
+
+        uint32_t ReasonsBefore               = ThrottleReasonsAt(pPrevious, d, pDomain->domain);
+        uint32_t ReasonsAfter                = ThrottleReasonsAt(pCurrent, d, pDomain->domain);
+        double Weight[THROTTLE_REASON_COUNT] = {};
+        double WeightSum                     = 0.0;
+        for (uint32_t r = 0; r < THROTTLE_REASON_UNATTRIBUTED; r++)
+        {
+            Weight[r] = ((0 != (ReasonsBefore & THROTTLE_REASON_BIT(r))) ? 0.5 : 0.0) + ((0 != (ReasonsAfter & THROTTLE_REASON_BIT(r))) ? 0.5 : 0.0);
+            WeightSum += Weight[r];
+        }
+
+        if (0.0 == WeightSum)
+        {
+            pDomain->reasonSec[THROTTLE_REASON_UNATTRIBUTED] = pDomain->throttledSec;
+            continue;
+        }
+        for (uint32_t r = 0; r < THROTTLE_REASON_UNATTRIBUTED; r++)
+        {
+            pDomain->reasonSec[r] = pDomain->throttledSec * Weight[r] / WeightSum;
+        }
+    }
+
+    if ((CTL_RESULT_SUCCESS == pPrevious->telemetryResult) && (CTL_RESULT_SUCCESS == pCurrent->telemetryResult))
+    {
+        double IntervalSec               = static_cast<double>(pCurrent->hostTimestampNs - pPrevious->hostTimestampNs) / 1e9;
+        double Share                     = (pPrevious->telemetry.gpuUtilizationLimited ? 0.5 : 0.0) + (pCurrent->telemetry.gpuUtilizationLimited ? 0.5 : 0.0);
+        pInterval->utilizationLimitedSec = IntervalSec * Share;
+    }
+    return true;
+}
+
+/***************************************************************
+ * @brief Folds one interval into the summary entry of its adapter
+ ***************************************************************/
+static void ThrottleAccumulate(ThrottleSummary *pSummary, const ThrottleInterval *pInterval)
+{
+    ThrottleAdapterSummary *pAdapter = nullptr;
+    for (uint32_t i = 0; i < pSummary->adapterCount; i++)
+    {
+        if (pSummary->adapters[i].adapterIndex == pInterval->adapterIndex)
+        {
+            pAdapter = &pSummary->adapters[i];
+            break;
+        }
+    }
+    if (nullptr == pAdapter)
+    {
+        if (pSummary->adapterCount >= AGENT_MAX_ADAPTERS)
+        {
+            return;
+        }
+        pAdapter = &pSummary->adapters[pSummary->adapterCount++];
+        memset(pAdapter, 0, sizeof(ThrottleAdapterSummary));
+        pAdapter->adapterIndex = pInterval->adapterIndex;
+    }
+
+    pAdapter->intervals++;
+    pAdapter->utilizationLimitedSec += pInterval->utilizationLimitedSec;
+    for (uint32_t d = 0; d < pInterval->domainCount; d++)
+    {
+        const ThrottleDomainInterval *pDomain = &pInterval->domains[d];
+        if (!pDomain->valid)
+        {
+            continue;
+        }
+        if (CTL_FREQ_DOMAIN_MEMORY == pDomain->domain)
+        {
+            pAdapter->memoryThrottledSec += pDomain->throttledSec;
+        }
+        else if (CTL_FREQ_DOMAIN_GPU == pDomain->domain)
+        {
+            pAdapter->elapsedSec += pDomain->intervalSec;
+            pAdapter->throttledSec += pDomain->throttledSec;
+            for (uint32_t r = 0; r < THROTTLE_REASON_COUNT; r++)
+            {
+                pAdapter->reasonSec[r] += pDomain->reasonSec[r];
+            }
+        }
+    }
+    pSummary->endNs = pInterval->endNs;
+}
+
+static void ThrottleListener(const AdapterSnapshot *pPrevious, const PublishedSnapshot *pCurrent, void *pContext)
+{
+    ThrottleAttributor *pAttributor  = static_cast<ThrottleAttributor *>(pContext);
+    const AdapterTopology *pTopology = &pAttributor->pCache->topology[pCurrent->snapshot.adapterIndex];
+    if (!ThrottleComputeInterval(pTopology, pPrevious, &pCurrent->snapshot, &pAttributor->scratch))
+    {
+        return;
+    }
+
+    const ThrottleInterval *pInterval = &pAttributor->scratch;
+    {
+        std::lock_guard<std::mutex> Guard(pAttributor->lock);
+        pAttributor->latest[pInterval->adapterIndex] = *pInterval;
+        ThrottleAccumulate(&pAttributor->total, pInterval);
+        for (uint32_t w = 0, Seen = 0; (w < THROTTLE_MAX_WINDOWS) && (Seen < pAttributor->openWindows); w++)
+        {
+            ThrottleWindow *pWindow = &pAttributor->windows[w];
+            if (pWindow->open)
+            {
+                Seen++;
+                if (AgentAdapterMaskTest(&pWindow->adapters, pInterval->adapterIndex))
+                {
+                    ThrottleAccumulate(&pWindow->summary, pInterval);
+                }
+            }
+        }
+    }
+
+    if (nullptr != pAttributor->pfnCallback)
+    {
+        pAttributor->pfnCallback(pInterval, pAttributor->pContext);
+    }
+}
+
+ctl_result_t ThrottleAttributorInit(ThrottleAttributor *pAttributor, TelemetryCache *pCache, ThrottleIntervalCallback pfnCallback, void *pContext)
+{
+    if ((nullptr == pAttributor) || (nullptr == pCache))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    pAttributor->pCache      = pCache;
+    pAttributor->pfnCallback = pfnCallback;
+    pAttributor->pContext    = pContext;
+    {
+        std::lock_guard<std::mutex> Guard(pAttributor->lock);
+        memset(pAttributor->latest, 0, sizeof(pAttributor->latest));
+        memset(&pAttributor->total, 0, sizeof(pAttributor->total));
+        memset(pAttributor->windows, 0, sizeof(pAttributor->windows));
+        pAttributor->total.startNs = AgentHostTimeNs();
+        pAttributor->openWindows   = 0;
+    }
+
+    return TelemetryCacheAddListener(pCache, ThrottleListener, pAttributor);
+}
+
+ctl_result_t ThrottleAttributorLatest(ThrottleAttributor *pAttributor, uint32_t AdapterIndex, ThrottleInterval *pInterval)
+{
+    if ((nullptr == pAttributor) || (nullptr == pInterval))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (AdapterIndex >= pAttributor->pCache->adapterCount)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> Guard(pAttributor->lock);
+    *pInterval = pAttributor->latest[AdapterIndex];
+    return CTL_RESULT_SUCCESS;
+}
+
+void ThrottleAttributorTotals(ThrottleAttributor *pAttributor, ThrottleSummary *pSummary)
+{
+    std::lock_guard<std::mutex> Guard(pAttributor->lock);
+    *pSummary = pAttributor->total;
+}
+
+ctl_result_t ThrottleWindowBegin(ThrottleAttributor *pAttributor, const AgentAdapterMask *pAdapters, uint32_t *pWindowId)
+{
+    if ((nullptr == pAttributor) || (nullptr == pAdapters) || (nullptr == pWindowId))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    *pWindowId = THROTTLE_INVALID_WINDOW;
+    std::lock_guard<std::mutex> Guard(pAttributor->lock);
+    for (uint32_t w = 0; w < THROTTLE_MAX_WINDOWS; w++)
+    {
+        ThrottleWindow *pWindow = &pAttributor->windows[w];
+        if (!pWindow->open)
+        {
+            memset(&pWindow->summary, 0, sizeof(ThrottleSummary));
+            pWindow->open            = true;
+            pWindow->adapters        = *pAdapters;
+            pWindow->summary.startNs = AgentHostTimeNs();
+            pWindow->summary.endNs   = pWindow->summary.startNs;
+            pAttributor->openWindows++;
+            *pWindowId = w;
+            return CTL_RESULT_SUCCESS;
+        }
+    }
+    return CTL_RESULT_ERROR_OUT_OF_HOST_MEMORY;
+}
+
+ctl_result_t ThrottleWindowEnd(ThrottleAttributor *pAttributor, uint32_t WindowId, ThrottleSummary *pSummary)
+{
+    if ((nullptr == pAttributor) || (nullptr == pSummary))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(pAttributor->lock);
+    if ((WindowId >= THROTTLE_MAX_WINDOWS) || !pAttributor->windows[WindowId].open)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    ThrottleWindow *pWindow = &pAttributor->windows[WindowId];
+    pWindow->open           = false;
+    pAttributor->openWindows--;
+    *pSummary = pWindow->summary;
+    return CTL_RESULT_SUCCESS;
+}
+
+ThrottleReason ThrottleBoundReason(const ThrottleAdapterSummary *pSummary)
+{
+    if ((pSummary->elapsedSec <= 0.0) || (pSummary->throttledSec < THROTTLE_BOUND_FRACTION * pSummary->elapsedSec))
+    {
+        return THROTTLE_REASON_COUNT;
+    }
+
+    uint32_t Dominant = THROTTLE_REASON_UNATTRIBUTED;
+    for (uint32_t r = 0; r < THROTTLE_REASON_COUNT; r++)
+    {
+        if (pSummary->reasonSec[r] > pSummary->reasonSec[Dominant])
+        {
+            Dominant = r;
+        }
+    }
+    return static_cast<ThrottleReason>(Dominant);
+}
+
+const char *ThrottleReasonLabel(ThrottleReason Reason)
+{
+    switch (Reason)
+    {
+        case THROTTLE_REASON_POWER:
+            return "power";
+        case THROTTLE_REASON_THERMAL:
+            return "thermal";
+        case THROTTLE_REASON_CURRENT:
+            return "current";
+        case THROTTLE_REASON_VOLTAGE:
+            return "voltage";
+        case THROTTLE_REASON_RANGE:
+            return "frequency_range";
+        case THROTTLE_REASON_UNATTRIBUTED:
+            return "unattributed";
+        default:
+            return "none";
+    }
+}
+
+/***************************************************************
+ * @brief snprintf at *pLength, truncating at the end of the buffer
+ ***************************************************************/
+static void FormatAppend(char *pBuffer, size_t BufferSize, size_t *pLength, const char *pFormat, ...)
+{
+    if (*pLength + 1 >= BufferSize)
+    {
+        return;
+    }
+
+    va_list Args;
+    va_start(Args, pFormat);
+    int Written = vsnprintf(pBuffer + *pLength, BufferSize - *pLength, pFormat, Args);
+    va_end(Args);
+
+    if (Written > 0)
+    {
+        *pLength += static_cast<size_t>(Written);
+        *pLength = (*pLength < BufferSize) ? *pLength : BufferSize - 1;
+    }
+}
+
+size_t ThrottleAdapterSummaryFormat(const ThrottleAdapterSummary *pAdapter, char *pBuffer, size_t BufferSize)
+{
+    if ((nullptr == pAdapter) || (nullptr == pBuffer) || (0 == BufferSize))
+    {
+        return 0;
+    }
+
+    size_t Length        = 0;
+    double Percent       = (pAdapter->elapsedSec > 0.0) ? 100.0 * pAdapter->throttledSec / pAdapter->elapsedSec : 0.0;
+    ThrottleReason Bound = ThrottleBoundReason(pAdapter);
+    pBuffer[0]           = '\0';
+
+    FormatAppend(pBuffer, BufferSize, &Length, "Adapter %u: %.1f s, throttled %.2f s (%.1f %%)", pAdapter->adapterIndex, pAdapter->elapsedSec, pAdapter->throttledSec, Percent);
+    for (uint32_t r = 0; r < THROTTLE_REASON_COUNT; r++)
+    {
+        if (pAdapter->reasonSec[r] > 0.0)
+        {
+            FormatAppend(pBuffer, BufferSize, &Length, ", %s %.2f s", ThrottleReasonLabel(static_cast<ThrottleReason>(r)), pAdapter->reasonSec[r]);
+        }
+    }
+    FormatAppend(pBuffer, BufferSize, &Length, "; memory throttled %.2f s, low load %.2f s -> ", pAdapter->memoryThrottledSec, pAdapter->utilizationLimitedSec);
+    if (THROTTLE_REASON_COUNT == Bound)
+    {
+        FormatAppend(pBuffer, BufferSize, &Length, "not throttle bound\n");
+    }
+    else
+    {
+        FormatAppend(pBuffer, BufferSize, &Length, "%s bound\n", ThrottleReasonLabel(Bound));
+    }
+    return Length;
+}
+
+size_t ThrottleSummaryFormat(const ThrottleSummary *pSummary, char *pBuffer, size_t BufferSize)
+{
+    if ((nullptr == pSummary) || (nullptr == pBuffer) || (0 == BufferSize))
+    {
+        return 0;
+    }
+
+    size_t Length = 0;
+    pBuffer[0]    = '\0';
+    for (uint32_t i = 0; i < pSummary->adapterCount; i++)
+    {
+        Length += ThrottleAdapterSummaryFormat(&pSummary->adapters[i], pBuffer + Length, BufferSize - Length);
+    }
+    return Length;
+}
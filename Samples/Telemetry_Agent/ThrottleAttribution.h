@@ -0,0 +1,184 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  ThrottleAttribution.h
+ * @brief Splits hardware throttle time into the reasons that caused it.
+ *
+ * ctlFrequencyGetThrottleTime says how long a frequency domain was limited
+ * but not why. The limit flags of ctlPowerTelemetryGet and the throttle
+ * reasons of ctlFrequencyGetState say why, but only at the instant they are
+ * read. For every interval between two passes of the telemetry cache the
+ * throttle time of each domain is divided between the reasons flagged at
+ * either end of the interval, each end weighted by half. Time throttled
+ * without any flag is reported as unattributed.
+ *
+ * Results are delivered per interval to a callback on the sampler thread
+ * and accumulated into job windows that can be opened and closed from any
+ * thread.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+
+#include "TelemetryCache.h"
+
+#define THROTTLE_MAX_WINDOWS 32
+#define THROTTLE_INVALID_WINDOW 0xFFFFFFFFu
+#define THROTTLE_REPORT_LINE_LEN 512 ///< Longest line of ThrottleAdapterSummaryFormat
+#define THROTTLE_BOUND_FRACTION 0.05 ///< Throttled share of a window above which it is reported as bound
+
+enum ThrottleReason
+{
+    THROTTLE_REASON_POWER = 0, ///< Average or burst power limit, gpuPowerLimited
+    THROTTLE_REASON_THERMAL,   ///< gpuTemperatureLimited or thermal excursion
+    THROTTLE_REASON_CURRENT,   ///< gpuCurrentLimited, current excursion or PSU alert
+    THROTTLE_REASON_VOLTAGE,   ///< gpuVoltageLimited
+    THROTTLE_REASON_RANGE,     ///< Software or hardware frequency range
+    THROTTLE_REASON_UNATTRIBUTED,
+    THROTTLE_REASON_COUNT
+};
+
+/***************************************************************
+ * @brief One frequency domain over one interval
+ ***************************************************************/
+struct ThrottleDomainInterval
+{
+    ctl_freq_domain_t domain;
+    bool valid;
+    double intervalSec; ///< From the throttle counter timestamps
+    double throttledSec;
+    double reasonSec[THROTTLE_REASON_COUNT]; ///< Sums to throttledSec
+};
+
+/***************************************************************
+ * @brief Breakdown of one adapter between two consecutive passes
+ ***************************************************************/
+struct ThrottleInterval
+{
+    uint32_t adapterIndex;
+    uint64_t startNs; ///< Host time of the earlier pass
+    uint64_t endNs;
+    uint32_t domainCount;
+    ThrottleDomainInterval domains[AGENT_MAX_FREQ_DOMAINS];
+    double utilizationLimitedSec; ///< Time gpuUtilizationLimited was set, not hardware throttling
+};
+
+typedef void (*ThrottleIntervalCallback)(const ThrottleInterval *pInterval, void *pContext);
+
+/***************************************************************
+ * @brief Accumulated GPU domain breakdown of one adapter
+ ***************************************************************/
+struct ThrottleAdapterSummary
+{
+    uint32_t adapterIndex;
+    uint64_t intervals;
+    double elapsedSec;
+    double throttledSec;
+    double reasonSec[THROTTLE_REASON_COUNT];
+    double memoryThrottledSec;
+    double utilizationLimitedSec;
+};
+
+struct ThrottleSummary
+{
+    uint64_t startNs;
+    uint64_t endNs;
+    uint32_t adapterCount;
+    ThrottleAdapterSummary adapters[AGENT_MAX_ADAPTERS];
+};
+
+struct ThrottleWindow
+{
+    bool open;
+    AgentAdapterMask adapters; ///< The adapters the job runs on
+    ThrottleSummary summary;
+};
+
+struct ThrottleAttributor
+{
+    const TelemetryCache *pCache;
+    ThrottleIntervalCallback pfnCallback;
+    void *pContext;
+
+    ThrottleInterval scratch; ///< Sampler private
+
+    std::mutex lock; ///< Guards everything below
+    ThrottleInterval latest[AGENT_MAX_ADAPTERS];
+    ThrottleSummary total; ///< Since ThrottleAttributorInit
+    uint32_t openWindows;
+    ThrottleWindow windows[THROTTLE_MAX_WINDOWS];
+};
+
+/***************************************************************
+ * @brief Registers the attributor as a listener of the cache
+ *
+ * pfnCallback may be nullptr. Otherwise it is called on the sampler thread
+ * for every interval of every adapter and must not block. Call before
+ * TelemetryCacheStart.
+ ***************************************************************/
+ctl_result_t ThrottleAttributorInit(ThrottleAttributor *pAttributor, TelemetryCache *pCache, ThrottleIntervalCallback pfnCallback, void *pContext);
+
+/***************************************************************
+ * @brief Computes the breakdown between two passes of one adapter
+ *
+ * Returns false if there is no previous pass. Does not touch any state.
+ ***************************************************************/
+bool ThrottleComputeInterval(const AdapterTopology *pTopology, const AdapterSnapshot *pPrevious, const AdapterSnapshot *pCurrent, ThrottleInterval *pInterval);
+
+/***************************************************************
+ * @brief Copies the most recent interval of an adapter
+ ***************************************************************/
+ctl_result_t ThrottleAttributorLatest(ThrottleAttributor *pAttributor, uint32_t AdapterIndex, ThrottleInterval *pInterval);
+
+/***************************************************************
+ * @brief Copies the totals since ThrottleAttributorInit
+ ***************************************************************/
+void ThrottleAttributorTotals(ThrottleAttributor *pAttributor, ThrottleSummary *pSummary);
+
+/***************************************************************
+ * @brief Opens a job window over the adapters in pAdapters
+ *
+ * Intervals that end after this call are accumulated into the window.
+ ***************************************************************/
+ctl_result_t ThrottleWindowBegin(ThrottleAttributor *pAttributor, const AgentAdapterMask *pAdapters, uint32_t *pWindowId);
+
+/***************************************************************
+ * @brief Closes a window and returns what was accumulated
+ ***************************************************************/
+ctl_result_t ThrottleWindowEnd(ThrottleAttributor *pAttributor, uint32_t WindowId, ThrottleSummary *pSummary);
+
+/***************************************************************
+ * @brief Reason with the most throttled time, or THROTTLE_REASON_COUNT
+ *        if less than THROTTLE_BOUND_FRACTION of the time was throttled
+ ***************************************************************/
+ThrottleReason ThrottleBoundReason(const ThrottleAdapterSummary *pSummary);
+
+const char *ThrottleReasonLabel(ThrottleReason Reason);
+
+/***************************************************************
+ * @brief Formats the line of one adapter, newline included
+ *
+ * THROTTLE_REPORT_LINE_LEN always holds the line. Returns the number of
+ * characters written, excluding the terminator.
+ ***************************************************************/
+size_t ThrottleAdapterSummaryFormat(const ThrottleAdapterSummary *pAdapter, char *pBuffer, size_t BufferSize);
+
+/***************************************************************
+ * @brief Formats a summary as one text line per adapter
+ *
+ * Truncates at the end of the buffer; size it at adapterCount times
+ * THROTTLE_REPORT_LINE_LEN, or format each adapter on its own. Returns the
+ * number of characters written, excluding the terminator.
+ ***************************************************************/
+size_t ThrottleSummaryFormat(const ThrottleSummary *pSummary, char *pBuffer, size_t BufferSize);
@@ -0,0 +1,216 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  TimeSeriesStore.cpp
+ * @brief In memory store of recent telemetry time series.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <new>
+
+#include "TimeSeriesStore.h"
+
+ctl_result_t TimeSeriesStoreInit(TimeSeriesStore *pStore, uint32_t PointsPerSeries)
+{
+    if (nullptr == pStore)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> Guard(pStore->lock);
+    pStore->pointsPerSeries = (0 != PointsPerSeries) ? PointsPerSeries : TIME_SERIES_DEFAULT_POINTS;
+    pStore->seriesCount     = 0;
+    return CTL_RESULT_SUCCESS;
+}
+
+static uint32_t FindLocked(TimeSeriesStore *pStore, const char *pName, const char *pLabels)
+{
+    for (uint32_t i = 0; i < pStore->seriesCount; i++)
+    {
+        if ((0 == strncmp(pStore->series[i].name, pName, TIME_SERIES_NAME_LEN)) && (0 == strncmp(pStore->series[i].labels, pLabels, TIME_SERIES_LABELS_LEN)))
+        {
+            return i;
+        }
+    }
+    return TIME_SERIES_INVALID_ID;
+}
+
+uint32_t TimeSeriesStoreFind(TimeSeriesStore *pStore, const char *pName, const char *pLabels)
+{
+    if ((nullptr == pStore) || (nullptr == pName))
+    {
+        return TIME_SERIES_INVALID_ID;
+    }
+
+    std::lock_guard<std::mutex> Guard(pStore->lock);
+    return FindLocked(pStore, pName, (nullptr != pLabels) ? pLabels : "");
+}
+
+uint32_t TimeSeriesStoreRegister(TimeSeriesStore *pStore, const char *pName, const char *pLabels)
+{
+    if ((nullptr == pStore) || (nullptr == pName))
+    {
+        return TIME_SERIES_INVALID_ID;
+    }
+    if (nullptr == pLabels)
+    {
+        pLabels = "";
+    }
+
+    std::lock_guard<std::mutex> Guard(pStore->lock);
+    uint32_t Id = FindLocked(pStore, pName, pLabels);
+    if ((TIME_SERIES_INVALID_ID != Id) || (pStore->seriesCount >= TIME_SERIES_MAX_SERIES))
+    {
+        return Id;
+    }
+
+    TimeSeries *pSeries = &pStore->series[pStore->seriesCount];
+    try
+    {
+        pSeries->points.assign(pStore->pointsPerSeries, TimeSeriesPoint{ 0, 0.0 });
+    }
+    catch (std::bad_alloc &)
+    {
+        return TIME_SERIES_INVALID_ID;
+    }
+
+    snprintf(pSeries->name, sizeof(pSeries->name), "%s", pName);
+    snprintf(pSeries->labels, sizeof(pSeries->labels), "%s", pLabels);
+    pSeries->appended = 0;
+    return pStore->seriesCount++;
+}
+
+static void AppendLocked(TimeSeries *pSeries, uint64_t TimestampNs, double Value)
+{
+    size_t Capacity                               = pSeries->points.size();
+    pSeries->points[pSeries->appended % Capacity] = { TimestampNs, Value };
+    pSeries->appended++;
+}
+
+void TimeSeriesStoreAppend(TimeSeriesStore *pStore, uint32_t SeriesId, uint64_t TimestampNs, double Value)
+{
+    std::lock_guard<std::mutex> Guard(pStore->lock);
+    if (SeriesId < pStore->seriesCount)
+    {
+        AppendLocked(&pStore->series[SeriesId], TimestampNs, Value);
+    }
+}
+
+void TimeSeriesStoreAppendBatch(TimeSeriesStore *pStore, const uint32_t *pSeriesIds, const double *pValues, uint32_t Count, uint64_t TimestampNs)
+{
+    std::lock_guard<std::mutex> Guard(pStore->lock);
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        if (pSeriesIds[i] < pStore->seriesCount)
+        {
+            AppendLocked(&pStore->series[pSeriesIds[i]], TimestampNs, pValues[i]);
+        }
+    }
+}
+
+/***************************************************************
+ * @brief Number of stored points and ring index of the oldest
+ ***************************************************************/
+static uint64_t StoredPoints(const TimeSeries *pSeries, uint64_t *pOldest)
+{
+    uint64_t Capacity = pSeries->points.size();
+    uint64_t Stored   = (pSeries->appended < Capacity) ? pSeries->appended : Capacity;
+    *pOldest          = pSeries->appended - Stored;
+    return Stored;
+}
+
+uint32_t TimeSeriesStoreRead(TimeSeriesStore *pStore, uint32_t SeriesId, uint64_t SinceNs, TimeSeriesPoint *pPoints, uint32_t MaxPoints)
+{
+    if ((nullptr == pStore) || (nullptr == pPoints) || (0 == MaxPoints))
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> Guard(pStore->lock);
+    if (SeriesId >= pStore->seriesCount)
+    {
+        return 0;
+    }
+
+    const TimeSeries *pSeries = &pStore->series[SeriesId];
+    size_t Capacity           = pSeries->points.size();
+    uint64_t Oldest;
+    uint64_t Stored = StoredPoints(pSeries, &Oldest);
+
+    // Walk back from the newest point to find the first one to return
+    uint64_t First = Oldest + Stored;
+    while ((First > Oldest) && (pSeries->points[(First - 1) % Capacity].timestampNs > SinceNs) && ((Oldest + Stored - First) < MaxPoints))
+    {
+        First--;
+    }
+
+    uint32_t Count = 0;
+    for (uint64_t i = First; i < Oldest + Stored; i++)
+    {
+        pPoints[Count++] = pSeries->points[i % Capacity];
+    }
+    return Count;
+}
+
+bool TimeSeriesStoreLatest(TimeSeriesStore *pStore, uint32_t SeriesId, TimeSeriesPoint *pPoint)
+{
+    if ((nullptr == pStore) || (nullptr == pPoint))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> Guard(pStore->lock);
+    if ((SeriesId >= pStore->seriesCount) || (0 == pStore->series[SeriesId].appended))
+    {
+        return false;
+    }
+
+    const TimeSeries *pSeries = &pStore->series[SeriesId];
+    *pPoint                   = pSeries->points[(pSeries->appended - 1) % pSeries->points.size()];
+    return true;
+}
+
+bool TimeSeriesStoreWindowMean(TimeSeriesStore *pStore, uint32_t SeriesId, uint64_t WindowNs, double *pMean)
+{
+    if ((nullptr == pStore) || (nullptr == pMean))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> Guard(pStore->lock);
+    if ((SeriesId >= pStore->seriesCount) || (0 == pStore->series[SeriesId].appended))
+    {
+        return false;
+    }
+
+    const TimeSeries *pSeries = &pStore->series[SeriesId];
+    size_t Capacity           = pSeries->points.size();
+    uint64_t Oldest;
+    uint64_t Stored   = StoredPoints(pSeries, &Oldest);
+    uint64_t NewestNs = pSeries->points[(Oldest + Stored - 1) % Capacity].timestampNs;
+
+    double Sum     = 0.0;
+    uint32_t Count = 0;
+    for (uint64_t i = Oldest + Stored; i > Oldest; i--)
+    {
+        const TimeSeriesPoint &Point = pSeries->points[(i - 1) % Capacity];
+        if (NewestNs - Point.timestampNs > WindowNs)
+        {
+            break;
+        }
+        Sum += Point.value;
+        Count++;
+    }
+
+    *pMean = Sum / Count;
+    return true;
+}
@@ -0,0 +1,103 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  TimeSeriesStore.h
+ * @brief In memory store of recent telemetry time series.
+ *
+ * Each series is a fixed capacity ring of (host time, value) points
+ * identified by a name and a label string such as adapter="0",group="media".
+ * Storage for a series is allocated once when it is registered, so appending
+ * never allocates and old points are overwritten in order.
+ *
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <mutex>
+#include <vector>
+
+#include "igcl_api.h"
+
+#define TIME_SERIES_MAX_SERIES 512
+#define TIME_SERIES_NAME_LEN 64
+#define TIME_SERIES_LABELS_LEN 96
+#define TIME_SERIES_DEFAULT_POINTS 600
+#define TIME_SERIES_INVALID_ID 0xFFFFFFFFu
+
+struct TimeSeriesPoint
+{
+    uint64_t timestampNs; ///< Host steady clock, see AgentHostTimeNs
+    double value;
+};
+
+struct TimeSeries
+{
+    char name[TIME_SERIES_NAME_LEN];
+    char labels[TIME_SERIES_LABELS_LEN];
+    uint64_t appended; ///< Points appended since registration
+    std::vector<TimeSeriesPoint> points;
+};
+
+struct TimeSeriesStore
+{
+    uint32_t pointsPerSeries;
+    uint32_t seriesCount;
+    std::mutex lock;
+    TimeSeries series[TIME_SERIES_MAX_SERIES];
+};
+
+/***************************************************************
+ * @brief Weight of a new interval for an average with time constant Tau
+ *
+ * Derived from the interval length, so missed or late ticks do not change
+ * the effective window of an exponentially weighted average.
+ ***************************************************************/
+inline double TimeSeriesEwmaWeight(double IntervalSec, double TauSec)
+{
+    return 1.0 - exp(-IntervalSec / TauSec);
+}
+
+ctl_result_t TimeSeriesStoreInit(TimeSeriesStore *pStore, uint32_t PointsPerSeries);
+
+/***************************************************************
+ * @brief Returns the id of a series, registering it on first use
+ *
+ * TIME_SERIES_INVALID_ID if the store is full or allocation failed.
+ ***************************************************************/
+uint32_t TimeSeriesStoreRegister(TimeSeriesStore *pStore, const char *pName, const char *pLabels);
+
+/***************************************************************
+ * @brief Id of an existing series or TIME_SERIES_INVALID_ID
+ ***************************************************************/
+uint32_t TimeSeriesStoreFind(TimeSeriesStore *pStore, const char *pName, const char *pLabels);
+
+void TimeSeriesStoreAppend(TimeSeriesStore *pStore, uint32_t SeriesId, uint64_t TimestampNs, double Value);
+
+/***************************************************************
+ * @brief Appends one point to each of Count series under a single lock
+ ***************************************************************/
+void TimeSeriesStoreAppendBatch(TimeSeriesStore *pStore, const uint32_t *pSeriesIds, const double *pValues, uint32_t Count, uint64_t TimestampNs);
+
+/***************************************************************
+ * @brief Copies the points newer than SinceNs, oldest first
+ *
+ * Returns the number of points written to pPoints, at most MaxPoints. When
+ * more points match, the newest MaxPoints are returned.
+ ***************************************************************/
+uint32_t TimeSeriesStoreRead(TimeSeriesStore *pStore, uint32_t SeriesId, uint64_t SinceNs, TimeSeriesPoint *pPoints, uint32_t MaxPoints);
+
+bool TimeSeriesStoreLatest(TimeSeriesStore *pStore, uint32_t SeriesId, TimeSeriesPoint *pPoint);
+
+/***************************************************************
+ * @brief Mean of the points within WindowNs of the newest point
+ ***************************************************************/
+bool TimeSeriesStoreWindowMean(TimeSeriesStore *pStore, uint32_t SeriesId, uint64_t WindowNs, double *pMean);
@@ -0,0 +1,391 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  VfCurve.cpp
+ * @brief Voltage frequency curves of the overclocking V2 API.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#include "VfCurve.h"
+
+static bool VfCurvePointLess(const ctl_voltage_frequency_point_t &Left, const ctl_voltage_frequency_point_t &Right)
+{
+    return (Left.Voltage < Right.Voltage) || ((Left.Voltage == Right.Voltage) && (Left.Frequency < Right.Frequency));
+}
+
+static bool VfCurveVoltageBelow(double VoltageMv, const ctl_voltage_frequency_point_t &Point)
+{
+    return VoltageMv < Point.Voltage;
+}
+
+static bool VfCurveFrequencyBelow(const ctl_voltage_frequency_point_t &Point, double FrequencyMhz)
+{
+    return Point.Frequency < FrequencyMhz;
+}
+
+static double VfCurveStep(const VfCurveLimits *pLimits, bool Voltage)
+{
+    if (nullptr == pLimits)
+    {
+        return 1.0;
+    }
+    return std::max(1.0, Voltage ? pLimits->voltageStepMv : pLimits->frequencyStepMhz);
+}
+
+ctl_result_t VfCurveLimitsFromProperties(const ctl_oc_properties_t *pProperties, VfCurveLimits *pLimits)
+{
+    if ((nullptr == pProperties) || (nullptr == pLimits))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (0 == pProperties->Version)
+    {
+        return CTL_RESULT_ERROR_UNSUPPORTED_VERSION;
+    }
+
+    const ctl_oc_control_info_t &Voltage   = pProperties->gpuVFCurveVoltageLimit;
+    const ctl_oc_control_info_t &Frequency = pProperties->gpuVFCurveFrequencyLimit;
+    if (!pProperties->bSupported || !Voltage.bSupported || !Frequency.bSupported)
+    {
+        return CTL_RESULT_ERROR_UNSUPPORTED_FEATURE;
+    }
+
+    // Points are in millivolts whatever unit the limit is given in
+    double Scale              = (CTL_UNITS_VOLTAGE_VOLTS == Voltage.units) ? 1000.0 : 1.0;
+    pLimits->voltageMinMv     = Voltage.min * Scale;
+    pLimits->voltageMaxMv     = Voltage.max * Scale;
+    pLimits->voltageStepMv    = std::max(1.0, Voltage.step * Scale);
+    pLimits->frequencyMinMhz  = Frequency.min;
+    pLimits->frequencyMaxMhz  = Frequency.max;
+    pLimits->frequencyStepMhz = std::max(1.0, Frequency.step);
+    return (pLimits->voltageMaxMv >= pLimits->voltageMinMv) && (pLimits->frequencyMaxMhz >= pLimits->frequencyMinMhz) ? CTL_RESULT_SUCCESS : CTL_RESULT_ERROR_INVALID_ARGUMENT;
+}
+
+ctl_result_t VfCurveRead(ctl_device_adapter_handle_t hDevice, ctl_vf_curve_type_t Type, ctl_vf_curve_details_t Details, VfCurve *pCurve)
+{
+    if (nullptr == pCurve)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+
+    uint32_t Count      = 0;
+    ctl_result_t Result = ctlOverclockReadVFCurve(hDevice, Type, Details, &Count, nullptr);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        return Result;
+    }
+    if ((0 == Count) || (Count > VF_CURVE_MAX_POINTS))
+    {
+        return CTL_RESULT_ERROR_INVALID_SIZE;
+    }
+
+    Result = ctlOverclockReadVFCurve(hDevice, Type, Details, &Count, pCurve->points);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        return Result;
+    }
+    pCurve->details    = Details;
+    pCurve->pointCount = Count;
+    std::stable_sort(pCurve->points, pCurve->points + Count, VfCurvePointLess);
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t VfCurveSet(VfCurve *pCurve, ctl_vf_curve_details_t Details, const ctl_voltage_frequency_point_t *pPoints, uint32_t PointCount)
+{
+    if ((nullptr == pCurve) || ((nullptr == pPoints) && (0 != PointCount)))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (PointCount > VF_CURVE_MAX_POINTS)
+    {
+        return CTL_RESULT_ERROR_INVALID_SIZE;
+    }
+
+    memmove(pCurve->points, pPoints, PointCount * sizeof(ctl_voltage_frequency_point_t));
+    pCurve->details    = Details;
+    pCurve->pointCount = PointCount;
+    std::stable_sort(pCurve->points, pCurve->points + PointCount, VfCurvePointLess);
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t VfCurveValidate(const VfCurve *pCurve, const VfCurveLimits *pLimits)
+{
+    if (nullptr == pCurve)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((0 == pCurve->pointCount) || (pCurve->pointCount > VF_CURVE_MAX_POINTS))
+    {
+        return CTL_RESULT_ERROR_CORE_OVERCLOCK_INVALID_CUSTOM_VF_CURVE;
+    }
+
+    for (uint32_t i = 0; i < pCurve->pointCount; i++)
+    {
+        const ctl_voltage_frequency_point_t &Point = pCurve->points[i];
+        if ((nullptr != pLimits) && ((Point.Voltage < pLimits->voltageMinMv) || (Point.Voltage > pLimits->voltageMaxMv)))
+        {
+            return CTL_RESULT_ERROR_CORE_OVERCLOCK_VOLTAGE_OUTSIDE_RANGE;
+        }
+        if ((nullptr != pLimits) && ((Point.Frequency < pLimits->frequencyMinMhz) || (Point.Frequency > pLimits->frequencyMaxMhz)))
+        {
+            return CTL_RESULT_ERROR_CORE_OVERCLOCK_FREQUENCY_OUTSIDE_RANGE;
+        }
+        if ((i > 0) && ((Point.Voltage <= pCurve->points[i - 1].Voltage) || (Point.Frequency < pCurve->points[i - 1].Frequency)))
+        {
+            return CTL_RESULT_ERROR_CORE_OVERCLOCK_INVALID_CUSTOM_VF_CURVE;
+        }
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t VfCurveEnforce(VfCurve *pCurve, const VfCurveLimits *pLimits, uint32_t *pAdjusted)
+{
+    if (nullptr == pCurve)
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((0 == pCurve->pointCount) || (pCurve->pointCount > VF_CURVE_MAX_POINTS))
+    {
+        return CTL_RESULT_ERROR_CORE_OVERCLOCK_INVALID_CUSTOM_VF_CURVE;
+    }
+
+    const uint32_t Count = pCurve->pointCount;
+    ctl_voltage_frequency_point_t Original[VF_CURVE_MAX_POINTS];
+    memcpy(Original, pCurve->points, Count * sizeof(ctl_voltage_frequency_point_t));
+
+    if (nullptr != pLimits)
+    {
+        for (uint32_t i = 0; i < Count; i++)
+        {
+            ctl_voltage_frequency_point_t &Point = pCurve->points[i];
+            Point.Voltage                        = static_cast<uint32_t>(std::min(std::max<double>(Point.Voltage, ceil(pLimits->voltageMinMv)), floor(pLimits->voltageMaxMv)));
+            Point.Frequency                      = static_cast<uint32_t>(std::min(std::max<double>(Point.Frequency, ceil(pLimits->frequencyMinMhz)), floor(pLimits->frequencyMaxMhz)));
+        }
+    }
+
+    // A repeated voltage moves up, so a point never runs its clock on less
+    // voltage than asked; a frequency above a later one comes down to it
+    const uint32_t VoltageStep = static_cast<uint32_t>(ceil(VfCurveStep(pLimits, true)));
+    const double MaxMv         = (nullptr != pLimits) ? pLimits->voltageMaxMv : static_cast<double>(UINT32_MAX);
+    for (uint32_t i = 1; i < Count; i++)
+    {
+        if (pCurve->points[i].Voltage <= pCurve->points[i - 1].Voltage)
+        {
+            pCurve->points[i].Voltage = pCurve->points[i - 1].Voltage + VoltageStep;
+        }
+        if (pCurve->points[i].Voltage > MaxMv)
+        {
+            memcpy(pCurve->points, Original, Count * sizeof(ctl_voltage_frequency_point_t));
+            return CTL_RESULT_ERROR_CORE_OVERCLOCK_VOLTAGE_OUTSIDE_RANGE;
+        }
+    }
+    for (uint32_t i = Count - 1; i > 0; i--)
+    {
+        pCurve->points[i - 1].Frequency = std::min(pCurve->points[i - 1].Frequency, pCurve->points[i].Frequency);
+    }
+
+    if (nullptr != pAdjusted)
+    {
+        *pAdjusted = 0;
+        for (uint32_t i = 0; i < Count; i++)
+        {
+            *pAdjusted += ((pCurve->points[i].Voltage != Original[i].Voltage) || (pCurve->points[i].Frequency != Original[i].Frequency)) ? 1 : 0;
+        }
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+double VfCurveFrequencyAt(const VfCurve *pCurve, double VoltageMv)
+{
+    const uint32_t Count                       = pCurve->pointCount;
+    const ctl_voltage_frequency_point_t *pBase = pCurve->points;
+    if (0 == Count)
+    {
+        return 0.0;
+    }
+    if (VoltageMv <= pBase[0].Voltage)
+    {
+        return pBase[0].Frequency;
+    }
+    if (VoltageMv >= pBase[Count - 1].Voltage)
+    {
+        return pBase[Count - 1].Frequency;
+    }
+
+    // First point above the voltage, never the first point here
+    const ctl_voltage_frequency_point_t *pAbove = std::upper_bound(pBase, pBase + Count, VoltageMv, VfCurveVoltageBelow);
+    const ctl_voltage_frequency_point_t *pBelow = pAbove - 1;
+    double Fraction                             = (VoltageMv - pBelow->Voltage) / (static_cast<double>(pAbove->Voltage) - pBelow->Voltage);
+    return pBelow->Frequency + (static_cast<double>(pAbove->Frequency) - pBelow->Frequency) * Fraction;
+}
+
+double VfCurveVoltageAt(const VfCurve *pCurve, double FrequencyMhz)
+{
+    const uint32_t Count                       = pCurve->pointCount;
+    const ctl_voltage_frequency_point_t *pBase = pCurve->points;
+    if (0 == Count)
+    {
+        return 0.0;
+    }
+    if (FrequencyMhz <= pBase[0].Frequency)
+    {
+        return pBase[0].Voltage;
+    }
+    if (FrequencyMhz >= pBase[Count - 1].Frequency)
+    {
+        return pBase[Count - 1].Voltage;
+    }
+
+    // First point that reaches the frequency, so a flat stretch yields its lowest voltage
+    const ctl_voltage_frequency_point_t *pAbove = std::lower_bound(pBase, pBase + Count, FrequencyMhz, VfCurveFrequencyBelow);
+    const ctl_voltage_frequency_point_t *pBelow = pAbove - 1;
+    double Fraction                             = (FrequencyMhz - pBelow->Frequency) / (static_cast<double>(pAbove->Frequency) - pBelow->Frequency);
+    return pBelow->Voltage + (static_cast<double>(pAbove->Voltage) - pBelow->Voltage) * Fraction;
+}
+
+/***************************************************************
+ * @brief Fills pTarget with pSource at the voltages given
+ ***************************************************************/
+static void VfCurveEvaluate(const VfCurve *pSource, const uint32_t *pVoltagesMv, uint32_t PointCount, ctl_vf_curve_details_t Details, VfCurve *pTarget)
+{
+    ctl_voltage_frequency_point_t Points[VF_CURVE_MAX_POINTS];
+    for (uint32_t i = 0; i < PointCount; i++)
+    {
+        Points[i].Voltage   = pVoltagesMv[i];
+        Points[i].Frequency = static_cast<uint32_t>(floor(VfCurveFrequencyAt(pSource, pVoltagesMv[i])));
+    }
+    memcpy(pTarget->points, Points, PointCount * sizeof(ctl_voltage_frequency_point_t));
+    pTarget->details    = Details;
+    pTarget->pointCount = PointCount;
+}
+
+ctl_result_t VfCurveResample(const VfCurve *pSource, const VfCurve *pGrid, VfCurve *pTarget)
+{
+    if ((nullptr == pSource) || (nullptr == pGrid) || (nullptr == pTarget))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((0 == pSource->pointCount) || (0 == pGrid->pointCount) || (pGrid->pointCount > VF_CURVE_MAX_POINTS))
+    {
+        return CTL_RESULT_ERROR_INVALID_SIZE;
+    }
+
+    uint32_t VoltagesMv[VF_CURVE_MAX_POINTS];
+    for (uint32_t i = 0; i < pGrid->pointCount; i++)
+    {
+        VoltagesMv[i] = pGrid->points[i].Voltage;
+    }
+    VfCurveEvaluate(pSource, VoltagesMv, pGrid->pointCount, pGrid->details, pTarget);
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t VfCurveResampleEven(const VfCurve *pSource, uint32_t PointCount, ctl_vf_curve_details_t Details, VfCurve *pTarget)
+{
+    if ((nullptr == pSource) || (nullptr == pTarget))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((0 == pSource->pointCount) || (PointCount < 2) || (PointCount > VF_CURVE_MAX_POINTS))
+    {
+        return CTL_RESULT_ERROR_INVALID_SIZE;
+    }
+
+    // At least a millivolt apart, so the rounded voltages stay distinct
+    double LowMv  = pSource->points[0].Voltage;
+    double HighMv = pSource->points[pSource->pointCount - 1].Voltage;
+    if (HighMv - LowMv < PointCount - 1)
+    {
+        return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+    }
+
+    uint32_t VoltagesMv[VF_CURVE_MAX_POINTS];
+    for (uint32_t i = 0; i < PointCount; i++)
+    {
+        VoltagesMv[i] = static_cast<uint32_t>(llround(LowMv + (HighMv - LowMv) * i / (PointCount - 1)));
+    }
+    VfCurveEvaluate(pSource, VoltagesMv, PointCount, Details, pTarget);
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t VfCurveDiffCompute(const VfCurve *pLive, const VfCurve *pTarget, const VfCurveLimits *pLimits, VfCurveDiff *pDiff)
+{
+    if ((nullptr == pLive) || (nullptr == pTarget) || (nullptr == pDiff))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if ((pLive->pointCount != pTarget->pointCount) || (pLive->pointCount > VF_CURVE_MAX_POINTS))
+    {
+        return CTL_RESULT_ERROR_INVALID_SIZE;
+    }
+
+    // Changes below a step would be rounded away by the driver
+    double VoltageStep   = VfCurveStep(pLimits, true);
+    double FrequencyStep = VfCurveStep(pLimits, false);
+    pDiff->editCount     = 0;
+    for (uint32_t i = 0; i < pLive->pointCount; i++)
+    {
+        const ctl_voltage_frequency_point_t &From = pLive->points[i];
+        const ctl_voltage_frequency_point_t &To   = pTarget->points[i];
+        double VoltageDelta                       = fabs(static_cast<double>(To.Voltage) - From.Voltage);
+        double FrequencyDelta                     = fabs(static_cast<double>(To.Frequency) - From.Frequency);
+        if ((VoltageDelta >= VoltageStep) || (FrequencyDelta >= FrequencyStep))
+        {
+            VfCurveEdit &Edit = pDiff->edits[pDiff->editCount++];
+            Edit.index        = i;
+            Edit.from         = From;
+            Edit.to           = To;
+        }
+    }
+    return CTL_RESULT_SUCCESS;
+}
+
+ctl_result_t VfCurveApply(ctl_device_adapter_handle_t hDevice, const VfCurve *pLive, const VfCurveDiff *pDiff, const VfCurveLimits *pLimits, VfCurve *pApplied)
+{
+    if ((nullptr == pLive) || (nullptr == pDiff) || (nullptr == pApplied))
+    {
+        return CTL_RESULT_ERROR_INVALID_NULL_POINTER;
+    }
+    if (0 == pDiff->editCount)
+    {
+        if (pApplied != pLive)
+        {
+            *pApplied = *pLive;
+        }
+        return CTL_RESULT_SUCCESS;
+    }
+
+    // A diff taken against another curve than pLive is refused rather than merged
+    VfCurve Curve = *pLive;
+    for (uint32_t i = 0; i < pDiff->editCount; i++)
+    {
+        const VfCurveEdit &Edit = pDiff->edits[i];
+        if ((Edit.index >= Curve.pointCount) || (Curve.points[Edit.index].Voltage != Edit.from.Voltage) || (Curve.points[Edit.index].Frequency != Edit.from.Frequency))
+        {
+            return CTL_RESULT_ERROR_INVALID_ARGUMENT;
+        }
+        Curve.points[Edit.index] = Edit.to;
+    }
+
+    ctl_result_t Result = VfCurveValidate(&Curve, pLimits);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        return Result;
+    }
+    Result = ctlOverclockWriteCustomVFCurve(hDevice, Curve.pointCount, Curve.points);
+    if (CTL_RESULT_SUCCESS != Result)
+    {
+        return Result;
+    }
+    return VfCurveRead(hDevice, CTL_VF_CURVE_TYPE_LIVE, Curve.details, pApplied);
+}
@@ -0,0 +1,155 @@
+//===========================================================================
+// Copyright (C) 2025 Intel Corporation
+//
+//
+//
+// SPDX-License-Identifier: MIT
+//--------------------------------------------------------------------------
+
+/**
+ *
+ * @file  VfCurve.h
+ * @brief Voltage frequency curves of the overclocking V2 API.
+ *
+ * A curve is held as its points sorted by voltage, in millivolts and MHz
+ * as ctlOverclockReadVFCurve returns them. A valid curve has distinct
+ * voltages and frequencies that never fall as the voltage rises, so both
+ * lookups are a binary search followed by a linear interpolation: the
+ * frequency the curve runs at a voltage, and the lowest voltage at which
+ * it reaches a frequency.
+ *
+ * The driver reports a curve at three levels of detail, each with a point
+ * count of its own. Resampling evaluates a curve at the voltages of
+ * another, typically the live curve at the level a custom curve is written
+ * at, or at evenly spaced voltages. Frequencies are rounded down, so a
+ * resampled curve never asks for more clock at a voltage than its source.
+ *
+ * Writes are read, modify, write against the live curve. VfCurveDiffCompute
+ * keeps only the points that moved by at least a step of the limits, and
+ * VfCurveApply checks the curve that results against the voltage and
+ * frequency limits of ctl_oc_properties_t before writing it, writes
+ * nothing when no point moved, and reads the live curve back since the
+ * driver may apply a slightly different one.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "igcl_api.h"
+
+#define VF_CURVE_MAX_POINTS 256
+
+struct VfCurveLimits
+{
+    double voltageMinMv;
+    double voltageMaxMv;
+    double voltageStepMv; ///< Smallest change the driver applies, at least 1
+    double frequencyMinMhz;
+    double frequencyMaxMhz;
+    double frequencyStepMhz;
+};
+
+struct VfCurve
+{
+    ctl_vf_curve_details_t details;
+    uint32_t pointCount;
+    ctl_voltage_frequency_point_t points[VF_CURVE_MAX_POINTS]; ///< Ascending voltage
+};
+
+struct VfCurveEdit
+{
+    uint32_t index; ///< Of the point in the live curve
+    ctl_voltage_frequency_point_t from;
+    ctl_voltage_frequency_point_t to;
+};
+
+struct VfCurveDiff
+{
+    uint32_t editCount;
+    VfCurveEdit edits[VF_CURVE_MAX_POINTS];
+};
+
+/***************************************************************
+ * @brief Limits of custom curves, converted to millivolts and MHz
+ *
+ * Returns CTL_RESULT_ERROR_UNSUPPORTED_VERSION for properties of version 0
+ * and CTL_RESULT_ERROR_UNSUPPORTED_FEATURE when either limit is not
+ * supported.
+ ***************************************************************/
+ctl_result_t VfCurveLimitsFromProperties(const ctl_oc_properties_t *pProperties, VfCurveLimits *pLimits);
+
+/***************************************************************
+ * @brief Reads a stock or live curve at a level of detail
+ ***************************************************************/
+ctl_result_t VfCurveRead(ctl_device_adapter_handle_t hDevice, ctl_vf_curve_type_t Type, ctl_vf_curve_details_t Details, VfCurve *pCurve);
+
+/***************************************************************
+ * @brief Copies points in any order into a curve sorted by voltage
+ ***************************************************************/
+ctl_result_t VfCurveSet(VfCurve *pCurve, ctl_vf_curve_details_t Details, const ctl_voltage_frequency_point_t *pPoints, uint32_t PointCount);
+
+/***************************************************************
+ * @brief Checks the order of the points and, with pLimits, their range
+ *
+ * Returns CTL_RESULT_ERROR_CORE_OVERCLOCK_INVALID_CUSTOM_VF_CURVE for a
+ * repeated voltage or a frequency that falls, and the voltage or frequency
+ * outside range errors for a point beyond the limits. pLimits may be
+ * nullptr.
+ ***************************************************************/
+ctl_result_t VfCurveValidate(const VfCurve *pCurve, const VfCurveLimits *pLimits);
+
+/***************************************************************
+ * @brief Makes a curve valid by moving as few points as possible
+ *
+ * Points are clamped into the limits, a repeated voltage is raised by a
+ * step and a frequency above that of a higher voltage is lowered to it,
+ * both of which keep the curve on the stable side. pAdjusted, which may be
+ * nullptr, receives the number of points moved. Fails when the voltages
+ * do not fit between the limits.
+ ***************************************************************/
+ctl_result_t VfCurveEnforce(VfCurve *pCurve, const VfCurveLimits *pLimits, uint32_t *pAdjusted);
+
+/***************************************************************
+ * @brief Frequency of a valid curve at a voltage, clamped to its ends
+ ***************************************************************/
+double VfCurveFrequencyAt(const VfCurve *pCurve, double VoltageMv);
+
+/***************************************************************
+ * @brief Lowest voltage at which a valid curve reaches a frequency
+ *
+ * The voltage of the last point when the curve never reaches it, that of
+ * the first when the curve starts above it.
+ ***************************************************************/
+double VfCurveVoltageAt(const VfCurve *pCurve, double FrequencyMhz);
+
+/***************************************************************
+ * @brief Evaluates pSource at the voltages of pGrid
+ *
+ * pTarget takes the voltages and level of detail of pGrid, and may be
+ * either of them.
+ ***************************************************************/
+ctl_result_t VfCurveResample(const VfCurve *pSource, const VfCurve *pGrid, VfCurve *pTarget);
+
+/***************************************************************
+ * @brief Evaluates pSource at PointCount voltages spread evenly over it
+ ***************************************************************/
+ctl_result_t VfCurveResampleEven(const VfCurve *pSource, uint32_t PointCount, ctl_vf_curve_details_t Details, VfCurve *pTarget);
+
+/***************************************************************
+ * @brief Points of pTarget that differ from pLive by at least a step
+ *
+ * Both curves must have the same number of points; resample pTarget onto
+ * pLive first otherwise. pLimits may be nullptr, every change then counts.
+ ***************************************************************/
+ctl_result_t VfCurveDiffCompute(const VfCurve *pLive, const VfCurve *pTarget, const VfCurveLimits *pLimits, VfCurveDiff *pDiff);
+
+/***************************************************************
+ * @brief Writes pLive with the edits of pDiff applied
+ *
+ * The curve is validated against pLimits before anything is written, and
+ * nothing is written for an empty diff. On success pApplied, which may be
+ * pLive, receives the live curve read back at the same level of detail.
+ ***************************************************************/
+ctl_result_t VfCurveApply(ctl_device_adapter_handle_t hDevice, const VfCurve *pLive, const VfCurveDiff *pDiff, const VfCurveLimits *pLimits, VfCurve *pApplied);